@@ -1,15 +1,15 @@
 #version 300 es
 precision mediump float;
-uniform sampler2D diffTexture;
-uniform bool useEffect;
+uniform mediump sampler2DArray diffTexture;
 uniform vec4 effectColor;
-in vec2 v2fCoord;
+in vec3 v3fCoord;
+flat in float fEffect;
 out vec4 oColor;
 void main()
 {
-   if (useEffect == true) {
+   if (fEffect > 0.5) {
       oColor = effectColor;
    } else {
-      oColor = texture(diffTexture, v2fCoord);
+      oColor = texture(diffTexture, v3fCoord);
    }
-}
\ No newline at end of file
+}
@@ -0,0 +1,35 @@
+#version 300 es
+// Plane coordinates reach tens of meters, mediump would step on the lines.
+precision highp float;
+// inputs
+in vec2 v_Plane;
+in vec2 v_Fade;
+// uniforms
+uniform vec4 u_BaseColor;
+uniform vec4 u_LineColor;
+uniform vec4 u_Grid;        // minor cell, minor half width, major cell, major half width
+// outputs
+out vec4 FragColor;
+
+// Coverage of the lines of one grid level, anti-aliased over the pixel
+// footprint.  A line is drawn at least a pixel wide and dimmed by how much
+// it was widened, and where the cells shrink below a couple of pixels the
+// lines settle to their average coverage instead of shimmering.
+float gridCoverage(vec2 plane, float cell, float halfWidth) {
+    vec2 coord = plane / cell;
+    vec2 footprint = fwidth(coord);
+    float width = 2.0 * halfWidth / cell;
+    vec2 drawWidth = clamp(vec2(width), footprint, vec2(0.5));
+    vec2 toLine = 1.0 - abs(fract(coord) * 2.0 - 1.0);
+    vec2 cover = 1.0 - smoothstep(drawWidth - footprint * 1.5, drawWidth + footprint * 1.5, toLine);
+    cover *= clamp(width / drawWidth, 0.0, 1.0);
+    cover = mix(cover, vec2(width), clamp(footprint * 2.0 - 1.0, 0.0, 1.0));
+    return max(cover.x, cover.y);
+}
+
+void main() {
+    float minor = gridCoverage(v_Plane, u_Grid.x, u_Grid.y);
+    float major = gridCoverage(v_Plane, u_Grid.z, u_Grid.w);
+    float cover = max(minor * 0.5, major) * (1.0 - clamp(length(v_Fade) - 1.0, 0.0, 1.0));
+    FragColor = mix(u_BaseColor, u_LineColor, cover);
+}
@@ -0,0 +1,12 @@
+#version 300 es
+precision mediump float;
+in vec3 v3fCoord;
+out vec4 FragColor;
+uniform samplerCube atexture;
+uniform samplerCube btexture;   // the sky fading out
+uniform float fade;             // 0 shows btexture, 1 atexture
+
+void main()
+{
+    FragColor = mix(texture(btexture, v3fCoord), texture(atexture, v3fCoord), fade);
+}
@@ -0,0 +1,24 @@
+#version 300 es
+precision highp float;
+in vec3 v3fCoord;
+out vec4 FragColor;
+uniform sampler2D atexture;
+
+const float kPi = 3.14159265;
+
+void main()
+{
+    vec3 dir = normalize(v3fCoord);
+    // -z is the middle of the image, +y the top row.
+    vec2 uv = vec2(atan(dir.x, -dir.z) * (0.5 / kPi) + 0.5, acos(clamp(dir.y, -1.0, 1.0)) / kPi);
+    // u jumps from 1 to 0 behind the viewer.  Take the gradients of a u that
+    // wraps elsewhere there, or the seam picks the smallest mip.
+    vec2 wrapped = vec2(fract(uv.x + 0.5), uv.y);
+    vec2 dx = dFdx(uv), dy = dFdy(uv);
+    vec2 wdx = dFdx(wrapped), wdy = dFdy(wrapped);
+    if (abs(wdx.x) + abs(wdy.x) < abs(dx.x) + abs(dy.x)) {
+        dx = wdx;
+        dy = wdy;
+    }
+    FragColor = textureGrad(atexture, uv, dx, dy);
+}
@@ -0,0 +1,12 @@
+#version 300 es
+precision mediump float;
+precision mediump sampler2DArray;
+uniform sampler2DArray atexture;
+in vec3 v3fCoord;
+in vec4 v4fColor;
+in float intensity;
+out vec4 oColor;
+void main()
+{
+   oColor = texture(atexture, v3fCoord) * v4fColor * intensity;
+}
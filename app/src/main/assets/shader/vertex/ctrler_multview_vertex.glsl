@@ -5,11 +5,25 @@
 
 layout(num_views = 2) in;
 
+// See ctrler_vertex.glsl.
 uniform mat4 matrix[2];
+uniform mat4 compMatrix[32];
+uniform vec4 compParams[32];
+uniform vec4 compRegion[32];
 layout(location = 0) in vec3 v3Position;
 layout(location = 2) in vec2 v2Coord;
-out vec2 v2fCoord;
+layout(location = 3) in float fSlot;
+out vec3 v3fCoord;
+flat out float fEffect;
 void main() {
-    gl_Position = matrix[gl_ViewID_OVR] * vec4(v3Position.xyz, 1);
-    v2fCoord = vec2(v2Coord.s, v2Coord.t);
+    int slot = int(fSlot);
+    vec4 params = compParams[slot];
+    gl_Position = matrix[gl_ViewID_OVR] * compMatrix[slot] * vec4(v3Position.xyz, 1);
+    gl_Position.z -= params.z * gl_Position.w;
+    if (params.x == 0.0) {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+    }
+    vec4 region = compRegion[slot];
+    v3fCoord = vec3(region.xy + clamp(v2Coord, 0.0, 1.0) * region.zw, params.w);
+    fEffect = params.y;
 }
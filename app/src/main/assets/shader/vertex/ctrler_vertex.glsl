@@ -1,9 +1,25 @@
 #version 300 es
+// A whole controller in one draw.  fSlot picks the component's matrix and
+// flags: x shows it, y fills it with effectColor, z pulls it toward the eye,
+// w is its atlas page.  compRegion maps the coordinate into that page.
 uniform mat4 matrix;
+uniform mat4 compMatrix[32];
+uniform vec4 compParams[32];
+uniform vec4 compRegion[32];
 layout(location = 0) in vec3 v3Position;
 layout(location = 2) in vec2 v2Coord;
-out vec2 v2fCoord;
+layout(location = 3) in float fSlot;
+out vec3 v3fCoord;
+flat out float fEffect;
 void main() {
-    v2fCoord = vec2(v2Coord.s, v2Coord.t);
-    gl_Position = matrix * vec4(v3Position.xyz, 1.0f);
-}
\ No newline at end of file
+    int slot = int(fSlot);
+    vec4 params = compParams[slot];
+    vec4 region = compRegion[slot];
+    v3fCoord = vec3(region.xy + clamp(v2Coord, 0.0, 1.0) * region.zw, params.w);
+    fEffect = params.y;
+    gl_Position = matrix * compMatrix[slot] * vec4(v3Position.xyz, 1.0f);
+    gl_Position.z -= params.z * gl_Position.w;
+    if (params.x == 0.0f) {
+        gl_Position = vec4(2.0f, 2.0f, 2.0f, 1.0f);
+    }
+}
@@ -0,0 +1,16 @@
+#version 300 es
+// The floor quad, scaled to the far plane and centered under the camera.
+layout(location = 0) in vec4 a_Position;
+// outputs
+out vec2 v_Plane;
+out vec2 v_Fade;          // offset from the camera over the fade start
+// uniforms
+uniform mat4 u_MVP;
+uniform vec4 u_Follow;      // center x, center z, scale, fade start
+
+void main() {
+    vec2 offset = a_Position.xz * u_Follow.z;
+    v_Plane = offset + u_Follow.xy;
+    v_Fade = offset / u_Follow.w;
+    gl_Position = u_MVP * vec4(v_Plane.x, 0.0, v_Plane.y, 1.0);
+}
@@ -0,0 +1,14 @@
+#version 300 es
+// One triangle over the whole viewport at the far plane, no vertex array.
+// matrix is the inverse of projection * view without translation.
+uniform mat4 matrix;
+out vec3 v3fCoord;
+
+void main()
+{
+    vec2 corner = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2)) * 2.0 - 1.0;
+    gl_Position = vec4(corner, 1.0, 1.0);
+    // The unprojected w is positive on the far plane, so xyz alone is the
+    // direction and interpolates linearly across the screen.
+    v3fCoord = (matrix * vec4(corner, 1.0, 1.0)).xyz;
+}
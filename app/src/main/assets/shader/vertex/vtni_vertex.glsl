@@ -0,0 +1,21 @@
+#version 300 es
+uniform mat4 matrix;
+uniform vec4 l_dir;
+layout(location = 0) in vec3 v3Position;
+layout(location = 1) in vec2 v2Coord;
+layout(location = 2) in vec3 v3Normal;
+layout(location = 3) in mat4 m4Model;
+layout(location = 7) in vec4 v4Color;
+layout(location = 8) in float fLayer;
+out vec3 v3fCoord;
+out vec4 v4fColor;
+out float intensity;
+void main()
+{
+    // Instances are rotated, translated and uniformly scaled only.
+    vec3 norm = normalize(mat3(m4Model) * v3Normal);
+    intensity = max(dot(norm, l_dir.xyz), l_dir.w);
+    v3fCoord = vec3(v2Coord, fLayer);
+    v4fColor = v4Color;
+    gl_Position = matrix * m4Model * vec4(v3Position.xyz, 1);
+}
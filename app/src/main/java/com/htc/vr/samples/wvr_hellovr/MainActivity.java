@@ -46,10 +46,20 @@ public class MainActivity extends VRActivity {
     private static final String ACTION_SWITCH_DEBUG = "com.htc.vr.samples.wvr_hellovr.ACTION_SWITCH_DEBUG";
     private static final String ACTION_SWITCH_MSAA = "com.htc.vr.samples.wvr_hellovr.ACTION_SWITCH_MSAA";
     private static final String ACTION_SWITCH_SCENE = "com.htc.vr.samples.wvr_hellovr.ACTION_SWITCH_SCENE";
+    // No room left in the notification; send these with "adb shell am broadcast -a".
+    private static final String ACTION_SWITCH_FOVEATION = "com.htc.vr.samples.wvr_hellovr.ACTION_SWITCH_FOVEATION";
+    private static final String ACTION_SWITCH_FOVEATION_FORCED = "com.htc.vr.samples.wvr_hellovr.ACTION_SWITCH_FOVEATION_FORCED";
+    private static final String ACTION_SWITCH_FLOOR = "com.htc.vr.samples.wvr_hellovr.ACTION_SWITCH_FLOOR";
     private static final String SP_DEBUG = "debug";
     private static final int FLAG_DEBUG = 0x01;
     private static final int FLAG_MSAA = 0x02;
     private static final int FLAG_SCENE = 0x04;
+    // Off, fixed, gaze, controller
+    private static final int FLAG_FOVEATION_SHIFT = 3;
+    private static final int FLAG_FOVEATION_MASK = 0x18;
+    private static final int FLAG_FOVEATION_FORCED = 0x20;
+    // Textured or procedural grid floor
+    private static final int FLAG_PROCEDURAL_FLOOR = 0x40;
     private boolean mDebug = false;
     private int mFlag = FLAG_MSAA;
     private final String CHANNEL_ID = "channel.id.wvr_hellovr";
@@ -76,6 +86,13 @@ public class MainActivity extends VRActivity {
             } else if (intent.getAction().equals(ACTION_SWITCH_SCENE)) {
                 boolean scene = (mFlag & FLAG_SCENE) == 0;  // invert flag value here
                 mFlag = (mFlag & ~FLAG_SCENE) | (scene ? FLAG_SCENE : 0);
+            } else if (intent.getAction().equals(ACTION_SWITCH_FOVEATION)) {
+                int mode = (((mFlag & FLAG_FOVEATION_MASK) >> FLAG_FOVEATION_SHIFT) + 1) & 0x3;
+                mFlag = (mFlag & ~FLAG_FOVEATION_MASK) | (mode << FLAG_FOVEATION_SHIFT);
+            } else if (intent.getAction().equals(ACTION_SWITCH_FOVEATION_FORCED)) {
+                mFlag ^= FLAG_FOVEATION_FORCED;
+            } else if (intent.getAction().equals(ACTION_SWITCH_FLOOR)) {
+                mFlag ^= FLAG_PROCEDURAL_FLOOR;
             } else {
                 Log.i(TAG,"onReceive: end1");
                 return;
@@ -91,10 +108,26 @@ public class MainActivity extends VRActivity {
 
     static native void setFlag(int flag);
 
+    // Where native code keeps files it can rebuild, like parsed controller models.
+    static native void setCacheDir(String dir);
+
+    // A .hvsc scene from hellovr_meshconv, an asset path or an absolute path.
+    static native void setEnvironment(String path);
+
+    // A file of recorded controller input.  Replayed when it exists, otherwise recorded.
+    static native void setInputTrace(String path);
+
     @Override
     protected void onCreate(Bundle icicle) {
         Log.i(TAG,"onCreate:call init");
         init(getResources().getAssets());
+        setCacheDir(getCacheDir().getAbsolutePath());
+        String environment = getIntent().getStringExtra("environment");
+        if (environment != null)
+            setEnvironment(environment);
+        String inputTrace = getIntent().getStringExtra("input_trace");
+        if (inputTrace != null)
+            setInputTrace(inputTrace);
         super.onCreate(icicle);
 
         // dump verion information
@@ -176,6 +209,9 @@ public class MainActivity extends VRActivity {
         filter.addAction(ACTION_SWITCH_DEBUG);
         filter.addAction(ACTION_SWITCH_MSAA);
         filter.addAction(ACTION_SWITCH_SCENE);
+        filter.addAction(ACTION_SWITCH_FOVEATION);
+        filter.addAction(ACTION_SWITCH_FOVEATION_FORCED);
+        filter.addAction(ACTION_SWITCH_FLOOR);
         registerReceiver(receiver, filter);
         Log.i(TAG,"setNotification:end");
     }
@@ -41,22 +41,50 @@ COMMON_INCLUDES := \
 COMMON_FILES := \
     hellovr.cpp \
     Context.cpp \
+    EnvWrapper.cpp \
+    AssetFile.cpp \
     shared/Matrices.cpp \
+    shared/BVH.cpp \
+    shared/SceneGraph.cpp \
+    shared/Frustum.cpp \
+    shared/MeshGenerator.cpp \
+    shared/MeshSimplifier.cpp \
+    shared/LodSelector.cpp \
+    shared/RenderStats.cpp \
+    shared/ResolutionController.cpp \
+    shared/Foveation.cpp \
+    shared/PoseHistory.cpp \
+    shared/Quaternion.cpp \
+    shared/FramePipeline.cpp \
+    shared/JobSystem.cpp \
+    shared/SceneFile.cpp \
+    shared/AtlasPacker.cpp \
+    shared/InputSystem.cpp \
     object/Texture.cpp \
+    object/RenderState.cpp \
     object/VertexArrayObject.cpp \
     object/FrameBufferObject.cpp \
+    object/GpuTimer.cpp \
+    object/RenderTargetManager.cpp \
     object/Shader.cpp \
     object/Object.cpp \
     object/Mesh.cpp \
+    object/InstanceBuffer.cpp \
+    object/IndexedMesh.cpp \
     scene/SkyBox.cpp \
+    scene/SkyBoxCache.cpp \
     scene/ControllerAxes.cpp \
     scene/Picture.cpp \
     scene/ControllerCube.cpp \
     scene/Sphere.cpp \
     scene/Floor.cpp \
+    scene/SeaOfCubes.cpp \
     scene/ReticlePointer.cpp \
     scene/Controller.cpp \
-    scene/CustomController.cpp
+    scene/ControllerModel.cpp \
+    scene/Environment.cpp \
+    scene/CustomController.cpp \
+    scene/Picker.cpp
 
 #USE_CONTROLLER use device controller.
 #USE_CUSTOM_CONTROLLER use device emitter.
@@ -0,0 +1,80 @@
+// "WaveVR SDK 
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#define LOG_TAG "AssetFile"
+#include <stdlib.h>
+#include <string.h>
+#include <Context.h>
+#include "log.h"
+
+AssetFile::AssetFile(AAssetManager * assetManager, const char * assetPath) :
+    mAssetManager(assetManager),
+    mPath(assetPath),
+    mAsset(NULL) {
+}
+
+AssetFile::~AssetFile() {
+    close();
+}
+
+bool AssetFile::open() {
+    if (mAsset != NULL)
+        return true;
+
+    if (mPath == NULL) {
+        LOGE("File Path is NULL");
+        return false;
+    }
+
+    if (mAssetManager == NULL) {
+        LOGE("AssetManager is NULL");
+        return false;
+    }
+
+    mAsset = AAssetManager_open(mAssetManager, mPath, AASSET_MODE_UNKNOWN);
+    if (mAsset == NULL) {
+        LOGE("Open file failed: %s", mPath);
+        return false;
+    }
+
+    return true;
+}
+
+void AssetFile::close() {
+    if (mAsset == NULL)
+        return;
+    AAsset_close(mAsset);
+    mAsset = NULL;
+}
+
+const void * AssetFile::getBuffer() {
+    if (mAsset == NULL)
+        return NULL;
+    return AAsset_getBuffer(mAsset);
+}
+
+size_t AssetFile::getLength() {
+    if (mAsset == NULL)
+        return 0;
+    return AAsset_getLength(mAsset);
+}
+
+char * AssetFile::toString() {
+    if (mAsset == NULL)
+        return NULL;
+    const void * buffer = AAsset_getBuffer(mAsset);
+    const size_t N = AAsset_getLength(mAsset);
+    if (N == 0)
+        return NULL;
+    char * dup = new char [N + 1];
+    memcpy(dup, buffer, N);
+    dup[N] = 0;
+    return dup;
+}
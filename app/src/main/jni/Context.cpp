@@ -14,23 +14,6 @@
 #include <Context.h>
 #include "log.h"
 
-EnvWrapper::EnvWrapper(JavaVM * vm, JNIEnv * env, bool needAttach) :
-        mVM(vm), mEnv(env), mNeedAttach(needAttach) {
-    if (mNeedAttach && mEnv != NULL) {
-        int ret = mVM->AttachCurrentThread(&mEnv, NULL);
-        if (ret != 0) {
-            mEnv = NULL;
-            mNeedAttach = false;
-        }
-    }
-}
-
-EnvWrapper::~EnvWrapper() {
-    if (mNeedAttach && mEnv != NULL) {
-        mVM->DetachCurrentThread();
-    }
-}
-
 BitmapFactory::BitmapFactory(JNIEnv * env) {
     const char * BitmapFactoryClassName = "android/graphics/BitmapFactory";
     jclass localClazz = env->FindClass(BitmapFactoryClassName);
@@ -133,89 +116,3 @@ void Context::init(JNIEnv * env, jobject assetManagerInstance) {
 
     mBitmapFactory = new BitmapFactory(env);
 }
-
-EnvWrapper Context::getEnv() {
-    if (mActivityNative != NULL)
-        return EnvWrapper(mVM, mActivityNative->env, true);
-
-    JNIEnv * env = NULL;
-    int stat;
-    stat = mVM->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6);
-    if (stat == JNI_EDETACHED) {
-        return EnvWrapper(mVM, env, true);
-    } else if (stat == JNI_OK) {
-        return EnvWrapper(mVM, env, false);
-    } else if (stat == JNI_EVERSION) {
-        LOGE("GetEnv: version not supported");
-    } else {
-        LOGE("Could not get java env!");
-    }
-    Context * context = Context::getInstance();
-    context->getEnv();
-    return EnvWrapper(mVM, NULL, false);
-}
-
-AssetFile::AssetFile(AAssetManager * assetManager, const char * assetPath) :
-    mAssetManager(assetManager),
-    mPath(assetPath),
-    mAsset(NULL) {
-}
-
-AssetFile::~AssetFile() {
-    close();
-}
-
-bool AssetFile::open() {
-    if (mAsset != NULL)
-        return true;
-
-    if (mPath == NULL) {
-        LOGE("File Path is NULL");
-        return false;
-    }
-
-    if (mAssetManager == NULL) {
-        LOGE("AssetManager is NULL");
-        return false;
-    }
-
-    mAsset = AAssetManager_open(mAssetManager, mPath, AASSET_MODE_UNKNOWN);
-    if (mAsset == NULL) {
-        LOGE("Open file failed: %s", mPath);
-        return false;
-    }
-
-    return true;
-}
-
-void AssetFile::close() {
-    if (mAsset == NULL)
-        return;
-    AAsset_close(mAsset);
-    mAsset = NULL;
-}
-
-const void * AssetFile::getBuffer() {
-    if (mAsset == NULL)
-        return NULL;
-    return AAsset_getBuffer(mAsset);
-}
-
-size_t AssetFile::getLength() {
-    if (mAsset == NULL)
-        return 0;
-    return AAsset_getLength(mAsset);
-}
-
-char * AssetFile::toString() {
-    if (mAsset == NULL)
-        return NULL;
-    const void * buffer = AAsset_getBuffer(mAsset);
-    const size_t N = AAsset_getLength(mAsset);
-    if (N == 0)
-        return NULL;
-    char * dup = new char [N + 1];
-    memcpy(dup, buffer, N);
-    dup[N] = 0;
-    return dup;
-}
@@ -16,14 +16,22 @@
 #include <android/bitmap.h>
 
 class Context;
+// The JNIEnv of the calling thread.  With needAttach the thread is attached
+// for the life of the wrapper and detached again after, which is how
+// JobSystem workers and other native threads reach Java.
 class EnvWrapper {
 private:
     JavaVM * mVM;
     JNIEnv * mEnv;
     bool mNeedAttach;
 
+    // A copy would detach the thread twice.
+    EnvWrapper(const EnvWrapper&);
+    EnvWrapper& operator=(const EnvWrapper&);
+
 public:
     EnvWrapper(JavaVM * vm, JNIEnv * env, bool needAttach);
+    EnvWrapper(EnvWrapper&& other);
 
     ~EnvWrapper();
 
@@ -0,0 +1,64 @@
+// "WaveVR SDK 
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+// Thread attachment, shared by the device and the host build so the host
+// tests run the same code against the JavaVM of host/android/java_vm.cpp.
+
+#define LOG_TAG "Context"
+#include <stdlib.h>
+#include <Context.h>
+#include "log.h"
+
+EnvWrapper::EnvWrapper(JavaVM * vm, JNIEnv * env, bool needAttach) :
+        mVM(vm), mEnv(env), mNeedAttach(needAttach) {
+    // GetEnv() leaves env NULL on a detached thread, so do not wait for one.
+    if (mNeedAttach) {
+        int ret = mVM->AttachCurrentThread(&mEnv, NULL);
+        if (ret != 0) {
+            LOGE("AttachCurrentThread failed %d", ret);
+            mEnv = NULL;
+            mNeedAttach = false;
+        }
+    }
+}
+
+EnvWrapper::EnvWrapper(EnvWrapper&& other) :
+        mVM(other.mVM), mEnv(other.mEnv), mNeedAttach(other.mNeedAttach) {
+    other.mNeedAttach = false;
+}
+
+EnvWrapper::~EnvWrapper() {
+    if (mNeedAttach && mEnv != NULL) {
+        mVM->DetachCurrentThread();
+    }
+}
+
+EnvWrapper Context::getEnv() {
+    if (mActivityNative != NULL)
+        return EnvWrapper(mVM, mActivityNative->env, true);
+    if (mVM == NULL)
+        return EnvWrapper(NULL, NULL, false);
+
+    JNIEnv * env = NULL;
+    int stat;
+    stat = mVM->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6);
+    if (stat == JNI_EDETACHED) {
+        // A JobSystem worker or another native thread.  Attached until the
+        // wrapper goes away.
+        return EnvWrapper(mVM, NULL, true);
+    } else if (stat == JNI_OK) {
+        return EnvWrapper(mVM, env, false);
+    } else if (stat == JNI_EVERSION) {
+        LOGE("GetEnv: version not supported");
+    } else {
+        LOGE("Could not get java env!");
+    }
+    return EnvWrapper(mVM, NULL, false);
+}
@@ -0,0 +1,61 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+
+#include "AllocCounter.h"
+
+static std::atomic<uint64_t> sCount(0);
+static std::atomic<uint64_t> sBytes(0);
+
+static void * countedAlloc(size_t size) {
+    sCount.fetch_add(1, std::memory_order_relaxed);
+    sBytes.fetch_add(size, std::memory_order_relaxed);
+    void * p = malloc(size != 0 ? size : 1);
+    if (p == NULL)
+        throw std::bad_alloc();
+    return p;
+}
+
+void * operator new(size_t size) { return countedAlloc(size); }
+void * operator new[](size_t size) { return countedAlloc(size); }
+void * operator new(size_t size, const std::nothrow_t &) noexcept {
+    sCount.fetch_add(1, std::memory_order_relaxed);
+    sBytes.fetch_add(size, std::memory_order_relaxed);
+    return malloc(size != 0 ? size : 1);
+}
+void * operator new[](size_t size, const std::nothrow_t & tag) noexcept { return operator new(size, tag); }
+void operator delete(void * p) noexcept { free(p); }
+void operator delete[](void * p) noexcept { free(p); }
+void operator delete(void * p, size_t) noexcept { free(p); }
+void operator delete[](void * p, size_t) noexcept { free(p); }
+
+uint64_t AllocCounter::count() {
+    return sCount.load(std::memory_order_relaxed);
+}
+
+uint64_t AllocCounter::bytes() {
+    return sBytes.load(std::memory_order_relaxed);
+}
+
+AllocScope::AllocScope(benchmark::State & state) :
+        mState(state),
+        mCount(AllocCounter::count()),
+        mBytes(AllocCounter::bytes()) {
+}
+
+AllocScope::~AllocScope() {
+    mState.counters["allocs"] = benchmark::Counter(
+            AllocCounter::count() - mCount, benchmark::Counter::kAvgIterations);
+    mState.counters["alloc_bytes"] = benchmark::Counter(
+            AllocCounter::bytes() - mBytes, benchmark::Counter::kAvgIterations);
+}
@@ -0,0 +1,33 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+
+#include <stdint.h>
+#include <benchmark/benchmark.h>
+
+// Counts every global operator new in the benchmark binary.  Wrap the timed
+// loop with an AllocScope to report "allocs" and "alloc_bytes" per iteration.
+class AllocCounter {
+public:
+    static uint64_t count();
+    static uint64_t bytes();
+};
+
+class AllocScope {
+public:
+    explicit AllocScope(benchmark::State & state);
+    ~AllocScope();
+
+private:
+    benchmark::State & mState;
+    uint64_t mCount;
+    uint64_t mBytes;
+};
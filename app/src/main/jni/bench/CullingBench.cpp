@@ -0,0 +1,90 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#include <stdlib.h>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <Frustum.h>
+
+// Roughly the HMD's field of view, eyes 64mm apart.
+static void makeEyes(Frustum& left, Frustum& right) {
+    const float n = 0.1f, f = 100.0f;
+    Matrix4 proj(1, 0, 0, 0,
+                 0, 1, 0, 0,
+                 0, 0, -(f + n) / (f - n), -1,
+                 0, 0, -2 * f * n / (f - n), 0);
+    Matrix4 eyeLeft, eyeRight;
+    eyeLeft.translate(0.032f, 0, 0);
+    eyeRight.translate(-0.032f, 0, 0);
+    left.set(proj * eyeLeft);
+    right.set(proj * eyeRight);
+}
+
+// Objects all around the viewer, so about a quarter survive.
+static void makeBoxes(std::vector<AABB> & boxes, int count) {
+    srand(9);
+    for (int i = 0; i < count; i++) {
+        Vector3 c((rand() % 2000 - 1000) * 0.02f, (rand() % 2000 - 1000) * 0.005f, (rand() % 2000 - 1000) * 0.02f);
+        boxes.push_back(AABB(c - Vector3(0.2f, 0.2f, 0.2f), c + Vector3(0.2f, 0.2f, 0.2f)));
+    }
+}
+
+// What renderScene would do without a culling pass: test every box per eye.
+static void BM_Culling_PerEyeScalar(benchmark::State & state) {
+    Frustum left, right;
+    makeEyes(left, right);
+    std::vector<AABB> boxes;
+    makeBoxes(boxes, state.range(0));
+    for (auto _ : state) {
+        uint32_t visible = 0;
+        for (size_t i = 0; i < boxes.size(); i++)
+            visible += left.intersects(boxes[i]);
+        for (size_t i = 0; i < boxes.size(); i++)
+            visible += right.intersects(boxes[i]);
+        benchmark::DoNotOptimize(visible);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Culling_PerEyeScalar)->Arg(1000)->Arg(10000);
+
+// Filling the flat arrays is part of the per frame cost.
+static void BM_Culling_Stereo(benchmark::State & state) {
+    Frustum left, right;
+    makeEyes(left, right);
+    std::vector<AABB> boxes;
+    makeBoxes(boxes, state.range(0));
+    FrustumCuller culler;
+    for (auto _ : state) {
+        culler.clear();
+        for (size_t i = 0; i < boxes.size(); i++)
+            culler.add(boxes[i]);
+        benchmark::DoNotOptimize(culler.cull(left, right));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Culling_Stereo)->Arg(1000)->Arg(10000);
+
+// The pass alone, for bounds that are already in place.
+static void BM_Culling_StereoPass(benchmark::State & state) {
+    Frustum left, right;
+    makeEyes(left, right);
+    std::vector<AABB> boxes;
+    makeBoxes(boxes, state.range(0));
+    FrustumCuller culler;
+    for (size_t i = 0; i < boxes.size(); i++)
+        culler.add(boxes[i]);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(culler.cull(left, right));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Culling_StereoPass)->Arg(1000)->Arg(10000);
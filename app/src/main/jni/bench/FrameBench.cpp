@@ -0,0 +1,54 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#include <benchmark/benchmark.h>
+
+#include <hellovr.h>
+#include <wvr/wvr_stub.h>
+
+#include "BenchEnv.h"
+
+extern FramePipeline::Mode gPipelineMode;
+
+// A whole frame of the sample: input, both eyes, submit and pose update.
+// The second argument is the FramePipeline mode; with one core the worker
+// only moves the simulation, so overlap pays off on a device.
+static void BM_MainApplicationFrame(benchmark::State & state) {
+    if (!BenchEnv::hasGL()) {
+        state.SkipWithError("no GLES 3 context");
+        return;
+    }
+    WVR_Stub_Reset();
+    WVR_Stub_SetRenderTargetSize(state.range(0), state.range(0));
+    WVR_Stub_SetPoseAnimation(true);
+    const FramePipeline::Mode oldMode = gPipelineMode;
+    gPipelineMode = (FramePipeline::Mode) state.range(1);
+    MainApplication * app = new MainApplication();
+    if (!app->initVR() || !app->initGL()) {
+        state.SkipWithError("MainApplication init failed");
+    } else {
+        for (auto _ : state) {
+            app->handleInput();
+            app->renderFrame();
+        }
+        glFinish();
+    }
+    app->shutdownGL();
+    app->shutdownVR();
+    delete app;
+    gPipelineMode = oldMode;
+    WVR_Stub_Reset();
+}
+BENCHMARK(BM_MainApplicationFrame)
+        ->Args({256, FramePipeline::kSerial})
+        ->Args({1024, FramePipeline::kSerial})
+        ->Args({1024, FramePipeline::kLockstep})
+        ->Args({1024, FramePipeline::kOverlap})
+        ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,111 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include <ControllerAxes.h>
+#include <ControllerCube.h>
+#include <MeshGenerator.h>
+#include <ReticlePointer.h>
+#include <Texture.h>
+
+#include "AllocCounter.h"
+#include "BenchEnv.h"
+
+// These objects compile shaders in their constructors, so a GL context is
+// needed to create them even though the measured functions are CPU only.
+#define REQUIRE_GL(state) \
+    if (!BenchEnv::hasGL()) { state.SkipWithError("no GLES 3 context"); return; }
+
+static Matrix4 makePose() {
+    Matrix4 m;
+    m.rotate(30, 0.3f, 1.0f, 0.2f);
+    m.translate(0.2f, -0.3f, -0.4f);
+    return m;
+}
+
+// The sphere tessellation Sphere uploads, 36 slices by 18 stacks.
+static void BM_MeshGenerator_UVSphere(benchmark::State & state) {
+    MeshData mesh;
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        MeshGenerator::uvSphere(0.8f, 36, 18, mesh);
+        benchmark::DoNotOptimize(mesh.vertices.data());
+    }
+}
+BENCHMARK(BM_MeshGenerator_UVSphere);
+
+static void BM_MeshGenerator_Icosphere(benchmark::State & state) {
+    MeshData mesh;
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        MeshGenerator::icosphere(0.8f, (uint32_t) state.range(0), mesh);
+        benchmark::DoNotOptimize(mesh.vertices.data());
+    }
+}
+BENCHMARK(BM_MeshGenerator_Icosphere)->Arg(2)->Arg(4);
+
+static void BM_ControllerCube_AddCubeToScene(benchmark::State & state) {
+    const Matrix4 pose = makePose();
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        vertices.clear();
+        indices.clear();
+        ControllerCube::addCubeToScene(pose, vertices, 0, indices);
+        benchmark::DoNotOptimize(vertices.data());
+        benchmark::DoNotOptimize(indices.data());
+    }
+}
+BENCHMARK(BM_ControllerCube_AddCubeToScene);
+
+static void BM_ControllerAxes_MakeVertices(benchmark::State & state) {
+    REQUIRE_GL(state);
+    ControllerAxes axes;
+    const Matrix4 pose = makePose();
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        // A fresh buffer each time, as drawControllers does every frame.
+        std::vector<float> buffer;
+        benchmark::DoNotOptimize(axes.makeVertices(pose, buffer));
+    }
+}
+BENCHMARK(BM_ControllerAxes_MakeVertices);
+
+static void BM_ReticlePointer_MakeVertices(benchmark::State & state) {
+    REQUIRE_GL(state);
+    ReticlePointer reticle;
+    const Matrix4 pose = makePose();
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        std::vector<float> buffer;
+        benchmark::DoNotOptimize(reticle.makeVertices(pose, buffer));
+    }
+}
+BENCHMARK(BM_ReticlePointer_MakeVertices);
+
+// One cube map face out of a 4x3 skybox cross, as loadSkyboxTexture does.
+static void BM_Texture_CropBitmap(benchmark::State & state) {
+    const size_t face = state.range(0);
+    const size_t stride = face * 4 * 4;
+    const size_t height = face * 3;
+    std::vector<uint8_t> bitmap(stride * height, 0x7F);
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        uint8_t * croped = Texture::cropBitmap(bitmap.data(), stride, height, face * 4, face, face * 4, face);
+        benchmark::DoNotOptimize(croped);
+        delete [] croped;
+    }
+    state.SetBytesProcessed(state.iterations() * face * 4 * face);
+}
+BENCHMARK(BM_Texture_CropBitmap)->Arg(256)->Arg(512);
@@ -0,0 +1,73 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#include <benchmark/benchmark.h>
+
+#include <FrameBufferObject.h>
+#include <SeaOfCubes.h>
+
+#include "BenchEnv.h"
+
+// Both eyes of the SeaOfCubes stress scene into a small target, so the time
+// is dominated by draw submission rather than fill.  state.range(0) cubes
+// per side, state.range(1) selects instancing.
+static void BM_SeaOfCubes(benchmark::State & state) {
+    if (!BenchEnv::hasGL()) {
+        state.SkipWithError("no GLES 3 context");
+        return;
+    }
+    const int size = 128;
+    GLuint color = 0;
+    glGenTextures(1, &color);
+    glBindTexture(GL_TEXTURE_2D, color);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, size, size);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    FrameBufferObject * fbo = new FrameBufferObject(color, size, size);
+
+    const uint32_t side = (uint32_t) state.range(0);
+    SeaOfCubes * cubes = new SeaOfCubes(side, side, side, 0.6f);
+    cubes->setInstanced(state.range(1) != 0);
+    if (cubes->hasError() || fbo->hasError()) {
+        state.SkipWithError("SeaOfCubes init failed");
+    } else {
+        const float n = 0.1f, f = 100.0f;
+        Matrix4 projection(1, 0, 0, 0,
+                           0, 1, 0, 0,
+                           0, 0, -(f + n) / (f - n), -1,
+                           0, 0, -2 * f * n / (f - n), 0);
+        Matrix4 view, eyeLeft, eyeRight;
+        view.translate(0, 0, -side * 0.6f * 1.5f);
+        eyeLeft.translate(0.032f, 0, 0);
+        eyeRight.translate(-0.032f, 0, 0);
+        const Vector4 light(0, 0, 1, 0.5f);
+
+        fbo->bindFrameBuffer();
+        fbo->glViewportFull();
+        glEnable(GL_DEPTH_TEST);
+        for (auto _ : state) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            cubes->draw(projection, eyeLeft, view, light);
+            cubes->draw(projection, eyeRight, view, light);
+            glFinish();
+        }
+        fbo->unbindFrameBuffer();
+        state.counters["cubes"] = cubes->getInstanceCount();
+        state.counters["draws"] = 2 * cubes->getDrawCalls();
+    }
+    delete cubes;
+    delete fbo;
+    glDeleteTextures(1, &color);
+}
+BENCHMARK(BM_SeaOfCubes)
+    ->Args({10, 0})->Args({10, 1})
+    ->Args({22, 0})->Args({22, 1})
+    ->ArgNames({"side", "instanced"})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,114 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+
+
+#include <stdlib.h>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <Frustum.h>
+#include <JobSystem.h>
+#include <Picker.h>
+
+namespace {
+
+// A made up frame of CPU work: culling, skinning and picking, each split
+// across the pool.
+class SyntheticFrame {
+public:
+    static const uint32_t kBoxes = 65536;
+    static const uint32_t kVertices = 32768;
+    static const uint32_t kBones = 32;
+    static const uint32_t kRays = 512;
+
+    SyntheticFrame() {
+        srand(3);
+        for (uint32_t i = 0; i < kBoxes; i++) {
+            Vector3 c((rand() % 2000 - 1000) * 0.02f, (rand() % 2000 - 1000) * 0.02f, -(rand() % 1000) * 0.05f);
+            mCuller.add(AABB(c - Vector3(0.1f, 0.1f, 0.1f), c + Vector3(0.1f, 0.1f, 0.1f)));
+        }
+        Matrix4 projection;
+        const float n = 0.1f, f = 100.0f;
+        projection = Matrix4(n / 0.1f, 0, 0, 0, 0, n / 0.1f, 0, 0, 0, 0, -(f + n) / (f - n), -1,
+                0, 0, -2 * f * n / (f - n), 0);
+        mLeft.set(projection);
+        mRight.set(projection);
+
+        for (uint32_t i = 0; i < kBones; i++)
+            mBones[i].rotateY((float) i).translate(0, 0.01f * i, 0);
+        mPositions.resize(kVertices);
+        mSkinned.resize(kVertices);
+        mBoneIndex.resize(kVertices * 2);
+        for (uint32_t i = 0; i < kVertices; i++) {
+            mPositions[i].set(rand() % 100 * 0.01f, rand() % 100 * 0.01f, rand() % 100 * 0.01f);
+            mBoneIndex[i * 2] = rand() % kBones;
+            mBoneIndex[i * 2 + 1] = rand() % kBones;
+        }
+
+        for (uint32_t i = 0; i < 2000; i++) {
+            Matrix4 at;
+            at.translate((rand() % 200 - 100) * 0.1f, (rand() % 200 - 100) * 0.1f, -(rand() % 100) * 0.5f - 1);
+            mPicker.addSphere(Vector3(0, 0, 0), 0.2f, at);
+        }
+        for (uint32_t i = 0; i < kRays; i++) {
+            Vector3 dir((rand() % 100 - 50) * 0.01f, (rand() % 100 - 50) * 0.01f, -1);
+            mRays.push_back(Ray(Vector3(0, 0, 0), dir.normalize()));
+        }
+        mHits.resize(kRays);
+        mPicker.update();
+    }
+
+    uint32_t run(JobSystem& jobs) {
+        uint32_t visible = mCuller.cull(mLeft, mRight, &jobs);
+        jobs.parallelFor(kVertices, 1024, [this](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                const Vector3& p = mPositions[i];
+                mSkinned[i] = (mBones[mBoneIndex[i * 2]] * p + mBones[mBoneIndex[i * 2 + 1]] * p) * 0.5f;
+            }
+        });
+        return visible + mPicker.raycastBatch(mRays.data(), kRays, FLT_MAX, mHits.data(), &jobs);
+    }
+
+private:
+    FrustumCuller mCuller;
+    Frustum mLeft, mRight;
+    Matrix4 mBones[kBones];
+    std::vector<Vector3> mPositions;
+    std::vector<Vector3> mSkinned;
+    std::vector<uint32_t> mBoneIndex;
+    Picker mPicker;
+    std::vector<Ray> mRays;
+    std::vector<Picker::Hit> mHits;
+};
+
+}
+
+// Scaling of one synthetic frame with the number of workers.  The calling
+// thread helps, so 1 worker is up to two cores busy.
+static void BM_JobSystem_Frame(benchmark::State & state) {
+    SyntheticFrame frame;
+    JobSystem jobs((uint32_t) state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(frame.run(jobs));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_JobSystem_Frame)->RangeMultiplier(2)->Range(1, 8)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Overhead per chunk with no work in it.
+static void BM_JobSystem_EmptyChunks(benchmark::State & state) {
+    JobSystem jobs((uint32_t) state.range(0));
+    for (auto _ : state)
+        jobs.parallelFor(1024, 1, [](uint32_t, uint32_t) {});
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_JobSystem_EmptyChunks)->Arg(1)->Arg(4)->UseRealTime();
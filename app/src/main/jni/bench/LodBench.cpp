@@ -0,0 +1,97 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include <FrameBufferObject.h>
+#include <MeshGenerator.h>
+#include <MeshSimplifier.h>
+#include <RenderStats.h>
+#include <Sphere.h>
+
+#include "AllocCounter.h"
+#include "BenchEnv.h"
+
+// Halving icospheres of 1280 and 5120 triangles, the work done per controller
+// component when its model loads.
+static void BM_MeshSimplifier_Halve(benchmark::State & state) {
+    MeshData mesh;
+    MeshGenerator::icosphere(1.0f, (uint32_t) state.range(0), mesh);
+    std::vector<uint32_t> out;
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        MeshSimplifier::simplify(mesh.vertices.data(), MeshData::kStride, mesh.getVertexCount(),
+                mesh.indices.data(), (uint32_t) mesh.indices.size(), (uint32_t) mesh.indices.size() / 2, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.counters["triangles"] = mesh.indices.size() / 3;
+}
+BENCHMARK(BM_MeshSimplifier_Halve)->Arg(3)->Arg(4)->Unit(benchmark::kMillisecond);
+
+// 64 spheres from 2 m to 40 m away, both eyes.  With state.range(0) set
+// each sphere picks its level from its projected size, otherwise they all
+// draw the full mesh.
+static void BM_Sphere_Row(benchmark::State & state) {
+    if (!BenchEnv::hasGL()) {
+        state.SkipWithError("no GLES 3 context");
+        return;
+    }
+    const int size = 128;
+    GLuint color = 0;
+    glGenTextures(1, &color);
+    glBindTexture(GL_TEXTURE_2D, color);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, size, size);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    FrameBufferObject * fbo = new FrameBufferObject(color, size, size);
+
+    const int count = 64;
+    std::vector<Sphere *> spheres;
+    for (int i = 0; i < count; i++) {
+        Vector3 pos((i % 8 - 3.5f) * 0.5f, (i / 8 - 3.5f) * 0.3f, -2.0f - i * 0.6f);
+        spheres.push_back(new Sphere(pos));
+        spheres.back()->setLodEnable(state.range(0) != 0);
+    }
+    if (spheres[0]->hasError() || fbo->hasError()) {
+        state.SkipWithError("Sphere init failed");
+    } else {
+        const float n = 0.1f, f = 100.0f;
+        Matrix4 projection(1, 0, 0, 0,
+                           0, 1, 0, 0,
+                           0, 0, -(f + n) / (f - n), -1,
+                           0, 0, -2 * f * n / (f - n), 0);
+        Matrix4 eyeLeft, eyeRight;
+        eyeLeft.translate(0.032f, 0, 0);
+        eyeRight.translate(-0.032f, 0, 0);
+        const Vector4 light(0, 0, 1, 0.5f);
+
+        fbo->bindFrameBuffer();
+        fbo->glViewportFull();
+        glEnable(GL_DEPTH_TEST);
+        for (auto _ : state) {
+            RenderStats::beginFrame();
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            for (int i = 0; i < count; i++) {
+                spheres[i]->draw(projection, eyeLeft, Matrix4(), light);
+                spheres[i]->draw(projection, eyeRight, Matrix4(), light);
+            }
+            glFinish();
+        }
+        fbo->unbindFrameBuffer();
+        state.counters["triangles"] = RenderStats::getTriangles();
+    }
+    for (int i = 0; i < count; i++)
+        delete spheres[i];
+    delete fbo;
+    glDeleteTextures(1, &color);
+}
+BENCHMARK(BM_Sphere_Row)->Arg(0)->Arg(1)->ArgNames({"lod"})->Unit(benchmark::kMillisecond);
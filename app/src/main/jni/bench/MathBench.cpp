@@ -0,0 +1,175 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#include <benchmark/benchmark.h>
+
+#include <Matrices.h>
+#include <Object.h>
+#include <Quaternion.h>
+#include <RaySphereIntersection.h>
+
+#include "AllocCounter.h"
+
+// A pose like the ones the sample multiplies every frame: rotation and translation.
+static Matrix4 makePose(float angle) {
+    Matrix4 m;
+    m.rotate(angle, 0.3f, 1.0f, 0.2f);
+    m.translate(0.2f, -0.3f, -0.4f);
+    return m;
+}
+
+static void BM_Matrix4_Multiply(benchmark::State & state) {
+    Matrix4 a = makePose(30), b = makePose(-45);
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        Matrix4 c = a * b;
+        benchmark::DoNotOptimize(c);
+    }
+}
+BENCHMARK(BM_Matrix4_Multiply);
+
+static void BM_Matrix4_Invert(benchmark::State & state) {
+    Matrix4 a = makePose(30);
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        Matrix4 m = a;
+        benchmark::DoNotOptimize(m.invert());
+    }
+}
+BENCHMARK(BM_Matrix4_Invert);
+
+static void BM_Matrix4_InvertGeneral(benchmark::State & state) {
+    Matrix4 a = makePose(30);
+    a[3] = 0.01f;  // Not affine, so invert() takes the general path.
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        Matrix4 m = a;
+        benchmark::DoNotOptimize(m.invert());
+    }
+}
+BENCHMARK(BM_Matrix4_InvertGeneral);
+
+static void BM_Matrix4_InvertAffine(benchmark::State & state) {
+    Matrix4 a = makePose(30);
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        Matrix4 m = a;
+        benchmark::DoNotOptimize(m.invertAffine());
+    }
+}
+BENCHMARK(BM_Matrix4_InvertAffine);
+
+static void BM_Matrix4_InvertEuclidean(benchmark::State & state) {
+    Matrix4 a = makePose(30);
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        Matrix4 m = a;
+        benchmark::DoNotOptimize(m.invertEuclidean());
+    }
+}
+BENCHMARK(BM_Matrix4_InvertEuclidean);
+
+// The same poses as dual quaternions, against Multiply and InvertEuclidean.
+static void BM_DualQuaternion_Multiply(benchmark::State & state) {
+    DualQuaternion a = DualQuaternion::fromMatrix(makePose(30));
+    DualQuaternion b = DualQuaternion::fromMatrix(makePose(-45));
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        DualQuaternion c = a * b;
+        benchmark::DoNotOptimize(c);
+    }
+}
+BENCHMARK(BM_DualQuaternion_Multiply);
+
+static void BM_DualQuaternion_Inverse(benchmark::State & state) {
+    DualQuaternion a = DualQuaternion::fromMatrix(makePose(30));
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        DualQuaternion c = a.inverse();
+        benchmark::DoNotOptimize(c);
+    }
+}
+BENCHMARK(BM_DualQuaternion_Inverse);
+
+// The 3DoF controller placement: the inverse head rotation times the
+// controller rotation, as hellovr.cpp did it with Euler angles and as it
+// does it now.
+static void BM_Pose3DoF_Euler(benchmark::State & state) {
+    const Matrix4 head = makePose(30), controller = makePose(-45);
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(head);
+        Matrix4 mat = head;
+        mat.invert();
+        float angleY = atan2f(-mat[8], mat[10]);
+        float angleX = asin(-mat[9]);
+        float angleZ = atan2f(mat[1], mat[5]);
+        mat.identity().rotateY(-angleY / M_PI * 180.0f);
+        mat.rotateX(angleX / M_PI * 180.0f);
+        mat.rotateZ(angleZ / M_PI * 180.0f);
+        mat *= controller;
+        benchmark::DoNotOptimize(mat);
+    }
+}
+BENCHMARK(BM_Pose3DoF_Euler);
+
+static void BM_Pose3DoF_Quaternion(benchmark::State & state) {
+    const Matrix4 head = makePose(30), controller = makePose(-45);
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(head);
+        Matrix4 mat = (Quaternion::fromMatrix(head).conjugate() * Quaternion::fromMatrix(controller)).toMatrix();
+        benchmark::DoNotOptimize(mat);
+    }
+}
+BENCHMARK(BM_Pose3DoF_Quaternion);
+
+static void BM_Quaternion_Slerp(benchmark::State & state) {
+    const Quaternion a = Quaternion::fromMatrix(makePose(30));
+    const Quaternion b = Quaternion::fromMatrix(makePose(-45));
+    float t = 0;
+    for (auto _ : state) {
+        t = t < 1 ? t + 0.01f : 0;
+        benchmark::DoNotOptimize(state.range(0) ? Quaternion::slerp(a, b, t) : Quaternion::nlerp(a, b, t));
+    }
+}
+BENCHMARK(BM_Quaternion_Slerp)->Arg(1)->Arg(0);
+
+// Matrix3::invert through the path the scene objects use for lighting.
+static void BM_Object_MakeNormalMatrix(benchmark::State & state) {
+    Object object;
+    Matrix4 view = makePose(30) * makePose(10);
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(view);
+        Matrix3 n = object.makeNormalMatrix(view);
+        benchmark::DoNotOptimize(n);
+    }
+}
+BENCHMARK(BM_Object_MakeNormalMatrix);
+
+// The controller ray test of MainApplication::drawControllers, hit and miss.
+static void BM_RaySphereIntersection(benchmark::State & state) {
+    const bool hit = state.range(0) != 0;
+    Point3D origin(0.2f, -0.3f, -0.4f);
+    Vector3D direction(hit ? 0.8f : -0.8f, 2.3f, -3.6f);
+    Sphere3D sphere(Point3D(1, 2, -4), 0.8f);
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        Ray3D ray(origin, direction, Vector3());
+        benchmark::DoNotOptimize(intersection(ray, sphere));
+        benchmark::DoNotOptimize(ray.collision);
+    }
+    state.SetLabel(hit ? "hit" : "miss");
+}
+BENCHMARK(BM_RaySphereIntersection)->Arg(1)->Arg(0);
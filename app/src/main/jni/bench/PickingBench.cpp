@@ -0,0 +1,121 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#include <stdlib.h>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <Picker.h>
+
+#include "AllocCounter.h"
+
+// Targets scattered in front of the viewer, like a room full of buttons.
+static void fillScene(Picker & picker, std::vector<Vector3> * centers, int count) {
+    srand(1);
+    for (int i = 0; i < count; i++) {
+        Vector3 c((rand() % 2000 - 1000) * 0.01f, (rand() % 2000 - 1000) * 0.01f, -(rand() % 2000) * 0.01f - 1);
+        Matrix4 m;
+        m.translate(c);
+        picker.addSphere(Vector3(0, 0, 0), 0.1f, m);
+        if (centers)
+            centers->push_back(c);
+    }
+    picker.update();
+}
+
+// Two controllers and the head.
+static void makeRays(Ray * rays) {
+    rays[0].set(Vector3(0.2f, -0.3f, -0.4f), Vector3(-0.05f, 0.1f, -1).normalize());
+    rays[1].set(Vector3(-0.2f, -0.3f, -0.4f), Vector3(0.05f, 0.1f, -1).normalize());
+    rays[2].set(Vector3(0, 0, 0), Vector3(0, 0, -1));
+}
+
+static void BM_Picking_Linear(benchmark::State & state) {
+    Picker picker;
+    std::vector<Vector3> centers;
+    fillScene(picker, &centers, state.range(0));
+    Ray rays[3];
+    makeRays(rays);
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        for (int r = 0; r < 3; r++) {
+            float best = FLT_MAX, t;
+            for (size_t i = 0; i < centers.size(); i++) {
+                if (intersectSphere(rays[r], centers[i], 0.1f, 0, best, t))
+                    best = t;
+            }
+            benchmark::DoNotOptimize(best);
+        }
+    }
+}
+BENCHMARK(BM_Picking_Linear)->Arg(1000)->Arg(10000);
+
+static void BM_Picking_Closest(benchmark::State & state) {
+    Picker picker;
+    fillScene(picker, NULL, state.range(0));
+    Ray rays[3];
+    makeRays(rays);
+    Picker::Hit hit;
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        for (int r = 0; r < 3; r++)
+            benchmark::DoNotOptimize(picker.raycastClosest(rays[r], FLT_MAX, hit));
+    }
+}
+BENCHMARK(BM_Picking_Closest)->Arg(1000)->Arg(10000);
+
+static void BM_Picking_Batch(benchmark::State & state) {
+    Picker picker;
+    fillScene(picker, NULL, state.range(0));
+    Ray rays[3];
+    makeRays(rays);
+    Picker::Hit hits[3];
+    AllocScope allocs(state);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(picker.raycastBatch(rays, 3, FLT_MAX, hits));
+}
+BENCHMARK(BM_Picking_Batch)->Arg(1000)->Arg(10000);
+
+// A few targets nudged per frame, then a query: the refit path.
+static void BM_Picking_MoveAndQuery(benchmark::State & state) {
+    Picker picker;
+    std::vector<Vector3> centers;
+    fillScene(picker, &centers, state.range(0));
+    Ray rays[3];
+    makeRays(rays);
+    Picker::Hit hits[3];
+    uint32_t frame = 0;
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        for (uint32_t i = 0; i < 8; i++) {
+            uint32_t id = (frame * 8 + i) % centers.size();
+            Matrix4 m;
+            m.translate(centers[id] + Vector3(0.05f * (frame % 4), 0, 0));
+            picker.setTransform(id, m);
+        }
+        benchmark::DoNotOptimize(picker.raycastBatch(rays, 3, FLT_MAX, hits));
+        frame++;
+    }
+}
+BENCHMARK(BM_Picking_MoveAndQuery)->Arg(1000)->Arg(10000);
+
+static void BM_Picking_Build(benchmark::State & state) {
+    Picker picker;
+    fillScene(picker, NULL, state.range(0));
+    for (auto _ : state) {
+        // Remove and re-add one target to force a rebuild.
+        Matrix4 m;
+        picker.remove(0);
+        picker.addSphere(Vector3(0, 0, 0), 0.1f, m);
+        picker.update();
+    }
+}
+BENCHMARK(BM_Picking_Build)->Arg(1000)->Arg(10000);
@@ -0,0 +1,41 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+
+#include <math.h>
+
+#include <benchmark/benchmark.h>
+
+#include <PoseHistory.h>
+
+// Push and predict for one device, the per frame work of acquireFramePose()
+// for each controller, by filter mode.
+static void BM_PoseHistory_Frame(benchmark::State & state) {
+    PoseHistory history;
+    history.setFilter((PoseHistory::FilterMode) state.range(0));
+    const int64_t frameNs = 13333333;
+    int64_t time = 0;
+    Matrix4 predicted;
+    for (auto _ : state) {
+        time += frameNs;
+        Matrix4 pose;
+        pose.rotateY(sinf(time / 1e9f) * 30.0f);
+        pose.translate(0.2f, 1.0f, -0.3f);
+        history.push(time, pose);
+        history.predict(time + frameNs, predicted);
+        benchmark::DoNotOptimize(predicted);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PoseHistory_Frame)
+    ->Arg(PoseHistory::kFilterNone)
+    ->Arg(PoseHistory::kFilterOneEuro)
+    ->Arg(PoseHistory::kFilterExponential);
@@ -0,0 +1,133 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#include <stdlib.h>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <RayPacket.h>
+
+// Scalar and packet versions of the same work, so the items/s columns compare
+// directly.
+
+static void makeRays(Ray * rays, int count) {
+    srand(2);
+    for (int i = 0; i < count; i++) {
+        Vector3 dir((rand() % 100 - 50) * 0.01f, (rand() % 100 - 50) * 0.01f, -1);
+        rays[i].set(Vector3(0, 0, 0), dir.normalize());
+    }
+}
+
+static void BM_RaySphere_Scalar4(benchmark::State & state) {
+    Ray rays[4];
+    makeRays(rays, 4);
+    Vector3 center(0.1f, 0.1f, -5);
+    float t[4];
+    for (auto _ : state) {
+        for (int i = 0; i < 4; i++)
+            benchmark::DoNotOptimize(intersectSphere(rays[i], center, 1.0f, 0, FLT_MAX, t[i]));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 4);
+}
+BENCHMARK(BM_RaySphere_Scalar4);
+
+static void BM_RaySphere_Packet4(benchmark::State & state) {
+    Ray rays[4];
+    makeRays(rays, 4);
+    RayPacket4 packet;
+    packet.set(rays, 4);
+    Vector3 center(0.1f, 0.1f, -5);
+    const float tMax[4] = { FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+    float t[4];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(intersectSphere4(packet, center, 1.0f, 0, tMax, t));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 4);
+}
+BENCHMARK(BM_RaySphere_Packet4);
+
+static void BM_RayAABB_Scalar4(benchmark::State & state) {
+    Ray rays[4];
+    makeRays(rays, 4);
+    AABB box(Vector3(-1, -1, -6), Vector3(1, 1, -4));
+    float t[4];
+    for (auto _ : state) {
+        for (int i = 0; i < 4; i++)
+            benchmark::DoNotOptimize(box.intersect(rays[i], 0, FLT_MAX, t[i]));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 4);
+}
+BENCHMARK(BM_RayAABB_Scalar4);
+
+static void BM_RayAABB_Packet4(benchmark::State & state) {
+    Ray rays[4];
+    makeRays(rays, 4);
+    RayPacket4 packet;
+    packet.set(rays, 4);
+    AABB box(Vector3(-1, -1, -6), Vector3(1, 1, -4));
+    const float tMax[4] = { FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+    float t[4];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(intersectAABB4(packet, box, 0, tMax, t));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * 4);
+}
+BENCHMARK(BM_RayAABB_Packet4);
+
+// One ray against n spheres, the inner loop of a linear pick.
+static void sphereArrays(int n, std::vector<float> & cx, std::vector<float> & cy,
+        std::vector<float> & cz, std::vector<float> & r) {
+    srand(4);
+    for (int i = 0; i < n; i++) {
+        cx.push_back((rand() % 2000 - 1000) * 0.01f);
+        cy.push_back((rand() % 2000 - 1000) * 0.01f);
+        cz.push_back(-(rand() % 2000) * 0.01f - 1);
+        r.push_back(0.1f);
+    }
+}
+
+static void BM_ClosestSphere_Scalar(benchmark::State & state) {
+    std::vector<float> cx, cy, cz, r;
+    sphereArrays(state.range(0), cx, cy, cz, r);
+    Ray ray;
+    makeRays(&ray, 1);
+    for (auto _ : state) {
+        float best = FLT_MAX, t;
+        int32_t index = -1;
+        for (size_t i = 0; i < cx.size(); i++) {
+            if (intersectSphere(ray, Vector3(cx[i], cy[i], cz[i]), r[i], 0, best, t)) {
+                best = t;
+                index = (int32_t) i;
+            }
+        }
+        benchmark::DoNotOptimize(index);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ClosestSphere_Scalar)->Arg(1024);
+
+static void BM_ClosestSphere_Packet(benchmark::State & state) {
+    std::vector<float> cx, cy, cz, r;
+    sphereArrays(state.range(0), cx, cy, cz, r);
+    Ray ray;
+    makeRays(&ray, 1);
+    for (auto _ : state) {
+        float t;
+        benchmark::DoNotOptimize(closestSphere(ray, cx.data(), cy.data(), cz.data(), r.data(),
+                (uint32_t) cx.size(), 0, FLT_MAX, t));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ClosestSphere_Packet)->Arg(1024);
@@ -0,0 +1,75 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <Object.h>
+#include <SceneGraph.h>
+
+#include "AllocCounter.h"
+
+// A few roots, each with a short chain of children, like controllers with
+// their buttons and a room of props.
+static void buildObjects(std::vector<Object> & objects) {
+    for (size_t i = 0; i < objects.size(); i++) {
+        Matrix4 m;
+        m.translate((float) (i % 10), 0, -(float) (i / 10));
+        objects[i].setTransform(m);
+        if (i % 8 != 0)
+            objects[i].setParent(&objects[i - 1]);
+    }
+}
+
+// Every object asks for its world and normal matrix, the way draw() does.
+static void BM_SceneGraph_ParentWalk(benchmark::State & state) {
+    std::vector<Object> objects(state.range(0));
+    buildObjects(objects);
+    Matrix4 sum;
+    for (auto _ : state) {
+        for (size_t i = 0; i < objects.size(); i++) {
+            const Matrix4 world = objects[i].getTransforms();
+            sum += world;
+            benchmark::DoNotOptimize(objects[i].makeNormalMatrix(world));
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SceneGraph_ParentWalk)->Arg(1000)->Arg(10000);
+
+// Same reads through the graph, with one root in 64 moving per frame.
+static void BM_SceneGraph_Update(benchmark::State & state) {
+    // Declared first: objects release their nodes on destruction.
+    SceneGraph graph;
+    std::vector<Object> objects(state.range(0));
+    buildObjects(objects);
+    for (size_t i = 0; i < objects.size(); i++)
+        objects[i].attachToGraph(&graph);
+    graph.update();
+
+    Matrix4 sum;
+    size_t frame = 0;
+    AllocScope allocs(state);
+    for (auto _ : state) {
+        for (size_t i = (frame++ % 8) * 8; i < objects.size(); i += 64)
+            objects[i].move(0, 0.001f, 0);
+        graph.update();
+        for (size_t i = 0; i < objects.size(); i++) {
+            sum += objects[i].getTransforms();
+            benchmark::DoNotOptimize(objects[i].getWorldNormalMatrix());
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SceneGraph_Update)->Arg(1000)->Arg(10000);
@@ -0,0 +1,51 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#include <benchmark/benchmark.h>
+
+#include "BenchEnv.h"
+
+static HostEglContext * sEgl = NULL;
+static Context * sContext = NULL;
+static bool sHasGL = false;
+
+bool BenchEnv::init() {
+    JavaVM * vm = NULL;
+    jsize vmCount = 0;
+    JNI_GetCreatedJavaVMs(&vm, 1, &vmCount);
+    sContext = new Context(vm);
+    sContext->init(NULL, NULL);
+    sEgl = new HostEglContext();
+    sHasGL = sEgl->init();
+    return sHasGL;
+}
+
+void BenchEnv::shutdown() {
+    delete sEgl;
+    sEgl = NULL;
+    sHasGL = false;
+    delete sContext;
+    sContext = NULL;
+}
+
+bool BenchEnv::hasGL() {
+    return sHasGL;
+}
+
+int main(int argc, char ** argv) {
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    BenchEnv::init();
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    BenchEnv::shutdown();
+    return 0;
+}
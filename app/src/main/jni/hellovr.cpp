@@ -14,16 +14,20 @@
 #include <limits>
 #include <sys/types.h>
 #include <sys/time.h>
+#include <time.h>
 #include <cstdlib>
 #include <math.h>
 #include <Texture.h>
 #include <Picture.h>
 #include <SkyBox.h>
+#include <SeaOfCubes.h>
+#include <Environment.h>
 #include <ControllerAxes.h>
 #include <ControllerCube.h>
 #include <Controller.h>
 #include <ReticlePointer.h>
 #include <FrameBufferObject.h>
+#include <RenderTargetManager.h>
 #include <GLES2/gl2ext.h>
 #include <GLES3/gl3.h>
 
@@ -35,7 +39,15 @@
 #include <wvr/wvr_overlay.h>
 #include <wvr/wvr_system.h>
 #include <wvr/wvr_events.h>
-#include <RaySphereIntersection.h>
+#include <Picker.h>
+#include <SceneGraph.h>
+#include <Frustum.h>
+#include <RenderStats.h>
+#include <RenderState.h>
+#include <GpuTimer.h>
+#include <Context.h>
+#include <Quaternion.h>
+#include <JobSystem.h>
 
 #include "hellovr.h"
 
@@ -49,17 +61,48 @@
 bool gDebug = true;
 bool gDebugOld = gDebug;
 bool gMsaa = true;
+// Samples while gMsaa is on: 2 or 4, lowered to what the device supports.
+int gMsaaSamples = 4;
 bool gScene = false;
 bool gSceneOld = gScene;
+// Grid lines from the fragment shader instead of the land texture, see Floor.
+bool gProceduralFloor = false;
+// A SceneFile to show around the user, an asset path or an absolute path.
+std::string gEnvironment;
 bool gUseScale = true;
 float gScale = 1;
+// Follow measured GPU time.  Stepping the scale by hand turns it off.
+bool gDynamicScale = true;
+// Re-fetch the head pose before each eye is drawn.
+bool gLateLatch = true;
 
 #define LOGDIF(args...) if (gDebug) LOGD(args)
 
 #define VR_MAX_CLOCKS 200
 
-// To demonstrate how to use heavy-effect foveated rendering
-#define ENABLE_LOW_FOVEATED_RENDERING 0
+// The clock of WVR pose timestamps.
+static int64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Foveated rendering, set from the activity flags.  Forced skips the wait
+// for GPU load, for comparing with and without.
+Foveation::Mode gFoveationMode = Foveation::kOff;
+Foveation::Preset gFoveationPreset = Foveation::kPresetLow;
+bool gFoveationForced = false;
+
+// A file of recorded input.  Replayed instead of the controllers when it
+// exists, otherwise written at shutdown.  Empty records nothing.
+std::string gInputTrace;
+
+// Smoothing of controller poses.  The ray and the model use the same result.
+PoseHistory::FilterMode gControllerFilter = PoseHistory::kFilterOneEuro;
+
+// How the simulation runs against rendering.  Overlap simulates the next
+// frame on a worker while this one is drawn.
+FramePipeline::Mode gPipelineMode = FramePipeline::kOverlap;
 
 // To demonstrate how to use WaveVR AdaptiveQuality
 #define DISABLE_ADAPTIVE_QUALITY 0
@@ -78,12 +121,40 @@ static void dumpMatrix(const char * name, const Matrix4& mat) {
         ptr[3], ptr[7], ptr[11], ptr[15]);
 }
 
+// Analog axes are asked for only while the input is touched.
+static void readAnalogAxis(void * /*data*/, uint32_t device, uint32_t input, float& x, float& y) {
+    WVR_Axis_t axis = WVR_GetInputAnalogAxis((WVR_DeviceType) device, (WVR_InputId) input);
+    x = axis.x;
+    y = axis.y;
+}
+
+// Input events into the InputSystem.  Other events are left alone.
+static void feedInput(InputSystem& input, const WVR_Event_t& event) {
+    switch (event.common.type) {
+    case WVR_EventType_ButtonPressed:
+    case WVR_EventType_ButtonUnpressed:
+        input.onButton(event.input.device.deviceType, event.input.inputId,
+                event.common.type == WVR_EventType_ButtonPressed);
+        break;
+    case WVR_EventType_TouchTapped:
+    case WVR_EventType_TouchUntapped:
+        input.onTouch(event.input.device.deviceType, event.input.inputId,
+                event.common.type == WVR_EventType_TouchTapped);
+        break;
+    case WVR_EventType_DeviceConnected:
+    case WVR_EventType_DeviceDisconnected:
+        input.onConnect(event.device.deviceType, event.common.type == WVR_EventType_DeviceConnected);
+        break;
+    default:
+        break;
+    }
+}
+
 MainApplication::MainApplication()
-        : mControllerCount(0)
+        : mResetWorld(true)
+        , mSimFrameIndex(0)
         , mControllerCount_Last(-1)
-        , mValidPoseCount(0)
         , mValidPoseCount_Last(-1)
-        , mPoseClasses("")
         , m3DOF(true)
         , mMove(true)
         , mLight(true)
@@ -100,7 +171,28 @@ MainApplication::MainApplication()
     memset(mDevClassChar, 0, sizeof(mDevClassChar));
     mSkyBox = NULL;
     mSphere=NULL;
+    mSceneGraph=NULL;
+    mPicker=NULL;
+    mSpherePickId=Picker::kInvalidId;
     mFloor=NULL;
+    mCuller=NULL;
+    mSphereCull=FrustumCuller::kAlwaysVisible;
+    mFloorCull=FrustumCuller::kAlwaysVisible;
+    mSeaOfCubes=NULL;
+    mSeaOfCubesCull=FrustumCuller::kAlwaysVisible;
+    mEnvironment=NULL;
+    mEnvironmentCull=FrustumCuller::kAlwaysVisible;
+    mGpuTimer=NULL;
+    mRenderTargets=NULL;
+    mFoveationTraceTime=0;
+    mFoveationEnabled=false;
+    mInput.setAxisInputs((1u << WVR_InputId_Alias1_Touchpad) | (1u << WVR_InputId_Alias1_Thumbstick)
+            | (1u << WVR_InputId_Alias1_Trigger));
+    mInput.setAxisReader(readAnalogAxis, NULL);
+    mRequestedSamples=0;
+    mFramePeriodNs=1000000000LL / 75;
+    mSyncPoseAgeNs=0;
+    mSubmitPoseAgeNs=0;
     mGridPicture = NULL;
     mReticlePointer = NULL;
 #if defined(USE_CONTROLLER) || defined(USE_CUSTOM_CONTROLLER)
@@ -109,12 +201,15 @@ MainApplication::MainApplication()
 #else
     mControllerAxes = NULL;
     memset(mControllerCubeTableById, 0, sizeof(mControllerCubeTableById));
+    for (int i = 0; i < WVR_DEVICE_COUNT_LEVEL_1; i++)
+        mControllerCubeCull[i] = FrustumCuller::kAlwaysVisible;
 #endif
     LOGI("MainApplication::MainApplication()");
 }
 
 MainApplication::~MainApplication() {
     // work is done in Shutdown
+    mPipeline.stop();
     LOGI("Shutdown");
 }
 
@@ -171,13 +266,16 @@ bool MainApplication::initGL() {
     printGLString("Vendor", GL_VENDOR);
     printGLString("Renderer", GL_RENDERER);
     printGLString("Extensions", GL_EXTENSIONS);
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LEQUAL);
-    glDepthMask(true);
+    RenderState::invalidate();
+    RenderState::apply(RenderState::kOpaque);
     mLUV[0] = 0.0f;
     mLUV[1] = 0.0f;
     mUUV[0] = gScale;
     mUUV[1] = gScale;
+    mGpuTimer = new GpuTimer();
+    mResolution.reset();
+    if (gUseScale && gDynamicScale)
+        setRenderScale(mResolution.getScale());
     GLenum glerr = glGetError();
     if (glerr != GL_NO_ERROR) {
         LOGE("glGetError() before initGL: %d", glerr);
@@ -186,16 +284,40 @@ bool MainApplication::initGL() {
 #define OBJ_ERROR_CHECK(obj) if (obj->hasError() || obj->hasGLError()) return false
 
 
-    mFloor = new Floor();
+    mSceneGraph = new SceneGraph();
+    mCuller = new FrustumCuller();
+
+    mFloor = new Floor(gProceduralFloor ? Floor::kProcedural : Floor::kTextured);
     OBJ_ERROR_CHECK(mFloor);
+    mFloor->attachToGraph(mSceneGraph);
+
+    // Optional, the sample runs on without it.
+    if (!gEnvironment.empty()) {
+        mEnvironment = new Environment(gEnvironment.c_str());
+        if (mEnvironment->hasError()) {
+            LOGW("Unable to load the environment %s", gEnvironment.c_str());
+            delete mEnvironment;
+            mEnvironment = NULL;
+        } else {
+            mEnvironment->attachToGraph(mSceneGraph);
+        }
+    }
 
     oriSpherePos=Vector3(1,2,-4);
     mSphere = new Sphere(oriSpherePos);
     OBJ_ERROR_CHECK(mSphere);
+    mSphere->attachToGraph(mSceneGraph);
+
+    mPicker = new Picker();
+    Matrix4 sphereTransform;
+    sphereTransform.translate(oriSpherePos);
+    mSpherePickId = mPicker->addSphere(Vector3(0, 0, 0), mSphere->getRadius(), sphereTransform, mSphere);
+    mSimSphereCenter = oriSpherePos;
 
     // Setup Scenes
     mSkyBox = new SkyBox(gDebug);
     OBJ_ERROR_CHECK(mSkyBox);
+    mSkyBox->setCrossFade(0.5f);
     mLightDir = mSkyBox->getLightDir();
 
 
@@ -206,6 +328,8 @@ bool MainApplication::initGL() {
 #if defined(USE_CONTROLLER)
     mControllerObjs[0] = new Controller(WVR_DeviceType_Controller_Right);
     mControllerObjs[1] = new Controller(WVR_DeviceType_Controller_Left);
+    mControllerObjs[0]->setInputSystem(&mInput);
+    mControllerObjs[1]->setInputSystem(&mInput);
 #elif defined(USE_CUSTOM_CONTROLLER)
     mControllerObjs[0] = new CustomController(WVR_DeviceType_Controller_Right);
     mControllerObjs[1] = new CustomController(WVR_DeviceType_Controller_Left);
@@ -231,45 +355,10 @@ bool MainApplication::initGL() {
     mIndexRight = 0;
 
     mLeftEyeQ = WVR_ObtainTextureQueue(WVR_TextureTarget_2D, WVR_TextureFormat_RGBA, WVR_TextureType_UnsignedByte, mRenderWidth, mRenderHeight, 0);
-    for (int i = 0; i < WVR_GetTextureQueueLength(mLeftEyeQ); i++) {
-        FrameBufferObject* fbo;
-
-        fbo = new FrameBufferObject((int)(long)WVR_GetTexture(mLeftEyeQ, i).id, mRenderWidth, mRenderHeight, true);
-        if (!fbo) return false;
-        if (fbo->hasError())  {
-            delete fbo;
-            return false;
-        }
-        mLeftEyeFBOMSAA.push_back(fbo);
-
-        fbo = new FrameBufferObject((int)(long)WVR_GetTexture(mLeftEyeQ, i).id, mRenderWidth, mRenderHeight);
-        if (!fbo) return false;
-        if (fbo->hasError())  {
-            delete fbo;
-            return false;
-        }
-        mLeftEyeFBO.push_back(fbo);
-    }
     mRightEyeQ = WVR_ObtainTextureQueue(WVR_TextureTarget_2D, WVR_TextureFormat_RGBA, WVR_TextureType_UnsignedByte, mRenderWidth, mRenderHeight, 0);
-    for (int i = 0; i < WVR_GetTextureQueueLength(mRightEyeQ); i++) {
-        FrameBufferObject* fbo;
-
-        fbo = new FrameBufferObject((int)(long)WVR_GetTexture(mRightEyeQ, i).id, mRenderWidth, mRenderHeight, true);
-        if (!fbo) return false;
-        if (fbo->hasError())  {
-            delete fbo;
-            return false;
-        }
-        mRightEyeFBOMSAA.push_back(fbo);
-
-        fbo = new FrameBufferObject((int)(long)WVR_GetTexture(mRightEyeQ, i).id, mRenderWidth, mRenderHeight);
-        if (!fbo) return false;
-        if (fbo->hasError())  {
-            delete fbo;
-            return false;
-        }
-        mRightEyeFBO.push_back(fbo);
-	}
+    mRenderTargets = new RenderTargetManager();
+    if (!initRenderTargets())
+        return false;
 
 #if defined(USE_CONTROLLER) || defined(USE_CUSTOM_CONTROLLER)
     setupControllers();
@@ -282,9 +371,36 @@ bool MainApplication::initGL() {
     glEnable(GL_CULL_FACE);
     glFrontFace(GL_CCW);
 
-#if ENABLE_LOW_FOVEATED_RENDERING
-    WVR_RenderFoveationMode(WVR_FoveationMode_Enable);
-#endif
+    // Replays a recorded gaze in Foveation::kGaze when the asset is there.
+    {
+        Context * context = Context::getInstance();
+        AssetFile traceFile(context->getAssetManager(), "foveation/gaze_trace.txt");
+        if (traceFile.open()) {
+            char * text = traceFile.toString();
+            if (mFoveationTrace.parse(text))
+                LOGI("Foveation trace: %u samples", mFoveationTrace.getCount());
+            delete [] text;
+        }
+    }
+    if (!gInputTrace.empty()) {
+        if (mInputTrace.load(gInputTrace.c_str())) {
+            LOGI("Replaying %u input records from %s", mInputTrace.getCount(), gInputTrace.c_str());
+            mInput.setReplay(&mInputTrace);
+        } else {
+            LOGI("Recording input to %s", gInputTrace.c_str());
+            mInput.setRecording(&mInputTrace);
+        }
+    }
+    // Pose prediction falls back to one frame ahead when the runtime
+    // does not say.
+    {
+        WVR_RenderProps_t props;
+        if (WVR_GetRenderProps(&props) && props.refreshRate > 0)
+            mFramePeriodNs = (int64_t) (1000000000.0f / props.refreshRate);
+    }
+    mFoveation.setBudget(mResolution.getTargetTime());
+    mFoveation.setMode(Foveation::kOff);
+    WVR_RenderFoveationMode(WVR_FoveationMode_Disable);
 
 #if defined(DISABLE_ADAPTIVE_QUALITY) && DISABLE_ADAPTIVE_QUALITY
     // 1. WaveVR AQ is enabled with WVR_QualityStrategy_SendQualityEvent by default from WaveVR SDK 3.2.0
@@ -303,11 +419,35 @@ bool MainApplication::initGL() {
      */
 #endif
 
+    // Last, so the simulation only ever sees a complete scene.
+    mPipeline.start(gPipelineMode, this);
     return true;
 }
 
+// Only the framebuffers for the current gMsaa exist.  Toggling it rebuilds them.
+bool MainApplication::initRenderTargets() {
+    std::vector<GLuint> eyeTextures[RenderTargetManager::kEyeCount];
+    for (int i = 0; i < WVR_GetTextureQueueLength(mLeftEyeQ); i++)
+        eyeTextures[WVR_Eye_Left].push_back((GLuint)(long)WVR_GetTexture(mLeftEyeQ, i).id);
+    for (int i = 0; i < WVR_GetTextureQueueLength(mRightEyeQ); i++)
+        eyeTextures[WVR_Eye_Right].push_back((GLuint)(long)WVR_GetTexture(mRightEyeQ, i).id);
+    mRequestedSamples = gMsaa ? gMsaaSamples : 1;
+    return mRenderTargets->init(eyeTextures, mRenderWidth, mRenderHeight, mRequestedSamples);
+}
+
 void MainApplication::shutdownGL() {
     LOGENTRY();
+    mPipeline.stop();
+
+    if (!mInput.isReplaying() && !gInputTrace.empty()) {
+        if (mInputTrace.save(gInputTrace.c_str()))
+            LOGI("Saved %u input records to %s", mInputTrace.getCount(), gInputTrace.c_str());
+        mInput.setRecording(NULL);
+    }
+
+    if (mGpuTimer != NULL)
+        delete mGpuTimer;
+    mGpuTimer = NULL;
 
 
     if (mFloor != NULL )
@@ -318,6 +458,22 @@ void MainApplication::shutdownGL() {
         delete mSphere;
     mSphere = NULL;
 
+    if (mPicker != NULL)
+        delete mPicker;
+    mPicker = NULL;
+
+    if (mCuller != NULL)
+        delete mCuller;
+    mCuller = NULL;
+
+    if (mSeaOfCubes != NULL)
+        delete mSeaOfCubes;
+    mSeaOfCubes = NULL;
+
+    if (mEnvironment != NULL)
+        delete mEnvironment;
+    mEnvironment = NULL;
+
     if (mSkyBox != NULL)
         delete mSkyBox;
     mSkyBox = NULL;
@@ -351,21 +507,20 @@ void MainApplication::shutdownGL() {
         delete mReticlePointer;
     mReticlePointer = NULL;
 
-    if (mLeftEyeQ != 0) {
-        for (int i = 0; i < WVR_GetTextureQueueLength(mLeftEyeQ); i++) {
-            delete mLeftEyeFBOMSAA.at(i);
-            delete mLeftEyeFBO.at(i);
-        }
+    // After the objects, which release their nodes on delete.
+    if (mSceneGraph != NULL)
+        delete mSceneGraph;
+    mSceneGraph = NULL;
+
+    if (mRenderTargets != NULL)
+        delete mRenderTargets;
+    mRenderTargets = NULL;
+
+    if (mLeftEyeQ != 0)
         WVR_ReleaseTextureQueue(mLeftEyeQ);
-    }
 
-    if (mRightEyeQ != 0) {
-        for (int i = 0; i < WVR_GetTextureQueueLength(mRightEyeQ); i++) {
-            delete mRightEyeFBOMSAA.at(i);
-            delete mRightEyeFBO.at(i);
-        }
+    if (mRightEyeQ != 0)
         WVR_ReleaseTextureQueue(mRightEyeQ);
-    }
 }
 
 void MainApplication::shutdownVR() {
@@ -374,63 +529,32 @@ void MainApplication::shutdownVR() {
 
 
 
-class ControllerState {
-private:
-    bool mLastTouchpadPressed;
-    bool mTouchpadClicked;
-    bool mMenuClicked;
-    bool mLastMenuPressed;
-
-public:
-
-    ControllerState() : mLastTouchpadPressed(false), mTouchpadClicked(false), mLastMenuPressed(false), mMenuClicked(false) {
-    }
-
-    void updateState(WVR_DeviceType deviceType) {
-        bool bTouchpadPressed = WVR_GetInputButtonState(deviceType, WVR_InputId_Alias1_Touchpad);
-        if (mLastTouchpadPressed && (bTouchpadPressed) == 0) {
-            mTouchpadClicked = true;
-        } else {
-            mTouchpadClicked = false;
-        }
-        mLastTouchpadPressed = bTouchpadPressed;
-
-        bool bMenuPressed = WVR_GetInputButtonState(deviceType, WVR_InputId_Alias1_Menu);
-        if (mLastMenuPressed && (bMenuPressed) == 0) {
-            mMenuClicked = true;
-        } else {
-            mMenuClicked = false;
-        }
-        mLastMenuPressed = bMenuPressed;
-    }
-
-    inline bool touchpadClicked() const {
-        return mTouchpadClicked;
-    }
-
-    inline bool menuClicked() const {
-        return mMenuClicked;
-    }
-};
-
-void MainApplication::moveSphereHandler() {
+// Simulation side.  Only the focused controller's button moves the sphere.
+void MainApplication::moveSphere(WVR_DeviceType request) {
     Vector3 pos;
 
-    if (!mSphere) return;
-    if (mCurFocusController==WVR_DeviceType_Controller_Right) {
-        if(mSphere->getCenter()==oriSpherePos){
-            pos=Vector3(1,0,0)+mSphere->getCenter();
+    if (request != mCurFocusController) return;
+    if (request==WVR_DeviceType_Controller_Right) {
+        if(mSimSphereCenter==oriSpherePos){
+            pos=Vector3(1,0,0)+mSimSphereCenter;
         }else{
             pos=oriSpherePos;
         }
-        mSphere->setSpherePos(pos);
-    } else if (mCurFocusController==WVR_DeviceType_Controller_Left) {
-        if(mSphere->getCenter()==oriSpherePos){
-            pos=Vector3(-1,0,0)+mSphere->getCenter();
+    } else if (request==WVR_DeviceType_Controller_Left) {
+        if(mSimSphereCenter==oriSpherePos){
+            pos=Vector3(-1,0,0)+mSimSphereCenter;
         }else{
             pos=oriSpherePos;
         }
-        mSphere->setSpherePos(pos);
+    } else {
+        return;
+    }
+    mSimSphereCenter = pos;
+
+    if (mPicker) {
+        Matrix4 sphereTransform;
+        sphereTransform.translate(pos);
+        mPicker->setTransform(mSpherePickId, sphereTransform);
     }
 }
 
@@ -439,18 +563,45 @@ void MainApplication::moveSphereHandler() {
 //-----------------------------------------------------------------------------
 bool MainApplication::handleInput() {
     LOGENTRY();
-    static ControllerState states[WVR_DEVICE_COUNT_LEVEL_1];
 
     bool resolutionChange = false;
 
     if (gScene != gSceneOld) {
         gSceneOld = gScene;
+        if (gScene && mSeaOfCubes == NULL) {
+            // 22^3 cubes in front of the user, above the floor.
+            mSeaOfCubes = new SeaOfCubes(22, 22, 22, 0.6f);
+            if (mSeaOfCubes->hasError()) {
+                LOGE("SeaOfCubes init failed");
+                delete mSeaOfCubes;
+                mSeaOfCubes = NULL;
+            } else {
+                Matrix4 transform;
+                mSeaOfCubes->setTransform(transform.translate(0, 7, -10));
+                mSeaOfCubes->attachToGraph(mSceneGraph);
+            }
+        }
+        if (mSeaOfCubes)
+            mSeaOfCubes->setEnable(gScene);
+    }
+
+    const Floor::Mode floorMode = gProceduralFloor ? Floor::kProcedural : Floor::kTextured;
+    if (mFloor != NULL && mFloor->getMode() != floorMode) {
+        Floor * floor = new Floor(floorMode);
+        if (floor->hasError()) {
+            LOGE("Floor mode %d init failed", floorMode);
+            delete floor;
+        } else {
+            delete mFloor;
+            mFloor = floor;
+            mFloor->attachToGraph(mSceneGraph);
+        }
     }
 
     if (gDebug != gDebugOld) {
         gDebugOld = gDebug;
+        // Loads in the background, renderFrame() picks it up.
         mSkyBox->setDebug(gDebug);
-        mLightDir = mSkyBox->getLightDir();
         setupCameras();
     }
 
@@ -471,42 +622,12 @@ bool MainApplication::handleInput() {
                 LOGI("WVR_EventType_DeviceDisconnected");
             }
         }
+        feedInput(mInput, event);
         processVREvent(event);
 
 #if defined(USE_CONTROLLER) || defined(USE_CUSTOM_CONTROLLER)
             handleControllerConnectEvent(isCtrlerStatusChange);
 #endif
-
-        if (event.common.type == WVR_EventType_ButtonPressed) {
-            if (event.device.deviceType == WVR_DeviceType_Controller_Right && event.input.inputId == WVR_InputId_Alias1_Bumper
-                && mCurFocusController==WVR_DeviceType_Controller_Right){
-                moveSphereHandler();
-            }
-            if (event.device.deviceType == WVR_DeviceType_Controller_Left && event.input.inputId == WVR_InputId_Alias1_Bumper
-                && mCurFocusController==WVR_DeviceType_Controller_Left){
-                moveSphereHandler();
-            }
-
-            if (event.device.deviceType == WVR_DeviceType_Controller_Right && event.input.inputId == WVR_InputId_Alias1_Trigger
-                && mCurFocusController==WVR_DeviceType_Controller_Right){
-                moveSphereHandler();
-            }
-            if (event.device.deviceType == WVR_DeviceType_Controller_Left && event.input.inputId == WVR_InputId_Alias1_Trigger
-                && mCurFocusController==WVR_DeviceType_Controller_Left){
-                moveSphereHandler();
-            }
-
-            if (event.device.deviceType == WVR_DeviceType_Controller_Right && event.input.inputId == WVR_InputId_Alias1_Touchpad
-                && mCurFocusController==WVR_DeviceType_Controller_Right){
-                moveSphereHandler();
-            }
- 
-            if (event.device.deviceType == WVR_DeviceType_Controller_Left && event.input.inputId == WVR_InputId_Alias1_Touchpad
-                && mCurFocusController==WVR_DeviceType_Controller_Left){
-                moveSphereHandler();
-            }
-
-        }
     }
     if (resolutionChange) {
         switchResolution();
@@ -515,31 +636,68 @@ bool MainApplication::handleInput() {
 }
 
 void MainApplication::switchResolution() {
-#if ENABLE_LOW_FOVEATED_RENDERING
-    LOGI("menu key pressed");
-#else
     if (gUseScale == true) {
-            if (std::abs(gScale - 1.0) <= std::numeric_limits<float>::epsilon()) {
-                gScale = 0.5;
-            } else {
-                gScale += 0.1;
-            }
-            mUUV[0] = gScale;
-            mUUV[1] = gScale;
-
-            FrameBufferObject* fbo=NULL;
+        gDynamicScale = false;
+        if (std::abs(gScale - 1.0) <= std::numeric_limits<float>::epsilon()) {
+            setRenderScale(0.5);
+        } else {
+            setRenderScale(gScale + 0.1);
+        }
+    }
+}
 
-            for (int i = 0; i < WVR_GetTextureQueueLength(mLeftEyeQ); i++) {
-                fbo = gMsaa ? mLeftEyeFBOMSAA.at(i) : mLeftEyeFBO.at(i);
-                fbo->resizeFrameBuffer(gScale);
-            }
+// Picks up gFoveationMode and moves the focal point.  The focus is a head
+// space direction: the trace for gaze, as this runtime has no eye tracker,
+// or the ray of the focused controller.
+//
+// The runtime stays enabled only while the ramp has strength.  Enabled and
+// given no parameters, WVR_PreRenderEye would apply its default foveation.
+void MainApplication::updateFoveation(float gpuTime, const FramePacket& packet) {
+    const FramePose& framePose = packet.pose;
+    if (gFoveationMode != mFoveation.getMode())
+        mFoveation.setMode(gFoveationMode);
+    mFoveation.setPreset(gFoveationPreset);
+    mFoveation.setForced(gFoveationForced);
+    mFoveation.update(gpuTime);
+    if (mFoveation.isActive() != mFoveationEnabled) {
+        mFoveationEnabled = mFoveation.isActive();
+        WVR_RenderFoveationMode(mFoveationEnabled ? WVR_FoveationMode_Enable : WVR_FoveationMode_Disable);
+    }
 
-            for (int i = 0; i < WVR_GetTextureQueueLength(mRightEyeQ); i++) {
-                fbo = gMsaa ? mRightEyeFBOMSAA.at(i) : mRightEyeFBO.at(i);
-                fbo->resizeFrameBuffer(gScale);
-            }
+    if (gFoveationMode == Foveation::kGaze && mFoveationTrace.getCount() > 0) {
+        mFoveationTraceTime += mTimeDiff;
+        mFoveation.setFocusDirection(mFoveationTrace.sample(mFoveationTraceTime));
+    } else if (gFoveationMode == Foveation::kController) {
+        for (uint32_t id = WVR_DEVICE_HMD + 1; id < WVR_DEVICE_COUNT_LEVEL_1; ++id) {
+            if (framePose.devices[id].type != packet.focusController || !framePose.devices[id].pose.isValidPose)
+                continue;
+            Matrix4 headFromTracking = framePose.deviceToTracking[WVR_DEVICE_HMD];
+            headFromTracking.invert();
+            mFoveation.setFocusDirection(headFromTracking * (framePose.deviceToTracking[id] * Vector3(0, 0, -1)));
+            break;
+        }
     }
-#endif
+}
+
+// NULL when no foveation applies to this frame, as WVR_PreRenderEye takes it.
+const WVR_RenderFoveationParams_t * MainApplication::getFoveationParams(const Matrix4& projection,
+        WVR_RenderFoveationParams_t& params) const {
+    Foveation::Params fov;
+    if (!mFoveation.getParams(projection, fov))
+        return NULL;
+    params.focalX = fov.focalX;
+    params.focalY = fov.focalY;
+    params.fovealFov = fov.fovealFov;
+    params.periQuality = (WVR_PeripheralQuality) fov.peripheral;
+    return &params;
+}
+
+// Only the viewport and the submitted UVs change.  The eye buffers keep
+// their full size, so a new scale costs no reallocation.
+void MainApplication::setRenderScale(float scale) {
+    gScale = scale > 1 ? 1 : scale;
+    mUUV[0] = gScale;
+    mUUV[1] = gScale;
 }
 
 void MainApplication::switchInteractionMode() {
@@ -685,6 +843,8 @@ void MainApplication::processVREvent(const WVR_Event_t & event) {
              * 2. Or, you can adjust the rendering resolution lower gradually by re-create texture queue, disable MSAA, etc.
              */
             LOGI("[Sample] Get WVR_EventType_RecommendedQuality_Lower");
+            if (gUseScale && gDynamicScale)
+                setRenderScale(mResolution.requestLower());
         }
         break;
     case WVR_EventType_RecommendedQuality_Higher:
@@ -694,6 +854,8 @@ void MainApplication::processVREvent(const WVR_Event_t & event) {
              * 2. Or, you can adjust the rendering resolution higher ASAP by re-create texture queue, enable MSAA, etc.
              */
             LOGI("[Sample] Get WVR_EventType_RecommendedQuality_Higher");
+            if (gUseScale && gDynamicScale)
+                setRenderScale(mResolution.requestHigher());
         }
         break;
     default:
@@ -736,23 +898,55 @@ bool MainApplication::renderFrame() {
 
     unsigned int ext = WVR_SubmitExtend_Default;
 
+    RenderStats::beginFrame();
+    if ((gMsaa ? gMsaaSamples : 1) != mRequestedSamples && !initRenderTargets()) {
+        LOGE("Failed to rebuild the render targets");
+        return true;
+    }
 	mIndexLeft = WVR_GetAvailableTextureIndex(mLeftEyeQ);
     mIndexRight = WVR_GetAvailableTextureIndex(mRightEyeQ);
 
     //LOGD("renderFrame start");
-    // for now as fast as possible
-    drawControllers();
-
-    if (mInteractionMode == WVR_InteractionMode_Gaze) {
-        drawReticlePointer();
+    // Input is done.  The packet carries the poses and everything the
+    // simulation worked out from them; only GL work is left here.
+    const FramePacket& packet = nextPacket();
+    const FramePose& framePose = packet.pose;
+    if (framePose.devices[WVR_DEVICE_HMD].pose.isValidPose)
+        updateEyeToHeadMatrix(framePose.devices[WVR_DEVICE_HMD].pose.is6DoFPose);
+
+#if !defined(USE_CONTROLLER) && !defined(USE_CUSTOM_CONTROLLER)
+    if (packet.hasAxes)
+        mControllerAxes->setVertices(packet.axesVertices, packet.axesVertexCount);
+#endif
+    if (packet.hasReticle)
+        mReticlePointer->setVertices(packet.reticleVertices, packet.reticleVertexCount);
+    if (mSphere) {
+        if (!(mSphere->getCenter() == packet.sphereCenter)) {
+            Vector3 center = packet.sphereCenter;
+            mSphere->setSpherePos(center);
+        }
+        mSphere->setSphereColor(packet.sphereColor);
     }
-    renderStereoTargets();
+
+    // Once per frame, after input may have moved things.
+    if (mSceneGraph)
+        mSceneGraph->update();
+    if (mSkyBox && mSkyBox->update(monotonicNs()))
+        mLightDir = mSkyBox->getLightDir();
+    cullScene(framePose);
+    WVR_PoseState_t submitPoses[2];
+    mGpuTimer->begin();
+    renderStereoTargets(framePose, submitPoses);
+    mGpuTimer->end();
+    float gpuTime;
+    if (!mGpuTimer->poll(gpuTime))
+        gpuTime = 0;
+    if (gpuTime > 0 && gUseScale && gDynamicScale)
+        setRenderScale(mResolution.update(gpuTime));
+    updateFoveation(gpuTime, packet);
     ext |= WVR_SubmitExtend_Default;
-#if ENABLE_LOW_FOVEATED_RENDERING
-#else
     if (gScale < 1 && gScale > 0)
         ext |= WVR_SubmitExtend_PartialTexture;
-#endif
 
     WVR_TextureParams_t leftEyeTexture = WVR_GetTexture(mLeftEyeQ, mIndexLeft);
     WVR_SubmitError e;
@@ -761,16 +955,13 @@ bool MainApplication::renderFrame() {
     leftEyeTexture.layout.leftLowUVs.v[1] = 0;
     leftEyeTexture.layout.rightUpUVs.v[0] = 1;
     leftEyeTexture.layout.rightUpUVs.v[1] = 1;
-#if ENABLE_LOW_FOVEATED_RENDERING
-#else
         if (gScale < 1 && gScale > 0) {
             leftEyeTexture.layout.leftLowUVs.v[0] = mLUV[0];
             leftEyeTexture.layout.leftLowUVs.v[1] = mLUV[1];
             leftEyeTexture.layout.rightUpUVs.v[0] = mUUV[0];
             leftEyeTexture.layout.rightUpUVs.v[1] = mUUV[1];
         }
-#endif
-        e = WVR_SubmitFrame(WVR_Eye_Left, &leftEyeTexture, NULL, (WVR_SubmitExtend)ext);
+        e = WVR_SubmitFrame(WVR_Eye_Left, &leftEyeTexture, &submitPoses[WVR_Eye_Left], (WVR_SubmitExtend)ext);
         if (e != WVR_SubmitError_None) return true;
 
         // Right eye
@@ -781,18 +972,23 @@ bool MainApplication::renderFrame() {
         rightEyeTexture.layout.rightUpUVs.v[0] = 1;
         rightEyeTexture.layout.rightUpUVs.v[1] = 1;
 
-#if ENABLE_LOW_FOVEATED_RENDERING
-#else
         if (gScale < 1 && gScale > 0) {
             rightEyeTexture.layout.leftLowUVs.v[0] = mLUV[0];
             rightEyeTexture.layout.leftLowUVs.v[1] = mLUV[1];
             rightEyeTexture.layout.rightUpUVs.v[0] = mUUV[0];
             rightEyeTexture.layout.rightUpUVs.v[1] = mUUV[1];
         }
-#endif
-        e = WVR_SubmitFrame(WVR_Eye_Right, &rightEyeTexture, NULL, (WVR_SubmitExtend)ext);
+        e = WVR_SubmitFrame(WVR_Eye_Right, &rightEyeTexture, &submitPoses[WVR_Eye_Right], (WVR_SubmitExtend)ext);
         if (e != WVR_SubmitError_None) return true;
 
+    // Motion to photon is roughly display minus the pose sample time.
+    const int64_t submitTime = monotonicNs();
+    mSyncPoseAgeNs += submitTime - framePose.fetchTime;
+    mSubmitPoseAgeNs += submitTime - submitPoses[WVR_Eye_Right].timestamp;
+    LOGDIF("Pose fetch %lld latch %+lld submit %+lld display %+lld ns", (long long) framePose.fetchTime,
+            (long long) (framePose.latchTime ? framePose.latchTime - framePose.fetchTime : 0),
+            (long long) (submitTime - framePose.fetchTime), (long long) (framePose.displayTime - framePose.fetchTime));
+
     updateTime();
 
     // Clear
@@ -804,11 +1000,11 @@ bool MainApplication::renderFrame() {
     }
 
     // Spew out the controller and pose count whenever they change.
-    if (mControllerCount != mControllerCount_Last || mValidPoseCount != mValidPoseCount_Last) {
-        mValidPoseCount_Last = mValidPoseCount;
-        mControllerCount_Last = mControllerCount;
+    if (packet.controllerCount != mControllerCount_Last || packet.validPoseCount != mValidPoseCount_Last) {
+        mValidPoseCount_Last = packet.validPoseCount;
+        mControllerCount_Last = packet.controllerCount;
 
-        LOGD("PoseCount:%d(%s) Controllers:%d\n", mValidPoseCount, mPoseClasses.c_str(), mControllerCount);
+        LOGD("PoseCount:%d(%s) Controllers:%d\n", packet.validPoseCount, packet.poseClasses, packet.controllerCount);
     }
 
     usleep(1);
@@ -817,76 +1013,161 @@ bool MainApplication::renderFrame() {
     return false;
 }
 
+// Render thread.  Everything the simulation needs from render state is
+// copied here, so the two threads share nothing else while it runs.
+void MainApplication::fillSimInput() {
+    mSimInput.timeDiff = mTimeDiff;
+    mSimInput.interactionMode = mInteractionMode;
+    mSimInput.resetWorld = mResetWorld;
+    mResetWorld = false;
+    mInput.publish();
+#if defined(USE_CONTROLLER) || defined(USE_CUSTOM_CONTROLLER)
+    for (uint32_t cID = 0; cID < 2; ++cID) {
+        mSimInput.controllerTypes[cID] = mControllerObjs[cID] != nullptr ?
+                mControllerObjs[cID]->getCtrlerType() : WVR_DeviceType_Invalid;
+        if (mControllerObjs[cID] != nullptr)
+            mSimInput.emitterPoses[cID] = mControllerObjs[cID]->getEmitterPose();
+    }
+#endif
+}
+
+// Render thread.  Kicks the simulation of the next frame and returns the
+// packet to draw now.
+const FramePacket& MainApplication::nextPacket() {
+    if (mPipeline.getMode() == FramePipeline::kOverlap) {
+        // Nothing simulated ahead on the first frame.
+        if (mPipeline.getPending() == 0) {
+            fillSimInput();
+            mPipeline.kick();
+        }
+        mPipeline.wait();
+        mPackets.update();
+        fillSimInput();
+        mPipeline.kick();
+    } else {
+        fillSimInput();
+        mPipeline.kick();
+        mPipeline.wait();
+        mPackets.update();
+    }
+    return mPackets.getFront();
+}
+
+void MainApplication::simulate() {
+    simulateFrame(mSimInput, mPackets.getBack());
+    mPackets.publish();
+}
+
+// One simulated frame: poses, the world drive, picking and the CPU side of
+// the controller and reticle geometry.
+void MainApplication::simulateFrame(const SimInput& input, FramePacket& packet) {
+    packet.frameIndex = mSimFrameIndex++;
+    if (input.resetWorld) {
+        // Initial position need a little backward and upper to avoid been in a cube.
+        mWorldTranslation.identity().setColumn(3, Vector4(1.0f, 1.5f, 2.0f, 1));
+        mWorldRotation = 0;
+    }
+
+    acquireFramePose(packet.pose, input.timeDiff);
+    packet.validPoseCount = 0;
+    int classCount = 0;
+    for (int nDevice = 0; nDevice < WVR_DEVICE_COUNT_LEVEL_1; ++nDevice) {
+        if (packet.pose.devices[nDevice].pose.isValidPose) {
+            packet.validPoseCount++;
+            packet.poseClasses[classCount++] = mDevClassChar[nDevice];
+        }
+    }
+    packet.poseClasses[classCount] = 0;
+
+    // The simulation knows which controller has the focus, moveSphere()
+    // ignores the other one.
+    const InputSystem::Snapshot& buttons = mInput.acquire();
+    const uint32_t moveButtons = (1u << WVR_InputId_Alias1_Bumper) | (1u << WVR_InputId_Alias1_Trigger)
+            | (1u << WVR_InputId_Alias1_Touchpad);
+    if (buttons.devices[WVR_DeviceType_Controller_Right].wentDownAny(moveButtons))
+        moveSphere(WVR_DeviceType_Controller_Right);
+    if (buttons.devices[WVR_DeviceType_Controller_Left].wentDownAny(moveButtons))
+        moveSphere(WVR_DeviceType_Controller_Left);
+    packet.hasAxes = false;
+    packet.hasReticle = false;
+    packet.controllerCount = 0;
+    buildControllers(input, packet);
+    if (input.interactionMode == WVR_InteractionMode_Gaze)
+        buildReticlePointer(packet);
+
+    packet.sphereColor = currColor;
+    packet.sphereCenter = mSimSphereCenter;
+    packet.focusController = mCurFocusController;
+}
+
 //-----------------------------------------------------------------------------
-// Purpose: Draw all of the controllers as X/Y/Z lines
+// Purpose: Build all of the controllers as X/Y/Z lines
 //-----------------------------------------------------------------------------
-void MainApplication::drawControllers() {
+void MainApplication::buildControllers(const SimInput& input, FramePacket& packet) {
     // don't draw controllers if somebody else has input focus
 //    LOGI("drawControllers(): start");
     if (WVR_IsInputFocusCapturedBySystem())
         return;
 
-    if (mInteractionMode == WVR_InteractionMode_Gaze) {
+    if (input.interactionMode == WVR_InteractionMode_Gaze) {
         return;
     }
 
-    std::vector<float> buffer;
+    const FramePose& framePose = packet.pose;
+    std::vector<float>& buffer = packet.axesVertices;
+    buffer.clear();
 
     int vertCount = 0;
-    mControllerCount = 0;
     WVR_DeviceType type;
+    // Controller rays are picked together after the loop.
+    Ray rays[WVR_DEVICE_COUNT_LEVEL_1];
+    WVR_DeviceType rayTypes[WVR_DEVICE_COUNT_LEVEL_1];
+    uint32_t rayCount = 0;
     for (uint32_t id = WVR_DEVICE_HMD + 1; id < WVR_DEVICE_COUNT_LEVEL_1; ++id) {
-        if ((mVRDevicePairs[id].type != WVR_DeviceType_Controller_Right) && (mVRDevicePairs[id].type != WVR_DeviceType_Controller_Left)){
-//            LOGD("drawControllers(): not Controller : %d ", mVRDevicePairs[id].type);
+        if ((framePose.devices[id].type != WVR_DeviceType_Controller_Right) && (framePose.devices[id].type != WVR_DeviceType_Controller_Left)){
+//            LOGD("drawControllers(): not Controller : %d ", framePose.devices[id].type);
             continue;
         }
 
-        if (!WVR_IsDeviceConnected(mVRDevicePairs[id].type)){
-//            LOGD("drawControllers(): DeviceType: %d pose is disconnected :", mVRDevicePairs[id].type);
+        if (!WVR_IsDeviceConnected(framePose.devices[id].type)){
+//            LOGD("drawControllers(): DeviceType: %d pose is disconnected :", framePose.devices[id].type);
             continue;
         }
 
-        if (!mVRDevicePairs[id].pose.isValidPose) {
-//            LOGD("drawControllers(): DeviceType: %d pose is invalid", mVRDevicePairs[id].type);
+        if (!framePose.devices[id].pose.isValidPose) {
+//            LOGD("drawControllers(): DeviceType: %d pose is invalid", framePose.devices[id].type);
             continue;
         }
 
-        type= mVRDevicePairs[id].type;
+        type= framePose.devices[id].type;
 //        LOGD("drawControllers(): DeviceType: %d start ",type);
 
 
         Matrix4 mat;
         if (m3DOF) {
             // If the controller is 3DOF always put the model in the bottom of the view.
-            mat = mDevicePoseArray[WVR_DEVICE_HMD];
-            mat.invert();
-            float angleY = atan2f(-mat[8], mat[10]);  // Yaw
-            float angleX = asin(-mat[9]);             // Pitch
-            float angleZ = atan2f(mat[1], mat[5]);    // Roll
-
-            mat.identity().rotateY(-angleY / M_PI * 180.0f);
-            mat.rotateX(angleX / M_PI * 180.0f);
-            mat.rotateZ(angleZ / M_PI * 180.0f);
-            mat *= mDevicePoseArray[id];
-
-            int offset = mVRDevicePairs[id].type - WVR_DeviceType_Controller_Right;
+            // Its rotation in head space is the inverse head rotation times its own.
+            mat = (Quaternion::fromMatrix(framePose.deviceToTracking[WVR_DEVICE_HMD]).conjugate() *
+                    Quaternion::fromMatrix(framePose.deviceToTracking[id])).toMatrix();
+
+            int offset = framePose.devices[id].type - WVR_DeviceType_Controller_Right;
             float x = (offset % 2) == 0 ? 0.1f : -0.1f;
             float z = -0.45f - (offset / 2) * 0.3f;
             mat.setColumn(3, Vector4(x,-0.12f,z,1));
         } else {
-            mat = mDevicePoseArray[id];
+            mat = framePose.deviceToTracking[id];
         }
 #if defined(USE_CONTROLLER) || defined(USE_CUSTOM_CONTROLLER)
 #else
         vertCount += mControllerAxes->makeVertices(mat, buffer);
 #endif
-        mControllerCount += 1;
+        packet.controllerCount += 1;
 
         /**
          * Add Raycaster to hit the sphere
          */
         Matrix4 WorldFromHead;
-        WorldFromHead=mDevicePoseArray[WVR_DEVICE_HMD];
+        WorldFromHead=framePose.deviceToTracking[WVR_DEVICE_HMD];
         Matrix4 WorldFromController_new=WorldFromHead*mat;
 
         Matrix4 mat4WorldRotation;
@@ -895,41 +1176,36 @@ void MainApplication::drawControllers() {
 #if defined(USE_CONTROLLER) || defined(USE_CUSTOM_CONTROLLER)
         uint32_t ctrlerRealID = 0;
         for (uint32_t cID = 0; cID < 2; ++cID) {
-            if (mControllerObjs[cID] != nullptr) {
-                if (mControllerObjs[cID]->getCtrlerType() == mVRDevicePairs[id].type) {
-                    ctrlerRealID = cID;
-                    break;
-                }
+            if (input.controllerTypes[cID] == framePose.devices[id].type) {
+                ctrlerRealID = cID;
+                break;
             }
         }
-        Matrix4 emitterPose = mControllerObjs[ctrlerRealID]->getEmitterPose();
+        Matrix4 emitterPose = input.emitterPoses[ctrlerRealID];
 
         WorldFromController_new = mWorldTranslation * mat4WorldRotation * WorldFromController_new * emitterPose; //Because default World position that wee see doesn't base on (0,0,0) , so we need to use actual translation matrix to make ray coordinate as same as current coordinate of the world.
 #else
         WorldFromController_new = mWorldTranslation * mat4WorldRotation * WorldFromController_new; //Because default World position that wee see doesn't base on (0,0,0) , so we need to use actual translation matrix to make ray coordinate as same as current coordinate of the world.
 #endif
-        Point3D origin = {WorldFromController_new[12], WorldFromController_new[13], WorldFromController_new[14]};
+        Vector3 origin(WorldFromController_new[12], WorldFromController_new[13], WorldFromController_new[14]);
 
         Vector3 front(0.0f, 0.0f, -1.0f);
         Matrix3 mat3(WorldFromController_new[0], WorldFromController_new[1], WorldFromController_new[2], WorldFromController_new[4], WorldFromController_new[5], WorldFromController_new[6], WorldFromController_new[8], WorldFromController_new[9], WorldFromController_new[10]);
         Vector3 direction3 =(mat3 * front).normalize();
 
-        Vector3D direction = {direction3.x, direction3.y, direction3.z};
-
-        Vector3 c; //get real collision point
-        Ray3D ray = {origin, direction,c};
-
-        // Get center & radius of the sphere
-        Vector3 sCenter = mSphere->getCenter();
-        Point3D center = {sCenter.x, sCenter.y, sCenter.z};
-        Sphere3D sphere = {center, mSphere->getRadius()};
+        rays[rayCount].set(origin, direction3);
+        rayTypes[rayCount] = framePose.devices[id].type;
+        rayCount++;
+    }
 
-//        LOGD("drawControllers(): mPointToSphere DeviceType start: %d ", mVRDevicePairs[id].type);
+    Picker::Hit hits[WVR_DEVICE_COUNT_LEVEL_1];
+    if (mPicker)
+        mPicker->raycastBatch(rays, rayCount, FLT_MAX, hits, &JobSystem::getInstance());
+    for (uint32_t r = 0; r < rayCount; r++) {
         // Check if the ray intersects the sphere
+        mPointToSphere = mPicker && hits[r].id == mSpherePickId;
 
-        mPointToSphere = intersection(ray, sphere);
-
-        if(mVRDevicePairs[id].type==WVR_DeviceType_Controller_Right){
+        if(rayTypes[r]==WVR_DeviceType_Controller_Right){
 
             if(mPointToSphere){
 //                LOGD("drawControllers(): Right_Controller Hit");
@@ -976,23 +1252,26 @@ void MainApplication::drawControllers() {
     }
 #if defined(USE_CONTROLLER) || defined(USE_CUSTOM_CONTROLLER)
 #else
-    mControllerAxes->setVertices(buffer, vertCount);
+    packet.hasAxes = true;
+    packet.axesVertexCount = vertCount;
 #endif
 //    LOGI("drawControllers(): end");
 }
 
 //-----------------------------------------------------------------------------
-// Purpose: Draw reticle pointer
+// Purpose: Build reticle pointer
 //-----------------------------------------------------------------------------
-void MainApplication::drawReticlePointer() {
+void MainApplication::buildReticlePointer(FramePacket& packet) {
     if (WVR_IsInputFocusCapturedBySystem())
         return;
 
-        std::vector<float> buffer;
+        const FramePose& framePose = packet.pose;
+        std::vector<float>& buffer = packet.reticleVertices;
+        buffer.clear();
 
         int vertCount = 0;
         WVR_DeviceType type;
-        if (!mVRDevicePairs[WVR_DEVICE_HMD].pose.isValidPose) {
+        if (!framePose.devices[WVR_DEVICE_HMD].pose.isValidPose) {
             LOGD("drawReticle(): DeviceType: HMD pose is invalid");
             return;
         }
@@ -1004,30 +1283,22 @@ void MainApplication::drawReticlePointer() {
         */
         Matrix4 WorldFromHead;
         Matrix4 WorldFromReticlePointer_new;
-        //WorldFromHead =mDevicePoseArray[WVR_DEVICE_HMD];
-        WorldFromReticlePointer_new = mDevicePoseArray[WVR_DEVICE_HMD];
+        //WorldFromHead =framePose.deviceToTracking[WVR_DEVICE_HMD];
+        WorldFromReticlePointer_new = framePose.deviceToTracking[WVR_DEVICE_HMD];
 
         Matrix4 mat4WorldRotation;
         mat4WorldRotation.rotate(mWorldRotation, 0, 1, 0); // if world is rotated , the reticle pointer is also changed too.
         WorldFromReticlePointer_new = mWorldTranslation*mat4WorldRotation * WorldFromReticlePointer_new; //Because default World position that wee see doesn't base on (0,0,0) , so we need to use actual translation matrix to make ray coordinate as same as current coordinate of the world.
-        Point3D origin = {WorldFromReticlePointer_new[12], WorldFromReticlePointer_new[13], WorldFromReticlePointer_new[14]};
+        Vector3 origin(WorldFromReticlePointer_new[12], WorldFromReticlePointer_new[13], WorldFromReticlePointer_new[14]);
 
         Vector3 front(0.0f, 0.0f, -1.0f);
         Matrix3 mat3(WorldFromReticlePointer_new[0], WorldFromReticlePointer_new[1], WorldFromReticlePointer_new[2], WorldFromReticlePointer_new[4], WorldFromReticlePointer_new[5], WorldFromReticlePointer_new[6], WorldFromReticlePointer_new[8], WorldFromReticlePointer_new[9], WorldFromReticlePointer_new[10]);
         Vector3 direction3 = (mat3 * front).normalize();
 
-        Vector3D direction = {direction3.x, direction3.y, direction3.z};
-        Vector3 c; //get real collision point
-        Ray3D ray = {origin, direction,c};
-
-        // Get center & radius of the sphere
-        Vector3 sCenter = mSphere->getCenter();
-        Point3D center = {sCenter.x, sCenter.y, sCenter.z};
-
-        Sphere3D sphere = {center, mSphere->getRadius()};
-
         //Check if the ray intersects the sphere
-        mPointToSphere = intersection(ray, sphere);
+        Picker::Hit hit;
+        mPointToSphere = mPicker && mPicker->raycastClosest(Ray(origin, direction3), FLT_MAX, hit)
+                && hit.id == mSpherePickId;
 
         if(mPointToSphere){
             currColor= (WVR_GetDefaultControllerRole() == WVR_DeviceType_Controller_Right)
@@ -1039,7 +1310,8 @@ void MainApplication::drawReticlePointer() {
             mCurFocusController = WVR_DeviceType_HMD;
         }
     vertCount += mReticlePointer->makeVertices(WorldFromReticlePointer_new, buffer);
-    mReticlePointer->setVertices(buffer, vertCount);
+    packet.hasReticle = true;
+    packet.reticleVertexCount = vertCount;
 }
 
 void MainApplication::setupCameras() {
@@ -1058,71 +1330,124 @@ void MainApplication::setupCameras() {
     dumpMatrix("EyePosLeft", mEyePosLeft);
     dumpMatrix("EyePosRight", mEyePosRight);
 
-    // Initial position need a little backward and upper to avoid been in a cube.
-    mWorldTranslation.identity().setColumn(3, Vector4(1.0f, 1.5f, 2.0f, 1));
-    mWorldRotation = 0;
+    // The simulation owns the world drive and resets it on its next frame.
+    mResetWorld = true;
     gettimeofday(&mRtcTime, NULL);
 }
 
-void MainApplication::renderStereoTargets() {
+// Each eye gets its own copy of the frame pose, with the head re-fetched just
+// before WVR_PreRenderEye() when late latching is on.  The head pose an eye
+// was drawn with is returned in submitPoses so the compositor reprojects from
+// the same one.
+void MainApplication::renderStereoTargets(const FramePose& framePose, WVR_PoseState_t submitPoses[2]) {
     LOGENTRY();
     glClearColor(0.30f, 0.30f, 0.37f, 1.0f); // nice background color, but not black
+    // Objects still set raw GL state, so resync the cache once per frame.
+    RenderState::invalidate();
+    RenderState::apply(RenderState::kOpaque);
     FrameBufferObject * fbo = NULL;
+    FramePose eyePose = framePose;
 
-    fbo = gMsaa ? mLeftEyeFBOMSAA.at(mIndexLeft) : mLeftEyeFBO.at(mIndexLeft);
+    fbo = mRenderTargets->get(WVR_Eye_Left, mIndexLeft);
     fbo->bindFrameBuffer();
 
     WVR_TextureParams_t leftEyeTexture = WVR_GetTexture(mLeftEyeQ, mIndexLeft);
-#if ENABLE_LOW_FOVEATED_RENDERING
-        WVR_RenderFoveationParams_t foveated;
-        foveated.focalX = foveated.focalY = 0.0f;
-        foveated.fovealFov = 30.0f;
-        foveated.periQuality = WVR_PeripheralQuality_Low;
-        fbo->glViewportFull();
-        WVR_PreRenderEye(WVR_Eye_Left, &leftEyeTexture, &foveated);
-#else
+    WVR_RenderFoveationParams_t foveated;
         if (gScale < 1 && gScale > 0)
             fbo->glViewportScale(mLUV, mUUV);
         else
             fbo->glViewportFull();
-        WVR_PreRenderEye(WVR_Eye_Left, &leftEyeTexture);
-#endif
+        if (gLateLatch)
+            latchHeadPose(eyePose);
+        WVR_PreRenderEye(WVR_Eye_Left, &leftEyeTexture, getFoveationParams(mProjectionLeft, foveated));
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        renderScene(WVR_Eye_Left);
+        renderScene(WVR_Eye_Left, eyePose);
         fbo->unbindFrameBuffer();
+        submitPoses[WVR_Eye_Left] = eyePose.devices[WVR_DEVICE_HMD].pose;
 
         // Right Eye
-        fbo = gMsaa ? mRightEyeFBOMSAA.at(mIndexRight) : mRightEyeFBO.at(mIndexRight);
+        fbo = mRenderTargets->get(WVR_Eye_Right, mIndexRight);
         fbo->bindFrameBuffer();
         WVR_TextureParams_t rightEyeTexture = WVR_GetTexture(mRightEyeQ, mIndexRight);
-#if ENABLE_LOW_FOVEATED_RENDERING
-        foveated.focalX = foveated.focalY = 0.0f;
-        foveated.fovealFov = 30.0f;
-        foveated.periQuality = WVR_PeripheralQuality_Low;
-        fbo->glViewportFull();
-        WVR_PreRenderEye(WVR_Eye_Right, &rightEyeTexture, &foveated);
-#else
         if (gScale < 1 && gScale > 0)
             fbo->glViewportScale(mLUV, mUUV);
         else
             fbo->glViewportFull();
-        WVR_PreRenderEye(WVR_Eye_Right, &rightEyeTexture);
-#endif
+        if (gLateLatch)
+            latchHeadPose(eyePose);
+        WVR_PreRenderEye(WVR_Eye_Right, &rightEyeTexture, getFoveationParams(mProjectionRight, foveated));
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        renderScene(WVR_Eye_Right);
+        renderScene(WVR_Eye_Right, eyePose);
         fbo->unbindFrameBuffer();
+        submitPoses[WVR_Eye_Right] = eyePose.devices[WVR_DEVICE_HMD].pose;
 }
 
 
-void MainApplication::renderScene(WVR_Eye nEye) {
+// How far the head may turn between cullScene() and the last latchHeadPose()
+// of a frame, in radians: its current angular speed for a whole frame, as if
+// the prediction were no help at all.  The floor covers a turn that starts
+// from rest, the ceiling keeps a tracking glitch from disabling culling.
+static float latchTurnBound(const WVR_PoseState_t& hmd, float frameTime) {
+    const float kMinTurn = 0.0175f;     // 1 degree
+    const float kMaxTurn = 0.175f;      // 10 degrees
+    const WVR_Vector3f_t& w = hmd.angularVelocity;
+    const float turn = sqrtf(w.v[0] * w.v[0] + w.v[1] * w.v[1] + w.v[2] * w.v[2]) * frameTime;
+    return turn < kMinTurn ? kMinTurn : turn > kMaxTurn ? kMaxTurn : turn;
+}
+
+// Cull everything once per frame against both eyes.  renderScene() then only
+// checks the per eye result.
+//
+// This runs before the eyes re-latch the head pose, so with late latching on
+// each eye's projection is widened by latchTurnBound().  Culling after each
+// latch would put the cull on the critical path between the latch and the
+// draw, which is the time late latching is there to shorten.
+void MainApplication::cullScene(const FramePose& framePose) {
+    if (!mCuller)
+        return;
+    mCuller->clear();
+    mSphereCull = mSphere && mSphere->hasBounds() ?
+            mCuller->add(mSphere->getWorldBounds()) : FrustumCuller::kAlwaysVisible;
+    mFloorCull = mFloor && mFloor->hasBounds() ?
+            mCuller->add(mFloor->getWorldBounds()) : FrustumCuller::kAlwaysVisible;
+    mSeaOfCubesCull = mSeaOfCubes && mSeaOfCubes->hasBounds() ?
+            mCuller->add(mSeaOfCubes->getWorldBounds()) : FrustumCuller::kAlwaysVisible;
+    mEnvironmentCull = mEnvironment && mEnvironment->hasBounds() ?
+            mCuller->add(mEnvironment->getWorldBounds()) : FrustumCuller::kAlwaysVisible;
+#if !defined(USE_CONTROLLER) && !defined(USE_CUSTOM_CONTROLLER)
+    for (uint32_t id = 0; id < WVR_DEVICE_COUNT_LEVEL_1; id++) {
+        ControllerCube * cube = mControllerCubeTableById[id];
+        // A 3DOF cube is drawn in head space and is always in view.
+        if (cube == NULL || m3DOF || !cube->hasBounds())
+            mControllerCubeCull[id] = FrustumCuller::kAlwaysVisible;
+        else
+            mControllerCubeCull[id] = mCuller->add(cube->getLocalBounds().transformed(framePose.deviceToTracking[id]));
+    }
+#endif
+
+    const float turn = gLateLatch ? latchTurnBound(framePose.devices[WVR_DEVICE_HMD].pose, mTimeDiff) : 0;
+    Frustum left, right;
+    left.set(Frustum::widen(mProjectionLeft, turn) * mEyePosLeft * framePose.view);
+    right.set(Frustum::widen(mProjectionRight, turn) * mEyePosRight * framePose.view);
+    mCuller->cull(left, right, &JobSystem::getInstance());
+}
+
+bool MainApplication::isCulled(uint32_t cullIndex, WVR_Eye nEye) const {
+    if (!mCuller)
+        return false;
+    return !mCuller->isVisible(cullIndex,
+            nEye == WVR_Eye_Left ? FrustumCuller::kLeftEye : FrustumCuller::kRightEye);
+}
+
+void MainApplication::renderScene(WVR_Eye nEye, const FramePose& framePose) {
     WVR_RenderMask(nEye);
 
 
     if (mGridPicture && mGridPicture->isEnabled()) {
         if (nEye == WVR_Eye_Left)
-            mGridPicture->draw(mProjectionLeft, mEyePosLeft, mHMDPose, mLightDir);
+            mGridPicture->draw(mProjectionLeft, mEyePosLeft, framePose.view, mLightDir);
         else if (nEye == WVR_Eye_Right)
-            mGridPicture->draw(mProjectionRight, mEyePosRight, mHMDPose, mLightDir);
+            mGridPicture->draw(mProjectionRight, mEyePosRight, framePose.view, mLightDir);
         return;
     }
 
@@ -1137,17 +1462,17 @@ void MainApplication::renderScene(WVR_Eye nEye) {
                 //uint32_t idx = mControllerObjs[cID]->getCtrlerType() - WVR_DeviceType_HMD;
                 uint32_t ctrlerRealID = 0;
                 for (uint32_t devID = 0; devID < WVR_DEVICE_COUNT_LEVEL_1; ++devID) {
-                    if (mControllerObjs[cID]->getCtrlerType() == mVRDevicePairs[devID].type) {
+                    if (mControllerObjs[cID]->getCtrlerType() == framePose.devices[devID].type) {
                         ctrlerRealID = devID;
                         break;
                     }
                 }
-                if (mVRDevicePairs[ctrlerRealID].pose.isValidPose == true) {
-                    Matrix4 ctrlerPose = mDevicePoseArray[ctrlerRealID];
+                if (framePose.devices[ctrlerRealID].pose.isValidPose == true) {
+                    Matrix4 ctrlerPose = framePose.deviceToTracking[ctrlerRealID];
                     Matrix4 projs[2], eyes[2];
                     Matrix4 view;
                     if(m3DOF){
-                        view = mHMDPose; 
+                        view = framePose.view; 
                     }
                     if (nEye == WVR_Eye_Left) {
                         projs[0] = mProjectionLeft;
@@ -1170,7 +1495,7 @@ void MainApplication::renderScene(WVR_Eye nEye) {
     if (!isInputCapturedBySystem) {
         Matrix4 view;
         if (!m3DOF) {
-            view = mHMDPose;
+            view = framePose.view;
         }
         if (mControllerAxes) {
             if (mInteractionMode == WVR_InteractionMode_SystemDefault || mInteractionMode == WVR_InteractionMode_Controller){
@@ -1186,13 +1511,13 @@ void MainApplication::renderScene(WVR_Eye nEye) {
     int localControllerIdx = -1;
     for (uint32_t id = WVR_DEVICE_HMD + 1;
             id < WVR_DEVICE_COUNT_LEVEL_1; id++) {
-        if ((mVRDevicePairs[id].type != WVR_DeviceType_Controller_Right) && (mVRDevicePairs[id].type != WVR_DeviceType_Controller_Left))
+        if ((framePose.devices[id].type != WVR_DeviceType_Controller_Right) && (framePose.devices[id].type != WVR_DeviceType_Controller_Left))
             continue;
 
-        if (!WVR_IsDeviceConnected(mVRDevicePairs[id].type))
+        if (!WVR_IsDeviceConnected(framePose.devices[id].type))
             continue;
 
-        const WVR_PoseState_t & pose = mVRDevicePairs[id].pose;
+        const WVR_PoseState_t & pose = framePose.devices[id].pose;
         if (!pose.isValidPose)
             continue;
 
@@ -1212,30 +1537,25 @@ void MainApplication::renderScene(WVR_Eye nEye) {
         if (!mShowDeviceArray[id])
             continue;
 
+        if (isCulled(mControllerCubeCull[id], nEye))
+            continue;
+
         ControllerCube * ControllerCube = mControllerCubeTableById[id];
-        const Matrix4 & matDeviceToTracking = mDevicePoseArray[id];
+        const Matrix4 & matDeviceToTracking = framePose.deviceToTracking[id];
         Matrix4 view;
         if (m3DOF) {
             // If the controller is 3DOF always put the model in the bottom of the view.
-            Matrix4 mat = mDevicePoseArray[WVR_DEVICE_HMD];
-            mat.invert();
-            float angleY = atan2f(-mat[8], mat[10]);  // Yaw
-            float angleX = asin(-mat[9]);             // Pitch
-            float angleZ = atan2f(mat[1], mat[5]);    // Roll
-
-            mat.identity().rotateY(-angleY / M_PI * 180.0f);
-            mat.rotateX(angleX / M_PI * 180.0f);
-            mat.rotateZ(angleZ / M_PI * 180.0f);
-            mat *= matDeviceToTracking;
-            int offset = mVRDevicePairs[id].type - WVR_DeviceType_Controller_Right;
+            Matrix4 mat = (Quaternion::fromMatrix(framePose.deviceToTracking[WVR_DEVICE_HMD]).conjugate() *
+                    Quaternion::fromMatrix(matDeviceToTracking)).toMatrix();
+            int offset = framePose.devices[id].type - WVR_DeviceType_Controller_Right;
             float x = (offset % 2) == 0 ? 0.1f : -0.1f;
             float z = -0.45 - (offset / 2) * 0.3f;
             mat.setColumn(3, Vector4(x,-0.12f,z,1));
-            ControllerCube->getTransform().set(mat.get());
+            ControllerCube->setTransform(mat);
             ControllerCube->getNormalMatrix() = ControllerCube->makeNormalMatrix(matDeviceToTracking);
         } else {
-            view = mHMDPose;
-            ControllerCube->getTransform().set(matDeviceToTracking.get());
+            view = framePose.view;
+            ControllerCube->setTransform(matDeviceToTracking);
         }
         Vector4 light = mLightDir;
         if (!mLight)
@@ -1254,7 +1574,7 @@ void MainApplication::renderScene(WVR_Eye nEye) {
         Vector4 light = mLightDir;
         if (!mLight)
         light = Vector4(0,0,0,1);
-        Matrix4 view = mHMDPose;
+        Matrix4 view = framePose.view;
         // Gaze mode, use reticle pointer as input module
         if (mInteractionMode == WVR_InteractionMode_Gaze){
             if (nEye == WVR_Eye_Left)
@@ -1265,28 +1585,41 @@ void MainApplication::renderScene(WVR_Eye nEye) {
     }
 
     // Sphere
-    if (mSphere) {
-        mSphere->setSphereColor(currColor);
+    if (mSphere && !isCulled(mSphereCull, nEye)) {
+        if (nEye == WVR_Eye_Left)
+            mSphere->draw(mProjectionLeft, mEyePosLeft, framePose.view, mLightDir);
+        else if (nEye == WVR_Eye_Right)
+            mSphere->draw(mProjectionRight, mEyePosRight, framePose.view, mLightDir);
+    }
+
+    if (mFloor && !isCulled(mFloorCull, nEye)) {
+        if (nEye == WVR_Eye_Left)
+            mFloor->draw(mProjectionLeft, mEyePosLeft, framePose.view, mLightDir);
+        else if (nEye == WVR_Eye_Right)
+            mFloor->draw(mProjectionRight, mEyePosRight, framePose.view, mLightDir);
+    }
+
+    if (mSeaOfCubes && !isCulled(mSeaOfCubesCull, nEye)) {
         if (nEye == WVR_Eye_Left)
-            mSphere->draw(mProjectionLeft, mEyePosLeft, mHMDPose, mLightDir);
+            mSeaOfCubes->draw(mProjectionLeft, mEyePosLeft, framePose.view, mLightDir);
         else if (nEye == WVR_Eye_Right)
-            mSphere->draw(mProjectionRight, mEyePosRight, mHMDPose, mLightDir);
+            mSeaOfCubes->draw(mProjectionRight, mEyePosRight, framePose.view, mLightDir);
     }
 
-    if (mFloor) {
+    if (mEnvironment && !isCulled(mEnvironmentCull, nEye)) {
         if (nEye == WVR_Eye_Left)
-            mFloor->draw(mProjectionLeft, mEyePosLeft, mHMDPose, mLightDir);
+            mEnvironment->draw(mProjectionLeft, mEyePosLeft, framePose.view, mLightDir);
         else if (nEye == WVR_Eye_Right)
-            mFloor->draw(mProjectionRight, mEyePosRight, mHMDPose, mLightDir);
+            mEnvironment->draw(mProjectionRight, mEyePosRight, framePose.view, mLightDir);
     }
 
     // SkyBox
-    // minimize gpu loading by putting SkyBox in the end
+    // Drawn last, so the depth test rejects every pixel already covered.
     if (mSkyBox) {
             if (nEye == WVR_Eye_Left)
-                mSkyBox->draw(mProjectionLeft, mEyePosLeft, mHMDPose, mLightDir);
+                mSkyBox->draw(mProjectionLeft, mEyePosLeft, framePose.view, mLightDir);
             else if (nEye == WVR_Eye_Right)
-                mSkyBox->draw(mProjectionRight, mEyePosRight, mHMDPose, mLightDir);
+                mSkyBox->draw(mProjectionRight, mEyePosRight, framePose.view, mLightDir);
     }
 
     glUseProgram(0);
@@ -1314,7 +1647,12 @@ void MainApplication::updateTime() {
     mFrameCount++;
     if (mTimeAccumulator2S > 2000000) {
         mFPS = mFrameCount / (mTimeAccumulator2S / 1000000.0f);
-        LOGI("HelloVR FPS %3.0f", mFPS);
+        LOGI("HelloVR FPS %3.0f, %u triangles in %u draws per frame, scale %.2f", mFPS,
+                RenderStats::getFrameTriangles(), RenderStats::getFrameDrawCalls(), gScale);
+        LOGI("Pose age at submit: sync %.2f ms, submitted %.2f ms", mSyncPoseAgeNs / 1e6f / mFrameCount,
+                mSubmitPoseAgeNs / 1e6f / mFrameCount);
+        mSyncPoseAgeNs = 0;
+        mSubmitPoseAgeNs = 0;
 
         mFrameCount = 0;
         mTimeAccumulator2S = 0;
@@ -1339,16 +1677,18 @@ void MainApplication::updateEyeToHeadMatrix(bool is6DoF) {
     mIs6DoFPose = is6DoF;
 }
 
-void MainApplication::updateHMDMatrixPose() {
+// Fetches the predicted poses for the frame the simulation is working on.
+// In overlap mode that frame is drawn one period after this one, and the
+// poses are predicted that much further.
+void MainApplication::acquireFramePose(FramePose& framePose, float timeDiff) {
     LOGENTRY();
 
-    WVR_GetSyncPose(WVR_PoseOriginModel_OriginOnHead, mVRDevicePairs, WVR_DEVICE_COUNT_LEVEL_1);
-    mValidPoseCount = 0;
-    mPoseClasses = "";
+    WVR_GetSyncPose(WVR_PoseOriginModel_OriginOnHead, framePose.devices, WVR_DEVICE_COUNT_LEVEL_1);
+    framePose.fetchTime = monotonicNs();
+    framePose.latchTime = 0;
     for (int nDevice = 0; nDevice < WVR_DEVICE_COUNT_LEVEL_1; ++nDevice) {
-        if (mVRDevicePairs[nDevice].pose.isValidPose) {
-            mValidPoseCount++;
-            mDevicePoseArray[nDevice] = wvrmatrixConverter(mVRDevicePairs[nDevice].pose.poseMatrix);
+        if (framePose.devices[nDevice].pose.isValidPose) {
+            framePose.deviceToTracking[nDevice] = wvrmatrixConverter(framePose.devices[nDevice].pose.poseMatrix);
 
             if (mDevClassChar[nDevice]==0) {
                 switch (WVR_DeviceType_HMD + nDevice) {
@@ -1358,72 +1698,109 @@ void MainApplication::updateHMDMatrixPose() {
                 default:                                       mDevClassChar[nDevice] = '?'; break;
                 }
             }
-            mPoseClasses += mDevClassChar[nDevice];
         }
     }
 
-    if (mVRDevicePairs[WVR_DEVICE_HMD].pose.isValidPose) {
-        updateEyeToHeadMatrix(mVRDevicePairs[WVR_DEVICE_HMD].pose.is6DoFPose);
-        Matrix4 hmd = mDevicePoseArray[WVR_DEVICE_HMD];
+    // The runtime predicts to the display time.  When it does not say how
+    // far ahead, assume one frame.
+    const WVR_PoseState_t & hmdState = framePose.devices[WVR_DEVICE_HMD].pose;
+    framePose.displayTime = framePose.fetchTime + (hmdState.predictedMilliSec > 0 ?
+            (int64_t) (hmdState.predictedMilliSec * 1000000.0f) : mFramePeriodNs);
+    if (mPipeline.getMode() == FramePipeline::kOverlap)
+        framePose.displayTime += mFramePeriodNs;
+
+    // Controllers go through their history, so buildControllers() casts the
+    // ray from the same pose renderScene() draws the model at.
+    for (int nDevice = 0; nDevice < WVR_DEVICE_COUNT_LEVEL_1; ++nDevice) {
+        const WVR_PoseState_t & state = framePose.devices[nDevice].pose;
+        if (nDevice == WVR_DEVICE_HMD || !state.isValidPose)
+            continue;
+        PoseHistory & history = mPoseHistory[nDevice];
+        history.setFilter(gControllerFilter);
+        // The time the runtime predicted the pose for.
+        const int64_t sampleTime = (state.timestamp ? state.timestamp : framePose.fetchTime) +
+                (int64_t) (state.predictedMilliSec * 1000000.0f);
+        history.push(sampleTime, framePose.deviceToTracking[nDevice]);
+        history.predict(framePose.displayTime, framePose.deviceToTracking[nDevice]);
+    }
+
+    if (hmdState.isValidPose && mMove)
+        driveWorld(framePose.deviceToTracking[WVR_DEVICE_HMD], timeDiff);
+    framePose.worldTranslation = Vector3(mWorldTranslation[12], mWorldTranslation[13], mWorldTranslation[14]);
+    framePose.worldRotation = mWorldRotation;
+    if (hmdState.isValidPose)
+        mLastView = makeView(framePose, framePose.deviceToTracking[WVR_DEVICE_HMD]);
+    // Keep the last good view while the HMD pose is invalid.
+    framePose.view = mLastView;
+    if (gDebug) dumpMatrix("hmd", framePose.view);
+}
+
+// Re-fetch the HMD pose just before an eye is drawn, predicted to the same
+// display time.  Controllers keep the frame's poses.
+void MainApplication::latchHeadPose(FramePose& framePose) {
+    const int64_t now = monotonicNs();
+    const int64_t ahead = framePose.displayTime > now ? framePose.displayTime - now : 0;
+    WVR_PoseState_t state;
+    WVR_GetPoseState(WVR_DeviceType_HMD, WVR_PoseOriginModel_OriginOnHead,
+            (uint32_t) ((ahead + 500000) / 1000000), &state);
+    if (!state.isValidPose)
+        return;
+    framePose.devices[WVR_DEVICE_HMD].pose = state;
+    framePose.deviceToTracking[WVR_DEVICE_HMD] = wvrmatrixConverter(state.poseMatrix);
+    framePose.view = makeView(framePose, framePose.deviceToTracking[WVR_DEVICE_HMD]);
+    framePose.latchTime = now;
+}
 
-        if (!mMove) {
-            // The controller make the sample not simple.  If you don't have
-            // a controller, we just need invert the hmd pose.
+// Advance the world drive of mMove by one frame.
+void MainApplication::driveWorld(const Matrix4& hmd, float timeDiff) {
+    // Update world rotation.
+    mWorldRotation += -mDriveAngle * timeDiff;
+    const Quaternion worldRotation = Quaternion::fromAxisAngle(Vector3(0, 1, 0), mWorldRotation);
+
+    // Update WorldTranslation.  Not apply the tranlsation of hmdpose.
+    Vector3 direction = (worldRotation * Quaternion::fromMatrix(hmd)).rotate(Vector3(0, 0, 1));
+    direction *= -mDriveSpeed * timeDiff;
+
+    // Move toward -z
+    Matrix4 update;
+    update.setTranslation(direction);
+    mWorldTranslation *= update;
+
+    // Check world bound
+    if (mWorldTranslation[12] >= mFarClip/2)
+        mWorldTranslation[12] = mFarClip/2;
+    if (mWorldTranslation[12] <= -mFarClip/2)
+        mWorldTranslation[12] = -mFarClip/2;
+    if (mWorldTranslation[13] >= mFarClip/2)
+        mWorldTranslation[13] = mFarClip/2;
+    if (mWorldTranslation[13] <= -mFarClip/2)
+        mWorldTranslation[13] = -mFarClip/2;
+    if (mWorldTranslation[14] >= mFarClip/2)
+        mWorldTranslation[14] = mFarClip/2;
+    if (mWorldTranslation[14] <= -mFarClip/2)
+        mWorldTranslation[14] = -mFarClip/2;
+}
 
-            // When the head turn left, acturally the object turn right.
-            // When the head move left, acturally the object move right.
-            // So we need invert the hmd matrix.
-            mHMDPose = hmd.invert();
-        } else {
-            // In order to add translation and rotation to HMD. We need seperate
-            // the translation and rotation into two matrix from HMD.
-
-            Matrix4 hmdRotation = hmd;
-            hmdRotation.setColumn(3, Vector4(0,0,0,1));
-
-            Matrix4 hmdTranslation;
-            hmdTranslation.setColumn(3, Vector4(hmd[12], hmd[13], hmd[14], 1));
-
-            // Update world rotation.
-            mWorldRotation += -mDriveAngle * mTimeDiff;
-            Matrix4 mat4WorldRotation;
-            mat4WorldRotation.rotate(mWorldRotation, 0, 1, 0);
-
-            // Update WorldTranslation
-            Vector4 direction = (mat4WorldRotation * hmdRotation) * Vector4(0, 0, 1, 0);  // Not apply the tranlsation of hmdpose
-            direction *= -mDriveSpeed * mTimeDiff;
-            direction.w = 1;
-
-            // Move toward -z
-            Matrix4 update;
-            update.setColumn(3, direction);
-            mWorldTranslation *= update;
-
-            // Check world bound
-            if (mWorldTranslation[12] >= mFarClip/2)
-                mWorldTranslation[12] = mFarClip/2;
-            if (mWorldTranslation[12] <= -mFarClip/2)
-                mWorldTranslation[12] = -mFarClip/2;
-            if (mWorldTranslation[13] >= mFarClip/2)
-                mWorldTranslation[13] = mFarClip/2;
-            if (mWorldTranslation[13] <= -mFarClip/2)
-                mWorldTranslation[13] = -mFarClip/2;
-            if (mWorldTranslation[14] >= mFarClip/2)
-                mWorldTranslation[14] = mFarClip/2;
-            if (mWorldTranslation[14] <= -mFarClip/2)
-                mWorldTranslation[14] = -mFarClip/2;
-
-            // DEFINE: The invert A^-1 is notated A'
-            // The invert property: (AB)' = B'A'
-            // "WT" means "world translation", "HR" means "hmd rotation", and so on.
-            // We can get the model tranform matrix as (WT*HT*WR*HR)' = HR'*WR'*WT'*HT'
-            // The tranlation matrix property: TA = AT , then: (TA)' = (AT)'
-            // So we can put tranlsation matrix any where.
-            // We apply WR' to vertex first, then do HR'.  If not, the world will be weired when look up or down.
-            mHMDPose = (mWorldTranslation * hmdTranslation * mat4WorldRotation * hmdRotation).invert();
-        }
+// World to head for an HMD pose, under the world drive the frame was
+// simulated with.
+Matrix4 MainApplication::makeView(const FramePose& framePose, const Matrix4& hmd) const {
+    // When the head turn left, acturally the object turn right.
+    // When the head move left, acturally the object move right.
+    // So we need invert the hmd pose.
+    if (!mMove) {
+        // The controller make the sample not simple.  If you don't have
+        // a controller, we just need invert the hmd pose.
+        return DualQuaternion::fromMatrix(hmd).inverse().toMatrix();
     }
-    if (gDebug) dumpMatrix("hmd", mHMDPose);
+
+    // "WT" means "world translation", "HR" means "hmd rotation", and so on.
+    // The head is (WT*HT*WR*HR).  Translations commute, so it is one rigid
+    // transform: rotation WR*HR, translation WT+HT.  We apply WR' to vertex
+    // first, then do HR'.  If not, the world will be weired when look up or down.
+    const Quaternion rotation = Quaternion::fromAxisAngle(Vector3(0, 1, 0), framePose.worldRotation) *
+            Quaternion::fromMatrix(hmd);
+    const Vector3 translation = framePose.worldTranslation + Vector3(hmd[12], hmd[13], hmd[14]);
+    return DualQuaternion(rotation, translation).inverse().toMatrix();
 }
 
 #if defined(USE_CONTROLLER) || defined(USE_CUSTOM_CONTROLLER)
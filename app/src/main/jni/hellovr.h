@@ -18,13 +18,21 @@
 
 #include <wvr/wvr_device.h>
 #include <wvr/wvr_events.h>
+#include <wvr/wvr_render.h>
 #include <wvr/wvr_types.h>
 #include <Sphere.h>
 #include <Floor.h>
+#include <ResolutionController.h>
+#include <Foveation.h>
+#include <PoseHistory.h>
+#include <FramePipeline.h>
+#include <TripleBuffer.h>
+#include <InputSystem.h>
 class Context;
 class Texture;
 class SkyBox;
 class SeaOfCubes;
+class Environment;
 #if defined(USE_CONTROLLER)
 class Controller;
 #elif defined(USE_CUSTOM_CONTROLLER)
@@ -35,11 +43,65 @@ class ControllerCube;
 #endif
 class ReticlePointer;
 class FrameBufferObject;
+class RenderTargetManager;
 class Picture;
 class Clock;
 class Object;
-
-class MainApplication
+class Picker;
+class FrustumCuller;
+class GpuTimer;
+
+// Poses for one frame.  Fetched once per simulated frame and passed down,
+// so everything drawn in the frame sees the same poses.
+struct FramePose {
+    WVR_DevicePosePair_t devices[WVR_DEVICE_COUNT_LEVEL_1];
+    Matrix4 deviceToTracking[WVR_DEVICE_COUNT_LEVEL_1];
+    Matrix4 view;               // world to head
+    // The world drive when the poses were fetched, for rebuilding the view.
+    Vector3 worldTranslation;
+    float worldRotation;
+    // CLOCK_MONOTONIC nanoseconds.
+    int64_t fetchTime;
+    int64_t latchTime;          // last late latch of the head, 0 if none
+    int64_t displayTime;        // the time the poses are predicted to
+};
+
+// What the render thread hands the simulation of one frame.  Copied when
+// the simulation is kicked, so the simulation never reads render state.
+struct SimInput {
+    float timeDiff;
+    WVR_InteractionMode interactionMode;
+    bool resetWorld;
+#if defined(USE_CONTROLLER) || defined(USE_CUSTOM_CONTROLLER)
+    WVR_DeviceType controllerTypes[2];      // WVR_DeviceType_Invalid when not loaded
+    Matrix4 emitterPoses[2];
+#endif
+};
+
+// Everything the render thread takes from one simulated frame.  Written by
+// the simulation, then only read until the buffer comes round again.
+struct FramePacket {
+    uint32_t frameIndex;
+    FramePose pose;
+
+    bool hasAxes;               // false leaves the last axes in place
+    std::vector<float> axesVertices;
+    int axesVertexCount;
+    bool hasReticle;
+    std::vector<float> reticleVertices;
+    int reticleVertexCount;
+
+    // Picking results.
+    Sphere::Color sphereColor;
+    Vector3 sphereCenter;
+    WVR_DeviceType focusController;
+
+    int controllerCount;
+    int validPoseCount;
+    char poseClasses[WVR_DEVICE_COUNT_LEVEL_1 + 1];
+};
+
+class MainApplication : public FramePipeline::Stage
 {
 public:
     MainApplication();
@@ -63,12 +125,16 @@ public:
     void processVREvent(const WVR_Event_t & event);
     bool renderFrame();
 
-    void renderStereoTargets();
-    void drawControllers();
-    void renderScene(WVR_Eye nEye);
+    // FramePipeline::Stage, on the simulation thread in the threaded modes.
+    void simulate();
+
+    void renderStereoTargets(const FramePose& framePose, WVR_PoseState_t submitPoses[2]);
+    void cullScene(const FramePose& framePose);
+    void renderScene(WVR_Eye nEye, const FramePose& framePose);
 
     void updateTime();
-    void updateHMDMatrixPose();
+    void latchHeadPose(FramePose& framePose);
+    Matrix4 makeView(const FramePose& framePose, const Matrix4& hmd) const;
     void updateEyeToHeadMatrix(bool is6DoF);
 
     inline Matrix4 wvrmatrixConverter(const WVR_Matrix4f_t& mat) const {
@@ -81,24 +147,48 @@ public:
     }
 
 protected:
-    void moveSphereHandler();
-    WVR_DevicePosePair_t mVRDevicePairs[WVR_DEVICE_COUNT_LEVEL_1];
-
-    Matrix4 mDevicePoseArray[WVR_DEVICE_COUNT_LEVEL_1];
+    // Simulation side.  These own the poses, the world drive, picking and
+    // the controller and reticle geometry, and touch no GL.
+    void simulateFrame(const SimInput& input, FramePacket& packet);
+    void acquireFramePose(FramePose& framePose, float timeDiff);
+    void driveWorld(const Matrix4& hmd, float timeDiff);
+    void moveSphere(WVR_DeviceType request);
+    void buildControllers(const SimInput& input, FramePacket& packet);
+    void buildReticlePointer(FramePacket& packet);
+
+    // Render side.
+    void fillSimInput();
+    const FramePacket& nextPacket();
+
+    FramePipeline mPipeline;
+    TripleBuffer<FramePacket> mPackets;
+    SimInput mSimInput;
+    bool mResetWorld;
+    // Buttons and touches from the event queue.  Published with every kick,
+    // the simulation acquires the snapshot.
+    InputSystem mInput;
+    InputTrace mInputTrace;
+    uint32_t mSimFrameIndex;
+    Vector3 mSimSphereCenter;
+
+    bool isCulled(uint32_t cullIndex, WVR_Eye nEye) const;
     bool mShowDeviceArray[WVR_DEVICE_COUNT_LEVEL_1];
 
-    int mControllerCount;
     int mControllerCount_Last;
-    int mValidPoseCount;
     int mValidPoseCount_Last;
 
-    std::string mPoseClasses;                            // what classes we saw poses for this frame
     char mDevClassChar[WVR_DEVICE_COUNT_LEVEL_1];        // for each device, a character representing its class
 
     float mNearClip;
     float mFarClip;
 
-    Matrix4 mHMDPose;
+    // Controller poses, filtered and predicted to the display time.
+    PoseHistory mPoseHistory[WVR_DEVICE_COUNT_LEVEL_1];
+    Matrix4 mLastView;                                  // used while the HMD pose is invalid
+    int64_t mFramePeriodNs;
+    // Pose age at submit, summed over the FPS period.
+    int64_t mSyncPoseAgeNs;
+    int64_t mSubmitPoseAgeNs;
     Matrix4 mEyePosLeft;
     Matrix4 mEyePosRight;
 
@@ -115,6 +205,7 @@ protected:
 #else
     std::vector<ControllerCube *> mControllerCubes;
     ControllerCube * mControllerCubeTableById[WVR_DEVICE_COUNT_LEVEL_1];
+    uint32_t mControllerCubeCull[WVR_DEVICE_COUNT_LEVEL_1];
     ControllerAxes * mControllerAxes;
 #endif
 
@@ -124,11 +215,9 @@ protected:
     void* mLeftEyeQ;
     void* mRightEyeQ;
 
-    std::vector<FrameBufferObject*> mLeftEyeFBO;
-    std::vector<FrameBufferObject*> mRightEyeFBO;
-
-    std::vector<FrameBufferObject*> mLeftEyeFBOMSAA;
-    std::vector<FrameBufferObject*> mRightEyeFBOMSAA;
+    RenderTargetManager *mRenderTargets;
+    int mRequestedSamples;
+    bool initRenderTargets();
 
     SkyBox * mSkyBox;
     Picture * mGridPicture;
@@ -160,7 +249,20 @@ protected:
     bool mPointToSphere_R=false;
     Sphere::Color currColor=Sphere::Color::green;
     Sphere *mSphere;
+    SceneGraph *mSceneGraph;
+    Picker *mPicker;
+    uint32_t mSpherePickId;
     Floor *mFloor;
+    // Indices into mCuller, refreshed by cullScene() every frame.
+    FrustumCuller *mCuller;
+    uint32_t mSphereCull;
+    uint32_t mFloorCull;
+    // Built the first time gScene turns on.
+    SeaOfCubes *mSeaOfCubes;
+    uint32_t mSeaOfCubesCull;
+    // Loaded from gEnvironment when it is set.
+    Environment *mEnvironment;
+    uint32_t mEnvironmentCull;
     Vector3 oriSpherePos;
     WVR_DeviceType mCurFocusController;
 
@@ -168,10 +270,21 @@ protected:
     void switchGazeTriggerType();
     std::vector<float> mLUV { 0,0 };
     std::vector<float> mUUV { 0,0 };
+    // GPU time of renderStereoTargets() drives the viewport scale.
+    GpuTimer *mGpuTimer;
+    ResolutionController mResolution;
+    // Follows gFoveationMode, ramped by the same GPU time.
+    Foveation mFoveation;
+    FoveationTrace mFoveationTrace;
+    float mFoveationTraceTime;
+    bool mFoveationEnabled;
+    void updateFoveation(float gpuTime, const FramePacket& packet);
+    const WVR_RenderFoveationParams_t * getFoveationParams(const Matrix4& projection,
+            WVR_RenderFoveationParams_t& params) const;
 
     WVR_InteractionMode mInteractionMode;
     WVR_GazeTriggerType mGazeTriggerType;
 
-    void drawReticlePointer();
     void switchResolution();
+    void setRenderScale(float scale);
 };
\ No newline at end of file
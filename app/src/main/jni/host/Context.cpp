@@ -0,0 +1,229 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+// Host replacement of Context.cpp.  There is no Java VM on the host, so the
+// BitmapFactory decodes PNG and JPEG itself into RGBA_8888 bitmaps with the
+// same layout android.graphics.BitmapFactory would hand back.
+
+#define LOG_TAG "Context"
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <Context.h>
+#include "log.h"
+
+#include <png.h>
+#include <jpeglib.h>
+
+BitmapFactory::BitmapFactory(JNIEnv * /*env*/) :
+        mBitmapFactoryClass(NULL), mIdDecordByteArray(NULL) {
+}
+
+void BitmapFactory::clean(JNIEnv * /*env*/) {
+}
+
+void BitmapFactory::recycleBitmap(JNIEnv * /*env*/, jobject /*bitmap*/) {
+}
+
+uint8_t * BitmapFactory::decodeAndroidBitmap(JNIEnv * /*env*/, jobject /*jBitmap*/, AndroidBitmapInfo & /*outputInfo*/) {
+    return NULL;
+}
+
+namespace {
+
+struct PngReader {
+    const uint8_t * mData;
+    size_t mSize;
+    size_t mOffset;
+};
+
+void pngRead(png_structp png, png_bytep out, png_size_t length) {
+    PngReader * reader = (PngReader *) png_get_io_ptr(png);
+    if (reader->mOffset + length > reader->mSize)
+        png_error(png, "read past end of buffer");
+    memcpy(out, reader->mData + reader->mOffset, length);
+    reader->mOffset += length;
+}
+
+uint8_t * decodePng(const uint8_t * data, size_t size, AndroidBitmapInfo & info) {
+    png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    if (png == NULL)
+        return NULL;
+    png_infop pinfo = png_create_info_struct(png);
+    if (pinfo == NULL) {
+        png_destroy_read_struct(&png, NULL, NULL);
+        return NULL;
+    }
+
+    uint8_t * pixels = NULL;
+    png_bytep * rows = NULL;
+    if (setjmp(png_jmpbuf(png))) {
+        delete [] pixels;
+        delete [] rows;
+        png_destroy_read_struct(&png, &pinfo, NULL);
+        return NULL;
+    }
+
+    PngReader reader = { data, size, 0 };
+    png_set_read_fn(png, &reader, pngRead);
+    png_read_info(png, pinfo);
+
+    png_uint_32 width = png_get_image_width(png, pinfo);
+    png_uint_32 height = png_get_image_height(png, pinfo);
+    int colorType = png_get_color_type(png, pinfo);
+    int bitDepth = png_get_bit_depth(png, pinfo);
+
+    // Normalize everything to 8 bit RGBA.
+    if (bitDepth == 16)
+        png_set_strip_16(png);
+    if (colorType == PNG_COLOR_TYPE_PALETTE)
+        png_set_palette_to_rgb(png);
+    if (colorType == PNG_COLOR_TYPE_GRAY && bitDepth < 8)
+        png_set_expand_gray_1_2_4_to_8(png);
+    if (png_get_valid(png, pinfo, PNG_INFO_tRNS))
+        png_set_tRNS_to_alpha(png);
+    if (colorType == PNG_COLOR_TYPE_GRAY || colorType == PNG_COLOR_TYPE_GRAY_ALPHA)
+        png_set_gray_to_rgb(png);
+    if (colorType == PNG_COLOR_TYPE_RGB || colorType == PNG_COLOR_TYPE_GRAY || colorType == PNG_COLOR_TYPE_PALETTE)
+        png_set_filler(png, 0xFF, PNG_FILLER_AFTER);
+    png_read_update_info(png, pinfo);
+
+    const size_t stride = width * 4;
+    pixels = new uint8_t [stride * height];
+    rows = new png_bytep [height];
+    for (png_uint_32 y = 0; y < height; y++)
+        rows[y] = pixels + y * stride;
+    png_read_image(png, rows);
+    png_read_end(png, NULL);
+
+    delete [] rows;
+    png_destroy_read_struct(&png, &pinfo, NULL);
+
+    info.width = width;
+    info.height = height;
+    info.stride = stride;
+    info.format = ANDROID_BITMAP_FORMAT_RGBA_8888;
+    info.flags = 0;
+    return pixels;
+}
+
+struct JpegError {
+    jpeg_error_mgr mPub;
+    jmp_buf mJump;
+};
+
+void jpegErrorExit(j_common_ptr cinfo) {
+    JpegError * err = (JpegError *) cinfo->err;
+    longjmp(err->mJump, 1);
+}
+
+uint8_t * decodeJpeg(const uint8_t * data, size_t size, AndroidBitmapInfo & info) {
+    jpeg_decompress_struct cinfo;
+    JpegError jerr;
+    cinfo.err = jpeg_std_error(&jerr.mPub);
+    jerr.mPub.error_exit = jpegErrorExit;
+
+    uint8_t * pixels = NULL;
+    uint8_t * row = NULL;
+    if (setjmp(jerr.mJump)) {
+        delete [] pixels;
+        delete [] row;
+        jpeg_destroy_decompress(&cinfo);
+        return NULL;
+    }
+
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, (unsigned char *) data, size);
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.out_color_space = JCS_RGB;
+    jpeg_start_decompress(&cinfo);
+
+    const size_t width = cinfo.output_width;
+    const size_t height = cinfo.output_height;
+    const size_t stride = width * 4;
+    pixels = new uint8_t [stride * height];
+    row = new uint8_t [width * 3];
+    while (cinfo.output_scanline < cinfo.output_height) {
+        uint8_t * dst = pixels + cinfo.output_scanline * stride;
+        JSAMPROW rows[1] = { row };
+        jpeg_read_scanlines(&cinfo, rows, 1);
+        for (size_t x = 0; x < width; x++) {
+            dst[x * 4 + 0] = row[x * 3 + 0];
+            dst[x * 4 + 1] = row[x * 3 + 1];
+            dst[x * 4 + 2] = row[x * 3 + 2];
+            dst[x * 4 + 3] = 0xFF;
+        }
+    }
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    delete [] row;
+
+    info.width = width;
+    info.height = height;
+    info.stride = stride;
+    info.format = ANDROID_BITMAP_FORMAT_RGBA_8888;
+    info.flags = 0;
+    return pixels;
+}
+
+}  // namespace
+
+uint8_t * BitmapFactory::decodeByteArray(JNIEnv * env, const void * array, size_t size, AndroidBitmapInfo & outputInfo)
+{
+    // A NULL env is what a worker that never attached would pass on the
+    // device, where it crashes.  Fail here so the tests see it.
+    if (env == NULL) {
+        LOGE("decodeByteArray: no JNIEnv, the thread is not attached");
+        return NULL;
+    }
+    const uint8_t * data = (const uint8_t *) array;
+    uint8_t * pixels = NULL;
+    if (size >= 8 && png_sig_cmp((png_const_bytep) data, 0, 8) == 0) {
+        pixels = decodePng(data, size, outputInfo);
+    } else if (size >= 2 && data[0] == 0xFF && data[1] == 0xD8) {
+        pixels = decodeJpeg(data, size, outputInfo);
+    }
+    if (pixels == NULL)
+        LOGE("Unable to decode");
+    return pixels;
+}
+
+Context * Context::sInstance = NULL;
+
+Context::Context(JavaVM* vm) : mActivityNative(NULL), mVM(vm), mAssetManagerInstance(NULL),
+        mAssetManager(NULL), mBitmapFactory(NULL) {
+    sInstance = this;
+}
+
+Context::Context() : mActivityNative(NULL), mVM(NULL), mAssetManagerInstance(NULL),
+        mAssetManager(NULL), mBitmapFactory(NULL) {
+    sInstance = this;
+}
+
+Context::~Context() {
+    if (mBitmapFactory) delete mBitmapFactory;
+    mBitmapFactory = NULL;
+    if (sInstance == this)
+        sInstance = NULL;
+}
+
+void Context::init(JNIEnv * env, jobject assetManagerInstance) {
+    mAssetManagerInstance = assetManagerInstance;
+
+    mAssetManager = AAssetManager_fromJava(env, mAssetManagerInstance);
+    if (mAssetManager == NULL) {
+        LOGE("Fail to get AssetManager");
+        abort();
+    }
+
+    if (mBitmapFactory == NULL)
+        mBitmapFactory = new BitmapFactory(env);
+}
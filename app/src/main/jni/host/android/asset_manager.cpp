@@ -0,0 +1,69 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#include <android/asset_manager.h>
+#include <android/asset_manager_jni.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#ifndef HELLOVR_HOST_ASSET_ROOT
+#define HELLOVR_HOST_ASSET_ROOT "assets"
+#endif
+
+struct AAssetManager {
+    std::string mRoot;
+};
+
+struct AAsset {
+    std::vector<char> mData;
+};
+
+AAssetManager * AAssetManager_fromJava(JNIEnv * /*env*/, jobject /*assetManager*/) {
+    static AAssetManager sManager;
+    const char * root = getenv("HELLOVR_ASSET_ROOT");
+    sManager.mRoot = root != NULL ? root : HELLOVR_HOST_ASSET_ROOT;
+    return &sManager;
+}
+
+AAsset * AAssetManager_open(AAssetManager * mgr, const char * filename, int /*mode*/) {
+    if (mgr == NULL || filename == NULL)
+        return NULL;
+
+    std::string path = mgr->mRoot + "/" + filename;
+    FILE * fp = fopen(path.c_str(), "rb");
+    if (fp == NULL)
+        return NULL;
+
+    AAsset * asset = new AAsset();
+    char buffer[16384];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+        asset->mData.insert(asset->mData.end(), buffer, buffer + n);
+    fclose(fp);
+    return asset;
+}
+
+const void * AAsset_getBuffer(AAsset * asset) {
+    if (asset == NULL || asset->mData.empty())
+        return NULL;
+    return asset->mData.data();
+}
+
+off_t AAsset_getLength(AAsset * asset) {
+    if (asset == NULL)
+        return 0;
+    return (off_t) asset->mData.size();
+}
+
+void AAsset_close(AAsset * asset) {
+    delete asset;
+}
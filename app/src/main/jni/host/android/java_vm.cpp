@@ -0,0 +1,51 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#include <jni.h>
+#include <stddef.h>
+
+namespace {
+
+// Non-NULL while the thread is attached.  Points at sTag, which only
+// serves to give every thread a distinct handle.
+thread_local JNIEnv * sEnv = NULL;
+thread_local char sTag;
+
+JavaVM sVM;
+
+} // namespace
+
+jint _JavaVM::GetEnv(void ** env, jint version) {
+    if (version != JNI_VERSION_1_6) {
+        *env = NULL;
+        return JNI_EVERSION;
+    }
+    *env = sEnv;
+    return sEnv != NULL ? JNI_OK : JNI_EDETACHED;
+}
+
+jint _JavaVM::AttachCurrentThread(JNIEnv ** env, void * /*args*/) {
+    if (sEnv == NULL)
+        sEnv = (JNIEnv *) &sTag;
+    *env = sEnv;
+    return JNI_OK;
+}
+
+jint _JavaVM::DetachCurrentThread() {
+    sEnv = NULL;
+    return JNI_OK;
+}
+
+jint JNI_GetCreatedJavaVMs(JavaVM ** vms, jsize count, jsize * found) {
+    if (count > 0)
+        vms[0] = &sVM;
+    *found = 1;
+    return JNI_OK;
+}
@@ -0,0 +1,59 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#include <android/log.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <mutex>
+
+static int minPriority() {
+    static int sPriority = -1;
+    if (sPriority >= 0)
+        return sPriority;
+
+    const char * env = getenv("HELLOVR_LOG");
+    int prio = ANDROID_LOG_WARN;
+    if (env != NULL) {
+        switch (env[0]) {
+        case 'V': case 'v': prio = ANDROID_LOG_VERBOSE; break;
+        case 'D': case 'd': prio = ANDROID_LOG_DEBUG; break;
+        case 'I': case 'i': prio = ANDROID_LOG_INFO; break;
+        case 'W': case 'w': prio = ANDROID_LOG_WARN; break;
+        case 'E': case 'e': prio = ANDROID_LOG_ERROR; break;
+        case 'F': case 'f': prio = ANDROID_LOG_FATAL; break;
+        case 'S': case 's': prio = ANDROID_LOG_SILENT; break;
+        default: break;
+        }
+    }
+    sPriority = prio;
+    return sPriority;
+}
+
+int __android_log_vprint(int prio, const char * tag, const char * fmt, va_list ap) {
+    static const char sLevels[] = "??VDIWEFS";
+    static std::mutex sMutex;
+    if (prio < minPriority())
+        return 0;
+
+    std::lock_guard<std::mutex> lock(sMutex);
+    char level = (prio >= 0 && prio <= ANDROID_LOG_SILENT) ? sLevels[prio] : '?';
+    fprintf(stderr, "%c/%s: ", level, tag != NULL ? tag : "");
+    int n = vfprintf(stderr, fmt, ap);
+    fputc('\n', stderr);
+    return n;
+}
+
+int __android_log_print(int prio, const char * tag, const char * fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int n = __android_log_vprint(prio, tag, fmt, args);
+    va_end(args);
+    return n;
+}
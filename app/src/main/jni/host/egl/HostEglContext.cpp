@@ -0,0 +1,139 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#define LOG_TAG "HostEgl"
+#include <log.h>
+#include <string.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES3/gl3.h>
+
+#include "HostEglContext.h"
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+#ifndef EGL_NO_CONFIG_KHR
+#define EGL_NO_CONFIG_KHR ((EGLConfig) 0)
+#endif
+
+HostEglContext::HostEglContext() :
+        mDisplay(EGL_NO_DISPLAY),
+        mContext(EGL_NO_CONTEXT),
+        mSurface(EGL_NO_SURFACE) {
+}
+
+HostEglContext::~HostEglContext() {
+    shutdown();
+}
+
+static bool hasExtension(const char * list, const char * name) {
+    if (list == NULL)
+        return false;
+    const size_t len = strlen(name);
+    for (const char * p = strstr(list, name); p != NULL; p = strstr(p + len, name)) {
+        if ((p == list || p[-1] == ' ') && (p[len] == ' ' || p[len] == '\0'))
+            return true;
+    }
+    return false;
+}
+
+bool HostEglContext::init() {
+    if (mContext != EGL_NO_CONTEXT)
+        return true;
+
+    const char * clientExts = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay != NULL && hasExtension(clientExts, "EGL_MESA_platform_surfaceless"))
+        mDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    if (mDisplay == EGL_NO_DISPLAY)
+        mDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    EGLint major = 0, minor = 0;
+    if (mDisplay == EGL_NO_DISPLAY || !eglInitialize(mDisplay, &major, &minor)) {
+        LOGE("eglInitialize failed 0x%x", eglGetError());
+        mDisplay = EGL_NO_DISPLAY;
+        return false;
+    }
+    eglBindAPI(EGL_OPENGL_ES_API);
+
+    const char * displayExts = eglQueryString(mDisplay, EGL_EXTENSIONS);
+    const EGLint contextAttribs[] = { EGL_CONTEXT_CLIENT_VERSION, 3, EGL_NONE };
+
+    // A 1x1 pbuffer gives the context a default framebuffer, like the window
+    // surface on the device, so the sample's clears of framebuffer 0 are legal.
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT_KHR,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_NONE
+    };
+    const EGLint pbufferAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+    EGLConfig config = NULL;
+    EGLint count = 0;
+    if (eglChooseConfig(mDisplay, configAttribs, &config, 1, &count) && count > 0) {
+        mSurface = eglCreatePbufferSurface(mDisplay, config, pbufferAttribs);
+        if (mSurface != EGL_NO_SURFACE)
+            mContext = eglCreateContext(mDisplay, config, EGL_NO_CONTEXT, contextAttribs);
+        if (mContext != EGL_NO_CONTEXT && !eglMakeCurrent(mDisplay, mSurface, mSurface, mContext)) {
+            eglDestroyContext(mDisplay, mContext);
+            mContext = EGL_NO_CONTEXT;
+        }
+        if (mContext == EGL_NO_CONTEXT && mSurface != EGL_NO_SURFACE) {
+            eglDestroySurface(mDisplay, mSurface);
+            mSurface = EGL_NO_SURFACE;
+        }
+    }
+
+    // Otherwise no config and no surface at all, render only into FBOs.
+    if (mContext == EGL_NO_CONTEXT &&
+            hasExtension(displayExts, "EGL_KHR_surfaceless_context") &&
+            hasExtension(displayExts, "EGL_KHR_no_config_context")) {
+        LOGW("No pbuffer config, using a surfaceless context without a default framebuffer");
+        mContext = eglCreateContext(mDisplay, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttribs);
+        if (mContext != EGL_NO_CONTEXT &&
+                !eglMakeCurrent(mDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, mContext)) {
+            eglDestroyContext(mDisplay, mContext);
+            mContext = EGL_NO_CONTEXT;
+        }
+    }
+
+    if (mContext == EGL_NO_CONTEXT) {
+        LOGE("Failed to make a GLES 3 context current 0x%x", eglGetError());
+        shutdown();
+        return false;
+    }
+
+    LOGI("EGL %d.%d, GL_RENDERER %s, GL_VERSION %s", major, minor,
+            getRenderer(), (const char *) glGetString(GL_VERSION));
+    return true;
+}
+
+void HostEglContext::shutdown() {
+    if (mDisplay == EGL_NO_DISPLAY)
+        return;
+    eglMakeCurrent(mDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (mContext != EGL_NO_CONTEXT)
+        eglDestroyContext(mDisplay, mContext);
+    if (mSurface != EGL_NO_SURFACE)
+        eglDestroySurface(mDisplay, mSurface);
+    eglTerminate(mDisplay);
+    mDisplay = EGL_NO_DISPLAY;
+    mContext = EGL_NO_CONTEXT;
+    mSurface = EGL_NO_SURFACE;
+}
+
+const char * HostEglContext::getRenderer() const {
+    if (mContext == EGL_NO_CONTEXT)
+        return "";
+    return (const char *) glGetString(GL_RENDERER);
+}
@@ -0,0 +1,33 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+
+#include <EGL/egl.h>
+
+// Host only.  A GLES 3 context without a window, for running the render code
+// under hellovr_tests and hellovr_bench.  Uses Mesa's surfaceless platform
+// when available, with a 1x1 pbuffer as the default framebuffer.
+class HostEglContext {
+public:
+    HostEglContext();
+    ~HostEglContext();
+
+    bool init();
+    void shutdown();
+
+    bool isCurrent() const { return mContext != EGL_NO_CONTEXT; }
+    const char * getRenderer() const;
+
+private:
+    EGLDisplay mDisplay;
+    EGLContext mContext;
+    EGLSurface mSurface;
+};
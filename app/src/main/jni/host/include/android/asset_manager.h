@@ -0,0 +1,45 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+// Host stand-in for <android/asset_manager.h>.  Assets are plain files
+// below a root directory, see AAssetManager_fromJava().
+
+#pragma once
+#include <stddef.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct AAssetManager;
+typedef struct AAssetManager AAssetManager;
+
+struct AAsset;
+typedef struct AAsset AAsset;
+
+enum {
+    AASSET_MODE_UNKNOWN   = 0,
+    AASSET_MODE_RANDOM    = 1,
+    AASSET_MODE_STREAMING = 2,
+    AASSET_MODE_BUFFER    = 3
+};
+
+AAsset * AAssetManager_open(AAssetManager * mgr, const char * filename, int mode);
+
+const void * AAsset_getBuffer(AAsset * asset);
+
+off_t AAsset_getLength(AAsset * asset);
+
+void AAsset_close(AAsset * asset);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,25 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+#include <jni.h>
+#include <android/asset_manager.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// On the host the Java AssetManager is ignored.  The returned manager reads
+// from $HELLOVR_ASSET_ROOT, or from the directory baked in at build time.
+AAssetManager * AAssetManager_fromJava(JNIEnv * env, jobject assetManager);
+
+#ifdef __cplusplus
+}
+#endif
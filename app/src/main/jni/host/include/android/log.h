@@ -0,0 +1,41 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+// Host stand-in for <android/log.h>.  Messages go to stderr.  The minimum
+// priority printed is read from HELLOVR_LOG (V, D, I, W, E, F or S to
+// silence everything) and defaults to W.
+
+#pragma once
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum android_LogPriority {
+    ANDROID_LOG_UNKNOWN = 0,
+    ANDROID_LOG_DEFAULT,
+    ANDROID_LOG_VERBOSE,
+    ANDROID_LOG_DEBUG,
+    ANDROID_LOG_INFO,
+    ANDROID_LOG_WARN,
+    ANDROID_LOG_ERROR,
+    ANDROID_LOG_FATAL,
+    ANDROID_LOG_SILENT,
+} android_LogPriority;
+
+int __android_log_print(int prio, const char * tag, const char * fmt, ...)
+    __attribute__ ((format(printf, 3, 4)));
+
+int __android_log_vprint(int prio, const char * tag, const char * fmt, va_list ap);
+
+#ifdef __cplusplus
+}
+#endif
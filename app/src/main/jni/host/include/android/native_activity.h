@@ -0,0 +1,24 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+#include <jni.h>
+#include <android/asset_manager.h>
+
+typedef struct ANativeActivity {
+    JavaVM * vm;
+    JNIEnv * env;
+    jobject clazz;
+    const char * internalDataPath;
+    const char * externalDataPath;
+    int32_t sdkVersion;
+    void * instance;
+    AAssetManager * assetManager;
+} ANativeActivity;
@@ -0,0 +1,60 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+// Host stand-in for <jni.h>.  The rendering core only passes JNIEnv and
+// JavaVM pointers around; no Java VM exists in the host build, so every
+// handle is opaque and every call site is replaced by host/Context.cpp.
+// The exception is thread attachment: the JavaVM of host/android/java_vm.cpp
+// tracks which threads are attached, so EnvWrapper runs as on the device.
+
+#pragma once
+#include <stdint.h>
+
+typedef int32_t jint;
+typedef int64_t jlong;
+typedef int8_t jbyte;
+typedef uint8_t jboolean;
+typedef jint jsize;
+
+struct _jobject;
+typedef _jobject * jobject;
+typedef jobject jclass;
+typedef jobject jstring;
+typedef jobject jarray;
+typedef jarray jbyteArray;
+
+struct _jmethodID;
+typedef _jmethodID * jmethodID;
+
+struct _JNIEnv;
+struct _JavaVM;
+typedef _JNIEnv JNIEnv;
+typedef _JavaVM JavaVM;
+
+#define JNIEXPORT __attribute__ ((visibility ("default")))
+#define JNICALL
+
+#define JNI_OK          (0)
+#define JNI_ERR         (-1)
+#define JNI_EDETACHED   (-2)
+#define JNI_EVERSION    (-3)
+
+#define JNI_VERSION_1_6 0x00010006
+
+// Each attached thread gets a JNIEnv handle of its own that nothing
+// dereferences.  GetEnv() gives JNI_EDETACHED on other threads.
+struct _JavaVM {
+    jint GetEnv(void ** env, jint version);
+    jint AttachCurrentThread(JNIEnv ** env, void * args);
+    jint DetachCurrentThread();
+};
+
+// The one host VM.
+jint JNI_GetCreatedJavaVMs(JavaVM ** vms, jsize count, jsize * found);
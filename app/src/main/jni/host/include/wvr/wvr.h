@@ -0,0 +1,51 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#ifndef wvr_h_
+#define wvr_h_
+
+#include "wvr_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    WVR_AppType_VRContent = 1,
+    WVR_AppType_NonVRContent = 2,
+} WVR_AppType;
+
+typedef enum {
+    WVR_InitError_None = 0,
+    WVR_InitError_Unknown = 1,
+    WVR_InitError_NotInitialized = 2,
+} WVR_InitError;
+
+typedef int (*WVR_MainFunc)(int argc, char *argv[]);
+
+extern WVR_EXPORT WVR_InitError WVR_Init(WVR_AppType eType);
+
+extern WVR_EXPORT void WVR_Quit();
+
+extern WVR_EXPORT const char * WVR_GetInitErrorString(WVR_InitError error);
+
+/**
+ * Query a named runtime parameter.  With a NULL buffer the required size,
+ * including the terminating NUL, is returned.
+ */
+extern WVR_EXPORT uint32_t WVR_GetParameters(WVR_DeviceType type, const char * pchValue, char * retValue, uint32_t bufferSize);
+
+extern WVR_EXPORT void WVR_RegisterMain(WVR_MainFunc main);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // wvr_h_
@@ -0,0 +1,100 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#ifndef wvr_ctrller_render_model_h_
+#define wvr_ctrller_render_model_h_
+
+#include "wvr_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct WVR_VertexBuffer {
+    float * buffer;
+    uint32_t size;          /**< number of floats */
+    uint32_t dimension;     /**< floats per vertex */
+} WVR_VertexBuffer_t;
+
+typedef struct WVR_IndexBuffer {
+    uint32_t * buffer;
+    uint32_t size;          /**< number of indices */
+    uint32_t type;          /**< indices per face */
+} WVR_IndexBuffer_t;
+
+typedef struct WVR_CtrlerCompInfo {
+    WVR_VertexBuffer_t vertices;
+    WVR_VertexBuffer_t normals;
+    WVR_VertexBuffer_t texCoords;
+    WVR_IndexBuffer_t indices;
+    int32_t texIndex;
+    float localMat[16];     /**< column major */
+    char name[64];
+    bool defaultDraw;
+} WVR_CtrlerCompInfo_t;
+
+typedef struct WVR_CtrlerCompInfoTable {
+    WVR_CtrlerCompInfo_t * table;
+    uint32_t size;
+} WVR_CtrlerCompInfoTable_t;
+
+typedef struct WVR_CtrlerTexBitmap {
+    uint8_t * bitmap;
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    int32_t format;         /**< ANDROID_BITMAP_FORMAT_* */
+} WVR_CtrlerTexBitmap_t;
+
+typedef struct WVR_CtrlerTexBitmapTable {
+    WVR_CtrlerTexBitmap_t * table;
+    uint32_t size;
+} WVR_CtrlerTexBitmapTable_t;
+
+typedef struct WVR_TouchPadPlane {
+    WVR_Vector3f_t u;
+    WVR_Vector3f_t v;
+    WVR_Vector3f_t w;
+    WVR_Vector3f_t center;
+    float floatingDistance;
+    float radius;
+    bool valid;
+} WVR_TouchPadPlane_t;
+
+typedef struct WVR_BatteryLevelTable {
+    WVR_CtrlerTexBitmap_t * texTable;
+    int32_t * minLvTable;
+    int32_t * maxLvTable;
+    uint32_t size;
+} WVR_BatteryLevelTable_t;
+
+typedef struct WVR_CtrlerModel {
+    char name[256];
+    WVR_CtrlerCompInfoTable_t compInfos;
+    WVR_CtrlerTexBitmapTable_t bitmapInfos;
+    WVR_TouchPadPlane_t touchpadPlane;
+    WVR_BatteryLevelTable_t batteryLevels;
+    bool loadFromAsset;
+} WVR_CtrlerModel_t;
+
+/** Parse the render model of the current controller.  Release it with WVR_ReleaseControllerModel. */
+extern WVR_EXPORT WVR_Result WVR_GetCurrentControllerModel(WVR_DeviceType ctrlerType, WVR_CtrlerModel_t ** ctrlerModel, bool isOneBone = false);
+
+/** Free a model from WVR_GetCurrentControllerModel and reset the pointer to nullptr. */
+extern WVR_EXPORT void WVR_ReleaseControllerModel(WVR_CtrlerModel_t ** ctrlerModel);
+
+/** Column major pose of the ray emitter in controller space. */
+extern WVR_EXPORT WVR_Result WVR_GetCurrentControllerEmitter(WVR_DeviceType ctrlerType, float emitterPose[16]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // wvr_ctrller_render_model_h_
@@ -0,0 +1,52 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#ifndef wvr_device_h_
+#define wvr_device_h_
+
+#include "wvr_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    WVR_SimulationType_Auto      = 0,
+    WVR_SimulationType_ForceOn   = 1,
+    WVR_SimulationType_ForceOff  = 2,
+} WVR_SimulationType;
+
+extern WVR_EXPORT bool WVR_IsDeviceConnected(WVR_DeviceType type);
+
+extern WVR_EXPORT bool WVR_GetInputButtonState(WVR_DeviceType type, WVR_InputId id);
+
+extern WVR_EXPORT bool WVR_GetInputTouchState(WVR_DeviceType type, WVR_InputId id);
+
+extern WVR_EXPORT WVR_Axis_t WVR_GetInputAnalogAxis(WVR_DeviceType type, WVR_InputId id);
+
+extern WVR_EXPORT float WVR_GetDeviceBatteryPercentage(WVR_DeviceType type);
+
+extern WVR_EXPORT bool WVR_SetInputRequest(WVR_DeviceType type, const WVR_InputAttribute * request, uint32_t size);
+
+extern WVR_EXPORT bool WVR_GetInputMappingPair(WVR_DeviceType type, WVR_InputId destination, WVR_InputMappingPair * pair);
+
+extern WVR_EXPORT void WVR_GetSyncPose(WVR_PoseOriginModel originModel, WVR_DevicePosePair_t * retPose, uint32_t poseCount);
+
+extern WVR_EXPORT void WVR_GetPoseState(WVR_DeviceType type, WVR_PoseOriginModel originModel, uint32_t predictedMilliSec, WVR_PoseState_t * poseState);
+
+extern WVR_EXPORT void WVR_SetArmModel(WVR_SimulationType type);
+
+extern WVR_EXPORT WVR_DeviceType WVR_GetDefaultControllerRole();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // wvr_device_h_
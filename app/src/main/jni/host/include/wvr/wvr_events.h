@@ -0,0 +1,71 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#ifndef wvr_events_h_
+#define wvr_events_h_
+
+#include "wvr_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    /** common event region */
+    WVR_EventType_Quit                              = 1000,
+    WVR_EventType_SystemInteractionModeChanged      = 1001,
+    WVR_EventType_SystemGazeTriggerTypeChanged      = 1002,
+    WVR_EventType_TrackingModeChanged               = 1003,
+    WVR_EventType_RecommendedQuality_Lower          = 1004,
+    WVR_EventType_RecommendedQuality_Higher         = 1005,
+
+    /** Device events region */
+    WVR_EventType_DeviceConnected                   = 2000,
+    WVR_EventType_DeviceDisconnected                = 2001,
+    WVR_EventType_DeviceStatusUpdate                = 2002,
+    WVR_EventType_IpdChanged                        = 2005,
+    WVR_EventType_DeviceRoleChanged                 = 2008,
+
+    /** Input Event region */
+    WVR_EventType_ButtonPressed                     = 3000,
+    WVR_EventType_ButtonUnpressed                   = 3001,
+    WVR_EventType_TouchTapped                       = 3002,
+    WVR_EventType_TouchUntapped                     = 3003,
+} WVR_EventType;
+
+typedef struct WVR_CommonEvent {
+    WVR_EventType type;
+    int64_t timestamp;          /**< nanoseconds, CLOCK_MONOTONIC */
+} WVR_CommonEvent_t;
+
+typedef struct WVR_DeviceEvent {
+    WVR_CommonEvent_t common;
+    WVR_DeviceType deviceType;
+} WVR_DeviceEvent_t;
+
+typedef struct WVR_InputEvent {
+    WVR_DeviceEvent_t device;
+    WVR_InputId inputId;
+} WVR_InputEvent_t;
+
+typedef union WVR_Event {
+    WVR_CommonEvent_t common;
+    WVR_DeviceEvent_t device;
+    WVR_InputEvent_t input;
+} WVR_Event_t;
+
+/** Pop the oldest pending event.  Returns false when the queue is empty. */
+extern WVR_EXPORT bool WVR_PollEventQueue(WVR_Event_t * event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // wvr_events_h_
@@ -0,0 +1,18 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+// hellovr includes this header but uses none of the overlay API.
+
+#ifndef wvr_overlay_h_
+#define wvr_overlay_h_
+
+#include "wvr_types.h"
+
+#endif  // wvr_overlay_h_
@@ -0,0 +1,34 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#ifndef wvr_projection_h_
+#define wvr_projection_h_
+
+#include "wvr_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern WVR_EXPORT WVR_Matrix4f_t WVR_GetProjection(WVR_Eye eye, float near, float far);
+
+extern WVR_EXPORT void WVR_GetClippingPlaneBoundary(WVR_Eye eye, float * left, float * right, float * top, float * bottom);
+
+#ifdef __cplusplus
+extern WVR_EXPORT WVR_Matrix4f_t WVR_GetTransformFromEyeToHead(WVR_Eye eye, WVR_NumDoF dof = WVR_NumDoF_6DoF);
+#else
+extern WVR_EXPORT WVR_Matrix4f_t WVR_GetTransformFromEyeToHead(WVR_Eye eye, WVR_NumDoF dof);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // wvr_projection_h_
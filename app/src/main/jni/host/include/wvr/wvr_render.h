@@ -0,0 +1,154 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#ifndef wvr_render_h_
+#define wvr_render_h_
+
+#include "wvr_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    WVR_GraphicsApiType_OpenGL = 1,
+} WVR_GraphicsApiType;
+
+typedef enum {
+    WVR_RenderConfig_Default                = 0,
+    WVR_RenderConfig_Disable_SeparateWindow = 1 << 0,
+    WVR_RenderConfig_MSAA                   = 1 << 1,
+    WVR_RenderConfig_sRGB                   = 1 << 2,
+} WVR_RenderConfig;
+
+typedef struct WVR_RenderInitParams {
+    WVR_GraphicsApiType graphicsApi;
+    uint64_t renderConfig;
+} WVR_RenderInitParams_t;
+
+typedef enum {
+    WVR_RenderError_None                    = 0,
+    WVR_RenderError_RuntimeInitFailed       = 410,
+    WVR_RenderError_ContextSetupFailed      = 411,
+    WVR_RenderError_DisplaySetupFailed      = 412,
+    WVR_RenderError_LibNotSupported         = 413,
+    WVR_RenderError_NullPtr                 = 414,
+    WVR_RenderError_Max                     = 65535,
+} WVR_RenderError;
+
+typedef enum {
+    WVR_SubmitError_None                    = 0,
+    WVR_SubmitError_InvalidTexture          = 400,
+    WVR_SubmitError_ThreadStop              = 401,
+    WVR_SubmitError_BufferSubmitFailed      = 402,
+    WVR_SubmitError_Max                     = 65535,
+} WVR_SubmitError;
+
+typedef enum {
+    WVR_SubmitExtend_Default        = 0x0000,
+    WVR_SubmitExtend_DisableDistortion = 0x0001,
+    WVR_SubmitExtend_PartialTexture = 0x0010,
+} WVR_SubmitExtend;
+
+typedef enum {
+    WVR_TextureTarget_2D,
+    WVR_TextureTarget_2D_ARRAY,
+    WVR_TextureTarget_VULKAN,
+} WVR_TextureTarget;
+
+typedef enum {
+    WVR_TextureFormat_RGBA,
+} WVR_TextureFormat;
+
+typedef enum {
+    WVR_TextureType_UnsignedByte,
+} WVR_TextureType;
+
+typedef enum {
+    WVR_FoveationMode_Disable = 0,
+    WVR_FoveationMode_Enable  = 1,
+    WVR_FoveationMode_Default = 2,
+} WVR_FoveationMode;
+
+typedef enum {
+    WVR_PeripheralQuality_Low    = 0x0000,
+    WVR_PeripheralQuality_Medium = 0x0001,
+    WVR_PeripheralQuality_High   = 0x0002,
+} WVR_PeripheralQuality;
+
+typedef enum {
+    WVR_QualityStrategy_Default          = 1,
+    WVR_QualityStrategy_SendQualityEvent = 1,
+    WVR_QualityStrategy_AutoFoveation    = 1 << 1,
+    WVR_QualityStrategy_Reserved_2       = 1 << 2,
+} WVR_QualityStrategy;
+
+typedef void * WVR_TextureQueueHandle_t;
+typedef void * WVR_Texture_t;
+
+typedef struct WVR_TextureLayout {
+    WVR_Vector2f_t leftLowUVs;
+    WVR_Vector2f_t rightUpUVs;
+} WVR_TextureLayout_t;
+
+typedef struct WVR_TextureParams {
+    WVR_Texture_t id;
+    WVR_TextureTarget target;
+    WVR_TextureLayout_t layout;
+} WVR_TextureParams_t;
+
+typedef struct WVR_RenderFoveationParams {
+    float focalX;                       /**< NDC, [-1, 1] */
+    float focalY;                       /**< NDC, [-1, 1] */
+    float fovealFov;                    /**< degree */
+    WVR_PeripheralQuality periQuality;
+} WVR_RenderFoveationParams_t;
+
+typedef struct WVR_RenderProps {
+    float refreshRate;
+    bool hasExternal;
+    float ipdMeter;
+} WVR_RenderProps_t;
+
+extern WVR_EXPORT WVR_RenderError WVR_RenderInit(const WVR_RenderInitParams_t * param);
+
+extern WVR_EXPORT void WVR_GetRenderTargetSize(uint32_t * width, uint32_t * height);
+
+extern WVR_EXPORT bool WVR_GetRenderProps(WVR_RenderProps_t * props);
+
+extern WVR_EXPORT WVR_TextureQueueHandle_t WVR_ObtainTextureQueue(WVR_TextureTarget target, WVR_TextureFormat format, WVR_TextureType type, uint32_t width, uint32_t height, int32_t level);
+
+extern WVR_EXPORT uint32_t WVR_GetTextureQueueLength(WVR_TextureQueueHandle_t handle);
+
+extern WVR_EXPORT WVR_TextureParams_t WVR_GetTexture(WVR_TextureQueueHandle_t handle, int32_t index);
+
+extern WVR_EXPORT int32_t WVR_GetAvailableTextureIndex(WVR_TextureQueueHandle_t handle);
+
+extern WVR_EXPORT void WVR_ReleaseTextureQueue(WVR_TextureQueueHandle_t handle);
+
+extern WVR_EXPORT void WVR_RenderMask(WVR_Eye eye);
+
+extern WVR_EXPORT WVR_Result WVR_RenderFoveationMode(WVR_FoveationMode mode);
+
+extern WVR_EXPORT bool WVR_IsRenderFoveationEnabled();
+
+#ifdef __cplusplus
+extern WVR_EXPORT WVR_SubmitError WVR_SubmitFrame(WVR_Eye eye, const WVR_TextureParams_t * param, const WVR_PoseState_t * pose = NULL, WVR_SubmitExtend extendMethod = WVR_SubmitExtend_Default);
+
+extern WVR_EXPORT void WVR_PreRenderEye(WVR_Eye eye, const WVR_TextureParams_t * textureParam, const WVR_RenderFoveationParams_t * foveatedParam = NULL);
+
+extern WVR_EXPORT bool WVR_EnableAdaptiveQuality(bool enable, uint32_t strategyFlags = WVR_QualityStrategy_Default);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // wvr_render_h_
@@ -0,0 +1,90 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+// Host only.  Knobs and counters of the stub VR runtime in host/wvr/, used
+// by hellovr_tests and hellovr_bench to drive poses, input and events and to
+// observe what the sample submitted.  Not part of the WaveVR SDK.
+
+#ifndef wvr_stub_h_
+#define wvr_stub_h_
+
+#include "wvr_types.h"
+#include "wvr_events.h"
+#include "wvr_render.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct WVR_StubStats {
+    uint32_t submitCount[2];            /**< per WVR_Eye_Left / WVR_Eye_Right */
+    uint32_t preRenderCount[2];
+    uint32_t lastSubmitTexture[2];      /**< GL texture name */
+    uint32_t lastSubmitExtend[2];
+    WVR_TextureLayout_t lastSubmitLayout[2];
+    int64_t lastSubmitPoseTimestamp[2]; /**< 0 when submitted without a pose */
+    bool lastPreRenderFoveated[2];
+    WVR_RenderFoveationParams_t lastFoveation[2];
+    uint32_t syncPoseCount;
+    uint32_t liveTextureQueues;
+    uint32_t liveControllerModels;
+    uint32_t controllerModelLoads;      /**< successful WVR_GetCurrentControllerModel calls */
+    uint32_t inputQueries;              /**< WVR_GetInputButtonState, TouchState and AnalogAxis calls */
+    WVR_FoveationMode foveationMode;
+    bool adaptiveQualityEnabled;
+    uint32_t adaptiveQualityStrategy;
+} WVR_StubStats_t;
+
+/** Restore the default devices, poses, input state and counters.  Live texture queues are kept. */
+void WVR_Stub_Reset();
+
+void WVR_Stub_SetRenderTargetSize(uint32_t width, uint32_t height);
+
+void WVR_Stub_SetTextureQueueLength(uint32_t length);
+
+void WVR_Stub_SetDeviceConnected(WVR_DeviceType type, bool connected);
+
+/** Fix the pose of a device.  Disables the synthetic animation for that device. */
+void WVR_Stub_SetDevicePose(WVR_DeviceType type, const WVR_Matrix4f_t * pose, bool isValid, bool is6DoF);
+
+/**
+ * Animate the HMD and controllers with a slow deterministic sway derived
+ * from the monotonic clock, so a render loop sees poses change every frame.
+ */
+void WVR_Stub_SetPoseAnimation(bool enable);
+
+void WVR_Stub_SetButtonState(WVR_DeviceType type, WVR_InputId id, bool pressed);
+
+void WVR_Stub_SetTouchState(WVR_DeviceType type, WVR_InputId id, bool touched);
+
+void WVR_Stub_SetAnalogAxis(WVR_DeviceType type, WVR_InputId id, WVR_Axis_t axis);
+
+void WVR_Stub_SetBatteryPercentage(WVR_DeviceType type, float percentage);
+
+void WVR_Stub_SetInputFocusCapturedBySystem(bool captured);
+
+void WVR_Stub_SetIpd(float meter);
+
+/** Scale the controller render model's vertices, as a runtime update might change the model.  1 after reset. */
+void WVR_Stub_SetControllerModelScale(float scale);
+
+/** Queue an event for WVR_PollEventQueue.  A zero timestamp is replaced with the current time. */
+void WVR_Stub_PushEvent(const WVR_Event_t * event);
+
+void WVR_Stub_GetStats(WVR_StubStats_t * stats);
+
+/** Monotonic clock in nanoseconds, the time base of pose and event timestamps. */
+int64_t WVR_Stub_GetTimeNs();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // wvr_stub_h_
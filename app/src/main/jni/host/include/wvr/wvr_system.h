@@ -0,0 +1,34 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#ifndef wvr_system_h_
+#define wvr_system_h_
+
+#include "wvr_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern WVR_EXPORT bool WVR_IsInputFocusCapturedBySystem();
+
+extern WVR_EXPORT WVR_InteractionMode WVR_GetInteractionMode();
+
+extern WVR_EXPORT bool WVR_SetInteractionMode(WVR_InteractionMode mode);
+
+extern WVR_EXPORT WVR_GazeTriggerType WVR_GetGazeTriggerType();
+
+extern WVR_EXPORT bool WVR_SetGazeTriggerType(WVR_GazeTriggerType type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // wvr_system_h_
@@ -0,0 +1,184 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+// Host stand-in for the WaveVR SDK headers.  Only the part of the API used
+// by hellovr is declared; layouts follow the SDK so the sample code builds
+// unchanged.  The implementation lives in host/wvr/.
+
+#ifndef wvr_types_h_
+#define wvr_types_h_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define WVR_EXPORT __attribute__ ((visibility ("default")))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WVR_DEVICE_COUNT_LEVEL_0    1   /**< HMD */
+#define WVR_DEVICE_COUNT_LEVEL_1    3   /**< HMD, Two Controllers */
+#define WVR_DEVICE_COUNT_LEVEL_2    16  /**< HMD, Two Controllers, Others(Camera, Body tracker...) */
+#define WVR_DEVICE_HMD              0   /**< HMD index in WVR_DevicePosePair_t arrays */
+
+typedef enum {
+    WVR_Success                 = 0,
+    WVR_Error_SystemInvalid     = 1,
+    WVR_Error_InvalidArgument   = 2,
+    WVR_Error_OutOfMemory       = 3,
+    WVR_Error_FeatureNotSupport = 4,
+    WVR_Error_RuntimeVersionNotSupport = 5,
+    WVR_Error_CharacteristicNotFound = 6,
+    WVR_Error_CtrlerModel_InvalidModel = 100,
+    WVR_Error_CtrlerModel_DeviceDisconnected = 101,
+} WVR_Result;
+
+typedef enum {
+    WVR_DeviceType_Invalid          = 0,
+    WVR_DeviceType_HMD              = 1,
+    WVR_DeviceType_Controller_Right = 2,
+    WVR_DeviceType_Controller_Left  = 3,
+    WVR_DeviceType_Camera           = 4,
+    WVR_DeviceType_EyeTracking      = 5,
+} WVR_DeviceType;
+
+typedef enum {
+    WVR_Eye_Left  = 0,
+    WVR_Eye_Right = 1,
+    WVR_Eye_Both  = 2,
+    WVR_Eye_None,
+} WVR_Eye;
+
+typedef enum {
+    WVR_NumDoF_3DoF = 0,
+    WVR_NumDoF_6DoF = 1,
+} WVR_NumDoF;
+
+typedef enum {
+    WVR_PoseOriginModel_OriginOnHead                = 0,
+    WVR_PoseOriginModel_OriginOnGround              = 1,
+    WVR_PoseOriginModel_OriginOnTrackingObserver    = 2,
+    WVR_PoseOriginModel_OriginOnHead_3DoF           = 3,
+} WVR_PoseOriginModel;
+
+typedef enum {
+    WVR_InteractionMode_SystemDefault = 1,
+    WVR_InteractionMode_Gaze          = 2,
+    WVR_InteractionMode_Controller    = 3,
+} WVR_InteractionMode;
+
+typedef enum {
+    WVR_GazeTriggerType_Timeout       = 1,
+    WVR_GazeTriggerType_Button        = 2,
+    WVR_GazeTriggerType_TimeoutButton = 3,
+} WVR_GazeTriggerType;
+
+typedef enum {
+    WVR_InputId_Alias1_System      = 0,
+    WVR_InputId_Alias1_Menu        = 1,
+    WVR_InputId_Alias1_Grip        = 2,
+    WVR_InputId_Alias1_DPad_Left   = 3,
+    WVR_InputId_Alias1_DPad_Up     = 4,
+    WVR_InputId_Alias1_DPad_Right  = 5,
+    WVR_InputId_Alias1_DPad_Down   = 6,
+    WVR_InputId_Alias1_Volume_Up   = 7,
+    WVR_InputId_Alias1_Volume_Down = 8,
+    WVR_InputId_Alias1_Bumper      = 9,
+    WVR_InputId_Alias1_Enter       = 13,
+    WVR_InputId_Alias1_Touchpad    = 16,
+    WVR_InputId_Alias1_Thumbstick  = 17,
+    WVR_InputId_Alias1_Trigger     = 31,
+
+    WVR_InputId_Max                = 32,
+} WVR_InputId;
+
+typedef enum {
+    WVR_InputType_Button = 1 << 0,
+    WVR_InputType_Touch  = 1 << 1,
+    WVR_InputType_Analog = 1 << 2,
+} WVR_InputType;
+
+typedef enum {
+    WVR_AnalogType_None    = 0,
+    WVR_AnalogType_2D      = 1,
+    WVR_AnalogType_1D      = 2,
+} WVR_AnalogType;
+
+typedef struct WVR_Axis {
+    float x;
+    float y;
+} WVR_Axis_t;
+
+typedef struct WVR_InputAttribute {
+    WVR_InputId id;
+    uint32_t capability;        /**< bitmask of WVR_InputType */
+    WVR_AnalogType axis_type;
+} WVR_InputAttribute_t;
+
+typedef WVR_InputAttribute_t WVR_InputAttribute;
+
+typedef struct WVR_InputMappingPair {
+    WVR_InputAttribute destination;
+    WVR_InputAttribute source;
+} WVR_InputMappingPair_t;
+
+typedef WVR_InputMappingPair_t WVR_InputMappingPair;
+
+typedef struct WVR_Vector2f {
+    float v[2];
+} WVR_Vector2f_t;
+
+typedef struct WVR_Vector3f {
+    float v[3];
+} WVR_Vector3f_t;
+
+typedef struct WVR_Quatf {
+    float w;
+    float x;
+    float y;
+    float z;
+} WVR_Quatf_t;
+
+/** Row major: m[row][col]. */
+typedef struct WVR_Matrix4f {
+    float m[4][4];
+} WVR_Matrix4f_t;
+
+typedef struct WVR_Pose {
+    WVR_Vector3f_t position;
+    WVR_Quatf_t rotation;
+} WVR_Pose_t;
+
+typedef struct WVR_PoseState {
+    bool isValidPose;
+    WVR_Matrix4f_t poseMatrix;
+    WVR_Vector3f_t velocity;            /**< meter per second */
+    WVR_Vector3f_t angularVelocity;     /**< radian per second */
+    bool is6DoFPose;
+    int64_t timestamp;                  /**< nanoseconds, CLOCK_MONOTONIC */
+    WVR_Vector3f_t acceleration;
+    WVR_Vector3f_t angularAcceleration;
+    float predictedMilliSec;
+    WVR_PoseOriginModel originModel;
+    WVR_Pose_t rawPose;
+} WVR_PoseState_t;
+
+typedef struct WVR_DevicePosePair {
+    WVR_DeviceType type;
+    WVR_PoseState_t pose;
+} WVR_DevicePosePair_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // wvr_types_h_
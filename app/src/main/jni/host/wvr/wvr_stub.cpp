@@ -0,0 +1,834 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+// A small in-process stand-in for libwvr_api.so.  It keeps one HMD and two
+// controllers, serves texture queues backed by real GL textures, counts
+// submits and hands out a procedural controller render model.  Everything
+// is deterministic unless the pose animation is switched on.
+
+#define LOG_TAG "WVRStub"
+#include <wvr/wvr.h>
+#include <wvr/wvr_types.h>
+#include <wvr/wvr_device.h>
+#include <wvr/wvr_events.h>
+#include <wvr/wvr_render.h>
+#include <wvr/wvr_projection.h>
+#include <wvr/wvr_system.h>
+#include <wvr/wvr_ctrller_render_model.h>
+#include <wvr/wvr_stub.h>
+#include <android/bitmap.h>
+#include <log.h>
+
+#include <GLES3/gl3.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+const uint32_t kDeviceCount = WVR_DEVICE_COUNT_LEVEL_1;
+const char * kRenderModelName = "HostStubController";
+
+struct DeviceState {
+    bool mConnected;
+    bool mAnimated;
+    WVR_PoseState_t mPose;
+    bool mButtons[WVR_InputId_Max];
+    bool mTouches[WVR_InputId_Max];
+    WVR_Axis_t mAxes[WVR_InputId_Max];
+    float mBattery;
+};
+
+struct TextureQueue {
+    std::vector<GLuint> mTextures;
+    uint32_t mNext;
+};
+
+struct StubState {
+    std::mutex mMutex;
+    bool mInitialized = false;
+    WVR_MainFunc mMain = NULL;
+    DeviceState mDevices[kDeviceCount];
+    std::deque<WVR_Event_t> mEvents;
+    bool mAnimation = false;
+    bool mInputCaptured = false;
+    float mIpd = 0.064f;
+    float mControllerModelScale = 1.0f;
+    uint32_t mRenderWidth = 512;
+    uint32_t mRenderHeight = 512;
+    uint32_t mQueueLength = 3;
+    WVR_InteractionMode mInteractionMode = WVR_InteractionMode_Controller;
+    WVR_GazeTriggerType mGazeTriggerType = WVR_GazeTriggerType_Timeout;
+    WVR_StubStats_t mStats;
+};
+
+StubState & state() {
+    static StubState sState;
+    return sState;
+}
+
+int64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+int deviceIndex(WVR_DeviceType type) {
+    int index = (int) type - WVR_DeviceType_HMD;
+    if (index < 0 || index >= (int) kDeviceCount)
+        return -1;
+    return index;
+}
+
+bool validInput(WVR_InputId id) {
+    return (int) id >= 0 && id < WVR_InputId_Max;
+}
+
+void setIdentity(WVR_Matrix4f_t & mat) {
+    memset(&mat, 0, sizeof(mat));
+    mat.m[0][0] = mat.m[1][1] = mat.m[2][2] = mat.m[3][3] = 1.0f;
+}
+
+// Rotation about Y by yaw, then X by pitch, translated to (x, y, z).  Row major.
+void makePose(WVR_Matrix4f_t & mat, float yaw, float pitch, float x, float y, float z) {
+    const float cy = cosf(yaw), sy = sinf(yaw);
+    const float cp = cosf(pitch), sp = sinf(pitch);
+    setIdentity(mat);
+    mat.m[0][0] = cy;  mat.m[0][1] = sy * sp;  mat.m[0][2] = sy * cp;
+    mat.m[1][0] = 0;   mat.m[1][1] = cp;       mat.m[1][2] = -sp;
+    mat.m[2][0] = -sy; mat.m[2][1] = cy * sp;  mat.m[2][2] = cy * cp;
+    mat.m[0][3] = x;
+    mat.m[1][3] = y;
+    mat.m[2][3] = z;
+}
+
+void defaultPose(uint32_t index, float t, WVR_Matrix4f_t & mat) {
+    switch (index) {
+    case 0:
+        makePose(mat, 0.5f * sinf(t * 0.5f), 0.1f * sinf(t * 0.3f), 0, 0, 0);
+        break;
+    case 1:
+        makePose(mat, 0.3f * sinf(t * 0.7f), 0.2f * sinf(t * 0.9f), 0.2f, -0.3f, -0.4f);
+        break;
+    default:
+        makePose(mat, -0.3f * sinf(t * 0.6f), 0.2f * sinf(t * 0.8f), -0.2f, -0.3f, -0.4f);
+        break;
+    }
+}
+
+void resetLocked(StubState & s) {
+    for (uint32_t i = 0; i < kDeviceCount; i++) {
+        DeviceState & d = s.mDevices[i];
+        memset(&d, 0, sizeof(d));
+        d.mConnected = true;
+        d.mAnimated = true;
+        d.mBattery = 0.8f;
+        d.mPose.isValidPose = true;
+        d.mPose.is6DoFPose = (i == 0);
+        d.mPose.originModel = WVR_PoseOriginModel_OriginOnHead;
+        defaultPose(i, 0, d.mPose.poseMatrix);
+    }
+    s.mEvents.clear();
+    s.mAnimation = false;
+    s.mInputCaptured = false;
+    s.mIpd = 0.064f;
+    s.mControllerModelScale = 1.0f;
+    s.mInteractionMode = WVR_InteractionMode_Controller;
+    s.mGazeTriggerType = WVR_GazeTriggerType_Timeout;
+    uint32_t liveQueues = s.mStats.liveTextureQueues;
+    uint32_t liveModels = s.mStats.liveControllerModels;
+    memset(&s.mStats, 0, sizeof(s.mStats));
+    s.mStats.liveTextureQueues = liveQueues;
+    s.mStats.liveControllerModels = liveModels;
+    s.mStats.foveationMode = WVR_FoveationMode_Default;
+    s.mStats.adaptiveQualityEnabled = true;
+    s.mStats.adaptiveQualityStrategy = WVR_QualityStrategy_SendQualityEvent;
+}
+
+StubState & lockedState(std::unique_lock<std::mutex> & lock) {
+    static std::once_flag sOnce;
+    StubState & s = state();
+    lock = std::unique_lock<std::mutex>(s.mMutex);
+    std::call_once(sOnce, [&s]() { resetLocked(s); });
+    return s;
+}
+
+}  // namespace
+
+//-----------------------------------------------------------------------------
+// wvr.h
+//-----------------------------------------------------------------------------
+WVR_InitError WVR_Init(WVR_AppType /*eType*/) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mInitialized = true;
+    return WVR_InitError_None;
+}
+
+void WVR_Quit() {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mInitialized = false;
+}
+
+const char * WVR_GetInitErrorString(WVR_InitError error) {
+    switch (error) {
+    case WVR_InitError_None: return "None";
+    case WVR_InitError_NotInitialized: return "NotInitialized";
+    default: return "Unknown";
+    }
+}
+
+uint32_t WVR_GetParameters(WVR_DeviceType /*type*/, const char * pchValue, char * retValue, uint32_t bufferSize) {
+    if (pchValue == NULL || strcmp(pchValue, "GetRenderModelName") != 0)
+        return 0;
+    const uint32_t length = strlen(kRenderModelName) + 1;
+    if (retValue == NULL || bufferSize == 0)
+        return length;
+    const uint32_t n = bufferSize < length ? bufferSize : length;
+    memcpy(retValue, kRenderModelName, n);
+    retValue[n - 1] = 0;
+    return n;
+}
+
+void WVR_RegisterMain(WVR_MainFunc main) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mMain = main;
+}
+
+//-----------------------------------------------------------------------------
+// wvr_device.h
+//-----------------------------------------------------------------------------
+bool WVR_IsDeviceConnected(WVR_DeviceType type) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    int index = deviceIndex(type);
+    return index >= 0 && s.mDevices[index].mConnected;
+}
+
+bool WVR_GetInputButtonState(WVR_DeviceType type, WVR_InputId id) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mStats.inputQueries++;
+    int index = deviceIndex(type);
+    return index >= 0 && validInput(id) && s.mDevices[index].mButtons[id];
+}
+
+bool WVR_GetInputTouchState(WVR_DeviceType type, WVR_InputId id) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mStats.inputQueries++;
+    int index = deviceIndex(type);
+    return index >= 0 && validInput(id) && s.mDevices[index].mTouches[id];
+}
+
+WVR_Axis_t WVR_GetInputAnalogAxis(WVR_DeviceType type, WVR_InputId id) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mStats.inputQueries++;
+    WVR_Axis_t axis = {0, 0};
+    int index = deviceIndex(type);
+    if (index >= 0 && validInput(id))
+        axis = s.mDevices[index].mAxes[id];
+    return axis;
+}
+
+float WVR_GetDeviceBatteryPercentage(WVR_DeviceType type) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    int index = deviceIndex(type);
+    return index >= 0 ? s.mDevices[index].mBattery : 0;
+}
+
+bool WVR_SetInputRequest(WVR_DeviceType type, const WVR_InputAttribute * request, uint32_t size) {
+    return deviceIndex(type) >= 0 && (request != NULL || size == 0);
+}
+
+bool WVR_GetInputMappingPair(WVR_DeviceType type, WVR_InputId destination, WVR_InputMappingPair * pair) {
+    if (pair == NULL || deviceIndex(type) < 0)
+        return false;
+    pair->destination.id = destination;
+    pair->destination.capability = WVR_InputType_Button;
+    pair->destination.axis_type = WVR_AnalogType_None;
+    pair->source = pair->destination;
+    return true;
+}
+
+void WVR_GetPoseState(WVR_DeviceType type, WVR_PoseOriginModel originModel, uint32_t predictedMilliSec, WVR_PoseState_t * poseState) {
+    if (poseState == NULL)
+        return;
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    int index = deviceIndex(type);
+    if (index < 0) {
+        memset(poseState, 0, sizeof(*poseState));
+        return;
+    }
+    DeviceState & d = s.mDevices[index];
+    const int64_t now = nowNs();
+    const int64_t target = now + (int64_t) predictedMilliSec * 1000000LL;
+    if (s.mAnimation && d.mAnimated)
+        defaultPose(index, target / 1e9f, d.mPose.poseMatrix);
+    d.mPose.timestamp = now;
+    d.mPose.predictedMilliSec = predictedMilliSec;
+    d.mPose.originModel = originModel;
+    d.mPose.isValidPose = d.mPose.isValidPose && d.mConnected;
+    *poseState = d.mPose;
+}
+
+void WVR_GetSyncPose(WVR_PoseOriginModel originModel, WVR_DevicePosePair_t * retPose, uint32_t poseCount) {
+    if (retPose == NULL)
+        return;
+    {
+        std::unique_lock<std::mutex> lock;
+        StubState & s = lockedState(lock);
+        s.mStats.syncPoseCount++;
+    }
+    for (uint32_t i = 0; i < poseCount; i++) {
+        WVR_DeviceType type = (WVR_DeviceType) (WVR_DeviceType_HMD + i);
+        retPose[i].type = type;
+        WVR_GetPoseState(type, originModel, 0, &retPose[i].pose);
+    }
+}
+
+void WVR_SetArmModel(WVR_SimulationType /*type*/) {
+}
+
+WVR_DeviceType WVR_GetDefaultControllerRole() {
+    return WVR_DeviceType_Controller_Right;
+}
+
+//-----------------------------------------------------------------------------
+// wvr_events.h
+//-----------------------------------------------------------------------------
+bool WVR_PollEventQueue(WVR_Event_t * event) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    if (event == NULL || s.mEvents.empty())
+        return false;
+    *event = s.mEvents.front();
+    s.mEvents.pop_front();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// wvr_system.h
+//-----------------------------------------------------------------------------
+bool WVR_IsInputFocusCapturedBySystem() {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    return s.mInputCaptured;
+}
+
+WVR_InteractionMode WVR_GetInteractionMode() {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    return s.mInteractionMode;
+}
+
+bool WVR_SetInteractionMode(WVR_InteractionMode mode) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mInteractionMode = mode;
+    return true;
+}
+
+WVR_GazeTriggerType WVR_GetGazeTriggerType() {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    return s.mGazeTriggerType;
+}
+
+bool WVR_SetGazeTriggerType(WVR_GazeTriggerType type) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mGazeTriggerType = type;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// wvr_projection.h
+//-----------------------------------------------------------------------------
+void WVR_GetClippingPlaneBoundary(WVR_Eye eye, float * left, float * right, float * top, float * bottom) {
+    // Tangents of the half angles.  Each eye sees a little more to its outer side.
+    if (left) *left = eye == WVR_Eye_Left ? -1.1f : -0.9f;
+    if (right) *right = eye == WVR_Eye_Left ? 0.9f : 1.1f;
+    if (top) *top = 1.0f;
+    if (bottom) *bottom = -1.0f;
+}
+
+WVR_Matrix4f_t WVR_GetProjection(WVR_Eye eye, float near, float far) {
+    float l, r, t, b;
+    WVR_GetClippingPlaneBoundary(eye, &l, &r, &t, &b);
+    WVR_Matrix4f_t mat;
+    memset(&mat, 0, sizeof(mat));
+    mat.m[0][0] = 2.0f / (r - l);
+    mat.m[0][2] = (r + l) / (r - l);
+    mat.m[1][1] = 2.0f / (t - b);
+    mat.m[1][2] = (t + b) / (t - b);
+    mat.m[2][2] = -(far + near) / (far - near);
+    mat.m[2][3] = -(2.0f * far * near) / (far - near);
+    mat.m[3][2] = -1.0f;
+    return mat;
+}
+
+WVR_Matrix4f_t WVR_GetTransformFromEyeToHead(WVR_Eye eye, WVR_NumDoF /*dof*/) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    WVR_Matrix4f_t mat;
+    setIdentity(mat);
+    mat.m[0][3] = (eye == WVR_Eye_Left ? -0.5f : 0.5f) * s.mIpd;
+    return mat;
+}
+
+//-----------------------------------------------------------------------------
+// wvr_render.h
+//-----------------------------------------------------------------------------
+WVR_RenderError WVR_RenderInit(const WVR_RenderInitParams_t * param) {
+    if (param == NULL)
+        return WVR_RenderError_NullPtr;
+    if (param->graphicsApi != WVR_GraphicsApiType_OpenGL)
+        return WVR_RenderError_LibNotSupported;
+    return WVR_RenderError_None;
+}
+
+void WVR_GetRenderTargetSize(uint32_t * width, uint32_t * height) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    if (width) *width = s.mRenderWidth;
+    if (height) *height = s.mRenderHeight;
+}
+
+bool WVR_GetRenderProps(WVR_RenderProps_t * props) {
+    if (props == NULL)
+        return false;
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    props->refreshRate = 75.0f;
+    props->hasExternal = false;
+    props->ipdMeter = s.mIpd;
+    return true;
+}
+
+WVR_TextureQueueHandle_t WVR_ObtainTextureQueue(WVR_TextureTarget target, WVR_TextureFormat /*format*/, WVR_TextureType /*type*/, uint32_t width, uint32_t height, int32_t /*level*/) {
+    if (target != WVR_TextureTarget_2D || width == 0 || height == 0)
+        return NULL;
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+
+    TextureQueue * queue = new TextureQueue();
+    queue->mNext = 0;
+    queue->mTextures.resize(s.mQueueLength);
+    glGenTextures(s.mQueueLength, queue->mTextures.data());
+    for (uint32_t i = 0; i < s.mQueueLength; i++) {
+        glBindTexture(GL_TEXTURE_2D, queue->mTextures[i]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    s.mStats.liveTextureQueues++;
+    return queue;
+}
+
+uint32_t WVR_GetTextureQueueLength(WVR_TextureQueueHandle_t handle) {
+    TextureQueue * queue = (TextureQueue *) handle;
+    return queue != NULL ? queue->mTextures.size() : 0;
+}
+
+WVR_TextureParams_t WVR_GetTexture(WVR_TextureQueueHandle_t handle, int32_t index) {
+    TextureQueue * queue = (TextureQueue *) handle;
+    WVR_TextureParams_t params;
+    memset(&params, 0, sizeof(params));
+    params.target = WVR_TextureTarget_2D;
+    params.layout.rightUpUVs.v[0] = params.layout.rightUpUVs.v[1] = 1.0f;
+    if (queue != NULL && index >= 0 && index < (int32_t) queue->mTextures.size())
+        params.id = (WVR_Texture_t) (uintptr_t) queue->mTextures[index];
+    return params;
+}
+
+int32_t WVR_GetAvailableTextureIndex(WVR_TextureQueueHandle_t handle) {
+    TextureQueue * queue = (TextureQueue *) handle;
+    if (queue == NULL || queue->mTextures.empty())
+        return -1;
+    int32_t index = queue->mNext;
+    queue->mNext = (queue->mNext + 1) % queue->mTextures.size();
+    return index;
+}
+
+void WVR_ReleaseTextureQueue(WVR_TextureQueueHandle_t handle) {
+    TextureQueue * queue = (TextureQueue *) handle;
+    if (queue == NULL)
+        return;
+    glDeleteTextures(queue->mTextures.size(), queue->mTextures.data());
+    delete queue;
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mStats.liveTextureQueues--;
+}
+
+void WVR_RenderMask(WVR_Eye /*eye*/) {
+}
+
+WVR_Result WVR_RenderFoveationMode(WVR_FoveationMode mode) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mStats.foveationMode = mode;
+    return WVR_Success;
+}
+
+bool WVR_IsRenderFoveationEnabled() {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    return s.mStats.foveationMode == WVR_FoveationMode_Enable;
+}
+
+WVR_SubmitError WVR_SubmitFrame(WVR_Eye eye, const WVR_TextureParams_t * param, const WVR_PoseState_t * pose, WVR_SubmitExtend extendMethod) {
+    if (param == NULL || param->id == NULL)
+        return WVR_SubmitError_InvalidTexture;
+    if (eye != WVR_Eye_Left && eye != WVR_Eye_Right)
+        return WVR_SubmitError_BufferSubmitFailed;
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mStats.submitCount[eye]++;
+    s.mStats.lastSubmitTexture[eye] = (uint32_t) (uintptr_t) param->id;
+    s.mStats.lastSubmitExtend[eye] = extendMethod;
+    s.mStats.lastSubmitLayout[eye] = param->layout;
+    s.mStats.lastSubmitPoseTimestamp[eye] = pose != NULL ? pose->timestamp : 0;
+    return WVR_SubmitError_None;
+}
+
+void WVR_PreRenderEye(WVR_Eye eye, const WVR_TextureParams_t * /*textureParam*/, const WVR_RenderFoveationParams_t * foveatedParam) {
+    if (eye != WVR_Eye_Left && eye != WVR_Eye_Right)
+        return;
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mStats.preRenderCount[eye]++;
+    s.mStats.lastPreRenderFoveated[eye] = foveatedParam != NULL;
+    if (foveatedParam != NULL)
+        s.mStats.lastFoveation[eye] = *foveatedParam;
+}
+
+bool WVR_EnableAdaptiveQuality(bool enable, uint32_t strategyFlags) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mStats.adaptiveQualityEnabled = enable;
+    s.mStats.adaptiveQualityStrategy = enable ? strategyFlags : 0;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// wvr_ctrller_render_model.h
+//-----------------------------------------------------------------------------
+namespace {
+
+struct Box {
+    const char * mName;
+    float mHalf[3];
+    float mCenter[3];
+    int32_t mTexIndex;
+};
+
+// A controller-sized body with the parts hellovr looks for.
+const Box kBoxes[] = {
+    { "__CM__Body",           { 0.020f, 0.012f, 0.060f  }, { 0, 0, 0 },          0 },
+    { "__CM__TouchPad",       { 0.015f, 0.002f, 0.015f  }, { 0, 0.013f, -0.030f }, 0 },
+    { "__CM__TouchPad_Touch", { 0.003f, 0.001f, 0.003f  }, { 0, 0.016f, -0.030f }, 0 },
+    { "__CM__AppButton",      { 0.005f, 0.002f, 0.005f  }, { 0, 0.013f, 0.000f  }, 0 },
+    { "__CM__HomeButton",     { 0.005f, 0.002f, 0.005f  }, { 0, 0.013f, 0.015f  }, 0 },
+    { "__CM__TriggerKey",     { 0.006f, 0.008f, 0.006f  }, { 0, -0.015f, -0.040f }, 0 },
+    { "__CM__Battery",        { 0.006f, 0.001f, 0.003f  }, { 0, 0.013f, 0.035f  }, 0 },
+    { "__CM__Emitter",        { 0.001f, 0.001f, 0.001f  }, { 0, 0.000f, -0.062f }, 0 },
+};
+const uint32_t kBoxCount = sizeof(kBoxes) / sizeof(kBoxes[0]);
+
+void fillBox(const Box & box, float scale, WVR_CtrlerCompInfo_t & comp) {
+    static const float corners[8][3] = {
+        {-1,-1,-1}, { 1,-1,-1}, { 1, 1,-1}, {-1, 1,-1},
+        {-1,-1, 1}, { 1,-1, 1}, { 1, 1, 1}, {-1, 1, 1},
+    };
+    static const uint32_t faces[36] = {
+        0,2,1, 0,3,2,  4,5,6, 4,6,7,  0,1,5, 0,5,4,
+        3,6,2, 3,7,6,  1,2,6, 1,6,5,  0,4,7, 0,7,3,
+    };
+    memset(&comp, 0, sizeof(comp));
+    strncpy(comp.name, box.mName, sizeof(comp.name) - 1);
+
+    comp.vertices.buffer = new float[8 * 3];
+    comp.vertices.size = 8 * 3;
+    comp.vertices.dimension = 3;
+    comp.normals.buffer = new float[8 * 3];
+    comp.normals.size = 8 * 3;
+    comp.normals.dimension = 3;
+    comp.texCoords.buffer = new float[8 * 2];
+    comp.texCoords.size = 8 * 2;
+    comp.texCoords.dimension = 2;
+    for (uint32_t i = 0; i < 8; i++) {
+        for (uint32_t k = 0; k < 3; k++) {
+            comp.vertices.buffer[i * 3 + k] = corners[i][k] * box.mHalf[k] * scale;
+            comp.normals.buffer[i * 3 + k] = corners[i][k] * 0.57735f;
+        }
+        comp.texCoords.buffer[i * 2 + 0] = corners[i][0] > 0 ? 1.0f : 0.0f;
+        comp.texCoords.buffer[i * 2 + 1] = corners[i][1] > 0 ? 1.0f : 0.0f;
+    }
+    comp.indices.buffer = new uint32_t[36];
+    memcpy(comp.indices.buffer, faces, sizeof(faces));
+    comp.indices.size = 36;
+    comp.indices.type = 3;
+
+    comp.texIndex = box.mTexIndex;
+    comp.defaultDraw = true;
+    comp.localMat[0] = comp.localMat[5] = comp.localMat[10] = comp.localMat[15] = 1.0f;
+    comp.localMat[12] = box.mCenter[0];
+    comp.localMat[13] = box.mCenter[1];
+    comp.localMat[14] = box.mCenter[2];
+}
+
+void fillBitmap(WVR_CtrlerTexBitmap_t & bmp, uint32_t size, uint8_t r, uint8_t g, uint8_t b) {
+    bmp.width = bmp.height = size;
+    bmp.stride = size * 4;
+    bmp.format = ANDROID_BITMAP_FORMAT_RGBA_8888;
+    bmp.bitmap = new uint8_t[bmp.stride * size];
+    for (uint32_t y = 0; y < size; y++) {
+        for (uint32_t x = 0; x < size; x++) {
+            uint8_t * p = bmp.bitmap + y * bmp.stride + x * 4;
+            const bool odd = ((x / 4) + (y / 4)) & 1;
+            p[0] = odd ? r : r / 2;
+            p[1] = odd ? g : g / 2;
+            p[2] = odd ? b : b / 2;
+            p[3] = 0xFF;
+        }
+    }
+}
+
+}  // namespace
+
+WVR_Result WVR_GetCurrentControllerModel(WVR_DeviceType ctrlerType, WVR_CtrlerModel_t ** ctrlerModel, bool /*isOneBone*/) {
+    if (ctrlerModel == NULL)
+        return WVR_Error_InvalidArgument;
+    if (ctrlerType != WVR_DeviceType_Controller_Right && ctrlerType != WVR_DeviceType_Controller_Left)
+        return WVR_Error_InvalidArgument;
+    if (!WVR_IsDeviceConnected(ctrlerType))
+        return WVR_Error_CtrlerModel_DeviceDisconnected;
+
+    WVR_CtrlerModel_t * model = new WVR_CtrlerModel_t();
+    memset(model, 0, sizeof(*model));
+    strncpy(model->name, kRenderModelName, sizeof(model->name) - 1);
+
+    float scale;
+    {
+        std::unique_lock<std::mutex> lock;
+        scale = lockedState(lock).mControllerModelScale;
+    }
+    model->compInfos.size = kBoxCount;
+    model->compInfos.table = new WVR_CtrlerCompInfo_t[kBoxCount];
+    for (uint32_t i = 0; i < kBoxCount; i++)
+        fillBox(kBoxes[i], scale, model->compInfos.table[i]);
+
+    model->bitmapInfos.size = 1;
+    model->bitmapInfos.table = new WVR_CtrlerTexBitmap_t[1];
+    fillBitmap(model->bitmapInfos.table[0], 32, 0xC0, 0xC0, 0xC8);
+
+    static const int32_t minLv[] = { 0, 21, 61 };
+    static const int32_t maxLv[] = { 20, 60, 100 };
+    model->batteryLevels.size = 3;
+    model->batteryLevels.minLvTable = new int32_t[3];
+    model->batteryLevels.maxLvTable = new int32_t[3];
+    model->batteryLevels.texTable = new WVR_CtrlerTexBitmap_t[3];
+    for (uint32_t lv = 0; lv < 3; lv++) {
+        model->batteryLevels.minLvTable[lv] = minLv[lv];
+        model->batteryLevels.maxLvTable[lv] = maxLv[lv];
+        fillBitmap(model->batteryLevels.texTable[lv], 8, lv == 0 ? 0xFF : 0x20, lv == 0 ? 0x20 : 0xFF, 0x20);
+    }
+
+    WVR_TouchPadPlane_t & plane = model->touchpadPlane;
+    plane.u.v[0] = 1;
+    plane.v.v[1] = 1;
+    plane.w.v[2] = 1;
+    plane.center.v[1] = 0.013f;
+    plane.center.v[2] = -0.030f;
+    plane.floatingDistance = 0.002f;
+    plane.radius = 0.015f;
+    plane.valid = true;
+
+    *ctrlerModel = model;
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mStats.liveControllerModels++;
+    s.mStats.controllerModelLoads++;
+    return WVR_Success;
+}
+
+void WVR_ReleaseControllerModel(WVR_CtrlerModel_t ** ctrlerModel) {
+    if (ctrlerModel == NULL || *ctrlerModel == NULL)
+        return;
+    WVR_CtrlerModel_t * model = *ctrlerModel;
+    for (uint32_t i = 0; i < model->compInfos.size; i++) {
+        WVR_CtrlerCompInfo_t & comp = model->compInfos.table[i];
+        delete [] comp.vertices.buffer;
+        delete [] comp.normals.buffer;
+        delete [] comp.texCoords.buffer;
+        delete [] comp.indices.buffer;
+    }
+    delete [] model->compInfos.table;
+    for (uint32_t i = 0; i < model->bitmapInfos.size; i++)
+        delete [] model->bitmapInfos.table[i].bitmap;
+    delete [] model->bitmapInfos.table;
+    for (uint32_t i = 0; i < model->batteryLevels.size; i++)
+        delete [] model->batteryLevels.texTable[i].bitmap;
+    delete [] model->batteryLevels.texTable;
+    delete [] model->batteryLevels.minLvTable;
+    delete [] model->batteryLevels.maxLvTable;
+    delete model;
+    *ctrlerModel = nullptr;
+
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mStats.liveControllerModels--;
+}
+
+WVR_Result WVR_GetCurrentControllerEmitter(WVR_DeviceType ctrlerType, float emitterPose[16]) {
+    if (emitterPose == NULL)
+        return WVR_Error_InvalidArgument;
+    if (!WVR_IsDeviceConnected(ctrlerType))
+        return WVR_Error_CtrlerModel_DeviceDisconnected;
+    memset(emitterPose, 0, sizeof(float) * 16);
+    emitterPose[0] = emitterPose[5] = emitterPose[10] = emitterPose[15] = 1.0f;
+    emitterPose[14] = -0.062f;
+    return WVR_Success;
+}
+
+//-----------------------------------------------------------------------------
+// wvr_stub.h
+//-----------------------------------------------------------------------------
+void WVR_Stub_Reset() {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    resetLocked(s);
+}
+
+void WVR_Stub_SetRenderTargetSize(uint32_t width, uint32_t height) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mRenderWidth = width;
+    s.mRenderHeight = height;
+}
+
+void WVR_Stub_SetTextureQueueLength(uint32_t length) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mQueueLength = length > 0 ? length : 1;
+}
+
+void WVR_Stub_SetDeviceConnected(WVR_DeviceType type, bool connected) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    int index = deviceIndex(type);
+    if (index >= 0)
+        s.mDevices[index].mConnected = connected;
+}
+
+void WVR_Stub_SetDevicePose(WVR_DeviceType type, const WVR_Matrix4f_t * pose, bool isValid, bool is6DoF) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    int index = deviceIndex(type);
+    if (index < 0 || pose == NULL)
+        return;
+    DeviceState & d = s.mDevices[index];
+    d.mAnimated = false;
+    d.mPose.poseMatrix = *pose;
+    d.mPose.isValidPose = isValid;
+    d.mPose.is6DoFPose = is6DoF;
+}
+
+void WVR_Stub_SetPoseAnimation(bool enable) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mAnimation = enable;
+}
+
+void WVR_Stub_SetButtonState(WVR_DeviceType type, WVR_InputId id, bool pressed) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    int index = deviceIndex(type);
+    if (index >= 0 && validInput(id))
+        s.mDevices[index].mButtons[id] = pressed;
+}
+
+void WVR_Stub_SetTouchState(WVR_DeviceType type, WVR_InputId id, bool touched) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    int index = deviceIndex(type);
+    if (index >= 0 && validInput(id))
+        s.mDevices[index].mTouches[id] = touched;
+}
+
+void WVR_Stub_SetAnalogAxis(WVR_DeviceType type, WVR_InputId id, WVR_Axis_t axis) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    int index = deviceIndex(type);
+    if (index >= 0 && validInput(id))
+        s.mDevices[index].mAxes[id] = axis;
+}
+
+void WVR_Stub_SetBatteryPercentage(WVR_DeviceType type, float percentage) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    int index = deviceIndex(type);
+    if (index >= 0)
+        s.mDevices[index].mBattery = percentage;
+}
+
+void WVR_Stub_SetInputFocusCapturedBySystem(bool captured) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mInputCaptured = captured;
+}
+
+void WVR_Stub_SetIpd(float meter) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mIpd = meter;
+}
+
+void WVR_Stub_SetControllerModelScale(float scale) {
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    s.mControllerModelScale = scale;
+}
+
+void WVR_Stub_PushEvent(const WVR_Event_t * event) {
+    if (event == NULL)
+        return;
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    WVR_Event_t e = *event;
+    if (e.common.timestamp == 0)
+        e.common.timestamp = nowNs();
+    s.mEvents.push_back(e);
+}
+
+void WVR_Stub_GetStats(WVR_StubStats_t * stats) {
+    if (stats == NULL)
+        return;
+    std::unique_lock<std::mutex> lock;
+    StubState & s = lockedState(lock);
+    *stats = s.mStats;
+}
+
+int64_t WVR_Stub_GetTimeNs() {
+    return nowNs();
+}
@@ -13,6 +13,7 @@
 #include <log.h>
 #include <Context.h>
 #include <hellovr.h>
+#include <ControllerModel.h>
 #include <unistd.h>
 #include <wvr/wvr.h>
 
@@ -22,6 +23,11 @@ extern bool gDebugOld;
 extern bool gMsaa;
 extern bool gScene;
 extern bool gSceneOld;
+extern Foveation::Mode gFoveationMode;
+extern bool gFoveationForced;
+extern bool gProceduralFloor;
+extern std::string gEnvironment;
+extern std::string gInputTrace;
 
 int main(int argc, char *argv[]) {
     LOGENTRY();
@@ -52,8 +58,6 @@ int main(int argc, char *argv[]) {
             LOGE("Unknown render error. Quit.");
             break;
         }
-
-        app->updateHMDMatrixPose();
     }
 
     app->shutdownGL();
@@ -66,6 +70,9 @@ int main(int argc, char *argv[]) {
 extern "C" {
     JNIEXPORT void JNICALL Java_com_htc_vr_samples_wvr_1hellovr_MainActivity_init(JNIEnv * env, jobject act, jobject am);
     JNIEXPORT void JNICALL Java_com_htc_vr_samples_wvr_1hellovr_MainActivity_setFlag(JNIEnv * env, jclass clazz, jint flag);
+    JNIEXPORT void JNICALL Java_com_htc_vr_samples_wvr_1hellovr_MainActivity_setCacheDir(JNIEnv * env, jclass clazz, jstring dir);
+    JNIEXPORT void JNICALL Java_com_htc_vr_samples_wvr_1hellovr_MainActivity_setEnvironment(JNIEnv * env, jclass clazz, jstring path);
+    JNIEXPORT void JNICALL Java_com_htc_vr_samples_wvr_1hellovr_MainActivity_setInputTrace(JNIEnv * env, jclass clazz, jstring path);
 };
 
 JNIEXPORT void JNICALL Java_com_htc_vr_samples_wvr_1hellovr_MainActivity_init(JNIEnv * env, jobject activityInstance, jobject assetManagerInstance) {
@@ -83,6 +90,38 @@ JNIEXPORT void JNICALL Java_com_htc_vr_samples_wvr_1hellovr_MainActivity_setFlag
     LOGD("gMsaa = %d", gMsaa ? 1 : 0);
     gScene = (flag & 0x4) != 0;
     LOGD("gScene = %d", gScene ? 1 : 0);
+    gFoveationMode = (Foveation::Mode) ((flag >> 3) & 0x3);
+    gFoveationForced = (flag & 0x20) != 0;
+    LOGD("gFoveationMode = %s%s", Foveation::getModeName(gFoveationMode), gFoveationForced ? ", forced" : "");
+    gProceduralFloor = (flag & 0x40) != 0;
+    LOGD("gProceduralFloor = %d", gProceduralFloor ? 1 : 0);
+}
+
+JNIEXPORT void JNICALL Java_com_htc_vr_samples_wvr_1hellovr_MainActivity_setCacheDir(JNIEnv * env, jclass clazz, jstring dir) {
+    const char * path = env->GetStringUTFChars(dir, NULL);
+    if (path == NULL)
+        return;
+    LOGD("cache dir = %s", path);
+    ControllerModel::setCacheDirectory(path);
+    env->ReleaseStringUTFChars(dir, path);
+}
+
+JNIEXPORT void JNICALL Java_com_htc_vr_samples_wvr_1hellovr_MainActivity_setEnvironment(JNIEnv * env, jclass clazz, jstring path) {
+    const char * str = env->GetStringUTFChars(path, NULL);
+    if (str == NULL)
+        return;
+    LOGD("environment = %s", str);
+    gEnvironment = str;
+    env->ReleaseStringUTFChars(path, str);
+}
+
+JNIEXPORT void JNICALL Java_com_htc_vr_samples_wvr_1hellovr_MainActivity_setInputTrace(JNIEnv * env, jclass clazz, jstring path) {
+    const char * str = env->GetStringUTFChars(path, NULL);
+    if (str == NULL)
+        return;
+    LOGD("input trace = %s", str);
+    gInputTrace = str;
+    env->ReleaseStringUTFChars(path, str);
 }
 
 jint JNI_OnLoad(JavaVM* vm, void* reserved) {
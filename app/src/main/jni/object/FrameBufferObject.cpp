@@ -8,6 +8,7 @@
 // conditions signed by you and all SDK and API requirements,
 // specifications, and documentation provided by HTC to You."
 
+#define LOG_TAG "FrameBufferObject"
 #include <FrameBufferObject.h>
 #include <Object.h>
 
@@ -25,30 +26,34 @@
 #endif
 
 FrameBufferObject::FrameBufferObject(int textureId, int width, int height, bool msaa) :
-        mMSAA(msaa),
+        FrameBufferObject(textureId, width, height, msaa ? 4 : 1, 0) {
+}
+
+FrameBufferObject::FrameBufferObject(int textureId, int width, int height, int samples, GLuint depthBufferId) :
         mWidth(width),
         mHeight(height),
         mFrameBufferId(0),
-        mDepthBufferId(0),
-        mTextureId(textureId){
-        if (msaa) {
-            int samples;
-            glGetIntegerv(GL_MAX_SAMPLES_EXT, &samples);
-            if (samples < 4 || !Object::hasGlExtension("GL_EXT_multisampled_render_to_texture"))
-                msaa = false;
-        }
-
-
-        if (msaa) {
-            initMSAA();
-        } else {
-            msaa = false;
-            init();
-        }
+        mDepthBufferId(depthBufferId),
+        mTextureId(textureId) {
+    if (samples > 1) {
+        int maxSamples = getMaxSamples();
+        if (samples > maxSamples)
+            samples = maxSamples;
+    }
+    mSamples = samples > 1 ? samples : 1;
+    mMSAA = mSamples > 1;
+    mOwnsDepth = depthBufferId == 0;
+
+    if (mMSAA) {
+        initMSAA();
+    } else {
+        init();
+    }
 
     // check FBO status
     int status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
     if (status != GL_FRAMEBUFFER_COMPLETE) {
+        LOGE("Framebuffer incomplete 0x%x, %d samples", status, mSamples);
         mHasError = true;
         clear();
     }
@@ -60,39 +65,56 @@ FrameBufferObject::~FrameBufferObject() {
     clear();
 }
 
+int FrameBufferObject::getMaxSamples() {
+    if (!Object::hasGlExtension("GL_EXT_multisampled_render_to_texture"))
+        return 1;
+    int samples = 1;
+    glGetIntegerv(GL_MAX_SAMPLES_EXT, &samples);
+    return samples > 1 ? samples : 1;
+}
+
+GLuint FrameBufferObject::createDepthBuffer(int width, int height, int samples) {
+    GLuint id = 0;
+    glGenRenderbuffers(1, &id);
+    glBindRenderbuffer(GL_RENDERBUFFER, id);
+    if (samples > 1) {
+        PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC glRenderbufferStorageMultisampleEXT =
+            (PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC)eglGetProcAddress( "glRenderbufferStorageMultisampleEXT" );
+        glRenderbufferStorageMultisampleEXT(GL_RENDERBUFFER, samples, GL_DEPTH_COMPONENT24, width, height);
+    } else {
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    }
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    return id;
+}
+
 void FrameBufferObject::initMSAA() {
     // Reference to https://www.khronos.org/registry/gles/extensions/EXT/EXT_multisampled_render_to_texture.txt
-    PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC glRenderbufferStorageMultisampleEXT =
-        (PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC)eglGetProcAddress( "glRenderbufferStorageMultisampleEXT" );
-
     PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC glFramebufferTexture2DMultisampleEXT =
         (PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC)eglGetProcAddress( "glFramebufferTexture2DMultisampleEXT" );
 
-    glGenRenderbuffers(1, &mDepthBufferId);
-    glBindRenderbuffer(GL_RENDERBUFFER, mDepthBufferId);
-    glRenderbufferStorageMultisampleEXT(GL_RENDERBUFFER, 2, GL_DEPTH_COMPONENT24, mWidth, mHeight);
-    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    if (mOwnsDepth)
+        mDepthBufferId = createDepthBuffer(mWidth, mHeight, mSamples);
 
     glGenFramebuffers(1, &mFrameBufferId);
     glBindFramebuffer(GL_FRAMEBUFFER, mFrameBufferId);
     glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, mDepthBufferId);
-    glFramebufferTexture2DMultisampleEXT(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mTextureId, 0, 2);
+    glFramebufferTexture2DMultisampleEXT(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mTextureId, 0, mSamples);
 }
 
 void FrameBufferObject::init() {
+    if (mOwnsDepth)
+        mDepthBufferId = createDepthBuffer(mWidth, mHeight, 1);
+
     glGenFramebuffers(1, &mFrameBufferId);
     glBindFramebuffer(GL_FRAMEBUFFER, mFrameBufferId);
-
-    glGenRenderbuffers(1, &mDepthBufferId);
-    glBindRenderbuffer(GL_RENDERBUFFER, mDepthBufferId);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, mWidth, mHeight);
     glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, mDepthBufferId);
 
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mTextureId, 0);
 }
 
 void FrameBufferObject::clear() {
-    if (mDepthBufferId != 0) {
+    if (mDepthBufferId != 0 && mOwnsDepth) {
         glDeleteRenderbuffers(1, &mDepthBufferId);
     }
     if (mFrameBufferId != 0)
@@ -111,7 +133,7 @@ void FrameBufferObject::unbindFrameBuffer() {
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-void FrameBufferObject::glViewportScale(std::vector<float> lowerLeft, std::vector<float> topRight) {
+void FrameBufferObject::glViewportScale(const std::vector<float>& lowerLeft, const std::vector<float>& topRight) {
     float widthFactor = topRight[0] - lowerLeft[0];
     float heightFactor = topRight[1] - lowerLeft[1];
     mViewportX = (int) (lowerLeft[0] * mWidth);
@@ -124,6 +146,10 @@ void FrameBufferObject::glViewportScale(std::vector<float> lowerLeft, std::vecto
 }
 
 void FrameBufferObject::resizeFrameBuffer(float scale) {
+    if (!mOwnsDepth) {
+        LOGW("resizeFrameBuffer: the depth buffer is shared");
+        return;
+    }
     mScaledWidth = (unsigned int) (mWidth * scale);
     mScaledHeight = (unsigned int) (mHeight * scale);
 
@@ -131,7 +157,7 @@ void FrameBufferObject::resizeFrameBuffer(float scale) {
         PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC glRenderbufferStorageMultisampleEXT =
                 (PFNGLRENDERBUFFERSTORAGEMULTISAMPLEEXTPROC)eglGetProcAddress( "glRenderbufferStorageMultisampleEXT" );
         glBindRenderbuffer(GL_RENDERBUFFER, mDepthBufferId);
-        glRenderbufferStorageMultisampleEXT(GL_RENDERBUFFER, 2, GL_DEPTH_COMPONENT24, mScaledWidth, mScaledHeight);
+        glRenderbufferStorageMultisampleEXT(GL_RENDERBUFFER, mSamples, GL_DEPTH_COMPONENT24, mScaledWidth, mScaledHeight);
         glBindRenderbuffer(GL_RENDERBUFFER, 0);
 
     } else {
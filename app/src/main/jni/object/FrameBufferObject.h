@@ -8,6 +8,9 @@
 // conditions signed by you and all SDK and API requirements,
 // specifications, and documentation provided by HTC to You."
 
+#pragma once
+
+#include <stddef.h>
 #include <GLES2/gl2.h>
 #include <GLES2/gl2ext.h>
 #include <GLES3/gl31.h>
@@ -17,6 +20,8 @@
 class FrameBufferObject {
 private:
     bool mMSAA = false;
+    int mSamples = 1;
+    bool mOwnsDepth = true;
     int mWidth = 0;
     int mHeight = 0;
     float mScale = 1.0;
@@ -35,6 +40,10 @@ private:
 
 public:
     FrameBufferObject(int textureId, int width, int height, bool msaa = false);
+    // samples > 1 renders through GL_EXT_multisampled_render_to_texture.  A
+    // non zero depthBufferId is attached instead of a new depth buffer and
+    // is left to the caller to delete.
+    FrameBufferObject(int textureId, int width, int height, int samples, GLuint depthBufferId);
 
 public:
     static inline FrameBufferObject * getFBOInstance(int width, int height) {
@@ -46,6 +55,13 @@ public:
     }
 
     ~FrameBufferObject();
+
+    // Largest sample count usable for rendering to a texture, 1 without
+    // GL_EXT_multisampled_render_to_texture.
+    static int getMaxSamples();
+    // A depth buffer matching a FrameBufferObject of the same size and samples.
+    static GLuint createDepthBuffer(int width, int height, int samples);
+
     void initMSAA();
     void init();
 
@@ -72,9 +88,13 @@ public:
         return mHasError;
     }
 
+    inline int getSamples() const {
+        return mSamples;
+    }
+
     void clear();
 
-    void glViewportScale(std::vector<float> lowerLeft, std::vector<float> topRight);
+    void glViewportScale(const std::vector<float>& lowerLeft, const std::vector<float>& topRight);
 
     void resizeFrameBuffer(float scale);
 
@@ -0,0 +1,72 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#define LOG_TAG "GpuTimer"
+#include <log.h>
+#include <Object.h>
+#include <GpuTimer.h>
+
+const uint32_t GpuTimer::kQueryCount;
+
+GpuTimer::GpuTimer() : mFirst(0), mPending(0), mActive(false), mSupported(false) {
+    for (uint32_t i = 0; i < kQueryCount; i++)
+        mQueries[i] = 0;
+    if (!Object::hasGlExtension("GL_EXT_disjoint_timer_query")) {
+        LOGW("GL_EXT_disjoint_timer_query is not supported");
+        return;
+    }
+    glGenQueries(kQueryCount, mQueries);
+    mSupported = true;
+}
+
+GpuTimer::~GpuTimer() {
+    if (mSupported)
+        glDeleteQueries(kQueryCount, mQueries);
+}
+
+void GpuTimer::begin() {
+    if (!mSupported || mActive || mPending == kQueryCount)
+        return;
+    glBeginQuery(GL_TIME_ELAPSED_EXT, mQueries[(mFirst + mPending) % kQueryCount]);
+    mActive = true;
+}
+
+void GpuTimer::end() {
+    if (!mActive)
+        return;
+    glEndQuery(GL_TIME_ELAPSED_EXT);
+    mActive = false;
+    mPending++;
+}
+
+bool GpuTimer::poll(float& seconds) {
+    if (mPending == 0)
+        return false;
+
+    GLuint available = 0;
+    glGetQueryObjectuiv(mQueries[mFirst], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+        return false;
+
+    // Reading GL_GPU_DISJOINT_EXT also clears it.
+    GLint disjoint = 0;
+    glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+
+    // Nanoseconds; 32 bits hold over four seconds.
+    GLuint elapsed = 0;
+    glGetQueryObjectuiv(mQueries[mFirst], GL_QUERY_RESULT, &elapsed);
+    mFirst = (mFirst + 1) % kQueryCount;
+    mPending--;
+    if (disjoint)
+        return false;
+    seconds = elapsed * 1e-9f;
+    return true;
+}
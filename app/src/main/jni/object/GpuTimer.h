@@ -0,0 +1,51 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#pragma once
+
+#include <stdint.h>
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#include <GLES3/gl31.h>
+
+// GPU time of a span of GL commands, from GL_EXT_disjoint_timer_query.
+//
+// Results arrive a few frames after end().  A small ring of queries lets
+// begin() start a new span while older ones are in flight, and poll() never
+// waits for the GPU.  Without the extension every call does nothing.
+class GpuTimer {
+public:
+    static const uint32_t kQueryCount = 4;
+
+public:
+    GpuTimer();
+    ~GpuTimer();
+
+    inline bool isSupported() const {
+        return mSupported;
+    }
+
+    // Spans must not nest.  A begin() with every query in flight is skipped
+    // along with its end().
+    void begin();
+    void end();
+
+    // Oldest finished span in seconds.  False while none is ready.  Spans
+    // that saw a disjoint event, like a clock change, are dropped.
+    bool poll(float& seconds);
+
+private:
+    GLuint mQueries[kQueryCount];
+    uint32_t mFirst;            // oldest query in flight
+    uint32_t mPending;
+    bool mActive;
+    bool mSupported;
+};
@@ -0,0 +1,189 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#define LOG_TAG "IndexedMesh"
+#include <log.h>
+#include <RenderStats.h>
+#include <IndexedMesh.h>
+
+std::vector<std::pair<IndexedMesh::Key, std::weak_ptr<IndexedMesh> > > IndexedMesh::mMeshPool;
+
+IndexedMesh::IndexedMesh(const MeshData& data) : IndexedMesh(&data, 1) {
+}
+
+IndexedMesh::IndexedMesh(const MeshData * levels, uint32_t levelCount) :
+        mVertexBuffer(0), mIndexBuffer(0), mIndexType(GL_UNSIGNED_INT),
+        mVertexCount(0), mBounds(levels[0].getBounds()) {
+    // Levels are appended, their indices rebased onto the shared vertices.
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    for (uint32_t l = 0; l < levelCount; l++) {
+        const MeshData& level = levels[l];
+        mLodFirsts.push_back((uint32_t) indices.size());
+        mLodCounts.push_back((uint32_t) level.indices.size());
+        for (size_t i = 0; i < level.indices.size(); i++)
+            indices.push_back(level.indices[i] + mVertexCount);
+        vertices.insert(vertices.end(), level.vertices.begin(), level.vertices.end());
+        mVertexCount += level.getVertexCount();
+    }
+
+    glGenBuffers(1, &mVertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Short indices when they fit, half the index fetch bandwidth.
+    glGenBuffers(1, &mIndexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+    if (mVertexCount <= 0xFFFF) {
+        std::vector<uint16_t> shorts(indices.begin(), indices.end());
+        mIndexType = GL_UNSIGNED_SHORT;
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, shorts.size() * sizeof(uint16_t), shorts.data(), GL_STATIC_DRAW);
+    } else {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+IndexedMesh::~IndexedMesh() {
+    if (mVertexBuffer != 0)
+        glDeleteBuffers(1, &mVertexBuffer);
+    if (mIndexBuffer != 0)
+        glDeleteBuffers(1, &mIndexBuffer);
+    mVertexBuffer = mIndexBuffer = 0;
+}
+
+void IndexedMesh::bindAttributes(GLint position, GLint texCoord, GLint normal) {
+    const GLsizei stride = MeshData::kStride * sizeof(float);
+    glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+    if (position >= 0) {
+        glEnableVertexAttribArray(position);
+        glVertexAttribPointer(position, 3, GL_FLOAT, GL_FALSE, stride,
+                (const void *) (MeshData::kPositionOffset * sizeof(float)));
+    }
+    if (texCoord >= 0) {
+        glEnableVertexAttribArray(texCoord);
+        glVertexAttribPointer(texCoord, 2, GL_FLOAT, GL_FALSE, stride,
+                (const void *) (MeshData::kTexCoordOffset * sizeof(float)));
+    }
+    if (normal >= 0) {
+        glEnableVertexAttribArray(normal);
+        glVertexAttribPointer(normal, 3, GL_FLOAT, GL_FALSE, stride,
+                (const void *) (MeshData::kNormalOffset * sizeof(float)));
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+}
+
+void IndexedMesh::draw(uint32_t level) const {
+    if (level >= mLodCounts.size())
+        level = (uint32_t) mLodCounts.size() - 1;
+    const size_t indexSize = mIndexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+    glDrawElements(GL_TRIANGLES, mLodCounts[level], mIndexType, (const void *) (mLodFirsts[level] * indexSize));
+    RenderStats::addDraw(mLodCounts[level] / 3);
+}
+
+bool IndexedMesh::Key::operator==(const Key& other) const {
+    if (shape != other.shape)
+        return false;
+    for (int i = 0; i < 4; i++) {
+        if (params[i] != other.params[i])
+            return false;
+    }
+    return true;
+}
+
+std::shared_ptr<IndexedMesh> IndexedMesh::findMesh(const Key& key) {
+    std::shared_ptr<IndexedMesh> ret;
+    for (auto i = mMeshPool.begin(); i != mMeshPool.end();) {
+        if (i->second.expired()) {
+            i = mMeshPool.erase(i);
+            continue;
+        }
+        if (!ret && i->first == key)
+            ret = i->second.lock();
+        i++;
+    }
+    return ret;
+}
+
+std::shared_ptr<IndexedMesh> IndexedMesh::putMesh(const Key& key, const MeshData * levels, uint32_t levelCount) {
+    std::shared_ptr<IndexedMesh> mesh = std::make_shared<IndexedMesh>(levels, levelCount);
+    mMeshPool.push_back(std::make_pair(key, std::weak_ptr<IndexedMesh>(mesh)));
+    return mesh;
+}
+
+uint32_t IndexedMesh::getPoolSize() {
+    uint32_t count = 0;
+    for (auto i = mMeshPool.begin(); i != mMeshPool.end(); i++) {
+        if (!i->second.expired())
+            count++;
+    }
+    return count;
+}
+
+std::shared_ptr<IndexedMesh> IndexedMesh::getUVSphere(float radius, uint32_t slices, uint32_t stacks, uint32_t lodCount) {
+    if (lodCount < 1)
+        lodCount = 1;
+    const Key key = {kUVSphere, {radius, (float) slices, (float) stacks, (float) lodCount}};
+    std::shared_ptr<IndexedMesh> mesh = findMesh(key);
+    if (!mesh) {
+        std::vector<MeshData> levels(lodCount);
+        for (uint32_t l = 0; l < lodCount; l++)
+            MeshGenerator::uvSphere(radius, slices >> l, stacks >> l, levels[l]);
+        mesh = putMesh(key, levels.data(), lodCount);
+    }
+    return mesh;
+}
+
+std::shared_ptr<IndexedMesh> IndexedMesh::getIcosphere(float radius, uint32_t subdivisions) {
+    const Key key = {kIcosphere, {radius, (float) subdivisions, 0, 0}};
+    std::shared_ptr<IndexedMesh> mesh = findMesh(key);
+    if (!mesh) {
+        MeshData data;
+        MeshGenerator::icosphere(radius, subdivisions, data);
+        mesh = putMesh(key, &data, 1);
+    }
+    return mesh;
+}
+
+std::shared_ptr<IndexedMesh> IndexedMesh::getCube(float size) {
+    const Key key = {kCube, {size, 0, 0, 0}};
+    std::shared_ptr<IndexedMesh> mesh = findMesh(key);
+    if (!mesh) {
+        MeshData data;
+        MeshGenerator::cube(size, data);
+        mesh = putMesh(key, &data, 1);
+    }
+    return mesh;
+}
+
+std::shared_ptr<IndexedMesh> IndexedMesh::getPlane(float width, float depth, uint32_t divisionsX, uint32_t divisionsZ) {
+    const Key key = {kPlane, {width, depth, (float) divisionsX, (float) divisionsZ}};
+    std::shared_ptr<IndexedMesh> mesh = findMesh(key);
+    if (!mesh) {
+        MeshData data;
+        MeshGenerator::plane(width, depth, divisionsX, divisionsZ, data);
+        mesh = putMesh(key, &data, 1);
+    }
+    return mesh;
+}
+
+std::shared_ptr<IndexedMesh> IndexedMesh::getCylinder(float radius, float height, uint32_t slices) {
+    const Key key = {kCylinder, {radius, height, (float) slices, 0}};
+    std::shared_ptr<IndexedMesh> mesh = findMesh(key);
+    if (!mesh) {
+        MeshData data;
+        MeshGenerator::cylinder(radius, height, slices, data);
+        mesh = putMesh(key, &data, 1);
+    }
+    return mesh;
+}
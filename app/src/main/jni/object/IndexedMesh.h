@@ -0,0 +1,97 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <vector>
+#include <GLES3/gl31.h>
+#include <GLES3/gl3ext.h>
+#include <MeshGenerator.h>
+
+// A MeshData in GL buffers, one interleaved vertex buffer and one index
+// buffer.  The get functions share meshes through a pool keyed by generator
+// and parameters, like Shader::findShader(), so every sphere of one
+// tessellation draws from the same buffers.  Attribute locations differ
+// between shaders, so each user records them in a VAO of its own.
+//
+// A mesh may carry levels of detail, level 0 the finest.  All levels sit
+// in the same two buffers and a level is a range of the index buffer.
+class IndexedMesh {
+public:
+    explicit IndexedMesh(const MeshData& data);
+    IndexedMesh(const MeshData * levels, uint32_t levelCount);
+    ~IndexedMesh();
+
+    // Call with the user's VAO bound.  Pass -1 for inputs the shader lacks.
+    // Binds the index buffer into the VAO too.
+    void bindAttributes(GLint position, GLint texCoord, GLint normal);
+
+    // Call with a VAO from bindAttributes() bound.  Counts the triangles in
+    // RenderStats.
+    void draw(uint32_t level = 0) const;
+
+    inline uint32_t getLodCount() const {
+        return (uint32_t) mLodCounts.size();
+    }
+
+    inline uint32_t getVertexCount() const {
+        return mVertexCount;
+    }
+
+    inline uint32_t getIndexCount(uint32_t level = 0) const {
+        return mLodCounts[level];
+    }
+
+    inline const AABB& getBounds() const {
+        return mBounds;
+    }
+
+    // Each further level halves slices and stacks.
+    static std::shared_ptr<IndexedMesh> getUVSphere(float radius, uint32_t slices, uint32_t stacks, uint32_t lodCount = 1);
+    static std::shared_ptr<IndexedMesh> getIcosphere(float radius, uint32_t subdivisions);
+    static std::shared_ptr<IndexedMesh> getCube(float size);
+    static std::shared_ptr<IndexedMesh> getPlane(float width, float depth, uint32_t divisionsX, uint32_t divisionsZ);
+    static std::shared_ptr<IndexedMesh> getCylinder(float radius, float height, uint32_t slices);
+
+    // Meshes alive in the pool.
+    static uint32_t getPoolSize();
+
+private:
+    enum Shape {
+        kUVSphere,
+        kIcosphere,
+        kCube,
+        kPlane,
+        kCylinder
+    };
+
+    struct Key {
+        Shape shape;
+        float params[4];
+
+        bool operator==(const Key& other) const;
+    };
+
+    static std::shared_ptr<IndexedMesh> findMesh(const Key& key);
+    static std::shared_ptr<IndexedMesh> putMesh(const Key& key, const MeshData * levels, uint32_t levelCount);
+
+    GLuint mVertexBuffer;
+    GLuint mIndexBuffer;
+    GLenum mIndexType;
+    uint32_t mVertexCount;
+    std::vector<uint32_t> mLodFirsts;      // first index of each level
+    std::vector<uint32_t> mLodCounts;
+    AABB mBounds;
+
+    static std::vector<std::pair<Key, std::weak_ptr<IndexedMesh> > > mMeshPool;
+};
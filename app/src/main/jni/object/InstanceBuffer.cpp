@@ -0,0 +1,59 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#define LOG_TAG "InstanceBuffer"
+#include <stddef.h>
+#include <log.h>
+#include <InstanceBuffer.h>
+
+const GLuint InstanceBuffer::kModelLocation;
+const GLuint InstanceBuffer::kColorLocation;
+const GLuint InstanceBuffer::kLayerLocation;
+
+InstanceBuffer::InstanceBuffer() : mBuffer(0), mCapacity(0), mCount(0) {
+    glGenBuffers(1, &mBuffer);
+}
+
+InstanceBuffer::~InstanceBuffer() {
+    if (mBuffer != 0)
+        glDeleteBuffers(1, &mBuffer);
+    mBuffer = 0;
+}
+
+void InstanceBuffer::bindAttributes() {
+    const GLsizei stride = sizeof(InstanceData);
+    glBindBuffer(GL_ARRAY_BUFFER, mBuffer);
+    for (GLuint col = 0; col < 4; col++) {
+        const GLuint location = kModelLocation + col;
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, stride,
+                (const void *) (offsetof(InstanceData, model) + col * 4 * sizeof(float)));
+        glVertexAttribDivisor(location, 1);
+    }
+    glEnableVertexAttribArray(kColorLocation);
+    glVertexAttribPointer(kColorLocation, 4, GL_FLOAT, GL_FALSE, stride, (const void *) offsetof(InstanceData, color));
+    glVertexAttribDivisor(kColorLocation, 1);
+    glEnableVertexAttribArray(kLayerLocation);
+    glVertexAttribPointer(kLayerLocation, 1, GL_FLOAT, GL_FALSE, stride, (const void *) offsetof(InstanceData, layer));
+    glVertexAttribDivisor(kLayerLocation, 1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBuffer::upload(const InstanceData * data, uint32_t count) {
+    glBindBuffer(GL_ARRAY_BUFFER, mBuffer);
+    if (count > mCapacity)
+        mCapacity = count;
+    glBufferData(GL_ARRAY_BUFFER, mCapacity * sizeof(InstanceData), NULL, GL_DYNAMIC_DRAW);
+    if (count > 0)
+        glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(InstanceData), data);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    mCount = count;
+}
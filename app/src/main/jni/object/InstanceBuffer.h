@@ -0,0 +1,54 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#pragma once
+
+#include <stdint.h>
+#include <GLES3/gl31.h>
+#include <GLES3/gl3ext.h>
+
+// One instance for glDrawElementsInstanced.  Matches the per instance inputs
+// of shader/vertex/vtni_vertex.glsl.
+struct InstanceData {
+    float model[16];    // column major, like Matrix4::get()
+    float color[4];
+    float layer;        // texture array layer
+    float padding[3];
+};
+
+// GL buffer of InstanceData with the attribute divisors set up.
+class InstanceBuffer {
+public:
+    // Attribute locations, the model matrix takes four.
+    static const GLuint kModelLocation = 3;
+    static const GLuint kColorLocation = 7;
+    static const GLuint kLayerLocation = 8;
+
+public:
+    InstanceBuffer();
+    ~InstanceBuffer();
+
+    // Call with the mesh's VAO bound.
+    void bindAttributes();
+
+    // Orphans the old storage first, so the driver need not wait for draws
+    // still reading the previous contents.
+    void upload(const InstanceData * data, uint32_t count);
+
+    inline uint32_t getCount() const {
+        return mCount;
+    }
+
+private:
+    GLuint mBuffer;
+    uint32_t mCapacity;
+    uint32_t mCount;
+};
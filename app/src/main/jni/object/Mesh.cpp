@@ -3,6 +3,8 @@
 #include <GLES3/gl31.h>
 #include <GLES3/gl3ext.h>
 #include <log.h>
+#include <MeshSimplifier.h>
+#include <RenderStats.h>
 
 #include "Mesh.h"
 
@@ -15,6 +17,7 @@ Mesh::Mesh()
 , mIndiceSize(0)
 , mFaceType(0)
 , mVAOID(0)
+, mLod(0)
 {
 }
 
@@ -33,7 +36,7 @@ std::string Mesh::getName() const
     return mName;
 }
 
-void Mesh::createVertexBufferData(VertexAttribEnum iVALocation, float *iData, uint32_t iSize, uint32_t iDimension)
+void Mesh::createVertexBufferData(VertexAttribEnum iVALocation, const float *iData, uint32_t iSize, uint32_t iDimension)
 {
     if (iVALocation == VertexAttrib_MaxDefineValue || iData == nullptr || iSize == 0 || iDimension == 0) {
         LOGE("Parameter invalid!!! iVALocation(%d), iData(%p), iSize(%u), iDim(%u)",
@@ -56,7 +59,7 @@ void Mesh::createVertexBufferData(VertexAttribEnum iVALocation, float *iData, ui
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
-void Mesh::createIndexBufferData(uint32_t *iData, uint32_t iSize, uint32_t iType)
+void Mesh::createIndexBufferData(const uint32_t *iData, uint32_t iSize, uint32_t iType)
 {
     if (iData == nullptr || iSize == 0 || iType == 0) {
         LOGE("Parameter invalid!!! iData(%p), iSize(%u), iType(%u)", iData, iSize, iType);
@@ -71,12 +74,87 @@ void Mesh::createIndexBufferData(uint32_t *iData, uint32_t iSize, uint32_t iType
     //2. allocate new buffer
     mFaceType = iType;
     mIndiceSize = iSize;
+    mLodFirsts.assign(1, 0);
+    mLodSizes.assign(1, iSize);
+    mLod = 0;
     glGenBuffers(1, &mIndicesBuffer);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndicesBuffer);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, iSize * sizeof(uint32_t), iData, GL_STATIC_DRAW);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
+void Mesh::createLodIndexBufferData(const uint32_t *iData, uint32_t iSize, uint32_t iType,
+    const float *iPositions, uint32_t iPositionSize, uint32_t iDimension, uint32_t iLodCount)
+{
+    if (iPositions == nullptr || iDimension < 3 || iLodCount <= 1) {
+        createIndexBufferData(iData, iSize, iType);
+        return;
+    }
+    std::vector<uint32_t> indices, firsts, sizes;
+    buildLodIndices(iData, iSize, iPositions, iPositionSize, iDimension, iLodCount, indices, firsts, sizes);
+    createLodIndexBufferData(indices, firsts, sizes, iType);
+}
+
+void Mesh::createLodIndexBufferData(const std::vector<uint32_t> &iIndices, const std::vector<uint32_t> &iFirsts,
+    const std::vector<uint32_t> &iSizes, uint32_t iType)
+{
+    if (iFirsts.empty() || iFirsts.size() != iSizes.size()) {
+        LOGE("Parameter invalid!!! firsts(%zu), sizes(%zu)", iFirsts.size(), iSizes.size());
+        return;
+    }
+    //upload, then restore the level ranges.
+    createIndexBufferData(iIndices.data(), static_cast<uint32_t>(iIndices.size()), iType);
+    mIndiceSize = iSizes[0];
+    mLodFirsts = iFirsts;
+    mLodSizes = iSizes;
+    LOGI("M[%s] %u LODs, %u triangles at the coarsest", mName.c_str(),
+        static_cast<uint32_t>(mLodSizes.size()), mLodSizes.back() / 3);
+}
+
+void Mesh::buildLodIndices(const uint32_t *iData, uint32_t iSize,
+    const float *iPositions, uint32_t iPositionSize, uint32_t iDimension, uint32_t iLodCount,
+    std::vector<uint32_t> &oIndices, std::vector<uint32_t> &oFirsts, std::vector<uint32_t> &oSizes)
+{
+    //simplify each level from the one before, all levels in one list.
+    oIndices.assign(iData, iData + iSize);
+    oFirsts.assign(1, 0);
+    oSizes.assign(1, iSize);
+    if (iPositions == nullptr || iDimension < 3 || iLodCount <= 1) {
+        return;
+    }
+    std::vector<uint32_t> level;
+    for (uint32_t lod = 1; lod < iLodCount; ++lod) {
+        const uint32_t *src = oIndices.data() + oFirsts.back();
+        uint32_t got = MeshSimplifier::simplify(iPositions, iDimension, iPositionSize / iDimension,
+            src, oSizes.back(), oSizes.back() / 2, level);
+        if (got == 0 || got * 4 > oSizes.back() * 3) {
+            break; //not worth a level, seams or outlines hold most of it.
+        }
+        oFirsts.push_back(static_cast<uint32_t>(oIndices.size()));
+        oSizes.push_back(got);
+        oIndices.insert(oIndices.end(), level.begin(), level.end());
+    }
+}
+
+void Mesh::setLod(uint32_t iLevel)
+{
+    if (mLodSizes.empty()) {
+        mLod = 0;
+        return;
+    }
+    mLod = iLevel < mLodSizes.size() ? iLevel : static_cast<uint32_t>(mLodSizes.size() - 1);
+}
+
+uint32_t Mesh::getLodCount() const
+{
+    return mLodSizes.empty() ? 1 : static_cast<uint32_t>(mLodSizes.size());
+}
+
+uint32_t Mesh::getTriangleCount() const
+{
+    return (mLodSizes.empty() ? mIndiceSize : mLodSizes[mLod]) / 3;
+}
+
 void Mesh::createVAO()
 {
     if (glIsVertexArray(mVAOID) == GL_TRUE) {
@@ -113,16 +191,19 @@ void Mesh::createVAO()
 void Mesh::draw()
 {
     if (mVAOID > 0) {
+        uint32_t first = mLodSizes.empty() ? 0 : mLodFirsts[mLod];
+        uint32_t size = mLodSizes.empty() ? mIndiceSize : mLodSizes[mLod];
         glBindVertexArray(mVAOID);
-        glDrawElements(GL_TRIANGLES, mIndiceSize, GL_UNSIGNED_INT, 0 );
+        glDrawElements(GL_TRIANGLES, size, GL_UNSIGNED_INT, reinterpret_cast<const void *>(first * sizeof(uint32_t)));
         glBindVertexArray(0);
+        RenderStats::addDraw(size / 3);
     }
 }
 
 void Mesh::releaseGLComp()
 {
     
-    for (uint32_t vaID; vaID < VertexAttrib_MaxDefineValue; ++vaID) {
+    for (uint32_t vaID = 0; vaID < VertexAttrib_MaxDefineValue; ++vaID) {
         if (glIsBuffer(mVAttribBuffers[vaID]) == GL_TRUE) {
             glDeleteBuffers(1, &mVAttribBuffers[vaID]);
         }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <stdint.h>
 
 enum VertexAttribEnum
 {
@@ -19,8 +21,24 @@ public:
 public:
     void setName(const std::string &iName);
     std::string getName() const;
-    void createVertexBufferData(VertexAttribEnum iVALocation, float *iData, uint32_t iSize, uint32_t iDimension);
-    void createIndexBufferData(uint32_t *iData, uint32_t iSize, uint32_t iType);
+    void createVertexBufferData(VertexAttribEnum iVALocation, const float *iData, uint32_t iSize, uint32_t iDimension);
+    void createIndexBufferData(const uint32_t *iData, uint32_t iSize, uint32_t iType);
+    //Like createIndexBufferData, plus up to iLodCount - 1 coarser levels simplified from iData,
+    //each about half the triangles of the one before. iPositions are the vertices given to
+    //createVertexBufferData(VertexAttrib_Vertices, ...).
+    void createLodIndexBufferData(const uint32_t *iData, uint32_t iSize, uint32_t iType,
+        const float *iPositions, uint32_t iPositionSize, uint32_t iDimension, uint32_t iLodCount);
+    //Uploads levels made by buildLodIndices, so a cached model skips the simplifier.
+    void createLodIndexBufferData(const std::vector<uint32_t> &iIndices, const std::vector<uint32_t> &iFirsts,
+        const std::vector<uint32_t> &iSizes, uint32_t iType);
+    //The CPU half of createLodIndexBufferData, safe off the GL thread. Level i is the
+    //oSizes[i] indices from oFirsts[i] in oIndices, level 0 is iData itself.
+    static void buildLodIndices(const uint32_t *iData, uint32_t iSize,
+        const float *iPositions, uint32_t iPositionSize, uint32_t iDimension, uint32_t iLodCount,
+        std::vector<uint32_t> &oIndices, std::vector<uint32_t> &oFirsts, std::vector<uint32_t> &oSizes);
+    void setLod(uint32_t iLevel); //clamped to the levels there are.
+    uint32_t getLodCount() const;
+    uint32_t getTriangleCount() const; //of the current level.
     void createVAO(); //call it after we initialize all vertex buffers.
     void draw();
     void releaseGLComp();
@@ -31,5 +49,8 @@ protected:
     uint32_t mFaceType;
     uint32_t mIndiceSize;
     uint32_t mVAOID;
+    std::vector<uint32_t> mLodFirsts;
+    std::vector<uint32_t> mLodSizes;
+    uint32_t mLod;
     std::string mName;
 };
\ No newline at end of file
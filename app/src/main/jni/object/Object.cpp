@@ -9,6 +9,7 @@
 // specifications, and documentation provided by HTC to You."
 
 #define LOG_TAG "Object"
+#include <string.h>
 #include <Object.h>
 #include <Context.h>
 #include <Shader.h>
@@ -17,11 +18,12 @@
 #include <log.h>
 
 Object::Object() : 
-        mParent(NULL), mVAO(NULL),
+        mParent(NULL), mGraph(NULL), mNode(SceneGraph::kInvalidNode), mVAO(NULL),
         mTexture(NULL), mEnable(true), mHasError(false) {
 }
 
 Object::~Object() {
+    detachFromGraph();
     if (mTexture != NULL)
         delete mTexture;
     mTexture = NULL;
@@ -100,16 +102,57 @@ Object * Object::move(float x, float y, float z) {
     const float * m = mTransform.get();
     const float col [] = {m[12] + x, m[13] + y, m[14] + z, m[15]};
     mTransform.setColumn(3, col);
+    if (mGraph != NULL)
+        mGraph->setLocalTransform(mNode, mTransform);
     return this;
 }
 
+void Object::setTransform(const Matrix4& transform) {
+    mTransform = transform;
+    if (mGraph != NULL)
+        mGraph->setLocalTransform(mNode, mTransform);
+}
+
+void Object::setParent(Object * parent) {
+    mParent = parent;
+    if (mGraph == NULL)
+        return;
+    if (mParent != NULL && mParent->mGraph == mGraph)
+        mGraph->setParent(mNode, mParent->mNode);
+    else
+        mGraph->setParent(mNode, SceneGraph::kInvalidNode);
+}
+
+void Object::attachToGraph(SceneGraph * graph) {
+    detachFromGraph();
+    if (graph == NULL)
+        return;
+    SceneGraph::NodeId parent = SceneGraph::kInvalidNode;
+    if (mParent != NULL && mParent->mGraph == graph)
+        parent = mParent->mNode;
+    mNode = graph->createNode(parent);
+    if (mNode == SceneGraph::kInvalidNode)
+        return;
+    mGraph = graph;
+    mGraph->setLocalTransform(mNode, mTransform);
+}
+
+void Object::detachFromGraph() {
+    if (mGraph != NULL && mGraph->isValid(mNode))
+        mGraph->destroyNode(mNode);
+    mGraph = NULL;
+    mNode = SceneGraph::kInvalidNode;
+}
+
 Object * Object::move(const Vector4& direction, float distance) {
     // TODO
     return this;
 }
 
 Matrix4 Object::getTransforms() const {
-    if (mParent != NULL) {
+    if (mGraph != NULL) {
+        return mGraph->getWorldTransform(mNode);
+    } else if (mParent != NULL) {
         return mParent->getTransforms() * mTransform;
     } else {
         return mTransform;
@@ -122,5 +165,15 @@ Matrix3 Object::makeNormalMatrix(const Matrix4& view) const {
     return out.invert().transpose();
 }
 
+Matrix3 Object::getWorldNormalMatrix() const {
+    if (mGraph != NULL)
+        return mGraph->getNormalMatrix(mNode);
+    return makeNormalMatrix(getTransforms());
+}
+
+AABB Object::getWorldBounds() const {
+    return mLocalBounds.transformed(getTransforms());
+}
+
 void Object::draw(const Matrix4& projection, const Matrix4& eye, const Matrix4& view, const Vector4& lightDir) {
 }
@@ -11,6 +11,8 @@
 #pragma once
 #include <shared/Matrices.h>
 #include <shared/Vectors.h>
+#include <shared/SceneGraph.h>
+#include <shared/BoundingVolume.h>
 #include <Shader.h>
 #include <string>
 
@@ -22,6 +24,9 @@ protected:
     const char * mName;
     Object * mParent;
     Matrix4 mTransform;
+    SceneGraph * mGraph;
+    SceneGraph::NodeId mNode;
+    AABB mLocalBounds;
     std::shared_ptr<Shader> mShader;
     VertexArrayObject * mVAO;
     Texture * mTexture;
@@ -56,9 +61,7 @@ public:
 
     bool hasGLError() const;
 
-    inline void setParent(Object * parent) {
-        mParent = parent;
-    }
+    void setParent(Object * parent);
 
     inline Object * getParent() {
         return mParent;
@@ -74,11 +77,42 @@ public:
 
     Object * move(const Vector4& direction, float distance);
 
-    inline Matrix4& getTransform() {
+    inline const Matrix4& getTransform() const {
         return mTransform;
     }
 
+    void setTransform(const Matrix4& transform);
+
+    // Give this object a node in graph, under its parent's node if the parent
+    // is attached.  From then on getTransforms() and getWorldNormalMatrix()
+    // read the graph's cache, which is current after SceneGraph::update().
+    void attachToGraph(SceneGraph * graph);
+    void detachFromGraph();
+
+    inline SceneGraph::NodeId getNode() const {
+        return mNode;
+    }
+
+    // World transform.  Walks mParent when not attached to a graph.
     Matrix4 getTransforms() const;
+
+    Matrix3 getWorldNormalMatrix() const;
+
+    // Bounds of the mesh in local space, for culling.  Objects without
+    // bounds are never culled.
+    inline void setLocalBounds(const AABB& bounds) {
+        mLocalBounds = bounds;
+    }
+
+    inline const AABB& getLocalBounds() const {
+        return mLocalBounds;
+    }
+
+    inline bool hasBounds() const {
+        return !mLocalBounds.isEmpty();
+    }
+
+    AABB getWorldBounds() const;
     
     Matrix3 makeNormalMatrix(const Matrix4& view) const;
 
@@ -0,0 +1,53 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#include <RenderState.h>
+
+const RenderState::Desc RenderState::kOpaque = {true, true, GL_LEQUAL, true, false};
+
+RenderState::Desc RenderState::sCurrent = RenderState::kOpaque;
+bool RenderState::sValid = false;
+uint32_t RenderState::sChanges = 0;
+
+static inline void setCapability(GLenum cap, bool enable) {
+    if (enable)
+        glEnable(cap);
+    else
+        glDisable(cap);
+}
+
+void RenderState::apply(const Desc& desc) {
+    if (!sValid || desc.depthTest != sCurrent.depthTest) {
+        setCapability(GL_DEPTH_TEST, desc.depthTest);
+        sChanges++;
+    }
+    if (!sValid || desc.depthWrite != sCurrent.depthWrite) {
+        glDepthMask(desc.depthWrite ? GL_TRUE : GL_FALSE);
+        sChanges++;
+    }
+    if (!sValid || desc.depthFunc != sCurrent.depthFunc) {
+        glDepthFunc(desc.depthFunc);
+        sChanges++;
+    }
+    if (!sValid || desc.cullFace != sCurrent.cullFace) {
+        setCapability(GL_CULL_FACE, desc.cullFace);
+        sChanges++;
+    }
+    if (!sValid || desc.blend != sCurrent.blend) {
+        setCapability(GL_BLEND, desc.blend);
+        sChanges++;
+    }
+    sCurrent = desc;
+    sValid = true;
+}
+
+void RenderState::invalidate() {
+    sValid = false;
+}
@@ -0,0 +1,49 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+
+#include <stdint.h>
+#include <GLES3/gl31.h>
+
+// Depth, culling and blending of the GL thread, set through a cache so only
+// what changed reaches GL.
+//
+// The cache only knows what went through apply().  Code that sets these
+// with plain GL calls and does not put them back leaves it stale; call
+// invalidate() after such code, and once per frame to be safe.
+class RenderState {
+public:
+    struct Desc {
+        bool depthTest;
+        bool depthWrite;
+        GLenum depthFunc;
+        bool cullFace;          // back faces, counter clockwise front
+        bool blend;
+    };
+
+    // Depth tested with GL_LEQUAL and written, back faces culled, no blending.
+    static const Desc kOpaque;
+
+public:
+    static void apply(const Desc& desc);
+    // The next apply() sets everything.
+    static void invalidate();
+
+    // GL calls made by apply(), for tests.
+    static inline uint32_t getChangeCount() {
+        return sChanges;
+    }
+
+private:
+    static Desc sCurrent;
+    static bool sValid;
+    static uint32_t sChanges;
+};
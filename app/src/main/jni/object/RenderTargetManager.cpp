@@ -0,0 +1,89 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#define LOG_TAG "RenderTargetManager"
+#include <log.h>
+#include <FrameBufferObject.h>
+#include <RenderTargetManager.h>
+
+const uint32_t RenderTargetManager::kEyeCount;
+
+namespace {
+// GL_DEPTH_COMPONENT24 is stored in 32 bits.
+const size_t kDepthBytesPerSample = 4;
+// RGBA8 swapchain textures.
+const size_t kColorBytesPerPixel = 4;
+}
+
+RenderTargetManager::RenderTargetManager() :
+        mSharedDepth(0), mSamples(1), mDepthBufferCount(0), mDepthBytes(0), mColorBytes(0) {
+}
+
+RenderTargetManager::~RenderTargetManager() {
+    release();
+}
+
+int RenderTargetManager::chooseSamples(int requested) {
+    const int maxSamples = requested > 1 ? FrameBufferObject::getMaxSamples() : 1;
+    int samples = 4;
+    while (samples > 1 && (samples > requested || samples > maxSamples))
+        samples /= 2;
+    return samples;
+}
+
+bool RenderTargetManager::init(const std::vector<GLuint> textures[kEyeCount], int width, int height,
+        int samples, bool shareDepth) {
+    release();
+    mSamples = chooseSamples(samples);
+    if (mSamples != samples)
+        LOGW("%d samples requested, using %d", samples, mSamples);
+
+    if (shareDepth) {
+        mSharedDepth = FrameBufferObject::createDepthBuffer(width, height, mSamples);
+        mDepthBufferCount = 1;
+    }
+
+    const size_t pixels = (size_t) width * height;
+    for (uint32_t eye = 0; eye < kEyeCount; eye++) {
+        for (size_t i = 0; i < textures[eye].size(); i++) {
+            FrameBufferObject * fbo = new FrameBufferObject(textures[eye][i], width, height, mSamples, mSharedDepth);
+            if (fbo->hasError()) {
+                LOGE("Failed to create the target of eye %u texture %u", eye, (uint32_t) i);
+                delete fbo;
+                release();
+                return false;
+            }
+            mTargets[eye].push_back(fbo);
+            if (!shareDepth)
+                mDepthBufferCount++;
+            mColorBytes += pixels * kColorBytesPerPixel;
+        }
+    }
+    mDepthBytes = mDepthBufferCount * pixels * mSamples * kDepthBytesPerSample;
+
+    LOGI("%ux%u, %d samples, %u depth buffers: %zu KB depth, %zu KB color", width, height, mSamples,
+            mDepthBufferCount, mDepthBytes / 1024, mColorBytes / 1024);
+    return true;
+}
+
+void RenderTargetManager::release() {
+    for (uint32_t eye = 0; eye < kEyeCount; eye++) {
+        for (size_t i = 0; i < mTargets[eye].size(); i++)
+            delete mTargets[eye][i];
+        mTargets[eye].clear();
+    }
+    if (mSharedDepth != 0)
+        glDeleteRenderbuffers(1, &mSharedDepth);
+    mSharedDepth = 0;
+    mDepthBufferCount = 0;
+    mDepthBytes = 0;
+    mColorBytes = 0;
+}
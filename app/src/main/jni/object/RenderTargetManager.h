@@ -0,0 +1,83 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include <GLES3/gl31.h>
+
+class FrameBufferObject;
+
+// The eye framebuffers, one per swapchain texture, at one sample count.
+//
+// The requested sample count (1, 2 or 4) is lowered to what the device can
+// render to a texture.  Depth is transient: every frame clears it and
+// unbindFrameBuffer() invalidates it, so with shared depth one buffer serves
+// all targets instead of one per texture.
+class RenderTargetManager {
+public:
+    static const uint32_t kEyeCount = 2;
+
+public:
+    RenderTargetManager();
+    ~RenderTargetManager();
+
+    // Largest of 1, 2 and 4 that does not exceed requested or the device limit.
+    static int chooseSamples(int requested);
+
+    // Replaces the current targets.  textures[eye] holds the swapchain
+    // textures of that eye, all width x height.
+    bool init(const std::vector<GLuint> textures[kEyeCount], int width, int height, int samples,
+            bool shareDepth = true);
+    void release();
+
+    inline FrameBufferObject * get(uint32_t eye, uint32_t index) const {
+        return mTargets[eye][index];
+    }
+
+    inline uint32_t getCount(uint32_t eye) const {
+        return (uint32_t) mTargets[eye].size();
+    }
+
+    inline int getSamples() const {
+        return mSamples;
+    }
+
+    inline uint32_t getDepthBufferCount() const {
+        return mDepthBufferCount;
+    }
+
+    // Bytes of the depth buffers, counting every sample.  Tilers may keep
+    // multisampled depth in tile memory only, making this an upper bound.
+    inline size_t getDepthBytes() const {
+        return mDepthBytes;
+    }
+
+    // Bytes of the swapchain textures.  They belong to the texture queues;
+    // rendering to texture resolves into them without extra samples.
+    inline size_t getColorBytes() const {
+        return mColorBytes;
+    }
+
+    inline size_t getMemoryBytes() const {
+        return mDepthBytes + mColorBytes;
+    }
+
+private:
+    std::vector<FrameBufferObject *> mTargets[kEyeCount];
+    GLuint mSharedDepth;
+    int mSamples;
+    uint32_t mDepthBufferCount;
+    size_t mDepthBytes;
+    size_t mColorBytes;
+};
@@ -10,6 +10,7 @@
 
 #define LOG_TAG "Shader"
 #include <Shader.h>
+#include <string.h>
 #include <vector>
 #include "log.h"
 
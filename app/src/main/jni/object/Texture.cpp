@@ -79,7 +79,8 @@ Texture * Texture::loadTextureFromBitmapWithoutCached(WVR_CtrlerTexBitmap_t &wvr
     return texture;
 }
 
-Texture * Texture::loadTexture(const char * assetFile) {
+// Decodes an image asset without touching GL.
+static uint8_t * decodeAsset(const char * assetFile, AndroidBitmapInfo& info) {
     Context * context = Context::getInstance();
     EnvWrapper ew = context->getEnv();
     JNIEnv * env = ew.get();
@@ -91,40 +92,47 @@ Texture * Texture::loadTexture(const char * assetFile) {
     const void * data = textureFile.getBuffer();
     size_t length = textureFile.getLength();
     BitmapFactory * bf = context->getBitmapFactory();
+    return bf->decodeByteArray(env, data, length, info);
+}
 
-    AndroidBitmapInfo info;
-    uint8_t * bmp = bf->decodeByteArray(env, data, length, info);
-    if (bmp == NULL)
-        return NULL;
-
-    Texture * texture = genTexture();
-    texture->mBitmap = bmp;
-    texture->mWidth = info.width;
-    texture->mHeight = info.height;
-    texture->mStride = info.stride;
-    texture->mSize = info.stride * info.height;
-    switch (info.format) {
+static void toGLFormat(int32_t bitmapFormat, size_t& format, size_t& type) {
+    switch (bitmapFormat) {
     case ANDROID_BITMAP_FORMAT_RGB_565:
-        texture->mType = GL_UNSIGNED_SHORT_5_6_5;
-        texture->mFormat = GL_RGB565;
+        type = GL_UNSIGNED_SHORT_5_6_5;
+        format = GL_RGB565;
         break;
     case ANDROID_BITMAP_FORMAT_RGBA_4444:
-        texture->mType = GL_UNSIGNED_SHORT_4_4_4_4;
-        texture->mFormat = GL_RGBA4;
+        type = GL_UNSIGNED_SHORT_4_4_4_4;
+        format = GL_RGBA4;
         break;
     case ANDROID_BITMAP_FORMAT_RGBA_8888:
-        texture->mType = GL_UNSIGNED_BYTE;
-        texture->mFormat = GL_RGBA;
+        type = GL_UNSIGNED_BYTE;
+        format = GL_RGBA;
         break;
     case ANDROID_BITMAP_FORMAT_A_8:
-        texture->mType = GL_UNSIGNED_BYTE;
-        texture->mFormat = GL_RED;
+        type = GL_UNSIGNED_BYTE;
+        format = GL_RED;
         break;
     default:
-        texture->mType = GL_UNSIGNED_BYTE;
-        texture->mFormat = GL_RGBA;
+        type = GL_UNSIGNED_BYTE;
+        format = GL_RGBA;
         break;
     }
+}
+
+Texture * Texture::loadTexture(const char * assetFile) {
+    AndroidBitmapInfo info;
+    uint8_t * bmp = decodeAsset(assetFile, info);
+    if (bmp == NULL)
+        return NULL;
+
+    Texture * texture = genTexture();
+    texture->mBitmap = bmp;
+    texture->mWidth = info.width;
+    texture->mHeight = info.height;
+    texture->mStride = info.stride;
+    texture->mSize = info.stride * info.height;
+    toGLFormat(info.format, texture->mFormat, texture->mType);
 
     return texture;
 }
@@ -153,19 +161,35 @@ uint8_t * Texture::cropBitmap(const uint8_t * origBitmap, const size_t origW, co
     return croped;
 }
 
+CubemapData::CubemapData() : width(0), height(0), stride(0), format(GL_RGBA), type(GL_UNSIGNED_BYTE) {
+}
+
+size_t CubemapData::getGpuSize() const {
+    // GL_RGB5_A1, and a third more for the mipmaps.
+    return width * height * 2 * 6 * 4 / 3;
+}
+
 Texture * Texture::loadSkyboxTexture(const char * assetFile) {
-    Texture * texture = loadTexture(assetFile);
-    if (texture == NULL)
+    CubemapData data;
+    if (!decodeSkybox(assetFile, data))
         return NULL;
+    return createCubeMap(data);
+}
 
-    size_t stride = texture->mStride / 4;
-    size_t width = texture->mWidth / 4;
-    size_t height = texture->mHeight / 3;
-    if (((height * 3) != texture->mHeight) ||
-        ((stride * 4) != texture->mStride)) {
+bool Texture::decodeSkybox(const char * assetFile, CubemapData& data) {
+    AndroidBitmapInfo info;
+    uint8_t * bmp = decodeAsset(assetFile, info);
+    if (bmp == NULL)
+        return false;
+
+    size_t stride = info.stride / 4;
+    size_t width = info.width / 4;
+    size_t height = info.height / 3;
+    if (((height * 3) != info.height) ||
+        ((stride * 4) != info.stride)) {
         LOGW("May not a Skybox image.  Stop process");
-        delete texture;
-        return NULL;
+        delete [] bmp;
+        return false;
     }
 
     /**
@@ -180,6 +204,23 @@ Texture * Texture::loadSkyboxTexture(const char * assetFile) {
      *    GL_TEXTURE_CUBE_MAP_NEGATIVE_Z 5	Front
      */
     const int index[] = {6, 4, 1, 9, 5, 7};
+
+    data.width = width;
+    data.height = height;
+    data.stride = stride;
+    toGLFormat(info.format, data.format, data.type);
+    for (int i = 0; i < 6; i++) {
+        int x = stride * (index[i] % 4);
+        int y = height * (index[i] / 4);
+        uint8_t * bitmap = cropBitmap(bmp, info.stride, info.height, x, y, stride, height);
+        data.faces[i].assign(bitmap, bitmap + stride * height);
+        delete [] bitmap;
+    }
+    delete [] bmp;
+    return true;
+}
+
+Texture * Texture::createCubeMap(const CubemapData& data) {
     const int faces[] = {
                 GL_TEXTURE_CUBE_MAP_POSITIVE_X,
                 GL_TEXTURE_CUBE_MAP_NEGATIVE_X,
@@ -189,17 +230,18 @@ Texture * Texture::loadSkyboxTexture(const char * assetFile) {
                 GL_TEXTURE_CUBE_MAP_NEGATIVE_Z
             };
 
+    Texture * texture = genTexture();
+    texture->mWidth = data.width;
+    texture->mHeight = data.height;
+    texture->mStride = data.stride;
+    texture->mSize = data.getGpuSize();
+    texture->mFormat = data.format;
+    texture->mType = data.type;
     texture->bindTextureCubeMap();
 
     for (int i = 0; i < 6; i++) {
-        int x = stride * (index[i] % 4);
-        int y = height * (index[i] / 4);
-        uint8_t * bitmap = cropBitmap(texture->mBitmap, texture->mStride, texture->mHeight, x, y, stride, height);
-
         // Always output as GL_RGB5_A1 because the skybox don't need quality
-    	glTexImage2D(faces[i], 0, GL_RGB5_A1, width, height, 0, texture->mFormat, texture->mType, bitmap);
-
-    	delete [] bitmap;
+        glTexImage2D(faces[i], 0, GL_RGB5_A1, data.width, data.height, 0, data.format, data.type, data.faces[i].data());
     }
 
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -210,7 +252,98 @@ Texture * Texture::loadSkyboxTexture(const char * assetFile) {
     glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
 
     texture->unbindTextureCubeMap();
+
+    return texture;
+}
+
+Texture * Texture::loadEquirectTexture(const char * assetFile) {
+    Texture * texture = loadTexture(assetFile);
+    if (texture == NULL)
+        return NULL;
+    if (texture->mWidth != texture->mHeight * 2)
+        LOGW("%s is %zux%zu, not 2:1", assetFile, texture->mWidth, texture->mHeight);
+
+    texture->bindTexture();
+    texture->bindBitmap();
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    texture->unbindTexture();
     texture->cleanBitmap();
 
     return texture;
 }
+
+Texture * Texture::loadTextureArray(const char * const * assetFiles, int count) {
+    if (count <= 0)
+        return NULL;
+
+    Texture * texture = NULL;
+    for (int i = 0; i < count; i++) {
+        Texture * layer = loadTexture(assetFiles[i]);
+        if (layer == NULL) {
+            LOGE("Unable to load layer %d: %s", i, assetFiles[i]);
+            delete texture;
+            return NULL;
+        }
+
+        if (texture == NULL) {
+            texture = genTexture();
+            texture->mWidth = layer->mWidth;
+            texture->mHeight = layer->mHeight;
+            texture->mStride = layer->mStride;
+            texture->mSize = layer->mSize * count;
+            texture->mFormat = layer->mFormat;
+            texture->mType = layer->mType;
+            texture->bindTextureArray();
+            // The array doesn't need more quality than the single textures.
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGB5_A1, texture->mWidth, texture->mHeight, count, 0,
+                    texture->mFormat, texture->mType, NULL);
+        } else if (layer->mWidth != texture->mWidth || layer->mHeight != texture->mHeight ||
+                layer->mFormat != texture->mFormat || layer->mType != texture->mType) {
+            LOGE("Layer %d: %s does not match the first layer", i, assetFiles[i]);
+            delete layer;
+            texture->unbindTextureArray();
+            delete texture;
+            return NULL;
+        }
+
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, layer->mWidth, layer->mHeight, 1,
+                layer->mFormat, layer->mType, layer->mBitmap);
+        delete layer;
+    }
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    texture->unbindTextureArray();
+
+    return texture;
+}
+
+Texture * Texture::createTextureArray(const uint8_t * pixels, int width, int height, int layers) {
+    if (width <= 0 || height <= 0 || layers <= 0)
+        return NULL;
+
+    Texture * texture = genTexture();
+    texture->mWidth = width;
+    texture->mHeight = height;
+    texture->mStride = width * 4;
+    texture->mSize = texture->mStride * height * layers;
+    texture->mFormat = GL_RGBA;
+    texture->mType = GL_UNSIGNED_BYTE;
+    texture->bindTextureArray();
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    texture->unbindTextureArray();
+    return texture;
+}
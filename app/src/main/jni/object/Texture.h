@@ -9,10 +9,30 @@
 // specifications, and documentation provided by HTC to You."
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
 #include <GLES3/gl31.h>
 #include <GLES3/gl3ext.h>
 #include <wvr/wvr_ctrller_render_model.h>
 
+// CPU copy of a skybox cross with its six faces already cropped.  Decoding
+// makes no GL calls, so it may run on a worker; Texture::createCubeMap()
+// uploads it on the GL thread.
+struct CubemapData {
+    size_t width;                   // per face, in pixels
+    size_t height;
+    size_t stride;                  // per face row, in bytes
+    size_t format;
+    size_t type;
+    std::vector<uint8_t> faces[6];  // GL_TEXTURE_CUBE_MAP_POSITIVE_X first
+
+    CubemapData();
+
+    // What createCubeMap() takes on the GPU, mipmaps included.
+    size_t getGpuSize() const;
+};
+
 class Texture {
 private:
     GLuint mTexture;
@@ -40,6 +60,19 @@ public:
     static Texture * loadTexture(const char * assetFile);
     // loadSkyboxTexture will do glTexImage2D() inside.  Don't need do the bindBitmap().
     static Texture * loadSkyboxTexture(const char * assetFile);
+    // The CPU half of loadSkyboxTexture(), no GL calls.
+    static bool decodeSkybox(const char * assetFile, CubemapData& data);
+    // The GL half of loadSkyboxTexture().
+    static Texture * createCubeMap(const CubemapData& data);
+    // A 2:1 latitude-longitude panorama as a GL_TEXTURE_2D with mipmaps,
+    // repeating around.  Also already uploaded.
+    static Texture * loadEquirectTexture(const char * assetFile);
+    // Same sized images as the layers of a GL_TEXTURE_2D_ARRAY, with mipmaps.
+    // Like loadSkyboxTexture(), the data is already uploaded.
+    static Texture * loadTextureArray(const char * const * assetFiles, int count);
+    // RGBA8 layers of one level, tightly packed, for atlases.  Filtered
+    // like loadTextureFromBitmapWithoutCached().
+    static Texture * createTextureArray(const uint8_t * pixels, int width, int height, int layers);
 
     static uint8_t * cropBitmap(const uint8_t * origBitmap, const size_t origW, const size_t origH, const size_t x, const size_t y, const size_t w, const size_t h);
 
@@ -64,6 +97,14 @@ public:
         glBindTexture(GL_TEXTURE_2D, 0);
     }
 
+    inline void bindTextureArray() {
+        glBindTexture(GL_TEXTURE_2D_ARRAY, mTexture);
+    }
+
+    inline void unbindTextureArray() {
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    }
+
     inline void bindTextureCubeMap() {
         glBindTexture(GL_TEXTURE_CUBE_MAP, mTexture);
     }
@@ -2,12 +2,27 @@
 
 #define E_TO_UINT(enum) static_cast<uint32_t>(enum)
 
+#include <string.h>
 #include <functional>
 
 #include <log.h>
 
 #include "../Context.h"
 #include "Controller.h"
+#include "../shared/BoundingVolume.h"
+#include "../shared/RenderStats.h"
+
+//glPolygonOffset(0, -100) on a 24 bit depth buffer, in NDC.
+static const float sEffectDepthBias = 100.0f * 2.0f / 16777216.0f;
+
+//Draws iCount batch indices from iFirst.
+static void drawBatchRange(uint32_t iFirst, uint32_t iCount, GLenum iIndexType, uint32_t iIndexSize) {
+    if (iCount == 0) {
+        return;
+    }
+    glDrawElements(GL_TRIANGLES, iCount, iIndexType, reinterpret_cast<const void *>((uintptr_t) iFirst * iIndexSize));
+    RenderStats::addDraw(iCount / 3);
+}
 
 void dumpMatrix(const char * name, const Matrix4& mat) {
     const float * ptr = mat.get();
@@ -47,15 +62,25 @@ const std::string Controller::sControllerCompNames[CtrlerComp_MaxCompNumber] =
    std::string("__CM__Thumbstick")
 };
 
+const uint32_t Controller::sLodCount;
+const float Controller::sLodThresholds[Controller::sLodCount - 1] = {0.06f, 0.03f};
+
 Controller::Controller(WVR_DeviceType iCtrlerType)
-: mCachedData(nullptr)
-, mIsDataReady(false)
+: mIsDataReady(false)
 , mInitialized(false)
 , mCtrlerType(iCtrlerType)
 , mCompExistFlags{false}
+, mBodyRadius(0.0f)
+, mSlotMatrices{0.0f}
+, mSlotParams{0.0f}
+, mSlotRegions{0.0f}
+, mIsDotShown(false)
+, mIsBatteryShown(false)
 , mDiffTexLocations{-1, -1}
 , mMatrixLocations{-1, -1}
-, mUseEffectLocations{-1, -1}
+, mCompMatrixLocations{-1, -1}
+, mCompParamsLocations{-1, -1}
+, mCompRegionLocations{-1, -1}
 , mEffectColorLocations{-1, -1}
 , mTargetShader(nullptr)
 , mBtnEffect{1.0f,0.5f,0.5f,1.0f}
@@ -66,16 +91,18 @@ Controller::Controller(WVR_DeviceType iCtrlerType)
 , mTouchpadSacleFactor(0.15f)
 , mFloatingDistance(0.0f)
 , mRadius(1.0f)
+, mInput(nullptr)
 {
     LOGI("(%d[%p]): ctor!!", mCtrlerType, this);
     mShift.translate(1,1.5,2);
     for (uint32_t compID = 0; compID < CtrlerComp_MaxCompNumber; ++compID) {
-        mCompMeshes[compID].setName(sControllerCompNames[compID]);
         mCompTexID[compID] = -1;
         mCompExistFlags[compID] = false;
         mCompStates[compID] = CtrlerBtnState_None;
+        mCompSlots[compID] = ControllerModel::kNoSlot;
     }
     mLastUpdateTime = std::chrono::system_clock::now();
+    mLod.setThresholds(sLodThresholds, sLodCount);
     initializeGLComp();
 }
 
@@ -83,13 +110,9 @@ Controller::~Controller()
 {
     LOGI("(%d[%p]): dtor!!", mCtrlerType, this);
     //clear cache
-    if (mLoadModelFuncThread.joinable() == true) {
-        mLoadModelFuncThread.join();
-    }
-    //Don't protected because it's critial with mLoadModelFuncThread, but mLoadModelFuncThread is joined.
-    if (mCachedData != nullptr) {
-        WVR_ReleaseControllerModel(&mCachedData); //we will clear cached data ptr to nullptr.
-    }
+    JobSystem::getInstance().wait(mLoadModelJob);
+    //Don't protected because it's critial with the loading job, but the job is done.
+    mCachedData.reset();
     mIsDataReady = false;
     mInitialized = false;
     
@@ -99,72 +122,85 @@ Controller::~Controller()
 
 void Controller::loadControllerModelAsync()
 {
-    std::function<void()> loadModelFunc = [this](){
+    //Check controller render model name. 
+	std::string newRenderModelName;	
+	uint32_t paramLength = WVR_GetParameters(mCtrlerType, "GetRenderModelName", nullptr, 0);
+	newRenderModelName.resize(paramLength);	
+	WVR_GetParameters(mCtrlerType, "GetRenderModelName", &newRenderModelName[0], newRenderModelName.size());
+	newRenderModelName.resize(strlen(newRenderModelName.c_str()));
+	LOGI("(%d[%p]): new rm %s",  mCtrlerType, this, newRenderModelName.c_str());
+	if (newRenderModelName.compare(mCurrentRenderModelName) == 0) {
+	    LOGI("(%d[%p]): model name is still %s. So don't trigger asynchornous loading.", mCtrlerType, this, mCurrentRenderModelName.c_str());
+		return;
+	}
+    LOGI("(%d[%p]): change model name from %s to %s", mCtrlerType, this, mCurrentRenderModelName.c_str(), newRenderModelName.c_str());
+    mCurrentRenderModelName = newRenderModelName;
+    startLoadingJob(newRenderModelName);
+}
+
+void Controller::startLoadingJob(const std::string &iRenderModelName)
+{
+    std::function<void()> loadModelFunc = [this, iRenderModelName](){
         LOGI("(%d[%p]): In Loading Thread", mCtrlerType, this);
         mLoadingThreadMutex.lock();
         //1. Clear status and cached data(if it exist).
         {//Critical Section: Clear flag and cached parsed data.
             std::lock_guard<std::mutex> lockGuard(mCachedDataMutex);
-            if (mCachedData != nullptr) {
-                WVR_ReleaseControllerModel(&mCachedData); //we will clear cached data ptr to nullptr.
-            }
+            mCachedData.reset();
             mIsDataReady = false;
             mInitialized = false;
         }//Critical Section: Clear flag and cached parsed data.(End)
-        //2. Load ctrler model data.
-        WVR_Result result = WVR_GetCurrentControllerModel(mCtrlerType, &mCachedData);
-        if (result == WVR_Success) {
+        //2. Load ctrler model data, unless the other controller shows it already.
+        std::unique_ptr<ControllerModelData> data;
+        bool loaded = ControllerModel::isLoaded(iRenderModelName);
+        if (loaded == false) {
+            data.reset(new ControllerModelData());
+            loaded = ControllerModel::loadData(mCtrlerType, iRenderModelName, sLodCount, *data);
+        }
+        if (loaded == true) {
             {//Critical Section: Set data ready flag.
                 std::lock_guard<std::mutex> lockGuard(mCachedDataMutex);
+                mCachedData.swap(data);
+                mCachedName = iRenderModelName;
                 mIsDataReady = true;
             }//Critical Section: Set data ready flag.(End)
-        } else {
-            LOGI("(%d[%p]): Load fail. Reason(%d)", mCtrlerType, this, result);
         }
         mLoadingThreadMutex.unlock();
     };
-    //Check controller render model name. 
-	std::string newRenderModelName;	
-	uint32_t paramLength = WVR_GetParameters(mCtrlerType, "GetRenderModelName", nullptr, 0);
-	newRenderModelName.resize(paramLength);	
-	WVR_GetParameters(mCtrlerType, "GetRenderModelName", &newRenderModelName[0], newRenderModelName.size());
-	LOGI("(%d[%p]): new rm %s",  mCtrlerType, this, newRenderModelName.c_str());
-	if (newRenderModelName.compare(mCurrentRenderModelName) == 0) {
-	    LOGI("(%d[%p]): model name is still %s. So don't trigger asynchornous loading.", mCtrlerType, this, mCurrentRenderModelName.c_str());
-		return;
-	}
-    LOGI("(%d[%p]): change model name from %s to %s", mCtrlerType, this, mCurrentRenderModelName.c_str(), newRenderModelName.c_str());
-    mCurrentRenderModelName = newRenderModelName;
-    //Trigger LoadModelFuncThread.
-    if (mLoadModelFuncThread.joinable() == true) {
-        mLoadModelFuncThread.detach();
-        LOGI("(%d[%p]): Detach", mCtrlerType, this);
-    }
-    LOGI("(%d[%p]): Trigger Loading Thread", mCtrlerType, this);
-    
-    mLoadModelFuncThread = std::thread(loadModelFunc);
+    //Trigger the loading job. A running one finishes first, mLoadingThreadMutex orders them.
+    LOGI("(%d[%p]): Trigger Loading Job", mCtrlerType, this);
+    JobSystem::getInstance().runBackground(loadModelFunc, &mLoadModelJob);
 }
 
 void Controller::render(CtrlerDrawModeEnum iMode, const Matrix4 iProjs[CtrlerDrawMode_MaxModeMumber], const Matrix4 iEyes[CtrlerDrawMode_MaxModeMumber], const Matrix4 &iView, const Matrix4 &iCtrlerPose)
 {
     //1. Initialize controller model if necessary.
+    std::string reloadName;
     {//Critical Session: Initialize data block.
         std::lock_guard<std::mutex> lockGuard(mCachedDataMutex);
         if (mInitialized == false && mIsDataReady == true) {
+            //Clear old data.
+            releaseCtrlerModelGLComp();
+            //Upload mCachedData to gpu, or share the model the other controller uploaded.
             if (mCachedData != nullptr) {
-                //Clear old data.
-                releaseCtrlerModelGLComp();
-                //Initialize mCachedData to gpu.
+                mModel = ControllerModel::create(*mCachedData);
+            } else {
+                mModel = ControllerModel::find(mCachedName);
+            }
+            mCachedData.reset();
+            mIsDataReady = false;
+            if (mModel != nullptr) {
                 initializeCtrlerModelGLComp();
-                //Clear cached data but don't set data.
-                WVR_ReleaseControllerModel(&mCachedData); //we will clear cached data ptr to nullptr.
-                mIsDataReady = false;
                 mInitialized = true;
             } else {
-                LOGW("(%d[%p]): Initialize data is nullptr but data ready flag is true!!!", mCtrlerType, this);
+                LOGW("(%d[%p]): Model %s was released before we got it. Load again.", mCtrlerType, this, mCachedName.c_str());
+                reloadName = mCachedName;
             }
         }
     }//Critical Session: Initialize data block.(End)
+    if (reloadName.empty() == false) {
+        startLoadingJob(reloadName);
+    }
     //2. draw controller model if ok.
     if (mInitialized == false || WVR_IsDeviceConnected(mCtrlerType) == false) {
         return;
@@ -193,11 +229,13 @@ void Controller::render(CtrlerDrawModeEnum iMode, const Matrix4 iProjs[CtrlerDra
         mvps[1] = iProjs[1] * iEyes[1] * iView * mShift * iCtrlerPose;
     }
 
-    drawCtrlerBody(iMode, mvps);
-    drawCtrlerBattery(iMode, mvps);
-    drawCtrlerButtonEffect(iMode, mvps);
-    drawCtrlerTouchPad(iMode, mvps);
-    drawCtrlerRay(iMode, mvps);
+    //2.1 pick the level of detail once, from the first eye.
+    if (mBodyRadius > 0.0f) {
+        Matrix4 modelview = iEyes[0] * iView * mShift * iCtrlerPose * mCompLocalMats[CtrlerComp_Body];
+        mLod.select(LodSelector::projectedSize(modelview, iProjs[0], mBodyCenter, mBodyRadius));
+    }
+
+    drawCtrlerBatch(iMode, mvps);
     //draw end.
     //3. status recovering.
     if (lastPolygonOffsetFill == GL_TRUE) {
@@ -275,6 +313,7 @@ void Controller::initializeGLComp()
             delete [] fstr;
             if (ret == false) {
                 LOGE("(%d[%p]): Compile shader error!!!", mCtrlerType, this);
+                continue; //no program to query, keep the locations at -1.
             } else {
                 Shader::putShader(mShaders[mode]);
             }
@@ -282,99 +321,68 @@ void Controller::initializeGLComp()
         //
         mDiffTexLocations[mode] = mShaders[mode]->getUniformLocation("diffTexture");
         mMatrixLocations[mode]  = mShaders[mode]->getUniformLocation("matrix");
-        mUseEffectLocations[mode] = mShaders[mode]->getUniformLocation("useEffect");
+        mCompMatrixLocations[mode] = mShaders[mode]->getUniformLocation("compMatrix");
+        mCompParamsLocations[mode] = mShaders[mode]->getUniformLocation("compParams");
+        mCompRegionLocations[mode] = mShaders[mode]->getUniformLocation("compRegion");
         mEffectColorLocations[mode] = mShaders[mode]->getUniformLocation("effectColor");
-        LOGI("(%d[%p]): Mode[%d]: diffTexture(%d) matrix(%d) useEffect(%d) effectColor(%d)", mCtrlerType, this, 
+        LOGI("(%d[%p]): Mode[%d]: diffTexture(%d) matrix(%d) compMatrix(%d) compParams(%d) compRegion(%d) effectColor(%d)", mCtrlerType, this, 
             mode,
             mDiffTexLocations[mode], 
             mMatrixLocations[mode],
-            mUseEffectLocations[mode],
+            mCompMatrixLocations[mode],
+            mCompParamsLocations[mode],
+            mCompRegionLocations[mode],
             mEffectColorLocations[mode]);
     }
-    //Ray
-    float s = 0.00125f;
-    float dis = 3.0f;
-    float rayVertices[15] = {
-           s,    s, -0.003f,
-          -s,    s, -0.003f,
-          -s,   -s, -0.003f,
-           s,   -s, -0.003f,
-        0.0f, 0.0f, -dis
-    };
-
-    float rayTexCoords[10] = {
-        0 ,0,
-        0 ,0,
-        0 ,0,
-        0 ,0,
-        0 ,0
-    };
+}
 
-    uint32_t rayIndices[18]{
-        0, 1, 2,
-        0, 2, 3,
-        0, 4, 1,
-        0, 3, 4,
-        2, 4, 3,
-        1, 4, 2
-    };
+void Controller::releaseGLComp()
+{
+    //The shaders are pooled and the geometry belongs to mModel.
+}
 
-    mRayMesh.createVertexBufferData(VertexAttrib_Vertices, rayVertices, 15, 3);
-    mRayMesh.createVertexBufferData(VertexAttrib_TexCoords, rayTexCoords, 10, 2);
-    mRayMesh.createIndexBufferData(rayIndices, 18, 3);
-    mRayMesh.createVAO();
+void Controller::computeBodyBounds(const AABB &iBounds)
+{
+    mBodyRadius = 0.0f;
+    if (iBounds.isEmpty()) {
+        return;
+    }
+    mBodyCenter = iBounds.center();
+    mBodyRadius = iBounds.extent().length() * 0.5f;
 }
 
-void Controller::releaseGLComp()
+uint32_t Controller::getLodLevel() const
 {
-    mRayMesh.releaseGLComp();
+    return mLod.getLevel();
 }
 
 void Controller::initializeCtrlerModelGLComp()
 {
-    //1. Initialize meshes.
-    LOGI("(%d[%p]): Initialize meshes(%d)", mCtrlerType, this, (*mCachedData).compInfos.size);
+    const ControllerModelData &info = mModel->getInfo();
+    //1. Pick up meshes.
+    LOGI("(%d[%p]): Initialize meshes(%u)", mCtrlerType, this, mModel->getComponentCount());
     mEmitterPose = Matrix4();
 
-    for (uint32_t wvrCompID = 0; wvrCompID < (*mCachedData).compInfos.size; ++wvrCompID) {
-        uint32_t ctrlerCompID = getCompIdxByName((*mCachedData).compInfos.table[wvrCompID].name);
+    for (uint32_t compIdx = 0; compIdx < mModel->getComponentCount(); ++compIdx) {
+        const ControllerModelData::Component &comp = info.components[compIdx];
+        uint32_t ctrlerCompID = getCompIdxByName(comp.name);
         if (ctrlerCompID < E_TO_UINT(CtrlerComp_MaxCompNumber)) {
-            mCompMeshes[ctrlerCompID].createVertexBufferData(
-                VertexAttrib_Vertices,
-                (*mCachedData).compInfos.table[wvrCompID].vertices.buffer,
-                (*mCachedData).compInfos.table[wvrCompID].vertices.size,
-                (*mCachedData).compInfos.table[wvrCompID].vertices.dimension);
-
-            /* //don't use normal
-            mCompMeshes[ctrlerCompID].createVertexBufferData(
-                VertexAttrib_Normals,
-                (*mCachedData).compInfos.table[wvrCompID].normals.buffer,
-                (*mCachedData).compInfos.table[wvrCompID].normals.size,
-                (*mCachedData).compInfos.table[wvrCompID].normals.dimension);
-            */
-            
-            mCompMeshes[ctrlerCompID].createVertexBufferData(
-                VertexAttrib_TexCoords,
-                (*mCachedData).compInfos.table[wvrCompID].texCoords.buffer,
-                (*mCachedData).compInfos.table[wvrCompID].texCoords.size,
-                (*mCachedData).compInfos.table[wvrCompID].texCoords.dimension);
-            
-            mCompMeshes[ctrlerCompID].createIndexBufferData(
-                (*mCachedData).compInfos.table[wvrCompID].indices.buffer,
-                (*mCachedData).compInfos.table[wvrCompID].indices.size,
-                (*mCachedData).compInfos.table[wvrCompID].indices.type);
-
-            mCompMeshes[ctrlerCompID].createVAO();
+            mCompSlots[ctrlerCompID] = compIdx < mModel->getRaySlot() ? compIdx : ControllerModel::kNoSlot;
+
+            if (ctrlerCompID == CtrlerComp_Body) {
+                computeBodyBounds(mModel->getBounds(compIdx));
+            }
+
             //copy mat in ctrler space.
-            mCompLocalMats[ctrlerCompID].set((*mCachedData).compInfos.table[wvrCompID].localMat);
-            mCompTexID[ctrlerCompID] = (*mCachedData).compInfos.table[wvrCompID].texIndex;
+            mCompLocalMats[ctrlerCompID].set(comp.localMat);
+            mCompTexID[ctrlerCompID] = comp.texIndex;
             mCompExistFlags[ctrlerCompID] = true;
 
             if (ctrlerCompID == CtrlerComp_Emitter) {
                 mEmitterPose = mCompLocalMats[ctrlerCompID];
             }
         } else {
-            LOGI("(%d[%p]) : We can't find comp[%s] in legal names.", mCtrlerType, this, (*mCachedData).compInfos.table[wvrCompID].name);
+            LOGI("(%d[%p]) : We can't find comp[%s] in legal names.", mCtrlerType, this, comp.name.c_str());
         }
     }
 
@@ -388,170 +396,124 @@ void Controller::initializeCtrlerModelGLComp()
     }
 
     //1.2 calculate touchpad plane matrix.
-    mRadius = (*mCachedData).touchpadPlane.radius;
-    mFloatingDistance = (*mCachedData).touchpadPlane.floatingDistance;
+    mRadius = info.touchpadPlane.radius;
+    mFloatingDistance = info.touchpadPlane.floatingDistance;
 
-    mTouchPadPlaneMat[ 0] = (*mCachedData).touchpadPlane.u.v[0];
-    mTouchPadPlaneMat[ 1] = (*mCachedData).touchpadPlane.u.v[1];
-    mTouchPadPlaneMat[ 2] = (*mCachedData).touchpadPlane.u.v[2];
+    mTouchPadPlaneMat[ 0] = info.touchpadPlane.u.v[0];
+    mTouchPadPlaneMat[ 1] = info.touchpadPlane.u.v[1];
+    mTouchPadPlaneMat[ 2] = info.touchpadPlane.u.v[2];
     mTouchPadPlaneMat[ 3] = 0.0f;
     
-    mTouchPadPlaneMat[ 4] = (*mCachedData).touchpadPlane.v.v[0];
-    mTouchPadPlaneMat[ 5] = (*mCachedData).touchpadPlane.v.v[1];
-    mTouchPadPlaneMat[ 6] = (*mCachedData).touchpadPlane.v.v[2];
+    mTouchPadPlaneMat[ 4] = info.touchpadPlane.v.v[0];
+    mTouchPadPlaneMat[ 5] = info.touchpadPlane.v.v[1];
+    mTouchPadPlaneMat[ 6] = info.touchpadPlane.v.v[2];
     mTouchPadPlaneMat[ 7] = 0.0f;
 
-    mTouchPadPlaneMat[ 8] = (*mCachedData).touchpadPlane.w.v[0];
-    mTouchPadPlaneMat[ 9] = (*mCachedData).touchpadPlane.w.v[1];
-    mTouchPadPlaneMat[10] = (*mCachedData).touchpadPlane.w.v[2];
+    mTouchPadPlaneMat[ 8] = info.touchpadPlane.w.v[0];
+    mTouchPadPlaneMat[ 9] = info.touchpadPlane.w.v[1];
+    mTouchPadPlaneMat[10] = info.touchpadPlane.w.v[2];
     mTouchPadPlaneMat[11] = 0.0f;
 
-    mTouchPadPlaneMat[12] = (*mCachedData).touchpadPlane.center.v[0] + mFloatingDistance * mTouchPadPlaneMat[4];
-    mTouchPadPlaneMat[13] = (*mCachedData).touchpadPlane.center.v[1] + mFloatingDistance * mTouchPadPlaneMat[5];
-    mTouchPadPlaneMat[14] = (*mCachedData).touchpadPlane.center.v[2] + mFloatingDistance * mTouchPadPlaneMat[6];
+    mTouchPadPlaneMat[12] = info.touchpadPlane.center.v[0] + mFloatingDistance * mTouchPadPlaneMat[4];
+    mTouchPadPlaneMat[13] = info.touchpadPlane.center.v[1] + mFloatingDistance * mTouchPadPlaneMat[5];
+    mTouchPadPlaneMat[14] = info.touchpadPlane.center.v[2] + mFloatingDistance * mTouchPadPlaneMat[6];
     mTouchPadPlaneMat[15] = 1.0f;
 
-    mIsNeedRevertInputY = ((*mCachedData).touchpadPlane.valid == false);
-
-    //2. Initialize texture.
-    uint32_t wvrBitmapSize = (*mCachedData).bitmapInfos.size;
-    mTextureTable.resize(wvrBitmapSize);
-    LOGI("(%d[%p]): Initialize WVRTextures(%d)", mCtrlerType, this, wvrBitmapSize);
-    for (uint32_t texID = 0; texID < wvrBitmapSize; ++texID) {
-        mTextureTable[texID] = nullptr;
-        mTextureTable[texID] = Texture::loadTextureFromBitmapWithoutCached(
-            (*mCachedData).bitmapInfos.table[texID]);
-    }
-
-    //3. Intialize Battery Texture.
-    mBatLvTex.resize((*mCachedData).batteryLevels.size);
-    mBatMinLevels.resize((*mCachedData).batteryLevels.size);
-    mBatMaxLevels.resize((*mCachedData).batteryLevels.size);
-    for (uint32_t lv = 0; lv < (*mCachedData).batteryLevels.size; ++lv) {
-        mBatMinLevels[lv] = (*mCachedData).batteryLevels.minLvTable[lv];
-        mBatMaxLevels[lv] = (*mCachedData).batteryLevels.maxLvTable[lv];
-        if ((*mCachedData).batteryLevels.texTable[lv].bitmap != nullptr) {
-            mBatLvTex[lv] = Texture::loadTextureFromBitmapWithoutCached(
-                (*mCachedData).batteryLevels.texTable[lv]);
-        }
-    }
+    mIsNeedRevertInputY = (info.touchpadPlane.valid == false);
+
+    //2. Textures and battery levels are regions of mModel's atlas.
+    LOGI("(%d[%p]): Initialize WVRTextures(%u) battery levels(%u)", mCtrlerType, this,
+        mModel->getTextureCount(), mModel->getBatteryLevelCount());
+
+    //3. Pick up battery levels.
+    mBatMinLevels = info.batteryMinLevels;
+    mBatMaxLevels = info.batteryMaxLevels;
 
     LOGI("(%d[%p]): Initialize End!!!", mCtrlerType, this);
 }
 
-void Controller::drawCtrlerBody(CtrlerDrawModeEnum iMode, const Matrix4 iMVPs[CtrlerDrawMode_MaxModeMumber])
+void Controller::showSlot(uint32_t iSlot, const Matrix4 &iMat, bool iEffect, float iDepthBias)
 {
-    glEnable(GL_DEPTH_TEST);
-
-    uint32_t ctrlerCompID = CtrlerComp_Body;
-    Matrix4 finalMats[2];
-    uint32_t matNumber = 1;
-    std::vector<GLfloat> glMats;
-    if (iMode == CtrlerDrawMode_General) {
-        finalMats[0] = iMVPs[0] * mCompLocalMats[ctrlerCompID];
-        matNumber = 1;
-        glMats.resize(16);
-        memcpy(glMats.data(), finalMats[0].get(), 16 * sizeof(GLfloat));
-    } else {
-        finalMats[0] = iMVPs[0] * mCompLocalMats[ctrlerCompID];
-        finalMats[1] = iMVPs[1] * mCompLocalMats[ctrlerCompID];
-        matNumber = 2;
-        glMats.resize(32);
-        memcpy(glMats.data()     , finalMats[0].get(), 16 * sizeof(GLfloat));
-        memcpy(glMats.data() + 16, finalMats[1].get(), 16 * sizeof(GLfloat));
-    }
-
-    mTargetShader = mShaders[iMode].get();
-
-    if (mTargetShader != nullptr) {      
-        mTargetShader->useProgram();
-        if (mCompTexID[ctrlerCompID] >= 0 && mCompTexID[ctrlerCompID] < mTextureTable.size()) {
-            glUniformMatrix4fv(mMatrixLocations[iMode], matNumber, false, glMats.data());
-        
-            glActiveTexture(GL_TEXTURE0);
-            mTextureTable[mCompTexID[ctrlerCompID]]->bindTexture();
-            glUniform1i(mDiffTexLocations[iMode], 0);
-            glUniform1i(mUseEffectLocations[iMode], 0);
-            glUniform4f(mEffectColorLocations[iMode], 1.0f, 1.0f, 1.0f, 1.0f);
-            //
-            mCompMeshes[ctrlerCompID].draw();
-            //
-            mTextureTable[mCompTexID[ctrlerCompID]]->unbindTexture();
-        }
-        mTargetShader->unuseProgram();
+    if (iSlot == ControllerModel::kNoSlot) {
+        return;
     }
-
-    glDisable(GL_DEPTH_TEST);
+    memcpy(mSlotMatrices + iSlot * 16, iMat.get(), 16 * sizeof(float));
+    float *params = mSlotParams + iSlot * 4;
+    params[0] = 1.0f;
+    params[1] = iEffect ? 1.0f : 0.0f;
+    params[2] = iDepthBias;
 }
 
-void Controller::drawCtrlerBattery(CtrlerDrawModeEnum iMode, const Matrix4 iMVPs[CtrlerDrawMode_MaxModeMumber])
+void Controller::setSlotRegion(uint32_t iSlot, const AtlasPacker::Region &iRegion)
 {
-    if (mIsShowBattery == false || mCompExistFlags[CtrlerComp_Battery] == false) {
+    if (iSlot == ControllerModel::kNoSlot) {
         return;
     }
+    float *region = mSlotRegions + iSlot * 4;
+    region[0] = iRegion.u;
+    region[1] = iRegion.v;
+    region[2] = iRegion.width;
+    region[3] = iRegion.height;
+    mSlotParams[iSlot * 4 + 3] = static_cast<float>(iRegion.page);
+}
 
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFuncSeparate(
-        GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
-        GL_ONE, GL_ONE);
-
-    uint32_t ctrlerCompID = CtrlerComp_Battery;
-
-    Matrix4 finalMats[2];
-    uint32_t matNumber = 1;
-    std::vector<GLfloat> glMats;
-    if (iMode == CtrlerDrawMode_General) {
-        finalMats[0] = iMVPs[0] * mCompLocalMats[ctrlerCompID];
-        matNumber = 1;
-        glMats.resize(16);
-        memcpy(glMats.data(), finalMats[0].get(), 16 * sizeof(GLfloat));
-    } else {
-        finalMats[0] = iMVPs[0] * mCompLocalMats[ctrlerCompID];
-        finalMats[1] = iMVPs[1] * mCompLocalMats[ctrlerCompID];
-        matNumber = 2;
-        glMats.resize(32);
-        memcpy(glMats.data()     , finalMats[0].get(), 16 * sizeof(GLfloat));
-        memcpy(glMats.data() + 16, finalMats[1].get(), 16 * sizeof(GLfloat));
-    }
-
-    mTargetShader = mShaders[iMode].get();
-
-    if (mTargetShader != nullptr) {
-        if (mBatteryLevel >= 0 && mBatteryLevel < mBatLvTex.size()) {
-            if (mBatLvTex[mBatteryLevel] != nullptr) {
-                //draw.
-                mTargetShader->useProgram();
-                glUniformMatrix4fv(mMatrixLocations[iMode], matNumber, false, glMats.data());
-                glActiveTexture(GL_TEXTURE0);
-                mBatLvTex[mBatteryLevel]->bindTexture();
-                glUniform1i(mDiffTexLocations[iMode], 0);
-                glUniform1i(mUseEffectLocations[iMode], 0);
-                glUniform4f(mEffectColorLocations[iMode], 1.0f, 1.0f, 1.0f, 1.0f);
-                //
-                mCompMeshes[ctrlerCompID].draw();
-                //
-                mBatLvTex[mBatteryLevel]->unbindTexture();
-                mTargetShader->unuseProgram();
-            }
-        }
-    }
-
-    glBlendFuncSeparate(
-        GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
-        GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_BLEND);
+bool Controller::isBodyTextured() const
+{
+    const int32_t texID = mCompTexID[CtrlerComp_Body];
+    return texID >= 0 && (uint32_t) texID < mModel->getTextureCount() &&
+        mModel->getTextureRegion(texID).page != AtlasPacker::kNoPage;
 }
 
-void Controller::drawCtrlerTouchPad(CtrlerDrawModeEnum iMode, const Matrix4 iMVPs[CtrlerDrawMode_MaxModeMumber])
+void Controller::updateSlotConstants()
 {
-    glEnable(GL_DEPTH_TEST);
+    //Everything starts hidden.
+    memset(mSlotParams, 0, mModel->getBatchSlotCount() * 4 * sizeof(float));
+    mIsDotShown = false;
+    mIsBatteryShown = false;
+
+    //1. body.
+    if (isBodyTextured() == true) {
+        showSlot(mCompSlots[CtrlerComp_Body], mCompLocalMats[CtrlerComp_Body], false, 0.0f);
+        setSlotRegion(mCompSlots[CtrlerComp_Body], mModel->getTextureRegion(mCompTexID[CtrlerComp_Body]));
+    }
+
+    //2. battery, drawn on its own with the region of the level.
+    if (mIsShowBattery == true && mCompExistFlags[CtrlerComp_Battery] == true &&
+        mBatteryLevel >= 0 && (uint32_t) mBatteryLevel < mModel->getBatteryLevelCount() &&
+        mModel->getBatteryRegion(mBatteryLevel).page != AtlasPacker::kNoPage) {
+        showSlot(mCompSlots[CtrlerComp_Battery], mCompLocalMats[CtrlerComp_Battery], false, 0.0f);
+        setSlotRegion(mCompSlots[CtrlerComp_Battery], mModel->getBatteryRegion(mBatteryLevel));
+        mIsBatteryShown = (mCompSlots[CtrlerComp_Battery] == mModel->getBatterySlot());
+    }
+
+    //3. pressed buttons, pushed toward the eye so they cover the body.
+    for (uint32_t ctrlerCompID = CtrlerComp_AppButton; ctrlerCompID < CtrlerComp_MaxCompNumber; ++ctrlerCompID) {
+        //Don't draw non button effect.
+        if (ctrlerCompID == CtrlerComp_TouchPad_Touch ||
+            ctrlerCompID == CtrlerComp_BeamOrigin ||
+            ctrlerCompID == CtrlerComp_Emitter ||
+            ctrlerCompID == CtrlerComp_Battery) {
+            continue;
+        }
+        if (mCompStates[ctrlerCompID] == CtrlerBtnState_Pressed && mCompExistFlags[ctrlerCompID] == true) {
+            showSlot(mCompSlots[ctrlerCompID], mCompLocalMats[ctrlerCompID], true, sEffectDepthBias);
+        }
+    }
 
+    //4. touchpad, the dot where it is touched or the whole pad when pressed.
     if (mCompExistFlags[CtrlerComp_TouchPad] == true) {
         if (mCompStates[CtrlerComp_TouchPad] == CtrlerBtnState_Tapped && mCompExistFlags[CtrlerComp_TouchPad_Touch] == true) {
-            WVR_Axis_t axis = WVR_GetInputAnalogAxis(mCtrlerType, WVR_InputId_Alias1_Touchpad);
-            //1. calculate touchpad touch pos.
+            WVR_Axis_t axis = {0.0f, 0.0f};
+            if (mInput != nullptr) {
+                InputSystem::Axis touch;
+                if (mInput->getAxis(mCtrlerType, WVR_InputId_Alias1_Touchpad, touch) == true) {
+                    axis.x = touch.x;
+                    axis.y = touch.y;
+                }
+            } else {
+                axis = WVR_GetInputAnalogAxis(mCtrlerType, WVR_InputId_Alias1_Touchpad);
+            }
+            //4.1 calculate touchpad touch pos.
             float invAxisY = 1.0f;
             if (mIsNeedRevertInputY == true) {
                 invAxisY = -1.0f;
@@ -568,235 +530,118 @@ void Controller::drawCtrlerTouchPad(CtrlerDrawModeEnum iMode, const Matrix4 iMVP
             offsetMat[14] = Tp.z;
             offsetMat[15] = 1.0f;
 
-            Matrix4 dotFinalMat;
-            
-            //2. draw touchpad dot.
-            //2.1 find ctrler touchpad model.
-            uint32_t ctrlerCompID = 0;
-            ctrlerCompID = CtrlerComp_TouchPad_Touch;
-            Matrix4 touchpadDotRot = mCompLocalMats[ctrlerCompID];
+            //4.2 the dot keeps its own rotation on the touchpad plane.
+            Matrix4 touchpadDotRot = mCompLocalMats[CtrlerComp_TouchPad_Touch];
             touchpadDotRot[12] = 0.0f;
             touchpadDotRot[13] = 0.0f;
             touchpadDotRot[14] = 0.0f;
-            dotFinalMat = mTouchPadPlaneMat * offsetMat * touchpadDotRot;
-
-            Matrix4 finalMats[2];
-            uint32_t matNumber = 1;
-            std::vector<GLfloat> glMats;
-            if (iMode == CtrlerDrawMode_General) {
-                finalMats[0] = iMVPs[0] * dotFinalMat;
-                matNumber = 1;
-                glMats.resize(16);
-                memcpy(glMats.data(), finalMats[0].get(), 16 * sizeof(GLfloat));
-            } else {
-                finalMats[0] = iMVPs[0] * dotFinalMat;
-                finalMats[1] = iMVPs[1] * dotFinalMat;
-                matNumber = 2;
-                glMats.resize(32);
-                memcpy(glMats.data()     , finalMats[0].get(), 16 * sizeof(GLfloat));
-                memcpy(glMats.data() + 16, finalMats[1].get(), 16 * sizeof(GLfloat));
-            }
-
-            mTargetShader = mShaders[iMode].get();
-
-            //2.2 draw.
-            glDisable(GL_CULL_FACE);
-            mTargetShader->useProgram();
-            if (mCompTexID[ctrlerCompID] >= 0 && mCompTexID[ctrlerCompID] < mTextureTable.size()) {
-                glUniformMatrix4fv(mMatrixLocations[iMode], matNumber, false, glMats.data());
-
-                glActiveTexture(GL_TEXTURE0);
-                mTextureTable[mCompTexID[ctrlerCompID]]->bindTexture();
-                glUniform1i(mDiffTexLocations[iMode], 0);
-                glUniform1i(mUseEffectLocations[iMode], 1);
-                glUniform4f(mEffectColorLocations[iMode], mBtnEffect[0], mBtnEffect[1], mBtnEffect[2], mBtnEffect[3]);
-                //
-                mCompMeshes[ctrlerCompID].draw();
-                //
-                mTextureTable[mCompTexID[ctrlerCompID]]->unbindTexture();
-            }
-            mTargetShader->unuseProgram();
-            glEnable(GL_CULL_FACE);
-
+            showSlot(mCompSlots[CtrlerComp_TouchPad_Touch], mTouchPadPlaneMat * offsetMat * touchpadDotRot, true, 0.0f);
+            mIsDotShown = (mCompSlots[CtrlerComp_TouchPad_Touch] != ControllerModel::kNoSlot);
         } else if (mCompStates[CtrlerComp_TouchPad] == CtrlerBtnState_Pressed) {
-            glEnable(GL_POLYGON_OFFSET_FILL);
-            glPolygonOffset(0.0f, -100.0f); // -100.0 units means push the depth forward 100 units.
-
-            uint32_t ctrlerCompID = CtrlerComp_TouchPad;
-            
-            Matrix4 finalMats[2];
-            uint32_t matNumber = 1;
-            std::vector<GLfloat> glMats;
-            if (iMode == CtrlerDrawMode_General) {
-                finalMats[0] = iMVPs[0] * mCompLocalMats[ctrlerCompID];
-                matNumber = 1;
-                glMats.resize(16);
-                memcpy(glMats.data(), finalMats[0].get(), 16 * sizeof(GLfloat));
-            } else {
-                finalMats[0] = iMVPs[0] * mCompLocalMats[ctrlerCompID];
-                finalMats[1] = iMVPs[1] * mCompLocalMats[ctrlerCompID];
-                matNumber = 2;
-                glMats.resize(32);
-                memcpy(glMats.data()     , finalMats[0].get(), 16 * sizeof(GLfloat));
-                memcpy(glMats.data() + 16, finalMats[1].get(), 16 * sizeof(GLfloat));
-            }
-
-            mTargetShader = mShaders[iMode].get();
-            if (mTargetShader != nullptr) {
-                mTargetShader->useProgram();
-                if (mCompTexID[ctrlerCompID] >= 0 && mCompTexID[ctrlerCompID] < mTextureTable.size()) {
-                    glUniformMatrix4fv(mMatrixLocations[iMode], matNumber, false, glMats.data());
-
-                    glActiveTexture(GL_TEXTURE0);
-                    mTextureTable[mCompTexID[ctrlerCompID]]->bindTexture();
-                    glUniform1i(mDiffTexLocations[iMode], 0);
-                    glUniform1i(mUseEffectLocations[iMode], 1);
-                    glUniform4f(mEffectColorLocations[iMode], mBtnEffect[0], mBtnEffect[1], mBtnEffect[2], mBtnEffect[3]);
-                    //
-                    mCompMeshes[ctrlerCompID].draw();
-                    //
-                    mTextureTable[mCompTexID[ctrlerCompID]]->unbindTexture();
-                }
-                mTargetShader->unuseProgram();
-            }
-
-            glDisable(GL_POLYGON_OFFSET_FILL);
+            showSlot(mCompSlots[CtrlerComp_TouchPad], mCompLocalMats[CtrlerComp_TouchPad], true, sEffectDepthBias);
         }
     }
 
-    glDisable(GL_DEPTH_TEST);
+    //5. ray.
+    showSlot(mModel->getRaySlot(), mEmitterPose, true, 0.0f);
 }
 
-void Controller::drawCtrlerButtonEffect(CtrlerDrawModeEnum iMode, const Matrix4 iMVPs[CtrlerDrawMode_MaxModeMumber])
+void Controller::drawCtrlerBatch(CtrlerDrawModeEnum iMode, const Matrix4 iMVPs[CtrlerDrawMode_MaxModeMumber])
 {
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_POLYGON_OFFSET_FILL);
-    glPolygonOffset(0.0f, -100.0f); // -100.0 units means push the depth forward 100 units.
-
-	for (uint32_t ctrlerCompID = CtrlerComp_AppButton; ctrlerCompID < CtrlerComp_MaxCompNumber; ++ctrlerCompID) {
-		//Don't draw non button effect.
-		if (ctrlerCompID == CtrlerComp_TouchPad_Touch ||
-			ctrlerCompID == CtrlerComp_BeamOrigin ||
-			ctrlerCompID == CtrlerComp_Emitter ||
-			ctrlerCompID == CtrlerComp_Battery) {
-			    continue;
-			}
-        if (mCompStates[ctrlerCompID] == CtrlerBtnState_Pressed && mCompExistFlags[ctrlerCompID] == true) {
-            Matrix4 finalMats[2];
-            uint32_t matNumber = 1;
-            std::vector<GLfloat> glMats;
-            if (iMode == CtrlerDrawMode_General) {
-                finalMats[0] = iMVPs[0] * mCompLocalMats[ctrlerCompID];
-                matNumber = 1;
-                glMats.resize(16);
-                memcpy(glMats.data(), finalMats[0].get(), 16 * sizeof(GLfloat));
-            } else {
-                finalMats[0] = iMVPs[0] * mCompLocalMats[ctrlerCompID];
-                finalMats[1] = iMVPs[1] * mCompLocalMats[ctrlerCompID];
-                matNumber = 2;
-                glMats.resize(32);
-                memcpy(glMats.data()     , finalMats[0].get(), 16 * sizeof(GLfloat));
-                memcpy(glMats.data() + 16, finalMats[1].get(), 16 * sizeof(GLfloat));
-            }
+    mTargetShader = mShaders[iMode].get();
+    if (mTargetShader == nullptr || mModel == nullptr) {
+        return;
+    }
 
-            mTargetShader = mShaders[iMode].get();
-
-            if (mTargetShader != nullptr) {
-                mTargetShader->useProgram();
-                glUniformMatrix4fv(mMatrixLocations[iMode], matNumber, false, glMats.data());
-                if (mCompTexID[ctrlerCompID] >= 0 && mCompTexID[ctrlerCompID] < mTextureTable.size()) {
-                    glActiveTexture(GL_TEXTURE0);
-                    mTextureTable[mCompTexID[ctrlerCompID]]->bindTexture();
-                    glUniform1i(mDiffTexLocations[iMode], 0);
-                    glUniform1i(mUseEffectLocations[iMode], 1);
-                    glUniform4f(mEffectColorLocations[iMode], mBtnEffect[0], mBtnEffect[1], mBtnEffect[2], mBtnEffect[3]);
-                    //
-                    mCompMeshes[ctrlerCompID].draw();
-                    //
-                    mTextureTable[mCompTexID[ctrlerCompID]]->unbindTexture();
-                }
-                mTargetShader->unuseProgram();
-            }
-        }
+    updateSlotConstants();
+
+    uint32_t matNumber = 1;
+    GLfloat glMats[32];
+    memcpy(glMats, iMVPs[0].get(), 16 * sizeof(GLfloat));
+    if (iMode == CtrlerDrawMode_Multiview) {
+        memcpy(glMats + 16, iMVPs[1].get(), 16 * sizeof(GLfloat));
+        matNumber = 2;
     }
 
-    glDisable(GL_POLYGON_OFFSET_FILL);
-    glDisable(GL_DEPTH_TEST);
-}
+    const uint32_t slotCount = mModel->getBatchSlotCount();
+    const uint32_t lod = mLod.getLevel();
+    const GLenum indexType = mModel->getBatchIndexType();
+    const uint32_t indexSize = mModel->getBatchIndexSize();
 
-void Controller::drawCtrlerRay(CtrlerDrawModeEnum iMode, const Matrix4 iMVPs[CtrlerDrawMode_MaxModeMumber])
-{
     glEnable(GL_DEPTH_TEST);
 
-    Matrix4 finalMats[2];
-    uint32_t matNumber = 1;
-    std::vector<GLfloat> glMats;
-    if (iMode == CtrlerDrawMode_General) {
-        finalMats[0] = iMVPs[0] * mEmitterPose;
-        matNumber = 1;
-        glMats.resize(16);
-        memcpy(glMats.data(), finalMats[0].get(), 16 * sizeof(GLfloat));
+    mTargetShader->useProgram();
+    glUniformMatrix4fv(mMatrixLocations[iMode], matNumber, false, glMats);
+    glUniformMatrix4fv(mCompMatrixLocations[iMode], slotCount, false, mSlotMatrices);
+    glUniform4fv(mCompParamsLocations[iMode], slotCount, mSlotParams);
+    glUniform4fv(mCompRegionLocations[iMode], slotCount, mSlotRegions);
+    glUniform4f(mEffectColorLocations[iMode], mBtnEffect[0], mBtnEffect[1], mBtnEffect[2], mBtnEffect[3]);
+    glUniform1i(mDiffTexLocations[iMode], 0);
+    //One texture for the whole controller, battery included.
+    glActiveTexture(GL_TEXTURE0);
+    Texture *atlas = mModel->getAtlas();
+    if (atlas != nullptr) {
+        atlas->bindTextureArray();
+    }
+    glBindVertexArray(mModel->getBatchVAO());
+
+    //1. body, pressed buttons, touchpad and ray.
+    const ControllerModel::BatchRange &main = mModel->getMainRange(lod);
+    if (mIsDotShown == true && glIsEnabled(GL_CULL_FACE) == GL_TRUE) {
+        //The dot is single sided, so only its own range is drawn unculled.
+        const ControllerModel::BatchRange &dot = mModel->getBatchRange(lod, mCompSlots[CtrlerComp_TouchPad_Touch]);
+        const uint32_t dotEnd = dot.first + dot.count;
+        drawBatchRange(main.first, dot.first - main.first, indexType, indexSize);
+        glDisable(GL_CULL_FACE);
+        drawBatchRange(dot.first, dot.count, indexType, indexSize);
+        glEnable(GL_CULL_FACE);
+        drawBatchRange(dotEnd, main.first + main.count - dotEnd, indexType, indexSize);
     } else {
-        finalMats[0] = iMVPs[0] * mEmitterPose;
-        finalMats[1] = iMVPs[1] * mEmitterPose;
-        matNumber = 2;
-        glMats.resize(32);
-        memcpy(glMats.data()     , finalMats[0].get(), 16 * sizeof(GLfloat));
-        memcpy(glMats.data() + 16, finalMats[1].get(), 16 * sizeof(GLfloat));
+        drawBatchRange(main.first, main.count, indexType, indexSize);
     }
 
-    mTargetShader = mShaders[iMode].get();
-
-    if (mTargetShader != nullptr) {
-        mTargetShader->useProgram();
-        glUniformMatrix4fv(mMatrixLocations[iMode], matNumber, false, glMats.data());
-        glUniform1i(mDiffTexLocations[iMode], 0);
-        glUniform1i(mUseEffectLocations[iMode], 1);
-        glUniform4f(mEffectColorLocations[iMode], mBtnEffect[0], mBtnEffect[1], mBtnEffect[2], mBtnEffect[3]);
-        //
-        mRayMesh.draw();
-        //
-        mTargetShader->unuseProgram();
+    //2. battery, blended.
+    if (mIsBatteryShown == true) {
+        glEnable(GL_BLEND);
+        glBlendFuncSeparate(
+            GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
+            GL_ONE, GL_ONE);
+        const ControllerModel::BatchRange &battery = mModel->getBatchRange(lod, mModel->getBatterySlot());
+        drawBatchRange(battery.first, battery.count, indexType, indexSize);
+        glBlendFuncSeparate(
+            GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
+            GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glDisable(GL_BLEND);
     }
 
+    glBindVertexArray(0);
+    if (atlas != nullptr) {
+        atlas->unbindTextureArray();
+    }
+    mTargetShader->unuseProgram();
     glDisable(GL_DEPTH_TEST);
 }
 
 void Controller::releaseCtrlerModelGLComp()
 {
-    for (uint32_t ctrlerCompID = 0; ctrlerCompID < CtrlerComp_MaxCompNumber; ++ctrlerCompID) {
-        mCompMeshes[ctrlerCompID].releaseGLComp();
-    }
-    LOGI("(%d[%p]): release meshes done.", mCtrlerType, this);
-
-    for (uint32_t texID = 0; texID < mTextureTable.size(); ++texID) {
-        if (mTextureTable[texID] != nullptr) {
-            delete mTextureTable[texID];
-        }
-        mTextureTable[texID] = nullptr;
-    }
-    mTextureTable.clear();
-    LOGI("(%d[%p]): release texture done.", mCtrlerType, this);
-
+    //The meshes and textures go with the last controller holding the model.
     for (uint32_t compID = 0; compID < CtrlerComp_MaxCompNumber; ++compID) {
         mCompTexID[compID] = -1;
         mCompExistFlags[compID] = false;
         mCompStates[compID] = CtrlerBtnState_None;
+        mCompSlots[compID] = ControllerModel::kNoSlot;
     }
+    mIsDotShown = false;
+    mIsBatteryShown = false;
 
-    for (uint32_t lv = 0; lv < mBatLvTex.size(); ++lv) {
-        if (mBatLvTex[lv] != nullptr) {
-            delete mBatLvTex[lv];
-        }
-        mBatLvTex[lv] = nullptr;
-    }
-    mBatLvTex.clear();
-    mBatLvTex.shrink_to_fit();
     mBatMinLevels.clear();
     mBatMinLevels.shrink_to_fit();
     mBatMaxLevels.clear();
     mBatMaxLevels.shrink_to_fit();
-    LOGI("(%d[%p]): release battery done.", mCtrlerType, this);
+    mBodyRadius = 0.0f;
+
+    mModel.reset();
+    LOGI("(%d[%p]): release model done.", mCtrlerType, this);
 }
 
 bool Controller::isThisCtrlerType(WVR_DeviceType iCtrlerType) const
@@ -809,6 +654,11 @@ WVR_DeviceType Controller::getCtrlerType() const
     return mCtrlerType;
 }
 
+void Controller::setInputSystem(const InputSystem *iInput)
+{
+    mInput = iInput;
+}
+
 void Controller::switchCtrlerType()
 {
     WVR_DeviceType oldType = mCtrlerType;
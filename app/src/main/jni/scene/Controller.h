@@ -1,7 +1,6 @@
 #pragma once
 
 #include <mutex>
-#include <thread>
 
 #include <wvr/wvr.h>
 #include <wvr/wvr_ctrller_render_model.h>
@@ -12,6 +11,10 @@
 #include "../object/Mesh.h"
 #include "../object/Texture.h"
 #include "../object/Shader.h"
+#include "../shared/LodSelector.h"
+#include "../shared/JobSystem.h"
+#include "../shared/InputSystem.h"
+#include "ControllerModel.h"
 
 enum CtrlerCompEnum
 {
@@ -56,6 +59,8 @@ class Controller
 {
 public:
     static const std::string sControllerCompNames[CtrlerComp_MaxCompNumber];
+    static const uint32_t sLodCount = 3;
+    static const float sLodThresholds[sLodCount - 1]; //projected body size, see LodSelector.
 public:
     explicit Controller(WVR_DeviceType iCtrlerType);
     ~Controller();
@@ -67,6 +72,8 @@ public:
     void refreshButtonStatus(const WVR_Event_t &iEvent);
     void handleDisconnected();
     WVR_DeviceType getCtrlerType() const;
+    //The touchpad dot follows iInput's axis instead of asking the runtime, nullptr asks the runtime.
+    void setInputSystem(const InputSystem *iInput);
 public:
     void setButtonEffectColor(float r, float g, float b, float a);
     void resetButtonEffects();
@@ -74,15 +81,18 @@ protected:
     void initializeGLComp();
     void releaseGLComp();
 protected:
-    void initializeCtrlerModelGLComp();//protected by mCachedDataMutex!!!
+    void startLoadingJob(const std::string &iRenderModelName);
+    void initializeCtrlerModelGLComp();//from mModel.
     void releaseCtrlerModelGLComp();
+    void computeBodyBounds(const AABB &iBounds);
     uint32_t getCompIdxByName(const std::string &iName) const;
 protected:
-    void drawCtrlerBody(CtrlerDrawModeEnum iMode, const Matrix4 iMVPs[CtrlerDrawMode_MaxModeMumber]);
-    void drawCtrlerBattery(CtrlerDrawModeEnum iMode, const Matrix4 iMVPs[CtrlerDrawMode_MaxModeMumber]);
-    void drawCtrlerButtonEffect(CtrlerDrawModeEnum iMode, const Matrix4 iMVPs[CtrlerDrawMode_MaxModeMumber]);
-    void drawCtrlerTouchPad(CtrlerDrawModeEnum iMode, const Matrix4 iMVPs[CtrlerDrawMode_MaxModeMumber]);
-    void drawCtrlerRay(CtrlerDrawModeEnum iMode, const Matrix4 iMVPs[CtrlerDrawMode_MaxModeMumber]);
+    //All of the controller with one program and one upload, see ControllerModel's batch.
+    void drawCtrlerBatch(CtrlerDrawModeEnum iMode, const Matrix4 iMVPs[CtrlerDrawMode_MaxModeMumber]);
+    void updateSlotConstants();
+    void showSlot(uint32_t iSlot, const Matrix4 &iMat, bool iEffect, float iDepthBias);
+    void setSlotRegion(uint32_t iSlot, const AtlasPacker::Region &iRegion);
+    bool isBodyTextured() const;
 protected:
     void refreshBatteryStatus();
 protected:
@@ -91,21 +101,26 @@ protected:
     int32_t mBatteryLevel;
     float mCalmDownTime;
 protected:
-    WVR_CtrlerModel_t *mCachedData;
+    std::unique_ptr<ControllerModelData> mCachedData; //nullptr when the model is already in the pool.
+    std::string mCachedName;
     bool mIsDataReady;
     std::mutex mCachedDataMutex;
     std::mutex mLoadingThreadMutex; //**** IMPORTANT : only can used in lambda function in loadModelAsync
     bool mInitialized;
     WVR_DeviceType mCtrlerType;
-    std::thread mLoadModelFuncThread;
+    JobSystem::Counter mLoadModelJob;
 protected: //component
     bool mCompExistFlags[CtrlerComp_MaxCompNumber];
-    Mesh mCompMeshes[CtrlerComp_MaxCompNumber];
+    std::shared_ptr<ControllerModel> mModel; //shared with the other controller of the same model.
+    uint32_t mCompSlots[CtrlerComp_MaxCompNumber]; //in mModel's batch, ControllerModel::kNoSlot if absent.
     int32_t mCompTexID[CtrlerComp_MaxCompNumber];
     Matrix4 mCompLocalMats[CtrlerComp_MaxCompNumber];
     CtrlerBtnStateEnum mCompStates[CtrlerComp_MaxCompNumber];
+protected: //level of detail, chosen from the body's bounding sphere.
+    LodSelector mLod;
+    Vector3 mBodyCenter;
+    float mBodyRadius;
 protected: //battery
-    std::vector<Texture*> mBatLvTex;
     std::vector<int32_t> mBatMinLevels;
     std::vector<int32_t> mBatMaxLevels;
     std::chrono::system_clock::time_point mLastUpdateTime;
@@ -118,20 +133,28 @@ protected: //touchpad plane matrix
     Vector4 mTouchPadDotOffset;
     float mTouchpadSacleFactor;
     bool mIsNeedRevertInputY;
+    const InputSystem *mInput;
 protected:
     Matrix4 mEmitterPose;
-    Mesh mRayMesh;
+protected: //per slot constants of the batch draw.
+    float mSlotMatrices[ControllerModel::kMaxBatchSlots * 16];
+    float mSlotParams[ControllerModel::kMaxBatchSlots * 4]; //shown, effect, depth bias, atlas page.
+    float mSlotRegions[ControllerModel::kMaxBatchSlots * 4]; //atlas offset and scale.
+    bool mIsDotShown;
+    bool mIsBatteryShown;
 protected: //shader
-    std::vector<Texture*> mTextureTable;
     Shader *mTargetShader;
     std::shared_ptr<Shader> mShaders[CtrlerDrawMode_MaxModeMumber];
     int32_t mDiffTexLocations[CtrlerDrawMode_MaxModeMumber];
     int32_t mMatrixLocations[CtrlerDrawMode_MaxModeMumber];
-    int32_t mUseEffectLocations[CtrlerDrawMode_MaxModeMumber];
+    int32_t mCompMatrixLocations[CtrlerDrawMode_MaxModeMumber];
+    int32_t mCompParamsLocations[CtrlerDrawMode_MaxModeMumber];
+    int32_t mCompRegionLocations[CtrlerDrawMode_MaxModeMumber];
     int32_t mEffectColorLocations[CtrlerDrawMode_MaxModeMumber];
     std::string mCurrentRenderModelName;
 protected:
     Matrix4 mShift;
 public:
     Matrix4 getEmitterPose();
+    uint32_t getLodLevel() const;
 };
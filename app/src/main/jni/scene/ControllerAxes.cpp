@@ -16,6 +16,7 @@
 #include <VertexArrayObject.h>
 #include <GLES3/gl31.h>
 #include <ControllerAxes.h>
+#include <RenderStats.h>
 
 ControllerAxes::ControllerAxes() : Object() {
     mName = LOG_TAG;
@@ -150,6 +151,7 @@ void ControllerAxes::draw(const Matrix4& projection, const Matrix4& eye, const M
     glUniformMatrix4fv(mMatrix, 1, false, matrix.get());
     mVAO->bindVAO();
     glDrawArrays(GL_TRIANGLES, 0, mVertCount);
+    RenderStats::addDraw(mVertCount / 3);
 
     mVAO->unbindVAO();
     mShader->unuseProgram();
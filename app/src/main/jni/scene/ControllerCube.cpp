@@ -18,6 +18,7 @@
 #include <GLES2/gl2ext.h>
 #include <GLES3/gl31.h>
 #include <ControllerCube.h>
+#include <RenderStats.h>
 
 //-----------------------------------------------------------------------------
 // Purpose: Create/destroy GL Render Models
@@ -69,6 +70,7 @@ void ControllerCube::initCubes() {
     index = addCubeToScene(mat, vertdataarray, index, indexarray);
     if (indexarray.size() == 0)
         return;
+    setLocalBounds(AABB(Vector3(-0.5f, -0.5f, -0.5f) * scale, Vector3(0.5f, 0.5f, 0.5f) * scale));
 
     mVAO->bindVAO();
 
@@ -212,9 +214,10 @@ void ControllerCube::draw(const Matrix4& projection, const Matrix4& eye, const M
     if (!mEnable || mHasError || !mVAO || !mTexture)
         return;
 
-    Matrix4 matrix = projection * eye * view * getTransforms();
+    const Matrix4 world = getTransforms();
+    Matrix4 matrix = projection * eye * view * world;
     if (!m3DOF)
-        mNormalMatrix = makeNormalMatrix(getTransforms());
+        mNormalMatrix = mGraph != NULL ? getWorldNormalMatrix() : makeNormalMatrix(world);
 
     mShader->useProgram();
     glUniformMatrix4fv(mMatrixLocation, 1, false, matrix.get());
@@ -224,6 +227,7 @@ void ControllerCube::draw(const Matrix4& projection, const Matrix4& eye, const M
     glActiveTexture(GL_TEXTURE0);
     mTexture->bindTexture();
     glDrawElements(GL_TRIANGLES, mTrianglesX3, GL_UNSIGNED_INT, 0);
+    RenderStats::addDraw(mTrianglesX3 / 3);
 
     mShader->unuseProgram();
     mTexture->unbindTexture();
@@ -46,10 +46,11 @@ public:
         return mDeviceType;
     }
 
+    static int addCubeToScene(const Matrix4& mat, std::vector<float>& vertdata, int idx_start, std::vector<uint32_t>& indexdata);
+
 private:
     void initCubes();
     void initTexture();
-    static int addCubeToScene(const Matrix4& mat, std::vector<float>& vertdata, int idx_start, std::vector<uint32_t>& indexdata);
     static void addCubeVertex(const Vector4& v, float t0, float t1, const Vector3& n, std::vector<float>& vertdata);
 
 };
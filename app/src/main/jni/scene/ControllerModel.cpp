@@ -0,0 +1,869 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#define LOG_TAG "APCtrlerModel"
+
+#include <stdio.h>
+#include <string.h>
+#include <android/bitmap.h>
+
+#include <log.h>
+
+#include "ControllerModel.h"
+#include "../object/Mesh.h"
+#include "../object/Texture.h"
+
+namespace {
+
+const uint8_t kMagic[4] = { 'H', 'V', 'C', 'M' };
+
+// Drawn on its own, blended, so it goes last in the batch.
+const char *kBatteryComponent = "__CM__Battery";
+
+// Batch vertices: position, texture coordinate, slot.
+const uint32_t kBatchFloats = 6;
+
+// Texels repeated around every atlas region, for linear filtering.
+const uint32_t kAtlasPadding = 1;
+const uint32_t kAtlasMinPageSize = 256;
+const uint32_t kAtlasMaxPageSize = 2048;
+
+// The pointer ray, a thin pyramid from the emitter 3m down -z.
+const float kRayHalfWidth = 0.00125f;
+const float kRayVertices[15] = {
+     kRayHalfWidth,  kRayHalfWidth, -0.003f,
+    -kRayHalfWidth,  kRayHalfWidth, -0.003f,
+    -kRayHalfWidth, -kRayHalfWidth, -0.003f,
+     kRayHalfWidth, -kRayHalfWidth, -0.003f,
+    0.0f, 0.0f, -3.0f
+};
+const uint32_t kRayIndices[18] = {
+    0, 1, 2,
+    0, 2, 3,
+    0, 4, 1,
+    0, 3, 4,
+    2, 4, 3,
+    1, 4, 2
+};
+
+void appendBatchVertices(const float *iPositions, uint32_t iPositionDimension,
+    const float *iTexCoords, uint32_t iTexCoordDimension, uint32_t iTexCoordCount,
+    uint32_t iCount, uint32_t iSlot, std::vector<float> &oVertices)
+{
+    for (uint32_t v = 0; v < iCount; ++v) {
+        const float *p = iPositions + v * iPositionDimension;
+        oVertices.push_back(p[0]);
+        oVertices.push_back(p[1]);
+        oVertices.push_back(p[2]);
+        if (v < iTexCoordCount && iTexCoordDimension >= 2) {
+            oVertices.push_back(iTexCoords[v * iTexCoordDimension]);
+            oVertices.push_back(iTexCoords[v * iTexCoordDimension + 1]);
+        } else {
+            oVertices.push_back(0.0f);
+            oVertices.push_back(0.0f);
+        }
+        oVertices.push_back(static_cast<float>(iSlot));
+    }
+}
+
+// Host order, which is little endian on every target we build.
+class Writer {
+public:
+    explicit Writer(std::vector<uint8_t> &out) : mOut(out) {}
+
+    void bytes(const void *data, size_t size) {
+        const uint8_t *p = (const uint8_t *) data;
+        mOut.insert(mOut.end(), p, p + size);
+    }
+
+    void u32(uint32_t v) { bytes(&v, sizeof(v)); }
+    void u64(uint64_t v) { bytes(&v, sizeof(v)); }
+    void i32(int32_t v) { bytes(&v, sizeof(v)); }
+    void f32(float v) { bytes(&v, sizeof(v)); }
+
+    void str(const std::string &s) {
+        u32((uint32_t) s.size());
+        bytes(s.data(), s.size());
+    }
+
+    template <typename T>
+    void array(const std::vector<T> &v) {
+        u32((uint32_t) v.size());
+        bytes(v.data(), v.size() * sizeof(T));
+    }
+
+private:
+    std::vector<uint8_t> &mOut;
+};
+
+// Every read past the end fails the reader and returns zeros.
+class Reader {
+public:
+    Reader(const uint8_t *data, size_t size) : mData(data), mSize(size), mOffset(0), mFailed(false) {}
+
+    bool bytes(void *data, size_t size) {
+        if (mFailed || size > mSize - mOffset) {
+            mFailed = true;
+            memset(data, 0, size);
+            return false;
+        }
+        memcpy(data, mData + mOffset, size);
+        mOffset += size;
+        return true;
+    }
+
+    uint32_t u32() { uint32_t v; bytes(&v, sizeof(v)); return v; }
+    uint64_t u64() { uint64_t v; bytes(&v, sizeof(v)); return v; }
+    int32_t i32() { int32_t v; bytes(&v, sizeof(v)); return v; }
+    float f32() { float v; bytes(&v, sizeof(v)); return v; }
+
+    void str(std::string &s) {
+        uint32_t n = u32();
+        if (mFailed || n > mSize - mOffset) {
+            mFailed = true;
+            s.clear();
+            return;
+        }
+        s.assign((const char *) mData + mOffset, n);
+        mOffset += n;
+    }
+
+    template <typename T>
+    void array(std::vector<T> &v) {
+        uint32_t n = u32();
+        if (mFailed || n > (mSize - mOffset) / sizeof(T)) {
+            mFailed = true;
+            v.clear();
+            return;
+        }
+        v.resize(n);
+        bytes(v.data(), n * sizeof(T));
+    }
+
+    bool failed() const { return mFailed; }
+    bool atEnd() const { return mOffset == mSize; }
+
+private:
+    const uint8_t *mData;
+    size_t mSize;
+    size_t mOffset;
+    bool mFailed;
+};
+
+// FNV-1a, 64 bit.
+uint64_t hashBytes(uint64_t iHash, const void *iData, size_t iSize) {
+    const uint8_t *p = (const uint8_t *) iData;
+    for (size_t i = 0; i < iSize; ++i) {
+        iHash = (iHash ^ p[i]) * 1099511628211ULL;
+    }
+    return iHash;
+}
+
+bool copyBitmap(const WVR_CtrlerTexBitmap_t &iBitmap, ControllerModelData::Bitmap &oBitmap) {
+    oBitmap.width = 0;
+    oBitmap.height = 0;
+    oBitmap.pixels.clear();
+    if (iBitmap.bitmap == nullptr) {
+        return true;
+    }
+    if (iBitmap.format != ANDROID_BITMAP_FORMAT_RGBA_8888 || iBitmap.stride < iBitmap.width * 4) {
+        LOGW("We only support RGBA8888.format(%d) stride(%u)", iBitmap.format, iBitmap.stride);
+        return false;
+    }
+    const uint32_t row = iBitmap.width * 4;
+    oBitmap.width = iBitmap.width;
+    oBitmap.height = iBitmap.height;
+    oBitmap.pixels.resize(row * iBitmap.height);
+    for (uint32_t y = 0; y < iBitmap.height; ++y) {
+        memcpy(&oBitmap.pixels[y * row], iBitmap.bitmap + y * iBitmap.stride, row);
+    }
+    return true;
+}
+
+void writeBitmap(Writer &w, const ControllerModelData::Bitmap &iBitmap) {
+    w.u32(iBitmap.width);
+    w.u32(iBitmap.height);
+    w.array(iBitmap.pixels);
+}
+
+bool readBitmap(Reader &r, ControllerModelData::Bitmap &oBitmap) {
+    oBitmap.width = r.u32();
+    oBitmap.height = r.u32();
+    r.array(oBitmap.pixels);
+    return !r.failed() && (oBitmap.pixels.empty() ||
+        oBitmap.pixels.size() == (size_t) oBitmap.width * oBitmap.height * 4);
+}
+
+bool isValidComponent(const ControllerModelData::Component &iComp) {
+    if (iComp.vertexDimension < 3 || iComp.vertices.size() % iComp.vertexDimension != 0) {
+        return false;
+    }
+    if (iComp.texCoordDimension == 0 || iComp.texCoords.size() % iComp.texCoordDimension != 0) {
+        return false;
+    }
+    if (iComp.lodFirsts.empty() || iComp.lodFirsts.size() != iComp.lodSizes.size()) {
+        return false;
+    }
+    for (size_t lod = 0; lod < iComp.lodFirsts.size(); ++lod) {
+        if (iComp.lodFirsts[lod] > iComp.indices.size() ||
+            iComp.lodSizes[lod] > iComp.indices.size() - iComp.lodFirsts[lod]) {
+            return false;
+        }
+    }
+    const uint32_t vertexCount = (uint32_t) (iComp.vertices.size() / iComp.vertexDimension);
+    for (size_t i = 0; i < iComp.indices.size(); ++i) {
+        if (iComp.indices[i] >= vertexCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Anything but letters, digits, dots and dashes becomes an underscore.
+std::string toFileName(const std::string &iName) {
+    std::string file = "ctrler_";
+    for (size_t i = 0; i < iName.size(); ++i) {
+        const char c = iName[i];
+        const bool keep = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+            c == '.' || c == '-';
+        file += keep ? c : '_';
+    }
+    return file + ".bin";
+}
+
+}  // namespace
+
+ControllerModelData::ControllerModelData()
+: lodCount(0)
+, sourceHash(0)
+{
+    memset(&touchpadPlane, 0, sizeof(touchpadPlane));
+}
+
+bool ControllerModelData::fromWVR(const std::string &iName, const WVR_CtrlerModel_t &iModel, uint32_t iLodCount)
+{
+    name = iName;
+    lodCount = iLodCount;
+    sourceHash = hashSource(iModel);
+    components.clear();
+    components.reserve(iModel.compInfos.size);
+    for (uint32_t i = 0; i < iModel.compInfos.size; ++i) {
+        const WVR_CtrlerCompInfo_t &info = iModel.compInfos.table[i];
+        if (info.vertices.buffer == nullptr || info.texCoords.buffer == nullptr || info.indices.buffer == nullptr) {
+            LOGW("Comp[%s] has no geometry, skip it.", info.name);
+            continue;
+        }
+        components.push_back(Component());
+        Component &comp = components.back();
+        comp.name = info.name;
+        comp.vertexDimension = info.vertices.dimension;
+        comp.vertices.assign(info.vertices.buffer, info.vertices.buffer + info.vertices.size);
+        comp.texCoordDimension = info.texCoords.dimension;
+        comp.texCoords.assign(info.texCoords.buffer, info.texCoords.buffer + info.texCoords.size);
+        comp.indexType = info.indices.type;
+        Mesh::buildLodIndices(info.indices.buffer, info.indices.size,
+            info.vertices.buffer, info.vertices.size, info.vertices.dimension, iLodCount,
+            comp.indices, comp.lodFirsts, comp.lodSizes);
+        comp.texIndex = info.texIndex;
+        memcpy(comp.localMat, info.localMat, sizeof(comp.localMat));
+        if (!isValidComponent(comp)) {
+            LOGE("Comp[%s] is malformed.", info.name);
+            return false;
+        }
+    }
+
+    bitmaps.resize(iModel.bitmapInfos.size);
+    for (uint32_t i = 0; i < iModel.bitmapInfos.size; ++i) {
+        if (!copyBitmap(iModel.bitmapInfos.table[i], bitmaps[i])) {
+            return false;
+        }
+    }
+
+    const WVR_BatteryLevelTable_t &battery = iModel.batteryLevels;
+    batteryBitmaps.resize(battery.size);
+    batteryMinLevels.resize(battery.size);
+    batteryMaxLevels.resize(battery.size);
+    for (uint32_t lv = 0; lv < battery.size; ++lv) {
+        batteryMinLevels[lv] = battery.minLvTable[lv];
+        batteryMaxLevels[lv] = battery.maxLvTable[lv];
+        if (!copyBitmap(battery.texTable[lv], batteryBitmaps[lv])) {
+            return false;
+        }
+    }
+
+    touchpadPlane = iModel.touchpadPlane;
+    return true;
+}
+
+uint64_t ControllerModelData::hashSource(const WVR_CtrlerModel_t &iModel)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint32_t i = 0; i < iModel.compInfos.size; ++i) {
+        const WVR_CtrlerCompInfo_t &info = iModel.compInfos.table[i];
+        const uint32_t sizes[3] = { info.vertices.size, info.texCoords.size, info.indices.size };
+        hash = hashBytes(hash, sizes, sizeof(sizes));
+        if (info.vertices.buffer != nullptr) {
+            hash = hashBytes(hash, info.vertices.buffer, info.vertices.size * sizeof(float));
+        }
+        if (info.texCoords.buffer != nullptr) {
+            hash = hashBytes(hash, info.texCoords.buffer, info.texCoords.size * sizeof(float));
+        }
+        if (info.indices.buffer != nullptr) {
+            hash = hashBytes(hash, info.indices.buffer, info.indices.size * sizeof(uint32_t));
+        }
+    }
+    return hash;
+}
+
+void ControllerModelData::serialize(std::vector<uint8_t> &oBytes) const
+{
+    oBytes.clear();
+    Writer w(oBytes);
+    w.bytes(kMagic, sizeof(kMagic));
+    w.u32(ControllerModel::kFileVersion);
+    w.str(name);
+    w.u32(lodCount);
+    w.u64(sourceHash);
+
+    w.u32((uint32_t) components.size());
+    for (size_t i = 0; i < components.size(); ++i) {
+        const Component &comp = components[i];
+        w.str(comp.name);
+        w.u32(comp.vertexDimension);
+        w.array(comp.vertices);
+        w.u32(comp.texCoordDimension);
+        w.array(comp.texCoords);
+        w.u32(comp.indexType);
+        w.array(comp.indices);
+        w.array(comp.lodFirsts);
+        w.array(comp.lodSizes);
+        w.i32(comp.texIndex);
+        w.bytes(comp.localMat, sizeof(comp.localMat));
+    }
+
+    w.u32((uint32_t) bitmaps.size());
+    for (size_t i = 0; i < bitmaps.size(); ++i) {
+        writeBitmap(w, bitmaps[i]);
+    }
+
+    w.u32((uint32_t) batteryBitmaps.size());
+    for (size_t lv = 0; lv < batteryBitmaps.size(); ++lv) {
+        w.i32(batteryMinLevels[lv]);
+        w.i32(batteryMaxLevels[lv]);
+        writeBitmap(w, batteryBitmaps[lv]);
+    }
+
+    const WVR_TouchPadPlane_t &p = touchpadPlane;
+    const WVR_Vector3f_t *axes[4] = { &p.u, &p.v, &p.w, &p.center };
+    for (uint32_t a = 0; a < 4; ++a) {
+        for (uint32_t i = 0; i < 3; ++i) {
+            w.f32(axes[a]->v[i]);
+        }
+    }
+    w.f32(p.floatingDistance);
+    w.f32(p.radius);
+    w.u32(p.valid ? 1 : 0);
+}
+
+bool ControllerModelData::deserialize(const uint8_t *iBytes, size_t iSize)
+{
+    Reader r(iBytes, iSize);
+    uint8_t magic[4];
+    r.bytes(magic, sizeof(magic));
+    if (r.failed() || memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        LOGW("Not a controller model file.");
+        return false;
+    }
+    const uint32_t version = r.u32();
+    if (version != ControllerModel::kFileVersion) {
+        LOGW("Controller model file version %u, expect %u.", version, ControllerModel::kFileVersion);
+        return false;
+    }
+    r.str(name);
+    lodCount = r.u32();
+    sourceHash = r.u64();
+
+    uint32_t count = r.u32();
+    components.clear();
+    for (uint32_t i = 0; i < count && !r.failed(); ++i) {
+        components.push_back(Component());
+        Component &comp = components.back();
+        r.str(comp.name);
+        comp.vertexDimension = r.u32();
+        r.array(comp.vertices);
+        comp.texCoordDimension = r.u32();
+        r.array(comp.texCoords);
+        comp.indexType = r.u32();
+        r.array(comp.indices);
+        r.array(comp.lodFirsts);
+        r.array(comp.lodSizes);
+        comp.texIndex = r.i32();
+        r.bytes(comp.localMat, sizeof(comp.localMat));
+        if (r.failed() || !isValidComponent(comp)) {
+            LOGW("Controller model file has a malformed comp[%u].", i);
+            return false;
+        }
+    }
+
+    count = r.u32();
+    bitmaps.clear();
+    for (uint32_t i = 0; i < count && !r.failed(); ++i) {
+        bitmaps.push_back(Bitmap());
+        if (!readBitmap(r, bitmaps.back())) {
+            return false;
+        }
+    }
+
+    count = r.u32();
+    batteryBitmaps.clear();
+    batteryMinLevels.clear();
+    batteryMaxLevels.clear();
+    for (uint32_t lv = 0; lv < count && !r.failed(); ++lv) {
+        batteryMinLevels.push_back(r.i32());
+        batteryMaxLevels.push_back(r.i32());
+        batteryBitmaps.push_back(Bitmap());
+        if (!readBitmap(r, batteryBitmaps.back())) {
+            return false;
+        }
+    }
+
+    WVR_TouchPadPlane_t &p = touchpadPlane;
+    WVR_Vector3f_t *axes[4] = { &p.u, &p.v, &p.w, &p.center };
+    for (uint32_t a = 0; a < 4; ++a) {
+        for (uint32_t i = 0; i < 3; ++i) {
+            axes[a]->v[i] = r.f32();
+        }
+    }
+    p.floatingDistance = r.f32();
+    p.radius = r.f32();
+    p.valid = r.u32() != 0;
+
+    if (r.failed() || !r.atEnd()) {
+        LOGW("Controller model file is truncated or has trailing data.");
+        return false;
+    }
+    return true;
+}
+
+bool ControllerModelData::save(const std::string &iPath) const
+{
+    std::vector<uint8_t> bytes;
+    serialize(bytes);
+    //Write aside and rename, so a reader never sees half a file.
+    const std::string tmpPath = iPath + ".tmp";
+    FILE *file = fopen(tmpPath.c_str(), "wb");
+    if (file == NULL) {
+        LOGW("Unable to write %s", tmpPath.c_str());
+        return false;
+    }
+    const bool written = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    if (fclose(file) != 0 || !written || rename(tmpPath.c_str(), iPath.c_str()) != 0) {
+        LOGW("Unable to write %s", iPath.c_str());
+        remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ControllerModelData::load(const std::string &iPath)
+{
+    FILE *file = fopen(iPath.c_str(), "rb");
+    if (file == NULL) {
+        return false;
+    }
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[16384];
+    size_t got;
+    while ((got = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + got);
+    }
+    const bool failed = ferror(file) != 0;
+    fclose(file);
+    if (failed) {
+        LOGW("Unable to read %s", iPath.c_str());
+        return false;
+    }
+    return deserialize(bytes.data(), bytes.size());
+}
+
+const uint32_t ControllerModel::kFileVersion;
+const uint32_t ControllerModel::kMaxBatchSlots;
+const uint32_t ControllerModel::kNoSlot;
+std::mutex ControllerModel::sPoolMutex;
+std::vector<std::weak_ptr<ControllerModel> > ControllerModel::sPool;
+std::mutex ControllerModel::sDirectoryMutex;
+std::string ControllerModel::sDirectory;
+
+ControllerModel::ControllerModel(const ControllerModelData &iData)
+: mName(iData.name)
+, mInfo(iData)
+, mBatchVAO(0)
+, mBatchBuffers{0, 0}
+, mBatchIndexType(GL_UNSIGNED_SHORT)
+, mBatchIndexSize(2)
+, mBatchLodCount(1)
+, mBatchSlotCount(1)
+, mBatterySlot(kNoSlot)
+, mAtlas(nullptr)
+{
+    LOGI("[%s]: upload %zu comps, %zu textures", mName.c_str(), iData.components.size(), iData.bitmaps.size());
+    mBounds.resize(iData.components.size());
+    for (size_t i = 0; i < iData.components.size(); ++i) {
+        const ControllerModelData::Component &comp = iData.components[i];
+        for (size_t v = 0; v + comp.vertexDimension <= comp.vertices.size(); v += comp.vertexDimension) {
+            mBounds[i].expand(Vector3(comp.vertices[v], comp.vertices[v + 1], comp.vertices[v + 2]));
+        }
+        ControllerModelData::Component &info = mInfo.components[i];
+        std::vector<float>().swap(info.vertices);
+        std::vector<float>().swap(info.texCoords);
+        std::vector<uint32_t>().swap(info.indices);
+    }
+    buildBatch(iData);
+    buildAtlas(iData);
+    for (size_t i = 0; i < mInfo.bitmaps.size(); ++i) {
+        std::vector<uint8_t>().swap(mInfo.bitmaps[i].pixels);
+    }
+    for (size_t lv = 0; lv < mInfo.batteryBitmaps.size(); ++lv) {
+        std::vector<uint8_t>().swap(mInfo.batteryBitmaps[lv].pixels);
+    }
+}
+
+ControllerModel::~ControllerModel()
+{
+    LOGI("[%s]: release", mName.c_str());
+    glDeleteVertexArrays(1, &mBatchVAO);
+    glDeleteBuffers(2, mBatchBuffers);
+    delete mAtlas;
+}
+
+void ControllerModel::buildAtlas(const ControllerModelData &iData)
+{
+    //1. every bitmap, then every battery level.
+    std::vector<const ControllerModelData::Bitmap *> bitmaps;
+    for (size_t i = 0; i < iData.bitmaps.size(); ++i) {
+        bitmaps.push_back(&iData.bitmaps[i]);
+    }
+    for (size_t lv = 0; lv < iData.batteryBitmaps.size(); ++lv) {
+        bitmaps.push_back(&iData.batteryBitmaps[lv]);
+    }
+    const uint32_t count = (uint32_t) bitmaps.size();
+    mTextureRegions.assign(iData.bitmaps.size(), AtlasPacker::noRegion());
+    mBatteryRegions.assign(iData.batteryBitmaps.size(), AtlasPacker::noRegion());
+
+    //2. start from pages just big enough for the largest bitmap, so nothing is scaled.
+    GLint maxSize = 0, maxLayers = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    uint32_t pageWidth = kAtlasMinPageSize, pageHeight = kAtlasMinPageSize;
+    std::vector<uint32_t> widths(count, 0), heights(count, 0);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (bitmaps[i]->pixels.empty()) {
+            continue;
+        }
+        widths[i] = bitmaps[i]->width;
+        heights[i] = bitmaps[i]->height;
+        const uint32_t w = (widths[i] + 2 * kAtlasPadding + 15) & ~15u;
+        const uint32_t h = (heights[i] + 2 * kAtlasPadding + 15) & ~15u;
+        if (w <= (uint32_t) maxSize && w > pageWidth) {
+            pageWidth = w;
+        }
+        if (h <= (uint32_t) maxSize && h > pageHeight) {
+            pageHeight = h;
+        }
+    }
+
+    //3. pack.  Empty bitmaps are skipped, too large ones are left out.
+    std::vector<uint32_t> packed;
+    std::vector<uint32_t> packedWidths, packedHeights;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (widths[i] > 0 && heights[i] > 0) {
+            packed.push_back(i);
+            packedWidths.push_back(widths[i]);
+            packedHeights.push_back(heights[i]);
+        }
+    }
+    if (packed.empty()) {
+        return;
+    }
+    const uint32_t maxPages = count < (uint32_t) maxLayers ? count : (uint32_t) maxLayers;
+    std::vector<AtlasPacker::Placement> placements(packed.size());
+    AtlasPacker packer(pageWidth, pageHeight, kAtlasPadding, maxPages);
+    bool fits = packer.addAll(packedWidths.data(), packedHeights.data(), (uint32_t) packed.size(), placements.data());
+
+    //   every layer has the page size, so a mostly empty overflow layer costs
+    //   a whole page.  Try pages larger by a quarter step at a time and keep
+    //   the smallest total.  A row stops once a single page of it costs more.
+    const uint32_t limit = (uint32_t) maxSize < kAtlasMaxPageSize ? (uint32_t) maxSize : kAtlasMaxPageSize;
+    const uint32_t minWidth = pageWidth, minHeight = pageHeight;
+    const uint32_t stepWidth = (minWidth / 4 + 15) & ~15u, stepHeight = (minHeight / 4 + 15) & ~15u;
+    uint64_t area = (uint64_t) pageWidth * pageHeight * packer.getPageCount();
+    std::vector<AtlasPacker::Placement> trialPlacements(packed.size());
+    for (uint32_t h = minHeight; h <= limit; h += stepHeight) {
+        if (fits && (uint64_t) minWidth * h >= area) {
+            break;
+        }
+        for (uint32_t w = minWidth; w <= limit; w += stepWidth) {
+            if (fits && (uint64_t) w * h >= area) {
+                break;
+            }
+            if (w == minWidth && h == minHeight) {
+                continue;
+            }
+            AtlasPacker trial(w, h, kAtlasPadding, maxPages);
+            const bool trialFits = trial.addAll(packedWidths.data(), packedHeights.data(), (uint32_t) packed.size(),
+                trialPlacements.data());
+            const uint64_t trialArea = (uint64_t) w * h * trial.getPageCount();
+            if ((trialFits && fits == false) || (trialFits == fits && trialArea < area)) {
+                packer = trial;
+                placements.swap(trialPlacements);
+                fits = trialFits;
+                area = trialArea;
+                pageWidth = w;
+                pageHeight = h;
+            }
+        }
+    }
+    if (fits == false) {
+        LOGW("[%s]: some bitmaps do not fit a %ux%u atlas", mName.c_str(), pageWidth, pageHeight);
+    }
+
+    //4. compose the pages and upload them at once.
+    const uint32_t pageCount = packer.getPageCount();
+    std::vector<uint8_t> pixels((size_t) pageWidth * pageHeight * 4 * pageCount, 0);
+    for (size_t k = 0; k < packed.size(); ++k) {
+        const uint32_t i = packed[k];
+        const AtlasPacker::Placement &placement = placements[k];
+        if (placement.page == AtlasPacker::kNoPage) {
+            continue;
+        }
+        uint8_t *page = pixels.data() + (size_t) placement.page * pageWidth * pageHeight * 4;
+        AtlasPacker::copyPadded(page, pageWidth, pageHeight, bitmaps[i]->pixels.data(), widths[i], heights[i],
+            placement, kAtlasPadding);
+        const AtlasPacker::Region region = packer.getRegion(placement, widths[i], heights[i]);
+        if (i < mTextureRegions.size()) {
+            mTextureRegions[i] = region;
+        } else {
+            mBatteryRegions[i - mTextureRegions.size()] = region;
+        }
+    }
+    mAtlas = Texture::createTextureArray(pixels.data(), pageWidth, pageHeight, pageCount);
+    LOGI("[%s]: atlas of %u %ux%u pages for %zu bitmaps, %.0f%% used", mName.c_str(), pageCount,
+        pageWidth, pageHeight, packed.size(), packer.getOccupancy() * 100.0f);
+}
+
+void ControllerModel::buildBatch(const ControllerModelData &iData)
+{
+    const uint32_t compCount = (uint32_t) iData.components.size();
+    const uint32_t drawn = compCount < kMaxBatchSlots - 1 ? compCount : kMaxBatchSlots - 1;
+    if (drawn < compCount) {
+        LOGW("[%s]: %u comps, only the first %u are drawn", mName.c_str(), compCount, drawn);
+    }
+    mBatchSlotCount = drawn + 1;
+    const uint32_t raySlot = getRaySlot();
+
+    //1. order: components, the ray, then the battery.
+    std::vector<uint32_t> order;
+    mBatterySlot = kNoSlot;
+    for (uint32_t slot = 0; slot < drawn; ++slot) {
+        if (mBatterySlot == kNoSlot && iData.components[slot].name == kBatteryComponent) {
+            mBatterySlot = slot;
+        } else {
+            order.push_back(slot);
+        }
+    }
+    order.push_back(raySlot);
+    if (mBatterySlot != kNoSlot) {
+        order.push_back(mBatterySlot);
+    }
+
+    //2. vertices, in slot order.
+    std::vector<float> vertices;
+    std::vector<uint32_t> baseVertex(mBatchSlotCount);
+    mBatchLodCount = 1;
+    for (uint32_t slot = 0; slot < mBatchSlotCount; ++slot) {
+        baseVertex[slot] = (uint32_t) (vertices.size() / kBatchFloats);
+        if (slot == raySlot) {
+            appendBatchVertices(kRayVertices, 3, nullptr, 0, 0, 5, slot, vertices);
+            continue;
+        }
+        const ControllerModelData::Component &comp = iData.components[slot];
+        const uint32_t count = (uint32_t) (comp.vertices.size() / comp.vertexDimension);
+        const uint32_t texCount = comp.texCoordDimension > 0 ? (uint32_t) (comp.texCoords.size() / comp.texCoordDimension) : 0;
+        appendBatchVertices(comp.vertices.data(), comp.vertexDimension, comp.texCoords.data(), comp.texCoordDimension,
+            texCount, count, slot, vertices);
+        if (comp.lodSizes.size() > mBatchLodCount) {
+            mBatchLodCount = (uint32_t) comp.lodSizes.size();
+        }
+    }
+    const uint32_t vertexCount = (uint32_t) (vertices.size() / kBatchFloats);
+
+    //3. indices per level, rebased since GLES 3.0 has no base vertex draws.
+    std::vector<uint32_t> indices;
+    mBatchRanges.resize(mBatchLodCount * (mBatchSlotCount + 1));
+    for (uint32_t lod = 0; lod < mBatchLodCount; ++lod) {
+        BatchRange *ranges = &mBatchRanges[lod * (mBatchSlotCount + 1)];
+        for (size_t i = 0; i < order.size(); ++i) {
+            const uint32_t slot = order[i];
+            const uint32_t *src = kRayIndices;
+            uint32_t count = 18;
+            if (slot != raySlot) {
+                const ControllerModelData::Component &comp = iData.components[slot];
+                const uint32_t level = lod < comp.lodSizes.size() ? lod : (uint32_t) comp.lodSizes.size() - 1;
+                src = comp.indices.data() + comp.lodFirsts[level];
+                count = comp.lodSizes[level];
+            }
+            ranges[slot].first = (uint32_t) indices.size();
+            ranges[slot].count = count;
+            for (uint32_t k = 0; k < count; ++k) {
+                indices.push_back(src[k] + baseVertex[slot]);
+            }
+        }
+        BatchRange &main = ranges[mBatchSlotCount];
+        main.first = ranges[order[0]].first;
+        main.count = ranges[raySlot].first + ranges[raySlot].count - main.first;
+    }
+
+    //4. upload.
+    glGenVertexArrays(1, &mBatchVAO);
+    glGenBuffers(2, mBatchBuffers);
+    glBindVertexArray(mBatchVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, mBatchBuffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBatchBuffers[1]);
+    if (vertexCount <= 0x10000) {
+        std::vector<uint16_t> shorts(indices.begin(), indices.end());
+        mBatchIndexType = GL_UNSIGNED_SHORT;
+        mBatchIndexSize = sizeof(uint16_t);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, shorts.size() * sizeof(uint16_t), shorts.data(), GL_STATIC_DRAW);
+    } else {
+        mBatchIndexType = GL_UNSIGNED_INT;
+        mBatchIndexSize = sizeof(uint32_t);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+    }
+    const GLsizei stride = kBatchFloats * sizeof(float);
+    glEnableVertexAttribArray(VertexAttrib_Vertices);
+    glVertexAttribPointer(VertexAttrib_Vertices, 3, GL_FLOAT, GL_FALSE, stride, (const void *) 0);
+    glEnableVertexAttribArray(VertexAttrib_TexCoords);
+    glVertexAttribPointer(VertexAttrib_TexCoords, 2, GL_FLOAT, GL_FALSE, stride, (const void *) (3 * sizeof(float)));
+    glEnableVertexAttribArray(VertexAttrib_Color);
+    glVertexAttribPointer(VertexAttrib_Color, 1, GL_FLOAT, GL_FALSE, stride, (const void *) (5 * sizeof(float)));
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    LOGI("[%s]: batch of %u slots, %u vertices, %zu indices over %u LODs", mName.c_str(),
+        mBatchSlotCount, vertexCount, indices.size(), mBatchLodCount);
+}
+
+std::shared_ptr<ControllerModel> ControllerModel::find(const std::string &iName)
+{
+    std::lock_guard<std::mutex> lock(sPoolMutex);
+    std::shared_ptr<ControllerModel> ret;
+    for (auto i = sPool.begin(); i != sPool.end();) {
+        std::shared_ptr<ControllerModel> model = i->lock();
+        if (model == nullptr) {
+            i = sPool.erase(i);
+            continue;
+        }
+        if (model->getName() == iName) {
+            ret = model;
+        }
+        ++i;
+    }
+    return ret;
+}
+
+std::shared_ptr<ControllerModel> ControllerModel::create(const ControllerModelData &iData)
+{
+    std::shared_ptr<ControllerModel> model = find(iData.name);
+    if (model != nullptr) {
+        return model;
+    }
+    model = std::make_shared<ControllerModel>(iData);
+    std::lock_guard<std::mutex> lock(sPoolMutex);
+    sPool.push_back(model);
+    return model;
+}
+
+bool ControllerModel::isLoaded(const std::string &iName)
+{
+    std::lock_guard<std::mutex> lock(sPoolMutex);
+    for (size_t i = 0; i < sPool.size(); ++i) {
+        std::shared_ptr<ControllerModel> model = sPool[i].lock();
+        if (model != nullptr && model->getName() == iName) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ControllerModel::setCacheDirectory(const std::string &iDirectory)
+{
+    std::lock_guard<std::mutex> lock(sDirectoryMutex);
+    sDirectory = iDirectory;
+}
+
+std::string ControllerModel::getCacheDirectory()
+{
+    std::lock_guard<std::mutex> lock(sDirectoryMutex);
+    return sDirectory;
+}
+
+std::string ControllerModel::getCachePath(const std::string &iName)
+{
+    std::string directory = getCacheDirectory();
+    if (directory.empty() || iName.empty()) {
+        return std::string();
+    }
+    if (directory[directory.size() - 1] != '/') {
+        directory += '/';
+    }
+    return directory + toFileName(iName);
+}
+
+bool ControllerModel::loadData(WVR_DeviceType iType, const std::string &iName, uint32_t iLodCount,
+        ControllerModelData &oData, bool *oFromDisk)
+{
+    if (oFromDisk != NULL) {
+        *oFromDisk = false;
+    }
+    //1. the runtime, which the disk cache is checked against.
+    WVR_CtrlerModel_t *model = nullptr;
+    WVR_Result result = WVR_GetCurrentControllerModel(iType, &model);
+    if (result != WVR_Success || model == nullptr) {
+        LOGI("[%s]: Load fail. Reason(%d)", iName.c_str(), result);
+        return false;
+    }
+
+    //2. the disk cache.  A file of another model, LOD setup or geometry is rewritten below.
+    const std::string path = getCachePath(iName);
+    if (!path.empty() && oData.load(path)) {
+        if (oData.name == iName && oData.lodCount == iLodCount &&
+            oData.sourceHash == ControllerModelData::hashSource(*model)) {
+            WVR_ReleaseControllerModel(&model);
+            LOGI("[%s]: loaded from %s", iName.c_str(), path.c_str());
+            if (oFromDisk != NULL) {
+                *oFromDisk = true;
+            }
+            return true;
+        }
+        LOGW("[%s]: %s is stale", iName.c_str(), path.c_str());
+    }
+
+    //3. copy and simplify.
+    const bool ok = oData.fromWVR(iName, *model, iLodCount);
+    WVR_ReleaseControllerModel(&model);
+    if (!ok) {
+        return false;
+    }
+    if (!path.empty()) {
+        oData.save(path);
+    }
+    return true;
+}
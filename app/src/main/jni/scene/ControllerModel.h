@@ -0,0 +1,241 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <wvr/wvr_ctrller_render_model.h>
+#include <wvr/wvr_device.h>
+
+#include "../shared/AtlasPacker.h"
+#include "../shared/BoundingVolume.h"
+
+class Texture;
+
+// CPU copy of a controller render model, with the level of detail index
+// lists already built.  It serializes to a flat little endian file, so a
+// reconnect or a relaunch reads it back instead of copying the runtime's
+// model and running the simplifier again.  The file keeps a hash of the
+// runtime's geometry, so a changed model is not taken for the cached one.
+struct ControllerModelData {
+    struct Component {
+        std::string name;
+        uint32_t vertexDimension;
+        std::vector<float> vertices;
+        uint32_t texCoordDimension;
+        std::vector<float> texCoords;
+        uint32_t indexType;
+        std::vector<uint32_t> indices;      // all levels, see Mesh::buildLodIndices
+        std::vector<uint32_t> lodFirsts;
+        std::vector<uint32_t> lodSizes;
+        int32_t texIndex;
+        float localMat[16];
+    };
+
+    // RGBA8888 without row padding.  Empty pixels mean no bitmap.
+    struct Bitmap {
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint8_t> pixels;
+    };
+
+    std::string name;
+    uint32_t lodCount;
+    uint64_t sourceHash;                    // hashSource() of the runtime's model
+    std::vector<Component> components;
+    std::vector<Bitmap> bitmaps;
+    std::vector<Bitmap> batteryBitmaps;
+    std::vector<int32_t> batteryMinLevels;
+    std::vector<int32_t> batteryMaxLevels;
+    WVR_TouchPadPlane_t touchpadPlane;
+
+    ControllerModelData();
+
+    // Copies the runtime's model and simplifies every component to iLodCount levels.
+    bool fromWVR(const std::string &iName, const WVR_CtrlerModel_t &iModel, uint32_t iLodCount);
+    // FNV-1a of the vertices, texture coordinates and indices of every component.
+    static uint64_t hashSource(const WVR_CtrlerModel_t &iModel);
+    void serialize(std::vector<uint8_t> &oBytes) const;
+    // Rejects data of another format version or with ranges out of bounds.
+    bool deserialize(const uint8_t *iBytes, size_t iSize);
+    bool save(const std::string &iPath) const;
+    bool load(const std::string &iPath);
+};
+
+// GPU copy of a render model, shared by every controller showing it.
+//
+// Every component and the pointer ray live in one vertex and index buffer.
+// Each vertex carries its slot, the component index or getRaySlot(), which
+// picks that component's matrix and flags in the ctrler shaders.  At every
+// level of detail the ranges follow component order, then the ray, then
+// the battery, so all but the battery is one contiguous draw.  Components
+// with fewer levels repeat their coarsest one.
+//
+// The bitmaps and battery levels are packed into one array texture.  The
+// vertices keep the model's own texture coordinates; the ctrler shaders map
+// them into a region per slot, so the battery changes level by changing its
+// region and a controller draws without rebinding textures.
+//
+// Models are looked up by render model name.  The pool only keeps weak
+// references, like Shader's, so a model goes away with the last controller
+// that holds it.  Creating and dropping models belongs to the GL thread.
+//
+// loadData() is the slow part and may run on a worker.  It asks the runtime
+// for the model, then reads the disk cache if the file matches it, or copies
+// and simplifies the model and writes the cache file.
+// The disk cache is off until setCacheDirectory() is given a directory.
+class ControllerModel {
+public:
+    static const uint32_t kFileVersion = 2;
+    // Matches the uniform arrays in the ctrler shaders.  Components past it are not drawn.
+    static const uint32_t kMaxBatchSlots = 32;
+    static const uint32_t kNoSlot = 0xFFFFFFFF;
+
+    struct BatchRange {
+        uint32_t first;     // in indices
+        uint32_t count;
+    };
+
+public:
+    explicit ControllerModel(const ControllerModelData &iData);
+    ~ControllerModel();
+
+    static std::shared_ptr<ControllerModel> find(const std::string &iName);
+    // Returns the model already in the pool when there is one.
+    static std::shared_ptr<ControllerModel> create(const ControllerModelData &iData);
+    static bool isLoaded(const std::string &iName);
+
+    static void setCacheDirectory(const std::string &iDirectory);
+    static std::string getCacheDirectory();
+    // Empty when the disk cache is off.
+    static std::string getCachePath(const std::string &iName);
+    // oFromDisk tells whether the copy and the simplifier were skipped.
+    static bool loadData(WVR_DeviceType iType, const std::string &iName, uint32_t iLodCount,
+            ControllerModelData &oData, bool *oFromDisk = NULL);
+
+    inline const std::string &getName() const {
+        return mName;
+    }
+
+    // The model without its vertex, index and pixel arrays, which live on the GPU.
+    inline const ControllerModelData &getInfo() const {
+        return mInfo;
+    }
+
+    inline uint32_t getComponentCount() const {
+        return (uint32_t) mInfo.components.size();
+    }
+
+    // Local bounds of a component's vertices.
+    inline const AABB &getBounds(uint32_t iIndex) const {
+        return mBounds[iIndex];
+    }
+
+    // Position at location 0, texture coordinate at 2 and slot at 3.
+    inline uint32_t getBatchVAO() const {
+        return mBatchVAO;
+    }
+
+    // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+    inline uint32_t getBatchIndexType() const {
+        return mBatchIndexType;
+    }
+
+    inline uint32_t getBatchIndexSize() const {
+        return mBatchIndexSize;
+    }
+
+    inline uint32_t getBatchLodCount() const {
+        return mBatchLodCount;
+    }
+
+    // Components and the ray, one past the last drawn component.
+    inline uint32_t getBatchSlotCount() const {
+        return mBatchSlotCount;
+    }
+
+    inline uint32_t getRaySlot() const {
+        return mBatchSlotCount - 1;
+    }
+
+    // kNoSlot when the model has no battery.
+    inline uint32_t getBatterySlot() const {
+        return mBatterySlot;
+    }
+
+    // iLod is clamped to the levels there are.
+    inline const BatchRange &getBatchRange(uint32_t iLod, uint32_t iSlot) const {
+        return mBatchRanges[clampLod(iLod) * (mBatchSlotCount + 1) + iSlot];
+    }
+
+    // Every slot but the battery.
+    inline const BatchRange &getMainRange(uint32_t iLod) const {
+        return mBatchRanges[clampLod(iLod) * (mBatchSlotCount + 1) + mBatchSlotCount];
+    }
+
+    // Every bitmap and battery level in one GL_TEXTURE_2D_ARRAY, NULL without bitmaps.
+    inline Texture *getAtlas() const {
+        return mAtlas;
+    }
+
+    inline uint32_t getTextureCount() const {
+        return (uint32_t) mTextureRegions.size();
+    }
+
+    // Where bitmap iIndex went in the atlas.  The page is AtlasPacker::kNoPage
+    // when the bitmap is empty or did not fit.
+    inline const AtlasPacker::Region &getTextureRegion(uint32_t iIndex) const {
+        return mTextureRegions[iIndex];
+    }
+
+    inline uint32_t getBatteryLevelCount() const {
+        return (uint32_t) mBatteryRegions.size();
+    }
+
+    inline const AtlasPacker::Region &getBatteryRegion(uint32_t iLevel) const {
+        return mBatteryRegions[iLevel];
+    }
+
+private:
+    ControllerModel(const ControllerModel &);
+    ControllerModel &operator=(const ControllerModel &);
+
+    void buildBatch(const ControllerModelData &iData);
+    void buildAtlas(const ControllerModelData &iData);
+
+    inline uint32_t clampLod(uint32_t iLod) const {
+        return iLod < mBatchLodCount ? iLod : mBatchLodCount - 1;
+    }
+
+    std::string mName;
+    ControllerModelData mInfo;
+    std::vector<AABB> mBounds;
+    uint32_t mBatchVAO;
+    uint32_t mBatchBuffers[2];              // vertices, indices
+    uint32_t mBatchIndexType;
+    uint32_t mBatchIndexSize;
+    uint32_t mBatchLodCount;
+    uint32_t mBatchSlotCount;
+    uint32_t mBatterySlot;
+    std::vector<BatchRange> mBatchRanges;   // per level: one per slot, then the main range
+    Texture *mAtlas;
+    std::vector<AtlasPacker::Region> mTextureRegions;
+    std::vector<AtlasPacker::Region> mBatteryRegions;
+
+    static std::mutex sPoolMutex;
+    static std::vector<std::weak_ptr<ControllerModel> > sPool;
+    static std::mutex sDirectoryMutex;
+    static std::string sDirectory;
+};
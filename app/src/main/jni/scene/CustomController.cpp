@@ -1,5 +1,6 @@
 #define LOG_TAG "APCustomCtrler"
 
+#include <string.h>
 #include <functional>
 
 #include <log.h>
@@ -19,6 +20,7 @@ CustomController::CustomController(WVR_DeviceType iCtrlerType)
 CustomController::~CustomController()
 {
     LOGI("(%d) dtor!!", mCtrlerType);
+    JobSystem::getInstance().wait(mGetEmitterJob);
     mInitialized = false;
     releaseGLComp();
 }
@@ -39,11 +41,8 @@ void CustomController::loadControllerEmitterAsync()
         mLoadingThreadMutex.unlock();
     };
 
-    LOGI("(%d): Trigger Getting Emitter Thread", mCtrlerType);
-    if (mGetEmitterFuncThread.joinable() == true) {
-        mGetEmitterFuncThread.detach();
-    }
-    mGetEmitterFuncThread = std::thread(getEmitterFunc);
+    LOGI("(%d): Trigger Getting Emitter Job", mCtrlerType);
+    JobSystem::getInstance().runBackground(getEmitterFunc, &mGetEmitterJob);
 }
 
 void CustomController::initializeGLComp()
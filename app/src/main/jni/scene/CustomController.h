@@ -1,7 +1,6 @@
 #pragma once
 
 #include <mutex>
-#include <thread>
 
 #include "Controller.h"
 
@@ -24,7 +23,7 @@ protected:
 protected:
     bool mInitialized;
     WVR_DeviceType mCtrlerType;
-    std::thread mGetEmitterFuncThread;
+    JobSystem::Counter mGetEmitterJob;
     std::mutex mLoadingThreadMutex; //**** IMPORTANT : only can used in lambda function in loadControllerEmitterAsync
 protected:
     Mesh mCustomMesh;
@@ -0,0 +1,219 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#define LOG_TAG "Environment"
+#include <log.h>
+#include <Context.h>
+#include <Texture.h>
+#include <RenderStats.h>
+#include <Environment.h>
+
+Environment::Environment(const char * path)
+    : Object(), mMatrixLocation(0), mNormalMatrixLocation(0), mLightDirLocation(0), mDrawCalls(0) {
+
+    mName = LOG_TAG;
+    loadShaderFromAsset("shader/vertex/vtn_vertex.glsl", "shader/fragment/ti_fragment.glsl");
+    if (mHasError)
+        return;
+    mMatrixLocation = mShader->getUniformLocation("matrix");
+    mNormalMatrixLocation = mShader->getUniformLocation("normalm");
+    mLightDirLocation = mShader->getUniformLocation("l_dir");
+
+    SceneFile file;
+    if (path[0] == '/') {
+        if (!file.open(path)) {
+            mHasError = true;
+            return;
+        }
+        load(file);
+    } else {
+        Context * context = Context::getInstance();
+        AssetFile asset(context->getAssetManager(), path);
+        if (!asset.open() || !file.open(asset.getBuffer(), asset.getLength())) {
+            LOGE("Unable to load %s", path);
+            mHasError = true;
+            return;
+        }
+        load(file);
+    }
+    LOGI("%s: %zu meshes, %zu nodes, %zu textures", path, mMeshes.size(), mNodes.size(), mTextures.size());
+}
+
+Environment::~Environment() {
+    for (size_t i = 0; i < mMeshes.size(); i++) {
+        glDeleteVertexArrays(1, &mMeshes[i].vao);
+        glDeleteBuffers(2, mMeshes[i].buffers);
+    }
+    for (size_t i = 0; i < mTextures.size(); i++)
+        delete mTextures[i];
+}
+
+void Environment::load(const SceneFile& file) {
+    loadMaterials(file);
+    for (uint32_t i = 0; i < file.getMeshCount(); i++)
+        loadMesh(file, file.getMesh(i));
+    loadNodes(file);
+    mHasError = hasGLError();
+}
+
+void Environment::loadMaterials(const SceneFile& file) {
+    std::vector<Texture *> textures(file.getTextureCount(), NULL);
+    for (uint32_t i = 0; i < file.getTextureCount(); i++) {
+        Texture * texture = Texture::loadTexture(file.getString(file.getTexture(i).uri));
+        if (texture == NULL)
+            continue;
+        texture->bindTexture();
+        texture->bindBitmap();
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        texture->unbindTexture();
+        texture->cleanBitmap();
+        textures[i] = texture;
+        mTextures.push_back(texture);
+    }
+
+    // A missing texture falls back to the base color.
+    mMaterialTextures.resize(file.getMaterialCount() + 1);
+    for (uint32_t i = 0; i < file.getMaterialCount(); i++) {
+        const SceneFile::MaterialRecord& material = file.getMaterial(i);
+        Texture * texture = material.baseColorTexture != SceneFile::kNone ? textures[material.baseColorTexture] : NULL;
+        mMaterialTextures[i] = texture != NULL ? texture : makeColorTexture(material.baseColor);
+    }
+    const float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    mMaterialTextures[file.getMaterialCount()] = makeColorTexture(white);
+}
+
+Texture * Environment::makeColorTexture(const float color[4]) {
+    uint8_t texel[4];
+    for (int i = 0; i < 4; i++) {
+        float c = color[i] < 0.0f ? 0.0f : color[i] > 1.0f ? 1.0f : color[i];
+        texel[i] = (uint8_t) (c * 255.0f + 0.5f);
+    }
+    Texture * texture = Texture::genTexture();
+    texture->bindTexture();
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, texel);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    texture->unbindTexture();
+    mTextures.push_back(texture);
+    return texture;
+}
+
+void Environment::loadMesh(const SceneFile& file, const SceneFile::MeshRecord& record) {
+    GpuMesh mesh;
+    mesh.indexType = record.indexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    mesh.indexSize = record.indexSize;
+    mesh.firstSubmesh = (uint32_t) mSubmeshes.size();
+    mesh.submeshCount = record.submeshCount;
+    for (uint32_t i = 0; i < record.submeshCount; i++) {
+        const SceneFile::SubmeshRecord& s = file.getSubmesh(record.firstSubmesh + i);
+        Submesh submesh = { s.firstIndex, s.indexCount,
+            s.material == SceneFile::kNone ? file.getMaterialCount() : s.material };
+        mSubmeshes.push_back(submesh);
+    }
+
+    glGenVertexArrays(1, &mesh.vao);
+    glGenBuffers(2, mesh.buffers);
+    glBindVertexArray(mesh.vao);
+
+    // Straight from the mapping.
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.buffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) record.vertexCount * record.vertexStride,
+        file.getVertices(record), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.buffers[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr) record.indexCount * record.indexSize,
+        file.getIndices(record), GL_STATIC_DRAW);
+
+    // Locations of the vtn shader.  Absent inputs read a constant.
+    const GLsizei stride = record.vertexStride;
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, false, stride, (const void *) 0);
+    if (record.texCoordOffset != SceneFile::kNone) {
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, false, stride, (const void *) (uintptr_t) record.texCoordOffset);
+    } else {
+        glDisableVertexAttribArray(1);
+        glVertexAttrib2f(1, 0.0f, 0.0f);
+    }
+    if (record.normalOffset != SceneFile::kNone) {
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 3, GL_FLOAT, false, stride, (const void *) (uintptr_t) record.normalOffset);
+    } else {
+        glDisableVertexAttribArray(2);
+        glVertexAttrib3f(2, 0.0f, 1.0f, 0.0f);
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    mMeshes.push_back(mesh);
+}
+
+void Environment::loadNodes(const SceneFile& file) {
+    // Parents come first, so their world transform is ready.
+    std::vector<Matrix4> world(file.getNodeCount());
+    AABB bounds;
+    for (uint32_t i = 0; i < file.getNodeCount(); i++) {
+        const SceneFile::NodeRecord& node = file.getNode(i);
+        Matrix4 local(node.local);
+        world[i] = node.parent == SceneFile::kNone ? local : world[node.parent] * local;
+        if (node.mesh == SceneFile::kNone)
+            continue;
+
+        DrawNode draw;
+        draw.mesh = node.mesh;
+        draw.world = world[i];
+        draw.normal = makeNormalMatrix(world[i]);
+        mNodes.push_back(draw);
+
+        const SceneFile::MeshRecord& mesh = file.getMesh(node.mesh);
+        AABB meshBounds(Vector3(mesh.boundsMin[0], mesh.boundsMin[1], mesh.boundsMin[2]),
+            Vector3(mesh.boundsMax[0], mesh.boundsMax[1], mesh.boundsMax[2]));
+        bounds.expand(meshBounds.transformed(world[i]));
+    }
+    setLocalBounds(bounds);
+}
+
+void Environment::draw(const Matrix4& projection, const Matrix4& eye, const Matrix4& view, const Vector4& lightDir) {
+    mDrawCalls = 0;
+    if (!mEnable || mHasError)
+        return;
+
+    const Matrix4 viewProjection = projection * eye * view;
+    const Matrix4 transform = getTransforms();
+    const Matrix3 normalTransform = getWorldNormalMatrix();
+
+    mShader->useProgram();
+    glUniform4f(mLightDirLocation, lightDir.x, lightDir.y, lightDir.z, lightDir.w);
+    glActiveTexture(GL_TEXTURE0);
+    for (size_t n = 0; n < mNodes.size(); n++) {
+        const DrawNode& node = mNodes[n];
+        const GpuMesh& mesh = mMeshes[node.mesh];
+        Matrix4 matrix = viewProjection * transform * node.world;
+        Matrix3 normal = normalTransform * node.normal;
+        glUniformMatrix4fv(mMatrixLocation, 1, false, matrix.get());
+        glUniformMatrix3fv(mNormalMatrixLocation, 1, false, normal.get());
+        glBindVertexArray(mesh.vao);
+        for (uint32_t s = 0; s < mesh.submeshCount; s++) {
+            const Submesh& submesh = mSubmeshes[mesh.firstSubmesh + s];
+            mMaterialTextures[submesh.material]->bindTexture();
+            glDrawElements(GL_TRIANGLES, submesh.indexCount, mesh.indexType,
+                (const void *) (uintptr_t) (submesh.firstIndex * mesh.indexSize));
+            RenderStats::addDraw(submesh.indexCount / 3);
+            mDrawCalls++;
+        }
+    }
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    mShader->unuseProgram();
+}
@@ -0,0 +1,79 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+#include <Object.h>
+#include <SceneFile.h>
+#include <vector>
+
+// Static scenery from a SceneFile, such as a room converted from OBJ by
+// hellovr_meshconv.
+//
+// The file is mapped and every mesh goes straight from the mapping into its
+// GL buffers, then the mapping is dropped.  Nodes are flattened to world
+// transforms at load, so drawing is one glDrawElements per submesh with
+// the vtn shader.  Materials without a texture get a one texel texture of
+// their base color.
+class Environment : public Object {
+public:
+    // An absolute path is read from storage, anything else from the assets,
+    // which must be stored uncompressed to be mapped.
+    explicit Environment(const char * path);
+    virtual ~Environment();
+
+    void draw(const Matrix4& projection, const Matrix4& eye, const Matrix4& view, const Vector4& lightDir);
+
+    inline uint32_t getMeshCount() const {
+        return (uint32_t) mMeshes.size();
+    }
+
+    // Draw calls issued by the last draw().
+    inline uint32_t getDrawCalls() const {
+        return mDrawCalls;
+    }
+
+private:
+    struct GpuMesh {
+        GLuint vao;
+        GLuint buffers[2];      // vertices, indices
+        GLenum indexType;
+        uint32_t indexSize;
+        uint32_t firstSubmesh;
+        uint32_t submeshCount;
+    };
+
+    struct Submesh {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        uint32_t material;      // into mMaterialTextures
+    };
+
+    struct DrawNode {
+        uint32_t mesh;
+        Matrix4 world;          // in the Environment's space
+        Matrix3 normal;
+    };
+
+    void load(const SceneFile& file);
+    void loadMaterials(const SceneFile& file);
+    void loadMesh(const SceneFile& file, const SceneFile::MeshRecord& record);
+    void loadNodes(const SceneFile& file);
+    Texture * makeColorTexture(const float color[4]);
+
+    int mMatrixLocation;
+    int mNormalMatrixLocation;
+    int mLightDirLocation;
+    std::vector<GpuMesh> mMeshes;
+    std::vector<Submesh> mSubmeshes;
+    std::vector<DrawNode> mNodes;
+    std::vector<Texture *> mTextures;           // owned, one per SceneFile texture and color
+    std::vector<Texture *> mMaterialTextures;   // per material, the last one for kNone
+    uint32_t mDrawCalls;
+};
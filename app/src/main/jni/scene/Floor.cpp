@@ -15,6 +15,7 @@
 #include <Texture.h>
 #include <Object.h>
 #include <VertexArrayObject.h>
+#include <RenderStats.h>
 #include <GLES3/gl31.h>
 #include <GLES2/gl2ext.h>
 
@@ -50,6 +51,19 @@ const GLfloat floor_normal[3] = {
     0.0f, 1.0f, 0.0f,
 };
 
+// kProcedural: 1m cells, a heavier line every 10m.
+const GLfloat grid_base_color[4] = {
+    0.18f, 0.22f, 0.20f, 1.0f,
+};
+
+const GLfloat grid_line_color[4] = {
+    0.55f, 0.75f, 0.60f, 1.0f,
+};
+
+const GLfloat grid_cells[4] = {
+    1.0f, 0.01f, 10.0f, 0.02f,
+};
+
 } // namespace
 
 static void dumpMatrix(const char * name, const Matrix4& mat) {
@@ -66,9 +80,25 @@ static void dumpMatrix(const char * name, const Matrix4& mat) {
         ptr[3], ptr[7], ptr[11], ptr[15]);
 }
 
-Floor::Floor() : Object(), mFloorDepth(20.0f) {
+Floor::Floor(Mode mode) : Object(), mMode(mode), mFloorDepth(20.0f),
+        mFollowLocation(-1), mBaseColorLocation(-1), mLineColorLocation(-1), mGridLocation(-1) {
     mName = LOG_TAG;
 
+    if (mMode == kProcedural) {
+        loadShaderFromAsset("shader/vertex/grid_lines_vertex.glsl", "shader/fragment/grid_lines_fragment.glsl");
+        if (mHasError)
+            return;
+        mModelviewProjectionLocation = mShader->getUniformLocation("u_MVP");
+        mFollowLocation = mShader->getUniformLocation("u_Follow");
+        mBaseColorLocation = mShader->getUniformLocation("u_BaseColor");
+        mLineColorLocation = mShader->getUniformLocation("u_LineColor");
+        mGridLocation = mShader->getUniformLocation("u_Grid");
+        mVAO = new VertexArrayObject(true, false);
+        // No bounds: the quad moves with the camera and is never culled.
+        initFloor();
+        return;
+    }
+
     loadShaderFromAsset("shader/vertex/light_vertex.glsl", "shader/fragment/grid_fragment.glsl");
     if (mHasError)
         return;
@@ -90,6 +120,7 @@ Floor::Floor() : Object(), mFloorDepth(20.0f) {
    }
     initFloor();
     initTexture();
+    setLocalBounds(AABB(Vector3(-200*UNIT_SIZE, 0, -200*UNIT_SIZE), Vector3(200*UNIT_SIZE, 0, 200*UNIT_SIZE)));
 }
 
 void Floor::initTexture() {
@@ -141,8 +172,44 @@ void Floor::initFloor() {
 
 }
 
+// The quad is scaled out to the far plane and moved under the camera, in
+// the floor's own plane.  The lines come from the plane position, so they
+// stay put while the quad slides.
+void Floor::drawProcedural(const Matrix4& projection, const Matrix4& modelview) {
+    Matrix4 inverse = modelview;
+    inverse.invert();
+    const Vector4 camera = inverse * Vector4(0, 0, 0, 1);
+
+    // Far distance from the projection: p[14] / (p[10] + 1).
+    const float * p = projection.get();
+    float extent = p[10] != -1.0f ? p[14] / (p[10] + 1.0f) : 0.0f;
+    if (extent <= 0.0f)
+        extent = 200 * UNIT_SIZE;
+    const float follow[4] = {camera.x, camera.z, extent / (200 * UNIT_SIZE), extent * 0.5f};
+
+    Matrix4 modelview_projection = projection * modelview;
+    glUniformMatrix4fv(mModelviewProjectionLocation, 1, GL_FALSE, modelview_projection.get());
+    glUniform4fv(mFollowLocation, 1, follow);
+    glUniform4fv(mBaseColorLocation, 1, grid_base_color);
+    glUniform4fv(mLineColorLocation, 1, grid_line_color);
+    glUniform4fv(mGridLocation, 1, grid_cells);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    RenderStats::addDraw(2);
+}
+
 void Floor::draw(const Matrix4& projection, const Matrix4& eye, const Matrix4& view, const Vector4& lightDir) {
-    if (!mEnable || mHasError || !mVAO || !mTexture)
+    if (!mEnable || mHasError || !mVAO)
+        return;
+
+    if (mMode == kProcedural) {
+        mShader->useProgram();
+        mVAO->bindVAO();
+        drawProcedural(projection, eye * view * getTransforms());
+        mShader->unuseProgram();
+        mVAO->unbindVAO();
+        return;
+    }
+    if (!mTexture)
         return;
 
     mShader->useProgram();
@@ -171,6 +238,7 @@ void Floor::draw(const Matrix4& projection, const Matrix4& eye, const Matrix4& v
     glActiveTexture(GL_TEXTURE0);
     mTexture->bindTexture();
     glDrawArrays(GL_TRIANGLES, 0, 6);
+    RenderStats::addDraw(2);
 
     mShader->unuseProgram();
     mTexture->unbindTexture();
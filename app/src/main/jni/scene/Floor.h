@@ -15,14 +15,29 @@
 #include <vector>
 #include <array>
 
+// The ground plane.  kTextured is a 60x60m quad with land.png.  kProcedural
+// draws grid lines computed in the fragment shader, with no texture at all;
+// its quad follows the camera out to the far plane, so it never ends, and
+// the lines are filtered by their pixel footprint instead of by mipmaps.
 class Floor : public Object {
+public:
+    enum Mode {
+        kTextured,
+        kProcedural
+    };
+
 private:
+    Mode mMode;
     float mFloorDepth;
 
     int mModelLocation;
     int mModelviewLocation;
     int mModelviewProjectionLocation;
     int mLightPosLocation;
+    int mFollowLocation;
+    int mBaseColorLocation;
+    int mLineColorLocation;
+    int mGridLocation;
 
     Matrix4 mModelFloor;
 
@@ -30,12 +45,17 @@ private:
     Vector4 light_pos_eye_space_;
 
 public:
-    Floor();
+    explicit Floor(Mode mode = kTextured);
     ~Floor() {}
 
+    inline Mode getMode() const {
+        return mMode;
+    }
+
 private:
    void initFloor();
    void initTexture();
+   void drawProcedural(const Matrix4& projection, const Matrix4& modelview);
 
 public:
     virtual void draw(const Matrix4& projection, const Matrix4& eye, const Matrix4& view, const Vector4& lightDir);
@@ -0,0 +1,486 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#define LOG_TAG "Picker"
+#include <log.h>
+#include <Picker.h>
+#include <JobSystem.h>
+#include <RayPacket.h>
+
+namespace {
+
+// Box hit that, unlike AABB::intersect, reports the exit when the ray starts
+// inside, matching intersectSphere.  normal is the local face normal.
+bool intersectBox(const AABB& box, const Ray& ray, float tMax, float& t, Vector3& normal) {
+    float lo = -FLT_MAX, hi = FLT_MAX;
+    int loAxis = 0, hiAxis = 0;
+    for (int axis = 0; axis < 3; axis++) {
+        float t0 = (box.min[axis] - ray.origin[axis]) * ray.invDirection[axis];
+        float t1 = (box.max[axis] - ray.origin[axis]) * ray.invDirection[axis];
+        if (t0 > t1) {
+            float tmp = t0; t0 = t1; t1 = tmp;
+        }
+        if (t0 > lo) { lo = t0; loAxis = axis; }
+        if (t1 < hi) { hi = t1; hiAxis = axis; }
+    }
+    if (lo > hi || hi < 0)
+        return false;
+
+    int axis = loAxis;
+    t = lo;
+    if (lo < 0) {
+        t = hi;
+        axis = hiAxis;
+    }
+    if (t > tMax)
+        return false;
+    normal = Vector3(0, 0, 0);
+    normal[axis] = ray.direction[axis] > 0 ? -1.0f : 1.0f;
+    return true;
+}
+
+// Normals go through the inverse transpose.
+Vector3 transformNormal(const Matrix4& inverse, const Vector3& n) {
+    const float * m = inverse.get();
+    Vector3 out(m[0] * n.x + m[1] * n.y + m[2] * n.z,
+                m[4] * n.x + m[5] * n.y + m[6] * n.z,
+                m[8] * n.x + m[9] * n.y + m[10] * n.z);
+    return out.normalize();
+}
+
+float maxScale(const Matrix4& transform) {
+    const float * m = transform.get();
+    float sx = Vector3(m[0], m[1], m[2]).length();
+    float sy = Vector3(m[4], m[5], m[6]).length();
+    float sz = Vector3(m[8], m[9], m[10]).length();
+    return maxf(sx, maxf(sy, sz));
+}
+
+}  // namespace
+
+const uint32_t Picker::kInvalidId;
+const uint32_t Picker::kMaxPacketSize;
+
+Picker::Picker() : mCount(0), mNeedsBuild(false) {
+}
+
+Picker::~Picker() {
+}
+
+uint32_t Picker::allocate(VolumeType type, const Matrix4& transform, void * userData) {
+    uint32_t id;
+    if (!mFreeIds.empty()) {
+        id = mFreeIds.back();
+        mFreeIds.pop_back();
+    } else {
+        id = (uint32_t) mVolumes.size();
+        mVolumes.push_back(Volume());
+        mBounds.push_back(AABB());
+    }
+
+    Volume& v = mVolumes[id];
+    v.type = type;
+    v.alive = true;
+    v.enable = true;
+    v.dirty = false;
+    v.transform = transform;
+    v.inverse = transform;
+    v.inverse.invert();
+    v.local = AABB();
+    v.radius = 0;
+    v.worldRadius = 0;
+    v.positions.clear();
+    v.indices.clear();
+    v.userData = userData;
+
+    mCount++;
+    mNeedsBuild = true;
+    return id;
+}
+
+uint32_t Picker::addSphere(const Vector3& center, float radius, const Matrix4& transform, void * userData) {
+    uint32_t id = allocate(kSphere, transform, userData);
+    Volume& v = mVolumes[id];
+    v.center = center;
+    v.radius = radius;
+    v.local = AABB(center - Vector3(radius, radius, radius), center + Vector3(radius, radius, radius));
+    updateBounds(id);
+    return id;
+}
+
+uint32_t Picker::addBox(const AABB& local, const Matrix4& transform, void * userData) {
+    uint32_t id = allocate(kBox, transform, userData);
+    mVolumes[id].local = local;
+    updateBounds(id);
+    return id;
+}
+
+uint32_t Picker::addOrientedBox(const AABB& local, const Matrix4& transform, void * userData) {
+    uint32_t id = allocate(kOrientedBox, transform, userData);
+    mVolumes[id].local = local;
+    updateBounds(id);
+    return id;
+}
+
+uint32_t Picker::addMesh(const float * positions, uint32_t vertexCount, const uint32_t * indices, uint32_t indexCount,
+        const Matrix4& transform, void * userData) {
+    if (positions == NULL || indices == NULL || indexCount < 3) {
+        LOGE("addMesh: empty mesh");
+        return kInvalidId;
+    }
+    for (uint32_t i = 0; i < indexCount; i++) {
+        if (indices[i] >= vertexCount) {
+            LOGE("addMesh: index %u out of range", indices[i]);
+            return kInvalidId;
+        }
+    }
+
+    uint32_t id = allocate(kMesh, transform, userData);
+    Volume& v = mVolumes[id];
+    v.positions.assign(positions, positions + vertexCount * 3);
+    v.indices.assign(indices, indices + indexCount - indexCount % 3);
+    for (uint32_t i = 0; i < vertexCount; i++)
+        v.local.expand(Vector3(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]));
+    updateBounds(id);
+    return id;
+}
+
+void Picker::remove(uint32_t id) {
+    if (id >= mVolumes.size() || !mVolumes[id].alive)
+        return;
+    Volume& v = mVolumes[id];
+    v.alive = false;
+    v.positions.clear();
+    v.indices.clear();
+    mBounds[id] = AABB();
+    mFreeIds.push_back(id);
+    mCount--;
+    mNeedsBuild = true;
+}
+
+void Picker::clear() {
+    mVolumes.clear();
+    mBounds.clear();
+    mFreeIds.clear();
+    mDirtyIds.clear();
+    mCount = 0;
+    mNeedsBuild = false;
+    mTree.clear();
+}
+
+void Picker::setTransform(uint32_t id, const Matrix4& transform) {
+    if (id >= mVolumes.size() || !mVolumes[id].alive)
+        return;
+    Volume& v = mVolumes[id];
+    v.transform = transform;
+    v.inverse = transform;
+    v.inverse.invert();
+    updateBounds(id);
+    if (!v.dirty) {
+        v.dirty = true;
+        mDirtyIds.push_back(id);
+    }
+}
+
+void Picker::setEnable(uint32_t id, bool enable) {
+    if (id >= mVolumes.size() || !mVolumes[id].alive)
+        return;
+    mVolumes[id].enable = enable;
+}
+
+bool Picker::isEnabled(uint32_t id) const {
+    return id < mVolumes.size() && mVolumes[id].alive && mVolumes[id].enable;
+}
+
+void Picker::updateBounds(uint32_t id) {
+    Volume& v = mVolumes[id];
+    if (v.type == kSphere) {
+        v.worldCenter = v.transform * v.center;
+        const float * m = v.transform.get();
+        v.worldCenter += Vector3(m[12], m[13], m[14]);
+        v.worldRadius = v.radius * maxScale(v.transform);
+        Vector3 r(v.worldRadius, v.worldRadius, v.worldRadius);
+        mBounds[id] = AABB(v.worldCenter - r, v.worldCenter + r);
+    } else {
+        mBounds[id] = v.local.transformed(v.transform);
+    }
+}
+
+void Picker::update() {
+    if (!mNeedsBuild && !mDirtyIds.empty()) {
+        mTree.refit(mBounds.data(), mDirtyIds.data(), (uint32_t) mDirtyIds.size());
+        mNeedsBuild = mTree.needsRebuild();
+    }
+
+    if (mNeedsBuild) {
+        mScratchIds.clear();
+        for (uint32_t id = 0; id < mVolumes.size(); id++) {
+            if (mVolumes[id].alive)
+                mScratchIds.push_back(id);
+        }
+        mTree.build(mBounds.data(), mScratchIds.data(), (uint32_t) mScratchIds.size());
+        mNeedsBuild = false;
+    }
+
+    for (uint32_t i = 0; i < mDirtyIds.size(); i++)
+        mVolumes[mDirtyIds[i]].dirty = false;
+    mDirtyIds.clear();
+}
+
+bool Picker::intersect(uint32_t id, const Ray& ray, float tMax, float& t, Vector3 * normal) const {
+    const Volume& v = mVolumes[id];
+    if (!v.alive || !v.enable)
+        return false;
+
+    Vector3 n;
+    switch (v.type) {
+    case kSphere:
+        if (!intersectSphere(ray, v.worldCenter, v.worldRadius, 0, tMax, t))
+            return false;
+        if (normal)
+            *normal = (ray.at(t) - v.worldCenter).normalize();
+        return true;
+    case kBox:
+        if (!intersectBox(mBounds[id], ray, tMax, t, n))
+            return false;
+        if (normal)
+            *normal = n;
+        return true;
+    case kOrientedBox: {
+        Ray local = ray.transformed(v.inverse);
+        if (!intersectBox(v.local, local, tMax, t, n))
+            return false;
+        if (normal)
+            *normal = transformNormal(v.inverse, n);
+        return true;
+    }
+    case kMesh: {
+        Ray local = ray.transformed(v.inverse);
+        float tNear;
+        if (!v.local.intersect(local, 0, tMax, tNear))
+            return false;
+        const float * p = v.positions.data();
+        bool hit = false;
+        uint32_t hitTri = 0;
+        for (uint32_t i = 0; i < v.indices.size(); i += 3) {
+            const float * a = p + v.indices[i] * 3;
+            const float * b = p + v.indices[i + 1] * 3;
+            const float * c = p + v.indices[i + 2] * 3;
+            if (intersectTriangle(local, Vector3(a[0], a[1], a[2]), Vector3(b[0], b[1], b[2]),
+                    Vector3(c[0], c[1], c[2]), 0, tMax, t)) {
+                tMax = t;
+                hitTri = i;
+                hit = true;
+            }
+        }
+        if (hit && normal) {
+            const float * a = p + v.indices[hitTri] * 3;
+            const float * b = p + v.indices[hitTri + 1] * 3;
+            const float * c = p + v.indices[hitTri + 2] * 3;
+            Vector3 e1(b[0] - a[0], b[1] - a[1], b[2] - a[2]);
+            Vector3 e2(c[0] - a[0], c[1] - a[1], c[2] - a[2]);
+            *normal = transformNormal(v.inverse, e1.cross(e2));
+        }
+        t = tMax;
+        return hit;
+    }
+    }
+    return false;
+}
+
+void Picker::fillHit(uint32_t id, const Ray& ray, float t, const Vector3& normal, Hit& hit) const {
+    hit.id = id;
+    hit.distance = t;
+    hit.point = ray.at(t);
+    hit.normal = normal;
+    if (hit.normal.dot(ray.direction) > 0)
+        hit.normal = -hit.normal;
+    hit.userData = mVolumes[id].userData;
+}
+
+bool Picker::raycastClosest(const Ray& ray, float maxDistance, Hit& hit) {
+    update();
+
+    struct Closest {
+        const Picker * picker;
+        const Ray * ray;
+        uint32_t id;
+        bool operator()(uint32_t prim, float& tMax) {
+            float t;
+            if (picker->intersect(prim, *ray, tMax, t, NULL)) {
+                tMax = t;
+                id = prim;
+            }
+            return false;
+        }
+    } visitor = { this, &ray, kInvalidId };
+
+    float tMax = maxDistance;
+    mTree.raycast(ray, 0, tMax, visitor);
+    hit.id = kInvalidId;
+    if (visitor.id == kInvalidId)
+        return false;
+
+    // Only the winner pays for its normal.
+    float t;
+    Vector3 normal;
+    intersect(visitor.id, ray, maxDistance, t, &normal);
+    fillHit(visitor.id, ray, t, normal, hit);
+    return true;
+}
+
+bool Picker::raycastAny(const Ray& ray, float maxDistance) {
+    update();
+
+    struct Any {
+        const Picker * picker;
+        const Ray * ray;
+        bool hit;
+        bool operator()(uint32_t prim, float& tMax) {
+            float t;
+            hit = picker->intersect(prim, *ray, tMax, t, NULL);
+            return hit;
+        }
+    } visitor = { this, &ray, false };
+
+    mTree.raycast(ray, 0, maxDistance, visitor);
+    return visitor.hit;
+}
+
+uint32_t Picker::raycastBatch(const Ray * rays, uint32_t count, float maxDistance, Hit * hits,
+        JobSystem * jobs) {
+    update();
+
+    // Tracing only reads the tree, so packets are independent.
+    const uint32_t packetCount = (count + kMaxPacketSize - 1) / kMaxPacketSize;
+    auto tracePackets = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t p = begin; p < end; p++) {
+            const uint32_t first = p * kMaxPacketSize;
+            const uint32_t n = count - first < kMaxPacketSize ? count - first : kMaxPacketSize;
+            raycastPacket(rays + first, n, maxDistance, hits + first);
+        }
+    };
+    if (jobs != NULL)
+        jobs->parallelFor(packetCount, 1, tracePackets);
+    else
+        tracePackets(0, packetCount);
+
+    uint32_t hitCount = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (hits[i].id != kInvalidId)
+            hitCount++;
+    }
+    return hitCount;
+}
+
+// Walks the tree once for the whole packet, carrying a mask of the rays still
+// inside each node.  Rays from the controllers and the head start close
+// together and mostly visit the same nodes, so this touches each node once
+// instead of once per ray.
+void Picker::raycastPacket(const Ray * rays, uint32_t count, float maxDistance, Hit * hits) const {
+    float tMax[kMaxPacketSize];
+    uint32_t ids[kMaxPacketSize];
+    for (uint32_t i = 0; i < kMaxPacketSize; i++) {
+        tMax[i] = maxDistance;
+        ids[i] = kInvalidId;
+    }
+
+    // Groups of four rays for the SIMD kernels.
+    RayPacket4 quads[kMaxPacketSize / 4];
+    const uint32_t quadCount = (count + 3) / 4;
+    for (uint32_t q = 0; q < quadCount; q++)
+        quads[q].set(rays + q * 4, count - q * 4 < 4 ? count - q * 4 : 4);
+
+    const std::vector<BVH::Node>& nodes = mTree.getNodes();
+    const std::vector<uint32_t>& prims = mTree.getPrimitives();
+    if (!nodes.empty()) {
+        struct Entry { int32_t node; uint64_t mask; };
+        Entry stack[64];
+        int sp = 0;
+        uint64_t all = count == 64 ? ~0ULL : ((1ULL << count) - 1);
+        stack[sp++] = { 0, all };
+
+        while (sp > 0) {
+            const Entry e = stack[--sp];
+            const BVH::Node& node = nodes[e.node];
+
+            uint64_t mask = 0;
+            for (uint32_t q = 0; q < quadCount; q++) {
+                if (!(e.mask >> (q * 4) & 0xF))
+                    continue;
+                float t[4];
+                mask |= (uint64_t) intersectAABB4(quads[q], node.bounds, 0, tMax + q * 4, t) << (q * 4);
+            }
+            mask &= e.mask;
+            if (mask == 0)
+                continue;
+
+            if (node.count > 0) {
+                for (uint32_t p = node.first; p < node.first + node.count; p++) {
+                    const uint32_t prim = prims[p];
+                    const Volume& v = mVolumes[prim];
+                    if (v.type == kSphere) {
+                        if (!v.alive || !v.enable)
+                            continue;
+                        for (uint32_t q = 0; q < quadCount; q++) {
+                            uint32_t lanes = (uint32_t) (mask >> (q * 4) & 0xF);
+                            if (!lanes)
+                                continue;
+                            float t[4];
+                            lanes &= intersectSphere4(quads[q], v.worldCenter, v.worldRadius, 0, tMax + q * 4, t);
+                            for (uint32_t i = 0; lanes; i++, lanes >>= 1) {
+                                if (lanes & 1) {
+                                    tMax[q * 4 + i] = t[i];
+                                    ids[q * 4 + i] = prim;
+                                }
+                            }
+                        }
+                        continue;
+                    }
+                    for (uint32_t i = 0; i < count; i++) {
+                        float t;
+                        if ((mask >> i & 1) && intersect(prim, rays[i], tMax[i], t, NULL)) {
+                            tMax[i] = t;
+                            ids[i] = prim;
+                        }
+                    }
+                }
+                continue;
+            }
+
+            // Visit the child nearer to the packet's first active ray first.
+            int lowest = 0;
+            while (!(mask >> lowest & 1))
+                lowest++;
+            float tl = FLT_MAX, tr = FLT_MAX;
+            nodes[node.left].bounds.intersect(rays[lowest], 0, tMax[lowest], tl);
+            nodes[node.left + 1].bounds.intersect(rays[lowest], 0, tMax[lowest], tr);
+            if (tl <= tr) {
+                stack[sp++] = { node.left + 1, mask };
+                stack[sp++] = { node.left, mask };
+            } else {
+                stack[sp++] = { node.left, mask };
+                stack[sp++] = { node.left + 1, mask };
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        hits[i].id = kInvalidId;
+        hits[i].distance = maxDistance;
+        hits[i].userData = NULL;
+        if (ids[i] == kInvalidId)
+            continue;
+        float t;
+        Vector3 normal;
+        intersect(ids[i], rays[i], maxDistance, t, &normal);
+        fillHit(ids[i], rays[i], t, normal, hits[i]);
+    }
+}
@@ -0,0 +1,120 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <Matrices.h>
+#include <BoundingVolume.h>
+#include <BVH.h>
+
+class JobSystem;
+
+// Raycast picking against registered bounding volumes.
+//
+// Every target gets an id from one of the add functions.  Targets live in a
+// BVH over their world bounds: moving a target with setTransform() only marks
+// it for a refit, adding or removing one schedules a rebuild.  Queries apply
+// pending changes first, or call update() once per frame after moving things.
+//
+// Distances are in units of the ray direction, so normalize it to get meters.
+class Picker {
+public:
+    enum VolumeType {
+        kSphere,
+        kBox,           // axis aligned bounds of the transformed local box
+        kOrientedBox,   // the local box under its transform, tested exactly
+        kMesh           // triangles, tested in local space
+    };
+
+    static const uint32_t kInvalidId = 0xFFFFFFFF;
+    // Rays per packet in raycastBatch().
+    static const uint32_t kMaxPacketSize = 64;
+
+    struct Hit {
+        uint32_t id;
+        float distance;
+        Vector3 point;
+        Vector3 normal;     // world space, facing the ray
+        void * userData;
+    };
+
+public:
+    Picker();
+    ~Picker();
+
+    // The local center and radius are scaled by the largest axis of the transform.
+    uint32_t addSphere(const Vector3& center, float radius, const Matrix4& transform, void * userData = NULL);
+    uint32_t addBox(const AABB& local, const Matrix4& transform, void * userData = NULL);
+    uint32_t addOrientedBox(const AABB& local, const Matrix4& transform, void * userData = NULL);
+    // positions are xyz triples.  The data is copied.
+    uint32_t addMesh(const float * positions, uint32_t vertexCount, const uint32_t * indices, uint32_t indexCount,
+            const Matrix4& transform, void * userData = NULL);
+    void remove(uint32_t id);
+    void clear();
+
+    void setTransform(uint32_t id, const Matrix4& transform);
+    // Disabled targets stay in the tree but are never hit.
+    void setEnable(uint32_t id, bool enable);
+    bool isEnabled(uint32_t id) const;
+
+    // Apply pending adds, removes and moves.
+    void update();
+
+    bool raycastClosest(const Ray& ray, float maxDistance, Hit& hit);
+    bool raycastAny(const Ray& ray, float maxDistance);
+    // Closest hit per ray.  hits[i].id is kInvalidId when ray i misses.
+    // Returns the number of rays that hit something.  With jobs, packets
+    // are traced in parallel once there is more than one.
+    uint32_t raycastBatch(const Ray * rays, uint32_t count, float maxDistance, Hit * hits,
+            JobSystem * jobs = NULL);
+
+    inline uint32_t getCount() const {
+        return mCount;
+    }
+
+    inline const AABB& getBounds(uint32_t id) const {
+        return mBounds[id];
+    }
+
+private:
+    struct Volume {
+        VolumeType type;
+        bool alive;
+        bool enable;
+        bool dirty;
+        Matrix4 transform;
+        Matrix4 inverse;
+        AABB local;
+        Vector3 center;         // kSphere, local then world
+        float radius;
+        Vector3 worldCenter;
+        float worldRadius;
+        std::vector<float> positions;
+        std::vector<uint32_t> indices;
+        void * userData;
+    };
+
+    uint32_t allocate(VolumeType type, const Matrix4& transform, void * userData);
+    void updateBounds(uint32_t id);
+    bool intersect(uint32_t id, const Ray& ray, float tMax, float& t, Vector3 * normal) const;
+    void fillHit(uint32_t id, const Ray& ray, float t, const Vector3& normal, Hit& hit) const;
+    void raycastPacket(const Ray * rays, uint32_t count, float maxDistance, Hit * hits) const;
+
+    std::vector<Volume> mVolumes;
+    std::vector<AABB> mBounds;          // world bounds, indexed by id
+    std::vector<uint32_t> mFreeIds;
+    std::vector<uint32_t> mDirtyIds;
+    std::vector<uint32_t> mScratchIds;
+    uint32_t mCount;
+    bool mNeedsBuild;
+    BVH mTree;
+};
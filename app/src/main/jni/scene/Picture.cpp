@@ -16,6 +16,7 @@
 #include <VertexArrayObject.h>
 #include <GLES3/gl31.h>
 #include <Picture.h>
+#include <RenderStats.h>
 
 Picture::Picture() : Object() {
     mName = LOG_TAG;
@@ -97,6 +98,7 @@ void Picture::draw(const Matrix4& projection, const Matrix4& eye, const Matrix4&
 
     mVAO->bindVAO();
     glDrawArrays(GL_TRIANGLES, 0, 6);
+    RenderStats::addDraw(2);
     mShader->unuseProgram();
     mVAO->unbindVAO();
 }
@@ -35,7 +35,7 @@ struct Point3D {
   }
 };
 
-Vector3D operator-(Point3D const &p1, Point3D const &p2){
+inline Vector3D operator-(Point3D const &p1, Point3D const &p2){
   return Vector3D(p1.x-p2.x,p1.y-p2.y,p1.z-p2.z);
 }
 
@@ -55,36 +55,28 @@ struct Sphere3D {
   }
 };
 
-bool intersection(Ray3D &r, Sphere3D const &s){
+// True when the ray hits the sphere in front of its origin.  r.collision is
+// set to the nearest such hit.  A ray starting inside hits the far side.
+inline bool intersection(Ray3D &r, Sphere3D const &s){
   Vector3D w = r.p - s.center;
   float A = r.v.dot(r.v);
-  float B = 2*w.dot(r.v);
+  float B = w.dot(r.v);
   float C = w.dot(w) - s.radius*s.radius;
-  double t, epsilon = 1e-4;
-
-  float D = (B*B-4.0f*A*C);
-  if (D < 0){
-  return false;
-  }else{
-    Vector3 ori(r.p.x,r.p.y,r.p.z);
-    Vector3 dir(r.v.x,r.v.y,r.v.z);
-    t=(t = (-B - sqrtf(D)) * 0.5 / A) > epsilon ? t : ((t = (-B + sqrtf(D)) * 0.5 / A) > epsilon ? t : 0.0);
-    Vector3 t_first=(ori+(dir*t));
-//    LOGD("RayInter Start");
-//    LOGD("RayInter Intersection First intersection: %f , %f ,%f ",t_first.x,t_first.y,t_first.z);
-    r.collision.set(t_first.x,t_first.y,t_first.z);
-    float t1_v=((-B+sqrtf(D))*0.5f)/A;
-    float t2_v=((-B-sqrtf(D))*0.5f)/A;
-    Vector3 t1(ori+(dir*t1_v));
-    Vector3 t2(ori+(dir*t2_v));
-//    LOGD("RayInter Intersection Point 1: %f , %f ,%f ",t1.x,t1.y,t1.z);
-//    LOGD("RayInter Intersection Point 2: %f , %f ,%f ",t2.x,t2.y,t2.z);
-//    LOGD("RayInter End");
-    if(t_first==t1 || t_first==t2) // make sure the ray's direction forward to sphere
-      return true;
-    else
-      return false;
-  }
+  const float epsilon = 1e-4f;
+
+  float D = B*B - A*C;
+  if (D < 0 || A == 0)
+    return false;
+
+  float sqrtD = sqrtf(D);
+  float t = (-B - sqrtD) / A;
+  if (t <= epsilon)
+    t = (-B + sqrtD) / A;
+  if (t <= epsilon)
+    return false;
+
+  r.collision.set(r.p.x + r.v.x*t, r.p.y + r.v.y*t, r.p.z + r.v.z*t);
+  return true;
 }
 
 #endif //WVR_HELLOVR_RAY_H
\ No newline at end of file
@@ -18,6 +18,7 @@
 #include <GLES2/gl2ext.h>
 #include <GLES3/gl31.h>
 #include <ReticlePointer.h>
+#include <RenderStats.h>
 
 //-----------------------------------------------------------------------------
 // Purpose: Create/destroy GL Render Models
@@ -141,6 +142,7 @@ void ReticlePointer::draw(const Matrix4& projection, const Matrix4& eye, const M
     glUniformMatrix4fv(mMatrixLocation, 1, false, matrix.get());
     mVAO->bindVAO();
     glDrawArrays(GL_TRIANGLES, 0, mVertCount);
+    RenderStats::addDraw(mVertCount / 3);
 
     mVAO->unbindVAO();
     mShader->unuseProgram();
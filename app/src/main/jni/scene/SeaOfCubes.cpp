@@ -0,0 +1,199 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#define LOG_TAG "SeaOfCubes"
+#include <stdint.h>
+#include <string.h>
+#include <log.h>
+#include <Object.h>
+#include <Shader.h>
+#include <Texture.h>
+#include <VertexArrayObject.h>
+#include <GLES3/gl31.h>
+#include <ControllerCube.h>
+#include <SeaOfCubes.h>
+#include <RenderStats.h>
+
+namespace {
+const char * kLayers[] = {
+    "textures/cube_texture.jpg",
+    "textures/cube_controller.jpg"
+};
+const int kLayerCount = sizeof(kLayers) / sizeof(kLayers[0]);
+} // namespace
+
+SeaOfCubes::SeaOfCubes(uint32_t countX, uint32_t countY, uint32_t countZ, float spacing)
+    : Object(), mMatrixLocation(0), mLightDirLocation(0), mTrianglesX3(0),
+    mInstanceBuffer(NULL), mInstancesDirty(true), mInstanced(true), mDrawCalls(0) {
+
+    mName = LOG_TAG;
+    loadShaderFromAsset("shader/vertex/vtni_vertex.glsl", "shader/fragment/taci_fragment.glsl");
+    if (mHasError)
+        return;
+    mMatrixLocation = mShader->getUniformLocation("matrix");
+    mLightDirLocation = mShader->getUniformLocation("l_dir");
+
+    mVAO = new VertexArrayObject(true, true);
+
+    mTexture = Texture::loadTextureArray(kLayers, kLayerCount);
+    if (mTexture == NULL) {
+        mHasError = true;
+        return;
+    }
+
+    mInstanceBuffer = new InstanceBuffer();
+    initCubes();
+    initInstances(countX, countY, countZ, spacing);
+}
+
+SeaOfCubes::~SeaOfCubes() {
+    if (mInstanceBuffer != NULL)
+        delete mInstanceBuffer;
+    mInstanceBuffer = NULL;
+}
+
+void SeaOfCubes::initCubes() {
+    if (!mVAO) return;
+
+    std::vector<float> vertdataarray;
+    std::vector<uint32_t> indexarray;
+    mHasError = true;
+
+    // A unit cube, each instance scales it.
+    Matrix4 mat;
+    ControllerCube::addCubeToScene(mat, vertdataarray, 0, indexarray);
+    if (indexarray.size() == 0)
+        return;
+
+    mVAO->bindVAO();
+
+    mVAO->bindArrayBuffer();
+    GLuint offset = 0;
+    int stride = (3 + 2 + 3) * sizeof(float);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * vertdataarray.size(), &vertdataarray[0], GL_STATIC_DRAW);
+    if (hasGLError())
+        return;
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, false, stride, (const void *)(uintptr_t)offset);
+
+    offset += 3 * sizeof(float);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, false, stride, (const void *)(uintptr_t)offset);
+
+    offset += 2 * sizeof(float);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 3, GL_FLOAT, false, stride, (const void *)(uintptr_t)offset);
+
+    mInstanceBuffer->bindAttributes();
+
+    mVAO->bindElementArrayBuffer();
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * indexarray.size(), &indexarray[0], GL_STATIC_DRAW);
+    if (hasGLError())
+        return;
+
+    mTrianglesX3 = indexarray.size();
+    mHasError = false;
+    mVAO->unbindVAO();
+    mVAO->unbindArrayBuffer();
+    mVAO->unbindElementArrayBuffer();
+}
+
+void SeaOfCubes::initInstances(uint32_t countX, uint32_t countY, uint32_t countZ, float spacing) {
+    const float size = spacing * 0.5f;
+    const Vector3 origin(-0.5f * spacing * (countX - 1), -0.5f * spacing * (countY - 1), -0.5f * spacing * (countZ - 1));
+
+    mInstances.resize(countX * countY * countZ);
+    InstanceData * instance = mInstances.data();
+    for (uint32_t z = 0; z < countZ; z++) {
+        for (uint32_t y = 0; y < countY; y++) {
+            for (uint32_t x = 0; x < countX; x++, instance++) {
+                Matrix4 model;
+                model.scale(size);
+                model.translate(origin + Vector3(x * spacing, y * spacing, z * spacing));
+                memcpy(instance->model, model.get(), sizeof(instance->model));
+                // A gradient across the grid, so neighbours are easy to tell apart.
+                instance->color[0] = 0.5f + 0.5f * x / (countX > 1 ? countX - 1 : 1);
+                instance->color[1] = 0.5f + 0.5f * y / (countY > 1 ? countY - 1 : 1);
+                instance->color[2] = 0.5f + 0.5f * z / (countZ > 1 ? countZ - 1 : 1);
+                instance->color[3] = 1.0f;
+                instance->layer = (float) ((x + y + z) % kLayerCount);
+                instance->padding[0] = instance->padding[1] = instance->padding[2] = 0;
+            }
+        }
+    }
+    mInstancesDirty = true;
+
+    const Vector3 half(size * 0.5f, size * 0.5f, size * 0.5f);
+    setLocalBounds(AABB(origin - half, half - origin));
+}
+
+void SeaOfCubes::setInstanceTransform(uint32_t index, const Matrix4& model) {
+    if (index >= mInstances.size())
+        return;
+    memcpy(mInstances[index].model, model.get(), sizeof(mInstances[index].model));
+    mInstancesDirty = true;
+}
+
+void SeaOfCubes::setInstanceColor(uint32_t index, const Vector4& color) {
+    if (index >= mInstances.size())
+        return;
+    float * c = mInstances[index].color;
+    c[0] = color.x; c[1] = color.y; c[2] = color.z; c[3] = color.w;
+    mInstancesDirty = true;
+}
+
+void SeaOfCubes::draw(const Matrix4& projection, const Matrix4& eye, const Matrix4& view, const Vector4& lightDir) {
+    mDrawCalls = 0;
+    if (!mEnable || mHasError || !mVAO || !mTexture || mInstances.empty())
+        return;
+
+    // Both eyes share the upload.
+    if (mInstancesDirty) {
+        mInstanceBuffer->upload(mInstances.data(), (uint32_t) mInstances.size());
+        mInstancesDirty = false;
+    }
+
+    Matrix4 matrix = projection * eye * view * getTransforms();
+
+    mShader->useProgram();
+    glUniformMatrix4fv(mMatrixLocation, 1, false, matrix.get());
+    glUniform4f(mLightDirLocation, lightDir.x, lightDir.y, lightDir.z, lightDir.w);
+    mVAO->bindVAO();
+    glActiveTexture(GL_TEXTURE0);
+    mTexture->bindTextureArray();
+
+    if (mInstanced) {
+        glDrawElementsInstanced(GL_TRIANGLES, mTrianglesX3, GL_UNSIGNED_INT, 0, (GLsizei) mInstances.size());
+        RenderStats::addDraw(mTrianglesX3 / 3 * (uint32_t) mInstances.size());
+        mDrawCalls = 1;
+    } else {
+        // Same shader, with the instance inputs as constant attributes.
+        for (GLuint i = InstanceBuffer::kModelLocation; i <= InstanceBuffer::kLayerLocation; i++)
+            glDisableVertexAttribArray(i);
+        for (size_t i = 0; i < mInstances.size(); i++) {
+            const InstanceData & instance = mInstances[i];
+            for (GLuint col = 0; col < 4; col++)
+                glVertexAttrib4fv(InstanceBuffer::kModelLocation + col, instance.model + col * 4);
+            glVertexAttrib4fv(InstanceBuffer::kColorLocation, instance.color);
+            glVertexAttrib1f(InstanceBuffer::kLayerLocation, instance.layer);
+            glDrawElements(GL_TRIANGLES, mTrianglesX3, GL_UNSIGNED_INT, 0);
+            RenderStats::addDraw(mTrianglesX3 / 3);
+        }
+        for (GLuint i = InstanceBuffer::kModelLocation; i <= InstanceBuffer::kLayerLocation; i++)
+            glEnableVertexAttribArray(i);
+        mDrawCalls = (uint32_t) mInstances.size();
+    }
+
+    mShader->unuseProgram();
+    mTexture->unbindTextureArray();
+    mVAO->unbindVAO();
+}
@@ -0,0 +1,63 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#pragma once
+#include <Object.h>
+#include <InstanceBuffer.h>
+#include <vector>
+
+// A grid of textured cubes drawn with one glDrawElementsInstanced.
+//
+// Every cube shares the mesh, shader and texture array.  Per cube model
+// matrix, color and texture layer live in an InstanceBuffer, uploaded again
+// only after one of the setters changed something.  Stress scene for the
+// draw call path.
+class SeaOfCubes : public Object {
+private:
+    int mMatrixLocation;
+    int mLightDirLocation;
+    int mTrianglesX3;
+    std::vector<InstanceData> mInstances;
+    InstanceBuffer * mInstanceBuffer;
+    bool mInstancesDirty;
+    bool mInstanced;
+    uint32_t mDrawCalls;
+
+public:
+    // countX * countY * countZ cubes, spacing meters apart, centered on the origin.
+    SeaOfCubes(uint32_t countX, uint32_t countY, uint32_t countZ, float spacing);
+    virtual ~SeaOfCubes();
+
+    void draw(const Matrix4& projection, const Matrix4& eye, const Matrix4& view, const Vector4& lightDir);
+
+    inline uint32_t getInstanceCount() const {
+        return (uint32_t) mInstances.size();
+    }
+
+    // Relative to the SeaOfCubes transform.
+    void setInstanceTransform(uint32_t index, const Matrix4& model);
+    void setInstanceColor(uint32_t index, const Vector4& color);
+
+    // false draws one cube per glDrawElements, the way every other object in
+    // the sample draws.  For comparison only.
+    inline void setInstanced(bool instanced) {
+        mInstanced = instanced;
+    }
+
+    // Draw calls issued by the last draw().
+    inline uint32_t getDrawCalls() const {
+        return mDrawCalls;
+    }
+
+private:
+    void initCubes();
+    void initInstances(uint32_t countX, uint32_t countY, uint32_t countZ, float spacing);
+};
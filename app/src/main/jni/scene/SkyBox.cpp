@@ -10,9 +10,12 @@
 
 #define LOG_TAG "SkyBox"
 #include <SkyBox.h>
+#include <Context.h>
 #include <VertexArrayObject.h>
 #include <Shader.h>
 #include <Texture.h>
+#include <RenderState.h>
+#include <RenderStats.h>
 #include <GLES3/gl31.h>
 #include <log.h>
 #include <sys/time.h>
@@ -79,22 +82,107 @@ static const char * SkyBoxList[] = {
     "textures/skybox_groundsky.jpg"
 };
 
-SkyBox::SkyBox(bool debug) : Object() {
+static const char * SkyBoxVertexShaders[] = {
+    "shader/vertex/skybox_vertex.glsl",
+    "shader/vertex/skybox_fullscreen_vertex.glsl"
+};
+
+static const char * SkyBoxDebugAsset = "textures/skybox_simple.jpg";
+
+static const char * SkyBoxFragmentShaders[] = {
+    "shader/fragment/skybox_fragment.glsl",
+    "shader/fragment/skybox_equirect_fragment.glsl",
+    "shader/fragment/skybox_crossfade_fragment.glsl"
+};
+
+// The sky is at the far plane, where the cleared depth is.  Testing with
+// GL_LEQUAL draws it only where nothing else was, and is the state the rest
+// of the scene uses, so drawing the sky changes no state.
+static const RenderState::Desc & SkyBoxState = RenderState::kOpaque;
+
+// Like Object::loadShaderFromAsset(), without touching mShader.
+static std::shared_ptr<Shader> loadProgram(const char * vpath, const char * fpath) {
+    std::shared_ptr<Shader> program = Shader::findShader(vpath, fpath);
+    if (program != NULL)
+        return program;
+
+    Context * context = Context::getInstance();
+    AssetFile vfile(context->getAssetManager(), vpath);
+    AssetFile ffile(context->getAssetManager(), fpath);
+    if (!vfile.open() || !ffile.open()) {
+        LOGE("Unable to read %s or %s", vpath, fpath);
+        return NULL;
+    }
+
+    char * vstr = vfile.toString();
+    char * fstr = ffile.toString();
+    program = std::make_shared<Shader>(LOG_TAG, vpath, vstr, fpath, fstr);
+    bool ret = program->compile();
+    delete [] vstr;
+    delete [] fstr;
+    if (!ret)
+        return NULL;
+    Shader::putShader(program);
+    return program;
+}
+
+// Setup light direction by sky box.
+static Vector4 lightDirOf(enum SkyBoxEnum r) {
+    Vector4 lightDir;
+    float light_scale = 1.5f;
+    switch (r) {
+        case SKYBOX_WATERSKY:
+            lightDir = Vector4(-0.15f, -0.035f, -0.988f, 0.45f);
+            break;
+        case SKYBOX_GALAXY:
+            lightDir = Vector4(0, 0, 1.0f, 0.4f);
+            break;
+        case SKYBOX_CLOUDDAWN:
+            lightDir = Vector4(0.655f, 0.385f, 0.65f, 0.35f);
+            break;
+        case SKYBOX_CLOUDSUN:
+            lightDir = Vector4(0.7f, 0.13f, -0.7f, 0.30f);
+            break;
+        case SKYBOX_GROUNDSKY:
+            lightDir = Vector4(-0.8f, 0.45f, 0.4f, 0.40f);
+            break;
+    }
+    return lightDir * light_scale;
+}
+
+SkyBox::SkyBox(bool debug) : Object(), mGeometry(kFullscreenTriangle), mSource(kCubemap),
+        mCache(kDefaultCacheBudget), mNextRandom(0), mFadeNs(0), mFadeStartNs(0), mFade(1) {
     mName = LOG_TAG;
-    loadShaderFromAsset("shader/vertex/skybox_vertex.glsl", "shader/fragment/skybox_fragment.glsl");
-    if (mHasError)
+    for (int g = 0; g < 2; g++) {
+        for (int f = 0; f < kFragmentCount; f++) {
+            mMatrixLocations[g][f] = -1;
+            mTextureLocations[g][f] = -1;
+            mPreviousTextureLocations[g][f] = -1;
+            mFadeLocations[g][f] = -1;
+        }
+    }
+    if (getProgram(kCubemapFragment) == NULL) {
+        mHasError = true;
         return;
-    mMatrixLocation = mShader->getUniformLocation("matrix");
-    mTextureLocation = mShader->getUniformLocation("atexture");
+    }
 
     mVAO = new VertexArrayObject(true, false);
+
+    // The first sky is needed before the first frame.
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    srand(now.tv_usec);
     if (debug) {
-        mTexture = Texture::loadSkyboxTexture("textures/skybox_simple.jpg");
+        mCurrentAsset = SkyBoxDebugAsset;
         mLightDir = Vector4(0, 0, 0, 1);
     } else {
-        loadRandomTexture();
+        enum SkyBoxEnum r = static_cast<enum SkyBoxEnum>(rand() % 5);
+        mCurrentAsset = SkyBoxList[r];
+        mLightDir = lightDirOf(r);
     }
-    if (mTexture == NULL) {
+    pickNextRandom();
+    mCurrent = mCache.load(mCurrentAsset);
+    if (mCurrent == NULL) {
         mHasError = true;
         return;
     }
@@ -116,54 +204,129 @@ void SkyBox::initVertices() {
     mVAO->unbindVAO();
 }
 
-void SkyBox::loadRandomTexture() {
-    enum SkyBoxEnum r;
+// Picks the sky setDebug(false) goes to next, and keeps it and the debug
+// sky warm.  Never the sky shown or on its way in, so a toggle changes it.
+void SkyBox::pickNextRandom() {
+    const std::string& shown = mNextAsset.empty() ? mCurrentAsset : mNextAsset;
+    mNextRandom = rand() % 5;
+    if (shown == SkyBoxList[mNextRandom])
+        mNextRandom = (mNextRandom + 1 + rand() % 4) % 5;
+    LOGD("Random sky box idx is %d", mNextRandom);
 
-    struct timeval now;
-    gettimeofday(&now, NULL);
-    srand(now.tv_usec);
-    r = static_cast<enum SkyBoxEnum>(rand() % 5);
+    std::vector<std::string> candidates;
+    candidates.push_back(SkyBoxDebugAsset);
+    candidates.push_back(SkyBoxList[mNextRandom]);
+    mCache.setCandidates(candidates);
+}
 
-    LOGD("Random sky box idx is %u", r);
-    mTexture = Texture::loadSkyboxTexture(SkyBoxList[r]);
+Shader * SkyBox::getProgram(Fragment fragment) {
+    std::shared_ptr<Shader>& program = mPrograms[mGeometry][fragment];
+    if (program == NULL) {
+        program = loadProgram(SkyBoxVertexShaders[mGeometry], SkyBoxFragmentShaders[fragment]);
+        if (program == NULL)
+            return NULL;
+        mMatrixLocations[mGeometry][fragment] = program->getUniformLocation("matrix");
+        mTextureLocations[mGeometry][fragment] = program->getUniformLocation("atexture");
+        if (fragment == kCrossFadeFragment) {
+            mPreviousTextureLocations[mGeometry][fragment] = program->getUniformLocation("btexture");
+            mFadeLocations[mGeometry][fragment] = program->getUniformLocation("fade");
+        }
+    }
+    mShader = program;
+    return program.get();
+}
 
-    // Setup light direction by sky box.
-    float light_scale = 1.5f;
-    switch (r) {
-        case SKYBOX_WATERSKY:
-            mLightDir = Vector4(-0.15f, -0.035f, -0.988f, 0.45f);
-            break;
-        case SKYBOX_GALAXY:
-            mLightDir = Vector4(0, 0, 1.0f, 0.4f);
-            break;
-        case SKYBOX_CLOUDDAWN:
-            mLightDir = Vector4(0.655f, 0.385f, 0.65f, 0.35f);
-            break;
-        case SKYBOX_CLOUDSUN:
-            mLightDir = Vector4(0.7f, 0.13f, -0.7f, 0.30f);
-            break;
-        case SKYBOX_GROUNDSKY:
-            mLightDir = Vector4(-0.8f, 0.45f, 0.4f, 0.40f);
-            break;
+void SkyBox::setGeometry(Geometry geometry) {
+    mGeometry = geometry;
+}
+
+bool SkyBox::loadEquirect(const char * assetFile) {
+    Texture * texture = Texture::loadEquirectTexture(assetFile);
+    if (texture == NULL) {
+        LOGE("Unable to load %s", assetFile);
+        return false;
     }
-    mLightDir *= light_scale;
+    mCurrent.reset(texture);
+    mCurrentAsset = assetFile;
+    mPrevious.reset();
+    if (!mNextAsset.empty())
+        mCache.cancel(mNextAsset);
+    mNextAsset.clear();
+    mSource = kEquirect;
+    return true;
 }
 
 void SkyBox::setDebug(bool debug) {
-    if (mTexture != NULL)
-        delete mTexture;
-    mTexture = NULL;
-
     if (debug) {
-        mTexture = Texture::loadSkyboxTexture("textures/skybox_simple.jpg");
-        mLightDir = Vector4(0, 0, 0, 1);
+        switchTo(SkyBoxDebugAsset, Vector4(0, 0, 0, 1));
     } else {
-        loadRandomTexture();
+        enum SkyBoxEnum r = static_cast<enum SkyBoxEnum>(mNextRandom);
+        switchTo(SkyBoxList[r], lightDirOf(r));
+        pickNextRandom();
     }
 }
 
+void SkyBox::switchTo(const char * assetFile, const Vector4& lightDir) {
+    if (!mNextAsset.empty())
+        mCache.cancel(mNextAsset);
+    if (mSource == kCubemap && mCurrentAsset == assetFile) {
+        mNextAsset.clear();
+        return;
+    }
+    mNextAsset = assetFile;
+    mNextLightDir = lightDir;
+    mCache.request(mNextAsset);
+}
+
+bool SkyBox::update(int64_t nowNs) {
+    mCache.update();
+
+    bool changed = false;
+    if (!mNextAsset.empty()) {
+        if (mCache.isResident(mNextAsset)) {
+            swap(nowNs);
+            changed = true;
+        } else if (!mCache.isPending(mNextAsset)) {
+            LOGE("Unable to switch to %s", mNextAsset.c_str());
+            mNextAsset.clear();
+        }
+    }
+
+    if (mPrevious != NULL) {
+        mFade = mFadeNs > 0 ? (float) (nowNs - mFadeStartNs) / mFadeNs : 1;
+        if (mFade >= 1) {
+            mFade = 1;
+            mPrevious.reset();
+        }
+    }
+    return changed;
+}
+
+void SkyBox::swap(int64_t nowNs) {
+    std::shared_ptr<Texture> next = mCache.get(mNextAsset);
+    LOGD("Swap %s for %s", mCurrentAsset.c_str(), mNextAsset.c_str());
+    // Only cubemaps cross-fade.
+    if (mFadeNs > 0 && mSource == kCubemap) {
+        mPrevious = mCurrent;
+        mFadeStartNs = nowNs;
+        mFade = 0;
+    } else {
+        mPrevious.reset();
+        mFade = 1;
+    }
+    mCurrent = next;
+    mCurrentAsset = mNextAsset;
+    mNextAsset.clear();
+    mSource = kCubemap;
+    mLightDir = mNextLightDir;
+}
+
 void SkyBox::draw(const Matrix4& projection, const Matrix4& eye, const Matrix4& view, const Vector4& lightDir) {
-    if (!mEnable)
+    if (!mEnable || !mCurrent || !mVAO)
+        return;
+    const Fragment fragment = mPrevious != NULL ? kCrossFadeFragment : static_cast<Fragment>(mSource);
+    Shader * program = getProgram(fragment);
+    if (program == NULL)
         return;
 
     Matrix4 viewClone = view;
@@ -172,23 +335,38 @@ void SkyBox::draw(const Matrix4& projection, const Matrix4& eye, const Matrix4&
 
     // Skybox didn't need eye.
     Matrix4 matrix = projection * viewClone;
+    if (mGeometry == kFullscreenTriangle)
+        matrix.invert();
 
-    glEnable(GL_DEPTH_TEST);
-    glDepthMask(GL_TRUE);
-
-    if (!mTexture || !mVAO) return;
-    glDepthFunc(GL_LEQUAL);
-    mShader->useProgram();
-    glUniformMatrix4fv(mMatrixLocation, 1, GL_FALSE, matrix.get());
+    RenderState::apply(SkyBoxState);
+    program->useProgram();
+    glUniformMatrix4fv(mMatrixLocations[mGeometry][fragment], 1, GL_FALSE, matrix.get());
     glActiveTexture(GL_TEXTURE0);
-    mTexture->bindTextureCubeMap();
-    glUniform1i(mTextureLocation, 0);
+    if (mSource == kEquirect)
+        mCurrent->bindTexture();
+    else
+        mCurrent->bindTextureCubeMap();
+    glUniform1i(mTextureLocations[mGeometry][fragment], 0);
+    if (fragment == kCrossFadeFragment) {
+        glActiveTexture(GL_TEXTURE1);
+        mPrevious->bindTextureCubeMap();
+        glUniform1i(mPreviousTextureLocations[mGeometry][fragment], 1);
+        glUniform1f(mFadeLocations[mGeometry][fragment], mFade);
+    }
+    // The triangle reads no attributes, but GLES wants a vertex array bound.
     mVAO->bindVAO();
-    glDrawArrays(GL_TRIANGLES, 0, mVertices);
+    const int vertices = mGeometry == kFullscreenTriangle ? 3 : mVertices;
+    glDrawArrays(GL_TRIANGLES, 0, vertices);
+    RenderStats::addDraw(vertices / 3);
 
     mVAO->unbindVAO();
-    mTexture->unbindTextureCubeMap();
-    mShader->unuseProgram();
-
-    glDepthFunc(GL_LESS);
+    if (fragment == kCrossFadeFragment) {
+        mPrevious->unbindTextureCubeMap();
+        glActiveTexture(GL_TEXTURE0);
+    }
+    if (mSource == kEquirect)
+        mCurrent->unbindTexture();
+    else
+        mCurrent->unbindTextureCubeMap();
+    program->unuseProgram();
 }
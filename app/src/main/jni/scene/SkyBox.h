@@ -9,20 +9,76 @@
 // specifications, and documentation provided by HTC to You."
 
 #pragma once
+#include <stdint.h>
+#include <memory>
+#include <string>
 #include <Object.h>
 #include <Vectors.h>
+#include <SkyBoxCache.h>
 
 class Texture;
 class VertexArrayObject;
 class Shader;
 
+// The background, drawn after everything else where the depth buffer is
+// still clear.
+//
+// kFullscreenTriangle draws one triangle at the far plane and finds the
+// view direction per pixel from the inverse view projection, without a
+// vertex buffer.  kCube draws the 36 vertex cube.  Either samples a cubemap
+// cross or, after loadEquirect(), a latitude-longitude panorama.  Depth and
+// culling go through RenderState.
+//
+// Switching cubemaps does not stall a frame.  switchTo() and setDebug()
+// only ask the SkyBoxCache for the next sky; the current one stays on
+// screen until update() finds the next one resident, then the two swap,
+// cross-fading when setCrossFade() gave a time.  The skyboxes setDebug()
+// may switch to next are kept warm in the cache.
 class SkyBox : public Object {
+public:
+    enum Geometry {
+        kCube,
+        kFullscreenTriangle
+    };
+
+    enum Source {
+        kCubemap,
+        kEquirect
+    };
+
+    // The current sky and the next one, with faces up to 1024 pixels.
+    static const size_t kDefaultCacheBudget = 24 * 1024 * 1024;
+
 private:
-    int mMatrixLocation = 0;
-    int mTextureLocation = 0;
+    // The sources, and the cubemap fading in over the one fading out.
+    enum Fragment {
+        kCubemapFragment,
+        kEquirectFragment,
+        kCrossFadeFragment,
+        kFragmentCount
+    };
+
+    Geometry mGeometry;
+    Source mSource;
+    std::shared_ptr<Shader> mPrograms[2][kFragmentCount];   // [Geometry][Fragment], loaded when first drawn
+    int mMatrixLocations[2][kFragmentCount];
+    int mTextureLocations[2][kFragmentCount];
+    int mPreviousTextureLocations[2][kFragmentCount];
+    int mFadeLocations[2][kFragmentCount];
     Vector4 mLightDir;
     const int mVertices = 36;
 
+    SkyBoxCache mCache;
+    std::shared_ptr<Texture> mCurrent;
+    std::string mCurrentAsset;
+    std::shared_ptr<Texture> mPrevious;         // fading out, NULL when not fading
+    std::string mNextAsset;                     // empty when not switching
+    Vector4 mNextLightDir;
+    int mNextRandom;                            // index setDebug(false) goes to
+    int64_t mFadeNs;
+    int64_t mFadeStartNs;
+    float mFade;
+
 public:
     SkyBox(bool debug);
     ~SkyBox();
@@ -31,11 +87,57 @@ public:
         return mLightDir;
     }
 
+    // The debug sky or a random one, once it is loaded.
     void setDebug(bool debug);
+    // Shows a cubemap cross asset once it is loaded.
+    void switchTo(const char * assetFile, const Vector4& lightDir);
+
+    // On the GL thread once per frame, before drawing.  Uploads what the
+    // cache decoded, swaps in the next sky when it is there and advances
+    // the cross-fade.  Returns true when the sky, and so the light
+    // direction, changed.
+    bool update(int64_t nowNs);
+
+    // 0 swaps at once.
+    inline void setCrossFade(float seconds) {
+        mFadeNs = (int64_t) (seconds * 1e9f);
+    }
+
+    inline bool isSwitching() const {
+        return !mNextAsset.empty();
+    }
+
+    inline bool isFading() const {
+        return mPrevious != NULL;
+    }
+
+    inline const std::string& getAsset() const {
+        return mCurrentAsset;
+    }
+
+    inline SkyBoxCache& getCache() {
+        return mCache;
+    }
+
+    void setGeometry(Geometry geometry);
+
+    inline Geometry getGeometry() const {
+        return mGeometry;
+    }
+
+    inline Source getSource() const {
+        return mSource;
+    }
+
+    // Replaces the cubemap with a 2:1 panorama asset, synchronously.
+    // setDebug() goes back to the cubemaps.  The light direction stays.
+    bool loadEquirect(const char * assetFile);
 
 private:
     void initVertices();
-    void loadRandomTexture();
+    void pickNextRandom();
+    void swap(int64_t nowNs);
+    Shader * getProgram(Fragment fragment);
 
 public:
     virtual void draw(const Matrix4& projection, const Matrix4& eye, const Matrix4& view, const Vector4& lightDir);
@@ -0,0 +1,227 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#define LOG_TAG "SkyBoxCache"
+#include <log.h>
+#include <algorithm>
+#include <SkyBoxCache.h>
+#include <Texture.h>
+
+// Uploads per update(), each six faces and a mipmap chain.
+static const uint32_t kUploadsPerUpdate = 1;
+
+SkyBoxCache::SkyBoxCache(size_t budget) : mBudget(budget), mResidentBytes(0), mClock(0) {
+}
+
+SkyBoxCache::~SkyBoxCache() {
+    wait();
+}
+
+void SkyBoxCache::setBudget(size_t budget) {
+    mBudget = budget;
+    evict();
+}
+
+void SkyBoxCache::setCandidates(const std::vector<std::string>& assets) {
+    mCandidates = assets;
+}
+
+int SkyBoxCache::findResident(const std::string& asset) const {
+    for (size_t i = 0; i < mResident.size(); i++) {
+        if (mResident[i].asset == asset)
+            return (int) i;
+    }
+    return -1;
+}
+
+bool SkyBoxCache::isResident(const std::string& asset) const {
+    return findResident(asset) >= 0;
+}
+
+bool SkyBoxCache::isPending(const std::string& asset) const {
+    return std::find(mPending.begin(), mPending.end(), asset) != mPending.end();
+}
+
+bool SkyBoxCache::isFailed(const std::string& asset) const {
+    return std::find(mFailed.begin(), mFailed.end(), asset) != mFailed.end();
+}
+
+bool SkyBoxCache::isCandidate(const std::string& asset) const {
+    return std::find(mCandidates.begin(), mCandidates.end(), asset) != mCandidates.end();
+}
+
+bool SkyBoxCache::isWanted(const std::string& asset) const {
+    return std::find(mWanted.begin(), mWanted.end(), asset) != mWanted.end();
+}
+
+void SkyBoxCache::request(const std::string& asset) {
+    if (!isWanted(asset))
+        mWanted.push_back(asset);
+    decode(asset);
+}
+
+void SkyBoxCache::cancel(const std::string& asset) {
+    std::vector<std::string>::iterator wanted = std::find(mWanted.begin(), mWanted.end(), asset);
+    if (wanted != mWanted.end())
+        mWanted.erase(wanted);
+}
+
+void SkyBoxCache::decode(const std::string& asset) {
+    if (isResident(asset) || isPending(asset))
+        return;
+    mPending.push_back(asset);
+
+    std::function<void()> decodeFunc = [this, asset]() {
+        Decoded decoded;
+        decoded.asset = asset;
+        decoded.data.reset(new CubemapData());
+        if (!Texture::decodeSkybox(asset.c_str(), *decoded.data)) {
+            LOGE("Unable to decode %s", asset.c_str());
+            decoded.data.reset();
+        }
+        std::lock_guard<std::mutex> lock(mDecodedMutex);
+        mDecoded.push_back(std::move(decoded));
+    };
+    JobSystem::getInstance().runBackground(decodeFunc, &mJobs);
+}
+
+std::shared_ptr<Texture> SkyBoxCache::load(const std::string& asset) {
+    std::shared_ptr<Texture> texture = get(asset);
+    if (texture != NULL)
+        return texture;
+
+    CubemapData data;
+    if (!Texture::decodeSkybox(asset.c_str(), data))
+        return NULL;
+    insert(asset, Texture::createCubeMap(data), data.getGpuSize());
+    texture = get(asset);
+    evict();
+    return texture;
+}
+
+std::shared_ptr<Texture> SkyBoxCache::get(const std::string& asset) {
+    int i = findResident(asset);
+    if (i < 0)
+        return NULL;
+    cancel(asset);
+    mResident[i].lastUse = ++mClock;
+    return mResident[i].texture;
+}
+
+void SkyBoxCache::insert(const std::string& asset, Texture * texture, size_t bytes) {
+    Entry entry;
+    entry.asset = asset;
+    entry.texture.reset(texture);
+    entry.bytes = bytes;
+    entry.lastUse = ++mClock;
+    mResident.push_back(entry);
+    mResidentBytes += bytes;
+
+    bool known = false;
+    for (size_t i = 0; i < mKnownBytes.size(); i++) {
+        if (mKnownBytes[i].first == asset) {
+            mKnownBytes[i].second = bytes;
+            known = true;
+        }
+    }
+    if (!known)
+        mKnownBytes.push_back(std::make_pair(asset, bytes));
+}
+
+// Drops the least recently used skyboxes nobody holds or waits for, the
+// candidates last, until the rest fits.
+void SkyBoxCache::evict() {
+    while (mResidentBytes > mBudget) {
+        int victim = -1;
+        bool victimIsCandidate = true;
+        for (size_t i = 0; i < mResident.size(); i++) {
+            const Entry& entry = mResident[i];
+            if (entry.texture.use_count() > 1 || isWanted(entry.asset))
+                continue;
+            bool candidate = isCandidate(entry.asset);
+            if (victim < 0 || (victimIsCandidate && !candidate) ||
+                    (victimIsCandidate == candidate && entry.lastUse < mResident[victim].lastUse)) {
+                victim = (int) i;
+                victimIsCandidate = candidate;
+            }
+        }
+        if (victim < 0)
+            return;
+        LOGD("Evict %s", mResident[victim].asset.c_str());
+        mResidentBytes -= mResident[victim].bytes;
+        mResident.erase(mResident.begin() + victim);
+    }
+}
+
+// The size of the asset when it was resident before, else the mean of
+// the sizes seen so far.
+size_t SkyBoxCache::estimate(const std::string& asset) const {
+    if (mKnownBytes.empty())
+        return 0;
+    size_t total = 0;
+    for (size_t i = 0; i < mKnownBytes.size(); i++) {
+        if (mKnownBytes[i].first == asset)
+            return mKnownBytes[i].second;
+        total += mKnownBytes[i].second;
+    }
+    return total / mKnownBytes.size();
+}
+
+void SkyBoxCache::warmCandidates() {
+    // Without a size to go by, one at a time.
+    if (mKnownBytes.empty() && !mPending.empty())
+        return;
+    size_t bytes = mResidentBytes;
+    for (size_t i = 0; i < mPending.size(); i++)
+        bytes += estimate(mPending[i]);
+
+    for (size_t i = 0; i < mCandidates.size(); i++) {
+        const std::string& asset = mCandidates[i];
+        if (isResident(asset) || isPending(asset) || isFailed(asset))
+            continue;
+        size_t size = estimate(asset);
+        if (bytes + size > mBudget)
+            break;
+        bytes += size;
+        decode(asset);
+        if (size == 0)
+            break;
+    }
+}
+
+uint32_t SkyBoxCache::update() {
+    uint32_t uploads = 0;
+    while (uploads < kUploadsPerUpdate) {
+        Decoded decoded;
+        {
+            std::lock_guard<std::mutex> lock(mDecodedMutex);
+            if (mDecoded.empty())
+                break;
+            decoded = std::move(mDecoded.front());
+            mDecoded.erase(mDecoded.begin());
+        }
+        mPending.erase(std::find(mPending.begin(), mPending.end(), decoded.asset));
+        if (decoded.data == NULL) {
+            if (!isFailed(decoded.asset))
+                mFailed.push_back(decoded.asset);
+            cancel(decoded.asset);
+            continue;
+        }
+        insert(decoded.asset, Texture::createCubeMap(*decoded.data), decoded.data->getGpuSize());
+        uploads++;
+    }
+    evict();
+    warmCandidates();
+    return uploads;
+}
+
+void SkyBoxCache::wait() {
+    JobSystem::getInstance().wait(mJobs);
+}
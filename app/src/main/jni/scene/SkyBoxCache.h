@@ -0,0 +1,118 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <JobSystem.h>
+
+class Texture;
+struct CubemapData;
+
+// Skybox cubemaps kept on the GPU within a byte budget.
+//
+// request() decodes and crops an asset on a JobSystem background job;
+// update() uploads what finished, at most one skybox per call so a frame
+// pays for one upload, and then evicts the least recently used skyboxes
+// over the budget.  A texture somebody still holds from get(), or one
+// requested and not taken with get() yet, is never evicted; the budget
+// gives way rather than a switch.
+//
+// The candidates from setCandidates() are kept warm: update() requests
+// them in order while the estimated total fits in the budget, and they are
+// evicted after every other skybox.  Assets that failed to decode are not
+// warmed again.
+//
+// Everything but the decoding belongs to the GL thread.
+class SkyBoxCache {
+public:
+    explicit SkyBoxCache(size_t budget);
+    // Waits for the decodes in flight.
+    ~SkyBoxCache();
+
+    void setBudget(size_t budget);
+
+    inline size_t getBudget() const {
+        return mBudget;
+    }
+
+    // In priority order.
+    void setCandidates(const std::vector<std::string>& assets);
+
+    // Starts decoding the asset unless it is resident or on the way, and
+    // keeps it until get() takes it.
+    void request(const std::string& asset);
+    // Undoes request(), the asset may be evicted again.  A decode in flight
+    // still finishes.
+    void cancel(const std::string& asset);
+    // Decodes and uploads on the calling thread, for the first skybox.
+    std::shared_ptr<Texture> load(const std::string& asset);
+    // NULL until the asset is resident.  Counts as a use.
+    std::shared_ptr<Texture> get(const std::string& asset);
+
+    bool isResident(const std::string& asset) const;
+    bool isPending(const std::string& asset) const;
+
+    // Returns the number of skyboxes uploaded.
+    uint32_t update();
+    // Blocks until every decode in flight is done, for tests and teardown.
+    void wait();
+
+    inline size_t getResidentBytes() const {
+        return mResidentBytes;
+    }
+
+    inline uint32_t getResidentCount() const {
+        return (uint32_t) mResident.size();
+    }
+
+private:
+    struct Entry {
+        std::string asset;
+        std::shared_ptr<Texture> texture;
+        size_t bytes;
+        uint64_t lastUse;
+    };
+
+    struct Decoded {
+        std::string asset;
+        std::unique_ptr<CubemapData> data;  // NULL when decoding failed
+    };
+
+    int findResident(const std::string& asset) const;
+    void decode(const std::string& asset);
+    bool isWanted(const std::string& asset) const;
+    void insert(const std::string& asset, Texture * texture, size_t bytes);
+    void evict();
+    void warmCandidates();
+    size_t estimate(const std::string& asset) const;
+    bool isCandidate(const std::string& asset) const;
+    bool isFailed(const std::string& asset) const;
+
+    size_t mBudget;
+    size_t mResidentBytes;
+    uint64_t mClock;
+    std::vector<Entry> mResident;
+    std::vector<std::string> mCandidates;
+    std::vector<std::string> mPending;              // decoding or decoded, not uploaded yet
+    std::vector<std::string> mWanted;               // requested, not taken with get() yet
+    std::vector<std::pair<std::string, size_t> > mKnownBytes;
+    std::vector<std::string> mFailed;               // not warmed again
+
+    std::mutex mDecodedMutex;
+    std::vector<Decoded> mDecoded;                  // filled by the workers
+    JobSystem::Counter mJobs;
+};
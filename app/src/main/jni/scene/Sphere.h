@@ -11,8 +11,9 @@
 #ifndef WVR_HELLOVR_SPHERE_H
 #define WVR_HELLOVR_SPHERE_H
 #include <Object.h>
-#include <vector>
-#include <array>
+#include <IndexedMesh.h>
+#include <LodSelector.h>
+#include <memory>
 
 class Sphere : public Object {
 private:
@@ -24,7 +25,9 @@ private:
     int mCameraHandle;
     int mMMatrixHandle;
     int mColor;
-    int vCount = 0;
+    std::shared_ptr<IndexedMesh> mMesh;
+    LodSelector mLod;
+    bool mLodEnable;
 
     Vector4 light_pos_world_space_;
 
@@ -50,10 +53,18 @@ public:
 
 private:
     void initSphere();
-    void initVertexData(std::vector<float>& alVertix);
 
 public:
     virtual void draw(const Matrix4& projection, const Matrix4& eye, const Matrix4& view, const Vector4& lightDir);
     float getRadius();
+
+    // Off draws the full mesh at any distance.
+    inline void setLodEnable(bool enable) {
+        mLodEnable = enable;
+    }
+
+    inline uint32_t getLodLevel() const {
+        return mLod.getLevel();
+    }
     };
 #endif //WVR_HELLOVR_SPHERE_H
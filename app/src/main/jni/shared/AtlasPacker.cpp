@@ -0,0 +1,185 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#define LOG_TAG "AtlasPacker"
+#include <string.h>
+#include <algorithm>
+#include <log.h>
+#include <AtlasPacker.h>
+
+const uint32_t AtlasPacker::kNoPage;
+
+AtlasPacker::AtlasPacker(uint32_t width, uint32_t height, uint32_t padding, uint32_t maxPages) :
+        mWidth(width), mHeight(height), mPadding(padding), mMaxPages(maxPages), mUsedArea(0) {
+}
+
+void AtlasPacker::clear() {
+    mPages.clear();
+    mUsedArea = 0;
+}
+
+bool AtlasPacker::fit(const Skyline& skyline, size_t index, uint32_t w, uint32_t h, uint32_t& y) const {
+    const uint32_t x = skyline[index].x;
+    if (x + w > mWidth)
+        return false;
+
+    // Rest on the highest segment under the span.
+    y = 0;
+    uint32_t covered = 0;
+    for (size_t i = index; covered < w; i++) {
+        if (skyline[i].y > y)
+            y = skyline[i].y;
+        if (y + h > mHeight)
+            return false;
+        covered += skyline[i].width;
+    }
+    return true;
+}
+
+bool AtlasPacker::addToPage(uint32_t page, uint32_t w, uint32_t h, uint32_t& x, uint32_t& y) {
+    Skyline& skyline = mPages[page];
+    size_t best = skyline.size();
+    uint32_t bestTop = 0xFFFFFFFF;
+    uint32_t bestWidth = 0xFFFFFFFF;
+    for (size_t i = 0; i < skyline.size(); i++) {
+        uint32_t top;
+        if (!fit(skyline, i, w, h, top))
+            continue;
+        top += h;
+        if (top < bestTop || (top == bestTop && skyline[i].width < bestWidth)) {
+            best = i;
+            bestTop = top;
+            bestWidth = skyline[i].width;
+        }
+    }
+    if (best == skyline.size())
+        return false;
+
+    x = skyline[best].x;
+    y = bestTop - h;
+
+    // The new segment replaces the span it covers.
+    Segment segment = { x, bestTop, w };
+    skyline.insert(skyline.begin() + best, segment);
+    for (size_t i = best + 1; i < skyline.size();) {
+        const uint32_t end = x + w;
+        if (skyline[i].x >= end)
+            break;
+        const uint32_t overlap = end - skyline[i].x;
+        if (overlap < skyline[i].width) {
+            skyline[i].x += overlap;
+            skyline[i].width -= overlap;
+            break;
+        }
+        skyline.erase(skyline.begin() + i);
+    }
+
+    // Merge neighbours at the same height.
+    for (size_t i = 0; i + 1 < skyline.size();) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        } else {
+            i++;
+        }
+    }
+    return true;
+}
+
+bool AtlasPacker::add(uint32_t w, uint32_t h, Placement& placement) {
+    const uint32_t pw = w + 2 * mPadding;
+    const uint32_t ph = h + 2 * mPadding;
+    placement.page = kNoPage;
+    if (w == 0 || h == 0 || pw > mWidth || ph > mHeight) {
+        LOGW("add: %ux%u does not fit a %ux%u page", w, h, mWidth, mHeight);
+        return false;
+    }
+
+    uint32_t x = 0, y = 0;
+    uint32_t page = 0;
+    for (; page < mPages.size(); page++) {
+        if (addToPage(page, pw, ph, x, y))
+            break;
+    }
+    if (page == mPages.size()) {
+        if (page >= mMaxPages)
+            return false;
+        Segment empty = { 0, 0, mWidth };
+        mPages.push_back(Skyline(1, empty));
+        addToPage(page, pw, ph, x, y);
+    }
+
+    placement.page = page;
+    placement.x = x + mPadding;
+    placement.y = y + mPadding;
+    mUsedArea += (uint64_t) w * h;
+    return true;
+}
+
+bool AtlasPacker::addAll(const uint32_t * widths, const uint32_t * heights, uint32_t count, Placement * placements) {
+    std::vector<uint32_t> order(count);
+    for (uint32_t i = 0; i < count; i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return heights[a] != heights[b] ? heights[a] > heights[b] : widths[a] > widths[b];
+    });
+
+    bool all = true;
+    for (uint32_t i = 0; i < count; i++) {
+        const uint32_t k = order[i];
+        if (!add(widths[k], heights[k], placements[k]))
+            all = false;
+    }
+    return all;
+}
+
+AtlasPacker::Region AtlasPacker::getRegion(const Placement& placement, uint32_t w, uint32_t h) const {
+    if (placement.page == kNoPage)
+        return noRegion();
+    Region region;
+    region.page = placement.page;
+    region.u = (float) placement.x / mWidth;
+    region.v = (float) placement.y / mHeight;
+    region.width = (float) w / mWidth;
+    region.height = (float) h / mHeight;
+    return region;
+}
+
+AtlasPacker::Region AtlasPacker::noRegion() {
+    Region region = { kNoPage, 0, 0, 0, 0 };
+    return region;
+}
+
+float AtlasPacker::getOccupancy() const {
+    if (mPages.empty())
+        return 0;
+    return (float) ((double) mUsedArea / ((double) mWidth * mHeight * mPages.size()));
+}
+
+void AtlasPacker::copyPadded(uint8_t * page, uint32_t pageWidth, uint32_t pageHeight,
+        const uint8_t * pixels, uint32_t w, uint32_t h, const Placement& placement, uint32_t padding) {
+    const int32_t x0 = (int32_t) placement.x - (int32_t) padding;
+    const int32_t y0 = (int32_t) placement.y - (int32_t) padding;
+    const int32_t x1 = (int32_t) (placement.x + w + padding);
+    const int32_t y1 = (int32_t) (placement.y + h + padding);
+    for (int32_t y = y0 < 0 ? 0 : y0; y < y1 && y < (int32_t) pageHeight; y++) {
+        int32_t sy = y - (int32_t) placement.y;
+        sy = sy < 0 ? 0 : (sy >= (int32_t) h ? h - 1 : sy);
+        const uint8_t * src = pixels + (size_t) sy * w * 4;
+        uint8_t * dst = page + ((size_t) y * pageWidth) * 4;
+
+        // Row body in one copy, then the extruded columns.
+        memcpy(dst + (size_t) placement.x * 4, src, (size_t) w * 4);
+        for (int32_t x = x0 < 0 ? 0 : x0; x < (int32_t) placement.x; x++)
+            memcpy(dst + (size_t) x * 4, src, 4);
+        for (int32_t x = placement.x + w; x < x1 && x < (int32_t) pageWidth; x++)
+            memcpy(dst + (size_t) x * 4, src + (size_t) (w - 1) * 4, 4);
+    }
+}
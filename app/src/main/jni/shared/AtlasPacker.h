@@ -0,0 +1,99 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+// Skyline packer for texture atlases made of same sized pages, the layers of
+// a GL_TEXTURE_2D_ARRAY.
+//
+// Every rectangle is placed bottom-left on the page that keeps its top
+// lowest, with padding on all sides.  Fill the padding with copyPadded(),
+// which repeats the edge texels, so linear filtering at the border of a
+// region never picks up a neighbour.  A new page is opened when nothing
+// fits, up to maxPages.
+class AtlasPacker {
+public:
+    static const uint32_t kNoPage = 0xFFFFFFFF;
+
+    // Origin of the content, inside the padding.
+    struct Placement {
+        uint32_t page;
+        uint32_t x;
+        uint32_t y;
+    };
+
+    // Normalized offset and size of a placement, with its layer.
+    struct Region {
+        uint32_t page;      // kNoPage for nothing
+        float u;
+        float v;
+        float width;
+        float height;
+    };
+
+public:
+    AtlasPacker(uint32_t width, uint32_t height, uint32_t padding = 1, uint32_t maxPages = 1);
+
+    // False when the rectangle does not fit in any page there may be.
+    bool add(uint32_t w, uint32_t h, Placement& placement);
+    // Tallest first, which packs a skyline much tighter.  The placements
+    // come back in input order.  False when any of them does not fit.
+    bool addAll(const uint32_t * widths, const uint32_t * heights, uint32_t count, Placement * placements);
+    void clear();
+
+    Region getRegion(const Placement& placement, uint32_t w, uint32_t h) const;
+
+    // Copies RGBA8 pixels into a page and extrudes their edges over the padding.
+    static void copyPadded(uint8_t * page, uint32_t pageWidth, uint32_t pageHeight,
+            const uint8_t * pixels, uint32_t w, uint32_t h, const Placement& placement, uint32_t padding);
+
+    inline uint32_t getWidth() const {
+        return mWidth;
+    }
+
+    inline uint32_t getHeight() const {
+        return mHeight;
+    }
+
+    inline uint32_t getPadding() const {
+        return mPadding;
+    }
+
+    inline uint32_t getPageCount() const {
+        return (uint32_t) mPages.size();
+    }
+
+    // Content area over the area of the pages in use.
+    float getOccupancy() const;
+
+    static Region noRegion();
+
+private:
+    struct Segment {
+        uint32_t x;
+        uint32_t y;
+        uint32_t width;
+    };
+    typedef std::vector<Segment> Skyline;
+
+    // Lowest y for a w wide rectangle starting at segment index, or false.
+    bool fit(const Skyline& skyline, size_t index, uint32_t w, uint32_t h, uint32_t& y) const;
+    bool addToPage(uint32_t page, uint32_t w, uint32_t h, uint32_t& x, uint32_t& y);
+
+    uint32_t mWidth;
+    uint32_t mHeight;
+    uint32_t mPadding;
+    uint32_t mMaxPages;
+    std::vector<Skyline> mPages;
+    uint64_t mUsedArea;
+};
@@ -0,0 +1,193 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#include <algorithm>
+#include <BVH.h>
+
+namespace {
+    const uint32_t kBinCount = 12;
+    // The raycast stack holds two entries per level.
+    const uint32_t kMaxDepth = 30;
+    // Rebuild once refits have doubled the summed node surface area, which
+    // tracks the expected traversal cost.
+    const float kRebuildAreaRatio = 2.0f;
+}
+
+const uint32_t BVH::kMaxLeafSize;
+const int32_t BVH::kInvalid;
+
+BVH::BVH() : mBuiltArea(0), mArea(0) {
+}
+
+void BVH::clear() {
+    mNodes.clear();
+    mPrimitives.clear();
+    mLeafOf.clear();
+    mBuiltArea = 0;
+    mArea = 0;
+}
+
+void BVH::build(const AABB * boxes, const uint32_t * ids, uint32_t count) {
+    clear();
+    if (count == 0)
+        return;
+
+    uint32_t maxId = 0;
+    for (uint32_t i = 0; i < count; i++)
+        maxId = std::max(maxId, ids[i]);
+    mLeafOf.assign(maxId + 1, kInvalid);
+    mCentroids.resize(maxId + 1);
+    for (uint32_t i = 0; i < count; i++)
+        mCentroids[ids[i]] = boxes[ids[i]].center();
+
+    mPrimitives.assign(ids, ids + count);
+    mNodes.reserve(2 * count);
+    mNodes.push_back(Node());
+    buildNode(boxes, 0, 0, count, kInvalid, 0);
+
+    mBuiltArea = 0;
+    for (size_t i = 0; i < mNodes.size(); i++)
+        mBuiltArea += mNodes[i].bounds.surfaceArea();
+    mArea = mBuiltArea;
+}
+
+void BVH::buildNode(const AABB * boxes, int32_t index, uint32_t first, uint32_t count, int32_t parent, uint32_t depth) {
+    Node node;
+    node.parent = parent;
+    node.left = kInvalid;
+    node.first = first;
+    node.count = count;
+
+    AABB centroidBounds;
+    for (uint32_t i = first; i < first + count; i++) {
+        node.bounds.expand(boxes[mPrimitives[i]]);
+        centroidBounds.expand(mCentroids[mPrimitives[i]]);
+    }
+
+    if (count <= kMaxLeafSize || depth >= kMaxDepth) {
+        mNodes[index] = node;
+        for (uint32_t i = first; i < first + count; i++)
+            mLeafOf[mPrimitives[i]] = index;
+        return;
+    }
+
+    // Binned SAH on the longest centroid axis.
+    Vector3 extent = centroidBounds.extent();
+    int axis = 0;
+    if (extent.y > extent[axis]) axis = 1;
+    if (extent.z > extent[axis]) axis = 2;
+
+    uint32_t mid = first;
+    if (extent[axis] > 0) {
+        AABB binBounds[kBinCount];
+        uint32_t binCount[kBinCount] = {0};
+        const float lo = centroidBounds.min[axis];
+        const float scale = kBinCount / extent[axis];
+        for (uint32_t i = first; i < first + count; i++) {
+            uint32_t b = std::min(kBinCount - 1, (uint32_t) ((mCentroids[mPrimitives[i]][axis] - lo) * scale));
+            binCount[b]++;
+            binBounds[b].expand(boxes[mPrimitives[i]]);
+        }
+
+        float leftArea[kBinCount];
+        uint32_t leftCount[kBinCount];
+        AABB acc;
+        uint32_t n = 0;
+        for (uint32_t b = 0; b < kBinCount; b++) {
+            acc.expand(binBounds[b]);
+            n += binCount[b];
+            leftArea[b] = acc.surfaceArea();
+            leftCount[b] = n;
+        }
+        // Split between bin b - 1 and b.
+        float bestCost = FLT_MAX;
+        uint32_t bestSplit = 0;
+        acc = AABB();
+        n = 0;
+        for (uint32_t b = kBinCount - 1; b > 0; b--) {
+            acc.expand(binBounds[b]);
+            n += binCount[b];
+            if (leftCount[b - 1] == 0 || n == 0)
+                continue;
+            float cost = leftArea[b - 1] * leftCount[b - 1] + acc.surfaceArea() * n;
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestSplit = b;
+            }
+        }
+
+        if (bestSplit > 0) {
+            uint32_t * begin = &mPrimitives[first];
+            uint32_t * split = std::partition(begin, begin + count, [&](uint32_t id) {
+                uint32_t b = std::min(kBinCount - 1, (uint32_t) ((mCentroids[id][axis] - lo) * scale));
+                return b < bestSplit;
+            });
+            mid = first + (uint32_t) (split - begin);
+        }
+    }
+
+    // Coincident centroids, split at the median instead.
+    if (mid == first || mid == first + count) {
+        mid = first + count / 2;
+        uint32_t * begin = &mPrimitives[first];
+        std::nth_element(begin, begin + count / 2, begin + count, [&](uint32_t a, uint32_t b) {
+            return mCentroids[a][axis] < mCentroids[b][axis];
+        });
+    }
+
+    // Children are allocated as a pair so the right one is always left + 1,
+    // and always after their parent.
+    node.left = (int32_t) mNodes.size();
+    node.first = 0;
+    node.count = 0;
+    mNodes.push_back(Node());
+    mNodes.push_back(Node());
+    mNodes[index] = node;
+
+    buildNode(boxes, node.left, first, mid - first, index, depth + 1);
+    buildNode(boxes, node.left + 1, mid, first + count - mid, index, depth + 1);
+}
+
+void BVH::refit(const AABB * boxes, const uint32_t * changed, uint32_t count) {
+    for (uint32_t c = 0; c < count; c++) {
+        const uint32_t id = changed[c];
+        if (id >= mLeafOf.size() || mLeafOf[id] == kInvalid)
+            continue;
+
+        int32_t index = mLeafOf[id];
+        Node& leaf = mNodes[index];
+        AABB bounds;
+        for (uint32_t i = leaf.first; i < leaf.first + leaf.count; i++)
+            bounds.expand(boxes[mPrimitives[i]]);
+        if (bounds == leaf.bounds)
+            continue;
+        mArea += bounds.surfaceArea() - leaf.bounds.surfaceArea();
+        leaf.bounds = bounds;
+
+        // Walk up until an ancestor does not change.
+        index = leaf.parent;
+        while (index != kInvalid) {
+            Node& node = mNodes[index];
+            AABB merged = mNodes[node.left].bounds;
+            merged.expand(mNodes[node.left + 1].bounds);
+            if (merged == node.bounds)
+                break;
+            mArea += merged.surfaceArea() - node.bounds.surfaceArea();
+            node.bounds = merged;
+            index = node.parent;
+        }
+    }
+}
+
+bool BVH::needsRebuild() const {
+    if (mNodes.empty() || mBuiltArea <= 0)
+        return false;
+    return mArea > mBuiltArea * kRebuildAreaRatio;
+}
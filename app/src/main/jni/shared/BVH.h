@@ -0,0 +1,118 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <BoundingVolume.h>
+
+// Bounding volume hierarchy over caller owned boxes.  Built top down with a
+// binned SAH split and stored depth first in one array, so a parent always
+// precedes its children.  Moving primitives are handled by refit(), which
+// only walks from the changed leaves to the root.  Call build() again when
+// primitives are added or removed, or when needsRebuild() says the refitted
+// tree has degraded.
+class BVH {
+public:
+    static const uint32_t kMaxLeafSize = 4;
+    static const int32_t kInvalid = -1;
+
+    struct Node {
+        AABB bounds;
+        int32_t left;       // index of the left child, the right child is left + 1.  kInvalid on leaves.
+        int32_t parent;
+        uint32_t first;     // first entry in getPrimitives() for leaves
+        uint32_t count;     // number of primitives, 0 for inner nodes
+    };
+
+public:
+    BVH();
+
+    // Build over the primitive ids in ids, with boxes indexed by primitive id.
+    void build(const AABB * boxes, const uint32_t * ids, uint32_t count);
+
+    // Update the bounds of the given primitives and their ancestors.
+    void refit(const AABB * boxes, const uint32_t * changed, uint32_t count);
+
+    void clear();
+
+    inline bool isEmpty() const {
+        return mNodes.empty();
+    }
+
+    // True when refits have grown the tree well past its built quality.
+    bool needsRebuild() const;
+
+    inline const std::vector<Node>& getNodes() const {
+        return mNodes;
+    }
+
+    inline const std::vector<uint32_t>& getPrimitives() const {
+        return mPrimitives;
+    }
+
+    // Visit leaves hit by the ray, nearest first.  The visitor is called as
+    // bool visitor(uint32_t primitive, float & tMax) and may shrink tMax to
+    // prune the rest of the walk.  Returning true stops the walk.
+    template <typename Visitor>
+    void raycast(const Ray& ray, float tMin, float tMax, Visitor& visitor) const {
+        if (mNodes.empty())
+            return;
+        float tNear;
+        if (!mNodes[0].bounds.intersect(ray, tMin, tMax, tNear))
+            return;
+
+        struct Entry { int32_t node; float t; };
+        Entry stack[64];
+        int sp = 0;
+        stack[sp++] = { 0, tNear };
+        while (sp > 0) {
+            const Entry e = stack[--sp];
+            if (e.t > tMax)
+                continue;
+            const Node& node = mNodes[e.node];
+            if (node.count > 0) {
+                for (uint32_t i = 0; i < node.count; i++) {
+                    if (visitor(mPrimitives[node.first + i], tMax))
+                        return;
+                }
+                continue;
+            }
+            float tl, tr;
+            bool hl = mNodes[node.left].bounds.intersect(ray, tMin, tMax, tl);
+            bool hr = mNodes[node.left + 1].bounds.intersect(ray, tMin, tMax, tr);
+            // Push the far child first so the near one is popped next.
+            if (hl && hr) {
+                if (tl <= tr) {
+                    stack[sp++] = { node.left + 1, tr };
+                    stack[sp++] = { node.left, tl };
+                } else {
+                    stack[sp++] = { node.left, tl };
+                    stack[sp++] = { node.left + 1, tr };
+                }
+            } else if (hl) {
+                stack[sp++] = { node.left, tl };
+            } else if (hr) {
+                stack[sp++] = { node.left + 1, tr };
+            }
+        }
+    }
+
+private:
+    void buildNode(const AABB * boxes, int32_t index, uint32_t first, uint32_t count, int32_t parent, uint32_t depth);
+
+    std::vector<Node> mNodes;
+    std::vector<uint32_t> mPrimitives;
+    std::vector<int32_t> mLeafOf;           // primitive id -> leaf node
+    std::vector<Vector3> mCentroids;        // scratch, indexed by primitive id
+    float mBuiltArea;                       // summed node surface area after build()
+    float mArea;                            // and after refits
+};
@@ -0,0 +1,179 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+
+#include <float.h>
+#include <math.h>
+#include <Vectors.h>
+#include <Matrices.h>
+
+// fminf/fmaxf honour NaN and usually end up as library calls; these compile
+// to single min/max instructions.
+inline float minf(float a, float b) { return a < b ? a : b; }
+inline float maxf(float a, float b) { return a > b ? a : b; }
+
+// Ray with a precomputed reciprocal direction for slab tests.  The direction
+// does not need to be normalized; distances are in units of the direction.
+struct Ray {
+    Vector3 origin;
+    Vector3 direction;
+    Vector3 invDirection;
+
+    Ray() {}
+    Ray(const Vector3& o, const Vector3& d) { set(o, d); }
+
+    inline void set(const Vector3& o, const Vector3& d) {
+        origin = o;
+        direction = d;
+        // 1/0 gives +-inf which the slab test handles, except 0*inf.  Nudge exact zeros.
+        invDirection.x = 1.0f / (d.x != 0.0f ? d.x : 1e-30f);
+        invDirection.y = 1.0f / (d.y != 0.0f ? d.y : 1e-30f);
+        invDirection.z = 1.0f / (d.z != 0.0f ? d.z : 1e-30f);
+    }
+
+    inline Vector3 at(float t) const {
+        return origin + direction * t;
+    }
+
+    // Ray in the space of the inverse of a transform.  The parameter t is preserved.
+    inline Ray transformed(const Matrix4& inverse) const {
+        const float * m = inverse.get();
+        Vector3 o(m[0] * origin.x + m[4] * origin.y + m[8] * origin.z + m[12],
+                  m[1] * origin.x + m[5] * origin.y + m[9] * origin.z + m[13],
+                  m[2] * origin.x + m[6] * origin.y + m[10] * origin.z + m[14]);
+        Vector3 d(m[0] * direction.x + m[4] * direction.y + m[8] * direction.z,
+                  m[1] * direction.x + m[5] * direction.y + m[9] * direction.z,
+                  m[2] * direction.x + m[6] * direction.y + m[10] * direction.z);
+        return Ray(o, d);
+    }
+};
+
+struct AABB {
+    Vector3 min;
+    Vector3 max;
+
+    AABB() : min(FLT_MAX, FLT_MAX, FLT_MAX), max(-FLT_MAX, -FLT_MAX, -FLT_MAX) {}
+    AABB(const Vector3& mn, const Vector3& mx) : min(mn), max(mx) {}
+
+    inline bool isEmpty() const {
+        return min.x > max.x || min.y > max.y || min.z > max.z;
+    }
+
+    inline void expand(const Vector3& p) {
+        min.x = minf(min.x, p.x); min.y = minf(min.y, p.y); min.z = minf(min.z, p.z);
+        max.x = maxf(max.x, p.x); max.y = maxf(max.y, p.y); max.z = maxf(max.z, p.z);
+    }
+
+    inline void expand(const AABB& b) {
+        min.x = minf(min.x, b.min.x); min.y = minf(min.y, b.min.y); min.z = minf(min.z, b.min.z);
+        max.x = maxf(max.x, b.max.x); max.y = maxf(max.y, b.max.y); max.z = maxf(max.z, b.max.z);
+    }
+
+    inline Vector3 center() const {
+        return (min + max) * 0.5f;
+    }
+
+    inline Vector3 extent() const {
+        return max - min;
+    }
+
+    inline float surfaceArea() const {
+        if (isEmpty())
+            return 0;
+        Vector3 e = max - min;
+        return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+    }
+
+    inline bool contains(const AABB& b) const {
+        return b.min.x >= min.x && b.min.y >= min.y && b.min.z >= min.z &&
+               b.max.x <= max.x && b.max.y <= max.y && b.max.z <= max.z;
+    }
+
+    inline bool operator==(const AABB& b) const {
+        return min == b.min && max == b.max;
+    }
+
+    // Bounds of this box after an affine transform (Arvo's method).
+    inline AABB transformed(const Matrix4& mat) const {
+        const float * m = mat.get();
+        AABB out(Vector3(m[12], m[13], m[14]), Vector3(m[12], m[13], m[14]));
+        for (int col = 0; col < 3; col++) {
+            for (int row = 0; row < 3; row++) {
+                float a = m[col * 4 + row] * min[col];
+                float b = m[col * 4 + row] * max[col];
+                out.min[row] += minf(a, b);
+                out.max[row] += maxf(a, b);
+            }
+        }
+        return out;
+    }
+
+    // Slab test.  On hit tNear is the entry distance, clamped to tMin.
+    inline bool intersect(const Ray& ray, float tMin, float tMax, float& tNear) const {
+        float t0 = (min.x - ray.origin.x) * ray.invDirection.x;
+        float t1 = (max.x - ray.origin.x) * ray.invDirection.x;
+        float lo = minf(t0, t1), hi = maxf(t0, t1);
+        t0 = (min.y - ray.origin.y) * ray.invDirection.y;
+        t1 = (max.y - ray.origin.y) * ray.invDirection.y;
+        lo = maxf(lo, minf(t0, t1)); hi = minf(hi, maxf(t0, t1));
+        t0 = (min.z - ray.origin.z) * ray.invDirection.z;
+        t1 = (max.z - ray.origin.z) * ray.invDirection.z;
+        lo = maxf(lo, minf(t0, t1)); hi = minf(hi, maxf(t0, t1));
+        lo = maxf(lo, tMin);
+        hi = minf(hi, tMax);
+        tNear = lo;
+        return lo <= hi;
+    }
+};
+
+// Distance along the ray to a sphere.  A ray starting inside hits the far side.
+inline bool intersectSphere(const Ray& ray, const Vector3& center, float radius, float tMin, float tMax, float& t) {
+    Vector3 oc = ray.origin - center;
+    float a = ray.direction.dot(ray.direction);
+    float b = oc.dot(ray.direction);
+    float c = oc.dot(oc) - radius * radius;
+    float disc = b * b - a * c;
+    if (disc < 0 || a == 0)
+        return false;
+    float s = sqrtf(disc);
+    float root = (-b - s) / a;
+    if (root < tMin)
+        root = (-b + s) / a;
+    if (root < tMin || root > tMax)
+        return false;
+    t = root;
+    return true;
+}
+
+// Moller-Trumbore, double sided.
+inline bool intersectTriangle(const Ray& ray, const Vector3& v0, const Vector3& v1, const Vector3& v2,
+        float tMin, float tMax, float& t) {
+    Vector3 e1 = v1 - v0;
+    Vector3 e2 = v2 - v0;
+    Vector3 p = ray.direction.cross(e2);
+    float det = e1.dot(p);
+    if (fabsf(det) < 1e-12f)
+        return false;
+    float invDet = 1.0f / det;
+    Vector3 s = ray.origin - v0;
+    float u = s.dot(p) * invDet;
+    if (u < 0 || u > 1)
+        return false;
+    Vector3 q = s.cross(e1);
+    float v = ray.direction.dot(q) * invDet;
+    if (v < 0 || u + v > 1)
+        return false;
+    float root = e2.dot(q) * invDet;
+    if (root < tMin || root > tMax)
+        return false;
+    t = root;
+    return true;
+}
@@ -0,0 +1,189 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#define LOG_TAG "Foveation"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <log.h>
+#include <Foveation.h>
+
+namespace {
+struct PresetData {
+    float fovealFov;
+    Foveation::Quality peripheral;
+};
+
+const PresetData kPresets[Foveation::kPresetCount] = {
+    { 45.0f, Foveation::kQualityHigh },
+    { 38.0f, Foveation::kQualityMedium },
+    { 30.0f, Foveation::kQualityLow },
+};
+
+// Fovea at zero strength, wide enough to cover the view.
+const float kIdleFov = 90.0f;
+
+// Fractions of the budget where foveation ramps in and out.
+const float kRampInLoad = 0.85f;
+const float kRampOutLoad = 0.65f;
+// Strength change per frame: in quickly, out slowly so it does not pump.
+const float kRampIn = 0.1f;
+const float kRampOut = 0.02f;
+const float kSmoothing = 0.25f;
+}
+
+Foveation::Foveation() :
+        mMode(kOff), mPreset(kPresetLow), mForced(false), mBudget(1.0f / 75 * 0.9f),
+        mSmoothed(0), mStrength(0), mFocus(0, 0, -1) {
+}
+
+void Foveation::setMode(Mode mode) {
+    if (mode < kOff || mode >= kModeCount) {
+        LOGE("setMode: invalid mode %d", mode);
+        return;
+    }
+    if (mode != mMode)
+        LOGI("Foveation mode %s", getModeName(mode));
+    mMode = mode;
+    if (mode != kGaze && mode != kController)
+        mFocus = Vector3(0, 0, -1);
+}
+
+void Foveation::setPreset(Preset preset) {
+    if (preset < kPresetHigh || preset >= kPresetCount) {
+        LOGE("setPreset: invalid preset %d", preset);
+        return;
+    }
+    mPreset = preset;
+}
+
+void Foveation::setBudget(float seconds) {
+    if (seconds > 0)
+        mBudget = seconds;
+}
+
+void Foveation::update(float gpuSeconds) {
+    if (mMode == kOff) {
+        mStrength = 0;
+        return;
+    }
+    if (gpuSeconds <= 0)
+        return;
+    mSmoothed = mSmoothed == 0 ? gpuSeconds : mSmoothed + (gpuSeconds - mSmoothed) * kSmoothing;
+
+    const float load = mSmoothed / mBudget;
+    if (load > kRampInLoad)
+        mStrength = mStrength + kRampIn > 1 ? 1 : mStrength + kRampIn;
+    else if (load < kRampOutLoad)
+        mStrength = mStrength - kRampOut < 0 ? 0 : mStrength - kRampOut;
+}
+
+bool Foveation::getParams(const Matrix4& projection, Params& params) const {
+    if (!isActive())
+        return false;
+    const float strength = getStrength();
+
+    directionToNdc(projection, mFocus, params.focalX, params.focalY);
+
+    const PresetData& preset = kPresets[mPreset];
+    params.fovealFov = kIdleFov + (preset.fovealFov - kIdleFov) * strength;
+    // Lower the periphery in steps as the strength grows.
+    Quality quality = strength < 0.34f ? kQualityHigh : (strength < 0.67f ? kQualityMedium : kQualityLow);
+    params.peripheral = quality > preset.peripheral ? quality : preset.peripheral;
+    return true;
+}
+
+// A direction projects like a point at infinity, w = 0.
+void Foveation::directionToNdc(const Matrix4& projection, const Vector3& direction, float& x, float& y) {
+    const float * p = projection.get();
+    const float w = p[3] * direction.x + p[7] * direction.y + p[11] * direction.z;
+    if (w <= 1e-6f) {
+        x = y = 0;
+        return;
+    }
+    x = (p[0] * direction.x + p[4] * direction.y + p[8] * direction.z) / w;
+    y = (p[1] * direction.x + p[5] * direction.y + p[9] * direction.z) / w;
+    x = x < -1 ? -1 : (x > 1 ? 1 : x);
+    y = y < -1 ? -1 : (y > 1 ? 1 : y);
+}
+
+const char * Foveation::getModeName(Mode mode) {
+    switch (mode) {
+    case kOff: return "off";
+    case kFixed: return "fixed";
+    case kGaze: return "gaze";
+    case kController: return "controller";
+    default: return "unknown";
+    }
+}
+
+bool FoveationTrace::parse(const char * text) {
+    clear();
+    if (text == NULL)
+        return false;
+    const char * line = text;
+    while (*line) {
+        const char * next = strchr(line, '\n');
+        if (line[0] != '#') {
+            float t, x, y, z;
+            if (sscanf(line, "%f %f %f %f", &t, &x, &y, &z) == 4)
+                add(t, Vector3(x, y, z));
+        }
+        if (next == NULL)
+            break;
+        line = next + 1;
+    }
+    return !mTimes.empty();
+}
+
+void FoveationTrace::add(float seconds, const Vector3& direction) {
+    if (!mTimes.empty() && seconds < mTimes.back()) {
+        LOGW("add: %f is before the previous sample, skipped", seconds);
+        return;
+    }
+    mTimes.push_back(seconds);
+    mDirections.push_back(direction);
+}
+
+void FoveationTrace::clear() {
+    mTimes.clear();
+    mDirections.clear();
+}
+
+Vector3 FoveationTrace::sample(float seconds) const {
+    if (mTimes.empty())
+        return Vector3(0, 0, -1);
+    const float duration = getDuration();
+    if (duration > 0) {
+        seconds = fmodf(seconds, duration);
+        if (seconds < 0)
+            seconds += duration;
+    }
+
+    // Last sample at or before seconds.
+    uint32_t lo = 0, hi = (uint32_t) mTimes.size() - 1;
+    Vector3 d;
+    if (seconds <= mTimes[lo] || lo == hi) {
+        d = mDirections[lo];
+        return d.normalize();
+    }
+    while (hi - lo > 1) {
+        const uint32_t mid = (lo + hi) / 2;
+        if (mTimes[mid] <= seconds)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    const float span = mTimes[hi] - mTimes[lo];
+    const float f = span > 0 ? (seconds - mTimes[lo]) / span : 0;
+    d = mDirections[lo] + (mDirections[hi] - mDirections[lo]) * f;
+    return d.normalize();
+}
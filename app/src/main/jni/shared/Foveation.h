@@ -0,0 +1,140 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <Matrices.h>
+
+// Foveated rendering parameters, chosen at run time.
+//
+// The focal point follows a head space direction: straight ahead in kFixed,
+// or whatever setFocusDirection() was last given in kGaze and kController,
+// such as an eye tracker sample, the controller ray, or a FoveationTrace.
+// Foveation ramps in while the GPU time nears its budget and back out once
+// there is room again, unless it is forced on.  It starts below the budget
+// the resolution controller aims for, so it is spent before resolution.
+class Foveation {
+public:
+    enum Mode {
+        kOff,
+        kFixed,
+        kGaze,
+        kController,
+        kModeCount
+    };
+
+    // Fovea size and peripheral quality at full strength.
+    enum Preset {
+        kPresetHigh,    // widest fovea, peripheral quality kept high
+        kPresetMedium,
+        kPresetLow,     // 30 degrees, low peripheral quality
+        kPresetCount
+    };
+
+    // In the order of WVR_PeripheralQuality.
+    enum Quality {
+        kQualityLow,
+        kQualityMedium,
+        kQualityHigh
+    };
+
+    struct Params {
+        float focalX;       // NDC
+        float focalY;
+        float fovealFov;    // degrees
+        Quality peripheral;
+    };
+
+public:
+    Foveation();
+
+    void setMode(Mode mode);
+    inline Mode getMode() const {
+        return mMode;
+    }
+
+    void setPreset(Preset preset);
+    inline Preset getPreset() const {
+        return mPreset;
+    }
+
+    // Full strength regardless of load, for A/B comparisons.
+    inline void setForced(bool forced) {
+        mForced = forced;
+    }
+
+    // GPU seconds per frame that count as fully loaded.
+    void setBudget(float seconds);
+
+    // Head space, need not be normalized.
+    inline void setFocusDirection(const Vector3& direction) {
+        mFocus = direction;
+    }
+
+    // Once per frame.  gpuSeconds is 0 when no measurement arrived.
+    void update(float gpuSeconds);
+
+    // 0 is no foveation, 1 is the full preset.
+    inline float getStrength() const {
+        return mForced ? 1.0f : mStrength;
+    }
+
+    // True while getParams() has parameters to give.
+    inline bool isActive() const {
+        return mMode != kOff && getStrength() > 0;
+    }
+
+    // The parameters for an eye with this projection.  False when
+    // foveation should not be applied this frame.
+    bool getParams(const Matrix4& projection, Params& params) const;
+
+    // Head space direction to NDC.  Directions behind the eye map to the
+    // center.
+    static void directionToNdc(const Matrix4& projection, const Vector3& direction, float& x, float& y);
+
+    static const char * getModeName(Mode mode);
+
+private:
+    Mode mMode;
+    Preset mPreset;
+    bool mForced;
+    float mBudget;
+    float mSmoothed;
+    float mStrength;
+    Vector3 mFocus;
+};
+
+// Recorded focus directions, for replaying gaze without an eye tracker.
+// Text, one sample per line: seconds x y z.  Lines starting with # are
+// skipped.
+class FoveationTrace {
+public:
+    bool parse(const char * text);
+    void add(float seconds, const Vector3& direction);
+    void clear();
+
+    // Interpolated, looping over the length of the trace.
+    Vector3 sample(float seconds) const;
+
+    inline uint32_t getCount() const {
+        return (uint32_t) mTimes.size();
+    }
+
+    inline float getDuration() const {
+        return mTimes.empty() ? 0 : mTimes.back();
+    }
+
+private:
+    std::vector<float> mTimes;
+    std::vector<Vector3> mDirections;
+};
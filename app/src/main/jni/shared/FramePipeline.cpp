@@ -0,0 +1,100 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#define LOG_TAG "FramePipeline"
+#include <log.h>
+#include <FramePipeline.h>
+
+FramePipeline::FramePipeline()
+        : mMode(kSerial)
+        , mStage(NULL)
+        , mRequested(0)
+        , mCompleted(0)
+        , mWaited(0)
+        , mQuit(false) {
+}
+
+FramePipeline::~FramePipeline() {
+    stop();
+}
+
+bool FramePipeline::start(Mode mode, Stage * stage) {
+    if (stage == NULL || mode >= kModeCount) {
+        LOGE("start: bad mode %d or stage", mode);
+        return false;
+    }
+    stop();
+    mMode = mode;
+    mStage = stage;
+    mRequested = mCompleted = mWaited = 0;
+    mQuit = false;
+    if (mMode != kSerial)
+        mThread = std::thread(&FramePipeline::run, this);
+    LOGI("Frame pipeline %s", mMode == kSerial ? "serial" : mMode == kLockstep ? "lockstep" : "overlap");
+    return true;
+}
+
+void FramePipeline::stop() {
+    if (mThread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mQuit = true;
+        }
+        mKicked.notify_one();
+        mThread.join();
+        mWaited = mRequested;
+    }
+    mStage = NULL;
+}
+
+void FramePipeline::kick() {
+    if (mStage == NULL)
+        return;
+    if (mMode == kSerial) {
+        mStage->simulate();
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDone.wait(lock, [this] { return mCompleted == mRequested; });
+    mWaited = mRequested;
+    mRequested++;
+    lock.unlock();
+    mKicked.notify_one();
+}
+
+void FramePipeline::wait() {
+    if (mMode == kSerial || mStage == NULL)
+        return;
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDone.wait(lock, [this] { return mCompleted == mRequested; });
+    mWaited = mRequested;
+}
+
+uint32_t FramePipeline::getPending() const {
+    // Both counts only change on the render thread.
+    return mRequested - mWaited;
+}
+
+void FramePipeline::run() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+        // A pending simulation still runs on quit, so its producer is never
+        // left waiting on it.
+        mKicked.wait(lock, [this] { return mQuit || mCompleted != mRequested; });
+        if (mCompleted == mRequested)
+            break;
+        lock.unlock();
+        mStage->simulate();
+        lock.lock();
+        mCompleted++;
+        mDone.notify_all();
+    }
+}
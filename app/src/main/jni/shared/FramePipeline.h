@@ -0,0 +1,82 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#pragma once
+
+#include <stdint.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Runs the simulation half of a frame, on its own thread or inline.
+//
+// The render thread kick()s one simulation per frame and wait()s for it to
+// finish.  What the simulation produces goes through a TripleBuffer, so this
+// class only paces the two threads.
+//
+//   kSerial    simulate() runs inside kick(), on the caller's thread.
+//   kLockstep  simulate() runs on the worker; the render thread waits for
+//              the frame it is about to draw.
+//   kOverlap   the render thread draws frame N while the worker simulates
+//              N + 1.  Input reaches the screen one frame later, in exchange
+//              for the simulation leaving the critical path.
+class FramePipeline {
+public:
+    enum Mode {
+        kSerial,
+        kLockstep,
+        kOverlap,
+        kModeCount
+    };
+
+    class Stage {
+    public:
+        virtual ~Stage() {}
+        virtual void simulate() = 0;
+    };
+
+public:
+    FramePipeline();
+    ~FramePipeline();
+
+    // Starts the worker for the threaded modes.  stop() before the stage goes away.
+    bool start(Mode mode, Stage * stage);
+    // Finishes a pending simulation and joins the worker.
+    void stop();
+
+    inline Mode getMode() const {
+        return mMode;
+    }
+    inline bool isRunning() const {
+        return mStage != NULL;
+    }
+
+    // Render thread.  At most one simulation is pending; kick() waits for
+    // the previous one first.
+    void kick();
+    void wait();
+    // Simulations kicked and not waited for yet, 0 or 1.
+    uint32_t getPending() const;
+
+private:
+    void run();
+
+    Mode mMode;
+    Stage * mStage;
+    std::thread mThread;
+    std::mutex mMutex;
+    std::condition_variable mKicked;
+    std::condition_variable mDone;
+    uint32_t mRequested;
+    uint32_t mCompleted;
+    uint32_t mWaited;               // render thread only
+    bool mQuit;
+};
@@ -0,0 +1,228 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#include <atomic>
+#include <Frustum.h>
+#include <JobSystem.h>
+#include <RayPacket.h>
+
+const uint32_t FrustumCuller::kAlwaysVisible;
+const uint32_t FrustumCuller::kJobGrain;
+
+Frustum::Frustum() {
+    for (int i = 0; i < kPlaneCount; i++) {
+        mPlanes[i].normal.set(0, 0, 0);
+        mPlanes[i].d = 0;
+    }
+    for (int i = 0; i < 8; i++)
+        mCorners[i].set(0, 0, 0);
+}
+
+void Frustum::set(const Matrix4& viewProjection) {
+    // Gribb and Hartmann: clip space planes are sums of the matrix rows.
+    const float * m = viewProjection.get();
+    const float signs[kPlaneCount] = { 1, -1, 1, -1, 1, -1 };
+    for (int i = 0; i < kPlaneCount; i++) {
+        const int row = i / 2;
+        const float s = signs[i];
+        Vector3 n(m[3] + s * m[row], m[7] + s * m[4 + row], m[11] + s * m[8 + row]);
+        float d = m[15] + s * m[12 + row];
+        float length = n.length();
+        if (length > 0) {
+            n /= length;
+            d /= length;
+        }
+        mPlanes[i].normal = n;
+        mPlanes[i].d = d;
+    }
+
+    Matrix4 inverse = viewProjection;
+    inverse.invert();
+    for (int i = 0; i < 8; i++) {
+        Vector4 c = inverse * Vector4(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f, 1.0f);
+        mCorners[i].set(c.x / c.w, c.y / c.w, c.z / c.w);
+    }
+}
+
+// How far the plane must move out to hold every corner of f.
+static float shortfall(const Plane& plane, const Frustum& f) {
+    float worst = 0;
+    for (int i = 0; i < 8; i++)
+        worst = minf(worst, plane.distance(f.getCorner(i)));
+    return -worst;
+}
+
+Frustum Frustum::combine(const Frustum& a, const Frustum& b) {
+    Frustum out;
+    for (int i = 0; i < kPlaneCount; i++) {
+        float pushA = shortfall(a.mPlanes[i], b);
+        float pushB = shortfall(b.mPlanes[i], a);
+        out.mPlanes[i] = pushA <= pushB ? a.mPlanes[i] : b.mPlanes[i];
+        out.mPlanes[i].d += minf(pushA, pushB);
+    }
+    return out;
+}
+
+// Turns the pair of side tangents lo < 0 < hi out by angle.  A turn that
+// moves a point at elevation e sideways moves its azimuth by angle / cos(e),
+// so the padding grows with the tangent across the other axis.
+static void widenTangents(float& lo, float& hi, float across, float angle) {
+    const float pad = angle * sqrtf(1 + across * across);
+    const float limit = 1.5f;   // about 86 degrees
+    lo = tanf(maxf(atanf(lo) - pad, -limit));
+    hi = tanf(minf(atanf(hi) + pad, limit));
+}
+
+Matrix4 Frustum::widen(const Matrix4& projection, float angle) {
+    if (!(angle > 0))
+        return projection;
+    Matrix4 out = projection;
+    // m[0] = 2n / (r - l), m[8] = (r + l) / (r - l), and the same for y in
+    // m[5] and m[9], so the side tangents are (m[8] -+ 1) / m[0].
+    float left = (out[8] - 1) / out[0];
+    float right = (out[8] + 1) / out[0];
+    float bottom = (out[9] - 1) / out[5];
+    float top = (out[9] + 1) / out[5];
+    const float across = maxf(fabsf(bottom), fabsf(top));
+    const float along = maxf(fabsf(left), fabsf(right));
+    widenTangents(left, right, across, angle);
+    widenTangents(bottom, top, along, angle);
+    out[0] = 2 / (right - left);
+    out[8] = (right + left) / (right - left);
+    out[5] = 2 / (top - bottom);
+    out[9] = (top + bottom) / (top - bottom);
+    return out;
+}
+
+FrustumCuller::FrustumCuller() : mCount(0) {
+}
+
+void FrustumCuller::clear() {
+    mMinX.clear(); mMinY.clear(); mMinZ.clear();
+    mMaxX.clear(); mMaxY.clear(); mMaxZ.clear();
+    mCount = 0;
+}
+
+uint32_t FrustumCuller::add(const AABB& bounds) {
+    mMinX.push_back(bounds.min.x); mMinY.push_back(bounds.min.y); mMinZ.push_back(bounds.min.z);
+    mMaxX.push_back(bounds.max.x); mMaxY.push_back(bounds.max.y); mMaxZ.push_back(bounds.max.z);
+    return mCount++;
+}
+
+namespace {
+
+// A frustum's planes splatted across lanes, each with the box corner arrays
+// furthest along its normal.
+struct PackedPlanes {
+    int count;
+    const float * px[Frustum::kPlaneCount];
+    const float * py[Frustum::kPlaneCount];
+    const float * pz[Frustum::kPlaneCount];
+    simd::float4 nx[Frustum::kPlaneCount];
+    simd::float4 ny[Frustum::kPlaneCount];
+    simd::float4 nz[Frustum::kPlaneCount];
+    simd::float4 nd[Frustum::kPlaneCount];
+};
+
+// Planes that also appear in skip are left out: a box that passed skip
+// already passed those.
+void pack(const Frustum& f, const Frustum * skip, const float * const mins[3], const float * const maxs[3],
+        PackedPlanes& out) {
+    out.count = 0;
+    for (int j = 0; j < Frustum::kPlaneCount; j++) {
+        const Plane& plane = f.getPlane(j);
+        if (skip && skip->getPlane(j).normal == plane.normal && skip->getPlane(j).d == plane.d)
+            continue;
+        const int i = out.count++;
+        out.px[i] = plane.normal.x >= 0 ? maxs[0] : mins[0];
+        out.py[i] = plane.normal.y >= 0 ? maxs[1] : mins[1];
+        out.pz[i] = plane.normal.z >= 0 ? maxs[2] : mins[2];
+        out.nx[i] = simd::splat(plane.normal.x);
+        out.ny[i] = simd::splat(plane.normal.y);
+        out.nz[i] = simd::splat(plane.normal.z);
+        out.nd[i] = simd::splat(plane.d);
+    }
+}
+
+// Bit k set when box base + k is not entirely outside any plane.
+inline uint32_t insideLanes(const PackedPlanes& p, uint32_t base) {
+    using namespace simd;
+    float4 nearest = splat(FLT_MAX);
+    for (int i = 0; i < p.count; i++) {
+        float4 dist = madd(p.nx[i], load(p.px[i] + base), p.nd[i]);
+        dist = madd(p.ny[i], load(p.py[i] + base), dist);
+        dist = madd(p.nz[i], load(p.pz[i] + base), dist);
+        nearest = min4(nearest, dist);
+    }
+    return ~moveMask(less(nearest, splat(0))) & 0xF;
+}
+
+// Boxes [begin, end), both multiples of four.  Returns how many are visible.
+uint32_t cullPackets(const PackedPlanes& combined, const PackedPlanes eyes[2], uint32_t count,
+        uint8_t * visibility, uint32_t begin, uint32_t end) {
+    uint32_t visible = 0;
+    for (uint32_t base = begin; base < end; base += 4) {
+        uint8_t * out = visibility + base;
+        uint32_t inside = insideLanes(combined, base);
+        if (inside == 0) {
+            out[0] = out[1] = out[2] = out[3] = 0;
+            continue;
+        }
+
+        // Refine the survivors per eye.
+        uint32_t inLeft = insideLanes(eyes[0], base) & inside;
+        uint32_t inRight = insideLanes(eyes[1], base) & inside;
+        for (uint32_t k = 0; k < 4; k++)
+            out[k] = (uint8_t) (((inLeft >> k) & 1) * FrustumCuller::kLeftEye | ((inRight >> k) & 1) * FrustumCuller::kRightEye);
+        const uint32_t lanes = count - base < 4 ? (1u << (count - base)) - 1 : 0xF;
+        visible += __builtin_popcount((inLeft | inRight) & lanes);
+    }
+    return visible;
+}
+
+} // namespace
+
+uint32_t FrustumCuller::cull(const Frustum& left, const Frustum& right, JobSystem * jobs) {
+    mCombined = Frustum::combine(left, right);
+
+    // Pad to whole packets for the duration of the pass.  Padding lanes are
+    // tested but their results are dropped.
+    const uint32_t padded = (mCount + 3) & ~3u;
+    mMinX.resize(padded, 0); mMinY.resize(padded, 0); mMinZ.resize(padded, 0);
+    mMaxX.resize(padded, 0); mMaxY.resize(padded, 0); mMaxZ.resize(padded, 0);
+    mVisibility.resize(padded);
+
+    const float * const mins[3] = { mMinX.data(), mMinY.data(), mMinZ.data() };
+    const float * const maxs[3] = { mMaxX.data(), mMaxY.data(), mMaxZ.data() };
+    PackedPlanes combined, eyes[2];
+    pack(mCombined, NULL, mins, maxs, combined);
+    // For parallel eyes each one only adds its inner side plane.
+    pack(left, &mCombined, mins, maxs, eyes[0]);
+    pack(right, &mCombined, mins, maxs, eyes[1]);
+
+    uint32_t visible = 0;
+    if (jobs == NULL || padded <= kJobGrain) {
+        visible = cullPackets(combined, eyes, mCount, mVisibility.data(), 0, padded);
+    } else {
+        // Chunks write disjoint ranges of mVisibility.
+        std::atomic<uint32_t> total(0);
+        uint8_t * visibility = mVisibility.data();
+        const uint32_t count = mCount;
+        jobs->parallelFor(padded, kJobGrain, [&](uint32_t begin, uint32_t end) {
+            total.fetch_add(cullPackets(combined, eyes, count, visibility, begin, end), std::memory_order_relaxed);
+        });
+        visible = total.load(std::memory_order_relaxed);
+    }
+
+    mMinX.resize(mCount); mMinY.resize(mCount); mMinZ.resize(mCount);
+    mMaxX.resize(mCount); mMaxY.resize(mCount); mMaxZ.resize(mCount);
+    return visible;
+}
@@ -0,0 +1,137 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <Matrices.h>
+#include <BoundingVolume.h>
+
+class JobSystem;
+
+// Points p with normal.dot(p) + d >= 0 are inside.
+struct Plane {
+    Vector3 normal;
+    float d;
+
+    inline float distance(const Vector3& p) const {
+        return normal.dot(p) + d;
+    }
+};
+
+// Six planes of a view frustum, taken from a projection * view matrix.
+class Frustum {
+public:
+    enum PlaneIndex {
+        kLeft, kRight, kBottom, kTop, kNear, kFar, kPlaneCount
+    };
+
+public:
+    Frustum();
+
+    // viewProjection maps world space to clip space, as in projection * eye * view.
+    void set(const Matrix4& viewProjection);
+
+    // A frustum containing both a and b, for culling both eyes in one pass.
+    // Each plane is the looser of the two eyes' planes, pushed out when
+    // needed until it holds every corner of the other eye's frustum.  The
+    // result has planes only, so it cannot be combined again.
+    static Frustum combine(const Frustum& a, const Frustum& b);
+
+    // projection with its side planes turned out by angle radians about the
+    // eye, near and far kept.  A frustum of it holds the original one turned
+    // by up to angle in any direction, so culling stays valid for a view that
+    // still moves by that much.
+    static Matrix4 widen(const Matrix4& projection, float angle);
+
+    // False only when the box is entirely outside one plane.
+    inline bool intersects(const AABB& box) const {
+        for (int i = 0; i < kPlaneCount; i++) {
+            const Vector3& n = mPlanes[i].normal;
+            // The corner furthest along the normal.
+            Vector3 p(n.x >= 0 ? box.max.x : box.min.x,
+                      n.y >= 0 ? box.max.y : box.min.y,
+                      n.z >= 0 ? box.max.z : box.min.z);
+            if (mPlanes[i].distance(p) < 0)
+                return false;
+        }
+        return true;
+    }
+
+    inline const Plane& getPlane(int i) const {
+        return mPlanes[i];
+    }
+
+    // Corner i is at NDC (i & 1, i & 2, i & 4 ? 1 : -1), valid after set().
+    inline const Vector3& getCorner(int i) const {
+        return mCorners[i];
+    }
+
+private:
+    Plane mPlanes[kPlaneCount];
+    Vector3 mCorners[8];
+};
+
+// Per frame stereo culling over a flat array of world bounds.
+//
+// clear() and add() the bounds of everything drawable, then cull() once.
+// Boxes are tested four at a time against the combined frustum of both eyes,
+// and only packets with a survivor are refined against each eye, so that
+// renderScene() can also skip objects just one eye sees.
+class FrustumCuller {
+public:
+    enum {
+        kLeftEye = 1,
+        kRightEye = 2
+    };
+
+    // Index of something that is never culled, such as head locked content.
+    static const uint32_t kAlwaysVisible = 0xFFFFFFFF;
+
+public:
+    FrustumCuller();
+
+    void clear();
+    // Returns the index to pass to isVisible().
+    uint32_t add(const AABB& bounds);
+
+    // Boxes per job when cull() is given a JobSystem.  Fewer run inline.
+    static const uint32_t kJobGrain = 2048;
+
+    // Returns the number of boxes visible to at least one eye.
+    uint32_t cull(const Frustum& left, const Frustum& right, JobSystem * jobs = NULL);
+
+    // Eye mask of kLeftEye and kRightEye as of the last cull().
+    inline uint8_t getVisibility(uint32_t index) const {
+        return index == kAlwaysVisible ? (kLeftEye | kRightEye) : mVisibility[index];
+    }
+
+    inline bool isVisible(uint32_t index, uint8_t eye) const {
+        return (getVisibility(index) & eye) != 0;
+    }
+
+    inline uint32_t getCount() const {
+        return mCount;
+    }
+
+    inline const Frustum& getCombined() const {
+        return mCombined;
+    }
+
+private:
+    // Structure of arrays, padded to a multiple of four during cull().
+    std::vector<float> mMinX, mMinY, mMinZ;
+    std::vector<float> mMaxX, mMaxY, mMaxZ;
+    std::vector<uint8_t> mVisibility;
+    uint32_t mCount;
+    Frustum mCombined;
+};
@@ -0,0 +1,279 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#define LOG_TAG "InputSystem"
+#include <log.h>
+#include <stdio.h>
+#include <string.h>
+#include <InputSystem.h>
+
+const uint32_t InputSystem::kMaxDevices;
+const uint32_t InputSystem::kMaxInputs;
+const uint32_t InputSystem::kMaxAxes;
+
+bool InputTrace::parse(const char * text) {
+    clear();
+    if (text == NULL)
+        return false;
+    const char * line = text;
+    while (*line) {
+        const char * next = strchr(line, '\n');
+        if (line[0] != '#') {
+            Record r;
+            r.y = 0;
+            char kind;
+            int n = sscanf(line, "%u %c %u %u %f %f", &r.frame, &kind, &r.device, &r.input, &r.x, &r.y);
+            r.kind = kind;
+            if (n == 6 && kind == 'a')
+                add(r);
+            else if (n >= 5 && (kind == 'b' || kind == 't' || kind == 'c'))
+                add(r);
+        }
+        if (next == NULL)
+            break;
+        line = next + 1;
+    }
+    return !mRecords.empty();
+}
+
+void InputTrace::write(std::string& text) const {
+    char line[96];
+    for (size_t i = 0; i < mRecords.size(); i++) {
+        const Record& r = mRecords[i];
+        if (r.kind == 'a')
+            snprintf(line, sizeof(line), "%u a %u %u %.6f %.6f\n", r.frame, r.device, r.input, r.x, r.y);
+        else
+            snprintf(line, sizeof(line), "%u %c %u %u %d\n", r.frame, r.kind, r.device, r.input, r.x != 0 ? 1 : 0);
+        text += line;
+    }
+}
+
+bool InputTrace::load(const char * path) {
+    clear();
+    FILE * file = fopen(path, "r");
+    if (file == NULL)
+        return false;
+    std::string text;
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        text.append(buffer, n);
+    fclose(file);
+    return parse(text.c_str());
+}
+
+bool InputTrace::save(const char * path) const {
+    std::string text;
+    write(text);
+    FILE * file = fopen(path, "w");
+    if (file == NULL) {
+        LOGE("save: unable to open %s", path);
+        return false;
+    }
+    bool ok = fwrite(text.data(), 1, text.size(), file) == text.size();
+    fclose(file);
+    return ok;
+}
+
+void InputTrace::add(const Record& record) {
+    if (!mRecords.empty() && record.frame < mRecords.back().frame) {
+        LOGW("add: frame %u is before the previous record, skipped", record.frame);
+        return;
+    }
+    mRecords.push_back(record);
+}
+
+void InputTrace::clear() {
+    mRecords.clear();
+}
+
+InputSystem::InputSystem() :
+        mAxisInputs(0),
+        mAxisReader(NULL),
+        mAxisData(NULL),
+        mRecording(NULL),
+        mRecordFrame(0),
+        mReplay(NULL),
+        mReplayFrame(0),
+        mReplayCursor(0) {
+}
+
+void InputSystem::setAxisInputs(uint32_t mask) {
+    uint32_t kept = 0, count = 0;
+    for (uint32_t i = 0; i < kMaxInputs && count < kMaxAxes; i++) {
+        if ((mask >> i) & 1) {
+            kept |= 1u << i;
+            count++;
+        }
+    }
+    if (kept != mask)
+        LOGW("setAxisInputs: only the first %u axes are kept", kMaxAxes);
+    mAxisInputs = kept;
+}
+
+void InputSystem::setAxisReader(AxisReader reader, void * data) {
+    mAxisReader = reader;
+    mAxisData = data;
+}
+
+int32_t InputSystem::axisSlot(uint32_t input) const {
+    if (input >= kMaxInputs || !((mAxisInputs >> input) & 1))
+        return -1;
+    return __builtin_popcount(mAxisInputs & ((1u << input) - 1));
+}
+
+void InputSystem::apply(char kind, uint32_t device, uint32_t input, bool value) {
+    if (device >= kMaxDevices)
+        return;
+    DeviceState& d = mCurrent.devices[device];
+    const uint32_t deviceBit = 1u << device;
+
+    if (kind == 'c') {
+        if (value) {
+            mCurrent.connected |= deviceBit;
+            return;
+        }
+        // Whatever was held is let go, so nothing stays stuck down.
+        mCurrent.connected &= ~deviceBit;
+        d.releasedEdges |= d.pressed;
+        d.untouchedEdges |= d.touched;
+        d.pressed = 0;
+        d.touched = 0;
+        return;
+    }
+
+    if (input >= kMaxInputs)
+        return;
+    const uint32_t bit = 1u << input;
+    uint32_t& level = kind == 'b' ? d.pressed : d.touched;
+    if (((level & bit) != 0) == value)
+        return;
+    if (value) {
+        level |= bit;
+        (kind == 'b' ? d.pressedEdges : d.touchedEdges) |= bit;
+    } else {
+        level &= ~bit;
+        (kind == 'b' ? d.releasedEdges : d.untouchedEdges) |= bit;
+    }
+    // An event from a device implies it is there.
+    mCurrent.connected |= deviceBit;
+}
+
+void InputSystem::onButton(uint32_t device, uint32_t input, bool pressed) {
+    if (mReplay != NULL)
+        return;
+    apply('b', device, input, pressed);
+    if (mRecording != NULL) {
+        InputTrace::Record r = { mRecordFrame, 'b', device, input, pressed ? 1.0f : 0.0f, 0 };
+        mRecording->add(r);
+    }
+}
+
+void InputSystem::onTouch(uint32_t device, uint32_t input, bool touched) {
+    if (mReplay != NULL)
+        return;
+    apply('t', device, input, touched);
+    if (mRecording != NULL) {
+        InputTrace::Record r = { mRecordFrame, 't', device, input, touched ? 1.0f : 0.0f, 0 };
+        mRecording->add(r);
+    }
+}
+
+void InputSystem::onConnect(uint32_t device, bool connected) {
+    if (mReplay != NULL)
+        return;
+    apply('c', device, 0, connected);
+    if (mRecording != NULL) {
+        InputTrace::Record r = { mRecordFrame, 'c', device, 0, connected ? 1.0f : 0.0f, 0 };
+        mRecording->add(r);
+    }
+}
+
+// Applies this frame's records.  Axes are taken as recorded, the reader is
+// not asked.
+void InputSystem::replayFrame() {
+    const uint32_t count = mReplay->getCount();
+    while (mReplayCursor < count) {
+        const InputTrace::Record& r = mReplay->getRecord(mReplayCursor);
+        if (r.frame > mReplayFrame)
+            break;
+        mReplayCursor++;
+        if (r.kind != 'a') {
+            apply(r.kind, r.device, r.input, r.x != 0);
+            continue;
+        }
+        int32_t slot = axisSlot(r.input);
+        if (slot >= 0 && r.device < kMaxDevices) {
+            mCurrent.devices[r.device].axes[slot].x = r.x;
+            mCurrent.devices[r.device].axes[slot].y = r.y;
+        }
+    }
+    mReplayFrame++;
+}
+
+void InputSystem::publish() {
+    if (mReplay != NULL) {
+        replayFrame();
+    } else if (mAxisReader != NULL && mAxisInputs != 0) {
+        // Only what is touched, an idle controller costs no runtime call.
+        for (uint32_t device = 0; device < kMaxDevices; device++) {
+            DeviceState& d = mCurrent.devices[device];
+            uint32_t active = d.touched & mAxisInputs;
+            while (active != 0) {
+                const uint32_t input = __builtin_ctz(active);
+                active &= active - 1;
+                Axis& axis = d.axes[axisSlot(input)];
+                mAxisReader(mAxisData, device, input, axis.x, axis.y);
+                if (mRecording != NULL) {
+                    InputTrace::Record r = { mRecordFrame, 'a', device, input, axis.x, axis.y };
+                    mRecording->add(r);
+                }
+            }
+        }
+    }
+
+    mSnapshots.getBack() = mCurrent;
+    mSnapshots.publish();
+
+    mCurrent.frameIndex++;
+    for (uint32_t device = 0; device < kMaxDevices; device++) {
+        DeviceState& d = mCurrent.devices[device];
+        d.pressedEdges = 0;
+        d.releasedEdges = 0;
+        d.touchedEdges = 0;
+        d.untouchedEdges = 0;
+    }
+    if (mRecording != NULL)
+        mRecordFrame++;
+}
+
+bool InputSystem::getAxis(uint32_t device, uint32_t input, Axis& axis) const {
+    int32_t slot = axisSlot(input);
+    if (slot < 0 || device >= kMaxDevices || !mCurrent.devices[device].isTouched(input))
+        return false;
+    axis = mCurrent.devices[device].axes[slot];
+    return true;
+}
+
+const InputSystem::Snapshot& InputSystem::acquire() {
+    mSnapshots.update();
+    return mSnapshots.getFront();
+}
+
+void InputSystem::setRecording(InputTrace * trace) {
+    mRecording = trace;
+    mRecordFrame = 0;
+}
+
+void InputSystem::setReplay(const InputTrace * trace) {
+    mReplay = trace;
+    mReplayFrame = 0;
+    mReplayCursor = 0;
+}
@@ -0,0 +1,179 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <TripleBuffer.h>
+
+// Recorded input, one line per record:
+//   <frame> b <device> <input> <0|1>      button pressed or released
+//   <frame> t <device> <input> <0|1>      touched or untouched
+//   <frame> c <device> 0 <0|1>            connected or disconnected
+//   <frame> a <device> <input> <x> <y>    analog axis while touched
+// Frames count InputSystem::publish() calls from the start of the recording.
+class InputTrace {
+public:
+    struct Record {
+        uint32_t frame;
+        char kind;          // 'b', 't', 'c' or 'a'
+        uint32_t device;
+        uint32_t input;
+        float x;            // the 0 or 1 of b, t and c
+        float y;
+    };
+
+public:
+    bool parse(const char * text);
+    void write(std::string& text) const;
+    // A file path, not an asset.
+    bool load(const char * path);
+    bool save(const char * path) const;
+    // Records must come in frame order.
+    void add(const Record& record);
+    void clear();
+
+    inline uint32_t getCount() const {
+        return (uint32_t) mRecords.size();
+    }
+
+    inline const Record& getRecord(uint32_t index) const {
+        return mRecords[index];
+    }
+
+private:
+    std::vector<Record> mRecords;
+};
+
+// Button and touch state per device, built from runtime events instead of
+// asking the runtime about every button every frame.
+//
+// The input thread, the one polling the event queue, feeds events through
+// onButton(), onTouch() and onConnect(), then publish()es once per frame.
+// publish() asks the axis reader for analog axes, but only for the inputs
+// that are touched, so an idle frame makes no runtime calls at all.  The
+// simulation thread acquire()s the latest Snapshot through a TripleBuffer,
+// without locks.
+//
+// Edges are what happened between two publish() calls, so a press and a
+// release inside one frame still show up.  Take every snapshot, as a frame
+// pipeline does by publishing right before it kicks the simulation; edges
+// of a snapshot that was replaced before it was taken are lost.
+//
+// Devices and inputs are the runtime's numbers, WVR_DeviceType and
+// WVR_InputId, and only index bits here.
+class InputSystem {
+public:
+    static const uint32_t kMaxDevices = 4;
+    static const uint32_t kMaxInputs = 32;
+    // Analog inputs per device, see setAxisInputs().
+    static const uint32_t kMaxAxes = 4;
+
+    typedef void (*AxisReader)(void * data, uint32_t device, uint32_t input, float& x, float& y);
+
+    struct Axis {
+        float x;
+        float y;
+    };
+
+    struct DeviceState {
+        uint32_t pressed;           // bit per input
+        uint32_t touched;
+        uint32_t pressedEdges;      // went down since the previous snapshot
+        uint32_t releasedEdges;
+        uint32_t touchedEdges;
+        uint32_t untouchedEdges;
+        Axis axes[kMaxAxes];        // valid while the input is touched
+
+        inline bool isPressed(uint32_t input) const {
+            return (pressed >> input) & 1;
+        }
+        inline bool isTouched(uint32_t input) const {
+            return (touched >> input) & 1;
+        }
+        inline bool wentDown(uint32_t input) const {
+            return (pressedEdges >> input) & 1;
+        }
+        inline bool wentUp(uint32_t input) const {
+            return (releasedEdges >> input) & 1;
+        }
+        // Any of the inputs in mask went down.
+        inline bool wentDownAny(uint32_t mask) const {
+            return (pressedEdges & mask) != 0;
+        }
+    };
+
+    struct Snapshot {
+        uint32_t frameIndex;
+        uint32_t connected;         // bit per device
+        DeviceState devices[kMaxDevices];
+
+        Snapshot() {
+            memset(this, 0, sizeof(*this));
+        }
+    };
+
+public:
+    InputSystem();
+
+    // Inputs that have an analog axis, at most kMaxAxes bits.
+    void setAxisInputs(uint32_t mask);
+    void setAxisReader(AxisReader reader, void * data);
+
+    // Input thread.  Devices and inputs out of range are ignored, and so is
+    // everything while a replay runs.
+    void onButton(uint32_t device, uint32_t input, bool pressed);
+    void onTouch(uint32_t device, uint32_t input, bool touched);
+    void onConnect(uint32_t device, bool connected);
+    void publish();
+
+    // Input thread, as of the last publish().
+    inline const Snapshot& getCurrent() const {
+        return mCurrent;
+    }
+    // Axis of a touched analog input as of the last publish(), or false.
+    bool getAxis(uint32_t device, uint32_t input, Axis& axis) const;
+
+    // Simulation thread.  The newest snapshot, or the last one again when
+    // nothing was published since.
+    const Snapshot& acquire();
+
+    // Every event and polled axis goes into the trace from the next
+    // publish() on.  NULL stops.  The trace must outlive the recording.
+    void setRecording(InputTrace * trace);
+    // Feeds the trace instead of the runtime, from the next publish() on.
+    // NULL returns to live input.
+    void setReplay(const InputTrace * trace);
+
+    inline bool isReplaying() const {
+        return mReplay != NULL;
+    }
+
+private:
+    int32_t axisSlot(uint32_t input) const;
+    void apply(char kind, uint32_t device, uint32_t input, bool value);
+    void replayFrame();
+
+    uint32_t mAxisInputs;
+    AxisReader mAxisReader;
+    void * mAxisData;
+
+    Snapshot mCurrent;              // input thread
+    TripleBuffer<Snapshot> mSnapshots;
+
+    InputTrace * mRecording;
+    uint32_t mRecordFrame;
+    const InputTrace * mReplay;
+    uint32_t mReplayFrame;
+    uint32_t mReplayCursor;
+};
@@ -0,0 +1,244 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#define LOG_TAG "JobSystem"
+#include <stdio.h>
+#include <log.h>
+#include <JobSystem.h>
+
+namespace {
+
+// -1 on threads that are not workers of any pool.
+thread_local int sWorkerIndex = -1;
+thread_local const JobSystem * sWorkerPool = NULL;
+
+// Highest cpuinfo_max_freq in kHz, 0 when cpufreq is not exposed.
+uint32_t readMaxFreq(uint32_t cpu) {
+    char path[96];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cpufreq/cpuinfo_max_freq", cpu);
+    FILE * file = fopen(path, "r");
+    if (file == NULL)
+        return 0;
+    unsigned int freq = 0;
+    if (fscanf(file, "%u", &freq) != 1)
+        freq = 0;
+    fclose(file);
+    return freq;
+}
+
+} // namespace
+
+JobSystem::JobSystem(uint32_t workerCount)
+        : mQueued(0)
+        , mNextQueue(0)
+        , mBackgroundRunning(0)
+        , mQuit(false) {
+    if (workerCount == 0)
+        workerCount = getDefaultWorkerCount();
+    mBackgroundLimit = workerCount > 1 ? workerCount - 1 : 1;
+    for (uint32_t i = 0; i < workerCount; i++)
+        mQueues.push_back(std::unique_ptr<Queue>(new Queue()));
+    for (uint32_t i = 0; i < workerCount; i++)
+        mWorkers.push_back(std::thread(&JobSystem::workerMain, this, (int) i));
+    LOGI("%u workers", workerCount);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mQuit = true;
+    }
+    mWake.notify_all();
+    for (size_t i = 0; i < mWorkers.size(); i++)
+        mWorkers[i].join();
+}
+
+JobSystem& JobSystem::getInstance() {
+    static JobSystem instance;
+    return instance;
+}
+
+// On big.LITTLE parts only the cores with the highest maximum clock count.
+// Little cores would finish their share of a parallelFor last.
+uint32_t JobSystem::getDefaultWorkerCount() {
+    const uint32_t cpus = std::thread::hardware_concurrency();
+    uint32_t big = 0;
+    uint32_t maxFreq = 0;
+    for (uint32_t cpu = 0; cpu < cpus; cpu++) {
+        const uint32_t freq = readMaxFreq(cpu);
+        if (freq > maxFreq) {
+            maxFreq = freq;
+            big = 1;
+        } else if (freq == maxFreq && freq > 0) {
+            big++;
+        }
+    }
+    if (maxFreq == 0)
+        big = cpus;
+    // At least one, so run() of a task never waits for a wait().
+    return big > 2 ? big - 1 : 1;
+}
+
+void JobSystem::run(Function function, void * data, uint32_t begin, uint32_t end,
+        Counter * counter, Counter * dependency) {
+    Job job = { function, data, begin, end, counter };
+    if (counter != NULL)
+        counter->mPending.fetch_add(1, std::memory_order_relaxed);
+    if (dependency != NULL) {
+        std::lock_guard<std::mutex> lock(dependency->mMutex);
+        if (!dependency->isDone()) {
+            dependency->mContinuations.push_back(job);
+            return;
+        }
+    }
+    push(job);
+}
+
+void JobSystem::run(const std::function<void()>& task, Counter * counter, Counter * dependency) {
+    run(&JobSystem::callTask, new std::function<void()>(task), 0, 0, counter, dependency);
+}
+
+void JobSystem::runBackground(const std::function<void()>& task, Counter * counter) {
+    Job job = { &JobSystem::callTask, new std::function<void()>(task), 0, 0, counter };
+    if (counter != NULL)
+        counter->mPending.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(mBackgroundMutex);
+        mBackground.push_back(job);
+    }
+    { std::lock_guard<std::mutex> lock(mWakeMutex); }
+    mWake.notify_one();
+}
+
+void JobSystem::callTask(void * data, uint32_t, uint32_t) {
+    std::function<void()> * task = (std::function<void()> *) data;
+    (*task)();
+    delete task;
+}
+
+void JobSystem::wait(Counter& counter) {
+    const int self = sWorkerPool == this ? sWorkerIndex : -1;
+    while (!counter.isDone()) {
+        Job job;
+        if (pop(self, job))
+            execute(job);
+        else
+            std::this_thread::yield();
+    }
+    // The last job may still be inside execute(), holding the mutex.
+    std::lock_guard<std::mutex> lock(counter.mMutex);
+}
+
+void JobSystem::push(const Job& job) {
+    const int self = sWorkerPool == this ? sWorkerIndex : -1;
+    Queue & queue = *mQueues[self >= 0 ? self : mNextQueue.fetch_add(1, std::memory_order_relaxed) % mQueues.size()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(job);
+    }
+    mQueued.fetch_add(1, std::memory_order_release);
+    // Taking the lock orders this with a worker about to sleep.
+    { std::lock_guard<std::mutex> lock(mWakeMutex); }
+    mWake.notify_one();
+}
+
+// Own queue newest first, then the oldest job of another worker.
+bool JobSystem::pop(int self, Job& job) {
+    if (mQueued.load(std::memory_order_acquire) == 0)
+        return false;
+    const uint32_t count = (uint32_t) mQueues.size();
+    if (self >= 0) {
+        Queue & queue = *mQueues[self];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = queue.jobs.back();
+            queue.jobs.pop_back();
+            mQueued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    const uint32_t start = self >= 0 ? (uint32_t) self + 1 : 0;
+    for (uint32_t i = 0; i < count; i++) {
+        Queue & queue = *mQueues[(start + i) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = queue.jobs.front();
+            queue.jobs.pop_front();
+            mQueued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Oldest first, while fewer than mBackgroundLimit are running.
+bool JobSystem::popBackground(Job& job) {
+    std::lock_guard<std::mutex> lock(mBackgroundMutex);
+    if (mBackground.empty() || mBackgroundRunning >= mBackgroundLimit)
+        return false;
+    job = mBackground.front();
+    mBackground.pop_front();
+    mBackgroundRunning++;
+    return true;
+}
+
+bool JobSystem::hasBackgroundWork() {
+    std::lock_guard<std::mutex> lock(mBackgroundMutex);
+    return !mBackground.empty() && mBackgroundRunning < mBackgroundLimit;
+}
+
+void JobSystem::execute(const Job& job) {
+    job.function(job.data, job.begin, job.end);
+    Counter * counter = job.counter;
+    if (counter == NULL)
+        return;
+
+    // Under the mutex, so a waiter that sees zero cannot free the counter
+    // before this is done with it.
+    std::vector<Job> released;
+    {
+        std::lock_guard<std::mutex> lock(counter->mMutex);
+        if (counter->mPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            released.swap(counter->mContinuations);
+    }
+    for (size_t i = 0; i < released.size(); i++)
+        push(released[i]);
+}
+
+void JobSystem::workerMain(int index) {
+    sWorkerIndex = index;
+    sWorkerPool = this;
+    while (true) {
+        Job job;
+        if (pop(index, job)) {
+            execute(job);
+            continue;
+        }
+        if (popBackground(job)) {
+            execute(job);
+            {
+                std::lock_guard<std::mutex> lock(mBackgroundMutex);
+                mBackgroundRunning--;
+            }
+            // One held back by the limit may go now.
+            { std::lock_guard<std::mutex> lock(mWakeMutex); }
+            mWake.notify_one();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mWakeMutex);
+        mWake.wait(lock, [this] {
+            return mQuit || mQueued.load(std::memory_order_acquire) > 0 || hasBackgroundWork();
+        });
+        // Background jobs held back by the limit are left to the worker
+        // running one, which loops round for the next when it is done.
+        if (mQuit && mQueued.load(std::memory_order_acquire) == 0 && !hasBackgroundWork())
+            break;
+    }
+}
@@ -0,0 +1,145 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+// Fixed pool of workers for short CPU jobs, with work stealing.
+//
+// Each worker owns a deque.  It pushes and pops its own jobs at the back and
+// steals from the front of the others when it runs dry.  Jobs submitted from
+// other threads are dealt round robin.  A thread that wait()s on a Counter
+// runs jobs itself until the counter drops to zero, so waiting inside a job
+// is fine and the render thread does its share of a parallelFor().
+//
+// Dependencies: a job submitted with a dependency Counter is only queued
+// when that counter reaches zero.
+//
+// Long jobs, such as file loads and decodes, go to runBackground() instead.
+// They sit in a queue of their own that only workers take from, and only
+// when they have no short job to run, so a wait() never picks one up and a
+// per frame parallelFor() never stalls behind one.  At most all workers but
+// one run background jobs at the same time.
+class JobSystem {
+public:
+    typedef void (*Function)(void * data, uint32_t begin, uint32_t end);
+
+    class Counter;
+
+    struct Job {
+        Function function;
+        void * data;
+        uint32_t begin;
+        uint32_t end;
+        Counter * counter;
+    };
+
+    // Jobs submitted against a counter and not finished yet.  wait() on it
+    // before it goes away.
+    class Counter {
+    public:
+        Counter() : mPending(0) {}
+
+        inline bool isDone() const {
+            return mPending.load(std::memory_order_acquire) == 0;
+        }
+
+    private:
+        friend class JobSystem;
+        std::atomic<uint32_t> mPending;
+        std::mutex mMutex;
+        std::vector<Job> mContinuations;    // held until mPending is zero
+    };
+
+public:
+    // 0 picks getDefaultWorkerCount().
+    explicit JobSystem(uint32_t workerCount = 0);
+    // Runs what is queued, then joins the workers.
+    ~JobSystem();
+
+    // Shared by the whole process, created on first use.
+    static JobSystem& getInstance();
+    // The big cores less the calling thread, which helps while it waits.
+    static uint32_t getDefaultWorkerCount();
+
+    inline uint32_t getWorkerCount() const {
+        return (uint32_t) mWorkers.size();
+    }
+
+    // function(data, begin, end) on some worker.
+    void run(Function function, void * data, uint32_t begin, uint32_t end,
+            Counter * counter = NULL, Counter * dependency = NULL);
+    // Copies the task.  Allocates, so keep it for work that is not per frame.
+    void run(const std::function<void()>& task, Counter * counter = NULL, Counter * dependency = NULL);
+    // A long task, run by a worker with nothing else to do.
+    void runBackground(const std::function<void()>& task, Counter * counter = NULL);
+
+    // Runs queued short jobs until counter is done.  Background jobs are
+    // left to the workers, so waiting on one only yields until it is done.
+    void wait(Counter& counter);
+
+    // body(begin, end) over [0, count) in chunks of grain, the calling thread
+    // included.  Returns when every chunk is done.
+    template <typename F>
+    void parallelFor(uint32_t count, uint32_t grain, const F& body) {
+        if (grain == 0)
+            grain = 1;
+        if (count <= grain) {
+            if (count > 0)
+                body(0, count);
+            return;
+        }
+        Counter counter;
+        for (uint32_t begin = grain; begin < count; begin += grain)
+            run(&callRange<F>, const_cast<F *>(&body), begin, count - begin < grain ? count : begin + grain, &counter);
+        body(0, grain);
+        wait(counter);
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    template <typename F>
+    static void callRange(void * data, uint32_t begin, uint32_t end) {
+        (*(const F *) data)(begin, end);
+    }
+    static void callTask(void * data, uint32_t begin, uint32_t end);
+
+    void push(const Job& job);
+    bool pop(int self, Job& job);
+    bool popBackground(Job& job);
+    bool hasBackgroundWork();
+    void execute(const Job& job);
+    void workerMain(int index);
+
+    std::vector<std::unique_ptr<Queue> > mQueues;
+    std::vector<std::thread> mWorkers;
+    std::atomic<uint32_t> mQueued;
+    std::atomic<uint32_t> mNextQueue;
+    std::mutex mBackgroundMutex;
+    std::deque<Job> mBackground;        // under mBackgroundMutex
+    uint32_t mBackgroundRunning;        // under mBackgroundMutex
+    uint32_t mBackgroundLimit;
+    std::mutex mWakeMutex;
+    std::condition_variable mWake;
+    bool mQuit;
+};
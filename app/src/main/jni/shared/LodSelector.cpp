@@ -0,0 +1,62 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#define LOG_TAG "LodSelector"
+#include <float.h>
+#include <math.h>
+#include <log.h>
+#include <LodSelector.h>
+
+const uint32_t LodSelector::kMaxLevels;
+
+LodSelector::LodSelector() : mLevelCount(1), mLevel(0), mHysteresis(0.15f) {
+    for (uint32_t i = 0; i < kMaxLevels - 1; i++)
+        mThresholds[i] = 0;
+}
+
+void LodSelector::setThresholds(const float * thresholds, uint32_t levelCount) {
+    if (levelCount < 1 || levelCount > kMaxLevels) {
+        LOGE("setThresholds: %u levels, at most %u", levelCount, kMaxLevels);
+        return;
+    }
+    for (uint32_t i = 0; i + 1 < levelCount; i++)
+        mThresholds[i] = thresholds[i];
+    mLevelCount = levelCount;
+    if (mLevel >= mLevelCount)
+        mLevel = mLevelCount - 1;
+}
+
+float LodSelector::projectedSize(const Matrix4& modelview, const Matrix4& projection,
+        const Vector3& localCenter, float localRadius) {
+    const float * m = modelview.get();
+    // Matrix4 * Vector3 leaves out the translation.
+    const Vector3 center = modelview * localCenter + Vector3(m[12], m[13], m[14]);
+    const float sx = m[0] * m[0] + m[1] * m[1] + m[2] * m[2];
+    const float sy = m[4] * m[4] + m[5] * m[5] + m[6] * m[6];
+    const float sz = m[8] * m[8] + m[9] * m[9] + m[10] * m[10];
+    const float radius = localRadius * sqrtf(fmaxf(sx, fmaxf(sy, sz)));
+
+    // Inside or touching the sphere: as big as it gets.
+    const float depth = -center.z;
+    if (depth <= radius)
+        return FLT_MAX;
+    return radius * projection.get()[5] / depth;
+}
+
+uint32_t LodSelector::select(float size) {
+    // Finer while clearly above the next finer threshold, coarser while
+    // clearly below the current one.
+    while (mLevel > 0 && size >= mThresholds[mLevel - 1] * (1 + mHysteresis))
+        mLevel--;
+    while (mLevel + 1 < mLevelCount && size < mThresholds[mLevel] * (1 - mHysteresis))
+        mLevel++;
+    return mLevel;
+}
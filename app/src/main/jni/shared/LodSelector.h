@@ -0,0 +1,58 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#pragma once
+
+#include <stdint.h>
+#include <Matrices.h>
+
+// Picks a level of detail from the projected size of a bounding sphere.
+//
+// Level 0 is the finest.  A level is drawn while the projected size stays
+// at or above its threshold; the size must pass a threshold by the
+// hysteresis fraction before the level changes, so an object resting near
+// a threshold does not pop between levels.
+class LodSelector {
+public:
+    static const uint32_t kMaxLevels = 4;
+
+public:
+    LodSelector();
+
+    // thresholds[i] is the smallest size drawn at level i, decreasing, and
+    // there are levelCount - 1 of them.  The last level has no lower bound.
+    void setThresholds(const float * thresholds, uint32_t levelCount);
+
+    inline void setHysteresis(float fraction) {
+        mHysteresis = fraction;
+    }
+
+    // Diameter of the sphere over the viewport height.  modelview takes
+    // the local center to eye space; its largest axis scales the radius.
+    static float projectedSize(const Matrix4& modelview, const Matrix4& projection,
+            const Vector3& localCenter, float localRadius);
+
+    uint32_t select(float size);
+
+    inline uint32_t getLevel() const {
+        return mLevel;
+    }
+
+    inline uint32_t getLevelCount() const {
+        return mLevelCount;
+    }
+
+private:
+    float mThresholds[kMaxLevels - 1];
+    uint32_t mLevelCount;
+    uint32_t mLevel;
+    float mHysteresis;
+};
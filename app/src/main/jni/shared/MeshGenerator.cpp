@@ -0,0 +1,294 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#define LOG_TAG "MeshGenerator"
+#include <math.h>
+#include <unordered_map>
+#include <log.h>
+#include <MeshGenerator.h>
+
+const uint32_t MeshData::kStride;
+const uint32_t MeshData::kPositionOffset;
+const uint32_t MeshData::kTexCoordOffset;
+const uint32_t MeshData::kNormalOffset;
+
+namespace {
+const double kPi = 3.14159265358979323846;
+
+// cos and sin of start + i * step for i in [0, count].  Each entry is the
+// previous one rotated by step; doubles keep the drift far below float
+// precision for any tessellation we use.
+void makeSinCosTable(double start, double step, uint32_t count, std::vector<float>& cosTable, std::vector<float>& sinTable) {
+    cosTable.resize(count + 1);
+    sinTable.resize(count + 1);
+    const double cs = cos(step), ss = sin(step);
+    double c = cos(start), s = sin(start);
+    for (uint32_t i = 0; i <= count; i++) {
+        cosTable[i] = (float) c;
+        sinTable[i] = (float) s;
+        const double nc = c * cs - s * ss;
+        s = s * cs + c * ss;
+        c = nc;
+    }
+}
+
+inline void pushVertex(std::vector<float>& v, float x, float y, float z, float s, float t, float nx, float ny, float nz) {
+    v.push_back(x);
+    v.push_back(y);
+    v.push_back(z);
+    v.push_back(s);
+    v.push_back(t);
+    v.push_back(nx);
+    v.push_back(ny);
+    v.push_back(nz);
+}
+
+inline void pushTriangle(std::vector<uint32_t>& idx, uint32_t a, uint32_t b, uint32_t c) {
+    idx.push_back(a);
+    idx.push_back(b);
+    idx.push_back(c);
+}
+
+// Index of the normalized midpoint of edge ab, created once per edge.
+uint32_t midpoint(uint32_t a, uint32_t b, std::vector<Vector3>& points, std::unordered_map<uint64_t, uint32_t>& cache) {
+    const uint64_t key = a < b ? ((uint64_t) a << 32) | b : ((uint64_t) b << 32) | a;
+    auto found = cache.find(key);
+    if (found != cache.end())
+        return found->second;
+    Vector3 m = (points[a] + points[b]) * 0.5f;
+    m.normalize();
+    const uint32_t index = (uint32_t) points.size();
+    points.push_back(m);
+    cache[key] = index;
+    return index;
+}
+}  // namespace
+
+AABB MeshData::getBounds() const {
+    AABB bounds;
+    for (size_t i = 0; i + kStride <= vertices.size(); i += kStride)
+        bounds.expand(Vector3(vertices[i], vertices[i + 1], vertices[i + 2]));
+    return bounds;
+}
+
+void MeshGenerator::uvSphere(float radius, uint32_t slices, uint32_t stacks, MeshData& out) {
+    out.clear();
+    if (slices < 3)
+        slices = 3;
+    if (stacks < 2)
+        stacks = 2;
+
+    std::vector<float> cosLon, sinLon, cosLat, sinLat;
+    makeSinCosTable(0, 2 * kPi / slices, slices, cosLon, sinLon);
+    makeSinCosTable(-kPi / 2, kPi / stacks, stacks, cosLat, sinLat);
+    // Close the seam and the poles exactly.
+    cosLon[slices] = 1;
+    sinLon[slices] = 0;
+    cosLat[0] = cosLat[stacks] = 0;
+    sinLat[0] = -1;
+    sinLat[stacks] = 1;
+
+    const uint32_t ring = slices + 1;
+    out.vertices.reserve(ring * (stacks + 1) * MeshData::kStride);
+    for (uint32_t j = 0; j <= stacks; j++) {
+        const float t = (float) j / stacks;
+        for (uint32_t i = 0; i <= slices; i++) {
+            // -sin keeps u increasing to the right seen from outside.
+            const float nx = cosLat[j] * cosLon[i];
+            const float ny = sinLat[j];
+            const float nz = -cosLat[j] * sinLon[i];
+            pushVertex(out.vertices, nx * radius, ny * radius, nz * radius, (float) i / slices, t, nx, ny, nz);
+        }
+    }
+
+    // The triangle touching a pole at two corners has no area, skip it.
+    out.indices.reserve(slices * (stacks - 1) * 6);
+    for (uint32_t j = 0; j < stacks; j++) {
+        for (uint32_t i = 0; i < slices; i++) {
+            const uint32_t a = j * ring + i;
+            const uint32_t b = a + 1;
+            const uint32_t c = a + ring;
+            const uint32_t d = c + 1;
+            if (j != 0)
+                pushTriangle(out.indices, a, b, c);
+            if (j != stacks - 1)
+                pushTriangle(out.indices, b, d, c);
+        }
+    }
+}
+
+void MeshGenerator::icosphere(float radius, uint32_t subdivisions, MeshData& out) {
+    out.clear();
+    if (subdivisions > 7) {
+        LOGW("icosphere: %u subdivisions is too many, using 7", subdivisions);
+        subdivisions = 7;
+    }
+
+    const float g = (1.0f + sqrtf(5.0f)) / 2.0f;
+    static const float kCorners[4][2] = {
+        {-1, 1}, {1, 1}, {-1, -1}, {1, -1}
+    };
+    std::vector<Vector3> points;
+    points.reserve(10 * (1u << (2 * subdivisions)) + 2);
+    // Three golden rectangles in the xy, yz and zx planes.
+    for (int i = 0; i < 4; i++)
+        points.push_back(Vector3(kCorners[i][0], kCorners[i][1] * g, 0));
+    for (int i = 0; i < 4; i++)
+        points.push_back(Vector3(0, kCorners[i][0], kCorners[i][1] * g));
+    for (int i = 0; i < 4; i++)
+        points.push_back(Vector3(kCorners[i][1] * g, 0, kCorners[i][0]));
+    for (size_t i = 0; i < points.size(); i++)
+        points[i].normalize();
+
+    static const uint32_t kFaces[20][3] = {
+        {0, 11, 5}, {0, 5, 1}, {0, 1, 7}, {0, 7, 10}, {0, 10, 11},
+        {1, 5, 9}, {5, 11, 4}, {11, 10, 2}, {10, 7, 6}, {7, 1, 8},
+        {3, 9, 4}, {3, 4, 2}, {3, 2, 6}, {3, 6, 8}, {3, 8, 9},
+        {4, 9, 5}, {2, 4, 11}, {6, 2, 10}, {8, 6, 7}, {9, 8, 1}
+    };
+    std::vector<uint32_t> faces(&kFaces[0][0], &kFaces[0][0] + 60);
+    std::vector<uint32_t> next;
+    std::unordered_map<uint64_t, uint32_t> cache;
+    for (uint32_t level = 0; level < subdivisions; level++) {
+        next.clear();
+        next.reserve(faces.size() * 4);
+        cache.clear();
+        for (size_t f = 0; f < faces.size(); f += 3) {
+            const uint32_t a = faces[f], b = faces[f + 1], c = faces[f + 2];
+            const uint32_t ab = midpoint(a, b, points, cache);
+            const uint32_t bc = midpoint(b, c, points, cache);
+            const uint32_t ca = midpoint(c, a, points, cache);
+            pushTriangle(next, a, ab, ca);
+            pushTriangle(next, b, bc, ab);
+            pushTriangle(next, c, ca, bc);
+            pushTriangle(next, ab, bc, ca);
+        }
+        faces.swap(next);
+    }
+
+    out.vertices.reserve(points.size() * MeshData::kStride);
+    for (size_t i = 0; i < points.size(); i++) {
+        const Vector3& n = points[i];
+        const float s = 0.5f + (float) (atan2(-n.z, n.x) / (2 * kPi));
+        const float t = 0.5f + (float) (asin(n.y) / kPi);
+        pushVertex(out.vertices, n.x * radius, n.y * radius, n.z * radius, s, t, n.x, n.y, n.z);
+    }
+    out.indices.swap(faces);
+}
+
+void MeshGenerator::cube(float size, MeshData& out) {
+    out.clear();
+    // Normal, right and up of each face; right x up = normal.
+    static const float kFaces[6][9] = {
+        { 1, 0, 0,   0, 0, -1,   0, 1, 0},
+        {-1, 0, 0,   0, 0, 1,    0, 1, 0},
+        { 0, 1, 0,   1, 0, 0,    0, 0, -1},
+        { 0, -1, 0,  1, 0, 0,    0, 0, 1},
+        { 0, 0, 1,   1, 0, 0,    0, 1, 0},
+        { 0, 0, -1,  -1, 0, 0,   0, 1, 0}
+    };
+    static const float kCorners[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+
+    const float h = size * 0.5f;
+    out.vertices.reserve(24 * MeshData::kStride);
+    out.indices.reserve(36);
+    for (uint32_t f = 0; f < 6; f++) {
+        const float * n = kFaces[f];
+        const float * r = n + 3;
+        const float * u = n + 6;
+        for (uint32_t k = 0; k < 4; k++) {
+            const float cr = kCorners[k][0], cu = kCorners[k][1];
+            pushVertex(out.vertices,
+                    (n[0] + r[0] * cr + u[0] * cu) * h,
+                    (n[1] + r[1] * cr + u[1] * cu) * h,
+                    (n[2] + r[2] * cr + u[2] * cu) * h,
+                    (cr + 1) * 0.5f, (cu + 1) * 0.5f, n[0], n[1], n[2]);
+        }
+        const uint32_t base = f * 4;
+        pushTriangle(out.indices, base, base + 1, base + 2);
+        pushTriangle(out.indices, base, base + 2, base + 3);
+    }
+}
+
+void MeshGenerator::plane(float width, float depth, uint32_t divisionsX, uint32_t divisionsZ, MeshData& out) {
+    out.clear();
+    if (divisionsX < 1)
+        divisionsX = 1;
+    if (divisionsZ < 1)
+        divisionsZ = 1;
+
+    const uint32_t row = divisionsX + 1;
+    out.vertices.reserve(row * (divisionsZ + 1) * MeshData::kStride);
+    for (uint32_t j = 0; j <= divisionsZ; j++) {
+        const float t = (float) j / divisionsZ;
+        for (uint32_t i = 0; i <= divisionsX; i++) {
+            const float s = (float) i / divisionsX;
+            pushVertex(out.vertices, (s - 0.5f) * width, 0, (0.5f - t) * depth, s, t, 0, 1, 0);
+        }
+    }
+
+    out.indices.reserve(divisionsX * divisionsZ * 6);
+    for (uint32_t j = 0; j < divisionsZ; j++) {
+        for (uint32_t i = 0; i < divisionsX; i++) {
+            const uint32_t a = j * row + i;
+            pushTriangle(out.indices, a, a + 1, a + row + 1);
+            pushTriangle(out.indices, a, a + row + 1, a + row);
+        }
+    }
+}
+
+void MeshGenerator::cylinder(float radius, float height, uint32_t slices, MeshData& out) {
+    out.clear();
+    if (slices < 3)
+        slices = 3;
+
+    std::vector<float> cosLon, sinLon;
+    makeSinCosTable(0, 2 * kPi / slices, slices, cosLon, sinLon);
+    cosLon[slices] = 1;
+    sinLon[slices] = 0;
+
+    const float h = height * 0.5f;
+    const uint32_t ring = slices + 1;
+    out.vertices.reserve((ring * 4 + 2) * MeshData::kStride);
+    out.indices.reserve(slices * 12);
+
+    // Side, bottom ring then top ring.
+    for (uint32_t j = 0; j < 2; j++) {
+        const float y = j == 0 ? -h : h;
+        for (uint32_t i = 0; i <= slices; i++) {
+            const float nx = cosLon[i], nz = -sinLon[i];
+            pushVertex(out.vertices, nx * radius, y, nz * radius, (float) i / slices, (float) j, nx, 0, nz);
+        }
+    }
+    for (uint32_t i = 0; i < slices; i++) {
+        const uint32_t a = i, b = i + 1, c = i + ring, d = c + 1;
+        pushTriangle(out.indices, a, b, c);
+        pushTriangle(out.indices, b, d, c);
+    }
+
+    // Caps, a center vertex and a ring of their own for the flat normal.
+    for (uint32_t j = 0; j < 2; j++) {
+        const float ny = j == 0 ? -1.0f : 1.0f;
+        const uint32_t center = out.getVertexCount();
+        pushVertex(out.vertices, 0, ny * h, 0, 0.5f, 0.5f, 0, ny, 0);
+        for (uint32_t i = 0; i <= slices; i++) {
+            pushVertex(out.vertices, cosLon[i] * radius, ny * h, -sinLon[i] * radius,
+                    0.5f + 0.5f * cosLon[i], 0.5f + 0.5f * sinLon[i], 0, ny, 0);
+        }
+        for (uint32_t i = 0; i < slices; i++) {
+            const uint32_t a = center + 1 + i;
+            if (j == 0)
+                pushTriangle(out.indices, center, a + 1, a);
+            else
+                pushTriangle(out.indices, center, a, a + 1);
+        }
+    }
+}
@@ -0,0 +1,69 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <BoundingVolume.h>
+
+// Indexed mesh on the CPU side.  Vertices are interleaved, kStride floats
+// each: position xyz, texture coordinate uv, normal xyz, the same layout as
+// ControllerCube::addCubeToScene().  Triangles wind counterclockwise seen
+// from outside.
+struct MeshData {
+    static const uint32_t kStride = 8;
+    static const uint32_t kPositionOffset = 0;
+    static const uint32_t kTexCoordOffset = 3;
+    static const uint32_t kNormalOffset = 5;
+
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+
+    inline uint32_t getVertexCount() const {
+        return (uint32_t) (vertices.size() / kStride);
+    }
+
+    inline void clear() {
+        vertices.clear();
+        indices.clear();
+    }
+
+    AABB getBounds() const;
+};
+
+// Procedural meshes around the origin.  The output is cleared first, so a
+// caller may reuse one MeshData without reallocating.
+//
+// Trigonometry is done by rotating a unit vector by a fixed step, so a mesh
+// costs one sin/cos pair per ring and per segment instead of several per
+// vertex.
+class MeshGenerator {
+public:
+    // Latitude/longitude sphere, poles on y: stacks + 1 rings of slices + 1
+    // vertices, from -y up.  The seam column is duplicated so u can run from
+    // 0 to 1.  Each pole is a whole ring of coincident vertices, so every pole
+    // triangle has its own u; the degenerate second triangle there is left out.
+    static void uvSphere(float radius, uint32_t slices, uint32_t stacks, MeshData& out);
+
+    // Subdivided icosahedron: 20 * 4^subdivisions triangles of about equal
+    // size.  Shared vertices across the u seam, so texture it with care.
+    static void icosphere(float radius, uint32_t subdivisions, MeshData& out);
+
+    // Cube of edge size, four vertices per face for flat normals.
+    static void cube(float size, MeshData& out);
+
+    // Plane in xz facing +y, split into divisionsX by divisionsZ cells.
+    static void plane(float width, float depth, uint32_t divisionsX, uint32_t divisionsZ, MeshData& out);
+
+    // Capped cylinder along y.
+    static void cylinder(float radius, float height, uint32_t slices, MeshData& out);
+};
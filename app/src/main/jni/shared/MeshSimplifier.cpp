@@ -0,0 +1,299 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#define LOG_TAG "MeshSimplifier"
+#include <float.h>
+#include <algorithm>
+#include <queue>
+#include <unordered_set>
+#include <log.h>
+#include <Vectors.h>
+#include <MeshSimplifier.h>
+
+namespace {
+// Symmetric 4x4 as a2 ab ac ad b2 bc bd c2 cd d2.
+struct Quadric {
+    double q[10];
+
+    Quadric() {
+        for (int i = 0; i < 10; i++)
+            q[i] = 0;
+    }
+
+    void addPlane(double a, double b, double c, double d, double w) {
+        q[0] += w * a * a; q[1] += w * a * b; q[2] += w * a * c; q[3] += w * a * d;
+        q[4] += w * b * b; q[5] += w * b * c; q[6] += w * b * d;
+        q[7] += w * c * c; q[8] += w * c * d;
+        q[9] += w * d * d;
+    }
+
+    void add(const Quadric& o) {
+        for (int i = 0; i < 10; i++)
+            q[i] += o.q[i];
+    }
+
+    double eval(const Vector3& p) const {
+        const double x = p.x, y = p.y, z = p.z;
+        return q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z + 2 * q[3] * x
+                + q[4] * y * y + 2 * q[5] * y * z + 2 * q[6] * y
+                + q[7] * z * z + 2 * q[8] * z
+                + q[9];
+    }
+};
+
+struct Collapse {
+    double cost;
+    uint32_t from;
+    uint32_t to;
+    uint32_t stamp;
+
+    bool operator>(const Collapse& o) const {
+        return cost > o.cost;
+    }
+};
+
+struct PositionLess {
+    const std::vector<Vector3> * points;
+
+    bool operator()(uint32_t a, uint32_t b) const {
+        const Vector3& p = (*points)[a];
+        const Vector3& q = (*points)[b];
+        if (p.x != q.x) return p.x < q.x;
+        if (p.y != q.y) return p.y < q.y;
+        return p.z < q.z;
+    }
+};
+
+class Simplifier {
+public:
+    Simplifier(const float * positions, uint32_t stride, uint32_t vertexCount,
+            const uint32_t * indices, uint32_t indexCount);
+
+    void run(uint32_t targetTriangles);
+    void write(std::vector<uint32_t>& out) const;
+
+private:
+    Vector3 faceNormal(uint32_t t, uint32_t replace, uint32_t with) const;
+    void findCollapse(uint32_t v);
+    void collapse(uint32_t from, uint32_t to);
+
+    std::vector<Vector3> mPoints;
+    std::vector<uint32_t> mTris;            // 3 per triangle
+    std::vector<uint8_t> mTriAlive;
+    std::vector<std::vector<uint32_t> > mAdjacent;  // vertex -> triangles
+    std::vector<Quadric> mQuadrics;
+    std::vector<uint8_t> mLocked;
+    std::vector<uint32_t> mStamps;
+    std::vector<uint32_t> mMarks;
+    uint32_t mMark;
+    uint32_t mLiveTris;
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse> > mHeap;
+};
+
+Simplifier::Simplifier(const float * positions, uint32_t stride, uint32_t vertexCount,
+        const uint32_t * indices, uint32_t indexCount) :
+        mPoints(vertexCount), mAdjacent(vertexCount), mQuadrics(vertexCount),
+        mLocked(vertexCount, 0), mStamps(vertexCount, 0), mMarks(vertexCount, 0),
+        mMark(0), mLiveTris(0) {
+    for (uint32_t i = 0; i < vertexCount; i++) {
+        const float * p = positions + i * stride;
+        mPoints[i] = Vector3(p[0], p[1], p[2]);
+    }
+
+    mTris.reserve(indexCount);
+    for (uint32_t i = 0; i + 2 < indexCount; i += 3) {
+        const uint32_t a = indices[i], b = indices[i + 1], c = indices[i + 2];
+        if (a >= vertexCount || b >= vertexCount || c >= vertexCount || a == b || b == c || c == a)
+            continue;
+        mTris.push_back(a);
+        mTris.push_back(b);
+        mTris.push_back(c);
+    }
+    const uint32_t triCount = (uint32_t) mTris.size() / 3;
+    mTriAlive.assign(triCount, 1);
+    mLiveTris = triCount;
+
+    // Split vertices: more than one index at one position.
+    std::vector<uint32_t> order(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; i++)
+        order[i] = i;
+    PositionLess less = {&mPoints};
+    std::sort(order.begin(), order.end(), less);
+    for (uint32_t i = 1; i < vertexCount; i++) {
+        if (!less(order[i - 1], order[i]))
+            mLocked[order[i - 1]] = mLocked[order[i]] = 1;
+    }
+
+    // Open edges: a half edge without its twin.
+    std::unordered_set<uint64_t> halfEdges;
+    halfEdges.reserve(mTris.size());
+    for (size_t i = 0; i < mTris.size(); i += 3) {
+        for (int k = 0; k < 3; k++)
+            halfEdges.insert(((uint64_t) mTris[i + k] << 32) | mTris[i + (k + 1) % 3]);
+    }
+    for (size_t i = 0; i < mTris.size(); i += 3) {
+        for (int k = 0; k < 3; k++) {
+            const uint32_t a = mTris[i + k], b = mTris[i + (k + 1) % 3];
+            if (halfEdges.find(((uint64_t) b << 32) | a) == halfEdges.end())
+                mLocked[a] = mLocked[b] = 1;
+        }
+    }
+
+    // Area weighted plane quadrics.
+    for (uint32_t t = 0; t < triCount; t++) {
+        const Vector3& a = mPoints[mTris[t * 3]];
+        Vector3 n = (mPoints[mTris[t * 3 + 1]] - a).cross(mPoints[mTris[t * 3 + 2]] - a);
+        const float area2 = n.length();
+        if (area2 > 0)
+            n /= area2;
+        Quadric q;
+        q.addPlane(n.x, n.y, n.z, -n.dot(a), area2 * 0.5);
+        for (int k = 0; k < 3; k++) {
+            mQuadrics[mTris[t * 3 + k]].add(q);
+            mAdjacent[mTris[t * 3 + k]].push_back(t);
+        }
+    }
+}
+
+// Normal of triangle t with vertex replace moved onto with.
+Vector3 Simplifier::faceNormal(uint32_t t, uint32_t replace, uint32_t with) const {
+    uint32_t v[3];
+    for (int k = 0; k < 3; k++)
+        v[k] = mTris[t * 3 + k] == replace ? with : mTris[t * 3 + k];
+    const Vector3& a = mPoints[v[0]];
+    return (mPoints[v[1]] - a).cross(mPoints[v[2]] - a);
+}
+
+// Queue the cheapest collapse of v that flips no triangle.
+void Simplifier::findCollapse(uint32_t v) {
+    mStamps[v]++;
+    if (mLocked[v])
+        return;
+
+    const std::vector<uint32_t>& tris = mAdjacent[v];
+    mMark++;
+    double best = DBL_MAX;
+    uint32_t bestTo = v;
+    for (size_t i = 0; i < tris.size(); i++) {
+        const uint32_t t = tris[i];
+        if (!mTriAlive[t])
+            continue;
+        for (int k = 0; k < 3; k++) {
+            const uint32_t u = mTris[t * 3 + k];
+            if (u == v || mMarks[u] == mMark)
+                continue;
+            mMarks[u] = mMark;
+
+            const double cost = mQuadrics[v].eval(mPoints[u]) + mQuadrics[u].eval(mPoints[u]);
+            if (cost >= best)
+                continue;
+            bool flips = false;
+            for (size_t j = 0; j < tris.size() && !flips; j++) {
+                const uint32_t s = tris[j];
+                if (!mTriAlive[s] || mTris[s * 3] == u || mTris[s * 3 + 1] == u || mTris[s * 3 + 2] == u)
+                    continue;
+                // Turning a face more than about 75 degrees also counts,
+                // it leaves slivers standing on edge.
+                const Vector3 after = faceNormal(s, v, u);
+                const Vector3 before = faceNormal(s, v, v);
+                flips = after.dot(before) <= 0.25f * after.length() * before.length();
+            }
+            if (!flips) {
+                best = cost;
+                bestTo = u;
+            }
+        }
+    }
+    if (bestTo != v) {
+        Collapse c = {best, v, bestTo, mStamps[v]};
+        mHeap.push(c);
+    }
+}
+
+void Simplifier::collapse(uint32_t from, uint32_t to) {
+    mQuadrics[to].add(mQuadrics[from]);
+    std::vector<uint32_t>& tris = mAdjacent[from];
+    for (size_t i = 0; i < tris.size(); i++) {
+        const uint32_t t = tris[i];
+        if (!mTriAlive[t])
+            continue;
+        uint32_t * v = &mTris[t * 3];
+        if (v[0] == to || v[1] == to || v[2] == to) {
+            mTriAlive[t] = 0;
+            mLiveTris--;
+            continue;
+        }
+        for (int k = 0; k < 3; k++) {
+            if (v[k] == from)
+                v[k] = to;
+        }
+        mAdjacent[to].push_back(t);
+    }
+    std::vector<uint32_t>().swap(tris);
+    mLocked[from] = 1;
+    mStamps[from]++;
+
+    // Drop dead triangles from to's list, then requeue to and its ring.
+    std::vector<uint32_t>& around = mAdjacent[to];
+    around.erase(std::remove_if(around.begin(), around.end(),
+            [this](uint32_t t) { return !mTriAlive[t]; }), around.end());
+    std::vector<uint32_t> ring;
+    mMark++;
+    mMarks[to] = mMark;
+    for (size_t i = 0; i < around.size(); i++) {
+        for (int k = 0; k < 3; k++) {
+            const uint32_t u = mTris[around[i] * 3 + k];
+            if (mMarks[u] != mMark) {
+                mMarks[u] = mMark;
+                ring.push_back(u);
+            }
+        }
+    }
+    findCollapse(to);
+    for (size_t i = 0; i < ring.size(); i++)
+        findCollapse(ring[i]);
+}
+
+void Simplifier::run(uint32_t targetTriangles) {
+    for (uint32_t v = 0; v < (uint32_t) mPoints.size(); v++)
+        findCollapse(v);
+    while (mLiveTris > targetTriangles && !mHeap.empty()) {
+        const Collapse c = mHeap.top();
+        mHeap.pop();
+        if (c.stamp != mStamps[c.from])
+            continue;
+        collapse(c.from, c.to);
+    }
+}
+
+void Simplifier::write(std::vector<uint32_t>& out) const {
+    out.clear();
+    out.reserve(mLiveTris * 3);
+    for (size_t t = 0; t < mTriAlive.size(); t++) {
+        if (mTriAlive[t])
+            out.insert(out.end(), &mTris[t * 3], &mTris[t * 3] + 3);
+    }
+}
+}  // namespace
+
+uint32_t MeshSimplifier::simplify(const float * positions, uint32_t stride, uint32_t vertexCount,
+        const uint32_t * indices, uint32_t indexCount, uint32_t targetIndexCount,
+        std::vector<uint32_t>& out) {
+    if (positions == NULL || indices == NULL || stride < 3) {
+        LOGE("simplify: invalid input");
+        out.clear();
+        return 0;
+    }
+    Simplifier simplifier(positions, stride, vertexCount, indices, indexCount);
+    simplifier.run(targetIndexCount / 3);
+    simplifier.write(out);
+    return (uint32_t) out.size();
+}
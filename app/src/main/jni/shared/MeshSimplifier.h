@@ -0,0 +1,32 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+// Quadric error metric simplification (Garland and Heckbert).
+//
+// Each step moves one vertex onto a neighbour, so the output only indexes
+// vertices of the input and a coarser level can share the vertex buffer of
+// the full mesh.  Vertices on an open edge, or sharing their position with
+// another vertex as at a texture seam, never move: outlines and seams stay
+// put at the cost of less reduction on heavily split meshes.
+class MeshSimplifier {
+public:
+    // positions: xyz of vertex i at positions[i * stride].
+    // Writes the kept triangles to out and returns their index count, which
+    // stays above targetIndexCount when no further collapse is safe.
+    static uint32_t simplify(const float * positions, uint32_t stride, uint32_t vertexCount,
+            const uint32_t * indices, uint32_t indexCount, uint32_t targetIndexCount,
+            std::vector<uint32_t>& out);
+};
@@ -0,0 +1,170 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#define LOG_TAG "PoseHistory"
+#include <log.h>
+#include <math.h>
+#include <PoseHistory.h>
+
+const uint32_t PoseHistory::kCapacity;
+const int64_t PoseHistory::kMaxPredictionNs;
+
+// Samples spanned by getVelocity().  More is smoother and lags more.
+static const uint32_t kVelocitySpan = 3;
+// After a gap this long, as when tracking was lost, the filter starts over.
+static const float kFilterRestart = 0.25f;
+
+// Low pass weight of a new value for a cutoff in Hz.
+static inline float smoothing(float cutoff, float dt) {
+    const float tau = 1.0f / (2.0f * (float) M_PI * cutoff);
+    return 1.0f / (1.0f + tau / dt);
+}
+
+PoseHistory::PoseHistory()
+        : mFilter(kFilterNone)
+        , mTimeConstant(0.05f) {
+    mOneEuro.minCutoff = 1.0f;
+    mOneEuro.beta = 0.5f;
+    mOneEuro.derivativeCutoff = 1.0f;
+    reset();
+}
+
+void PoseHistory::reset() {
+    for (uint32_t i = 0; i < kCapacity; i++)
+        mSlots[i].sequence.store(0, std::memory_order_relaxed);
+    mWritten.store(0, std::memory_order_release);
+    mHasFiltered = false;
+    mLinearSpeed = 0;
+    mAngularSpeed = 0;
+}
+
+void PoseHistory::setFilter(FilterMode mode) {
+    if (mode == mFilter)
+        return;
+    mFilter = mode;
+    mHasFiltered = false;
+}
+
+void PoseHistory::setOneEuroParams(const OneEuroParams& params) {
+    if (params.minCutoff <= 0 || params.derivativeCutoff <= 0 || params.beta < 0) {
+        LOGW("Ignore One Euro params %f %f %f", params.minCutoff, params.beta, params.derivativeCutoff);
+        return;
+    }
+    mOneEuro = params;
+}
+
+void PoseHistory::setTimeConstant(float seconds) {
+    if (seconds > 0)
+        mTimeConstant = seconds;
+}
+
+void PoseHistory::filter(Sample& raw) {
+    // mFiltered.time means nothing before the first sample.
+    if (mFilter == kFilterNone || !mHasFiltered || (raw.time - mFiltered.time) / 1e9f > kFilterRestart) {
+        mFiltered = raw;
+        mHasFiltered = true;
+        mLinearSpeed = 0;
+        mAngularSpeed = 0;
+        return;
+    }
+    const float dt = (raw.time - mFiltered.time) / 1e9f;
+
+    float linearWeight, angularWeight;
+    if (mFilter == kFilterOneEuro) {
+        // The cutoff rises with the filtered speed, so fast motion lags less.
+        const float linearSpeed = raw.position.distance(mFiltered.position) / dt;
+        const float angularSpeed = (raw.rotation * mFiltered.rotation.conjugate()).toRotationVector().length() / dt;
+        const float derivativeWeight = smoothing(mOneEuro.derivativeCutoff, dt);
+        mLinearSpeed += (linearSpeed - mLinearSpeed) * derivativeWeight;
+        mAngularSpeed += (angularSpeed - mAngularSpeed) * derivativeWeight;
+        linearWeight = smoothing(mOneEuro.minCutoff + mOneEuro.beta * mLinearSpeed, dt);
+        angularWeight = smoothing(mOneEuro.minCutoff + mOneEuro.beta * mAngularSpeed, dt);
+    } else {
+        linearWeight = angularWeight = 1.0f - expf(-dt / mTimeConstant);
+    }
+
+    mFiltered.time = raw.time;
+    mFiltered.position += (raw.position - mFiltered.position) * linearWeight;
+    mFiltered.rotation = Quaternion::slerp(mFiltered.rotation, raw.rotation, angularWeight);
+    raw = mFiltered;
+}
+
+void PoseHistory::push(int64_t time, const Matrix4& pose) {
+    const uint32_t n = mWritten.load(std::memory_order_relaxed);
+    if (n > 0 && time <= mSlots[(n - 1) % kCapacity].sample.time)
+        return;
+
+    Sample sample;
+    sample.time = time;
+    const float * m = pose.get();
+    sample.position.set(m[12], m[13], m[14]);
+    sample.rotation = Quaternion::fromMatrix(pose);
+    filter(sample);
+
+    Slot & slot = mSlots[n % kCapacity];
+    slot.sequence.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.sample = sample;
+    slot.sequence.store(2 * (n + 1), std::memory_order_release);
+    mWritten.store(n + 1, std::memory_order_release);
+}
+
+bool PoseHistory::getSample(uint32_t age, Sample& sample) const {
+    // A slot that changed while it was copied belongs to a newer sample;
+    // start over from the new latest.
+    for (int attempt = 0; attempt < 4; attempt++) {
+        const uint32_t written = mWritten.load(std::memory_order_acquire);
+        if (age >= written || age >= kCapacity)
+            return false;
+        const uint32_t n = written - 1 - age;
+        const Slot & slot = mSlots[n % kCapacity];
+        if (slot.sequence.load(std::memory_order_acquire) != 2 * (n + 1))
+            continue;
+        sample = slot.sample;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == 2 * (n + 1))
+            return true;
+    }
+    return false;
+}
+
+bool PoseHistory::getVelocity(Vector3& linear, Vector3& angular) const {
+    Sample latest, earlier;
+    const uint32_t count = getCount();
+    if (count < 2 || !getSample(0, latest))
+        return false;
+    const uint32_t span = count - 1 < kVelocitySpan ? count - 1 : kVelocitySpan;
+    if (!getSample(span, earlier) || latest.time <= earlier.time)
+        return false;
+
+    const float dt = (latest.time - earlier.time) / 1e9f;
+    linear = (latest.position - earlier.position) / dt;
+    angular = (latest.rotation * earlier.rotation.conjugate()).toRotationVector() / dt;
+    return true;
+}
+
+bool PoseHistory::predict(int64_t time, Matrix4& pose) const {
+    Sample sample;
+    if (!getSample(0, sample))
+        return false;
+
+    int64_t ahead = time - sample.time;
+    if (ahead > kMaxPredictionNs)
+        ahead = kMaxPredictionNs;
+    Vector3 linear, angular;
+    if (ahead > 0 && getVelocity(linear, angular)) {
+        const float dt = ahead / 1e9f;
+        sample.position += linear * dt;
+        sample.rotation = (Quaternion::fromRotationVector(angular * dt) * sample.rotation).normalize();
+    }
+    pose = DualQuaternion(sample.rotation, sample.position).toMatrix();
+    return true;
+}
@@ -0,0 +1,104 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <Matrices.h>
+#include <Quaternion.h>
+
+// Recent poses of one tracked device, filtered, with velocity and prediction.
+//
+// push() belongs to one thread, normally the one fetching poses.  Every other
+// call may come from any thread: samples live in a fixed ring where each slot
+// carries a sequence number, and readers retry a slot that was rewritten
+// under them instead of taking a lock.
+//
+// The ring holds filtered poses.  kFilterOneEuro smooths slow motion hard and
+// lets fast motion through, which suits controller rays.  kFilterExponential
+// slerps toward each new pose with a fixed time constant.
+//
+// Times are CLOCK_MONOTONIC nanoseconds, the base of WVR pose timestamps.
+class PoseHistory {
+public:
+    static const uint32_t kCapacity = 16;
+    // Prediction further ahead than this is clamped.
+    static const int64_t kMaxPredictionNs = 50000000;
+
+    enum FilterMode {
+        kFilterNone,
+        kFilterOneEuro,
+        kFilterExponential,
+        kFilterModeCount
+    };
+
+    struct Sample {
+        int64_t time;
+        Vector3 position;
+        Quaternion rotation;
+    };
+
+    struct OneEuroParams {
+        float minCutoff;    // Hz, at rest
+        float beta;         // cutoff added per meter or radian per second
+        float derivativeCutoff;
+    };
+
+public:
+    PoseHistory();
+
+    // Drops the samples and the filter state.  Not while another thread reads.
+    void reset();
+
+    void setFilter(FilterMode mode);
+    inline FilterMode getFilter() const {
+        return mFilter;
+    }
+    void setOneEuroParams(const OneEuroParams& params);
+    // Seconds to cover about 63% of a step.
+    void setTimeConstant(float seconds);
+
+    // A pose older than the latest is dropped.
+    void push(int64_t time, const Matrix4& pose);
+
+    inline uint32_t getCount() const {
+        uint32_t written = mWritten.load(std::memory_order_acquire);
+        return written < kCapacity ? written : kCapacity;
+    }
+
+    // age 0 is the latest.  False when there is no such sample.
+    bool getSample(uint32_t age, Sample& sample) const;
+    // Per second over the last few samples.  angular is axis times radians.
+    bool getVelocity(Vector3& linear, Vector3& angular) const;
+    // The latest filtered pose extrapolated to time.
+    bool predict(int64_t time, Matrix4& pose) const;
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> sequence;     // odd while being written
+        Sample sample;
+    };
+
+    void filter(Sample& raw);
+
+    Slot mSlots[kCapacity];
+    std::atomic<uint32_t> mWritten;
+
+    // Writer side.
+    FilterMode mFilter;
+    OneEuroParams mOneEuro;
+    float mTimeConstant;
+    bool mHasFiltered;
+    Sample mFiltered;
+    float mLinearSpeed;         // filtered derivatives for kFilterOneEuro
+    float mAngularSpeed;
+};
@@ -0,0 +1,105 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#include <Quaternion.h>
+
+Quaternion Quaternion::fromMatrix(const Matrix4& matrix) {
+    // Column major: row r, column c is m[c * 4 + r].
+    const float * m = matrix.get();
+    const float trace = m[0] + m[5] + m[10];
+    Quaternion q;
+    if (trace > 0) {
+        const float s = 0.5f / sqrtf(trace + 1.0f);
+        q = Quaternion((m[6] - m[9]) * s, (m[8] - m[2]) * s, (m[1] - m[4]) * s, 0.25f / s);
+    } else if (m[0] > m[5] && m[0] > m[10]) {
+        const float s = 2.0f * sqrtf(1.0f + m[0] - m[5] - m[10]);
+        q = Quaternion(0.25f * s, (m[4] + m[1]) / s, (m[8] + m[2]) / s, (m[6] - m[9]) / s);
+    } else if (m[5] > m[10]) {
+        const float s = 2.0f * sqrtf(1.0f + m[5] - m[0] - m[10]);
+        q = Quaternion((m[4] + m[1]) / s, 0.25f * s, (m[9] + m[6]) / s, (m[8] - m[2]) / s);
+    } else {
+        const float s = 2.0f * sqrtf(1.0f + m[10] - m[0] - m[5]);
+        q = Quaternion((m[8] + m[2]) / s, (m[9] + m[6]) / s, 0.25f * s, (m[1] - m[4]) / s);
+    }
+    return q.normalize();
+}
+
+Quaternion Quaternion::fromAxisAngle(const Vector3& axis, float degrees) {
+    Vector3 unit = axis;
+    unit.normalize();
+    return fromRotationVector(unit * (degrees * (float) M_PI / 180.0f));
+}
+
+Quaternion Quaternion::fromRotationVector(const Vector3& v) {
+    const float angle = v.length();
+    if (angle < 1e-7f)
+        return Quaternion(v.x * 0.5f, v.y * 0.5f, v.z * 0.5f, 1).normalize();
+    const float s = sinf(angle * 0.5f) / angle;
+    return Quaternion(v.x * s, v.y * s, v.z * s, cosf(angle * 0.5f));
+}
+
+Vector3 Quaternion::toRotationVector() const {
+    // The shorter way round.
+    const float sign = w < 0 ? -1.0f : 1.0f;
+    const Vector3 v(x * sign, y * sign, z * sign);
+    const float s = v.length();
+    if (s < 1e-7f)
+        return v * 2.0f;
+    return v * (2.0f * atan2f(s, w * sign) / s);
+}
+
+Quaternion Quaternion::slerp(const Quaternion& a, const Quaternion& b, float t) {
+    Quaternion to = b;
+    float cosAngle = a.dot(b);
+    if (cosAngle < 0) {
+        to = -b;
+        cosAngle = -cosAngle;
+    }
+    // Nearly parallel: sin(angle) is too small to divide by.
+    if (cosAngle > 0.9995f)
+        return nlerp(a, to, t);
+    const float angle = acosf(cosAngle);
+    const float inv = 1.0f / sinf(angle);
+    return a * (sinf((1 - t) * angle) * inv) + to * (sinf(t * angle) * inv);
+}
+
+Quaternion Quaternion::nlerp(const Quaternion& a, const Quaternion& b, float t) {
+    const Quaternion to = a.dot(b) < 0 ? -b : b;
+    return (a * (1 - t) + to * t).normalize();
+}
+
+Matrix4 Quaternion::toMatrix() const {
+    const float xx = x * x, yy = y * y, zz = z * z;
+    const float xy = x * y, xz = x * z, yz = y * z;
+    const float wx = w * x, wy = w * y, wz = w * z;
+    return Matrix4(
+        1 - 2 * (yy + zz), 2 * (xy + wz), 2 * (xz - wy), 0,
+        2 * (xy - wz), 1 - 2 * (xx + zz), 2 * (yz + wx), 0,
+        2 * (xz + wy), 2 * (yz - wx), 1 - 2 * (xx + yy), 0,
+        0, 0, 0, 1);
+}
+
+Quaternion Quaternion::yawOnly() const {
+    // Swing twist: the twist about y keeps only the y and w parts.
+    Quaternion twist(0, y, 0, w);
+    if (twist.dot(twist) < 1e-12f)
+        return Quaternion();
+    return twist.normalize();
+}
+
+Matrix4 DualQuaternion::toMatrix() const {
+    Matrix4 m = real.toMatrix();
+    const Vector3 t = getTranslation();
+    m[12] = t.x;
+    m[13] = t.y;
+    m[14] = t.z;
+    return m;
+}
@@ -0,0 +1,176 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#pragma once
+
+#include <math.h>
+#include <Matrices.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define QUATERNION_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define QUATERNION_SSE 1
+#endif
+
+// Unit quaternion rotations and dual quaternion rigid transforms.
+//
+// The products are four wide on NEON and SSE2.  Angles are in degrees, as in
+// Matrix4::rotate(), except where a name says radians.  A rotation matches
+// the Matrix4 it converts to: q.rotate(v) == q.toMatrix() * v, and a * b
+// applies b first.
+struct Quaternion
+{
+    float x;
+    float y;
+    float z;
+    float w;
+
+    Quaternion() : x(0), y(0), z(0), w(1) {}
+    Quaternion(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+
+    // The rotation part of a rigid transform.
+    static Quaternion fromMatrix(const Matrix4& m);
+    static Quaternion fromAxisAngle(const Vector3& axis, float degrees);
+    // Axis times angle in radians, the inverse of toRotationVector().
+    static Quaternion fromRotationVector(const Vector3& v);
+    static Quaternion slerp(const Quaternion& a, const Quaternion& b, float t);
+    // Cheaper than slerp, fine for steps of a few degrees.
+    static Quaternion nlerp(const Quaternion& a, const Quaternion& b, float t);
+
+    Matrix4 toMatrix() const;
+    Vector3 toRotationVector() const;
+
+    // The rotation about +y left once pitch and roll are removed.  Identity
+    // when looking straight up or down.
+    Quaternion yawOnly() const;
+    inline float getYawRadians() const {
+        return 2.0f * atan2f(y, w);
+    }
+
+    inline Quaternion conjugate() const {
+        return Quaternion(-x, -y, -z, w);
+    }
+    inline float dot(const Quaternion& q) const {
+        return x * q.x + y * q.y + z * q.z + w * q.w;
+    }
+    inline Quaternion& normalize() {
+        const float length = sqrtf(dot(*this));
+        if (length > 0) {
+            const float inv = 1.0f / length;
+            x *= inv; y *= inv; z *= inv; w *= inv;
+        } else {
+            x = y = z = 0; w = 1;
+        }
+        return *this;
+    }
+
+    inline Vector3 rotate(const Vector3& v) const {
+        // v + 2w(u x v) + 2u x (u x v), u the vector part.
+        const Vector3 u(x, y, z);
+        const Vector3 t = u.cross(v) * 2.0f;
+        return v + t * w + u.cross(t);
+    }
+
+    inline Quaternion operator+(const Quaternion& q) const {
+        return Quaternion(x + q.x, y + q.y, z + q.z, w + q.w);
+    }
+    inline Quaternion operator*(float s) const {
+        return Quaternion(x * s, y * s, z * s, w * s);
+    }
+    inline Quaternion operator-() const {
+        return Quaternion(-x, -y, -z, -w);
+    }
+    Quaternion operator*(const Quaternion& q) const;
+};
+
+// Rotation then translation, the rigid transforms of tracked poses.
+struct DualQuaternion
+{
+    Quaternion real;    // rotation
+    Quaternion dual;    // half the translation times real
+
+    DualQuaternion() : real(), dual(0, 0, 0, 0) {}
+    DualQuaternion(const Quaternion& rotation, const Vector3& translation)
+            : real(rotation)
+            , dual(Quaternion(translation.x, translation.y, translation.z, 0) * rotation * 0.5f) {}
+
+    static DualQuaternion fromMatrix(const Matrix4& m) {
+        return DualQuaternion(Quaternion::fromMatrix(m), Vector3(m[12], m[13], m[14]));
+    }
+    Matrix4 toMatrix() const;
+
+    inline Vector3 getTranslation() const {
+        const Quaternion t = dual * real.conjugate();
+        return Vector3(2.0f * t.x, 2.0f * t.y, 2.0f * t.z);
+    }
+    inline Vector3 transform(const Vector3& p) const {
+        return real.rotate(p) + getTranslation();
+    }
+
+    // a * b applies b first, as with Matrix4.
+    inline DualQuaternion operator*(const DualQuaternion& b) const {
+        DualQuaternion r;
+        r.real = real * b.real;
+        r.dual = real * b.dual + dual * b.real;
+        return r;
+    }
+    // Of a unit dual quaternion.
+    inline DualQuaternion inverse() const {
+        DualQuaternion r;
+        r.real = real.conjugate();
+        r.dual = dual.conjugate();
+        return r;
+    }
+};
+
+inline Quaternion Quaternion::operator*(const Quaternion& q) const {
+#if defined(QUATERNION_SSE) || defined(QUATERNION_NEON)
+    // Each lane of the result sums one column of the Hamilton product:
+    //   w * (qx qy qz qw)
+    // + x * (qw -qz  qy -qx)
+    // + y * (qz  qw -qx -qy)
+    // + z * (-qy qx  qw -qz)
+    Quaternion r;
+#if defined(QUATERNION_SSE)
+    const __m128 b = _mm_loadu_ps(&q.x);
+    __m128 sum = _mm_mul_ps(_mm_set1_ps(w), b);
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(x), _mm_setr_ps(1, -1, 1, -1)),
+            _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 1, 2, 3))));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(y), _mm_setr_ps(1, 1, -1, -1)),
+            _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(z), _mm_setr_ps(-1, 1, 1, -1)),
+            _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1))));
+    _mm_storeu_ps(&r.x, sum);
+#else
+    static const float kSignX[4] = { 1, -1, 1, -1 };
+    static const float kSignY[4] = { 1, 1, -1, -1 };
+    static const float kSignZ[4] = { -1, 1, 1, -1 };
+    const float32x4_t b = vld1q_f32(&q.x);
+    const float32x4_t yxwz = vrev64q_f32(b);
+    const float32x4_t wzyx = vcombine_f32(vget_high_f32(yxwz), vget_low_f32(yxwz));
+    const float32x4_t zwxy = vextq_f32(b, b, 2);
+    float32x4_t sum = vmulq_n_f32(b, w);
+    sum = vmlaq_f32(sum, vmulq_n_f32(vld1q_f32(kSignX), x), wzyx);
+    sum = vmlaq_f32(sum, vmulq_n_f32(vld1q_f32(kSignY), y), zwxy);
+    sum = vmlaq_f32(sum, vmulq_n_f32(vld1q_f32(kSignZ), z), yxwz);
+    vst1q_f32(&r.x, sum);
+#endif
+    return r;
+#else
+    return Quaternion(
+        w * q.x + x * q.w + y * q.z - z * q.y,
+        w * q.y - x * q.z + y * q.w + z * q.x,
+        w * q.z + x * q.y - y * q.x + z * q.w,
+        w * q.w - x * q.x - y * q.y - z * q.z);
+#endif
+}
@@ -0,0 +1,323 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <BoundingVolume.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RAYPACKET_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RAYPACKET_SSE 1
+#endif
+
+// Four wide ray intersection kernels in SoA layout.
+//
+// Two shapes are covered: four rays against one primitive (RayPacket4), and
+// one ray against four primitives (SpherePacket4, AABBPacket4).  Every kernel
+// writes the hit distance per lane and returns a lane mask, bit i set when
+// lane i hit within [tMin, tMax].  Misses leave t untouched.  Eight wide
+// callers run two packets; 128 bit NEON and SSE2 have no wider float lanes.
+//
+// Results match intersectSphere() and AABB::intersect() in BoundingVolume.h:
+// a ray starting inside a sphere hits its far side, a ray starting inside a
+// box hits at tMin.
+
+namespace simd {
+
+#if defined(RAYPACKET_NEON)
+typedef float32x4_t float4;
+inline float4 load(const float * p) { return vld1q_f32(p); }
+inline void store(float * p, float4 v) { vst1q_f32(p, v); }
+inline float4 splat(float f) { return vdupq_n_f32(f); }
+inline float4 add(float4 a, float4 b) { return vaddq_f32(a, b); }
+inline float4 sub(float4 a, float4 b) { return vsubq_f32(a, b); }
+inline float4 mul(float4 a, float4 b) { return vmulq_f32(a, b); }
+inline float4 min4(float4 a, float4 b) { return vminq_f32(a, b); }
+inline float4 max4(float4 a, float4 b) { return vmaxq_f32(a, b); }
+inline float4 madd(float4 a, float4 b, float4 c) { return vmlaq_f32(c, a, b); }
+#if defined(__aarch64__)
+inline float4 div4(float4 a, float4 b) { return vdivq_f32(a, b); }
+inline float4 sqrt4(float4 a) { return vsqrtq_f32(a); }
+#else
+inline float4 div4(float4 a, float4 b) {
+    float4 r = vrecpeq_f32(b);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    return vmulq_f32(a, r);
+}
+// a * rsqrt(a), with a = 0 kept at 0 instead of 0 * inf.
+inline float4 sqrt4(float4 a) {
+    float4 r = vrsqrteq_f32(a);
+    r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+    r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+    uint32x4_t zero = vceqq_f32(a, vdupq_n_f32(0));
+    return vbslq_f32(zero, a, vmulq_f32(a, r));
+}
+#endif
+// Comparisons return all ones or all zeros per lane.
+inline float4 less(float4 a, float4 b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+inline float4 lessEqual(float4 a, float4 b) { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+inline float4 andMask(float4 a, float4 b) {
+    return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+}
+inline float4 blend(float4 mask, float4 a, float4 b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+inline uint32_t moveMask(float4 mask) {
+    uint32x4_t m = vreinterpretq_u32_f32(mask);
+    return (vgetq_lane_u32(m, 0) & 1) | (vgetq_lane_u32(m, 1) & 2) |
+           (vgetq_lane_u32(m, 2) & 4) | (vgetq_lane_u32(m, 3) & 8);
+}
+#elif defined(RAYPACKET_SSE)
+typedef __m128 float4;
+inline float4 load(const float * p) { return _mm_loadu_ps(p); }
+inline void store(float * p, float4 v) { _mm_storeu_ps(p, v); }
+inline float4 splat(float f) { return _mm_set1_ps(f); }
+inline float4 add(float4 a, float4 b) { return _mm_add_ps(a, b); }
+inline float4 sub(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+inline float4 mul(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+inline float4 min4(float4 a, float4 b) { return _mm_min_ps(a, b); }
+inline float4 max4(float4 a, float4 b) { return _mm_max_ps(a, b); }
+inline float4 madd(float4 a, float4 b, float4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+inline float4 div4(float4 a, float4 b) { return _mm_div_ps(a, b); }
+inline float4 sqrt4(float4 a) { return _mm_sqrt_ps(a); }
+inline float4 less(float4 a, float4 b) { return _mm_cmplt_ps(a, b); }
+inline float4 lessEqual(float4 a, float4 b) { return _mm_cmple_ps(a, b); }
+inline float4 andMask(float4 a, float4 b) { return _mm_and_ps(a, b); }
+inline float4 blend(float4 mask, float4 a, float4 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+inline uint32_t moveMask(float4 mask) { return (uint32_t) _mm_movemask_ps(mask); }
+#else
+// Plain C fallback with the same interface.
+struct float4 { float v[4]; };
+inline float4 load(const float * p) { float4 r = {{ p[0], p[1], p[2], p[3] }}; return r; }
+inline void store(float * p, float4 a) { p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3]; }
+inline float4 splat(float f) { float4 r = {{ f, f, f, f }}; return r; }
+#define RAYPACKET_LANEWISE(name, expr) \
+    inline float4 name(float4 a, float4 b) { float4 r; for (int i = 0; i < 4; i++) { float x = a.v[i], y = b.v[i]; r.v[i] = (expr); } return r; }
+RAYPACKET_LANEWISE(add, x + y)
+RAYPACKET_LANEWISE(sub, x - y)
+RAYPACKET_LANEWISE(mul, x * y)
+RAYPACKET_LANEWISE(min4, x < y ? x : y)
+RAYPACKET_LANEWISE(max4, x > y ? x : y)
+RAYPACKET_LANEWISE(div4, x / y)
+#undef RAYPACKET_LANEWISE
+inline float4 madd(float4 a, float4 b, float4 c) { return add(mul(a, b), c); }
+inline float4 sqrt4(float4 a) { float4 r; for (int i = 0; i < 4; i++) r.v[i] = sqrtf(a.v[i]); return r; }
+inline float4 maskOf(bool b0, bool b1, bool b2, bool b3) {
+    float4 r;
+    uint32_t bits[4] = { b0 ? 0xFFFFFFFFu : 0u, b1 ? 0xFFFFFFFFu : 0u, b2 ? 0xFFFFFFFFu : 0u, b3 ? 0xFFFFFFFFu : 0u };
+    memcpy(r.v, bits, sizeof(bits));
+    return r;
+}
+inline uint32_t bitsOf(float f) { uint32_t u; memcpy(&u, &f, sizeof(u)); return u; }
+inline float4 less(float4 a, float4 b) {
+    return maskOf(a.v[0] < b.v[0], a.v[1] < b.v[1], a.v[2] < b.v[2], a.v[3] < b.v[3]);
+}
+inline float4 lessEqual(float4 a, float4 b) {
+    return maskOf(a.v[0] <= b.v[0], a.v[1] <= b.v[1], a.v[2] <= b.v[2], a.v[3] <= b.v[3]);
+}
+inline float4 andMask(float4 a, float4 b) {
+    return maskOf(bitsOf(a.v[0]) && bitsOf(b.v[0]), bitsOf(a.v[1]) && bitsOf(b.v[1]),
+                  bitsOf(a.v[2]) && bitsOf(b.v[2]), bitsOf(a.v[3]) && bitsOf(b.v[3]));
+}
+inline float4 blend(float4 mask, float4 a, float4 b) {
+    float4 r;
+    for (int i = 0; i < 4; i++)
+        r.v[i] = bitsOf(mask.v[i]) ? a.v[i] : b.v[i];
+    return r;
+}
+inline uint32_t moveMask(float4 mask) {
+    return (bitsOf(mask.v[0]) ? 1u : 0u) | (bitsOf(mask.v[1]) ? 2u : 0u) |
+           (bitsOf(mask.v[2]) ? 4u : 0u) | (bitsOf(mask.v[3]) ? 8u : 0u);
+}
+#endif
+
+}  // namespace simd
+
+// Four rays, one per lane.
+struct RayPacket4 {
+    float ox[4], oy[4], oz[4];
+    float dx[4], dy[4], dz[4];
+    float ix[4], iy[4], iz[4];     // reciprocal directions, as in Ray
+
+    // Lanes past count repeat the last ray so they never produce new hits
+    // of their own; callers mask them off.
+    inline void set(const Ray * rays, uint32_t count) {
+        for (uint32_t i = 0; i < 4; i++) {
+            const Ray& r = rays[i < count ? i : count - 1];
+            ox[i] = r.origin.x; oy[i] = r.origin.y; oz[i] = r.origin.z;
+            dx[i] = r.direction.x; dy[i] = r.direction.y; dz[i] = r.direction.z;
+            ix[i] = r.invDirection.x; iy[i] = r.invDirection.y; iz[i] = r.invDirection.z;
+        }
+    }
+};
+
+// Four spheres, one per lane.  Unused lanes should have a negative radius.
+struct SpherePacket4 {
+    float cx[4], cy[4], cz[4];
+    float radius[4];
+};
+
+// Four boxes, one per lane.  Unused lanes should be empty (min > max).
+struct AABBPacket4 {
+    float minX[4], minY[4], minZ[4];
+    float maxX[4], maxY[4], maxZ[4];
+};
+
+namespace simd {
+
+// Shared by both sphere kernels, all inputs already in lanes.
+inline uint32_t sphereLanes(float4 ox, float4 oy, float4 oz, float4 dx, float4 dy, float4 dz,
+        float4 cx, float4 cy, float4 cz, float4 radius, float4 tMin, float4 tMax, float * t) {
+    float4 wx = sub(ox, cx), wy = sub(oy, cy), wz = sub(oz, cz);
+    float4 a = madd(dx, dx, madd(dy, dy, mul(dz, dz)));
+    float4 b = madd(wx, dx, madd(wy, dy, mul(wz, dz)));
+    float4 c = sub(madd(wx, wx, madd(wy, wy, mul(wz, wz))), mul(radius, radius));
+    float4 disc = sub(mul(b, b), mul(a, c));
+    float4 zero = splat(0);
+    float4 valid = andMask(lessEqual(zero, disc), andMask(less(zero, a), lessEqual(zero, radius)));
+
+    float4 s = sqrt4(max4(disc, zero));
+    float4 nb = sub(zero, b);
+    float4 tNear = div4(sub(nb, s), a);
+    float4 tFar = div4(add(nb, s), a);
+    float4 root = blend(less(tNear, tMin), tFar, tNear);
+    valid = andMask(valid, andMask(lessEqual(tMin, root), lessEqual(root, tMax)));
+
+    uint32_t mask = moveMask(valid);
+    if (mask) {
+        float out[4];
+        store(out, root);
+        for (int i = 0; i < 4; i++) {
+            if (mask >> i & 1)
+                t[i] = out[i];
+        }
+    }
+    return mask;
+}
+
+inline uint32_t boxLanes(float4 ox, float4 oy, float4 oz, float4 ix, float4 iy, float4 iz,
+        float4 minX, float4 minY, float4 minZ, float4 maxX, float4 maxY, float4 maxZ,
+        float4 tMin, float4 tMax, float * t) {
+    float4 t0 = mul(sub(minX, ox), ix), t1 = mul(sub(maxX, ox), ix);
+    float4 lo = min4(t0, t1), hi = max4(t0, t1);
+    t0 = mul(sub(minY, oy), iy); t1 = mul(sub(maxY, oy), iy);
+    lo = max4(lo, min4(t0, t1)); hi = min4(hi, max4(t0, t1));
+    t0 = mul(sub(minZ, oz), iz); t1 = mul(sub(maxZ, oz), iz);
+    lo = max4(lo, min4(t0, t1)); hi = min4(hi, max4(t0, t1));
+    lo = max4(lo, tMin);
+    hi = min4(hi, tMax);
+
+    // The slab test alone accepts inverted (empty) boxes.
+    float4 valid = andMask(lessEqual(lo, hi),
+            andMask(lessEqual(minX, maxX), andMask(lessEqual(minY, maxY), lessEqual(minZ, maxZ))));
+    uint32_t mask = moveMask(valid);
+    if (mask) {
+        float out[4];
+        store(out, lo);
+        for (int i = 0; i < 4; i++) {
+            if (mask >> i & 1)
+                t[i] = out[i];
+        }
+    }
+    return mask;
+}
+
+}  // namespace simd
+
+// Four rays against one sphere.  tMax is per ray, so a packet can carry each
+// ray's closest hit so far.
+inline uint32_t intersectSphere4(const RayPacket4& rays, const Vector3& center, float radius,
+        float tMin, const float * tMax, float * t) {
+    using namespace simd;
+    return sphereLanes(load(rays.ox), load(rays.oy), load(rays.oz),
+            load(rays.dx), load(rays.dy), load(rays.dz),
+            splat(center.x), splat(center.y), splat(center.z), splat(radius),
+            splat(tMin), load(tMax), t);
+}
+
+// Four rays against one box.
+inline uint32_t intersectAABB4(const RayPacket4& rays, const AABB& box, float tMin, const float * tMax, float * t) {
+    using namespace simd;
+    return boxLanes(load(rays.ox), load(rays.oy), load(rays.oz),
+            load(rays.ix), load(rays.iy), load(rays.iz),
+            splat(box.min.x), splat(box.min.y), splat(box.min.z),
+            splat(box.max.x), splat(box.max.y), splat(box.max.z),
+            splat(tMin), load(tMax), t);
+}
+
+// One ray against four spheres.
+inline uint32_t intersectSphere4(const Ray& ray, const SpherePacket4& spheres, float tMin, float tMax, float * t) {
+    using namespace simd;
+    return sphereLanes(splat(ray.origin.x), splat(ray.origin.y), splat(ray.origin.z),
+            splat(ray.direction.x), splat(ray.direction.y), splat(ray.direction.z),
+            load(spheres.cx), load(spheres.cy), load(spheres.cz), load(spheres.radius),
+            splat(tMin), splat(tMax), t);
+}
+
+// One ray against four boxes.
+inline uint32_t intersectAABB4(const Ray& ray, const AABBPacket4& boxes, float tMin, float tMax, float * t) {
+    using namespace simd;
+    return boxLanes(splat(ray.origin.x), splat(ray.origin.y), splat(ray.origin.z),
+            splat(ray.invDirection.x), splat(ray.invDirection.y), splat(ray.invDirection.z),
+            load(boxes.minX), load(boxes.minY), load(boxes.minZ),
+            load(boxes.maxX), load(boxes.maxY), load(boxes.maxZ),
+            splat(tMin), splat(tMax), t);
+}
+
+// Closest of count spheres stored as SoA arrays, four at a time.  Returns the
+// index of the nearest hit and its distance in t, or -1 on a miss.
+inline int32_t closestSphere(const Ray& ray, const float * cx, const float * cy, const float * cz,
+        const float * radius, uint32_t count, float tMin, float tMax, float& t) {
+    using namespace simd;
+    const float4 ox = splat(ray.origin.x), oy = splat(ray.origin.y), oz = splat(ray.origin.z);
+    const float4 dx = splat(ray.direction.x), dy = splat(ray.direction.y), dz = splat(ray.direction.z);
+    const float4 lo = splat(tMin);
+
+    int32_t best = -1;
+    float hit[4];
+    uint32_t first = 0;
+    for (; first + 4 <= count; first += 4) {
+        uint32_t mask = sphereLanes(ox, oy, oz, dx, dy, dz,
+                load(cx + first), load(cy + first), load(cz + first), load(radius + first),
+                lo, splat(tMax), hit);
+        for (uint32_t i = 0; mask; i++, mask >>= 1) {
+            if ((mask & 1) && hit[i] <= tMax) {
+                tMax = hit[i];
+                best = (int32_t) (first + i);
+            }
+        }
+    }
+    if (first < count) {
+        SpherePacket4 tail;
+        for (uint32_t i = 0; i < 4; i++) {
+            bool used = first + i < count;
+            tail.cx[i] = used ? cx[first + i] : 0;
+            tail.cy[i] = used ? cy[first + i] : 0;
+            tail.cz[i] = used ? cz[first + i] : 0;
+            tail.radius[i] = used ? radius[first + i] : -1.0f;
+        }
+        uint32_t mask = intersectSphere4(ray, tail, tMin, tMax, hit);
+        for (uint32_t i = 0; mask; i++, mask >>= 1) {
+            if ((mask & 1) && hit[i] <= tMax) {
+                tMax = hit[i];
+                best = (int32_t) (first + i);
+            }
+        }
+    }
+    if (best >= 0)
+        t = tMax;
+    return best;
+}
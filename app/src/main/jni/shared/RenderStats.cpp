@@ -0,0 +1,24 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#include <RenderStats.h>
+
+uint32_t RenderStats::mTriangles = 0;
+uint32_t RenderStats::mDrawCalls = 0;
+uint32_t RenderStats::mFrameTriangles = 0;
+uint32_t RenderStats::mFrameDrawCalls = 0;
+
+void RenderStats::beginFrame() {
+    mFrameTriangles = mTriangles;
+    mFrameDrawCalls = mDrawCalls;
+    mTriangles = 0;
+    mDrawCalls = 0;
+}
@@ -0,0 +1,51 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#pragma once
+
+#include <stdint.h>
+
+// Per frame draw counters.  Every draw call site reports what it submits;
+// render thread only.
+class RenderStats {
+public:
+    // Keep the counts of the frame just finished and start over.
+    static void beginFrame();
+
+    static inline void addDraw(uint32_t triangles) {
+        mDrawCalls++;
+        mTriangles += triangles;
+    }
+
+    // Of the last finished frame.
+    static inline uint32_t getFrameTriangles() {
+        return mFrameTriangles;
+    }
+
+    static inline uint32_t getFrameDrawCalls() {
+        return mFrameDrawCalls;
+    }
+
+    // So far in this frame.
+    static inline uint32_t getTriangles() {
+        return mTriangles;
+    }
+
+    static inline uint32_t getDrawCalls() {
+        return mDrawCalls;
+    }
+
+private:
+    static uint32_t mTriangles;
+    static uint32_t mDrawCalls;
+    static uint32_t mFrameTriangles;
+    static uint32_t mFrameDrawCalls;
+};
@@ -0,0 +1,117 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#define LOG_TAG "ResolutionController"
+#include <math.h>
+#include <log.h>
+#include <ResolutionController.h>
+
+const float ResolutionController::kMinStep = 0.02f;
+
+namespace {
+// Weight of a new sample in the smoothed frame time.
+const float kSmoothing = 0.25f;
+// Area change per adaptive quality event.
+const float kEventStep = 0.15f;
+// Frames a hint holds, about half a second.
+const uint32_t kHoldFrames = 45;
+}
+
+ResolutionController::ResolutionController() :
+        mMinScale(0.5f), mMaxScale(1.0f), mTarget(1.0f / 75 * 0.9f),
+        mKp(0.3f), mKi(0.08f), mKd(0.1f), mDeadBand(0.05f) {
+    reset();
+}
+
+void ResolutionController::setBounds(float minScale, float maxScale) {
+    if (minScale <= 0 || maxScale < minScale) {
+        LOGE("setBounds: invalid [%f, %f]", minScale, maxScale);
+        return;
+    }
+    mMinScale = minScale;
+    mMaxScale = maxScale;
+    mIntegral = clampArea(mIntegral);
+    applyArea(mScale * mScale);
+}
+
+void ResolutionController::setTargetTime(float seconds) {
+    if (seconds > 0)
+        mTarget = seconds;
+}
+
+void ResolutionController::setGains(float kp, float ki, float kd) {
+    mKp = kp;
+    mKi = ki;
+    mKd = kd;
+}
+
+void ResolutionController::setDeadBand(float fraction) {
+    mDeadBand = fraction;
+}
+
+void ResolutionController::reset() {
+    mSmoothed = 0;
+    mIntegral = mMaxScale * mMaxScale;
+    mLastError = 0;
+    mHold = 0;
+    mScale = mMaxScale;
+}
+
+float ResolutionController::clampArea(float area) const {
+    const float lo = mMinScale * mMinScale, hi = mMaxScale * mMaxScale;
+    return area < lo ? lo : (area > hi ? hi : area);
+}
+
+// Moves mScale only for a change of at least kMinStep, or onto a bound.
+float ResolutionController::applyArea(float area) {
+    const float scale = sqrtf(clampArea(area));
+    const float diff = fabsf(scale - mScale);
+    const bool atBound = scale == mMinScale || scale == mMaxScale;
+    if (diff >= kMinStep || (atBound && diff > 0))
+        mScale = scale;
+    return mScale;
+}
+
+float ResolutionController::update(float gpuSeconds) {
+    if (gpuSeconds <= 0)
+        return mScale;
+    mSmoothed = mSmoothed == 0 ? gpuSeconds : mSmoothed + (gpuSeconds - mSmoothed) * kSmoothing;
+    if (mHold > 0) {
+        mHold--;
+        return mScale;
+    }
+
+    // Positive when there is time to spare.
+    float error = (mTarget - mSmoothed) / mTarget;
+    if (fabsf(error) < mDeadBand)
+        error = 0;
+
+    // The integral carries the settled area and is clamped to the bounds so
+    // it does not wind up while pinned at one of them.
+    mIntegral = clampArea(mIntegral + mKi * error);
+    const float area = mIntegral + mKp * error + mKd * (error - mLastError);
+    mLastError = error;
+    return applyArea(area);
+}
+
+float ResolutionController::requestLower() {
+    mIntegral = clampArea(mScale * mScale - kEventStep);
+    mLastError = 0;
+    mHold = kHoldFrames;
+    return applyArea(mIntegral);
+}
+
+float ResolutionController::requestHigher() {
+    mIntegral = clampArea(mScale * mScale + kEventStep);
+    mLastError = 0;
+    mHold = kHoldFrames;
+    return applyArea(mIntegral);
+}
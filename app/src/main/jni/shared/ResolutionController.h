@@ -0,0 +1,74 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#pragma once
+
+#include <stdint.h>
+
+// Picks the render viewport scale that keeps GPU frame time inside a budget.
+//
+// update() takes one measured frame time, smooths it, and runs a PID step on
+// the relative headroom.  GPU time follows the pixel count, so the
+// controller works on scale^2 and returns its square root.  Headroom within
+// the dead band counts as zero, and the returned scale only moves once the
+// wanted change reaches kMinStep, so frame time noise does not change the
+// viewport every frame.
+class ResolutionController {
+public:
+    static const float kMinStep;
+
+public:
+    ResolutionController();
+
+    void setBounds(float minScale, float maxScale);
+    // Seconds of GPU time to aim for, below the frame period.
+    void setTargetTime(float seconds);
+    inline float getTargetTime() const {
+        return mTarget;
+    }
+    void setGains(float kp, float ki, float kd);
+    // Relative headroom treated as on target.
+    void setDeadBand(float fraction);
+
+    // Feed the GPU time of one frame, get the scale to render the next at.
+    float update(float gpuSeconds);
+
+    // For coarse hints such as the adaptive quality events: one step down or
+    // up, applied at once.  update() keeps the hinted scale for a while
+    // before its own measurements take over again.
+    float requestLower();
+    float requestHigher();
+
+    // Back to the largest scale, forgetting the history.
+    void reset();
+
+    inline float getScale() const {
+        return mScale;
+    }
+
+private:
+    float clampArea(float area) const;
+    float applyArea(float area);
+
+    float mMinScale;
+    float mMaxScale;
+    float mTarget;
+    float mKp;
+    float mKi;
+    float mKd;
+    float mDeadBand;
+
+    float mSmoothed;        // filtered frame time, 0 before the first sample
+    float mIntegral;        // in scale^2
+    float mLastError;
+    uint32_t mHold;         // update() calls left that keep a hinted scale
+    float mScale;
+};
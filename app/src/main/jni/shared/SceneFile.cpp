@@ -0,0 +1,204 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#define LOG_TAG "SceneFile"
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <log.h>
+#include <SceneFile.h>
+
+const uint32_t SceneFile::kVersion;
+const uint32_t SceneFile::kAlignment;
+const uint32_t SceneFile::kNone;
+
+namespace {
+
+const char kMagic[4] = { 'H', 'V', 'S', 'C' };
+
+// Record size per section, 1 for the blobs.
+const uint32_t kRecordSizes[SceneFile::kSectionCount] = {
+    sizeof(SceneFile::MeshRecord),
+    sizeof(SceneFile::SubmeshRecord),
+    sizeof(SceneFile::MaterialRecord),
+    sizeof(SceneFile::TextureRecord),
+    sizeof(SceneFile::NodeRecord),
+    1,
+    1,
+    1
+};
+
+}  // namespace
+
+SceneFile::SceneFile() : mData(NULL), mSize(0), mMapping(NULL), mMappingSize(0) {
+}
+
+SceneFile::~SceneFile() {
+    close();
+}
+
+bool SceneFile::open(const char * path) {
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        LOGE("Unable to open %s", path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(Header)) {
+        LOGE("%s is too small", path);
+        ::close(fd);
+        return false;
+    }
+    void * mapping = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        LOGE("Unable to map %s", path);
+        return false;
+    }
+    mMapping = mapping;
+    mMappingSize = st.st_size;
+    if (!open(mapping, st.st_size)) {
+        LOGE("%s is not a valid scene file", path);
+        return false;
+    }
+    return true;
+}
+
+bool SceneFile::open(const void * data, size_t size) {
+    if (data != mMapping)
+        close();
+    mData = (const uint8_t *) data;
+    mSize = size;
+    if (data == NULL || ((uintptr_t) data) % sizeof(uint32_t) != 0 || !validate()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SceneFile::close() {
+    if (mMapping != NULL)
+        munmap(mMapping, mMappingSize);
+    mMapping = NULL;
+    mMappingSize = 0;
+    mData = NULL;
+    mSize = 0;
+}
+
+bool SceneFile::isString(uint32_t offset) const {
+    return offset == kNone || offset < section(kStrings).size;
+}
+
+bool SceneFile::validateMesh(const MeshRecord& mesh) const {
+    const SectionEntry& vertices = section(kVertexData);
+    const SectionEntry& indices = section(kIndexData);
+    if (mesh.vertexStride < 3 * sizeof(float) || mesh.vertexStride % sizeof(float) != 0 ||
+            mesh.vertexOffset % sizeof(float) != 0)
+        return false;
+    if (mesh.normalOffset != kNone && (mesh.normalOffset % sizeof(float) != 0 ||
+            mesh.normalOffset > mesh.vertexStride - 3 * sizeof(float)))
+        return false;
+    if (mesh.texCoordOffset != kNone && (mesh.texCoordOffset % sizeof(float) != 0 ||
+            mesh.texCoordOffset > mesh.vertexStride - 2 * sizeof(float)))
+        return false;
+    if (mesh.vertexOffset > vertices.size ||
+            (uint64_t) mesh.vertexCount * mesh.vertexStride > vertices.size - mesh.vertexOffset)
+        return false;
+    if ((mesh.indexSize != 2 && mesh.indexSize != 4) || mesh.indexOffset % mesh.indexSize != 0)
+        return false;
+    if (mesh.indexOffset > indices.size ||
+            (uint64_t) mesh.indexCount * mesh.indexSize > indices.size - mesh.indexOffset)
+        return false;
+    if (mesh.firstSubmesh > count(kSubmeshes) || mesh.submeshCount > count(kSubmeshes) - mesh.firstSubmesh)
+        return false;
+    for (uint32_t i = 0; i < mesh.submeshCount; i++) {
+        const SubmeshRecord& submesh = getSubmesh(mesh.firstSubmesh + i);
+        if (submesh.firstIndex > mesh.indexCount || submesh.indexCount > mesh.indexCount - submesh.firstIndex)
+            return false;
+        if (submesh.material != kNone && submesh.material >= count(kMaterials))
+            return false;
+    }
+
+    // A stray index would read past the vertex buffer on the GPU.
+    const void * data = getIndices(mesh);
+    for (uint32_t i = 0; i < mesh.indexCount; i++) {
+        uint32_t index = mesh.indexSize == 2 ? ((const uint16_t *) data)[i] : ((const uint32_t *) data)[i];
+        if (index >= mesh.vertexCount)
+            return false;
+    }
+    return true;
+}
+
+bool SceneFile::validate() const {
+    if (mSize < sizeof(Header))
+        return false;
+    const Header& header = *(const Header *) mData;
+    if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        LOGE("Bad magic");
+        return false;
+    }
+    if (header.version != kVersion) {
+        LOGE("Version %u, expect %u", header.version, kVersion);
+        return false;
+    }
+    if (header.fileSize != mSize || header.sectionCount != kSectionCount) {
+        LOGE("Size %u of %zu, %u sections", header.fileSize, mSize, header.sectionCount);
+        return false;
+    }
+
+    for (uint32_t s = 0; s < kSectionCount; s++) {
+        const SectionEntry& entry = header.sections[s];
+        if (entry.offset % kAlignment != 0 || entry.offset < sizeof(Header) ||
+                entry.offset > mSize || entry.size > mSize - entry.offset ||
+                (uint64_t) entry.count * kRecordSizes[s] != entry.size) {
+            LOGE("Section %u is out of bounds", s);
+            return false;
+        }
+    }
+
+    const SectionEntry& strings = section(kStrings);
+    if (strings.size > 0 && mData[strings.offset + strings.size - 1] != 0) {
+        LOGE("Strings are not terminated");
+        return false;
+    }
+
+    for (uint32_t i = 0; i < getMeshCount(); i++) {
+        if (!validateMesh(getMesh(i))) {
+            LOGE("Mesh %u is out of bounds", i);
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < getMaterialCount(); i++) {
+        const MaterialRecord& material = getMaterial(i);
+        if (!isString(material.name) ||
+                (material.baseColorTexture != kNone && material.baseColorTexture >= getTextureCount())) {
+            LOGE("Material %u is out of bounds", i);
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < getTextureCount(); i++) {
+        if (getTexture(i).uri == kNone || !isString(getTexture(i).uri)) {
+            LOGE("Texture %u is out of bounds", i);
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < getNodeCount(); i++) {
+        const NodeRecord& node = getNode(i);
+        if (!isString(node.name) || (node.parent != kNone && node.parent >= i) ||
+                (node.mesh != kNone && node.mesh >= getMeshCount())) {
+            LOGE("Node %u is out of bounds", i);
+            return false;
+        }
+    }
+    return true;
+}
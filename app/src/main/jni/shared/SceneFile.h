@@ -0,0 +1,202 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Read only view of a scene container: static meshes with their materials,
+// texture references and node hierarchy, as written by tools/meshconv.
+//
+// Layout, little endian throughout:
+//   Header, then the sections it lists, each starting kAlignment aligned.
+//   Record sections are arrays of the structs below.  kStrings holds NUL
+//   terminated names referenced by byte offset.  kVertexData holds the
+//   interleaved vertex streams and kIndexData the index buffers, in the
+//   form glBufferData takes them.
+//
+// open() maps the file and checks every offset and count once, so the
+// getters below are plain pointer arithmetic into the mapping and the
+// buffers can be uploaded straight from it.  Nothing is allocated.
+class SceneFile {
+public:
+    static const uint32_t kVersion = 1;
+    static const uint32_t kAlignment = 16;
+    // Absent attribute, material, texture, parent or mesh.
+    static const uint32_t kNone = 0xFFFFFFFF;
+
+    enum Section {
+        kMeshes,
+        kSubmeshes,
+        kMaterials,
+        kTextures,
+        kNodes,
+        kStrings,
+        kVertexData,
+        kIndexData,
+        kSectionCount
+    };
+
+    struct SectionEntry {
+        uint32_t offset;        // from the start of the file
+        uint32_t size;          // bytes
+        uint32_t count;         // records, or bytes for the blob sections
+        uint32_t reserved;
+    };
+
+    struct Header {
+        char magic[4];          // "HVSC"
+        uint32_t version;
+        uint32_t fileSize;
+        uint32_t sectionCount;
+        SectionEntry sections[kSectionCount];
+    };
+
+    // Positions are three floats at the start of each vertex.  Normals are
+    // three floats and texture coordinates two, at the given byte offsets.
+    struct MeshRecord {
+        uint32_t vertexOffset;  // bytes into kVertexData
+        uint32_t vertexCount;
+        uint32_t vertexStride;
+        uint32_t normalOffset;
+        uint32_t texCoordOffset;
+        uint32_t indexOffset;   // bytes into kIndexData
+        uint32_t indexCount;
+        uint32_t indexSize;     // 2 or 4
+        uint32_t firstSubmesh;
+        uint32_t submeshCount;
+        float boundsMin[3];
+        float boundsMax[3];
+    };
+
+    // A range of the mesh's indices drawn with one material.
+    struct SubmeshRecord {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        uint32_t material;
+        uint32_t reserved;
+    };
+
+    struct MaterialRecord {
+        uint32_t name;
+        float baseColor[4];
+        uint32_t baseColorTexture;
+        uint32_t reserved[2];
+    };
+
+    struct TextureRecord {
+        uint32_t uri;           // an asset path
+    };
+
+    // Parents come before their children.  local is column major, like Matrix4.
+    struct NodeRecord {
+        uint32_t name;
+        uint32_t parent;
+        uint32_t mesh;
+        uint32_t reserved;
+        float local[16];
+    };
+
+public:
+    SceneFile();
+    ~SceneFile();
+
+    // Maps the file read only.
+    bool open(const char * path);
+    // Views memory that must outlive this SceneFile or the next open(),
+    // like an uncompressed asset's buffer.  It must be 4 byte aligned,
+    // which zipalign gives stored assets.
+    bool open(const void * data, size_t size);
+    void close();
+
+    inline bool isOpen() const {
+        return mData != NULL;
+    }
+
+    inline uint32_t getMeshCount() const {
+        return count(kMeshes);
+    }
+
+    inline const MeshRecord& getMesh(uint32_t i) const {
+        return records<MeshRecord>(kMeshes)[i];
+    }
+
+    inline const SubmeshRecord& getSubmesh(uint32_t i) const {
+        return records<SubmeshRecord>(kSubmeshes)[i];
+    }
+
+    inline uint32_t getMaterialCount() const {
+        return count(kMaterials);
+    }
+
+    inline const MaterialRecord& getMaterial(uint32_t i) const {
+        return records<MaterialRecord>(kMaterials)[i];
+    }
+
+    inline uint32_t getTextureCount() const {
+        return count(kTextures);
+    }
+
+    inline const TextureRecord& getTexture(uint32_t i) const {
+        return records<TextureRecord>(kTextures)[i];
+    }
+
+    inline uint32_t getNodeCount() const {
+        return count(kNodes);
+    }
+
+    inline const NodeRecord& getNode(uint32_t i) const {
+        return records<NodeRecord>(kNodes)[i];
+    }
+
+    // "" for kNone.
+    inline const char * getString(uint32_t offset) const {
+        return offset == kNone ? "" : (const char *) (mData + section(kStrings).offset + offset);
+    }
+
+    inline const void * getVertices(const MeshRecord& mesh) const {
+        return mData + section(kVertexData).offset + mesh.vertexOffset;
+    }
+
+    inline const void * getIndices(const MeshRecord& mesh) const {
+        return mData + section(kIndexData).offset + mesh.indexOffset;
+    }
+
+    inline size_t getSize() const {
+        return mSize;
+    }
+
+private:
+    SceneFile(const SceneFile&);
+    SceneFile& operator=(const SceneFile&);
+
+    inline const SectionEntry& section(Section s) const {
+        return ((const Header *) mData)->sections[s];
+    }
+
+    inline uint32_t count(Section s) const {
+        return mData == NULL ? 0 : section(s).count;
+    }
+
+    template <typename T>
+    inline const T * records(Section s) const {
+        return (const T *) (mData + section(s).offset);
+    }
+
+    bool validate() const;
+    bool validateMesh(const MeshRecord& mesh) const;
+    bool isString(uint32_t offset) const;
+
+    const uint8_t * mData;
+    size_t mSize;
+    void * mMapping;
+    size_t mMappingSize;
+};
@@ -0,0 +1,208 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#define LOG_TAG "SceneGraph"
+#include <log.h>
+#include <SceneGraph.h>
+
+const SceneGraph::NodeId SceneGraph::kInvalidNode;
+const uint32_t SceneGraph::kInvalidIndex;
+
+SceneGraph::SceneGraph() : mNeedsSort(false) {
+}
+
+SceneGraph::~SceneGraph() {
+}
+
+SceneGraph::NodeId SceneGraph::createNode(NodeId parent) {
+    std::lock_guard<std::mutex> lock(mLocalMutex);
+    if (parent != kInvalidNode && !isValid(parent)) {
+        LOGE("createNode: invalid parent %u", parent);
+        return kInvalidNode;
+    }
+
+    NodeId id;
+    if (!mFreeIds.empty()) {
+        id = mFreeIds.back();
+        mFreeIds.pop_back();
+    } else {
+        id = (NodeId) mIndexOf.size();
+        mIndexOf.push_back(kInvalidIndex);
+    }
+
+    // Appending keeps the parent first.
+    mIndexOf[id] = (uint32_t) mIds.size();
+    mIds.push_back(id);
+    mParents.push_back(parent == kInvalidNode ? kInvalidIndex : mIndexOf[parent]);
+    mLocal.push_back(Matrix4());
+    mWorld.push_back(Matrix4());
+    mNormal.push_back(Matrix3());
+    mDirty.push_back(1);
+    mChanged.push_back(0);
+    return id;
+}
+
+void SceneGraph::destroyNode(NodeId id) {
+    std::lock_guard<std::mutex> lock(mLocalMutex);
+    if (!isValid(id))
+        return;
+
+    // Children move up to the grandparent, which already precedes them.
+    const uint32_t index = mIndexOf[id];
+    const uint32_t grandparent = mParents[index];
+    const uint32_t count = (uint32_t) mIds.size();
+    for (uint32_t i = 0; i < count; i++) {
+        if (mParents[i] == index) {
+            mParents[i] = grandparent;
+            mDirty[i] = 1;
+        }
+    }
+
+    mIndexOf[id] = kInvalidIndex;
+    mFreeIds.push_back(id);
+    for (uint32_t i = index + 1; i < count; i++) {
+        const uint32_t p = mParents[i];
+        mIds[i - 1] = mIds[i];
+        mParents[i - 1] = p == kInvalidIndex || p < index ? p : p - 1;
+        mLocal[i - 1] = mLocal[i];
+        mWorld[i - 1] = mWorld[i];
+        mNormal[i - 1] = mNormal[i];
+        mDirty[i - 1] = mDirty[i];
+        mChanged[i - 1] = mChanged[i];
+        mIndexOf[mIds[i - 1]] = i - 1;
+    }
+    mIds.pop_back();
+    mParents.pop_back();
+    mLocal.pop_back();
+    mWorld.pop_back();
+    mNormal.pop_back();
+    mDirty.pop_back();
+    mChanged.pop_back();
+}
+
+void SceneGraph::setParent(NodeId id, NodeId parent) {
+    std::lock_guard<std::mutex> lock(mLocalMutex);
+    if (!isValid(id) || (parent != kInvalidNode && !isValid(parent)))
+        return;
+
+    uint32_t index = mIndexOf[id];
+    if (parent != kInvalidNode) {
+        // Refuse cycles: parent must not be id or one of its descendants.
+        for (uint32_t p = mIndexOf[parent]; p != kInvalidIndex; p = mParents[p]) {
+            if (p == index) {
+                LOGE("setParent: %u is a descendant of %u", parent, id);
+                return;
+            }
+        }
+    }
+
+    mParents[index] = parent == kInvalidNode ? kInvalidIndex : mIndexOf[parent];
+    mDirty[index] = 1;
+    if (mParents[index] != kInvalidIndex && mParents[index] > index)
+        mNeedsSort = true;
+}
+
+SceneGraph::NodeId SceneGraph::getParent(NodeId id) const {
+    uint32_t p = mParents[mIndexOf[id]];
+    return p == kInvalidIndex ? kInvalidNode : mIds[p];
+}
+
+void SceneGraph::setLocalTransform(NodeId id, const Matrix4& local) {
+    std::lock_guard<std::mutex> lock(mLocalMutex);
+    if (!isValid(id))
+        return;
+    uint32_t index = mIndexOf[id];
+    mLocal[index] = local;
+    mDirty[index] = 1;
+}
+
+Matrix4 SceneGraph::getLocalTransform(NodeId id) const {
+    std::lock_guard<std::mutex> lock(mLocalMutex);
+    return mLocal[mIndexOf[id]];
+}
+
+// Stable reorder by depth, which keeps every parent ahead of its children.
+void SceneGraph::sortByDepth() {
+    const uint32_t count = (uint32_t) mIds.size();
+    std::vector<uint32_t> depth(count, 0);
+    uint32_t maxDepth = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t d = 0;
+        for (uint32_t p = mParents[i]; p != kInvalidIndex; p = mParents[p])
+            d++;
+        depth[i] = d;
+        if (d > maxDepth)
+            maxDepth = d;
+    }
+
+    std::vector<uint32_t> order;
+    order.reserve(count);
+    for (uint32_t d = 0; d <= maxDepth; d++) {
+        for (uint32_t i = 0; i < count; i++) {
+            if (depth[i] == d)
+                order.push_back(i);
+        }
+    }
+
+    std::vector<uint32_t> remap(count);
+    for (uint32_t i = 0; i < count; i++)
+        remap[order[i]] = i;
+
+    std::vector<NodeId> ids(count);
+    std::vector<uint32_t> parents(count);
+    std::vector<Matrix4> local(count), world(count);
+    std::vector<Matrix3> normal(count);
+    std::vector<uint8_t> dirty(count);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t from = order[i];
+        ids[i] = mIds[from];
+        parents[i] = mParents[from] == kInvalidIndex ? kInvalidIndex : remap[mParents[from]];
+        local[i] = mLocal[from];
+        world[i] = mWorld[from];
+        normal[i] = mNormal[from];
+        dirty[i] = mDirty[from];
+        mIndexOf[ids[i]] = i;
+    }
+    mIds.swap(ids);
+    mParents.swap(parents);
+    mLocal.swap(local);
+    mWorld.swap(world);
+    mNormal.swap(normal);
+    mDirty.swap(dirty);
+    mNeedsSort = false;
+}
+
+uint32_t SceneGraph::update() {
+    std::lock_guard<std::mutex> lock(mLocalMutex);
+    if (mNeedsSort)
+        sortByDepth();
+
+    uint32_t recomputed = 0;
+    const uint32_t count = (uint32_t) mIds.size();
+    for (uint32_t i = 0; i < count; i++) {
+        const uint32_t p = mParents[i];
+        const bool parentChanged = p != kInvalidIndex && mChanged[p];
+        if (!mDirty[i] && !parentChanged) {
+            mChanged[i] = 0;
+            continue;
+        }
+
+        Matrix4& world = mWorld[i];
+        world = p == kInvalidIndex ? mLocal[i] : mWorld[p] * mLocal[i];
+        const float * m = world.get();
+        Matrix3 normal(m[0], m[1], m[2], m[4], m[5], m[6], m[8], m[9], m[10]);
+        mNormal[i] = normal.invert().transpose();
+
+        mDirty[i] = 0;
+        mChanged[i] = 1;
+        recomputed++;
+    }
+    return recomputed;
+}
@@ -0,0 +1,89 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+
+#include <stdint.h>
+#include <mutex>
+#include <vector>
+#include <Matrices.h>
+
+// Transform hierarchy with cached world and normal matrices.
+//
+// Nodes are kept in flat arrays ordered so that a parent always comes before
+// its children.  update() walks the arrays once and recomputes only nodes
+// whose local transform changed or whose parent was recomputed, so a frame
+// where one controller moved touches one subtree.
+//
+// Threading: setLocalTransform() and getLocalTransform() may be called from
+// any thread.  Creating, destroying and reparenting nodes, update() and the
+// world/normal getters belong to one thread, normally the render thread.
+// A local transform set from a worker shows up in the world transform after
+// the next update().
+class SceneGraph {
+public:
+    typedef uint32_t NodeId;
+    static const NodeId kInvalidNode = 0xFFFFFFFF;
+
+public:
+    SceneGraph();
+    ~SceneGraph();
+
+    NodeId createNode(NodeId parent = kInvalidNode);
+    // Children of a destroyed node are moved to its parent.
+    void destroyNode(NodeId id);
+    void setParent(NodeId id, NodeId parent);
+    NodeId getParent(NodeId id) const;
+
+    void setLocalTransform(NodeId id, const Matrix4& local);
+    Matrix4 getLocalTransform(NodeId id) const;
+
+    // As of the last update().
+    inline const Matrix4& getWorldTransform(NodeId id) const {
+        return mWorld[mIndexOf[id]];
+    }
+
+    // Inverse transpose of the world rotation and scale, for lighting.
+    inline const Matrix3& getNormalMatrix(NodeId id) const {
+        return mNormal[mIndexOf[id]];
+    }
+
+    inline bool isValid(NodeId id) const {
+        return id < mIndexOf.size() && mIndexOf[id] != kInvalidIndex;
+    }
+
+    inline uint32_t getCount() const {
+        return (uint32_t) mIds.size();
+    }
+
+    // Recompute changed subtrees.  Returns the number of nodes recomputed.
+    uint32_t update();
+
+private:
+    static const uint32_t kInvalidIndex = 0xFFFFFFFF;
+
+    void sortByDepth();
+
+    // Dense, parent first.
+    std::vector<NodeId> mIds;
+    std::vector<uint32_t> mParents;         // dense index of the parent, or kInvalidIndex
+    std::vector<Matrix4> mLocal;
+    std::vector<Matrix4> mWorld;
+    std::vector<Matrix3> mNormal;
+    std::vector<uint8_t> mDirty;            // local changed since the last update
+    std::vector<uint8_t> mChanged;          // recomputed in the current update
+
+    std::vector<uint32_t> mIndexOf;         // id -> dense index
+    std::vector<NodeId> mFreeIds;
+    bool mNeedsSort;
+
+    // Guards mLocal and mDirty against setLocalTransform() from other threads.
+    mutable std::mutex mLocalMutex;
+};
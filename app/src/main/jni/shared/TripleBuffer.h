@@ -0,0 +1,56 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+// Lock-free single producer, single consumer handoff of the latest value.
+//
+// The producer fills getBack() and publish()es it.  The consumer calls
+// update() and reads getFront(), which stays put until its next update().
+// Neither side ever waits: a value published twice before the consumer
+// looks is simply replaced.  Buffers are reused, so a T that holds vectors
+// stops allocating once they have grown.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : mBack(0), mMiddle(1), mFront(2) {}
+
+    // Producer side.
+    inline T& getBack() {
+        return mBuffers[mBack];
+    }
+    inline void publish() {
+        mBack = mMiddle.exchange(mBack | kFresh, std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    // Consumer side.  True when a newer value was published since the last call.
+    inline bool update() {
+        if (!(mMiddle.load(std::memory_order_relaxed) & kFresh))
+            return false;
+        mFront = mMiddle.exchange(mFront, std::memory_order_acq_rel) & kIndexMask;
+        return true;
+    }
+    inline const T& getFront() const {
+        return mBuffers[mFront];
+    }
+
+private:
+    static const uint32_t kIndexMask = 3;
+    static const uint32_t kFresh = 4;
+
+    T mBuffers[3];
+    uint32_t mBack;                 // producer only
+    std::atomic<uint32_t> mMiddle;  // index, plus kFresh when not yet taken
+    uint32_t mFront;                // consumer only
+};
@@ -0,0 +1,176 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include <AtlasPacker.h>
+#include <AtlasBuilder.h>
+#include <TextureAtlas.h>
+
+#include "HostTestEnv.h"
+
+namespace {
+
+struct Rect {
+    uint32_t page, x, y, w, h;
+};
+
+// Padded rectangles must not touch and must stay inside the page.
+void expectDisjoint(const std::vector<Rect>& rects, uint32_t width, uint32_t height, uint32_t padding) {
+    for (size_t i = 0; i < rects.size(); i++) {
+        const Rect& a = rects[i];
+        EXPECT_GE(a.x, padding);
+        EXPECT_GE(a.y, padding);
+        EXPECT_LE(a.x + a.w + padding, width);
+        EXPECT_LE(a.y + a.h + padding, height);
+        for (size_t j = 0; j < i; j++) {
+            const Rect& b = rects[j];
+            const bool apart = a.page != b.page ||
+                a.x + a.w + padding <= b.x - padding || b.x + b.w + padding <= a.x - padding ||
+                a.y + a.h + padding <= b.y - padding || b.y + b.h + padding <= a.y - padding;
+            EXPECT_TRUE(apart) << i << " overlaps " << j;
+        }
+    }
+}
+
+}  // namespace
+
+TEST(AtlasPackerTest, PacksWithoutOverlap) {
+    const uint32_t kCount = 200;
+    std::vector<uint32_t> widths(kCount), heights(kCount);
+    srand(7);
+    for (uint32_t i = 0; i < kCount; i++) {
+        widths[i] = 4 + rand() % 60;
+        heights[i] = 4 + rand() % 60;
+    }
+    AtlasPacker packer(256, 256, 2, 8);
+    std::vector<AtlasPacker::Placement> placements(kCount);
+    ASSERT_TRUE(packer.addAll(widths.data(), heights.data(), kCount, placements.data()));
+
+    std::vector<Rect> rects;
+    for (uint32_t i = 0; i < kCount; i++) {
+        ASSERT_NE(AtlasPacker::kNoPage, placements[i].page);
+        Rect r = { placements[i].page, placements[i].x, placements[i].y, widths[i], heights[i] };
+        rects.push_back(r);
+    }
+    expectDisjoint(rects, 256, 256, 2);
+    EXPECT_GT(packer.getPageCount(), 1u);
+    // A skyline sorted by height wastes little.
+    EXPECT_GT(packer.getOccupancy(), 0.6f);
+}
+
+TEST(AtlasPackerTest, OpensPagesUpToTheLimit) {
+    AtlasPacker packer(64, 64, 0, 2);
+    AtlasPacker::Placement p;
+    ASSERT_TRUE(packer.add(64, 64, p));
+    EXPECT_EQ(0u, p.page);
+    ASSERT_TRUE(packer.add(32, 32, p));
+    EXPECT_EQ(1u, p.page);
+    ASSERT_TRUE(packer.add(32, 64, p));
+    EXPECT_EQ(1u, p.page);
+    EXPECT_EQ(32u, p.x);
+    // The gap left of the tall one takes a square, not a wide one.
+    EXPECT_FALSE(packer.add(64, 32, p));
+    EXPECT_EQ(AtlasPacker::kNoPage, p.page);
+    AtlasPacker::Placement gap;
+    ASSERT_TRUE(packer.add(32, 32, gap));
+    EXPECT_EQ(1u, gap.page);
+    EXPECT_EQ(0u, gap.x);
+    EXPECT_EQ(32u, gap.y);
+    EXPECT_FLOAT_EQ(1.0f, packer.getOccupancy());
+    // Too large with its padding, even on an empty page.
+    AtlasPacker padded(64, 64, 1, 4);
+    EXPECT_FALSE(padded.add(63, 10, p));
+    EXPECT_EQ(0u, padded.getPageCount());
+
+    AtlasPacker::Region region = packer.getRegion(p, 32, 32);
+    EXPECT_EQ(AtlasPacker::kNoPage, region.page);
+}
+
+TEST(AtlasPackerTest, CopyExtrudesTheEdges) {
+    const uint32_t kPage = 8;
+    std::vector<uint8_t> page(kPage * kPage * 4, 0);
+    // 2x2 of red, green / blue, white.
+    const uint8_t pixels[16] = {
+        255, 0, 0, 255,    0, 255, 0, 255,
+        0, 0, 255, 255,    255, 255, 255, 255,
+    };
+    AtlasPacker packer(kPage, kPage, 2, 1);
+    AtlasPacker::Placement p;
+    ASSERT_TRUE(packer.add(2, 2, p));
+    EXPECT_EQ(2u, p.x);
+    EXPECT_EQ(2u, p.y);
+    AtlasPacker::copyPadded(page.data(), kPage, kPage, pixels, 2, 2, p, 2);
+
+    // Every texel of the padded 6x6 comes from the nearest pixel.
+    for (uint32_t y = 0; y < 6; y++) {
+        for (uint32_t x = 0; x < 6; x++) {
+            const uint32_t sx = x < 3 ? 0 : 1, sy = y < 3 ? 0 : 1;
+            EXPECT_EQ(0, memcmp(&page[(y * kPage + x) * 4], &pixels[(sy * 2 + sx) * 4], 4)) << x << "," << y;
+        }
+    }
+    // Outside the padding stays clear.
+    EXPECT_EQ(0, page[(6 * kPage + 6) * 4 + 3]);
+
+    const AtlasPacker::Region region = packer.getRegion(p, 2, 2);
+    EXPECT_FLOAT_EQ(0.25f, region.u);
+    EXPECT_FLOAT_EQ(0.25f, region.width);
+}
+
+TEST(TextureAtlasTest, ReadsWhatTheBuilderWrites) {
+    AtlasBuilder builder(128, 4, 4);
+    std::vector<uint8_t> red(100 * 40 * 4), blue(20 * 90 * 4);
+    for (size_t i = 0; i < red.size(); i += 4) {
+        red[i] = 255;
+        red[i + 3] = 255;
+    }
+    for (size_t i = 0; i < blue.size(); i += 4) {
+        blue[i + 2] = 255;
+        blue[i + 3] = 255;
+    }
+    ASSERT_TRUE(builder.addImage("red.png", red.data(), 100, 40));
+    ASSERT_TRUE(builder.addImage("blue.png", blue.data(), 20, 90));
+    ASSERT_TRUE(builder.addImage("red_again.png", red.data(), 100, 40));
+    EXPECT_FALSE(builder.addImage("has space.png", red.data(), 1, 1));
+    ASSERT_TRUE(builder.build());
+    EXPECT_EQ(2u, builder.getPageCount());
+
+    TextureAtlas atlas;
+    ASSERT_TRUE(atlas.parse(builder.getManifest("textures/ui").c_str()));
+    ASSERT_EQ(2u, atlas.getPageCount());
+    EXPECT_EQ("ui_0.png", atlas.getPage(0));
+    EXPECT_EQ(3u, atlas.getRegionCount());
+    EXPECT_TRUE(atlas.find("missing.png") == NULL);
+
+    const AtlasPacker::Region * region = atlas.find("blue.png");
+    ASSERT_TRUE(region != NULL);
+    EXPECT_FLOAT_EQ(20.0f / 128, region->width);
+    EXPECT_FLOAT_EQ(90.0f / 128, region->height);
+    // The center of the region is blue on its page.
+    const uint32_t x = (uint32_t) ((region->u + region->width / 2) * 128);
+    const uint32_t y = (uint32_t) ((region->v + region->height / 2) * 128);
+    const uint8_t * texel = &builder.getPage(region->page)[(y * 128 + x) * 4];
+    EXPECT_EQ(0, texel[0]);
+    EXPECT_EQ(255, texel[2]);
+}
+
+TEST(TextureAtlasTest, RejectsRegionsOutsideThePage) {
+    TextureAtlas atlas;
+    EXPECT_FALSE(atlas.parse("atlas 64 64 1\npage a.png\nregion x 0 60 0 8 8\n"));
+    EXPECT_FALSE(atlas.parse("atlas 64 64 1\npage a.png\nregion x 1 0 0 8 8\n"));
+    EXPECT_FALSE(atlas.parse("atlas 64 64 1\nnonsense\n"));
+    EXPECT_TRUE(atlas.parse("# comment\natlas 64 64 1\npage a.png\nregion x 0 0 0 8 8\n"));
+}
@@ -0,0 +1,451 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <Controller.h>
+#include <ControllerModel.h>
+#include <FrameBufferObject.h>
+#include <Mesh.h>
+#include <RenderStats.h>
+#include <Texture.h>
+#include <wvr/wvr_stub.h>
+
+#include "HostTestEnv.h"
+
+namespace {
+
+const char * kName = "HostStubController";
+
+bool fromStub(ControllerModelData& data, uint32_t lodCount = 3) {
+    WVR_CtrlerModel_t * model = NULL;
+    if (WVR_GetCurrentControllerModel(WVR_DeviceType_Controller_Right, &model) != WVR_Success)
+        return false;
+    bool ok = data.fromWVR(kName, *model, lodCount);
+    WVR_ReleaseControllerModel(&model);
+    return ok;
+}
+
+uint32_t runtimeLoads() {
+    WVR_StubStats_t stats;
+    WVR_Stub_GetStats(&stats);
+    return stats.controllerModelLoads;
+}
+
+class ControllerModelCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        WVR_Stub_Reset();
+        char tmpl[] = "/tmp/hellovr_cacheXXXXXX";
+        ASSERT_TRUE(mkdtemp(tmpl) != NULL);
+        mDir = tmpl;
+        ControllerModel::setCacheDirectory(mDir);
+    }
+
+    void TearDown() override {
+        unlink(ControllerModel::getCachePath(kName).c_str());
+        ControllerModel::setCacheDirectory("");
+        rmdir(mDir.c_str());
+    }
+
+    std::string mDir;
+};
+
+}  // namespace
+
+TEST(ControllerModelTest, CopiesTheRuntimeModel) {
+    WVR_Stub_Reset();
+    ControllerModelData data;
+    ASSERT_TRUE(fromStub(data));
+    EXPECT_EQ(kName, data.name);
+    ASSERT_FALSE(data.components.empty());
+    for (size_t i = 0; i < data.components.size(); i++) {
+        const ControllerModelData::Component& comp = data.components[i];
+        EXPECT_FALSE(comp.name.empty());
+        EXPECT_EQ(0u, comp.vertices.size() % comp.vertexDimension);
+        ASSERT_FALSE(comp.lodSizes.empty());
+        EXPECT_EQ(0u, comp.lodFirsts[0]);
+    }
+    ASSERT_EQ(1u, data.bitmaps.size());
+    // Row padding is dropped.
+    EXPECT_EQ(data.bitmaps[0].width * data.bitmaps[0].height * 4, data.bitmaps[0].pixels.size());
+    EXPECT_EQ(3u, data.batteryBitmaps.size());
+    EXPECT_EQ(100, data.batteryMaxLevels.back());
+    EXPECT_TRUE(data.touchpadPlane.valid);
+
+    WVR_StubStats_t stats;
+    WVR_Stub_GetStats(&stats);
+    EXPECT_EQ(0u, stats.liveControllerModels);
+}
+
+TEST(ControllerModelTest, SerializeRoundTrips) {
+    WVR_Stub_Reset();
+    ControllerModelData data;
+    ASSERT_TRUE(fromStub(data));
+    std::vector<uint8_t> bytes;
+    data.serialize(bytes);
+
+    ControllerModelData copy;
+    ASSERT_TRUE(copy.deserialize(bytes.data(), bytes.size()));
+    EXPECT_EQ(data.name, copy.name);
+    EXPECT_EQ(data.lodCount, copy.lodCount);
+    ASSERT_EQ(data.components.size(), copy.components.size());
+    for (size_t i = 0; i < data.components.size(); i++) {
+        const ControllerModelData::Component& a = data.components[i];
+        const ControllerModelData::Component& b = copy.components[i];
+        EXPECT_EQ(a.name, b.name);
+        EXPECT_EQ(a.vertices, b.vertices);
+        EXPECT_EQ(a.texCoords, b.texCoords);
+        EXPECT_EQ(a.indices, b.indices);
+        EXPECT_EQ(a.lodFirsts, b.lodFirsts);
+        EXPECT_EQ(a.lodSizes, b.lodSizes);
+        EXPECT_EQ(a.texIndex, b.texIndex);
+        EXPECT_EQ(0, memcmp(a.localMat, b.localMat, sizeof(a.localMat)));
+    }
+    ASSERT_EQ(data.bitmaps.size(), copy.bitmaps.size());
+    EXPECT_EQ(data.bitmaps[0].pixels, copy.bitmaps[0].pixels);
+    EXPECT_EQ(data.batteryMinLevels, copy.batteryMinLevels);
+    EXPECT_EQ(data.batteryMaxLevels, copy.batteryMaxLevels);
+    EXPECT_EQ(data.batteryBitmaps.back().pixels, copy.batteryBitmaps.back().pixels);
+    EXPECT_EQ(0, memcmp(&data.touchpadPlane.center, &copy.touchpadPlane.center, sizeof(WVR_Vector3f_t)));
+    EXPECT_EQ(data.touchpadPlane.radius, copy.touchpadPlane.radius);
+    EXPECT_EQ(data.touchpadPlane.valid, copy.touchpadPlane.valid);
+}
+
+TEST(ControllerModelTest, RejectsDamagedData) {
+    WVR_Stub_Reset();
+    ControllerModelData data;
+    ASSERT_TRUE(fromStub(data));
+    std::vector<uint8_t> bytes;
+    data.serialize(bytes);
+    ControllerModelData copy;
+
+    // Every truncation fails, none reads past the end.
+    for (size_t size = 0; size < bytes.size(); size += 7)
+        EXPECT_FALSE(copy.deserialize(bytes.data(), size)) << size;
+
+    std::vector<uint8_t> bad = bytes;
+    bad[0] = 'X';
+    EXPECT_FALSE(copy.deserialize(bad.data(), bad.size()));
+
+    bad = bytes;
+    bad[4]++;   // version
+    EXPECT_FALSE(copy.deserialize(bad.data(), bad.size()));
+
+    bad = bytes;
+    bad.push_back(0);
+    EXPECT_FALSE(copy.deserialize(bad.data(), bad.size()));
+
+    // An index past the vertices.
+    data.components[0].indices[0] = 100000;
+    data.serialize(bad);
+    EXPECT_FALSE(copy.deserialize(bad.data(), bad.size()));
+}
+
+TEST_F(ControllerModelCacheTest, SecondLoadReadsTheFile) {
+    const uint32_t before = runtimeLoads();
+    ControllerModelData first;
+    bool fromDisk = true;
+    ASSERT_TRUE(ControllerModel::loadData(WVR_DeviceType_Controller_Left, kName, 3, first, &fromDisk));
+    EXPECT_FALSE(fromDisk);
+    EXPECT_EQ(before + 1, runtimeLoads());
+    EXPECT_EQ(0, access(ControllerModel::getCachePath(kName).c_str(), R_OK));
+
+    // The runtime is still asked, the file is checked against its model.
+    ControllerModelData second;
+    ASSERT_TRUE(ControllerModel::loadData(WVR_DeviceType_Controller_Right, kName, 3, second, &fromDisk));
+    EXPECT_TRUE(fromDisk);
+    EXPECT_EQ(before + 2, runtimeLoads());
+    EXPECT_EQ(first.sourceHash, second.sourceHash);
+    ASSERT_EQ(first.components.size(), second.components.size());
+    EXPECT_EQ(first.components[0].indices, second.components[0].indices);
+}
+
+// A runtime update may keep the model name and change the geometry.
+TEST_F(ControllerModelCacheTest, ChangedModelIsRebuilt) {
+    ControllerModelData data;
+    ASSERT_TRUE(ControllerModel::loadData(WVR_DeviceType_Controller_Left, kName, 3, data));
+    const std::vector<float> vertices = data.components[0].vertices;
+
+    WVR_Stub_SetControllerModelScale(2.0f);
+    bool fromDisk = true;
+    ASSERT_TRUE(ControllerModel::loadData(WVR_DeviceType_Controller_Left, kName, 3, data, &fromDisk));
+    EXPECT_FALSE(fromDisk);
+    ASSERT_EQ(vertices.size(), data.components[0].vertices.size());
+    EXPECT_FLOAT_EQ(2 * vertices[0], data.components[0].vertices[0]);
+
+    ASSERT_TRUE(ControllerModel::loadData(WVR_DeviceType_Controller_Left, kName, 3, data, &fromDisk));
+    EXPECT_TRUE(fromDisk);
+}
+
+TEST_F(ControllerModelCacheTest, StaleOrDamagedFileIsRebuilt) {
+    ControllerModelData data;
+    ASSERT_TRUE(ControllerModel::loadData(WVR_DeviceType_Controller_Left, kName, 3, data));
+    const uint32_t before = runtimeLoads();
+
+    // Other LOD settings do not match the file.
+    bool fromDisk = true;
+    ASSERT_TRUE(ControllerModel::loadData(WVR_DeviceType_Controller_Left, kName, 1, data, &fromDisk));
+    EXPECT_FALSE(fromDisk);
+    EXPECT_EQ(before + 1, runtimeLoads());
+    EXPECT_EQ(1u, data.components[0].lodSizes.size());
+
+    FILE * file = fopen(ControllerModel::getCachePath(kName).c_str(), "r+b");
+    ASSERT_TRUE(file != NULL);
+    fputs("junk", file);
+    fclose(file);
+    ASSERT_TRUE(ControllerModel::loadData(WVR_DeviceType_Controller_Left, kName, 1, data, &fromDisk));
+    EXPECT_FALSE(fromDisk);
+    ASSERT_TRUE(ControllerModel::loadData(WVR_DeviceType_Controller_Left, kName, 1, data, &fromDisk));
+    EXPECT_TRUE(fromDisk);
+}
+
+TEST_F(ControllerModelCacheTest, DisabledWithoutADirectory) {
+    ControllerModel::setCacheDirectory("");
+    EXPECT_TRUE(ControllerModel::getCachePath(kName).empty());
+    const uint32_t before = runtimeLoads();
+    ControllerModelData data;
+    bool fromDisk = true;
+    ASSERT_TRUE(ControllerModel::loadData(WVR_DeviceType_Controller_Left, kName, 3, data, &fromDisk));
+    ASSERT_TRUE(ControllerModel::loadData(WVR_DeviceType_Controller_Left, kName, 3, data, &fromDisk));
+    EXPECT_FALSE(fromDisk);
+    EXPECT_EQ(before + 2, runtimeLoads());
+}
+
+TEST(ControllerModelTest, CachePathIsAPlainFileName) {
+    ControllerModel::setCacheDirectory("/data/cache");
+    EXPECT_EQ("/data/cache/ctrler_a_b_c.d-1.bin", ControllerModel::getCachePath("a/b c.d-1"));
+    ControllerModel::setCacheDirectory("");
+}
+
+TEST(ControllerModelTest, ModelsAreSharedByName) {
+    REQUIRE_GL();
+    WVR_Stub_Reset();
+    ControllerModelData data;
+    ASSERT_TRUE(fromStub(data));
+    EXPECT_FALSE(ControllerModel::isLoaded(kName));
+
+    std::shared_ptr<ControllerModel> left = ControllerModel::create(data);
+    std::shared_ptr<ControllerModel> right = ControllerModel::create(data);
+    EXPECT_EQ(left.get(), right.get());
+    EXPECT_EQ(left.get(), ControllerModel::find(kName).get());
+    ASSERT_EQ(data.components.size(), left->getComponentCount());
+    EXPECT_EQ(data.bitmaps.size(), left->getTextureCount());
+    ASSERT_TRUE(left->getAtlas() != NULL);
+    EXPECT_NE(0, (int) left->getAtlas()->getTextureId());
+    // The GPU copy keeps the layout but not the payload.
+    EXPECT_TRUE(left->getInfo().components[0].vertices.empty());
+    EXPECT_EQ(data.components[0].lodSizes, left->getInfo().components[0].lodSizes);
+    EXPECT_FALSE(left->getBounds(0).isEmpty());
+    EXPECT_EQ(data.components[0].lodSizes.size(), left->getBatchLodCount());
+
+    left.reset();
+    EXPECT_TRUE(ControllerModel::isLoaded(kName));
+    right.reset();
+    EXPECT_FALSE(ControllerModel::isLoaded(kName));
+    EXPECT_TRUE(ControllerModel::find(kName) == nullptr);
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+}
+
+TEST(ControllerModelTest, BatchKeepsTheBatteryLast) {
+    REQUIRE_GL();
+    WVR_Stub_Reset();
+    ControllerModelData data;
+    ASSERT_TRUE(fromStub(data));
+    std::shared_ptr<ControllerModel> model = ControllerModel::create(data);
+    const uint32_t compCount = (uint32_t) data.components.size();
+    EXPECT_EQ(compCount + 1, model->getBatchSlotCount());
+    EXPECT_EQ(compCount, model->getRaySlot());
+    ASSERT_NE(ControllerModel::kNoSlot, model->getBatterySlot());
+    EXPECT_EQ("__CM__Battery", data.components[model->getBatterySlot()].name);
+    EXPECT_NE(0u, model->getBatchVAO());
+    EXPECT_EQ((uint32_t) GL_UNSIGNED_SHORT, model->getBatchIndexType());
+
+    for (uint32_t lod = 0; lod < model->getBatchLodCount(); lod++) {
+        const ControllerModel::BatchRange &main = model->getMainRange(lod);
+        const ControllerModel::BatchRange &battery = model->getBatchRange(lod, model->getBatterySlot());
+        EXPECT_EQ(main.first + main.count, battery.first);
+        uint32_t sum = 0;
+        for (uint32_t slot = 0; slot < model->getBatchSlotCount(); slot++) {
+            const ControllerModel::BatchRange &range = model->getBatchRange(lod, slot);
+            EXPECT_EQ(0u, range.count % 3);
+            if (slot == model->getBatterySlot())
+                continue;
+            EXPECT_GE(range.first, main.first);
+            EXPECT_LE(range.first + range.count, main.first + main.count);
+            sum += range.count;
+        }
+        EXPECT_EQ(main.count, sum);
+        // Components with fewer levels repeat their coarsest one.
+        const std::vector<uint32_t> &sizes = data.components[0].lodSizes;
+        EXPECT_EQ(sizes[lod < sizes.size() ? lod : sizes.size() - 1], model->getBatchRange(lod, 0).count);
+    }
+    // Past the last level is clamped.
+    EXPECT_EQ(model->getMainRange(model->getBatchLodCount() - 1).first, model->getMainRange(100).first);
+    model.reset();
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+}
+
+TEST(ControllerModelTest, AtlasHoldsEveryBitmap) {
+    REQUIRE_GL();
+    WVR_Stub_Reset();
+    ControllerModelData data;
+    ASSERT_TRUE(fromStub(data));
+    std::shared_ptr<ControllerModel> model = ControllerModel::create(data);
+    ASSERT_TRUE(model->getAtlas() != NULL);
+    ASSERT_EQ(data.batteryBitmaps.size(), model->getBatteryLevelCount());
+
+    std::vector<AtlasPacker::Region> regions;
+    for (uint32_t i = 0; i < model->getTextureCount(); i++)
+        regions.push_back(model->getTextureRegion(i));
+    for (uint32_t lv = 0; lv < model->getBatteryLevelCount(); lv++)
+        regions.push_back(model->getBatteryRegion(lv));
+    for (size_t i = 0; i < regions.size(); i++) {
+        const AtlasPacker::Region& a = regions[i];
+        ASSERT_NE(AtlasPacker::kNoPage, a.page);
+        EXPECT_GT(a.width, 0.0f);
+        EXPECT_LE(a.u + a.width, 1.0f);
+        EXPECT_LE(a.v + a.height, 1.0f);
+        for (size_t j = 0; j < i; j++) {
+            const AtlasPacker::Region& b = regions[j];
+            const bool apart = a.page != b.page || a.u >= b.u + b.width || b.u >= a.u + a.width ||
+                a.v >= b.v + b.height || b.v >= a.v + a.height;
+            EXPECT_TRUE(apart) << i << " overlaps " << j;
+        }
+    }
+    model.reset();
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+}
+
+// A 256 texel bitmap fills most of its page.  The rest should widen that
+// page rather than open a second layer of the same size.
+TEST(ControllerModelTest, AtlasGrowsAPageBeforeOpeningAnother) {
+    REQUIRE_GL();
+    WVR_Stub_Reset();
+    ControllerModelData data;
+    ASSERT_TRUE(fromStub(data));
+    ControllerModelData::Bitmap large = { 256, 256, std::vector<uint8_t>(256 * 256 * 4, 0x80) };
+    ControllerModelData::Bitmap medium = { 130, 130, std::vector<uint8_t>(130 * 130 * 4, 0x40) };
+    data.bitmaps.assign(1, large);
+    data.bitmaps.push_back(medium);
+    for (size_t lv = 0; lv < data.batteryBitmaps.size(); lv++) {
+        ControllerModelData::Bitmap level = { 16, 16, std::vector<uint8_t>(16 * 16 * 4, 0xFF) };
+        data.batteryBitmaps[lv] = level;
+    }
+    std::shared_ptr<ControllerModel> model = ControllerModel::create(data);
+    Texture * atlas = model->getAtlas();
+    ASSERT_TRUE(atlas != NULL);
+    for (uint32_t i = 0; i < model->getTextureCount(); i++)
+        EXPECT_EQ(0u, model->getTextureRegion(i).page) << i;
+    for (uint32_t lv = 0; lv < model->getBatteryLevelCount(); lv++)
+        EXPECT_EQ(0u, model->getBatteryRegion(lv).page) << lv;
+    // Against two layers just big enough for the large bitmap, 272x272.
+    EXPECT_LT(atlas->getWidth() * atlas->getHeight(), 2u * 272 * 272);
+    model.reset();
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+}
+
+// Pressing a button used to add a draw and a program bind per eye.
+TEST(ControllerModelTest, ControllerDrawsInOneCall) {
+    REQUIRE_GL();
+    WVR_Stub_Reset();
+    const int kSize = 64;
+    GLuint color = 0;
+    glGenTextures(1, &color);
+    glBindTexture(GL_TEXTURE_2D, color);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, kSize, kSize);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    FrameBufferObject fbo(color, kSize, kSize);
+    ASSERT_FALSE(fbo.hasError());
+
+    Matrix4 projs[CtrlerDrawMode_MaxModeMumber];
+    Matrix4 eyes[CtrlerDrawMode_MaxModeMumber];
+    const float n = 0.01f, f = 10.0f;
+    projs[0].set(1, 0, 0, 0,
+                 0, 1, 0, 0,
+                 0, 0, -(f + n) / (f - n), -1,
+                 0, 0, -2 * f * n / (f - n), 0);
+    // The controller sits at its fixed shift of (1, 1.5, 2), look at it from above.
+    Matrix4 view;
+    view.translate(-1, -1.6f, -2).rotateX(90);
+    Matrix4 pose;
+
+    Controller controller(WVR_DeviceType_Controller_Right);
+    controller.loadControllerModelAsync();
+    // Count effect colored pixels, (1, 0.5, 0.5) by default.  Body texels
+    // from the atlas are the stub's bluish grey checker.
+    uint32_t textured = 0;
+    auto render = [&](uint32_t &draws) {
+        fbo.bindFrameBuffer();
+        fbo.glViewportFull();
+        glClearColor(0, 0, 0, 1);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        const uint32_t before = RenderStats::getDrawCalls();
+        controller.render(CtrlerDrawMode_General, projs, eyes, view, pose);
+        draws = RenderStats::getDrawCalls() - before;
+        std::vector<uint8_t> pixels(kSize * kSize * 4);
+        glReadPixels(0, 0, kSize, kSize, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        fbo.unbindFrameBuffer();
+        uint32_t effect = 0;
+        textured = 0;
+        for (size_t i = 0; i < pixels.size(); i += 4) {
+            if (pixels[i] > 200 && pixels[i + 1] > 100 && pixels[i + 1] < 155)
+                effect++;
+            if (pixels[i] > 0x40 && pixels[i] == pixels[i + 1] && pixels[i + 2] > pixels[i])
+                textured++;
+        }
+        return effect;
+    };
+
+    uint32_t draws = 0, idle = 0;
+    for (uint32_t i = 0; i < 100 && draws == 0; i++) {
+        idle = render(draws);
+        if (draws == 0)
+            usleep(10000);
+    }
+    // The battery level is read a second after start, so only the main draw.
+    ASSERT_EQ(1u, draws);
+    EXPECT_GT(textured, 0u);
+
+    WVR_Event_t event;
+    memset(&event, 0, sizeof(event));
+    event.input.device.common.type = WVR_EventType_ButtonPressed;
+    event.input.device.deviceType = WVR_DeviceType_Controller_Right;
+    event.input.inputId = WVR_InputId_Alias1_Menu;
+    controller.refreshButtonStatus(event);
+    event.input.inputId = WVR_InputId_Alias1_Touchpad;
+    controller.refreshButtonStatus(event);
+    const uint32_t pressed = render(draws);
+    EXPECT_EQ(1u, draws);
+    EXPECT_GT(pressed, idle);
+
+    // The single sided touchpad dot gets its own unculled draw, the rest
+    // of the batch stays culled.
+    event.input.device.common.type = WVR_EventType_ButtonUnpressed;
+    controller.refreshButtonStatus(event);
+    glDisable(GL_CULL_FACE);
+    render(draws);
+    EXPECT_EQ(1u, draws);
+    glEnable(GL_CULL_FACE);
+    render(draws);
+    EXPECT_GT(draws, 1u);
+    EXPECT_LE(draws, 3u);
+    EXPECT_TRUE(glIsEnabled(GL_CULL_FACE));
+    glDisable(GL_CULL_FACE);
+
+    glDeleteTextures(1, &color);
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+}
@@ -0,0 +1,117 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+
+
+#include <stdlib.h>
+#include <vector>
+
+#include <FrameBufferObject.h>
+#include <Floor.h>
+
+#include "HostTestEnv.h"
+
+// Renders the floor into a small offscreen target from 1.5m above it,
+// looking down -z, so the horizon is the middle row.
+class FloorTest : public ::testing::Test {
+protected:
+    static const int kSize = 64;
+
+    void SetUp() override {
+        REQUIRE_GL();
+        glGenTextures(1, &mColor);
+        glBindTexture(GL_TEXTURE_2D, mColor);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, kSize, kSize);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        mFbo = new FrameBufferObject(mColor, kSize, kSize);
+        ASSERT_FALSE(mFbo->hasError());
+
+        const float n = 0.1f, f = 1000.0f;
+        mProjection.set(1, 0, 0, 0,
+                        0, 1, 0, 0,
+                        0, 0, -(f + n) / (f - n), -1,
+                        0, 0, -2 * f * n / (f - n), 0);
+    }
+
+    void TearDown() override {
+        delete mFbo;
+        if (mColor != 0)
+            glDeleteTextures(1, &mColor);
+    }
+
+    std::vector<uint8_t> render(Floor & floor, float x, float z) {
+        Matrix4 view;
+        view.translate(-x, -1.5f, -z);
+        mFbo->bindFrameBuffer();
+        mFbo->glViewportFull();
+        glEnable(GL_DEPTH_TEST);
+        glDisable(GL_CULL_FACE);
+        glClearColor(0, 0, 0, 1);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        floor.draw(mProjection, Matrix4(), view, Vector4(0, 1, 0, 0));
+        std::vector<uint8_t> pixels(kSize * kSize * 4);
+        glReadPixels(0, 0, kSize, kSize, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        mFbo->unbindFrameBuffer();
+        return pixels;
+    }
+
+    // Pixels of the row that are not the clear color.
+    static uint32_t covered(const std::vector<uint8_t> & pixels, int row) {
+        uint32_t count = 0;
+        for (int x = 0; x < kSize; x++) {
+            const uint8_t * p = &pixels[(row * kSize + x) * 4];
+            count += p[0] + p[1] + p[2] > 0;
+        }
+        return count;
+    }
+
+    GLuint mColor = 0;
+    FrameBufferObject * mFbo = NULL;
+    Matrix4 mProjection;
+};
+
+// The row just under the horizon is about 100m away, past the end of the
+// textured quad.
+TEST_F(FloorTest, ProceduralFloorReachesTheHorizon) {
+    Floor textured(Floor::kTextured);
+    ASSERT_FALSE(textured.hasError());
+    EXPECT_TRUE(textured.hasBounds());
+    std::vector<uint8_t> land = render(textured, 0, 0);
+    EXPECT_EQ((uint32_t) kSize, covered(land, 0));
+    EXPECT_EQ(0u, covered(land, kSize / 2 - 1));
+
+    Floor procedural(Floor::kProcedural);
+    ASSERT_FALSE(procedural.hasError());
+    EXPECT_FALSE(procedural.hasBounds());
+    std::vector<uint8_t> grid = render(procedural, 0, 0);
+    EXPECT_EQ((uint32_t) kSize, covered(grid, 0));
+    EXPECT_EQ((uint32_t) kSize, covered(grid, kSize / 2 - 1));
+    EXPECT_EQ(0u, covered(grid, kSize / 2));
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+}
+
+// The lines are anchored to the floor, so walking a whole major cell gives
+// the same picture, while half a cell does not.
+TEST_F(FloorTest, ProceduralGridStaysInPlace) {
+    Floor procedural(Floor::kProcedural);
+    ASSERT_FALSE(procedural.hasError());
+    std::vector<uint8_t> here = render(procedural, 0.25f, 0.25f);
+    std::vector<uint8_t> cellAway = render(procedural, 10.25f, -19.75f);
+    std::vector<uint8_t> halfAway = render(procedural, 0.75f, 0.25f);
+
+    uint32_t differ = 0, halfDiffer = 0;
+    for (size_t i = 0; i < here.size(); i++) {
+        differ += abs(here[i] - cellAway[i]) > 2;
+        halfDiffer += abs(here[i] - halfAway[i]) > 2;
+    }
+    EXPECT_EQ(0u, differ);
+    EXPECT_GT(halfDiffer, 0u);
+}
@@ -0,0 +1,126 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#include <math.h>
+
+#include <gtest/gtest.h>
+
+#include <Foveation.h>
+
+static const float kBudget = 0.010f;
+
+// Symmetric, 90 degrees both ways.
+static Matrix4 makeProjection() {
+    const float n = 0.1f, f = 100.0f;
+    return Matrix4(1, 0, 0, 0,
+                   0, 1, 0, 0,
+                   0, 0, -(f + n) / (f - n), -1,
+                   0, 0, -2 * f * n / (f - n), 0);
+}
+
+TEST(FoveationTest, OffAndIdleGiveNoParams) {
+    Foveation fov;
+    fov.setBudget(kBudget);
+    Foveation::Params params;
+    EXPECT_FALSE(fov.getParams(makeProjection(), params));
+
+    fov.setMode(Foveation::kFixed);
+    for (int i = 0; i < 20; i++)
+        fov.update(0.3f * kBudget);
+    EXPECT_FALSE(fov.getParams(makeProjection(), params));
+}
+
+TEST(FoveationTest, ForcedUsesThePreset) {
+    Foveation fov;
+    fov.setMode(Foveation::kFixed);
+    fov.setPreset(Foveation::kPresetLow);
+    fov.setForced(true);
+    Foveation::Params params;
+    ASSERT_TRUE(fov.getParams(makeProjection(), params));
+    EXPECT_FLOAT_EQ(0, params.focalX);
+    EXPECT_FLOAT_EQ(0, params.focalY);
+    EXPECT_FLOAT_EQ(30.0f, params.fovealFov);
+    EXPECT_EQ(Foveation::kQualityLow, params.peripheral);
+
+    fov.setPreset(Foveation::kPresetHigh);
+    ASSERT_TRUE(fov.getParams(makeProjection(), params));
+    EXPECT_EQ(Foveation::kQualityHigh, params.peripheral);
+    EXPECT_GT(params.fovealFov, 30.0f);
+}
+
+TEST(FoveationTest, RampsWithLoad) {
+    Foveation fov;
+    fov.setBudget(kBudget);
+    fov.setMode(Foveation::kFixed);
+    for (int i = 0; i < 20; i++)
+        fov.update(1.1f * kBudget);
+    EXPECT_FLOAT_EQ(1.0f, fov.getStrength());
+
+    // Between the thresholds nothing moves.
+    for (int i = 0; i < 40; i++)
+        fov.update(0.75f * kBudget);
+    EXPECT_FLOAT_EQ(1.0f, fov.getStrength());
+
+    // Out slowly.
+    for (int i = 0; i < 30; i++)
+        fov.update(0.4f * kBudget);
+    EXPECT_GT(fov.getStrength(), 0.0f);
+    EXPECT_LT(fov.getStrength(), 1.0f);
+    for (int i = 0; i < 100; i++)
+        fov.update(0.4f * kBudget);
+    EXPECT_FLOAT_EQ(0.0f, fov.getStrength());
+
+    // Partial strength widens the fovea and keeps the periphery higher.
+    for (int i = 0; i < 10; i++)
+        fov.update(1.1f * kBudget);
+    fov.update(0.0f);
+    Foveation::Params params;
+    ASSERT_TRUE(fov.getParams(makeProjection(), params));
+    EXPECT_GE(params.fovealFov, 30.0f);
+}
+
+TEST(FoveationTest, FocusFollowsDirection) {
+    const Matrix4 projection = makeProjection();
+    float x, y;
+    Foveation::directionToNdc(projection, Vector3(0, 0, -1), x, y);
+    EXPECT_NEAR(0, x, 1e-5f);
+    EXPECT_NEAR(0, y, 1e-5f);
+    Foveation::directionToNdc(projection, Vector3(0.5f, 0.25f, -1), x, y);
+    EXPECT_NEAR(0.5f, x, 1e-5f);
+    EXPECT_NEAR(0.25f, y, 1e-5f);
+    Foveation::directionToNdc(projection, Vector3(3, 0, -1), x, y);
+    EXPECT_FLOAT_EQ(1, x);
+    Foveation::directionToNdc(projection, Vector3(0, 0, 1), x, y);
+    EXPECT_FLOAT_EQ(0, x);
+
+    Foveation fov;
+    fov.setMode(Foveation::kController);
+    fov.setForced(true);
+    fov.setFocusDirection(Vector3(-0.5f, 0, -1));
+    Foveation::Params params;
+    ASSERT_TRUE(fov.getParams(projection, params));
+    EXPECT_NEAR(-0.5f, params.focalX, 1e-5f);
+}
+
+TEST(FoveationTraceTest, ParsesAndLoops) {
+    FoveationTrace trace;
+    EXPECT_FALSE(trace.parse("# empty\n"));
+    ASSERT_TRUE(trace.parse("# t x y z\n0 0 0 -1\n1 1 0 -1\nbad line\n2 0 0 -1"));
+    EXPECT_EQ(3u, trace.getCount());
+    EXPECT_FLOAT_EQ(2.0f, trace.getDuration());
+
+    Vector3 d = trace.sample(0.5f);
+    EXPECT_NEAR(0.5f / sqrtf(1.25f), d.x, 1e-5f);
+    EXPECT_NEAR(1.0f / sqrtf(2.0f), trace.sample(1.0f).x, 1e-5f);
+    // Loops.
+    EXPECT_NEAR(d.x, trace.sample(2.5f).x, 1e-5f);
+    EXPECT_NEAR(0, trace.sample(2.0f).x, 1e-5f);
+}
@@ -0,0 +1,144 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+
+
+#include <atomic>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <FramePipeline.h>
+#include <TripleBuffer.h>
+
+namespace {
+
+// Counts simulations and records the thread they ran on.
+class CountingStage : public FramePipeline::Stage {
+public:
+    CountingStage() : mCount(0) {}
+
+    void simulate() {
+        mThread = std::this_thread::get_id();
+        mCount++;
+    }
+
+    std::atomic<uint32_t> mCount;
+    std::thread::id mThread;
+};
+
+// Each packet is filled with its frame number, so a torn read shows as a mix.
+struct Packet {
+    uint32_t values[64];
+};
+
+}
+
+TEST(TripleBufferTest, ConsumerSeesTheLatestValue) {
+    TripleBuffer<int> buffer;
+    EXPECT_FALSE(buffer.update());
+
+    buffer.getBack() = 1;
+    buffer.publish();
+    buffer.getBack() = 2;
+    buffer.publish();
+    EXPECT_TRUE(buffer.update());
+    EXPECT_EQ(2, buffer.getFront());
+    // Nothing new: the front stays.
+    EXPECT_FALSE(buffer.update());
+    EXPECT_EQ(2, buffer.getFront());
+}
+
+TEST(TripleBufferTest, ValuesAreNeverTorn) {
+    TripleBuffer<Packet> buffer;
+    const uint32_t frames = 20000;
+    std::thread producer([&buffer, frames] {
+        for (uint32_t f = 1; f <= frames; f++) {
+            Packet & packet = buffer.getBack();
+            for (uint32_t i = 0; i < 64; i++)
+                packet.values[i] = f;
+            buffer.publish();
+        }
+    });
+
+    uint32_t last = 0;
+    bool torn = false;
+    while (last < frames && !torn) {
+        if (!buffer.update())
+            continue;
+        const Packet & packet = buffer.getFront();
+        EXPECT_GT(packet.values[0], last);
+        for (uint32_t i = 1; i < 64; i++)
+            torn |= packet.values[i] != packet.values[0];
+        last = packet.values[0];
+    }
+    producer.join();
+    EXPECT_FALSE(torn);
+}
+
+TEST(FramePipelineTest, SerialRunsInsideKick) {
+    CountingStage stage;
+    FramePipeline pipeline;
+    ASSERT_TRUE(pipeline.start(FramePipeline::kSerial, &stage));
+    pipeline.kick();
+    EXPECT_EQ(1u, stage.mCount);
+    EXPECT_EQ(std::this_thread::get_id(), stage.mThread);
+    EXPECT_EQ(0u, pipeline.getPending());
+    pipeline.stop();
+}
+
+TEST(FramePipelineTest, LockstepRunsOnTheWorker) {
+    CountingStage stage;
+    FramePipeline pipeline;
+    ASSERT_TRUE(pipeline.start(FramePipeline::kLockstep, &stage));
+    for (uint32_t i = 0; i < 10; i++) {
+        pipeline.kick();
+        pipeline.wait();
+        EXPECT_EQ(i + 1, stage.mCount);
+        EXPECT_EQ(0u, pipeline.getPending());
+    }
+    EXPECT_NE(std::this_thread::get_id(), stage.mThread);
+    pipeline.stop();
+}
+
+TEST(FramePipelineTest, KickWaitsForThePreviousFrame) {
+    CountingStage stage;
+    FramePipeline pipeline;
+    ASSERT_TRUE(pipeline.start(FramePipeline::kOverlap, &stage));
+    pipeline.kick();
+    pipeline.kick();
+    // The second kick waited for the first.
+    EXPECT_GE(stage.mCount, 1u);
+    EXPECT_EQ(1u, pipeline.getPending());
+    pipeline.wait();
+    EXPECT_EQ(2u, stage.mCount);
+    EXPECT_EQ(0u, pipeline.getPending());
+}
+
+TEST(FramePipelineTest, StopFinishesThePendingFrame) {
+    CountingStage stage;
+    FramePipeline pipeline;
+    ASSERT_TRUE(pipeline.start(FramePipeline::kOverlap, &stage));
+    pipeline.kick();
+    pipeline.stop();
+    EXPECT_EQ(1u, stage.mCount);
+    EXPECT_FALSE(pipeline.isRunning());
+    // Kicking a stopped pipeline does nothing.
+    pipeline.kick();
+    pipeline.wait();
+    EXPECT_EQ(1u, stage.mCount);
+}
+
+TEST(FramePipelineTest, RejectsAMissingStage) {
+    FramePipeline pipeline;
+    EXPECT_FALSE(pipeline.start(FramePipeline::kLockstep, NULL));
+    EXPECT_FALSE(pipeline.isRunning());
+}
@@ -0,0 +1,168 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#include <stdlib.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Frustum.h>
+#include <JobSystem.h>
+
+// glFrustum style projection, 90 degrees wide with the far plane at 100.
+static Matrix4 perspective(float left, float right) {
+    const float n = 0.1f, f = 100.0f, b = -0.1f, t = 0.1f;
+    return Matrix4(2 * n / (right - left), 0, 0, 0,
+                   0, 2 * n / (t - b), 0, 0,
+                   (right + left) / (right - left), (t + b) / (t - b), -(f + n) / (f - n), -1,
+                   0, 0, -2 * f * n / (f - n), 0);
+}
+
+// Eyes 64mm apart looking down -z, with slightly asymmetric projections.
+static void makeEyes(Frustum& left, Frustum& right) {
+    Matrix4 eyeLeft, eyeRight;
+    eyeLeft.translate(0.032f, 0, 0);
+    eyeRight.translate(-0.032f, 0, 0);
+    left.set(perspective(-0.11f, 0.09f) * eyeLeft);
+    right.set(perspective(-0.09f, 0.11f) * eyeRight);
+}
+
+static AABB boxAt(float x, float y, float z, float half) {
+    return AABB(Vector3(x - half, y - half, z - half), Vector3(x + half, y + half, z + half));
+}
+
+TEST(FrustumTest, PlanesAndCorners) {
+    Frustum f;
+    f.set(perspective(-0.1f, 0.1f));
+    EXPECT_TRUE(f.intersects(boxAt(0, 0, -5, 0.1f)));
+    EXPECT_FALSE(f.intersects(boxAt(0, 0, 5, 0.1f)));
+    EXPECT_FALSE(f.intersects(boxAt(10, 0, -5, 0.1f)));
+    EXPECT_FALSE(f.intersects(boxAt(0, 0, -200, 1)));
+    // Straddling the left plane still counts.
+    EXPECT_TRUE(f.intersects(boxAt(-5, 0, -5, 0.5f)));
+
+    for (int c = 0; c < 8; c++) {
+        for (int p = 0; p < Frustum::kPlaneCount; p++)
+            EXPECT_GT(f.getPlane(p).distance(f.getCorner(c)), -1e-2f) << "corner " << c << " plane " << p;
+    }
+}
+
+TEST(FrustumTest, CombinedHoldsBothEyes) {
+    Frustum left, right;
+    makeEyes(left, right);
+    Frustum both = Frustum::combine(left, right);
+
+    srand(3);
+    for (int i = 0; i < 2000; i++) {
+        AABB box = boxAt((rand() % 2000 - 1000) * 0.02f, (rand() % 2000 - 1000) * 0.02f,
+                -(rand() % 2000) * 0.04f, 0.05f);
+        if (left.intersects(box) || right.intersects(box)) {
+            EXPECT_TRUE(both.intersects(box)) << i;
+        }
+    }
+    EXPECT_FALSE(both.intersects(boxAt(0, 0, 1, 0.1f)));
+    EXPECT_FALSE(both.intersects(boxAt(30, 0, -5, 0.1f)));
+}
+
+TEST(FrustumTest, WidenedHoldsTurnedViews) {
+    const Matrix4 projection = perspective(-0.11f, 0.09f);
+    const float turn = 0.1f;    // radians
+    Frustum padded;
+    padded.set(Frustum::widen(projection, turn));
+    EXPECT_FALSE(padded.intersects(boxAt(30, 0, -5, 0.1f)));
+    Frustum same;
+    same.set(Frustum::widen(projection, 0));
+    EXPECT_FALSE(same.intersects(boxAt(-6, 0, -5, 0.1f)));
+    EXPECT_TRUE(padded.intersects(boxAt(-6, 0, -5, 0.1f)));
+
+    const Vector3 axes[] = { Vector3(0, 1, 0), Vector3(1, 0, 0), Vector3(0, 0, 1), Vector3(1, 1, 0.3f).normalize() };
+    srand(11);
+    for (size_t a = 0; a < sizeof(axes) / sizeof(axes[0]); a++) {
+        for (int sign = -1; sign <= 1; sign += 2) {
+            Matrix4 view;
+            view.rotate(sign * turn * 180 / 3.14159265f, axes[a]);
+            Frustum turned;
+            turned.set(projection * view);
+            for (int i = 0; i < 2000; i++) {
+                AABB box = boxAt((rand() % 2000 - 1000) * 0.04f, (rand() % 2000 - 1000) * 0.04f,
+                        -(rand() % 2000) * 0.04f, 0.05f);
+                if (turned.intersects(box)) {
+                    ASSERT_TRUE(padded.intersects(box)) << "axis " << a << " sign " << sign << " box " << i;
+                }
+            }
+        }
+    }
+}
+
+TEST(FrustumTest, CullerMatchesPerEyeTests) {
+    Frustum left, right;
+    makeEyes(left, right);
+
+    FrustumCuller culler;
+    std::vector<AABB> boxes;
+    srand(5);
+    // Not a multiple of four, so the last packet is partial.
+    for (int i = 0; i < 1003; i++) {
+        boxes.push_back(boxAt((rand() % 2000 - 1000) * 0.02f, (rand() % 2000 - 1000) * 0.02f,
+                (rand() % 2000 - 1500) * 0.04f, (rand() % 100) * 0.01f));
+        EXPECT_EQ((uint32_t) i, culler.add(boxes.back()));
+    }
+
+    uint32_t expected = 0;
+    uint32_t visible = culler.cull(left, right);
+    for (size_t i = 0; i < boxes.size(); i++) {
+        uint8_t eyes = (left.intersects(boxes[i]) ? FrustumCuller::kLeftEye : 0) |
+                (right.intersects(boxes[i]) ? FrustumCuller::kRightEye : 0);
+        EXPECT_EQ(eyes, culler.getVisibility((uint32_t) i)) << i;
+        if (eyes)
+            expected++;
+    }
+    EXPECT_EQ(expected, visible);
+    EXPECT_GT(visible, 0u);
+    EXPECT_LT(visible, (uint32_t) boxes.size());
+}
+
+TEST(FrustumTest, CullerWithJobsMatchesSerial) {
+    Frustum left, right;
+    makeEyes(left, right);
+
+    FrustumCuller culler;
+    srand(9);
+    // Several chunks of kJobGrain and a partial packet.
+    const uint32_t count = FrustumCuller::kJobGrain * 3 + 7;
+    for (uint32_t i = 0; i < count; i++)
+        culler.add(boxAt((rand() % 2000 - 1000) * 0.02f, (rand() % 2000 - 1000) * 0.02f,
+                (rand() % 2000 - 1500) * 0.04f, (rand() % 100) * 0.01f));
+
+    const uint32_t visible = culler.cull(left, right);
+    std::vector<uint8_t> expected(count);
+    for (uint32_t i = 0; i < count; i++)
+        expected[i] = culler.getVisibility(i);
+
+    JobSystem jobs(3);
+    EXPECT_EQ(visible, culler.cull(left, right, &jobs));
+    for (uint32_t i = 0; i < count; i++)
+        ASSERT_EQ(expected[i], culler.getVisibility(i)) << i;
+}
+
+TEST(FrustumTest, OneEyeOnly) {
+    Frustum left, right;
+    makeEyes(left, right);
+
+    // Near and off to one side, where the eyes' views differ.
+    FrustumCuller culler;
+    uint32_t leftOnly = culler.add(boxAt(-0.165f, 0, -0.15f, 0.005f));
+    uint32_t rightOnly = culler.add(boxAt(0.165f, 0, -0.15f, 0.005f));
+    EXPECT_EQ(2u, culler.cull(left, right));
+    EXPECT_EQ(FrustumCuller::kLeftEye, culler.getVisibility(leftOnly));
+    EXPECT_EQ(FrustumCuller::kRightEye, culler.getVisibility(rightOnly));
+    EXPECT_TRUE(culler.isVisible(FrustumCuller::kAlwaysVisible, FrustumCuller::kLeftEye));
+}
@@ -0,0 +1,34 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <Context.h>
+#include <HostEglContext.h>
+
+// Shared by all test files.  One GLES context and one Context for the whole
+// run, matching what JNI_OnLoad and the WVR runtime provide on the device.
+class HostTestEnv : public ::testing::Environment {
+public:
+    void SetUp() override;
+    void TearDown() override;
+
+    static bool hasGL();
+
+private:
+    HostEglContext mEgl;
+    Context * mContext = NULL;
+};
+
+// Skips the current test when no GLES 3 context could be created.
+#define REQUIRE_GL() \
+    do { if (!HostTestEnv::hasGL()) GTEST_SKIP() << "no GLES 3 context"; } while (0)
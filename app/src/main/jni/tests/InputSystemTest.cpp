@@ -0,0 +1,190 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <InputSystem.h>
+
+namespace {
+
+const uint32_t kRight = 2;
+const uint32_t kTouchpad = 16;
+const uint32_t kTrigger = 31;
+const uint32_t kMenu = 1;
+
+// Counts calls and answers with the input number, so slots are checked too.
+struct AxisCounter {
+    AxisCounter() : calls(0) {}
+    uint32_t calls;
+};
+
+void countingReader(void * data, uint32_t device, uint32_t input, float& x, float& y) {
+    AxisCounter * counter = (AxisCounter *) data;
+    counter->calls++;
+    x = (float) input;
+    y = (float) device;
+}
+
+}
+
+TEST(InputSystemTest, EdgesLastOneSnapshot) {
+    InputSystem input;
+    input.onButton(kRight, kMenu, true);
+    input.publish();
+    const InputSystem::Snapshot& first = input.acquire();
+    EXPECT_TRUE(first.devices[kRight].isPressed(kMenu));
+    EXPECT_TRUE(first.devices[kRight].wentDown(kMenu));
+    EXPECT_EQ(1u << kRight, first.connected);
+
+    input.publish();
+    const InputSystem::Snapshot& second = input.acquire();
+    EXPECT_TRUE(second.devices[kRight].isPressed(kMenu));
+    EXPECT_FALSE(second.devices[kRight].wentDown(kMenu));
+    EXPECT_EQ(first.frameIndex + 1, second.frameIndex);
+
+    // A click inside one frame still shows both edges, and no level.
+    input.onButton(kRight, kTrigger, true);
+    input.onButton(kRight, kTrigger, false);
+    input.onButton(kRight, kMenu, false);
+    input.publish();
+    const InputSystem::Snapshot& third = input.acquire();
+    EXPECT_TRUE(third.devices[kRight].wentDown(kTrigger));
+    EXPECT_TRUE(third.devices[kRight].wentUp(kTrigger));
+    EXPECT_FALSE(third.devices[kRight].isPressed(kTrigger));
+    EXPECT_TRUE(third.devices[kRight].wentUp(kMenu));
+}
+
+TEST(InputSystemTest, DisconnectReleasesEverything) {
+    InputSystem input;
+    input.onButton(kRight, kTrigger, true);
+    input.onTouch(kRight, kTouchpad, true);
+    input.publish();
+    input.onConnect(kRight, false);
+    input.publish();
+    const InputSystem::Snapshot& snapshot = input.acquire();
+    EXPECT_EQ(0u, snapshot.connected);
+    EXPECT_EQ(0u, snapshot.devices[kRight].pressed);
+    EXPECT_EQ(0u, snapshot.devices[kRight].touched);
+    EXPECT_TRUE(snapshot.devices[kRight].wentUp(kTrigger));
+    EXPECT_EQ(1u << kTouchpad, snapshot.devices[kRight].untouchedEdges);
+}
+
+TEST(InputSystemTest, OutOfRangeIsIgnored) {
+    InputSystem input;
+    input.onButton(InputSystem::kMaxDevices, kMenu, true);
+    input.onButton(kRight, InputSystem::kMaxInputs, true);
+    input.publish();
+    const InputSystem::Snapshot& snapshot = input.acquire();
+    EXPECT_EQ(0u, snapshot.connected);
+    EXPECT_EQ(0u, snapshot.devices[kRight].pressed);
+}
+
+TEST(InputSystemTest, AxesArePolledOnlyWhileTouched) {
+    InputSystem input;
+    AxisCounter counter;
+    input.setAxisInputs((1u << kTouchpad) | (1u << kTrigger));
+    input.setAxisReader(countingReader, &counter);
+
+    for (int i = 0; i < 10; i++)
+        input.publish();
+    EXPECT_EQ(0u, counter.calls);
+
+    input.onTouch(kRight, kTouchpad, true);
+    input.publish();
+    input.publish();
+    EXPECT_EQ(2u, counter.calls);
+    InputSystem::Axis axis;
+    ASSERT_TRUE(input.getAxis(kRight, kTouchpad, axis));
+    EXPECT_EQ((float) kTouchpad, axis.x);
+    EXPECT_EQ((float) kRight, axis.y);
+    EXPECT_FALSE(input.getAxis(kRight, kTrigger, axis));
+    EXPECT_EQ((float) kTouchpad, input.acquire().devices[kRight].axes[0].x);
+
+    // Touching an input without an axis costs nothing either.
+    input.onTouch(kRight, kTouchpad, false);
+    input.onTouch(kRight, kMenu, true);
+    input.publish();
+    EXPECT_EQ(2u, counter.calls);
+    EXPECT_FALSE(input.getAxis(kRight, kTouchpad, axis));
+}
+
+TEST(InputSystemTest, SnapshotsCrossThreadsWhole) {
+    InputSystem input;
+    const uint32_t frames = 2000;
+    std::thread consumer([&input, frames]() {
+        uint32_t last = 0;
+        while (last + 1 < frames) {
+            const InputSystem::Snapshot& snapshot = input.acquire();
+            // The trigger is down on odd frames, and only then.
+            const bool odd = (snapshot.frameIndex & 1) != 0;
+            EXPECT_EQ(odd, snapshot.devices[kRight].isPressed(kTrigger));
+            EXPECT_GE(snapshot.frameIndex, last);
+            last = snapshot.frameIndex;
+        }
+    });
+    for (uint32_t i = 0; i < frames; i++) {
+        input.onButton(kRight, kTrigger, (i & 1) != 0);
+        input.publish();
+    }
+    consumer.join();
+}
+
+TEST(InputSystemTest, ReplayReproducesTheRecording) {
+    InputTrace trace;
+    std::vector<InputSystem::Snapshot> recorded;
+    {
+        InputSystem input;
+        AxisCounter counter;
+        input.setAxisInputs(1u << kTouchpad);
+        input.setAxisReader(countingReader, &counter);
+        input.setRecording(&trace);
+        for (uint32_t i = 0; i < 12; i++) {
+            if (i == 2)
+                input.onConnect(kRight, true);
+            if (i == 3)
+                input.onTouch(kRight, kTouchpad, true);
+            if (i == 5)
+                input.onButton(kRight, kTouchpad, true);
+            if (i == 6)
+                input.onButton(kRight, kTouchpad, false);
+            if (i == 8)
+                input.onTouch(kRight, kTouchpad, false);
+            input.publish();
+            recorded.push_back(input.acquire());
+        }
+        EXPECT_EQ(5u, counter.calls);
+    }
+
+    // Through text, as it would go through a file.
+    std::string text;
+    trace.write(text);
+    InputTrace parsed;
+    ASSERT_TRUE(parsed.parse(text.c_str()));
+    EXPECT_EQ(trace.getCount(), parsed.getCount());
+
+    InputSystem replay;
+    AxisCounter counter;
+    replay.setAxisInputs(1u << kTouchpad);
+    replay.setAxisReader(countingReader, &counter);
+    replay.setReplay(&parsed);
+    for (uint32_t i = 0; i < recorded.size(); i++) {
+        // Live input is ignored while replaying.
+        replay.onButton(kRight, kMenu, true);
+        replay.publish();
+        const InputSystem::Snapshot& snapshot = replay.acquire();
+        EXPECT_EQ(0, memcmp(&recorded[i], &snapshot, sizeof(snapshot))) << "frame " << i;
+    }
+    EXPECT_EQ(0u, counter.calls);
+}
@@ -0,0 +1,181 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <JobSystem.h>
+
+TEST(JobSystemTest, DefaultPoolHasAWorker) {
+    EXPECT_GE(JobSystem::getDefaultWorkerCount(), 1u);
+    EXPECT_GE(JobSystem::getInstance().getWorkerCount(), 1u);
+}
+
+TEST(JobSystemTest, ParallelForCoversEveryIndexOnce) {
+    JobSystem jobs(3);
+    const uint32_t count = 10007;
+    std::vector<std::atomic<uint32_t> > hits(count);
+    for (uint32_t i = 0; i < count; i++)
+        hits[i] = 0;
+    jobs.parallelFor(count, 64, [&hits](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
+            hits[i]++;
+    });
+    for (uint32_t i = 0; i < count; i++)
+        ASSERT_EQ(1u, hits[i].load()) << i;
+
+    // Less than one chunk runs inline.
+    uint32_t calls = 0;
+    jobs.parallelFor(10, 64, [&calls](uint32_t begin, uint32_t end) {
+        EXPECT_EQ(0u, begin);
+        EXPECT_EQ(10u, end);
+        calls++;
+    });
+    EXPECT_EQ(1u, calls);
+}
+
+TEST(JobSystemTest, NestedParallelForDoesNotDeadlock) {
+    // One worker, so the inner loops only finish because waiters help.
+    JobSystem jobs(1);
+    std::atomic<uint32_t> total(0);
+    jobs.parallelFor(8, 1, [&](uint32_t, uint32_t) {
+        jobs.parallelFor(100, 10, [&](uint32_t begin, uint32_t end) {
+            total += end - begin;
+        });
+    });
+    EXPECT_EQ(800u, total.load());
+}
+
+TEST(JobSystemTest, CounterTracksTasks) {
+    JobSystem jobs(2);
+    JobSystem::Counter counter;
+    EXPECT_TRUE(counter.isDone());
+    std::atomic<uint32_t> ran(0);
+    for (int i = 0; i < 50; i++)
+        jobs.run([&ran] { ran++; }, &counter);
+    jobs.wait(counter);
+    EXPECT_TRUE(counter.isDone());
+    EXPECT_EQ(50u, ran.load());
+}
+
+TEST(JobSystemTest, DependentJobsRunAfterTheirDependency) {
+    JobSystem jobs(3);
+    JobSystem::Counter first, second;
+    std::atomic<uint32_t> firstDone(0);
+    std::atomic<uint32_t> sawFirst(0);
+    for (int i = 0; i < 20; i++) {
+        jobs.run([&firstDone] {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            firstDone++;
+        }, &first);
+    }
+    for (int i = 0; i < 5; i++)
+        jobs.run([&] { sawFirst += firstDone.load(); }, &second, &first);
+    jobs.wait(second);
+    EXPECT_EQ(20u * 5, sawFirst.load());
+    // Already done: a dependent job is queued straight away.
+    JobSystem::Counter third;
+    jobs.run([&sawFirst] { sawFirst++; }, &third, &first);
+    jobs.wait(third);
+    EXPECT_EQ(20u * 5 + 1, sawFirst.load());
+}
+
+TEST(JobSystemTest, DestructorRunsQueuedJobs) {
+    std::atomic<uint32_t> ran(0);
+    {
+        JobSystem jobs(2);
+        for (int i = 0; i < 100; i++)
+            jobs.run([&ran] { ran++; });
+    }
+    EXPECT_EQ(100u, ran.load());
+}
+
+TEST(JobSystemTest, WaitLeavesBackgroundJobsToWorkers) {
+    JobSystem jobs(1);
+    // Keep the only worker busy, so the long job stays queued.
+    std::atomic<bool> started(false), release(false);
+    JobSystem::Counter gate;
+    jobs.run([&] {
+        started = true;
+        while (!release)
+            std::this_thread::yield();
+    }, &gate);
+    while (!started)
+        std::this_thread::yield();
+
+    std::atomic<bool> longRan(false);
+    std::thread::id longThread;
+    JobSystem::Counter load;
+    jobs.runBackground([&] {
+        longThread = std::this_thread::get_id();
+        longRan = true;
+    }, &load);
+
+    // A per frame wait on an unrelated counter runs its own jobs only.
+    JobSystem::Counter frame;
+    std::atomic<uint32_t> ran(0);
+    for (int i = 0; i < 8; i++)
+        jobs.run([&ran] { ran++; }, &frame);
+    jobs.wait(frame);
+    EXPECT_EQ(8u, ran.load());
+    EXPECT_FALSE(longRan.load());
+    EXPECT_FALSE(load.isDone());
+
+    release = true;
+    jobs.wait(gate);
+    jobs.wait(load);
+    EXPECT_TRUE(longRan.load());
+    EXPECT_NE(std::this_thread::get_id(), longThread);
+}
+
+TEST(JobSystemTest, BackgroundJobsLeaveAWorkerForShortJobs) {
+    JobSystem jobs(2);
+    std::atomic<bool> release(false);
+    std::atomic<uint32_t> running(0);
+    JobSystem::Counter loads;
+    for (int i = 0; i < 3; i++) {
+        jobs.runBackground([&] {
+            running++;
+            while (!release)
+                std::this_thread::yield();
+        }, &loads);
+    }
+    while (running.load() == 0)
+        std::this_thread::yield();
+
+    // The other worker still takes short jobs while the loads block.
+    std::atomic<bool> shortRan(false);
+    jobs.run([&shortRan] { shortRan = true; });
+    for (int i = 0; i < 2000 && !shortRan; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_TRUE(shortRan.load());
+    EXPECT_EQ(1u, running.load());
+
+    release = true;
+    jobs.wait(loads);
+    EXPECT_EQ(3u, running.load());
+}
+
+TEST(JobSystemTest, DestructorRunsQueuedBackgroundJobs) {
+    std::atomic<uint32_t> ran(0);
+    {
+        JobSystem jobs(3);
+        for (int i = 0; i < 20; i++)
+            jobs.runBackground([&ran] { ran++; });
+    }
+    EXPECT_EQ(20u, ran.load());
+}
@@ -0,0 +1,205 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#include <float.h>
+#include <map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <IndexedMesh.h>
+#include <LodSelector.h>
+#include <Mesh.h>
+#include <MeshGenerator.h>
+#include <MeshSimplifier.h>
+#include <RenderStats.h>
+#include <Sphere.h>
+
+#include "HostTestEnv.h"
+
+static const float kThresholds[2] = {0.25f, 0.08f};
+
+TEST(LodSelectorTest, PicksLevelBySize) {
+    LodSelector lod;
+    lod.setThresholds(kThresholds, 3);
+    lod.setHysteresis(0);
+    EXPECT_EQ(0u, lod.select(1.0f));
+    EXPECT_EQ(1u, lod.select(0.2f));
+    EXPECT_EQ(2u, lod.select(0.01f));
+    EXPECT_EQ(0u, lod.select(0.25f));
+}
+
+TEST(LodSelectorTest, HysteresisStopsPopping) {
+    LodSelector lod;
+    lod.setThresholds(kThresholds, 3);
+    lod.setHysteresis(0.1f);
+    EXPECT_EQ(0u, lod.select(0.3f));
+    // Wobbling around 0.25 stays put until well past it either way.
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(0u, lod.select(i & 1 ? 0.24f : 0.26f));
+    }
+    EXPECT_EQ(1u, lod.select(0.2f));
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(1u, lod.select(i & 1 ? 0.24f : 0.26f));
+    }
+    EXPECT_EQ(0u, lod.select(0.28f));
+}
+
+TEST(LodSelectorTest, ProjectedSize) {
+    Matrix4 projection;
+    projection[5] = 2.0f;
+    Matrix4 modelview;
+    modelview.translate(0, 0, -10);
+    EXPECT_FLOAT_EQ(0.2f, LodSelector::projectedSize(modelview, projection, Vector3(0, 0, 0), 1.0f));
+    // A local offset and a scale both count.
+    EXPECT_FLOAT_EQ(0.2f / 0.8f, LodSelector::projectedSize(modelview, projection, Vector3(0, 0, 2), 1.0f));
+    Matrix4 scaled;
+    scaled.scale(3.0f);
+    scaled.translate(0, 0, -10);
+    EXPECT_FLOAT_EQ(0.6f, LodSelector::projectedSize(scaled, projection, Vector3(0, 0, 0), 1.0f));
+    // Inside the sphere.
+    EXPECT_EQ(FLT_MAX, LodSelector::projectedSize(modelview, projection, Vector3(0, 0, 0), 20.0f));
+}
+
+// Each edge is used once in each direction: no holes, no flipped faces.
+static bool isClosed(const std::vector<uint32_t>& indices) {
+    std::map<std::pair<uint32_t, uint32_t>, int> edges;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        for (int k = 0; k < 3; k++)
+            edges[std::make_pair(indices[i + k], indices[i + (k + 1) % 3])]++;
+    }
+    for (auto e = edges.begin(); e != edges.end(); e++) {
+        if (e->second != 1 || edges.count(std::make_pair(e->first.second, e->first.first)) != 1)
+            return false;
+    }
+    return true;
+}
+
+TEST(MeshSimplifierTest, HalvesAClosedMesh) {
+    MeshData mesh;
+    MeshGenerator::icosphere(1.0f, 3, mesh);
+    const uint32_t full = (uint32_t) mesh.indices.size();
+    std::vector<uint32_t> out;
+    uint32_t got = MeshSimplifier::simplify(mesh.vertices.data(), MeshData::kStride, mesh.getVertexCount(),
+            mesh.indices.data(), full, full / 2, out);
+    EXPECT_EQ(got, out.size());
+    EXPECT_LE(got, full / 2);
+    EXPECT_GT(got, full / 3);
+    EXPECT_TRUE(isClosed(out));
+
+    // Still facing out: the output only indexes points on the sphere.
+    for (size_t i = 0; i < out.size(); i += 3) {
+        const float * a = &mesh.vertices[out[i] * MeshData::kStride];
+        const float * b = &mesh.vertices[out[i + 1] * MeshData::kStride];
+        const float * c = &mesh.vertices[out[i + 2] * MeshData::kStride];
+        Vector3 pa(a[0], a[1], a[2]), pb(b[0], b[1], b[2]), pc(c[0], c[1], c[2]);
+        ASSERT_GT((pb - pa).cross(pc - pa).dot(pa + pb + pc), 0.0f) << i / 3;
+    }
+}
+
+TEST(MeshSimplifierTest, KeepsOutlinesAndSeams) {
+    MeshData mesh;
+    MeshGenerator::plane(2.0f, 2.0f, 8, 8, mesh);
+    std::vector<uint32_t> out;
+    MeshSimplifier::simplify(mesh.vertices.data(), MeshData::kStride, mesh.getVertexCount(),
+            mesh.indices.data(), (uint32_t) mesh.indices.size(), 0, out);
+    EXPECT_LT(out.size(), mesh.indices.size() / 2);
+
+    // Every outline vertex is still used, so the outline did not move.
+    std::vector<bool> used(mesh.getVertexCount(), false);
+    for (size_t i = 0; i < out.size(); i++)
+        used[out[i]] = true;
+    for (uint32_t v = 0; v < mesh.getVertexCount(); v++) {
+        const uint32_t i = v % 9, j = v / 9;
+        if (i == 0 || i == 8 || j == 0 || j == 8) {
+            EXPECT_TRUE(used[v]) << v;
+        }
+    }
+
+    // The UV sphere's seam column is split, so it stays.
+    MeshGenerator::uvSphere(1.0f, 24, 12, mesh);
+    MeshSimplifier::simplify(mesh.vertices.data(), MeshData::kStride, mesh.getVertexCount(),
+            mesh.indices.data(), (uint32_t) mesh.indices.size(), (uint32_t) mesh.indices.size() / 4, out);
+    used.assign(mesh.getVertexCount(), false);
+    for (size_t i = 0; i < out.size(); i++)
+        used[out[i]] = true;
+    for (uint32_t j = 1; j < 12; j++) {
+        EXPECT_TRUE(used[j * 25]);
+        EXPECT_TRUE(used[j * 25 + 24]);
+    }
+}
+
+TEST(LodTest, MeshCarriesSimplifiedLevels) {
+    REQUIRE_GL();
+    MeshData data;
+    MeshGenerator::icosphere(1.0f, 3, data);
+    std::vector<float> positions;
+    for (uint32_t v = 0; v < data.getVertexCount(); v++)
+        positions.insert(positions.end(), &data.vertices[v * MeshData::kStride], &data.vertices[v * MeshData::kStride] + 3);
+
+    Mesh mesh;
+    mesh.createVertexBufferData(VertexAttrib_Vertices, positions.data(), (uint32_t) positions.size(), 3);
+    mesh.createLodIndexBufferData(data.indices.data(), (uint32_t) data.indices.size(), 3,
+            positions.data(), (uint32_t) positions.size(), 3, 3);
+    mesh.createVAO();
+    ASSERT_EQ(3u, mesh.getLodCount());
+
+    uint32_t last = data.indices.size() / 3 + 1;
+    for (uint32_t level = 0; level < 4; level++) {
+        mesh.setLod(level);
+        EXPECT_LT(mesh.getTriangleCount(), last);
+        last = mesh.getTriangleCount();
+        RenderStats::beginFrame();
+        mesh.draw();
+        EXPECT_EQ(last, RenderStats::getTriangles());
+        EXPECT_EQ(1u, RenderStats::getDrawCalls());
+        if (level == 2)
+            break;
+    }
+    // Past the last level clamps to it.
+    mesh.setLod(7);
+    EXPECT_EQ(last, mesh.getTriangleCount());
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+}
+
+TEST(LodTest, SphereDropsDetailWithDistance) {
+    REQUIRE_GL();
+    Vector3 pos(0, 0, -2);
+    Sphere sphere(pos);
+    ASSERT_FALSE(sphere.hasError());
+    std::shared_ptr<IndexedMesh> mesh = IndexedMesh::getUVSphere(0.8f, 36, 18, 3);
+    ASSERT_EQ(3u, mesh->getLodCount());
+
+    Matrix4 projection;
+    projection[5] = 1.0f;
+    const Vector4 light(0, 0, 1, 0);
+    RenderStats::beginFrame();
+    sphere.draw(projection, Matrix4(), Matrix4(), light);
+    EXPECT_EQ(0u, sphere.getLodLevel());
+    EXPECT_EQ(mesh->getIndexCount(0) / 3, RenderStats::getTriangles());
+
+    Vector3 far(0, 0, -40);
+    sphere.setSpherePos(far);
+    RenderStats::beginFrame();
+    sphere.draw(projection, Matrix4(), Matrix4(), light);
+    EXPECT_EQ(2u, sphere.getLodLevel());
+    EXPECT_EQ(mesh->getIndexCount(2) / 3, RenderStats::getTriangles());
+    EXPECT_LT(RenderStats::getTriangles() * 10, mesh->getIndexCount(0) / 3);
+
+    sphere.setLodEnable(false);
+    RenderStats::beginFrame();
+    sphere.draw(projection, Matrix4(), Matrix4(), light);
+    EXPECT_EQ(mesh->getIndexCount(0) / 3, RenderStats::getTriangles());
+
+    RenderStats::beginFrame();
+    EXPECT_EQ(mesh->getIndexCount(0) / 3, RenderStats::getFrameTriangles());
+    EXPECT_EQ(0u, RenderStats::getTriangles());
+}
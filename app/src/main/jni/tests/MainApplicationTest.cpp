@@ -0,0 +1,320 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#include <string.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/stat.h>
+
+#include <hellovr.h>
+#include <ControllerModel.h>
+#include <wvr/wvr_stub.h>
+
+#include "HostTestEnv.h"
+
+extern bool gScene;
+extern float gScale;
+extern bool gMsaa;
+extern Foveation::Mode gFoveationMode;
+extern bool gFoveationForced;
+extern bool gLateLatch;
+extern FramePipeline::Mode gPipelineMode;
+
+// Drives the real sample through init, a few frames and shutdown, the same
+// sequence as main() in jni.cpp.  Lockstep runs the simulation on its
+// thread but keeps one pose fetch per rendered frame.
+class MainApplicationTest : public ::testing::Test {
+protected:
+    MainApplicationTest() : mPipelineMode(FramePipeline::kLockstep) {}
+
+    void SetUp() override {
+        REQUIRE_GL();
+        WVR_Stub_Reset();
+        gPipelineMode = mPipelineMode;
+        WVR_Stub_SetRenderTargetSize(256, 256);
+        mApp = new MainApplication();
+        ASSERT_TRUE(mApp->initVR());
+        ASSERT_TRUE(mApp->initGL());
+    }
+
+    void TearDown() override {
+        if (mApp != NULL) {
+            mApp->shutdownGL();
+            mApp->shutdownVR();
+            delete mApp;
+        }
+        gPipelineMode = FramePipeline::kOverlap;
+        WVR_Stub_Reset();
+    }
+
+    // Returns false when the sample asked to quit or failed to render.
+    bool frame() {
+        if (mApp->handleInput())
+            return false;
+        if (mApp->renderFrame())
+            return false;
+        return true;
+    }
+
+    FramePipeline::Mode mPipelineMode;
+    MainApplication * mApp = NULL;
+};
+
+class MainApplicationOverlapTest : public MainApplicationTest {
+protected:
+    MainApplicationOverlapTest() {
+        mPipelineMode = FramePipeline::kOverlap;
+    }
+};
+
+TEST_F(MainApplicationTest, RendersAndSubmitsBothEyes) {
+    const uint32_t frames = 5;
+    for (uint32_t i = 0; i < frames; i++)
+        ASSERT_TRUE(frame());
+
+    WVR_StubStats_t stats;
+    WVR_Stub_GetStats(&stats);
+    EXPECT_EQ(frames, stats.submitCount[WVR_Eye_Left]);
+    EXPECT_EQ(frames, stats.submitCount[WVR_Eye_Right]);
+    EXPECT_NE(0u, stats.lastSubmitTexture[WVR_Eye_Left]);
+    EXPECT_NE(stats.lastSubmitTexture[WVR_Eye_Left], stats.lastSubmitTexture[WVR_Eye_Right]);
+    EXPECT_EQ(frames, stats.syncPoseCount);
+    EXPECT_EQ(2u, stats.liveTextureQueues);
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+}
+
+TEST_F(MainApplicationTest, SubmitsTheLateLatchedHeadPose) {
+    ASSERT_TRUE(frame());
+    WVR_StubStats_t stats;
+    WVR_Stub_GetStats(&stats);
+    EXPECT_EQ(1u, stats.syncPoseCount);
+    const int64_t before = WVR_Stub_GetTimeNs();
+    ASSERT_TRUE(frame());
+    WVR_Stub_GetStats(&stats);
+    // One sync fetch per frame; the eyes re-fetch the head after it.
+    EXPECT_EQ(2u, stats.syncPoseCount);
+    EXPECT_GE(stats.lastSubmitPoseTimestamp[WVR_Eye_Left], before);
+    EXPECT_GE(stats.lastSubmitPoseTimestamp[WVR_Eye_Right], stats.lastSubmitPoseTimestamp[WVR_Eye_Left]);
+
+    gLateLatch = false;
+    ASSERT_TRUE(frame());
+    WVR_Stub_GetStats(&stats);
+    gLateLatch = true;
+    // Without the latch both eyes carry the sync pose.
+    EXPECT_NE(0, stats.lastSubmitPoseTimestamp[WVR_Eye_Left]);
+    EXPECT_EQ(stats.lastSubmitPoseTimestamp[WVR_Eye_Left], stats.lastSubmitPoseTimestamp[WVR_Eye_Right]);
+}
+
+TEST_F(MainApplicationTest, QuitEventStopsTheLoop) {
+    ASSERT_TRUE(frame());
+    WVR_Event_t event;
+    memset(&event, 0, sizeof(event));
+    event.common.type = WVR_EventType_Quit;
+    WVR_Stub_PushEvent(&event);
+    EXPECT_TRUE(mApp->handleInput());
+}
+
+TEST_F(MainApplicationTest, ControllersLoadAndUnload) {
+    // Controller models are loaded on a worker thread.  Give it time and keep rendering.
+    for (uint32_t i = 0; i < 20; i++) {
+        ASSERT_TRUE(frame());
+        usleep(10000);
+    }
+
+    WVR_Event_t event;
+    memset(&event, 0, sizeof(event));
+    event.common.type = WVR_EventType_DeviceDisconnected;
+    event.device.deviceType = WVR_DeviceType_Controller_Left;
+    WVR_Stub_SetDeviceConnected(WVR_DeviceType_Controller_Left, false);
+    WVR_Stub_PushEvent(&event);
+    for (uint32_t i = 0; i < 3; i++)
+        ASSERT_TRUE(frame());
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+}
+
+// Buttons come from events.  The runtime is asked only for the axis of a
+// touched touchpad, once per frame.
+TEST_F(MainApplicationTest, InputIsEventDriven) {
+    for (uint32_t i = 0; i < 5; i++)
+        ASSERT_TRUE(frame());
+    WVR_StubStats_t stats;
+    WVR_Stub_GetStats(&stats);
+    EXPECT_EQ(0u, stats.inputQueries);
+
+    WVR_Event_t event;
+    memset(&event, 0, sizeof(event));
+    event.common.type = WVR_EventType_TouchTapped;
+    event.input.device.deviceType = WVR_DeviceType_Controller_Right;
+    event.input.inputId = WVR_InputId_Alias1_Touchpad;
+    WVR_Stub_PushEvent(&event);
+    for (uint32_t i = 0; i < 3; i++)
+        ASSERT_TRUE(frame());
+    WVR_Stub_GetStats(&stats);
+    EXPECT_EQ(3u, stats.inputQueries);
+
+    event.common.type = WVR_EventType_TouchUntapped;
+    WVR_Stub_PushEvent(&event);
+    for (uint32_t i = 0; i < 3; i++)
+        ASSERT_TRUE(frame());
+    WVR_Stub_GetStats(&stats);
+    EXPECT_EQ(3u, stats.inputQueries);
+}
+
+// The first run parses the model and writes the cache file, the next one
+// only reads it.  A file written again would get a new modification time.
+TEST_F(MainApplicationTest, RelaunchLoadsControllersFromDiskCache) {
+    char dir[] = "/tmp/hellovr_cacheXXXXXX";
+    ASSERT_TRUE(mkdtemp(dir) != NULL);
+    ControllerModel::setCacheDirectory(dir);
+    const std::string path = ControllerModel::getCachePath("HostStubController");
+    const struct utimbuf written = { 1, 1 };
+    for (uint32_t run = 0; run < 2; run++) {
+        mApp->shutdownGL();
+        mApp->shutdownVR();
+        delete mApp;
+        EXPECT_FALSE(ControllerModel::isLoaded("HostStubController"));
+        if (run > 0)
+            ASSERT_EQ(0, utime(path.c_str(), &written));
+
+        mApp = new MainApplication();
+        ASSERT_TRUE(mApp->initVR());
+        ASSERT_TRUE(mApp->initGL());
+        for (uint32_t i = 0; i < 50 && !ControllerModel::isLoaded("HostStubController"); i++) {
+            ASSERT_TRUE(frame());
+            usleep(10000);
+        }
+        EXPECT_TRUE(ControllerModel::isLoaded("HostStubController"));
+        EXPECT_EQ(0, access(path.c_str(), R_OK));
+    }
+    struct stat info;
+    ASSERT_EQ(0, stat(path.c_str(), &info));
+    EXPECT_EQ(written.modtime, info.st_mtime);
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+
+    ControllerModel::setCacheDirectory("");
+    unlink(path.c_str());
+    rmdir(dir);
+}
+
+TEST_F(MainApplicationTest, SceneFlagShowsSeaOfCubes) {
+    ASSERT_TRUE(frame());
+    gScene = true;
+    for (uint32_t i = 0; i < 3; i++)
+        ASSERT_TRUE(frame());
+    gScene = false;
+    ASSERT_TRUE(frame());
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+}
+
+// Measured GPU time may lower the scale as well, so only the way down is
+// checked here.  The controller itself is covered in ResolutionControllerTest.
+TEST_F(MainApplicationTest, QualityEventsScaleTheViewport) {
+    ASSERT_TRUE(frame());
+    WVR_Event_t event;
+    memset(&event, 0, sizeof(event));
+    event.common.type = WVR_EventType_RecommendedQuality_Lower;
+    WVR_Stub_PushEvent(&event);
+    ASSERT_TRUE(frame());
+
+    WVR_StubStats_t stats;
+    WVR_Stub_GetStats(&stats);
+    EXPECT_LT(gScale, 1.0f);
+    EXPECT_TRUE(stats.lastSubmitExtend[WVR_Eye_Left] & WVR_SubmitExtend_PartialTexture);
+    EXPECT_FLOAT_EQ(gScale, stats.lastSubmitLayout[WVR_Eye_Left].rightUpUVs.v[0]);
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+}
+
+TEST_F(MainApplicationTest, MsaaToggleRebuildsTargets) {
+    ASSERT_TRUE(frame());
+    gMsaa = false;
+    ASSERT_TRUE(frame());
+    gMsaa = true;
+    ASSERT_TRUE(frame());
+
+    WVR_StubStats_t stats;
+    WVR_Stub_GetStats(&stats);
+    EXPECT_EQ(3u, stats.submitCount[WVR_Eye_Left]);
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+}
+
+TEST_F(MainApplicationTest, FoveationIsARuntimeOption) {
+    ASSERT_TRUE(frame());
+    WVR_StubStats_t stats;
+    WVR_Stub_GetStats(&stats);
+    EXPECT_FALSE(stats.lastPreRenderFoveated[WVR_Eye_Left]);
+
+    gFoveationMode = Foveation::kFixed;
+    gFoveationForced = true;
+    ASSERT_TRUE(frame());
+    ASSERT_TRUE(frame());
+    WVR_Stub_GetStats(&stats);
+    EXPECT_EQ(WVR_FoveationMode_Enable, stats.foveationMode);
+    EXPECT_TRUE(stats.lastPreRenderFoveated[WVR_Eye_Left]);
+    EXPECT_TRUE(stats.lastPreRenderFoveated[WVR_Eye_Right]);
+    EXPECT_EQ(WVR_PeripheralQuality_Low, stats.lastFoveation[WVR_Eye_Left].periQuality);
+
+    gFoveationMode = Foveation::kOff;
+    gFoveationForced = false;
+    ASSERT_TRUE(frame());
+    ASSERT_TRUE(frame());
+    WVR_Stub_GetStats(&stats);
+    EXPECT_EQ(WVR_FoveationMode_Disable, stats.foveationMode);
+    EXPECT_FALSE(stats.lastPreRenderFoveated[WVR_Eye_Left]);
+}
+
+TEST_F(MainApplicationTest, FoveationIsEnabledOnlyWithParams) {
+    // No GPU time is measured before the first frame, so the ramp starts
+    // at 0 and the runtime stays disabled.
+    gFoveationMode = Foveation::kFixed;
+    ASSERT_TRUE(frame());
+    WVR_StubStats_t stats;
+    WVR_Stub_GetStats(&stats);
+    EXPECT_EQ(WVR_FoveationMode_Disable, stats.foveationMode);
+    EXPECT_FALSE(stats.lastPreRenderFoveated[WVR_Eye_Left]);
+
+    // Each frame leaves the mode for the next one.  Enabled without params
+    // would be the runtime's default foveation.
+    for (int i = 0; i < 6; i++) {
+        const bool enabled = stats.foveationMode == WVR_FoveationMode_Enable;
+        gFoveationForced = i == 2;
+        ASSERT_TRUE(frame());
+        WVR_Stub_GetStats(&stats);
+        EXPECT_EQ(enabled, stats.lastPreRenderFoveated[WVR_Eye_Left]) << i;
+        EXPECT_EQ(enabled, stats.lastPreRenderFoveated[WVR_Eye_Right]) << i;
+    }
+    gFoveationMode = Foveation::kOff;
+    gFoveationForced = false;
+}
+
+TEST_F(MainApplicationOverlapTest, SimulatesOneFrameAhead) {
+    const uint32_t frames = 5;
+    for (uint32_t i = 0; i < frames; i++)
+        ASSERT_TRUE(frame());
+
+    WVR_StubStats_t stats;
+    WVR_Stub_GetStats(&stats);
+    EXPECT_EQ(frames, stats.submitCount[WVR_Eye_Left]);
+    EXPECT_EQ(frames, stats.submitCount[WVR_Eye_Right]);
+    // The first frame also kicks the one after it.
+    EXPECT_EQ(frames + 1, stats.syncPoseCount);
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+}
+
+TEST_F(MainApplicationOverlapTest, ShutdownFinishesThePendingFrame) {
+    for (uint32_t i = 0; i < 3; i++)
+        ASSERT_TRUE(frame());
+    mApp->shutdownGL();
+    WVR_StubStats_t stats;
+    WVR_Stub_GetStats(&stats);
+    EXPECT_EQ(4u, stats.syncPoseCount);
+    mApp->shutdownVR();
+    delete mApp;
+    mApp = NULL;
+}
@@ -0,0 +1,181 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#include <math.h>
+#include <map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <FrameBufferObject.h>
+#include <IndexedMesh.h>
+#include <MeshGenerator.h>
+#include <Sphere.h>
+
+#include "HostTestEnv.h"
+
+static Vector3 positionOf(const MeshData& mesh, uint32_t v) {
+    const float * p = &mesh.vertices[v * MeshData::kStride + MeshData::kPositionOffset];
+    return Vector3(p[0], p[1], p[2]);
+}
+
+static Vector3 normalOf(const MeshData& mesh, uint32_t v) {
+    const float * n = &mesh.vertices[v * MeshData::kStride + MeshData::kNormalOffset];
+    return Vector3(n[0], n[1], n[2]);
+}
+
+// Every triangle faces along its vertex normals, counterclockwise from outside.
+static void expectOutwardWinding(const MeshData& mesh) {
+    ASSERT_EQ(0u, mesh.indices.size() % 3);
+    for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+        const uint32_t a = mesh.indices[i], b = mesh.indices[i + 1], c = mesh.indices[i + 2];
+        ASSERT_LT(a, mesh.getVertexCount());
+        ASSERT_LT(b, mesh.getVertexCount());
+        ASSERT_LT(c, mesh.getVertexCount());
+        const Vector3 face = (positionOf(mesh, b) - positionOf(mesh, a)).cross(positionOf(mesh, c) - positionOf(mesh, a));
+        ASSERT_GT(face.length(), 0.0f) << "degenerate triangle " << i / 3;
+        const Vector3 normal = normalOf(mesh, a) + normalOf(mesh, b) + normalOf(mesh, c);
+        ASSERT_GT(face.dot(normal), 0.0f) << "triangle " << i / 3;
+    }
+}
+
+// Each edge is used once in each direction: no holes, no flipped faces.
+static void expectClosed(const MeshData& mesh) {
+    std::map<std::pair<uint32_t, uint32_t>, int> edges;
+    for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+        for (int k = 0; k < 3; k++)
+            edges[std::make_pair(mesh.indices[i + k], mesh.indices[i + (k + 1) % 3])]++;
+    }
+    for (auto e = edges.begin(); e != edges.end(); e++) {
+        ASSERT_EQ(1, e->second);
+        ASSERT_EQ(1u, edges.count(std::make_pair(e->first.second, e->first.first)))
+                << e->first.first << "-" << e->first.second;
+    }
+}
+
+TEST(MeshGeneratorTest, UVSphereIsIndexedOnTheSurface) {
+    MeshData mesh;
+    MeshGenerator::uvSphere(0.8f, 36, 18, mesh);
+    EXPECT_EQ(37u * 19u, mesh.getVertexCount());
+    EXPECT_EQ(36u * 17u * 6u, mesh.indices.size());
+    for (uint32_t v = 0; v < mesh.getVertexCount(); v++) {
+        ASSERT_NEAR(0.8f, positionOf(mesh, v).length(), 1e-5f) << v;
+        ASSERT_NEAR(1.0f, normalOf(mesh, v).length(), 1e-5f) << v;
+    }
+    expectOutwardWinding(mesh);
+
+    // The seam column repeats the first one exactly.
+    for (uint32_t j = 0; j <= 18; j++) {
+        Vector3 first = positionOf(mesh, j * 37), last = positionOf(mesh, j * 37 + 36);
+        EXPECT_EQ(first.x, last.x);
+        EXPECT_EQ(first.y, last.y);
+        EXPECT_EQ(first.z, last.z);
+    }
+
+    AABB bounds = mesh.getBounds();
+    EXPECT_NEAR(-0.8f, bounds.min.y, 1e-6f);
+    EXPECT_NEAR(0.8f, bounds.max.y, 1e-6f);
+}
+
+TEST(MeshGeneratorTest, IcosphereIsClosed) {
+    MeshData mesh;
+    for (uint32_t level = 0; level <= 3; level++) {
+        MeshGenerator::icosphere(1.0f, level, mesh);
+        const uint32_t faces = 20u << (2 * level);
+        EXPECT_EQ(faces * 3, mesh.indices.size());
+        EXPECT_EQ(faces / 2 + 2, mesh.getVertexCount());
+        for (uint32_t v = 0; v < mesh.getVertexCount(); v++)
+            ASSERT_NEAR(1.0f, positionOf(mesh, v).length(), 1e-5f);
+        expectOutwardWinding(mesh);
+        expectClosed(mesh);
+    }
+}
+
+TEST(MeshGeneratorTest, CubeCylinderAndPlane) {
+    MeshData mesh;
+    MeshGenerator::cube(2.0f, mesh);
+    EXPECT_EQ(24u, mesh.getVertexCount());
+    EXPECT_EQ(36u, mesh.indices.size());
+    expectOutwardWinding(mesh);
+    AABB bounds = mesh.getBounds();
+    EXPECT_FLOAT_EQ(-1.0f, bounds.min.x);
+    EXPECT_FLOAT_EQ(1.0f, bounds.max.z);
+
+    MeshGenerator::cylinder(0.5f, 2.0f, 24, mesh);
+    expectOutwardWinding(mesh);
+    bounds = mesh.getBounds();
+    EXPECT_FLOAT_EQ(-1.0f, bounds.min.y);
+    EXPECT_FLOAT_EQ(1.0f, bounds.max.y);
+    EXPECT_NEAR(0.5f, bounds.max.x, 1e-6f);
+
+    MeshGenerator::plane(4.0f, 2.0f, 4, 2, mesh);
+    EXPECT_EQ(15u, mesh.getVertexCount());
+    EXPECT_EQ(4u * 2u * 6u, mesh.indices.size());
+    expectOutwardWinding(mesh);
+}
+
+TEST(IndexedMeshTest, PoolSharesMeshesByParameters) {
+    REQUIRE_GL();
+    std::shared_ptr<IndexedMesh> a = IndexedMesh::getUVSphere(1.0f, 16, 8);
+    std::shared_ptr<IndexedMesh> b = IndexedMesh::getUVSphere(1.0f, 16, 8);
+    std::shared_ptr<IndexedMesh> c = IndexedMesh::getUVSphere(1.0f, 32, 16);
+    EXPECT_EQ(a.get(), b.get());
+    EXPECT_NE(a.get(), c.get());
+    EXPECT_EQ(17u * 9u, a->getVertexCount());
+
+    const uint32_t before = IndexedMesh::getPoolSize();
+    c.reset();
+    EXPECT_EQ(before - 1, IndexedMesh::getPoolSize());
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+}
+
+TEST(IndexedMeshTest, SpheresShareOneMeshAndDraw) {
+    REQUIRE_GL();
+    const int kSize = 32;
+    GLuint color = 0;
+    glGenTextures(1, &color);
+    glBindTexture(GL_TEXTURE_2D, color);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, kSize, kSize);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    FrameBufferObject * fbo = new FrameBufferObject(color, kSize, kSize);
+    ASSERT_FALSE(fbo->hasError());
+
+    const uint32_t before = IndexedMesh::getPoolSize();
+    Vector3 p0(0, 0, -3), p1(2, 0, -3);
+    Sphere s0(p0);
+    Sphere s1(p1);
+    ASSERT_FALSE(s0.hasError());
+    EXPECT_LE(IndexedMesh::getPoolSize(), before + 1);
+
+    const float n = 0.1f, f = 100.0f;
+    Matrix4 projection(1, 0, 0, 0,
+                       0, 1, 0, 0,
+                       0, 0, -(f + n) / (f - n), -1,
+                       0, 0, -2 * f * n / (f - n), 0);
+    fbo->bindFrameBuffer();
+    fbo->glViewportFull();
+    glEnable(GL_DEPTH_TEST);
+    glClearColor(0, 0, 0, 1);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    s0.draw(projection, Matrix4(), Matrix4(), Vector4(0, 0, 1, 0));
+    std::vector<uint8_t> pixels(kSize * kSize * 4);
+    glReadPixels(0, 0, kSize, kSize, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    fbo->unbindFrameBuffer();
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+
+    const uint8_t * center = &pixels[(kSize / 2 * kSize + kSize / 2) * 4];
+    EXPECT_GT(center[1], 0);
+    const uint8_t * corner = &pixels[0];
+    EXPECT_EQ(0, corner[0] + corner[1] + corner[2]);
+
+    delete fbo;
+    glDeleteTextures(1, &color);
+}
@@ -0,0 +1,231 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <BVH.h>
+#include <Picker.h>
+#include <JobSystem.h>
+
+static Matrix4 at(float x, float y, float z) {
+    Matrix4 m;
+    m.translate(x, y, z);
+    return m;
+}
+
+static const Vector3 kForward(0, 0, -1);
+
+TEST(BVHTest, BuildKeepsEveryPrimitiveInOneLeaf) {
+    std::vector<AABB> boxes;
+    std::vector<uint32_t> ids;
+    srand(7);
+    for (uint32_t i = 0; i < 500; i++) {
+        Vector3 c(rand() % 100, rand() % 100, rand() % 100);
+        boxes.push_back(AABB(c - Vector3(0.5f, 0.5f, 0.5f), c + Vector3(0.5f, 0.5f, 0.5f)));
+        ids.push_back(i);
+    }
+    BVH bvh;
+    bvh.build(boxes.data(), ids.data(), (uint32_t) ids.size());
+
+    std::vector<int> seen(ids.size(), 0);
+    const std::vector<BVH::Node>& nodes = bvh.getNodes();
+    for (size_t n = 0; n < nodes.size(); n++) {
+        const BVH::Node& node = nodes[n];
+        if (node.count == 0) {
+            EXPECT_LT((int32_t) n, node.left);
+            EXPECT_TRUE(node.bounds.contains(nodes[node.left].bounds));
+            EXPECT_TRUE(node.bounds.contains(nodes[node.left + 1].bounds));
+            continue;
+        }
+        EXPECT_LE(node.count, BVH::kMaxLeafSize);
+        for (uint32_t i = node.first; i < node.first + node.count; i++) {
+            uint32_t prim = bvh.getPrimitives()[i];
+            seen[prim]++;
+            EXPECT_TRUE(node.bounds.contains(boxes[prim]));
+        }
+    }
+    for (size_t i = 0; i < seen.size(); i++)
+        EXPECT_EQ(1, seen[i]) << "primitive " << i;
+}
+
+TEST(BVHTest, CoincidentCentroidsStillSplit) {
+    std::vector<AABB> boxes(64, AABB(Vector3(0, 0, 0), Vector3(1, 1, 1)));
+    std::vector<uint32_t> ids;
+    for (uint32_t i = 0; i < boxes.size(); i++)
+        ids.push_back(i);
+    BVH bvh;
+    bvh.build(boxes.data(), ids.data(), (uint32_t) ids.size());
+    EXPECT_GT(bvh.getNodes().size(), 1u);
+    EXPECT_EQ(boxes.size(), bvh.getPrimitives().size());
+}
+
+TEST(PickerTest, ClosestHitPicksNearestSphere) {
+    Picker picker;
+    uint32_t farId = picker.addSphere(Vector3(0, 0, 0), 1.0f, at(0, 0, -10));
+    uint32_t nearId = picker.addSphere(Vector3(0, 0, 0), 1.0f, at(0, 0, -5));
+    picker.addSphere(Vector3(0, 0, 0), 1.0f, at(5, 0, -3));
+
+    Picker::Hit hit;
+    ASSERT_TRUE(picker.raycastClosest(Ray(Vector3(0, 0, 0), kForward), FLT_MAX, hit));
+    EXPECT_EQ(nearId, hit.id);
+    EXPECT_NEAR(4.0f, hit.distance, 1e-5f);
+    EXPECT_NEAR(1.0f, hit.normal.z, 1e-5f);
+
+    picker.setEnable(nearId, false);
+    ASSERT_TRUE(picker.raycastClosest(Ray(Vector3(0, 0, 0), kForward), FLT_MAX, hit));
+    EXPECT_EQ(farId, hit.id);
+
+    EXPECT_FALSE(picker.raycastClosest(Ray(Vector3(0, 0, 0), kForward), 5.0f, hit));
+    EXPECT_EQ(Picker::kInvalidId, hit.id);
+}
+
+TEST(PickerTest, RayStartingInsideHitsFarSide) {
+    Picker picker;
+    picker.addSphere(Vector3(0, 0, 0), 2.0f, at(0, 0, 0));
+    Picker::Hit hit;
+    ASSERT_TRUE(picker.raycastClosest(Ray(Vector3(0, 0, 0), kForward), FLT_MAX, hit));
+    EXPECT_NEAR(2.0f, hit.distance, 1e-5f);
+    // Spheres behind the origin are not hit.
+    EXPECT_FALSE(picker.raycastAny(Ray(Vector3(0, 0, 5), Vector3(0, 0, 1)), FLT_MAX));
+}
+
+TEST(PickerTest, MovedTargetIsRefit) {
+    Picker picker;
+    for (int i = 0; i < 100; i++)
+        picker.addSphere(Vector3(0, 0, 0), 0.25f, at((float) i, 10, 0));
+    uint32_t target = picker.addSphere(Vector3(0, 0, 0), 0.25f, at(50, 10, 0));
+    picker.update();
+
+    Ray ray(Vector3(-3, 0, 0), kForward);
+    EXPECT_FALSE(picker.raycastAny(ray, FLT_MAX));
+
+    picker.setTransform(target, at(-3, 0, -6));
+    Picker::Hit hit;
+    ASSERT_TRUE(picker.raycastClosest(ray, FLT_MAX, hit));
+    EXPECT_EQ(target, hit.id);
+    EXPECT_NEAR(5.75f, hit.distance, 1e-5f);
+}
+
+TEST(PickerTest, RemovedIdsAreReused) {
+    Picker picker;
+    uint32_t a = picker.addBox(AABB(Vector3(-1, -1, -1), Vector3(1, 1, 1)), at(0, 0, -5));
+    picker.remove(a);
+    EXPECT_EQ(0u, picker.getCount());
+    EXPECT_FALSE(picker.raycastAny(Ray(Vector3(0, 0, 0), kForward), FLT_MAX));
+
+    uint32_t b = picker.addBox(AABB(Vector3(-1, -1, -1), Vector3(1, 1, 1)), at(0, 0, -5));
+    EXPECT_EQ(a, b);
+    Picker::Hit hit;
+    ASSERT_TRUE(picker.raycastClosest(Ray(Vector3(0, 0, 0), kForward), FLT_MAX, hit));
+    EXPECT_NEAR(4.0f, hit.distance, 1e-5f);
+    EXPECT_NEAR(-4.0f, hit.point.z, 1e-5f);
+}
+
+TEST(PickerTest, OrientedBoxIsTestedExactly) {
+    // A thin slab rotated 45 degrees about y.  Its world AABB covers the ray,
+    // the slab itself does not.
+    Matrix4 transform;
+    transform.rotateY(45);
+    transform.translate(0, 0, -5);
+    AABB slab(Vector3(-2, -1, -0.05f), Vector3(2, 1, 0.05f));
+
+    Picker aabb;
+    aabb.addBox(slab, transform);
+    Picker obb;
+    obb.addOrientedBox(slab, transform);
+
+    Ray ray(Vector3(1.2f, 0, 0), kForward);
+    EXPECT_TRUE(aabb.raycastAny(ray, FLT_MAX));
+    Picker::Hit hit;
+    ASSERT_TRUE(obb.raycastClosest(ray, FLT_MAX, hit));
+    // At 45 degrees the slab surface is as far from z = -5 as from x = 0.
+    EXPECT_NEAR(1.2f, fabsf(hit.point.z + 5), 0.1f);
+    EXPECT_GT(hit.normal.z, 0.5f);
+
+    EXPECT_FALSE(obb.raycastAny(Ray(Vector3(1.2f, 3, 0), kForward), FLT_MAX));
+}
+
+TEST(PickerTest, MeshHitsTriangles) {
+    // A quad in the xy plane, missing its upper right half.
+    const float positions[] = { -1, -1, 0,   1, -1, 0,   -1, 1, 0 };
+    const uint32_t indices[] = { 0, 1, 2 };
+    Picker picker;
+    uint32_t id = picker.addMesh(positions, 3, indices, 3, at(0, 0, -2));
+    ASSERT_NE(Picker::kInvalidId, id);
+
+    Picker::Hit hit;
+    ASSERT_TRUE(picker.raycastClosest(Ray(Vector3(-0.5f, -0.5f, 0), kForward), FLT_MAX, hit));
+    EXPECT_NEAR(2.0f, hit.distance, 1e-5f);
+    EXPECT_NEAR(1.0f, hit.normal.z, 1e-5f);
+    EXPECT_FALSE(picker.raycastAny(Ray(Vector3(0.6f, 0.6f, 0), kForward), FLT_MAX));
+
+    const uint32_t bad[] = { 0, 1, 7 };
+    EXPECT_EQ(Picker::kInvalidId, picker.addMesh(positions, 3, bad, 3, at(0, 0, 0)));
+}
+
+TEST(PickerTest, BatchMatchesSingleQueries) {
+    Picker picker;
+    srand(11);
+    for (int i = 0; i < 2000; i++) {
+        Vector3 c((rand() % 200 - 100) * 0.2f, (rand() % 200 - 100) * 0.2f, -(rand() % 100) * 0.5f - 1);
+        if (i % 2)
+            picker.addSphere(Vector3(0, 0, 0), 0.3f, at(c.x, c.y, c.z));
+        else
+            picker.addBox(AABB(Vector3(-0.2f, -0.2f, -0.2f), Vector3(0.2f, 0.2f, 0.2f)), at(c.x, c.y, c.z));
+    }
+
+    std::vector<Ray> rays;
+    for (int i = 0; i < 100; i++) {
+        Vector3 dir((rand() % 100 - 50) * 0.01f, (rand() % 100 - 50) * 0.01f, -1);
+        rays.push_back(Ray(Vector3(0, 0, 0), dir.normalize()));
+    }
+    std::vector<Picker::Hit> hits(rays.size());
+    uint32_t hitCount = picker.raycastBatch(rays.data(), (uint32_t) rays.size(), FLT_MAX, hits.data());
+
+    uint32_t expected = 0;
+    for (size_t i = 0; i < rays.size(); i++) {
+        Picker::Hit single;
+        bool hit = picker.raycastClosest(rays[i], FLT_MAX, single);
+        expected += hit ? 1 : 0;
+        EXPECT_EQ(single.id, hits[i].id) << "ray " << i;
+        if (hit) {
+            EXPECT_FLOAT_EQ(single.distance, hits[i].distance);
+        }
+    }
+    EXPECT_EQ(expected, hitCount);
+    EXPECT_GT(hitCount, 0u);
+}
+
+TEST(PickerTest, BatchWithJobsMatchesSerial) {
+    Picker picker;
+    srand(13);
+    for (int i = 0; i < 500; i++) {
+        Vector3 c((rand() % 200 - 100) * 0.2f, (rand() % 200 - 100) * 0.2f, -(rand() % 100) * 0.5f - 1);
+        picker.addSphere(Vector3(0, 0, 0), 0.3f, at(c.x, c.y, c.z));
+    }
+
+    // Several packets, the last one partial.
+    std::vector<Ray> rays;
+    for (int i = 0; i < 300; i++) {
+        Vector3 dir((rand() % 100 - 50) * 0.01f, (rand() % 100 - 50) * 0.01f, -1);
+        rays.push_back(Ray(Vector3(0, 0, 0), dir.normalize()));
+    }
+    std::vector<Picker::Hit> serial(rays.size()), parallel(rays.size());
+    const uint32_t hitCount = picker.raycastBatch(rays.data(), (uint32_t) rays.size(), FLT_MAX, serial.data());
+    JobSystem jobs(3);
+    EXPECT_EQ(hitCount, picker.raycastBatch(rays.data(), (uint32_t) rays.size(), FLT_MAX, parallel.data(), &jobs));
+    for (size_t i = 0; i < rays.size(); i++)
+        EXPECT_EQ(serial[i].id, parallel[i].id) << "ray " << i;
+    EXPECT_GT(hitCount, 0u);
+}
@@ -0,0 +1,140 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+
+#include <math.h>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <PoseHistory.h>
+
+static const int64_t kFrameNs = 13333333;
+
+static Matrix4 makePose(float yawDegrees, float x) {
+    Matrix4 pose;
+    pose.rotateY(yawDegrees);
+    pose.translate(x, 1.0f, 0);
+    return pose;
+}
+
+static float yawOf(const Matrix4& pose) {
+    // Forward is -z.
+    const Vector3 forward = pose * Vector3(0, 0, -1);
+    return atan2f(-forward.x, -forward.z) * 180.0f / (float) M_PI;
+}
+
+TEST(PoseHistoryTest, KeepsTheLatestSamples) {
+    PoseHistory history;
+    for (uint32_t i = 0; i < PoseHistory::kCapacity + 5; i++)
+        history.push((i + 1) * kFrameNs, makePose(0, (float) i));
+    EXPECT_EQ(PoseHistory::kCapacity, history.getCount());
+
+    PoseHistory::Sample sample;
+    ASSERT_TRUE(history.getSample(0, sample));
+    EXPECT_EQ((PoseHistory::kCapacity + 5) * kFrameNs, sample.time);
+    EXPECT_FLOAT_EQ(PoseHistory::kCapacity + 4.0f, sample.position.x);
+    ASSERT_TRUE(history.getSample(PoseHistory::kCapacity - 1, sample));
+    EXPECT_FLOAT_EQ(5.0f, sample.position.x);
+    EXPECT_FALSE(history.getSample(PoseHistory::kCapacity, sample));
+
+    // Not newer than the latest.
+    history.push(kFrameNs, makePose(0, -1));
+    ASSERT_TRUE(history.getSample(0, sample));
+    EXPECT_FLOAT_EQ(PoseHistory::kCapacity + 4.0f, sample.position.x);
+}
+
+TEST(PoseHistoryTest, PredictsConstantMotion) {
+    PoseHistory history;
+    // 90 degrees and 1 meter per second.
+    for (int i = 0; i < 6; i++) {
+        const float t = i * kFrameNs / 1e9f;
+        history.push(i * kFrameNs, makePose(90 * t, t));
+    }
+    Vector3 linear, angular;
+    ASSERT_TRUE(history.getVelocity(linear, angular));
+    EXPECT_NEAR(1.0f, linear.x, 1e-3f);
+    EXPECT_NEAR(M_PI / 2, angular.y, 1e-3f);
+
+    const int64_t target = 8 * kFrameNs;
+    Matrix4 predicted;
+    ASSERT_TRUE(history.predict(target, predicted));
+    const float t = target / 1e9f;
+    EXPECT_NEAR(t, predicted[12], 1e-3f);
+    EXPECT_NEAR(90 * t, yawOf(predicted), 0.05f);
+
+    // Far targets are clamped.
+    ASSERT_TRUE(history.predict(target + 1000000000LL, predicted));
+    const float clamped = (5 * kFrameNs + PoseHistory::kMaxPredictionNs) / 1e9f;
+    EXPECT_NEAR(clamped, predicted[12], 1e-3f);
+}
+
+TEST(PoseHistoryTest, OneEuroSmoothsJitterAndFollowsMotion) {
+    PoseHistory history;
+    history.setFilter(PoseHistory::kFilterOneEuro);
+    // A still controller jittering by a degree.
+    float maxYaw = 0;
+    for (int i = 0; i < 60; i++) {
+        history.push((i + 1) * kFrameNs, makePose(i % 2 ? 1.0f : -1.0f, 0));
+        Matrix4 pose;
+        ASSERT_TRUE(history.predict((i + 1) * kFrameNs, pose));
+        if (i > 30)
+            maxYaw = fmaxf(maxYaw, fabsf(yawOf(pose)));
+    }
+    EXPECT_LT(maxYaw, 0.3f);
+
+    // A fast turn is followed closely.
+    float yaw = 0;
+    for (int i = 60; i < 90; i++) {
+        yaw += 3.0f;
+        history.push((i + 1) * kFrameNs, makePose(yaw, 0));
+    }
+    Matrix4 pose;
+    ASSERT_TRUE(history.predict(90 * kFrameNs, pose));
+    EXPECT_NEAR(yaw, yawOf(pose), 6.0f);
+}
+
+TEST(PoseHistoryTest, ExponentialConvergesWithItsTimeConstant) {
+    PoseHistory history;
+    history.setFilter(PoseHistory::kFilterExponential);
+    history.setTimeConstant(0.1f);
+    history.push(kFrameNs, makePose(0, 0));
+    // One time constant in a single step covers 63%.
+    history.push(kFrameNs + 100000000, makePose(40, 1));
+    PoseHistory::Sample sample;
+    ASSERT_TRUE(history.getSample(0, sample));
+    const Matrix4 pose = DualQuaternion(sample.rotation, sample.position).toMatrix();
+    EXPECT_NEAR(1 - expf(-1), sample.position.x, 1e-4f);
+    EXPECT_NEAR(40 * (1 - expf(-1)), yawOf(pose), 0.01f);
+}
+
+TEST(PoseHistoryTest, ReadersNeverSeeTornSamples) {
+    PoseHistory history;
+    const int kPushes = 20000;
+    std::thread writer([&history]() {
+        for (int i = 1; i <= kPushes; i++)
+            history.push(i, makePose(0, (float) i));
+    });
+    int torn = 0;
+    int64_t lastTime = 0;
+    PoseHistory::Sample sample;
+    for (int i = 0; i < kPushes; i++) {
+        if (!history.getSample(0, sample))
+            continue;
+        // Position x was pushed with the time.
+        if (sample.position.x != (float) sample.time)
+            torn++;
+        EXPECT_GE(sample.time, lastTime);
+        lastTime = sample.time;
+    }
+    writer.join();
+    EXPECT_EQ(0, torn);
+}
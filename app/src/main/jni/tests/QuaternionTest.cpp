@@ -0,0 +1,124 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+
+#include <math.h>
+
+#include <gtest/gtest.h>
+
+#include <Quaternion.h>
+
+static Matrix4 makePose(float yaw, float pitch, float roll, const Vector3& t) {
+    Matrix4 m;
+    m.rotateZ(roll);
+    m.rotateX(pitch);
+    m.rotateY(yaw);
+    m.translate(t);
+    return m;
+}
+
+static void expectMatrixNear(const Matrix4& a, const Matrix4& b, float e) {
+    for (int i = 0; i < 16; i++)
+        EXPECT_NEAR(a[i], b[i], e) << "element " << i;
+}
+
+TEST(QuaternionTest, MatchesMatrixRotation) {
+    // Matrix4::rotate() takes a unit axis.
+    const Vector3 axis = Vector3(0.3f, 1.0f, -0.2f).normalize();
+    Matrix4 m;
+    m.rotate(50, axis);
+    const Quaternion q = Quaternion::fromAxisAngle(axis, 50);
+    expectMatrixNear(m, q.toMatrix(), 1e-5f);
+
+    const Vector3 v(0.4f, -1.2f, 2.0f);
+    const Vector3 a = m * v, b = q.rotate(v);
+    EXPECT_NEAR(a.x, b.x, 1e-5f);
+    EXPECT_NEAR(a.y, b.y, 1e-5f);
+    EXPECT_NEAR(a.z, b.z, 1e-5f);
+}
+
+TEST(QuaternionTest, RoundTripsMatrices) {
+    for (float yaw = -170; yaw < 180; yaw += 41) {
+        for (float pitch = -80; pitch < 90; pitch += 40) {
+            const Matrix4 m = makePose(yaw, pitch, 25, Vector3(0, 0, 0));
+            expectMatrixNear(m, Quaternion::fromMatrix(m).toMatrix(), 1e-5f);
+        }
+    }
+}
+
+TEST(QuaternionTest, ProductComposesLikeMatrices) {
+    const Matrix4 a = makePose(30, 10, -5, Vector3(0, 0, 0));
+    const Matrix4 b = makePose(-60, 45, 20, Vector3(0, 0, 0));
+    const Quaternion q = Quaternion::fromMatrix(a) * Quaternion::fromMatrix(b);
+    expectMatrixNear(a * b, q.toMatrix(), 1e-5f);
+}
+
+TEST(QuaternionTest, SlerpAndNlerpInterpolate) {
+    const Quaternion a;
+    const Quaternion b = Quaternion::fromAxisAngle(Vector3(0, 1, 0), 90);
+    const Quaternion half = Quaternion::slerp(a, b, 0.5f);
+    EXPECT_NEAR(45.0f * (float) M_PI / 180, half.getYawRadians(), 1e-5f);
+    // Slerp is constant speed, so a quarter is a quarter of the angle.
+    EXPECT_NEAR(22.5f * (float) M_PI / 180, Quaternion::slerp(a, b, 0.25f).getYawRadians(), 1e-5f);
+    EXPECT_NEAR(45.0f * (float) M_PI / 180, Quaternion::nlerp(a, b, 0.5f).getYawRadians(), 1e-5f);
+    // The shorter way round when b is given with the other sign.
+    EXPECT_NEAR(45.0f * (float) M_PI / 180, Quaternion::slerp(a, -b, 0.5f).getYawRadians(), 1e-5f);
+}
+
+TEST(QuaternionTest, YawOnlyDropsPitchAndRoll) {
+    const Quaternion q = Quaternion::fromMatrix(makePose(35, 20, 10, Vector3(0, 0, 0)));
+    const Quaternion yaw = q.yawOnly();
+    // Forward under the yaw alone stays level and keeps the heading of q.
+    const Vector3 forward = yaw.rotate(Vector3(0, 0, -1));
+    const Vector3 full = q.rotate(Vector3(0, 0, -1));
+    EXPECT_NEAR(0, forward.y, 1e-6f);
+    EXPECT_NEAR(atan2f(full.x, -full.z), atan2f(forward.x, -forward.z), 0.05f);
+    // Pure yaw passes through.
+    EXPECT_NEAR(35.0f * (float) M_PI / 180,
+            Quaternion::fromAxisAngle(Vector3(0, 1, 0), 35).yawOnly().getYawRadians(), 1e-5f);
+}
+
+// hellovr.cpp used to rebuild the inverse head rotation from Euler angles
+// to place 3DoF controllers.  The rebuild applied the angles in reverse
+// order, so it only held for a single axis; there the conjugate agrees.
+TEST(QuaternionTest, ConjugateMatchesTheEulerRebuild) {
+    for (float yaw = -150; yaw < 180; yaw += 50) {
+        Matrix4 mat = makePose(yaw, 0, 0, Vector3(0.1f, 1.6f, 0.2f));
+        const Quaternion head = Quaternion::fromMatrix(mat);
+        mat.invert();
+        const float angleY = atan2f(-mat[8], mat[10]);
+        const float angleX = asinf(-mat[9]);
+        const float angleZ = atan2f(mat[1], mat[5]);
+        mat.identity().rotateY(-angleY / M_PI * 180.0f);
+        mat.rotateX(angleX / M_PI * 180.0f);
+        mat.rotateZ(angleZ / M_PI * 180.0f);
+        expectMatrixNear(mat, head.conjugate().toMatrix(), 1e-4f);
+    }
+}
+
+TEST(DualQuaternionTest, MatchesRigidMatrices) {
+    const Matrix4 a = makePose(30, 10, -5, Vector3(0.5f, 1.6f, -2.0f));
+    const Matrix4 b = makePose(-60, 45, 20, Vector3(-0.2f, 0.1f, 0.3f));
+    const DualQuaternion da = DualQuaternion::fromMatrix(a);
+    const DualQuaternion db = DualQuaternion::fromMatrix(b);
+    expectMatrixNear(a, da.toMatrix(), 1e-5f);
+    expectMatrixNear(a * b, (da * db).toMatrix(), 1e-5f);
+
+    Matrix4 inverse = a;
+    inverse.invert();
+    expectMatrixNear(inverse, da.inverse().toMatrix(), 1e-5f);
+
+    const Vector3 p(0.3f, -0.7f, 1.1f);
+    const Vector3 q = a * p, r = da.transform(p);
+    EXPECT_NEAR(q.x + a[12], r.x, 1e-5f);
+    EXPECT_NEAR(q.y + a[13], r.y, 1e-5f);
+    EXPECT_NEAR(q.z + a[14], r.z, 1e-5f);
+}
@@ -0,0 +1,145 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#include <stdlib.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <RayPacket.h>
+#include <RaySphereIntersection.h>
+
+static float frand(float lo, float hi) {
+    return lo + (hi - lo) * (rand() / (float) RAND_MAX);
+}
+
+static Ray randomRay() {
+    Vector3 dir(frand(-1, 1), frand(-1, 1), frand(-1, 1));
+    return Ray(Vector3(frand(-2, 2), frand(-2, 2), frand(-2, 2)), dir.normalize());
+}
+
+// Every lane must agree with the scalar reference in BoundingVolume.h.
+TEST(RayPacketTest, RaysAgainstSphereMatchScalar) {
+    srand(3);
+    int hits = 0;
+    for (int iter = 0; iter < 2000; iter++) {
+        Ray rays[4];
+        for (int i = 0; i < 4; i++)
+            rays[i] = randomRay();
+        RayPacket4 packet;
+        packet.set(rays, 4);
+        Vector3 center(frand(-3, 3), frand(-3, 3), frand(-3, 3));
+        float radius = frand(0.1f, 2.0f);
+        float tMax[4] = { 100, 100, 1.0f, 100 };
+
+        float t[4] = { -1, -1, -1, -1 };
+        uint32_t mask = intersectSphere4(packet, center, radius, 0, tMax, t);
+        for (int i = 0; i < 4; i++) {
+            float expected;
+            bool hit = intersectSphere(rays[i], center, radius, 0, tMax[i], expected);
+            ASSERT_EQ(hit, (mask >> i & 1) != 0) << "iteration " << iter << " lane " << i;
+            if (hit) {
+                EXPECT_NEAR(expected, t[i], 1e-4f);
+                hits++;
+            } else {
+                EXPECT_EQ(-1.0f, t[i]);
+            }
+        }
+    }
+    EXPECT_GT(hits, 500);
+}
+
+TEST(RayPacketTest, RaysAgainstBoxMatchScalar) {
+    srand(5);
+    for (int iter = 0; iter < 2000; iter++) {
+        Ray rays[4];
+        for (int i = 0; i < 4; i++)
+            rays[i] = randomRay();
+        RayPacket4 packet;
+        packet.set(rays, 4);
+        Vector3 c(frand(-3, 3), frand(-3, 3), frand(-3, 3));
+        Vector3 e(frand(0.1f, 1), frand(0.1f, 1), frand(0.1f, 1));
+        AABB box(c - e, c + e);
+        float tMax[4] = { 100, 100, 100, 2.0f };
+
+        float t[4];
+        uint32_t mask = intersectAABB4(packet, box, 0, tMax, t);
+        for (int i = 0; i < 4; i++) {
+            float expected;
+            bool hit = box.intersect(rays[i], 0, tMax[i], expected);
+            ASSERT_EQ(hit, (mask >> i & 1) != 0) << "iteration " << iter << " lane " << i;
+            if (hit) {
+                EXPECT_NEAR(expected, t[i], 1e-4f);
+            }
+        }
+    }
+}
+
+TEST(RayPacketTest, RayAgainstBoxesSkipsEmptyLanes) {
+    Ray ray(Vector3(0, 0, 0), Vector3(0, 0, -1));
+    AABBPacket4 boxes;
+    for (int i = 0; i < 4; i++) {
+        AABB box = i == 3 ? AABB() : AABB(Vector3(-1, -1, -2.0f - i), Vector3(1, 1, -1.0f - i));
+        boxes.minX[i] = box.min.x; boxes.minY[i] = box.min.y; boxes.minZ[i] = box.min.z;
+        boxes.maxX[i] = box.max.x; boxes.maxY[i] = box.max.y; boxes.maxZ[i] = box.max.z;
+    }
+    float t[4];
+    EXPECT_EQ(0x7u, intersectAABB4(ray, boxes, 0, FLT_MAX, t));
+    EXPECT_FLOAT_EQ(1.0f, t[0]);
+    EXPECT_FLOAT_EQ(2.0f, t[1]);
+    EXPECT_FLOAT_EQ(3.0f, t[2]);
+    EXPECT_EQ(0x1u, intersectAABB4(ray, boxes, 0, 1.5f, t));
+}
+
+TEST(RayPacketTest, ClosestSphereReturnsIndexAndDistance) {
+    srand(9);
+    std::vector<float> cx, cy, cz, r;
+    for (int i = 0; i < 103; i++) {
+        cx.push_back(frand(-5, 5));
+        cy.push_back(frand(-5, 5));
+        cz.push_back(frand(-20, -1));
+        r.push_back(frand(0.1f, 0.5f));
+    }
+    for (int iter = 0; iter < 200; iter++) {
+        Ray ray(Vector3(0, 0, 0), Vector3(frand(-0.3f, 0.3f), frand(-0.3f, 0.3f), -1).normalize());
+        int32_t expected = -1;
+        float best = FLT_MAX;
+        for (int i = 0; i < 103; i++) {
+            float t;
+            if (intersectSphere(ray, Vector3(cx[i], cy[i], cz[i]), r[i], 0, best, t)) {
+                best = t;
+                expected = i;
+            }
+        }
+        float t = -1;
+        int32_t index = closestSphere(ray, cx.data(), cy.data(), cz.data(), r.data(), 103, 0, FLT_MAX, t);
+        EXPECT_EQ(expected, index);
+        // b * b - a * c cancels badly on grazing hits far away, and the
+        // packet sums its dot products in a different order.
+        if (expected >= 0) {
+            EXPECT_NEAR(best, t, 1e-4f * best);
+        }
+    }
+}
+
+// The legacy helper keeps its contract: forward hits only, nearest first.
+TEST(RayPacketTest, LegacyIntersection) {
+    Sphere3D sphere(Point3D(0, 0, -5), 1);
+    Ray3D ahead(Point3D(0, 0, 0), Vector3D(0, 0, -1), Vector3());
+    ASSERT_TRUE(intersection(ahead, sphere));
+    EXPECT_FLOAT_EQ(-4.0f, ahead.collision.z);
+
+    Ray3D inside(Point3D(0, 0, -5), Vector3D(0, 0, -1), Vector3());
+    ASSERT_TRUE(intersection(inside, sphere));
+    EXPECT_FLOAT_EQ(-6.0f, inside.collision.z);
+
+    Ray3D behind(Point3D(0, 0, 0), Vector3D(0, 0, 1), Vector3());
+    EXPECT_FALSE(intersection(behind, sphere));
+}
@@ -0,0 +1,126 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <FrameBufferObject.h>
+#include <RenderTargetManager.h>
+
+#include "HostTestEnv.h"
+
+static const int kSize = 64;
+static const uint32_t kQueueLength = 3;
+
+class RenderTargetManagerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        REQUIRE_GL();
+        for (uint32_t eye = 0; eye < RenderTargetManager::kEyeCount; eye++) {
+            mTextures[eye].resize(kQueueLength);
+            glGenTextures(kQueueLength, mTextures[eye].data());
+            for (uint32_t i = 0; i < kQueueLength; i++) {
+                glBindTexture(GL_TEXTURE_2D, mTextures[eye][i]);
+                glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, kSize, kSize);
+            }
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    void TearDown() override {
+        for (uint32_t eye = 0; eye < RenderTargetManager::kEyeCount; eye++) {
+            if (!mTextures[eye].empty())
+                glDeleteTextures(kQueueLength, mTextures[eye].data());
+        }
+    }
+
+    // Clears every target to its own red level and reads it back.
+    void clearAndCheck(const RenderTargetManager& targets) {
+        for (uint32_t eye = 0; eye < RenderTargetManager::kEyeCount; eye++) {
+            for (uint32_t i = 0; i < targets.getCount(eye); i++) {
+                const float red = (eye * kQueueLength + i + 1) / 8.0f;
+                FrameBufferObject * fbo = targets.get(eye, i);
+                fbo->bindFrameBuffer();
+                fbo->glViewportFull();
+                glClearColor(red, 0, 0, 1);
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                fbo->unbindFrameBuffer();
+            }
+        }
+
+        GLuint read = 0;
+        glGenFramebuffers(1, &read);
+        glBindFramebuffer(GL_FRAMEBUFFER, read);
+        for (uint32_t eye = 0; eye < RenderTargetManager::kEyeCount; eye++) {
+            for (uint32_t i = 0; i < kQueueLength; i++) {
+                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mTextures[eye][i], 0);
+                uint8_t pixel[4] = {0};
+                glReadPixels(kSize / 2, kSize / 2, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+                EXPECT_NEAR((eye * kQueueLength + i + 1) * 255 / 8, pixel[0], 2);
+            }
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &read);
+        EXPECT_EQ(GL_NO_ERROR, glGetError());
+    }
+
+    std::vector<GLuint> mTextures[RenderTargetManager::kEyeCount];
+};
+
+TEST(RenderTargetSamplesTest, ChoosesSupportedPowerOfTwo) {
+    REQUIRE_GL();
+    const int maxSamples = FrameBufferObject::getMaxSamples();
+    EXPECT_EQ(1, RenderTargetManager::chooseSamples(0));
+    EXPECT_EQ(1, RenderTargetManager::chooseSamples(1));
+    for (int requested = 2; requested <= 8; requested++) {
+        const int samples = RenderTargetManager::chooseSamples(requested);
+        EXPECT_TRUE(samples == 1 || samples == 2 || samples == 4);
+        EXPECT_LE(samples, requested);
+        EXPECT_TRUE(samples == 1 || samples <= maxSamples);
+    }
+}
+
+TEST_F(RenderTargetManagerTest, SharesOneDepthBuffer) {
+    RenderTargetManager targets;
+    ASSERT_TRUE(targets.init(mTextures, kSize, kSize, 1));
+    EXPECT_EQ(1, targets.getSamples());
+    EXPECT_EQ(kQueueLength, targets.getCount(0));
+    EXPECT_EQ(kQueueLength, targets.getCount(1));
+    EXPECT_EQ(1u, targets.getDepthBufferCount());
+    EXPECT_EQ((size_t) kSize * kSize * 4, targets.getDepthBytes());
+    EXPECT_EQ((size_t) 2 * kQueueLength * kSize * kSize * 4, targets.getColorBytes());
+    clearAndCheck(targets);
+}
+
+TEST_F(RenderTargetManagerTest, DepthPerTargetWhenNotShared) {
+    RenderTargetManager targets;
+    ASSERT_TRUE(targets.init(mTextures, kSize, kSize, 1, false));
+    EXPECT_EQ(2 * kQueueLength, targets.getDepthBufferCount());
+    EXPECT_EQ((size_t) 2 * kQueueLength * kSize * kSize * 4, targets.getDepthBytes());
+    clearAndCheck(targets);
+}
+
+TEST_F(RenderTargetManagerTest, MultisampledTargets) {
+    RenderTargetManager targets;
+    ASSERT_TRUE(targets.init(mTextures, kSize, kSize, 4));
+    const int samples = targets.getSamples();
+    EXPECT_EQ(RenderTargetManager::chooseSamples(4), samples);
+    EXPECT_EQ(samples, targets.get(0, 0)->getSamples());
+    EXPECT_EQ((size_t) kSize * kSize * 4 * samples, targets.getDepthBytes());
+    clearAndCheck(targets);
+
+    // Going back to single sampled replaces, not adds.
+    ASSERT_TRUE(targets.init(mTextures, kSize, kSize, 1));
+    EXPECT_EQ(1u, targets.getDepthBufferCount());
+    EXPECT_EQ(kQueueLength, targets.getCount(0));
+    clearAndCheck(targets);
+}
@@ -0,0 +1,136 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#include <math.h>
+
+#include <gtest/gtest.h>
+
+#include <GpuTimer.h>
+#include <ResolutionController.h>
+
+#include "HostTestEnv.h"
+
+static const float kTarget = 0.010f;
+
+// GPU time of a frame whose cost follows the pixel count.
+static float frameTime(float fullCost, float scale) {
+    return fullCost * scale * scale;
+}
+
+TEST(ResolutionControllerTest, StaysFullWhenUnderBudget) {
+    ResolutionController rc;
+    rc.setTargetTime(kTarget);
+    for (int i = 0; i < 100; i++)
+        EXPECT_FLOAT_EQ(1.0f, rc.update(frameTime(0.006f, rc.getScale())));
+}
+
+TEST(ResolutionControllerTest, SettlesUnderLoad) {
+    ResolutionController rc;
+    rc.setTargetTime(kTarget);
+    rc.setBounds(0.5f, 1.0f);
+    // Twice the budget at full size; about 0.71 meets it.
+    const float fullCost = 2 * kTarget;
+    for (int i = 0; i < 200; i++)
+        rc.update(frameTime(fullCost, rc.getScale()));
+    EXPECT_NEAR(sqrtf(0.5f), rc.getScale(), 0.06f);
+
+    // Settled: the scale holds still from frame to frame.
+    uint32_t changes = 0;
+    float last = rc.getScale();
+    for (int i = 0; i < 100; i++) {
+        // +-2% noise
+        const float noise = (i & 1) ? 1.02f : 0.98f;
+        rc.update(frameTime(fullCost, rc.getScale()) * noise);
+        if (rc.getScale() != last)
+            changes++;
+        last = rc.getScale();
+    }
+    EXPECT_EQ(0u, changes);
+}
+
+TEST(ResolutionControllerTest, ClampsAndRecovers) {
+    ResolutionController rc;
+    rc.setTargetTime(kTarget);
+    rc.setBounds(0.5f, 1.0f);
+    for (int i = 0; i < 200; i++)
+        rc.update(frameTime(10 * kTarget, rc.getScale()));
+    EXPECT_FLOAT_EQ(0.5f, rc.getScale());
+
+    // No wind up: once the load is gone it climbs back in a few dozen frames.
+    int frames = 0;
+    while (rc.getScale() < 1.0f && frames < 100) {
+        rc.update(frameTime(0.5f * kTarget, rc.getScale()));
+        frames++;
+    }
+    EXPECT_FLOAT_EQ(1.0f, rc.getScale());
+    EXPECT_LT(frames, 60);
+}
+
+TEST(ResolutionControllerTest, StepsAreNotTiny) {
+    ResolutionController rc;
+    rc.setTargetTime(kTarget);
+    float last = rc.getScale();
+    for (int i = 0; i < 200; i++) {
+        rc.update(frameTime(1.3f * kTarget, rc.getScale()));
+        const float step = fabsf(rc.getScale() - last);
+        if (step > 0) {
+            const bool atBound = rc.getScale() == 0.5f || rc.getScale() == 1.0f;
+            EXPECT_TRUE(step >= ResolutionController::kMinStep || atBound);
+        }
+        last = rc.getScale();
+    }
+}
+
+TEST(ResolutionControllerTest, QualityRequests) {
+    ResolutionController rc;
+    rc.setBounds(0.5f, 1.0f);
+    const float lower = rc.requestLower();
+    EXPECT_LT(lower, 1.0f);
+    EXPECT_LT(rc.requestLower(), lower);
+    for (int i = 0; i < 10; i++)
+        rc.requestLower();
+    EXPECT_FLOAT_EQ(0.5f, rc.getScale());
+    for (int i = 0; i < 10; i++)
+        rc.requestHigher();
+    EXPECT_FLOAT_EQ(1.0f, rc.getScale());
+}
+
+TEST(ResolutionControllerTest, RequestHoldsAgainstMeasurements) {
+    ResolutionController rc;
+    rc.setTargetTime(kTarget);
+    const float hinted = rc.requestLower();
+    for (int i = 0; i < 10; i++)
+        EXPECT_FLOAT_EQ(hinted, rc.update(0.2f * kTarget));
+    // Plenty of headroom wins in the end.
+    for (int i = 0; i < 200; i++)
+        rc.update(0.2f * kTarget);
+    EXPECT_FLOAT_EQ(1.0f, rc.getScale());
+}
+
+TEST(GpuTimerTest, MeasuresAClear) {
+    REQUIRE_GL();
+    GpuTimer timer;
+    if (!timer.isSupported())
+        GTEST_SKIP() << "no GL_EXT_disjoint_timer_query";
+
+    float seconds = -1;
+    bool ready = false;
+    for (int i = 0; i < 20 && !ready; i++) {
+        timer.begin();
+        glClear(GL_COLOR_BUFFER_BIT);
+        timer.end();
+        glFinish();
+        ready = timer.poll(seconds);
+    }
+    EXPECT_TRUE(ready);
+    EXPECT_GE(seconds, 0.0f);
+    EXPECT_LT(seconds, 1.0f);
+}
@@ -0,0 +1,300 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+#include <Environment.h>
+#include <SceneFile.h>
+#include <SceneFileWriter.h>
+#include <ObjImporter.h>
+
+#include "HostTestEnv.h"
+
+namespace {
+
+// A unit quad in the xy plane: position, uv, normal.
+const float kQuad[] = {
+    0, 0, 0,  0, 0,  0, 0, 1,
+    1, 0, 0,  1, 0,  0, 0, 1,
+    1, 1, 0,  1, 1,  0, 0, 1,
+    0, 1, 0,  0, 1,  0, 0, 1,
+};
+const uint32_t kQuadIndices[] = { 0, 1, 2, 0, 2, 3 };
+
+const char * kObj =
+    "mtllib room.mtl\n"
+    "o floor\n"
+    "v -1 0 -1\n"
+    "v 1 0 -1\n"
+    "v 1 0 1\n"
+    "v -1 0 1\n"
+    "usemtl red\n"
+    "f 1 2 3 4\n"
+    "usemtl blue\n"
+    "f -4 -2 -3\n"
+    "o wall\n"
+    "v 0 0 0\n"
+    "v 0 1 0\n"
+    "v 0 1 1\n"
+    "vn 1 0 0\n"
+    "f 5//1 6//1 7//1\n";
+
+const char * kMtl =
+    "newmtl red\n"
+    "Kd 1 0 0\n"
+    "newmtl blue\n"
+    "Kd 0 0 1\n"
+    "d 0.5\n";
+
+void buildQuadScene(SceneFileWriter& writer) {
+    const float red[4] = { 1, 0, 0, 1 };
+    const float white[4] = { 1, 1, 1, 1 };
+    uint32_t texture = writer.addTexture("textures/wall.png");
+    EXPECT_EQ(texture, writer.addTexture("textures/wall.png"));
+    writer.addMaterial("red", red);
+    writer.addMaterial("wall", white, texture);
+    SceneFile::SubmeshRecord submeshes[] = { { 0, 3, 0, 0 }, { 3, 3, 1, 0 } };
+    uint32_t mesh = writer.addMesh(kQuad, 4, 8, 5, 3, kQuadIndices, 6, submeshes, 2);
+    uint32_t root = writer.addNode("root", SceneFile::kNone, SceneFile::kNone, Matrix4());
+    Matrix4 local;
+    local.translate(0, 0, -2);
+    writer.addNode("quad", root, mesh, local);
+}
+
+class SceneFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char tmpl[] = "/tmp/hellovr_sceneXXXXXX";
+        ASSERT_TRUE(mkdtemp(tmpl) != NULL);
+        mDir = tmpl;
+        mDir += "/";
+    }
+
+    void TearDown() override {
+        for (size_t i = 0; i < mFiles.size(); i++)
+            unlink(mFiles[i].c_str());
+        rmdir(mDir.c_str());
+    }
+
+    std::string path(const char * name) {
+        mFiles.push_back(mDir + name);
+        return mFiles.back();
+    }
+
+    void writeText(const std::string& file, const char * text) {
+        FILE * f = fopen(file.c_str(), "w");
+        ASSERT_TRUE(f != NULL);
+        fputs(text, f);
+        fclose(f);
+    }
+
+    std::string mDir;
+    std::vector<std::string> mFiles;
+};
+
+}  // namespace
+
+TEST_F(SceneFileTest, RoundTripsThroughAMappedFile) {
+    SceneFileWriter writer;
+    buildQuadScene(writer);
+    const std::string file = path("quad.hvsc");
+    ASSERT_TRUE(writer.save(file.c_str()));
+
+    SceneFile scene;
+    ASSERT_TRUE(scene.open(file.c_str()));
+    ASSERT_EQ(1u, scene.getMeshCount());
+    ASSERT_EQ(2u, scene.getMaterialCount());
+    ASSERT_EQ(1u, scene.getTextureCount());
+    ASSERT_EQ(2u, scene.getNodeCount());
+
+    const SceneFile::MeshRecord& mesh = scene.getMesh(0);
+    EXPECT_EQ(4u, mesh.vertexCount);
+    EXPECT_EQ(32u, mesh.vertexStride);
+    EXPECT_EQ(20u, mesh.normalOffset);
+    EXPECT_EQ(12u, mesh.texCoordOffset);
+    EXPECT_EQ(2u, mesh.indexSize);
+    EXPECT_EQ(6u, mesh.indexCount);
+    EXPECT_EQ(0.0f, mesh.boundsMin[0]);
+    EXPECT_EQ(1.0f, mesh.boundsMax[1]);
+    EXPECT_EQ(0u, ((uintptr_t) scene.getVertices(mesh)) % 4);
+    EXPECT_EQ(0, memcmp(kQuad, scene.getVertices(mesh), sizeof(kQuad)));
+    const uint16_t * indices = (const uint16_t *) scene.getIndices(mesh);
+    for (uint32_t i = 0; i < 6; i++)
+        EXPECT_EQ(kQuadIndices[i], indices[i]);
+
+    ASSERT_EQ(2u, mesh.submeshCount);
+    EXPECT_EQ(3u, scene.getSubmesh(mesh.firstSubmesh + 1).firstIndex);
+    EXPECT_STREQ("wall", scene.getString(scene.getMaterial(1).name));
+    EXPECT_EQ(0u, scene.getMaterial(1).baseColorTexture);
+    EXPECT_EQ(SceneFile::kNone, scene.getMaterial(0).baseColorTexture);
+    EXPECT_STREQ("textures/wall.png", scene.getString(scene.getTexture(0).uri));
+
+    EXPECT_EQ(SceneFile::kNone, scene.getNode(0).parent);
+    EXPECT_EQ(0u, scene.getNode(1).parent);
+    EXPECT_EQ(0u, scene.getNode(1).mesh);
+    EXPECT_EQ(-2.0f, scene.getNode(1).local[14]);
+
+    scene.close();
+    EXPECT_FALSE(scene.isOpen());
+    EXPECT_EQ(0u, scene.getMeshCount());
+}
+
+TEST_F(SceneFileTest, RejectsCorruptData) {
+    SceneFileWriter writer;
+    buildQuadScene(writer);
+    std::vector<uint8_t> good;
+    writer.write(good);
+    // Vectors of uint32_t keep the copies aligned.
+    std::vector<uint32_t> storage((good.size() + 3) / 4);
+    uint8_t * data = (uint8_t *) storage.data();
+
+    SceneFile scene;
+    memcpy(data, good.data(), good.size());
+    ASSERT_TRUE(scene.open(data, good.size()));
+    scene.close();
+
+    EXPECT_FALSE(scene.open(data, good.size() - 4));
+    EXPECT_FALSE(scene.open(data, sizeof(SceneFile::Header) - 1));
+
+    data[0] = 'X';
+    EXPECT_FALSE(scene.open(data, good.size()));
+    memcpy(data, good.data(), good.size());
+
+    SceneFile::Header * header = (SceneFile::Header *) data;
+    header->version = SceneFile::kVersion + 1;
+    EXPECT_FALSE(scene.open(data, good.size()));
+    memcpy(data, good.data(), good.size());
+
+    header->sections[SceneFile::kMeshes].offset += 4;
+    EXPECT_FALSE(scene.open(data, good.size()));
+    memcpy(data, good.data(), good.size());
+
+    // An index past the last vertex.
+    const SceneFile::SectionEntry& indexData = header->sections[SceneFile::kIndexData];
+    ((uint16_t *) (data + indexData.offset))[2] = 4;
+    EXPECT_FALSE(scene.open(data, good.size()));
+    memcpy(data, good.data(), good.size());
+
+    // A submesh past the end of the indices.
+    SceneFile::SubmeshRecord * submeshes =
+            (SceneFile::SubmeshRecord *) (data + header->sections[SceneFile::kSubmeshes].offset);
+    submeshes[1].indexCount = 4;
+    EXPECT_FALSE(scene.open(data, good.size()));
+    memcpy(data, good.data(), good.size());
+
+    // A node whose parent comes after it.
+    SceneFile::NodeRecord * nodes = (SceneFile::NodeRecord *) (data + header->sections[SceneFile::kNodes].offset);
+    nodes[0].parent = 1;
+    EXPECT_FALSE(scene.open(data, good.size()));
+    memcpy(data, good.data(), good.size());
+
+    SceneFile::MaterialRecord * materials =
+            (SceneFile::MaterialRecord *) (data + header->sections[SceneFile::kMaterials].offset);
+    materials[1].baseColorTexture = 1;
+    EXPECT_FALSE(scene.open(data, good.size()));
+    memcpy(data, good.data(), good.size());
+
+    EXPECT_TRUE(scene.open(data, good.size()));
+}
+
+TEST_F(SceneFileTest, ImportsObjWithMaterials) {
+    writeText(path("room.mtl"), kMtl);
+    const std::string obj = path("room.obj");
+    writeText(obj, kObj);
+
+    SceneFileWriter writer;
+    ObjImporter importer(writer);
+    ASSERT_TRUE(importer.load(obj.c_str()));
+    // The quad is a fan of two triangles, plus one more of each object.
+    EXPECT_EQ(4u, importer.getTriangleCount());
+
+    std::vector<uint8_t> bytes;
+    writer.write(bytes);
+    std::vector<uint32_t> storage((bytes.size() + 3) / 4);
+    memcpy(storage.data(), bytes.data(), bytes.size());
+    SceneFile scene;
+    ASSERT_TRUE(scene.open(storage.data(), bytes.size()));
+    ASSERT_EQ(2u, scene.getMeshCount());
+    ASSERT_EQ(2u, scene.getNodeCount());
+    EXPECT_STREQ("floor", scene.getString(scene.getNode(0).name));
+    EXPECT_STREQ("wall", scene.getString(scene.getNode(1).name));
+
+    const SceneFile::MeshRecord& floor = scene.getMesh(scene.getNode(0).mesh);
+    EXPECT_EQ(4u, floor.vertexCount);
+    EXPECT_EQ(2u, floor.indexSize);
+    ASSERT_EQ(2u, floor.submeshCount);
+    const SceneFile::SubmeshRecord& red = scene.getSubmesh(floor.firstSubmesh);
+    const SceneFile::SubmeshRecord& blue = scene.getSubmesh(floor.firstSubmesh + 1);
+    EXPECT_EQ(6u, red.indexCount);
+    EXPECT_EQ(3u, blue.indexCount);
+    ASSERT_EQ(2u, scene.getMaterialCount());
+    EXPECT_STREQ("red", scene.getString(scene.getMaterial(red.material).name));
+    EXPECT_EQ(0.0f, scene.getMaterial(blue.material).baseColor[0]);
+    EXPECT_EQ(0.5f, scene.getMaterial(blue.material).baseColor[3]);
+
+    // Smoothed normals of a flat, counter clockwise floor point up.
+    const uint8_t * vertices = (const uint8_t *) scene.getVertices(floor);
+    for (uint32_t v = 0; v < floor.vertexCount; v++) {
+        const float * n = (const float *) (vertices + v * floor.vertexStride + floor.normalOffset);
+        EXPECT_NEAR(1.0f, fabsf(n[1]), 1e-5f);
+    }
+
+    const SceneFile::MeshRecord& wall = scene.getMesh(scene.getNode(1).mesh);
+    const float * n = (const float *) ((const uint8_t *) scene.getVertices(wall) + wall.normalOffset);
+    EXPECT_EQ(1.0f, n[0]);
+    // usemtl carries over into the next object.
+    EXPECT_EQ(blue.material, scene.getSubmesh(wall.firstSubmesh).material);
+}
+
+TEST_F(SceneFileTest, RejectsBadObj) {
+    SceneFileWriter writer;
+    ObjImporter importer(writer);
+    EXPECT_FALSE(importer.parse("v 0 0 0\nf 1 2 x\n", mDir));
+    EXPECT_FALSE(importer.load(path("missing.obj").c_str()));
+}
+
+TEST_F(SceneFileTest, EnvironmentDrawsEverySubmesh) {
+    REQUIRE_GL();
+    SceneFileWriter writer;
+    const float red[4] = { 1, 0, 0, 1 };
+    writer.addMaterial("red", red);
+    SceneFile::SubmeshRecord submeshes[] = { { 0, 3, 0, 0 }, { 3, 3, SceneFile::kNone, 0 } };
+    uint32_t mesh = writer.addMesh(kQuad, 4, 8, 5, 3, kQuadIndices, 6, submeshes, 2);
+    Matrix4 left, right;
+    left.translate(-2, 0, 0);
+    right.translate(2, 0, 0);
+    writer.addNode("left", SceneFile::kNone, mesh, left);
+    writer.addNode("right", SceneFile::kNone, mesh, right);
+    const std::string file = path("env.hvsc");
+    ASSERT_TRUE(writer.save(file.c_str()));
+
+    Environment env(file.c_str());
+    ASSERT_FALSE(env.hasError());
+    EXPECT_EQ(1u, env.getMeshCount());
+    ASSERT_TRUE(env.hasBounds());
+    EXPECT_EQ(-2.0f, env.getLocalBounds().min.x);
+    EXPECT_EQ(3.0f, env.getLocalBounds().max.x);
+
+    Matrix4 identity;
+    env.draw(identity, identity, identity, Vector4(0, -1, 0, 0));
+    EXPECT_EQ(4u, env.getDrawCalls());
+    EXPECT_EQ((GLenum) GL_NO_ERROR, glGetError());
+
+    Environment missing(path("missing.hvsc").c_str());
+    EXPECT_TRUE(missing.hasError());
+}
@@ -0,0 +1,155 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#include <math.h>
+#include <atomic>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <Object.h>
+#include <SceneGraph.h>
+
+static Matrix4 at(float x, float y, float z) {
+    Matrix4 m;
+    m.translate(x, y, z);
+    return m;
+}
+
+static void expectNear(const Matrix4& expected, const Matrix4& actual) {
+    for (int i = 0; i < 16; i++)
+        EXPECT_NEAR(expected[i], actual[i], 1e-5f) << "element " << i;
+}
+
+TEST(SceneGraphTest, WorldIsParentTimesLocal) {
+    SceneGraph graph;
+    SceneGraph::NodeId root = graph.createNode();
+    SceneGraph::NodeId child = graph.createNode(root);
+    SceneGraph::NodeId leaf = graph.createNode(child);
+    Matrix4 rotation;
+    rotation.rotateY(90);
+    graph.setLocalTransform(root, at(1, 0, 0));
+    graph.setLocalTransform(child, rotation);
+    graph.setLocalTransform(leaf, at(0, 0, -2));
+
+    EXPECT_EQ(3u, graph.update());
+    expectNear(at(1, 0, 0) * rotation * at(0, 0, -2), graph.getWorldTransform(leaf));
+    EXPECT_EQ(0u, graph.update());
+}
+
+TEST(SceneGraphTest, UpdateTouchesOnlyTheChangedSubtree) {
+    SceneGraph graph;
+    SceneGraph::NodeId left = graph.createNode();
+    SceneGraph::NodeId right = graph.createNode();
+    for (int i = 0; i < 5; i++) {
+        graph.createNode(left);
+        graph.createNode(right);
+    }
+    graph.update();
+
+    graph.setLocalTransform(left, at(0, 1, 0));
+    EXPECT_EQ(6u, graph.update());
+}
+
+TEST(SceneGraphTest, ReparentBeforeParentIsReordered) {
+    SceneGraph graph;
+    SceneGraph::NodeId a = graph.createNode();
+    SceneGraph::NodeId b = graph.createNode();
+    graph.setLocalTransform(a, at(0, 0, 1));
+    graph.setLocalTransform(b, at(2, 0, 0));
+    graph.setParent(a, b);
+    EXPECT_EQ(b, graph.getParent(a));
+
+    graph.update();
+    expectNear(at(2, 0, 1), graph.getWorldTransform(a));
+
+    // A cycle is refused and leaves the hierarchy alone.
+    graph.setParent(b, a);
+    EXPECT_EQ(SceneGraph::kInvalidNode, graph.getParent(b));
+}
+
+TEST(SceneGraphTest, DestroyMovesChildrenUpAndReusesIds) {
+    SceneGraph graph;
+    SceneGraph::NodeId root = graph.createNode();
+    SceneGraph::NodeId middle = graph.createNode(root);
+    SceneGraph::NodeId leaf = graph.createNode(middle);
+    graph.setLocalTransform(root, at(1, 0, 0));
+    graph.setLocalTransform(middle, at(0, 1, 0));
+    graph.setLocalTransform(leaf, at(0, 0, 1));
+    graph.update();
+
+    graph.destroyNode(middle);
+    EXPECT_FALSE(graph.isValid(middle));
+    EXPECT_EQ(root, graph.getParent(leaf));
+    EXPECT_EQ(2u, graph.getCount());
+    graph.update();
+    expectNear(at(1, 0, 1), graph.getWorldTransform(leaf));
+
+    EXPECT_EQ(middle, graph.createNode());
+}
+
+TEST(SceneGraphTest, NormalMatrixUndoesNonUniformScale) {
+    SceneGraph graph;
+    SceneGraph::NodeId node = graph.createNode();
+    Matrix4 scale;
+    scale.scale(2, 1, 1);
+    graph.setLocalTransform(node, scale);
+    graph.update();
+
+    const Matrix3& normal = graph.getNormalMatrix(node);
+    EXPECT_NEAR(0.5f, normal[0], 1e-6f);
+    EXPECT_NEAR(1.0f, normal[4], 1e-6f);
+    EXPECT_NEAR(1.0f, normal[8], 1e-6f);
+}
+
+TEST(SceneGraphTest, LocalTransformFromWorkerThread) {
+    SceneGraph graph;
+    SceneGraph::NodeId root = graph.createNode();
+    SceneGraph::NodeId child = graph.createNode(root);
+    graph.setLocalTransform(child, at(0, 0, -1));
+
+    std::atomic<bool> done(false);
+    std::thread worker([&]() {
+        for (int i = 0; i <= 1000; i++)
+            graph.setLocalTransform(root, at((float) i, 0, 0));
+        done = true;
+    });
+    while (!done)
+        graph.update();
+    worker.join();
+    graph.update();
+
+    expectNear(at(1000, 0, -1), graph.getWorldTransform(child));
+}
+
+TEST(SceneGraphTest, AttachedObjectMatchesParentWalk) {
+    SceneGraph graph;
+    Object parent, child;
+    child.setParent(&parent);
+    Matrix4 rotation;
+    rotation.rotateZ(30);
+    parent.setTransform(at(1, 2, 3) * rotation);
+    child.setTransform(at(0, 0, -1));
+    const Matrix4 walked = child.getTransforms();
+
+    parent.attachToGraph(&graph);
+    child.attachToGraph(&graph);
+    EXPECT_EQ(parent.getNode(), graph.getParent(child.getNode()));
+    graph.update();
+    expectNear(walked, child.getTransforms());
+
+    child.move(0, 1, 0);
+    graph.update();
+    expectNear(at(1, 2, 3) * rotation * at(0, 1, -1), child.getTransforms());
+
+    child.detachFromGraph();
+    EXPECT_EQ(1u, graph.getCount());
+}
@@ -0,0 +1,114 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+#include <stddef.h>
+#include <vector>
+
+#include <FrameBufferObject.h>
+#include <SeaOfCubes.h>
+
+#include "HostTestEnv.h"
+
+TEST(InstanceBufferTest, LayoutMatchesTheShader) {
+    EXPECT_EQ(0u, offsetof(InstanceData, model));
+    EXPECT_EQ(64u, offsetof(InstanceData, color));
+    EXPECT_EQ(80u, offsetof(InstanceData, layer));
+    EXPECT_EQ(96u, sizeof(InstanceData));
+}
+
+// Renders the cubes into a small offscreen target, looking down -z at them.
+class SeaOfCubesTest : public ::testing::Test {
+protected:
+    static const int kSize = 64;
+
+    void SetUp() override {
+        REQUIRE_GL();
+        glGenTextures(1, &mColor);
+        glBindTexture(GL_TEXTURE_2D, mColor);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, kSize, kSize);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        mFbo = new FrameBufferObject(mColor, kSize, kSize);
+        ASSERT_FALSE(mFbo->hasError());
+
+        const float n = 0.1f, f = 100.0f;
+        mProjection.set(1, 0, 0, 0,
+                        0, 1, 0, 0,
+                        0, 0, -(f + n) / (f - n), -1,
+                        0, 0, -2 * f * n / (f - n), 0);
+        mView.translate(0, 0, -6);
+    }
+
+    void TearDown() override {
+        delete mFbo;
+        if (mColor != 0)
+            glDeleteTextures(1, &mColor);
+    }
+
+    std::vector<uint8_t> render(SeaOfCubes & cubes) {
+        mFbo->bindFrameBuffer();
+        mFbo->glViewportFull();
+        glEnable(GL_DEPTH_TEST);
+        glClearColor(0, 0, 0, 1);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        cubes.draw(mProjection, Matrix4(), mView, Vector4(0, 0, 1, 0.5f));
+        std::vector<uint8_t> pixels(kSize * kSize * 4);
+        glReadPixels(0, 0, kSize, kSize, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        mFbo->unbindFrameBuffer();
+        return pixels;
+    }
+
+    GLuint mColor = 0;
+    FrameBufferObject * mFbo = NULL;
+    Matrix4 mProjection;
+    Matrix4 mView;
+};
+
+TEST_F(SeaOfCubesTest, OneDrawCallMatchesOnePerCube) {
+    SeaOfCubes cubes(4, 4, 4, 0.8f);
+    ASSERT_FALSE(cubes.hasError());
+    EXPECT_EQ(64u, cubes.getInstanceCount());
+
+    std::vector<uint8_t> instanced = render(cubes);
+    EXPECT_EQ(1u, cubes.getDrawCalls());
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+
+    uint32_t lit = 0;
+    for (size_t i = 0; i < instanced.size(); i += 4)
+        lit += instanced[i] + instanced[i + 1] + instanced[i + 2] > 0;
+    EXPECT_GT(lit, (uint32_t) (kSize * kSize / 32));
+
+    cubes.setInstanced(false);
+    std::vector<uint8_t> perCube = render(cubes);
+    EXPECT_EQ(64u, cubes.getDrawCalls());
+    EXPECT_EQ(instanced, perCube);
+}
+
+TEST_F(SeaOfCubesTest, InstanceEditsReachTheGpu) {
+    SeaOfCubes cubes(1, 1, 1, 1.0f);
+    ASSERT_FALSE(cubes.hasError());
+    std::vector<uint8_t> before = render(cubes);
+
+    cubes.setInstanceColor(0, Vector4(1, 0, 0, 1));
+    std::vector<uint8_t> red = render(cubes);
+    EXPECT_NE(before, red);
+    const uint8_t * center = &red[(kSize / 2 * kSize + kSize / 2) * 4];
+    EXPECT_GT(center[0], 0);
+    EXPECT_EQ(0, center[1]);
+    EXPECT_EQ(0, center[2]);
+
+    // Moved out of view.
+    Matrix4 away;
+    away.translate(100, 0, 0);
+    cubes.setInstanceTransform(0, away);
+    std::vector<uint8_t> empty = render(cubes);
+    for (size_t i = 0; i < empty.size(); i += 4)
+        ASSERT_EQ(0, empty[i] + empty[i + 1] + empty[i + 2]) << i / 4;
+}
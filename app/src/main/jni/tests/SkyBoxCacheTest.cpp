@@ -0,0 +1,202 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Context.h>
+#include <JobSystem.h>
+#include <SkyBoxCache.h>
+#include <Texture.h>
+
+#include "HostTestEnv.h"
+
+static const char * kSimple = "textures/skybox_simple.jpg";
+static const char * kGalaxy = "textures/skybox_galaxy.jpg";
+static const char * kGroundSky = "textures/skybox_groundsky.jpg";
+static const char * kCloudDawn = "textures/skybox_clouddawn.jpg";
+
+// 512 pixel faces in GL_RGB5_A1 with mipmaps.
+static const size_t kLargeBytes = 512 * 512 * 2 * 6 * 4 / 3;
+
+TEST(CubemapDataTest, DecodesSixFacesWithoutGl) {
+    CubemapData data;
+    ASSERT_TRUE(Texture::decodeSkybox(kSimple, data));
+    EXPECT_EQ(512u, data.width);
+    EXPECT_EQ(512u, data.height);
+    for (int i = 0; i < 6; i++)
+        EXPECT_EQ(data.stride * data.height, data.faces[i].size()) << i;
+    EXPECT_EQ(kLargeBytes, data.getGpuSize());
+
+    // Not a 4:3 cross.
+    CubemapData other;
+    EXPECT_FALSE(Texture::decodeSkybox("textures/land.png", other));
+}
+
+// Decodes go through BitmapFactory and need the JNIEnv of an attached
+// thread.  The workers never attach on their own, so getEnv() has to.
+TEST(CubemapDataTest, DecodesOnADetachedWorker) {
+    JavaVM * vm = NULL;
+    jsize vmCount = 0;
+    ASSERT_EQ(JNI_OK, JNI_GetCreatedJavaVMs(&vm, 1, &vmCount));
+
+    jint before = JNI_OK, after = JNI_OK;
+    bool decoded = false;
+    CubemapData data;
+    JobSystem::Counter counter;
+    JobSystem::getInstance().runBackground([&] {
+        JNIEnv * env = NULL;
+        before = vm->GetEnv((void **) &env, JNI_VERSION_1_6);
+        decoded = Texture::decodeSkybox(kSimple, data);
+        after = vm->GetEnv((void **) &env, JNI_VERSION_1_6);
+    }, &counter);
+    JobSystem::getInstance().wait(counter);
+
+    EXPECT_EQ(JNI_EDETACHED, before);
+    EXPECT_TRUE(decoded);
+    // Detached again when the decode is done.
+    EXPECT_EQ(JNI_EDETACHED, after);
+}
+
+TEST(CubemapDataTest, BitmapFactoryNeedsAnEnv) {
+    Context * context = Context::getInstance();
+    AssetFile file(context->getAssetManager(), kSimple);
+    ASSERT_TRUE(file.open());
+    AndroidBitmapInfo info;
+    EXPECT_EQ((uint8_t *) NULL, context->getBitmapFactory()->decodeByteArray(NULL, file.getBuffer(), file.getLength(), info));
+
+    EnvWrapper ew = context->getEnv();
+    ASSERT_NE((JNIEnv *) NULL, ew.get());
+    uint8_t * pixels = context->getBitmapFactory()->decodeByteArray(ew.get(), file.getBuffer(), file.getLength(), info);
+    EXPECT_NE((uint8_t *) NULL, pixels);
+    delete [] pixels;
+}
+
+class SkyBoxCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        REQUIRE_GL();
+    }
+};
+
+TEST_F(SkyBoxCacheTest, DecodesInTheBackgroundAndUploadsInUpdate) {
+    SkyBoxCache cache(4 * kLargeBytes);
+    cache.request(kSimple);
+    cache.request(kGalaxy);
+    EXPECT_TRUE(cache.isPending(kSimple));
+    EXPECT_FALSE(cache.isResident(kSimple));
+    EXPECT_EQ((Texture *) NULL, cache.get(kSimple).get());
+
+    cache.wait();
+    // One upload per update.
+    EXPECT_EQ(1u, cache.update());
+    EXPECT_EQ(1u, cache.getResidentCount());
+    EXPECT_EQ(1u, cache.update());
+    EXPECT_EQ(0u, cache.update());
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+
+    std::shared_ptr<Texture> simple = cache.get(kSimple);
+    ASSERT_NE((Texture *) NULL, simple.get());
+    EXPECT_NE(0u, simple->getTextureId());
+    EXPECT_FALSE(cache.isPending(kSimple));
+    EXPECT_EQ(2 * kLargeBytes, cache.getResidentBytes());
+
+    // Already there.
+    cache.request(kSimple);
+    EXPECT_FALSE(cache.isPending(kSimple));
+}
+
+TEST_F(SkyBoxCacheTest, EvictsTheLeastRecentlyUsed) {
+    SkyBoxCache cache(2 * kLargeBytes);
+    ASSERT_NE((Texture *) NULL, cache.load(kSimple).get());
+    ASSERT_NE((Texture *) NULL, cache.load(kGalaxy).get());
+    cache.get(kSimple);
+    ASSERT_NE((Texture *) NULL, cache.load(kGroundSky).get());
+
+    EXPECT_TRUE(cache.isResident(kSimple));
+    EXPECT_FALSE(cache.isResident(kGalaxy));
+    EXPECT_TRUE(cache.isResident(kGroundSky));
+    EXPECT_EQ(2 * kLargeBytes, cache.getResidentBytes());
+
+    cache.setBudget(kLargeBytes);
+    EXPECT_FALSE(cache.isResident(kSimple));
+    EXPECT_EQ(1u, cache.getResidentCount());
+}
+
+TEST_F(SkyBoxCacheTest, KeepsWhatIsHeldOrRequested) {
+    SkyBoxCache cache(kLargeBytes);
+    std::shared_ptr<Texture> held = cache.load(kSimple);
+    ASSERT_NE((Texture *) NULL, held.get());
+
+    // Over budget, but evicting either would break a switch.
+    cache.request(kGalaxy);
+    cache.wait();
+    cache.update();
+    EXPECT_TRUE(cache.isResident(kSimple));
+    EXPECT_TRUE(cache.isResident(kGalaxy));
+
+    std::shared_ptr<Texture> galaxy = cache.get(kGalaxy);
+    held.reset();
+    cache.update();
+    EXPECT_FALSE(cache.isResident(kSimple));
+    EXPECT_TRUE(cache.isResident(kGalaxy));
+
+    // A cancelled request may go.
+    cache.request(kGroundSky);
+    cache.wait();
+    cache.update();
+    EXPECT_TRUE(cache.isResident(kGroundSky));
+    galaxy.reset();
+    cache.cancel(kGroundSky);
+    cache.update();
+    EXPECT_EQ(1u, cache.getResidentCount());
+    EXPECT_EQ(kLargeBytes, cache.getResidentBytes());
+}
+
+TEST_F(SkyBoxCacheTest, WarmsCandidatesWithinTheBudget) {
+    SkyBoxCache cache(2 * kLargeBytes);
+    std::shared_ptr<Texture> current = cache.load(kSimple);
+    ASSERT_NE((Texture *) NULL, current.get());
+
+    std::vector<std::string> candidates;
+    candidates.push_back(kGalaxy);
+    candidates.push_back(kGroundSky);
+    cache.setCandidates(candidates);
+    // Only the first fits next to the current sky.
+    cache.update();
+    EXPECT_TRUE(cache.isPending(kGalaxy));
+    EXPECT_FALSE(cache.isPending(kGroundSky));
+    cache.wait();
+    cache.update();
+    EXPECT_TRUE(cache.isResident(kGalaxy));
+    EXPECT_FALSE(cache.isPending(kGroundSky));
+
+    // The candidates outlive other skyboxes.
+    current.reset();
+    std::shared_ptr<Texture> small = cache.load(kCloudDawn);
+    ASSERT_NE((Texture *) NULL, small.get());
+    EXPECT_FALSE(cache.isResident(kSimple));
+    EXPECT_TRUE(cache.isResident(kGalaxy));
+
+    // A candidate that does not decode is not retried.
+    candidates.clear();
+    candidates.push_back("textures/land.png");
+    cache.setCandidates(candidates);
+    cache.update();
+    cache.wait();
+    cache.update();
+    cache.update();
+    EXPECT_FALSE(cache.isPending("textures/land.png"));
+    EXPECT_FALSE(cache.isResident("textures/land.png"));
+}
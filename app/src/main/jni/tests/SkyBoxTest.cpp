@@ -0,0 +1,256 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+
+
+
+#include <stdlib.h>
+#include <vector>
+
+#include <FrameBufferObject.h>
+#include <RenderState.h>
+#include <SkyBox.h>
+
+#include "HostTestEnv.h"
+
+TEST(RenderStateTest, OnlyChangesReachGl) {
+    REQUIRE_GL();
+    RenderState::invalidate();
+    uint32_t before = RenderState::getChangeCount();
+    RenderState::apply(RenderState::kOpaque);
+    EXPECT_EQ(5u, RenderState::getChangeCount() - before);
+
+    before = RenderState::getChangeCount();
+    RenderState::apply(RenderState::kOpaque);
+    EXPECT_EQ(0u, RenderState::getChangeCount() - before);
+
+    RenderState::Desc blended = RenderState::kOpaque;
+    blended.blend = true;
+    blended.depthWrite = false;
+    RenderState::apply(blended);
+    EXPECT_EQ(2u, RenderState::getChangeCount() - before);
+    EXPECT_TRUE(glIsEnabled(GL_BLEND));
+    GLboolean depthWrite = GL_TRUE;
+    glGetBooleanv(GL_DEPTH_WRITEMASK, &depthWrite);
+    EXPECT_FALSE(depthWrite);
+
+    RenderState::apply(RenderState::kOpaque);
+    EXPECT_FALSE(glIsEnabled(GL_BLEND));
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+}
+
+// Renders the sky into a small offscreen target, looking down -z and a bit
+// to the side so more than one face shows.
+class SkyBoxTest : public ::testing::Test {
+protected:
+    static const int kSize = 64;
+
+    void SetUp() override {
+        REQUIRE_GL();
+        glGenTextures(1, &mColor);
+        glBindTexture(GL_TEXTURE_2D, mColor);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, kSize, kSize);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        mFbo = new FrameBufferObject(mColor, kSize, kSize);
+        ASSERT_FALSE(mFbo->hasError());
+
+        const float n = 0.1f, f = 100.0f;
+        mProjection.set(1, 0, 0, 0,
+                        0, 1, 0, 0,
+                        0, 0, -(f + n) / (f - n), -1,
+                        0, 0, -2 * f * n / (f - n), 0);
+        mView.rotateY(30);
+        mView.translate(0, -1.5f, 0);
+    }
+
+    void TearDown() override {
+        delete mFbo;
+        if (mColor != 0)
+            glDeleteTextures(1, &mColor);
+    }
+
+    // With nearDepth, the left half is cleared as if something were drawn there.
+    std::vector<uint8_t> render(SkyBox & sky, bool nearDepth = false) {
+        mFbo->bindFrameBuffer();
+        mFbo->glViewportFull();
+        RenderState::invalidate();
+        RenderState::apply(RenderState::kOpaque);
+        glClearColor(0, 0, 0, 1);
+        glClearDepthf(1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        if (nearDepth) {
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(0, 0, kSize / 2, kSize);
+            glClearDepthf(0.5f);
+            glClear(GL_DEPTH_BUFFER_BIT);
+            glClearDepthf(1.0f);
+            glDisable(GL_SCISSOR_TEST);
+        }
+        sky.draw(mProjection, Matrix4(), mView, Vector4(0, 0, 1, 0.5f));
+        std::vector<uint8_t> pixels(kSize * kSize * 4);
+        glReadPixels(0, 0, kSize, kSize, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        mFbo->unbindFrameBuffer();
+        return pixels;
+    }
+
+    static uint32_t countLit(const std::vector<uint8_t> & pixels, int x0, int x1) {
+        uint32_t lit = 0;
+        for (int y = 0; y < kSize; y++) {
+            for (int x = x0; x < x1; x++) {
+                const uint8_t * p = &pixels[(y * kSize + x) * 4];
+                lit += p[0] + p[1] + p[2] > 0;
+            }
+        }
+        return lit;
+    }
+
+    GLuint mColor = 0;
+    FrameBufferObject * mFbo = NULL;
+    Matrix4 mProjection;
+    Matrix4 mView;
+};
+
+TEST_F(SkyBoxTest, TriangleMatchesTheCube) {
+    SkyBox sky(true);
+    ASSERT_FALSE(sky.hasError());
+    EXPECT_EQ(SkyBox::kFullscreenTriangle, sky.getGeometry());
+
+    std::vector<uint8_t> triangle = render(sky);
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+    EXPECT_EQ((uint32_t) (kSize * kSize), countLit(triangle, 0, kSize));
+
+    sky.setGeometry(SkyBox::kCube);
+    std::vector<uint8_t> cube = render(sky);
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+
+    // Interpolating the direction per vertex or per pixel rounds differently.
+    uint32_t different = 0;
+    for (size_t i = 0; i < cube.size(); i++) {
+        if (abs(cube[i] - triangle[i]) > 8)
+            different++;
+    }
+    EXPECT_LT(different, (uint32_t) (kSize * kSize / 50));
+}
+
+TEST_F(SkyBoxTest, SkipsCoveredPixels) {
+    SkyBox sky(true);
+    ASSERT_FALSE(sky.hasError());
+    std::vector<uint8_t> pixels = render(sky, true);
+    EXPECT_EQ(0u, countLit(pixels, 0, kSize / 2));
+    EXPECT_EQ((uint32_t) (kSize * kSize / 2), countLit(pixels, kSize / 2, kSize));
+}
+
+TEST_F(SkyBoxTest, DrawingLeavesTheOpaqueState) {
+    SkyBox sky(true);
+    ASSERT_FALSE(sky.hasError());
+    render(sky);
+    const uint32_t before = RenderState::getChangeCount();
+    render(sky);
+    // Only the invalidate() in render() reaches GL.
+    EXPECT_EQ(5u, RenderState::getChangeCount() - before);
+    GLint func = 0;
+    glGetIntegerv(GL_DEPTH_FUNC, &func);
+    EXPECT_EQ(GL_LEQUAL, func);
+}
+
+TEST_F(SkyBoxTest, DrawsAnEquirectangularPanorama) {
+    SkyBox sky(true);
+    ASSERT_FALSE(sky.hasError());
+    ASSERT_TRUE(sky.loadEquirect("textures/land.png"));
+    EXPECT_EQ(SkyBox::kEquirect, sky.getSource());
+
+    std::vector<uint8_t> pixels = render(sky);
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+    EXPECT_GT(countLit(pixels, 0, kSize), (uint32_t) (kSize * kSize / 2));
+
+    // The panorama stays until update() swaps the cubemap in.
+    sky.setDebug(true);
+    EXPECT_EQ(SkyBox::kEquirect, sky.getSource());
+    sky.getCache().wait();
+    EXPECT_TRUE(sky.update(0));
+    EXPECT_EQ(SkyBox::kCubemap, sky.getSource());
+}
+
+TEST_F(SkyBoxTest, SwitchesOnceTheNextSkyIsLoaded) {
+    SkyBox sky(true);
+    ASSERT_FALSE(sky.hasError());
+    std::vector<uint8_t> simple = render(sky);
+
+    const Vector4 light(1, 0, 0, 0.5f);
+    sky.switchTo("textures/skybox_galaxy.jpg", light);
+    EXPECT_TRUE(sky.isSwitching());
+    EXPECT_EQ("textures/skybox_simple.jpg", sky.getAsset());
+    EXPECT_EQ(simple, render(sky));
+
+    sky.getCache().wait();
+    EXPECT_TRUE(sky.update(0));
+    EXPECT_FALSE(sky.isSwitching());
+    EXPECT_FALSE(sky.isFading());
+    EXPECT_EQ("textures/skybox_galaxy.jpg", sky.getAsset());
+    EXPECT_TRUE(sky.getLightDir() == light);
+    EXPECT_NE(simple, render(sky));
+    EXPECT_FALSE(sky.update(0));
+}
+
+// Every setDebug(false) goes to another sky than the one shown.
+TEST_F(SkyBoxTest, RandomSkyChangesEveryToggle) {
+    SkyBox sky(false);
+    ASSERT_FALSE(sky.hasError());
+    for (int i = 0; i < 4; i++) {
+        const std::string shown = sky.getAsset();
+        sky.setDebug(false);
+        EXPECT_TRUE(sky.isSwitching()) << i;
+        // One upload per update, and a warmed candidate may come first.
+        for (int k = 0; k < 4 && sky.isSwitching(); k++) {
+            sky.getCache().wait();
+            sky.update(0);
+        }
+        EXPECT_FALSE(sky.isSwitching()) << i;
+        EXPECT_NE(shown, sky.getAsset()) << i;
+    }
+}
+
+TEST_F(SkyBoxTest, CrossFadesBetweenCubemaps) {
+    SkyBox sky(true);
+    ASSERT_FALSE(sky.hasError());
+    std::vector<uint8_t> simple = render(sky);
+    sky.switchTo("textures/skybox_galaxy.jpg", Vector4(0, 0, 1, 0.5f));
+    sky.getCache().wait();
+    sky.update(0);
+    std::vector<uint8_t> galaxy = render(sky);
+
+    sky.setCrossFade(1.0f);
+    sky.switchTo("textures/skybox_simple.jpg", Vector4(0, 0, 0, 1));
+    const int64_t start = 1000000000LL;
+    EXPECT_TRUE(sky.update(start));
+    EXPECT_TRUE(sky.isFading());
+    std::vector<uint8_t> begin = render(sky);
+    EXPECT_EQ(GL_NO_ERROR, glGetError());
+
+    sky.update(start + 500000000LL);
+    std::vector<uint8_t> middle = render(sky);
+    sky.update(start + 1000000000LL);
+    EXPECT_FALSE(sky.isFading());
+    std::vector<uint8_t> end = render(sky);
+
+    uint32_t beginOff = 0, endOff = 0, between = 0;
+    for (size_t i = 0; i < simple.size(); i++) {
+        beginOff += abs(begin[i] - galaxy[i]) > 2;
+        endOff += abs(end[i] - simple[i]) > 2;
+        const int lo = galaxy[i] < simple[i] ? galaxy[i] : simple[i];
+        const int hi = galaxy[i] < simple[i] ? simple[i] : galaxy[i];
+        between += middle[i] + 2 < lo || middle[i] > hi + 2;
+    }
+    EXPECT_EQ(0u, beginOff);
+    EXPECT_EQ(0u, endOff);
+    EXPECT_EQ(0u, between);
+    EXPECT_NE(galaxy, middle);
+    EXPECT_NE(simple, middle);
+}
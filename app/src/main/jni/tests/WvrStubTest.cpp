@@ -0,0 +1,143 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#include <string.h>
+
+#include <GLES3/gl3.h>
+
+#include <wvr/wvr.h>
+#include <wvr/wvr_ctrller_render_model.h>
+#include <wvr/wvr_device.h>
+#include <wvr/wvr_projection.h>
+#include <wvr/wvr_stub.h>
+
+#include "HostTestEnv.h"
+
+class WvrStubTest : public ::testing::Test {
+protected:
+    void SetUp() override { WVR_Stub_Reset(); }
+    void TearDown() override { WVR_Stub_Reset(); }
+};
+
+TEST_F(WvrStubTest, DefaultDevicesAreConnectedWithValidPoses) {
+    WVR_DevicePosePair_t pairs[WVR_DEVICE_COUNT_LEVEL_1];
+    WVR_GetSyncPose(WVR_PoseOriginModel_OriginOnHead, pairs, WVR_DEVICE_COUNT_LEVEL_1);
+    for (uint32_t i = 0; i < WVR_DEVICE_COUNT_LEVEL_1; i++) {
+        EXPECT_EQ(WVR_DeviceType_HMD + i, pairs[i].type);
+        EXPECT_TRUE(WVR_IsDeviceConnected(pairs[i].type));
+        EXPECT_TRUE(pairs[i].pose.isValidPose);
+        EXPECT_GT(pairs[i].pose.timestamp, 0);
+    }
+    EXPECT_FLOAT_EQ(0.2f, pairs[1].pose.poseMatrix.m[0][3]);
+    EXPECT_FLOAT_EQ(-0.2f, pairs[2].pose.poseMatrix.m[0][3]);
+}
+
+TEST_F(WvrStubTest, FixedPoseAndDisconnect) {
+    WVR_Matrix4f_t pose;
+    memset(&pose, 0, sizeof(pose));
+    pose.m[0][0] = pose.m[1][1] = pose.m[2][2] = pose.m[3][3] = 1;
+    pose.m[1][3] = 1.5f;
+    WVR_Stub_SetDevicePose(WVR_DeviceType_HMD, &pose, true, true);
+    WVR_Stub_SetDeviceConnected(WVR_DeviceType_Controller_Left, false);
+
+    WVR_PoseState_t state;
+    WVR_GetPoseState(WVR_DeviceType_HMD, WVR_PoseOriginModel_OriginOnGround, 0, &state);
+    EXPECT_FLOAT_EQ(1.5f, state.poseMatrix.m[1][3]);
+    WVR_GetPoseState(WVR_DeviceType_Controller_Left, WVR_PoseOriginModel_OriginOnGround, 0, &state);
+    EXPECT_FALSE(state.isValidPose);
+    EXPECT_FALSE(WVR_IsDeviceConnected(WVR_DeviceType_Controller_Left));
+}
+
+TEST_F(WvrStubTest, EventsArePolledInOrder) {
+    WVR_Event_t event;
+    EXPECT_FALSE(WVR_PollEventQueue(&event));
+
+    memset(&event, 0, sizeof(event));
+    event.common.type = WVR_EventType_ButtonPressed;
+    event.device.deviceType = WVR_DeviceType_Controller_Right;
+    event.input.inputId = WVR_InputId_Alias1_Trigger;
+    WVR_Stub_PushEvent(&event);
+    event.common.type = WVR_EventType_ButtonUnpressed;
+    WVR_Stub_PushEvent(&event);
+
+    ASSERT_TRUE(WVR_PollEventQueue(&event));
+    EXPECT_EQ(WVR_EventType_ButtonPressed, event.common.type);
+    EXPECT_EQ(WVR_InputId_Alias1_Trigger, event.input.inputId);
+    EXPECT_GT(event.common.timestamp, 0);
+    ASSERT_TRUE(WVR_PollEventQueue(&event));
+    EXPECT_EQ(WVR_EventType_ButtonUnpressed, event.common.type);
+    EXPECT_FALSE(WVR_PollEventQueue(&event));
+}
+
+TEST_F(WvrStubTest, ProjectionIsAGLFrustum) {
+    WVR_Matrix4f_t proj = WVR_GetProjection(WVR_Eye_Left, 0.1f, 30.0f);
+    EXPECT_FLOAT_EQ(-1.0f, proj.m[3][2]);
+    EXPECT_FLOAT_EQ(0.0f, proj.m[3][3]);
+    EXPECT_LT(proj.m[0][2], 0.0f);  // Left eye sees more to the left.
+
+    WVR_Stub_SetIpd(0.07f);
+    WVR_Matrix4f_t eye = WVR_GetTransformFromEyeToHead(WVR_Eye_Right);
+    EXPECT_FLOAT_EQ(0.035f, eye.m[0][3]);
+}
+
+TEST_F(WvrStubTest, RenderModelName) {
+    uint32_t len = WVR_GetParameters(WVR_DeviceType_Controller_Right, "GetRenderModelName", NULL, 0);
+    ASSERT_GT(len, 1u);
+    char * name = new char[len];
+    WVR_GetParameters(WVR_DeviceType_Controller_Right, "GetRenderModelName", name, len);
+    EXPECT_STREQ("HostStubController", name);
+    delete [] name;
+}
+
+TEST_F(WvrStubTest, ControllerModelRoundTrip) {
+    WVR_CtrlerModel_t * model = NULL;
+    ASSERT_EQ(WVR_Success, WVR_GetCurrentControllerModel(WVR_DeviceType_Controller_Right, &model));
+    ASSERT_NE(nullptr, model);
+    EXPECT_GT(model->compInfos.size, 0u);
+    EXPECT_EQ(1u, model->bitmapInfos.size);
+    EXPECT_TRUE(model->touchpadPlane.valid);
+
+    WVR_StubStats_t stats;
+    WVR_Stub_GetStats(&stats);
+    EXPECT_EQ(1u, stats.liveControllerModels);
+
+    WVR_ReleaseControllerModel(&model);
+    EXPECT_EQ(nullptr, model);
+    WVR_Stub_GetStats(&stats);
+    EXPECT_EQ(0u, stats.liveControllerModels);
+}
+
+TEST_F(WvrStubTest, TextureQueueRotatesAndCountsSubmits) {
+    REQUIRE_GL();
+    WVR_Stub_SetTextureQueueLength(3);
+    WVR_TextureQueueHandle_t q = WVR_ObtainTextureQueue(WVR_TextureTarget_2D,
+            WVR_TextureFormat_RGBA, WVR_TextureType_UnsignedByte, 64, 64, 0);
+    ASSERT_NE(nullptr, q);
+    ASSERT_EQ(3u, WVR_GetTextureQueueLength(q));
+    EXPECT_EQ(0, WVR_GetAvailableTextureIndex(q));
+    EXPECT_EQ(1, WVR_GetAvailableTextureIndex(q));
+    EXPECT_EQ(2, WVR_GetAvailableTextureIndex(q));
+    EXPECT_EQ(0, WVR_GetAvailableTextureIndex(q));
+
+    WVR_TextureParams_t tex = WVR_GetTexture(q, 1);
+    EXPECT_TRUE(glIsTexture((GLuint) (uintptr_t) tex.id));
+    EXPECT_EQ(WVR_SubmitError_None, WVR_SubmitFrame(WVR_Eye_Left, &tex));
+
+    WVR_StubStats_t stats;
+    WVR_Stub_GetStats(&stats);
+    EXPECT_EQ(1u, stats.submitCount[WVR_Eye_Left]);
+    EXPECT_EQ(0u, stats.submitCount[WVR_Eye_Right]);
+    EXPECT_EQ((uint32_t) (uintptr_t) tex.id, stats.lastSubmitTexture[WVR_Eye_Left]);
+    EXPECT_EQ(1u, stats.liveTextureQueues);
+
+    WVR_ReleaseTextureQueue(q);
+    WVR_Stub_GetStats(&stats);
+    EXPECT_EQ(0u, stats.liveTextureQueues);
+}
@@ -0,0 +1,40 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#include "HostTestEnv.h"
+
+static bool sHasGL = false;
+
+void HostTestEnv::SetUp() {
+    // The host VM, so threads attach through EnvWrapper as on the device.
+    JavaVM * vm = NULL;
+    jsize vmCount = 0;
+    JNI_GetCreatedJavaVMs(&vm, 1, &vmCount);
+    mContext = new Context(vm);
+    mContext->init(NULL, NULL);
+    sHasGL = mEgl.init();
+}
+
+void HostTestEnv::TearDown() {
+    mEgl.shutdown();
+    sHasGL = false;
+    delete mContext;
+    mContext = NULL;
+}
+
+bool HostTestEnv::hasGL() {
+    return sHasGL;
+}
+
+int main(int argc, char ** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    ::testing::AddGlobalTestEnvironment(new HostTestEnv());
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,177 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#define LOG_TAG "AtlasBuilder"
+#include <stdio.h>
+#include <string.h>
+#include <png.h>
+#include <Context.h>
+#include <log.h>
+#include "AtlasBuilder.h"
+
+namespace {
+
+bool readFile(const char * path, std::vector<uint8_t>& out) {
+    FILE * fp = fopen(path, "rb");
+    if (fp == NULL)
+        return false;
+    uint8_t buffer[16384];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+        out.insert(out.end(), buffer, buffer + n);
+    fclose(fp);
+    return true;
+}
+
+bool writePng(const char * path, const uint8_t * pixels, uint32_t width, uint32_t height) {
+    FILE * fp = fopen(path, "wb");
+    if (fp == NULL) {
+        LOGE("Unable to write %s", path);
+        return false;
+    }
+    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    png_infop info = png != NULL ? png_create_info_struct(png) : NULL;
+    if (info == NULL || setjmp(png_jmpbuf(png))) {
+        png_destroy_write_struct(&png, &info);
+        fclose(fp);
+        LOGE("Unable to encode %s", path);
+        return false;
+    }
+    png_init_io(png, fp);
+    png_set_IHDR(png, info, width, height, 8, PNG_COLOR_TYPE_RGBA, PNG_INTERLACE_NONE,
+            PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    png_write_info(png, info);
+    for (uint32_t y = 0; y < height; y++)
+        png_write_row(png, (png_const_bytep) (pixels + (size_t) y * width * 4));
+    png_write_end(png, NULL);
+    png_destroy_write_struct(&png, &info);
+    return fclose(fp) == 0;
+}
+
+}  // namespace
+
+AtlasBuilder::AtlasBuilder(uint32_t pageSize, uint32_t padding, uint32_t maxPages) :
+        mPageSize(pageSize), mPadding(padding), mPacker(pageSize, pageSize, padding, maxPages) {
+}
+
+bool AtlasBuilder::addFile(const char * path) {
+    std::vector<uint8_t> data;
+    if (!readFile(path, data)) {
+        LOGE("Unable to read %s", path);
+        return false;
+    }
+    AndroidBitmapInfo info;
+    EnvWrapper ew = Context::getInstance()->getEnv();
+    uint8_t * bitmap = Context::getInstance()->getBitmapFactory()->decodeByteArray(ew.get(), data.data(), data.size(), info);
+    if (bitmap == NULL) {
+        LOGE("Unable to decode %s", path);
+        return false;
+    }
+    if (info.format != ANDROID_BITMAP_FORMAT_RGBA_8888) {
+        LOGE("%s: only RGBA8888 is supported, got %d", path, info.format);
+        delete [] bitmap;
+        return false;
+    }
+
+    std::vector<uint8_t> pixels((size_t) info.width * info.height * 4);
+    for (uint32_t y = 0; y < info.height; y++)
+        memcpy(&pixels[(size_t) y * info.width * 4], bitmap + (size_t) y * info.stride, info.width * 4);
+    delete [] bitmap;
+
+    const char * slash = strrchr(path, '/');
+    return addImage(slash != NULL ? slash + 1 : path, pixels.data(), info.width, info.height);
+}
+
+bool AtlasBuilder::addImage(const char * name, const uint8_t * pixels, uint32_t width, uint32_t height) {
+    if (name[0] == 0 || strpbrk(name, " \t\r\n") != NULL) {
+        LOGE("Image name \"%s\" is empty or has white space", name);
+        return false;
+    }
+    Image image;
+    image.name = name;
+    image.width = width;
+    image.height = height;
+    image.pixels.assign(pixels, pixels + (size_t) width * height * 4);
+    image.placement.page = AtlasPacker::kNoPage;
+    mImages.push_back(image);
+    return true;
+}
+
+bool AtlasBuilder::build() {
+    const uint32_t count = (uint32_t) mImages.size();
+    std::vector<uint32_t> widths(count), heights(count);
+    std::vector<AtlasPacker::Placement> placements(count);
+    for (uint32_t i = 0; i < count; i++) {
+        widths[i] = mImages[i].width;
+        heights[i] = mImages[i].height;
+    }
+    mPacker.clear();
+    const bool all = mPacker.addAll(widths.data(), heights.data(), count, placements.data());
+
+    mPages.assign(mPacker.getPageCount(), std::vector<uint8_t>((size_t) mPageSize * mPageSize * 4, 0));
+    for (uint32_t i = 0; i < count; i++) {
+        Image& image = mImages[i];
+        image.placement = placements[i];
+        if (image.placement.page == AtlasPacker::kNoPage) {
+            LOGE("%s (%ux%u) does not fit", image.name.c_str(), image.width, image.height);
+            continue;
+        }
+        AtlasPacker::copyPadded(mPages[image.placement.page].data(), mPageSize, mPageSize,
+                image.pixels.data(), image.width, image.height, image.placement, mPadding);
+    }
+    return all;
+}
+
+std::string AtlasBuilder::getManifest(const std::string& stem) const {
+    std::string manifest = "# hellovr texture atlas, written by hellovr_atlas\n";
+    char line[512];
+    snprintf(line, sizeof(line), "atlas %u %u %u\n", mPageSize, mPageSize, mPadding);
+    manifest += line;
+
+    // Pages go next to the manifest, so only the file name is recorded.
+    const size_t slash = stem.rfind('/');
+    const std::string base = slash == std::string::npos ? stem : stem.substr(slash + 1);
+    for (uint32_t page = 0; page < mPages.size(); page++) {
+        snprintf(line, sizeof(line), "page %s_%u.png\n", base.c_str(), page);
+        manifest += line;
+    }
+    for (size_t i = 0; i < mImages.size(); i++) {
+        const Image& image = mImages[i];
+        if (image.placement.page == AtlasPacker::kNoPage)
+            continue;
+        snprintf(line, sizeof(line), "region %s %u %u %u %u %u\n", image.name.c_str(), image.placement.page,
+                image.placement.x, image.placement.y, image.width, image.height);
+        manifest += line;
+    }
+    return manifest;
+}
+
+bool AtlasBuilder::save(const char * path) const {
+    std::string stem(path);
+    const size_t dot = stem.rfind('.');
+    if (dot != std::string::npos && stem.find('/', dot) == std::string::npos)
+        stem.resize(dot);
+
+    for (uint32_t page = 0; page < mPages.size(); page++) {
+        char suffix[32];
+        snprintf(suffix, sizeof(suffix), "_%u.png", page);
+        if (!writePng((stem + suffix).c_str(), mPages[page].data(), mPageSize, mPageSize))
+            return false;
+    }
+
+    const std::string manifest = getManifest(stem);
+    FILE * fp = fopen(path, "wb");
+    if (fp == NULL) {
+        LOGE("Unable to write %s", path);
+        return false;
+    }
+    const bool written = fwrite(manifest.data(), 1, manifest.size(), fp) == manifest.size();
+    return fclose(fp) == 0 && written;
+}
@@ -0,0 +1,74 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <AtlasPacker.h>
+
+// Packs images into same sized pages and writes them with the manifest
+// TextureAtlas reads.  Host only, used by hellovr_atlas and the tests.
+class AtlasBuilder {
+public:
+    struct Image {
+        std::string name;
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint8_t> pixels;    // RGBA8, tightly packed
+        AtlasPacker::Placement placement;
+    };
+
+public:
+    // padding should cover the texels the coarsest mip level blends across.
+    AtlasBuilder(uint32_t pageSize, uint32_t padding, uint32_t maxPages);
+
+    // A PNG or JPEG, named after the file without its directory.
+    bool addFile(const char * path);
+    // Names may not contain white space.
+    bool addImage(const char * name, const uint8_t * pixels, uint32_t width, uint32_t height);
+
+    // Packs and composes the pages.  False when something does not fit.
+    bool build();
+
+    // The manifest, with pages named <stem>_<n>.png for manifest <stem>.atlas.
+    std::string getManifest(const std::string& stem) const;
+    // Writes the manifest to path and the pages next to it.
+    bool save(const char * path) const;
+
+    inline uint32_t getPageCount() const {
+        return (uint32_t) mPages.size();
+    }
+
+    // RGBA8 of the page, getPageSize() squared.
+    inline const std::vector<uint8_t>& getPage(uint32_t index) const {
+        return mPages[index];
+    }
+
+    inline uint32_t getPageSize() const {
+        return mPageSize;
+    }
+
+    inline const std::vector<Image>& getImages() const {
+        return mImages;
+    }
+
+    inline float getOccupancy() const {
+        return mPacker.getOccupancy();
+    }
+
+private:
+    uint32_t mPageSize;
+    uint32_t mPadding;
+    AtlasPacker mPacker;
+    std::vector<Image> mImages;
+    std::vector<std::vector<uint8_t> > mPages;
+};
@@ -0,0 +1,113 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#define LOG_TAG "TextureAtlas"
+#include <stdio.h>
+#include <string.h>
+#include <Context.h>
+#include <Texture.h>
+#include <TextureAtlas.h>
+#include "log.h"
+
+TextureAtlas::TextureAtlas() : mWidth(0), mHeight(0), mTexture(NULL) {
+}
+
+TextureAtlas::~TextureAtlas() {
+    delete mTexture;
+}
+
+bool TextureAtlas::parse(const char * text) {
+    mWidth = mHeight = 0;
+    mPages.clear();
+    mNames.clear();
+    mRegions.clear();
+    if (text == NULL)
+        return false;
+
+    char name[256];
+    uint32_t lineNumber = 0;
+    for (const char * line = text; *line != 0;) {
+        const char * end = strchr(line, '\n');
+        const size_t length = end != NULL ? (size_t) (end - line) : strlen(line);
+        std::string record(line, length);
+        line += end != NULL ? length + 1 : length;
+        lineNumber++;
+
+        uint32_t width, height, padding, page, x, y, w, h;
+        if (record.empty() || record[0] == '#' || record[0] == '\r') {
+            continue;
+        } else if (sscanf(record.c_str(), "atlas %u %u %u", &width, &height, &padding) == 3) {
+            mWidth = width;
+            mHeight = height;
+        } else if (sscanf(record.c_str(), "page %255s", name) == 1) {
+            mPages.push_back(name);
+        } else if (sscanf(record.c_str(), "region %255s %u %u %u %u %u", name, &page, &x, &y, &w, &h) == 6) {
+            if (mWidth == 0 || mHeight == 0 || page >= mPages.size() || x + w > mWidth || y + h > mHeight) {
+                LOGE("Line %u: region %s is outside the atlas", lineNumber, name);
+                return false;
+            }
+            AtlasPacker::Region region;
+            region.page = page;
+            region.u = (float) x / mWidth;
+            region.v = (float) y / mHeight;
+            region.width = (float) w / mWidth;
+            region.height = (float) h / mHeight;
+            mNames.push_back(name);
+            mRegions.push_back(region);
+        } else {
+            LOGE("Line %u: unknown record", lineNumber);
+            return false;
+        }
+    }
+    return !mPages.empty();
+}
+
+const AtlasPacker::Region * TextureAtlas::find(const char * name) const {
+    for (size_t i = 0; i < mNames.size(); i++) {
+        if (mNames[i] == name)
+            return &mRegions[i];
+    }
+    return NULL;
+}
+
+TextureAtlas * TextureAtlas::load(const char * manifestAsset) {
+    Context * context = Context::getInstance();
+    AssetFile file(context->getAssetManager(), manifestAsset);
+    if (!file.open())
+        return NULL;
+    char * text = file.toString();
+    TextureAtlas * atlas = new TextureAtlas();
+    const bool parsed = atlas->parse(text);
+    delete [] text;
+    if (!parsed) {
+        LOGE("Unable to parse %s", manifestAsset);
+        delete atlas;
+        return NULL;
+    }
+
+    // Pages sit next to the manifest.
+    std::string directory(manifestAsset);
+    const size_t slash = directory.rfind('/');
+    directory = slash == std::string::npos ? std::string() : directory.substr(0, slash + 1);
+    std::vector<std::string> paths;
+    std::vector<const char *> files;
+    for (size_t i = 0; i < atlas->mPages.size(); i++)
+        paths.push_back(directory + atlas->mPages[i]);
+    for (size_t i = 0; i < paths.size(); i++)
+        files.push_back(paths[i].c_str());
+
+    atlas->mTexture = Texture::loadTextureArray(files.data(), (int) files.size());
+    if (atlas->mTexture == NULL) {
+        delete atlas;
+        return NULL;
+    }
+    LOGI("%s: %zu regions on %zu pages", manifestAsset, atlas->mRegions.size(), atlas->mPages.size());
+    return atlas;
+}
@@ -0,0 +1,71 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <AtlasPacker.h>
+
+class Texture;
+
+// Static textures packed offline by hellovr_atlas, see tools/atlas/main.cpp.
+// Host only, with the builder, until the sample draws from such an atlas.
+// The controller packs its textures at run time, see ControllerModel.
+//
+// The manifest is text, one record per line:
+//   atlas <page width> <page height> <padding>
+//   page <image, relative to the manifest>
+//   region <name> <page> <x> <y> <width> <height>
+// The pages become the layers of one GL_TEXTURE_2D_ARRAY, so everything in
+// the atlas draws with one binding and a Region per draw or instance.
+class TextureAtlas {
+public:
+    TextureAtlas();
+    ~TextureAtlas();
+
+    // Reads the manifest and its pages from the assets.  NULL on failure.
+    static TextureAtlas * load(const char * manifestAsset);
+
+    // Only reads the records, without any GL.
+    bool parse(const char * text);
+
+    // NULL when the atlas has no such region.
+    const AtlasPacker::Region * find(const char * name) const;
+
+    // Layers in page order, after load().
+    inline Texture * getTexture() const {
+        return mTexture;
+    }
+
+    inline uint32_t getPageCount() const {
+        return (uint32_t) mPages.size();
+    }
+
+    inline const std::string& getPage(uint32_t index) const {
+        return mPages[index];
+    }
+
+    inline uint32_t getRegionCount() const {
+        return (uint32_t) mRegions.size();
+    }
+
+private:
+    TextureAtlas(const TextureAtlas&);
+    TextureAtlas& operator=(const TextureAtlas&);
+
+    uint32_t mWidth;
+    uint32_t mHeight;
+    std::vector<std::string> mPages;
+    std::vector<std::string> mNames;
+    std::vector<AtlasPacker::Region> mRegions;
+    Texture * mTexture;
+};
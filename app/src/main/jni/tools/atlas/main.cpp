@@ -0,0 +1,66 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Context.h>
+#include "AtlasBuilder.h"
+
+// hellovr_atlas [-s page_size] [-p padding] output.atlas image...
+//
+// Packs static UI textures, PNG or JPEG, into the pages of a texture array
+// and writes the manifest TextureAtlas::load() reads, with the pages as
+// output_<n>.png next to it.  Regions are named after the image files.
+// The array gets mipmaps, so the default padding leaves room for three
+// levels before a region blends with its neighbour.
+int main(int argc, char * argv[]) {
+    uint32_t pageSize = 1024;
+    uint32_t padding = 4;
+    int arg = 1;
+    while (arg + 1 < argc && argv[arg][0] == '-') {
+        if (strcmp(argv[arg], "-s") == 0) {
+            pageSize = (uint32_t) atoi(argv[arg + 1]);
+        } else if (strcmp(argv[arg], "-p") == 0) {
+            padding = (uint32_t) atoi(argv[arg + 1]);
+        } else {
+            break;
+        }
+        arg += 2;
+    }
+    if (argc - arg < 2 || pageSize == 0) {
+        fprintf(stderr, "usage: %s [-s page_size] [-p padding] output.atlas image...\n", argv[0]);
+        return 2;
+    }
+    const char * output = argv[arg++];
+
+    // The host Context decodes images the way BitmapFactory does on the device.
+    JavaVM * vm = NULL;
+    jsize vmCount = 0;
+    JNI_GetCreatedJavaVMs(&vm, 1, &vmCount);
+    Context context(vm);
+    context.init(NULL, NULL);
+
+    AtlasBuilder builder(pageSize, padding, argc - arg);
+    for (; arg < argc; arg++) {
+        if (!builder.addFile(argv[arg]))
+            return 1;
+    }
+    if (!builder.build()) {
+        fprintf(stderr, "some images do not fit a %ux%u page\n", pageSize, pageSize);
+        return 1;
+    }
+    if (!builder.save(output))
+        return 1;
+
+    printf("%s: %zu images on %u pages of %ux%u, %.0f%% used\n", output, builder.getImages().size(),
+        builder.getPageCount(), pageSize, pageSize, builder.getOccupancy() * 100.0f);
+    return 0;
+}
@@ -0,0 +1,315 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#define LOG_TAG "ObjImporter"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <log.h>
+#include "ObjImporter.h"
+
+namespace {
+
+bool readFile(const std::string& path, std::string& text) {
+    FILE * file = fopen(path.c_str(), "rb");
+    if (file == NULL)
+        return false;
+    char chunk[16384];
+    size_t got;
+    text.clear();
+    while ((got = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        text.append(chunk, got);
+    fclose(file);
+    return true;
+}
+
+std::string directoryOf(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+// Splits on blanks, in place.
+void tokenize(char * line, std::vector<char *>& tokens) {
+    tokens.clear();
+    char * save = NULL;
+    for (char * token = strtok_r(line, " \t\r", &save); token != NULL; token = strtok_r(NULL, " \t\r", &save))
+        tokens.push_back(token);
+}
+
+// The rest of the line after the keyword, for names with blanks.
+std::string restOf(const char * line, const char * keyword) {
+    const char * p = line + strlen(keyword);
+    while (*p == ' ' || *p == '\t')
+        p++;
+    std::string rest(p);
+    while (!rest.empty() && (rest.back() == '\r' || rest.back() == ' ' || rest.back() == '\t'))
+        rest.pop_back();
+    return rest;
+}
+
+}  // namespace
+
+ObjImporter::ObjImporter(SceneFileWriter& writer)
+    : mWriter(writer), mMaterial(SceneFile::kNone), mTriangleCount(0) {
+}
+
+bool ObjImporter::load(const char * path) {
+    std::string text;
+    if (!readFile(path, text)) {
+        LOGE("Unable to read %s", path);
+        return false;
+    }
+    return parse(text, directoryOf(path));
+}
+
+bool ObjImporter::parse(const std::string& text, const std::string& directory) {
+    std::vector<char> line;
+    std::vector<char *> tokens;
+    std::vector<Corner> polygon;
+    size_t start = 0;
+    uint32_t lineNumber = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos)
+            end = text.size();
+        line.assign(text.begin() + start, text.begin() + end);
+        line.push_back(0);
+        start = end + 1;
+        lineNumber++;
+
+        const std::string raw(line.data());
+        tokenize(line.data(), tokens);
+        if (tokens.empty() || tokens[0][0] == '#')
+            continue;
+        const char * key = tokens[0];
+        if (strcmp(key, "v") == 0 && tokens.size() >= 4) {
+            for (int i = 1; i <= 3; i++)
+                mPositions.push_back(strtof(tokens[i], NULL));
+        } else if (strcmp(key, "vt") == 0 && tokens.size() >= 3) {
+            mTexCoords.push_back(strtof(tokens[1], NULL));
+            mTexCoords.push_back(strtof(tokens[2], NULL));
+        } else if (strcmp(key, "vn") == 0 && tokens.size() >= 4) {
+            for (int i = 1; i <= 3; i++)
+                mNormals.push_back(strtof(tokens[i], NULL));
+        } else if (strcmp(key, "f") == 0) {
+            polygon.resize(tokens.size() - 1);
+            for (size_t i = 1; i < tokens.size(); i++) {
+                if (!parseCorner(tokens[i], polygon[i - 1])) {
+                    LOGE("Line %u: bad face corner %s", lineNumber, tokens[i]);
+                    return false;
+                }
+            }
+            for (size_t i = 2; i < polygon.size(); i++) {
+                mCorners.push_back(polygon[0]);
+                mCorners.push_back(polygon[i - 1]);
+                mCorners.push_back(polygon[i]);
+                mTriangleMaterials.push_back(mMaterial);
+            }
+        } else if (strcmp(key, "o") == 0 || strcmp(key, "g") == 0) {
+            flush();
+            mObjectName = restOf(raw.c_str(), key);
+        } else if (strcmp(key, "usemtl") == 0) {
+            mMaterial = useMaterial(restOf(raw.c_str(), key));
+        } else if (strcmp(key, "mtllib") == 0) {
+            loadMaterials(directory + restOf(raw.c_str(), key));
+        }
+    }
+    flush();
+    return true;
+}
+
+// v, v/vt, v//vn or v/vt/vn, 1 based or negative from the end.
+bool ObjImporter::parseCorner(const char * token, Corner& corner) const {
+    const int32_t counts[3] = {
+        (int32_t) (mPositions.size() / 3),
+        (int32_t) (mTexCoords.size() / 2),
+        (int32_t) (mNormals.size() / 3)
+    };
+    int32_t * fields[3] = { &corner.position, &corner.texCoord, &corner.normal };
+    corner.position = corner.texCoord = corner.normal = -1;
+    const char * p = token;
+    for (int f = 0; f < 3; f++) {
+        if (*p != 0 && *p != '/') {
+            char * end = NULL;
+            long value = strtol(p, &end, 10);
+            if (end == p)
+                return false;
+            p = end;
+            int32_t index = value < 0 ? counts[f] + (int32_t) value : (int32_t) value - 1;
+            if (index < 0 || index >= counts[f])
+                return false;
+            *fields[f] = index;
+        }
+        if (*p == '/')
+            p++;
+        else
+            break;
+    }
+    return corner.position >= 0;
+}
+
+void ObjImporter::loadMaterials(const std::string& path) {
+    std::string text;
+    if (!readFile(path, text)) {
+        LOGW("Unable to read %s, materials are white", path.c_str());
+        return;
+    }
+    std::vector<char> line;
+    std::vector<char *> tokens;
+    Material * current = NULL;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos)
+            end = text.size();
+        line.assign(text.begin() + start, text.begin() + end);
+        line.push_back(0);
+        start = end + 1;
+
+        const std::string raw(line.data());
+        tokenize(line.data(), tokens);
+        if (tokens.empty() || tokens[0][0] == '#')
+            continue;
+        const char * key = tokens[0];
+        if (strcmp(key, "newmtl") == 0) {
+            Material& material = mMaterials[restOf(raw.c_str(), key)];
+            material.color[0] = material.color[1] = material.color[2] = material.color[3] = 1.0f;
+            material.texture.clear();
+            material.index = SceneFile::kNone;
+            current = &material;
+        } else if (current == NULL) {
+            continue;
+        } else if (strcmp(key, "Kd") == 0 && tokens.size() >= 4) {
+            for (int i = 0; i < 3; i++)
+                current->color[i] = strtof(tokens[i + 1], NULL);
+        } else if (strcmp(key, "d") == 0 && tokens.size() >= 2) {
+            current->color[3] = strtof(tokens[1], NULL);
+        } else if (strcmp(key, "Tr") == 0 && tokens.size() >= 2) {
+            current->color[3] = 1.0f - strtof(tokens[1], NULL);
+        } else if (strcmp(key, "map_Kd") == 0 && tokens.size() >= 2) {
+            // Options come before the file name, which is last.
+            current->texture = tokens.back();
+        }
+    }
+}
+
+uint32_t ObjImporter::useMaterial(const std::string& name) {
+    std::map<std::string, Material>::iterator found = mMaterials.find(name);
+    if (found == mMaterials.end()) {
+        LOGW("Unknown material %s, white", name.c_str());
+        Material& material = mMaterials[name];
+        material.color[0] = material.color[1] = material.color[2] = material.color[3] = 1.0f;
+        material.index = SceneFile::kNone;
+        found = mMaterials.find(name);
+    }
+    Material& material = found->second;
+    if (material.index == SceneFile::kNone) {
+        uint32_t texture = material.texture.empty() ? SceneFile::kNone :
+                mWriter.addTexture((mTexturePrefix + material.texture).c_str());
+        material.index = mWriter.addMaterial(name.c_str(), material.color, texture);
+    }
+    return material.index;
+}
+
+void ObjImporter::flush() {
+    if (mCorners.empty())
+        return;
+
+    // Triangles grouped by material, in order of first use.
+    std::vector<uint32_t> materials;
+    for (size_t t = 0; t < mTriangleMaterials.size(); t++) {
+        bool seen = false;
+        for (size_t m = 0; m < materials.size() && !seen; m++)
+            seen = materials[m] == mTriangleMaterials[t];
+        if (!seen)
+            materials.push_back(mTriangleMaterials[t]);
+    }
+
+    // One vertex per distinct corner.  Layout: position, texture coordinate, normal.
+    const uint32_t kFloats = 8;
+    std::map<Corner, uint32_t> vertexOf;
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<uint8_t> smooth;        // per vertex, normal is accumulated from faces
+    std::vector<SceneFile::SubmeshRecord> submeshes;
+    for (size_t m = 0; m < materials.size(); m++) {
+        SceneFile::SubmeshRecord submesh = { (uint32_t) indices.size(), 0, materials[m], 0 };
+        for (size_t t = 0; t < mTriangleMaterials.size(); t++) {
+            if (mTriangleMaterials[t] != materials[m])
+                continue;
+            const Corner * tri = &mCorners[t * 3];
+            const float * p0 = &mPositions[tri[0].position * 3];
+            const float * p1 = &mPositions[tri[1].position * 3];
+            const float * p2 = &mPositions[tri[2].position * 3];
+            Vector3 faceNormal = (Vector3(p1[0], p1[1], p1[2]) - Vector3(p0[0], p0[1], p0[2])).cross(
+                    Vector3(p2[0], p2[1], p2[2]) - Vector3(p0[0], p0[1], p0[2]));
+            for (int c = 0; c < 3; c++) {
+                const Corner& corner = tri[c];
+                std::map<Corner, uint32_t>::iterator found = vertexOf.find(corner);
+                uint32_t index;
+                if (found != vertexOf.end()) {
+                    index = found->second;
+                } else {
+                    index = (uint32_t) (vertices.size() / kFloats);
+                    vertexOf[corner] = index;
+                    const float * p = &mPositions[corner.position * 3];
+                    vertices.insert(vertices.end(), p, p + 3);
+                    if (corner.texCoord >= 0) {
+                        vertices.push_back(mTexCoords[corner.texCoord * 2]);
+                        vertices.push_back(mTexCoords[corner.texCoord * 2 + 1]);
+                    } else {
+                        vertices.push_back(0.0f);
+                        vertices.push_back(0.0f);
+                    }
+                    if (corner.normal >= 0) {
+                        const float * n = &mNormals[corner.normal * 3];
+                        vertices.insert(vertices.end(), n, n + 3);
+                    } else {
+                        vertices.insert(vertices.end(), 3, 0.0f);
+                    }
+                    smooth.push_back(corner.normal < 0);
+                }
+                if (smooth[index]) {
+                    float * n = &vertices[index * kFloats + 5];
+                    n[0] += faceNormal.x;
+                    n[1] += faceNormal.y;
+                    n[2] += faceNormal.z;
+                }
+                indices.push_back(index);
+            }
+        }
+        submesh.indexCount = (uint32_t) indices.size() - submesh.firstIndex;
+        submeshes.push_back(submesh);
+    }
+
+    for (size_t v = 0; v < smooth.size(); v++) {
+        if (!smooth[v])
+            continue;
+        float * n = &vertices[v * kFloats + 5];
+        const float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length > 0.0f) {
+            n[0] /= length;
+            n[1] /= length;
+            n[2] /= length;
+        } else {
+            n[1] = 1.0f;
+        }
+    }
+
+    const uint32_t mesh = mWriter.addMesh(vertices.data(), (uint32_t) (vertices.size() / kFloats), kFloats, 5, 3,
+            indices.data(), (uint32_t) indices.size(), submeshes.data(), (uint32_t) submeshes.size());
+    mWriter.addNode(mObjectName.c_str(), SceneFile::kNone, mesh, Matrix4());
+    mTriangleCount += (uint32_t) (indices.size() / 3);
+
+    mCorners.clear();
+    mTriangleMaterials.clear();
+    mObjectName.clear();
+}
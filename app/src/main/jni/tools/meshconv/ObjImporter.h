@@ -0,0 +1,83 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "SceneFileWriter.h"
+
+// Reads Wavefront OBJ and its MTL libraries into a SceneFileWriter.  Host
+// only.
+//
+// Every object or group becomes a top level node with one mesh, and every
+// material used in it a submesh.  Polygons are split into fans.  Vertices
+// are position, texture coordinate and normal, the order of the vtn
+// shaders.  Missing normals are smoothed from the faces, missing texture
+// coordinates are zero.  Textures are referenced as the texture prefix
+// followed by the map_Kd path, so point the prefix at their asset folder.
+class ObjImporter {
+public:
+    explicit ObjImporter(SceneFileWriter& writer);
+
+    inline void setTexturePrefix(const std::string& prefix) {
+        mTexturePrefix = prefix;
+    }
+
+    bool load(const char * path);
+    // mtllib files are looked up in directory.
+    bool parse(const std::string& text, const std::string& directory);
+
+    inline uint32_t getTriangleCount() const {
+        return mTriangleCount;
+    }
+
+private:
+    struct Corner {
+        int32_t position;
+        int32_t texCoord;       // -1 when absent
+        int32_t normal;         // -1 when absent
+
+        inline bool operator<(const Corner& other) const {
+            if (position != other.position)
+                return position < other.position;
+            if (texCoord != other.texCoord)
+                return texCoord < other.texCoord;
+            return normal < other.normal;
+        }
+    };
+
+    struct Material {
+        float color[4];
+        std::string texture;
+        uint32_t index;         // in the writer, SceneFile::kNone until used
+    };
+
+    bool parseCorner(const char * token, Corner& corner) const;
+    void loadMaterials(const std::string& path);
+    uint32_t useMaterial(const std::string& name);
+    void flush();
+
+    SceneFileWriter& mWriter;
+    std::string mTexturePrefix;
+    std::vector<float> mPositions;
+    std::vector<float> mTexCoords;
+    std::vector<float> mNormals;
+    std::map<std::string, Material> mMaterials;
+
+    // The object being read.
+    std::string mObjectName;
+    std::vector<Corner> mCorners;           // three per triangle
+    std::vector<uint32_t> mTriangleMaterials;
+    uint32_t mMaterial;
+    uint32_t mTriangleCount;
+};
@@ -0,0 +1,186 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#define LOG_TAG "SceneFileWriter"
+#include <stdio.h>
+#include <string.h>
+#include <log.h>
+#include <BoundingVolume.h>
+#include "SceneFileWriter.h"
+
+namespace {
+
+void append(std::vector<uint8_t>& out, const void * data, size_t size) {
+    const uint8_t * p = (const uint8_t *) data;
+    out.insert(out.end(), p, p + size);
+}
+
+void pad(std::vector<uint8_t>& out, size_t alignment) {
+    while (out.size() % alignment != 0)
+        out.push_back(0);
+}
+
+}  // namespace
+
+SceneFileWriter::SceneFileWriter() {
+}
+
+uint32_t SceneFileWriter::addMesh(const float * vertices, uint32_t vertexCount, uint32_t floatsPerVertex,
+        uint32_t normalOffset, uint32_t texCoordOffset,
+        const uint32_t * indices, uint32_t indexCount,
+        const SceneFile::SubmeshRecord * submeshes, uint32_t submeshCount) {
+    SceneFile::MeshRecord mesh;
+    memset(&mesh, 0, sizeof(mesh));
+    mesh.vertexOffset = (uint32_t) mVertexData.size();
+    mesh.vertexCount = vertexCount;
+    mesh.vertexStride = floatsPerVertex * sizeof(float);
+    mesh.normalOffset = normalOffset == SceneFile::kNone ? SceneFile::kNone : normalOffset * sizeof(float);
+    mesh.texCoordOffset = texCoordOffset == SceneFile::kNone ? SceneFile::kNone : texCoordOffset * sizeof(float);
+    append(mVertexData, vertices, (size_t) vertexCount * mesh.vertexStride);
+
+    AABB bounds;
+    for (uint32_t i = 0; i < vertexCount; i++) {
+        const float * p = vertices + (size_t) i * floatsPerVertex;
+        bounds.expand(Vector3(p[0], p[1], p[2]));
+    }
+    if (vertexCount == 0)
+        bounds = AABB(Vector3(), Vector3());
+    mesh.boundsMin[0] = bounds.min.x;
+    mesh.boundsMin[1] = bounds.min.y;
+    mesh.boundsMin[2] = bounds.min.z;
+    mesh.boundsMax[0] = bounds.max.x;
+    mesh.boundsMax[1] = bounds.max.y;
+    mesh.boundsMax[2] = bounds.max.z;
+
+    // 16 bit indices when they fit.
+    mesh.indexSize = vertexCount <= 0x10000 ? 2 : 4;
+    pad(mIndexData, mesh.indexSize);
+    mesh.indexOffset = (uint32_t) mIndexData.size();
+    mesh.indexCount = indexCount;
+    for (uint32_t i = 0; i < indexCount; i++) {
+        if (mesh.indexSize == 2) {
+            uint16_t index = (uint16_t) indices[i];
+            append(mIndexData, &index, sizeof(index));
+        } else {
+            append(mIndexData, &indices[i], sizeof(indices[i]));
+        }
+    }
+
+    mesh.firstSubmesh = (uint32_t) mSubmeshes.size();
+    if (submeshCount == 0) {
+        SceneFile::SubmeshRecord whole = { 0, indexCount, SceneFile::kNone, 0 };
+        mSubmeshes.push_back(whole);
+        mesh.submeshCount = 1;
+    } else {
+        mSubmeshes.insert(mSubmeshes.end(), submeshes, submeshes + submeshCount);
+        mesh.submeshCount = submeshCount;
+    }
+    mMeshes.push_back(mesh);
+    return (uint32_t) mMeshes.size() - 1;
+}
+
+uint32_t SceneFileWriter::addMaterial(const char * name, const float baseColor[4], uint32_t baseColorTexture) {
+    SceneFile::MaterialRecord material;
+    memset(&material, 0, sizeof(material));
+    material.name = addString(name);
+    memcpy(material.baseColor, baseColor, sizeof(material.baseColor));
+    material.baseColorTexture = baseColorTexture;
+    mMaterials.push_back(material);
+    return (uint32_t) mMaterials.size() - 1;
+}
+
+uint32_t SceneFileWriter::addTexture(const char * uri) {
+    const uint32_t offset = addString(uri);
+    for (uint32_t i = 0; i < mTextures.size(); i++) {
+        if (mTextures[i].uri == offset)
+            return i;
+    }
+    SceneFile::TextureRecord texture = { offset };
+    mTextures.push_back(texture);
+    return (uint32_t) mTextures.size() - 1;
+}
+
+uint32_t SceneFileWriter::addNode(const char * name, uint32_t parent, uint32_t mesh, const Matrix4& local) {
+    SceneFile::NodeRecord node;
+    memset(&node, 0, sizeof(node));
+    node.name = addString(name);
+    node.parent = parent;
+    node.mesh = mesh;
+    memcpy(node.local, local.get(), sizeof(node.local));
+    mNodes.push_back(node);
+    return (uint32_t) mNodes.size() - 1;
+}
+
+uint32_t SceneFileWriter::addString(const char * s) {
+    if (s == NULL || s[0] == 0)
+        return SceneFile::kNone;
+    std::map<std::string, uint32_t>::const_iterator found = mStringOffsets.find(s);
+    if (found != mStringOffsets.end())
+        return found->second;
+    const uint32_t offset = (uint32_t) mStrings.size();
+    mStrings.insert(mStrings.end(), s, s + strlen(s) + 1);
+    mStringOffsets[s] = offset;
+    return offset;
+}
+
+void SceneFileWriter::write(std::vector<uint8_t>& out) const {
+    const void * data[SceneFile::kSectionCount] = {
+        mMeshes.data(), mSubmeshes.data(), mMaterials.data(), mTextures.data(),
+        mNodes.data(), mStrings.data(), mVertexData.data(), mIndexData.data()
+    };
+    const size_t sizes[SceneFile::kSectionCount] = {
+        mMeshes.size() * sizeof(SceneFile::MeshRecord),
+        mSubmeshes.size() * sizeof(SceneFile::SubmeshRecord),
+        mMaterials.size() * sizeof(SceneFile::MaterialRecord),
+        mTextures.size() * sizeof(SceneFile::TextureRecord),
+        mNodes.size() * sizeof(SceneFile::NodeRecord),
+        mStrings.size(),
+        mVertexData.size(),
+        mIndexData.size()
+    };
+    const size_t counts[SceneFile::kSectionCount] = {
+        mMeshes.size(), mSubmeshes.size(), mMaterials.size(), mTextures.size(),
+        mNodes.size(), mStrings.size(), mVertexData.size(), mIndexData.size()
+    };
+
+    SceneFile::Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "HVSC", 4);
+    header.version = SceneFile::kVersion;
+    header.sectionCount = SceneFile::kSectionCount;
+
+    out.assign(sizeof(header), 0);
+    for (uint32_t s = 0; s < SceneFile::kSectionCount; s++) {
+        pad(out, SceneFile::kAlignment);
+        header.sections[s].offset = (uint32_t) out.size();
+        header.sections[s].size = (uint32_t) sizes[s];
+        header.sections[s].count = (uint32_t) counts[s];
+        append(out, data[s], sizes[s]);
+    }
+    pad(out, SceneFile::kAlignment);
+    header.fileSize = (uint32_t) out.size();
+    memcpy(out.data(), &header, sizeof(header));
+}
+
+bool SceneFileWriter::save(const char * path) const {
+    std::vector<uint8_t> bytes;
+    write(bytes);
+    FILE * file = fopen(path, "wb");
+    if (file == NULL) {
+        LOGE("Unable to write %s", path);
+        return false;
+    }
+    const bool written = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    if (fclose(file) != 0 || !written) {
+        LOGE("Unable to write %s", path);
+        return false;
+    }
+    return true;
+}
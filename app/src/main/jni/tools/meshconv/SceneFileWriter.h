@@ -0,0 +1,61 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#pragma once
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <Matrices.h>
+#include <SceneFile.h>
+
+// Builds a SceneFile.  Host only, used by hellovr_meshconv and the tests.
+class SceneFileWriter {
+public:
+    SceneFileWriter();
+
+    // vertices holds vertexCount interleaved vertices of floatsPerVertex
+    // floats, positions first.  normalOffset and texCoordOffset count
+    // floats, SceneFile::kNone when absent.  Without submeshes the whole
+    // mesh is one submesh without a material.  Returns the mesh index.
+    uint32_t addMesh(const float * vertices, uint32_t vertexCount, uint32_t floatsPerVertex,
+            uint32_t normalOffset, uint32_t texCoordOffset,
+            const uint32_t * indices, uint32_t indexCount,
+            const SceneFile::SubmeshRecord * submeshes = NULL, uint32_t submeshCount = 0);
+    uint32_t addMaterial(const char * name, const float baseColor[4], uint32_t baseColorTexture = SceneFile::kNone);
+    uint32_t addTexture(const char * uri);
+    // parent must already be added.
+    uint32_t addNode(const char * name, uint32_t parent, uint32_t mesh, const Matrix4& local);
+
+    void write(std::vector<uint8_t>& out) const;
+    bool save(const char * path) const;
+
+    inline uint32_t getMeshCount() const {
+        return (uint32_t) mMeshes.size();
+    }
+
+    inline uint32_t getNodeCount() const {
+        return (uint32_t) mNodes.size();
+    }
+
+private:
+    uint32_t addString(const char * s);
+
+    std::vector<SceneFile::MeshRecord> mMeshes;
+    std::vector<SceneFile::SubmeshRecord> mSubmeshes;
+    std::vector<SceneFile::MaterialRecord> mMaterials;
+    std::vector<SceneFile::TextureRecord> mTextures;
+    std::vector<SceneFile::NodeRecord> mNodes;
+    std::vector<char> mStrings;
+    std::map<std::string, uint32_t> mStringOffsets;
+    std::vector<uint8_t> mVertexData;
+    std::vector<uint8_t> mIndexData;
+};
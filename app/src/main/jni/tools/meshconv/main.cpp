@@ -0,0 +1,56 @@
+// "WaveVR SDK
+// © 2017 HTC Corporation. All Rights Reserved.
+//
+// Unless otherwise required by copyright law and practice,
+// upon the execution of HTC SDK license agreement,
+// HTC grants you access to and use of the WaveVR SDK(s).
+// You shall fully comply with all of HTC’s SDK license agreement terms and
+// conditions signed by you and all SDK and API requirements,
+// specifications, and documentation provided by HTC to You."
+
+#include <stdio.h>
+#include <string.h>
+#include <SceneFile.h>
+#include "ObjImporter.h"
+#include "SceneFileWriter.h"
+
+// hellovr_meshconv [-t texture_prefix] input.obj output.hvsc
+//
+// Converts a Wavefront OBJ scene to the SceneFile container that
+// Environment loads.  Store the output uncompressed in the APK, or push it
+// to the device, so it can be mapped.
+int main(int argc, char * argv[]) {
+    const char * prefix = "";
+    int arg = 1;
+    if (arg + 1 < argc && strcmp(argv[arg], "-t") == 0) {
+        prefix = argv[arg + 1];
+        arg += 2;
+    }
+    if (argc - arg != 2) {
+        fprintf(stderr, "usage: %s [-t texture_prefix] input.obj output.hvsc\n", argv[0]);
+        return 2;
+    }
+    const char * input = argv[arg];
+    const char * output = argv[arg + 1];
+
+    SceneFileWriter writer;
+    ObjImporter importer(writer);
+    importer.setTexturePrefix(prefix);
+    if (!importer.load(input)) {
+        fprintf(stderr, "unable to convert %s\n", input);
+        return 1;
+    }
+    if (!writer.save(output))
+        return 1;
+
+    // Read it back the way the sample will.
+    SceneFile file;
+    if (!file.open(output)) {
+        fprintf(stderr, "%s does not validate\n", output);
+        return 1;
+    }
+    printf("%s: %u meshes, %u materials, %u textures, %u nodes, %u triangles, %zu bytes\n", output,
+        file.getMeshCount(), file.getMaterialCount(), file.getTextureCount(), file.getNodeCount(),
+        importer.getTriangleCount(), file.getSize());
+    return 0;
+}